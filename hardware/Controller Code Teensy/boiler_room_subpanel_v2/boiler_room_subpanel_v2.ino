@@ -28,9 +28,10 @@
 #define MQTT_MAX_PACKET_SIZE 512
 #endif
 
-#include <SentientCapabilityManifest.h>
+#include <SentientManifestStream.h>
 #include <SentientMQTT.h>
 #include <SentientDeviceRegistry.h>
+#include <SentientPulseOutputs.h>
 #include <ArduinoJson.h>
 #include <FastLED.h>
 #include <IRremote.hpp>
@@ -84,95 +85,104 @@ CRGB leds[num_leds];
 // ============================================================================
 
 // Intro TV Power
-const char *intro_tv_power_commands[] = {
+constexpr const char *intro_tv_power_commands[] PROGMEM = {
     naming::CMD_TV_POWER_ON,
     naming::CMD_TV_POWER_OFF};
 
 // Intro TV Lift
-const char *intro_tv_lift_commands[] = {
+constexpr const char *intro_tv_lift_commands[] PROGMEM = {
     naming::CMD_TV_LIFT_UP,
     naming::CMD_TV_LIFT_DOWN,
     naming::CMD_TV_LIFT_STOP};
 
 // Fog Machine Power
-const char *fog_power_commands[] = {
+constexpr const char *fog_power_commands[] PROGMEM = {
     naming::CMD_FOG_POWER_ON,
     naming::CMD_FOG_POWER_OFF};
 
 // Fog Machine Trigger
-const char *fog_trigger_commands[] = {
+constexpr const char *fog_trigger_commands[] PROGMEM = {
     naming::CMD_FOG_TRIGGER};
 
 // Fog Machine Ultrasonic
-const char *fog_ultrasonic_commands[] = {
+constexpr const char *fog_ultrasonic_commands[] PROGMEM = {
     naming::CMD_ULTRASONIC_ON,
     naming::CMD_ULTRASONIC_OFF};
 
 // Barrel — maglock only
-const char *barrel_commands[] = {
+constexpr const char *barrel_commands[] PROGMEM = {
     naming::CMD_BARREL_LOCK,
     naming::CMD_BARREL_UNLOCK};
 
 // Study Door — group control
-const char *study_door_commands[] = {
+constexpr const char *study_door_commands[] PROGMEM = {
     naming::CMD_DOOR_LOCK,
     naming::CMD_DOOR_UNLOCK};
 
 // Gauge Progress Chest — discrete progress levels
-const char *gauge_chest_commands[] = {
+constexpr const char *gauge_chest_commands[] PROGMEM = {
     naming::CMD_GAUGE_SOLVED_1,
     naming::CMD_GAUGE_SOLVED_2,
     naming::CMD_GAUGE_SOLVED_3,
     naming::CMD_GAUGE_CLEAR};
 
 // IR Sensor — gun detection control
-const char *ir_sensor_commands[] = {
+constexpr const char *ir_sensor_commands[] PROGMEM = {
     naming::CMD_IR_ACTIVATE,
     naming::CMD_IR_DEACTIVATE};
 
 // Sensor items
-const char *ir_sensor_sensors[] = {"ir_code"};
+constexpr const char *ir_sensor_sensors[] PROGMEM = {"ir_code"};
 
 // Create device definitions with friendly names
-SentientDeviceDef dev_intro_tv_power(
+constexpr SentientDeviceDef dev_intro_tv_power PROGMEM(
     naming::DEV_INTRO_TV_POWER, naming::FRIENDLY_INTRO_TV_POWER, naming::TYPE_INTRO_TV_POWER,
     intro_tv_power_commands, 2);
 
-SentientDeviceDef dev_intro_tv_lift(
+constexpr SentientDeviceDef dev_intro_tv_lift PROGMEM(
     naming::DEV_INTRO_TV_LIFT, naming::FRIENDLY_INTRO_TV_LIFT, naming::TYPE_INTRO_TV_LIFT,
     intro_tv_lift_commands, 3);
 
-SentientDeviceDef dev_fog_power(
+constexpr SentientDeviceDef dev_fog_power PROGMEM(
     naming::DEV_FOG_POWER, naming::FRIENDLY_FOG_POWER, naming::TYPE_FOG_POWER,
     fog_power_commands, 2);
 
-SentientDeviceDef dev_fog_trigger(
+constexpr SentientDeviceDef dev_fog_trigger PROGMEM(
     naming::DEV_FOG_TRIGGER, naming::FRIENDLY_FOG_TRIGGER, naming::TYPE_FOG_TRIGGER,
     fog_trigger_commands, 1);
 
-SentientDeviceDef dev_fog_ultrasonic(
+constexpr SentientDeviceDef dev_fog_ultrasonic PROGMEM(
     naming::DEV_FOG_ULTRASONIC, naming::FRIENDLY_FOG_ULTRASONIC, naming::TYPE_FOG_ULTRASONIC,
     fog_ultrasonic_commands, 2);
 
-SentientDeviceDef dev_barrel(
+constexpr SentientDeviceDef dev_barrel PROGMEM(
     naming::DEV_BOILER_ROOM_BARREL, naming::FRIENDLY_BOILER_ROOM_BARREL, naming::TYPE_BOILER_ROOM_BARREL,
     barrel_commands, 2);
 
-SentientDeviceDef dev_ir_sensor(
+constexpr SentientDeviceDef dev_ir_sensor PROGMEM(
     naming::DEV_IR_SENSOR, naming::FRIENDLY_IR_SENSOR, naming::TYPE_IR_SENSOR,
     ir_sensor_commands, 2,
     ir_sensor_sensors, 1);
 
-SentientDeviceDef dev_study_door(
+constexpr SentientDeviceDef dev_study_door PROGMEM(
     naming::DEV_STUDY_DOOR, naming::FRIENDLY_STUDY_DOOR, naming::TYPE_STUDY_DOOR,
     study_door_commands, 2);
 
-SentientDeviceDef dev_gauge_chest(
+constexpr SentientDeviceDef dev_gauge_chest PROGMEM(
     naming::DEV_GAUGE_PROGRESS_CHEST, naming::FRIENDLY_GAUGE_PROGRESS_CHEST, naming::TYPE_GAUGE_PROGRESS_CHEST,
     gauge_chest_commands, 4);
 
 // Create the device registry (manifest builder will use these IDs and names)
-SentientDeviceRegistry deviceRegistry;
+SENTIENT_DEVICE_REGISTRY(deviceRegistry,
+  &dev_intro_tv_power,
+  &dev_intro_tv_lift,
+  &dev_fog_power,
+  &dev_fog_trigger,
+  &dev_fog_ultrasonic,
+  &dev_barrel,
+  &dev_ir_sensor,
+  &dev_study_door,
+  &dev_gauge_chest);
 
 // ──────────────────────────────────────────────────────────────────────────────
 // Configuration Constants
@@ -226,9 +236,14 @@ bool build_heartbeat_payload(JsonDocument &doc, void *ctx);
 // ──────────────────────────────────────────────────────────────────────────────
 // MQTT Objects
 // ──────────────────────────────────────────────────────────────────────────────
-SentientCapabilityManifest manifest;
+SentientManifestStream manifest(deviceRegistry);
 SentientMQTT mqtt(build_mqtt_config());
 
+// Fog trigger pulses run from a timer, so MQTT, IR and the gauge keep going
+SentientPulseOutputs timed_outputs;
+int fog_trigger_output = -1;
+void on_timed_output_done(const SentientPulseDone &done, void *ctx);
+
 // ══════════════════════════════════════════════════════════════════════════════
 // SECTION 2: SETUP FUNCTION
 // ══════════════════════════════════════════════════════════════════════════════
@@ -261,11 +276,11 @@ void setup()
 
   // Configure fog machine
   pinMode(fog_power_pin, OUTPUT);
-  pinMode(fog_trigger_pin, OUTPUT);
   pinMode(ultrasonic_water_pin, OUTPUT);
   digitalWrite(fog_power_pin, LOW);
-  digitalWrite(fog_trigger_pin, LOW);
   digitalWrite(ultrasonic_water_pin, LOW);
+  fog_trigger_output = timed_outputs.add(fog_trigger_pin);
+  timed_outputs.onComplete(on_timed_output_done);
 
   // Configure maglocks (HIGH = locked, LOW = unlocked)
   pinMode(barrel_maglock_pin, OUTPUT);
@@ -290,16 +305,6 @@ void setup()
   Serial.println(F("[BoilerRmA] Hardware initialized"));
 
   // Register all devices (SINGLE SOURCE OF TRUTH!) — canonical IDs + friendly names
-  Serial.println(F("[BoilerRmA] Registering devices (canonical)..."));
-  deviceRegistry.addDevice(&dev_intro_tv_power);
-  deviceRegistry.addDevice(&dev_intro_tv_lift);
-  deviceRegistry.addDevice(&dev_fog_power);
-  deviceRegistry.addDevice(&dev_fog_trigger);
-  deviceRegistry.addDevice(&dev_fog_ultrasonic);
-  deviceRegistry.addDevice(&dev_barrel);
-  deviceRegistry.addDevice(&dev_ir_sensor);
-  deviceRegistry.addDevice(&dev_study_door);
-  deviceRegistry.addDevice(&dev_gauge_chest);
   deviceRegistry.printSummary();
 
   // Build capability manifest
@@ -334,9 +339,9 @@ void setup()
 
     // Register with Sentient system
     Serial.println(F("[BoilerRmA] Registering with Sentient system..."));
-    if (manifest.publish_registration(mqtt.get_client(), room_id, controller_id))
+    if (manifest.publish_registration(mqtt, room_id, controller_id))
     {
-      Serial.println(F("[BoilerRmA] Registration successful!"));
+      Serial.println(F("[BoilerRmA] Registration started"));
     }
     else
     {
@@ -441,7 +446,7 @@ void setup()
           tv_power_on = false; digitalWrite(tv_power_pin, LOW);
           tv_lift_state = 0; digitalWrite(tv_lift_up_pin, LOW); digitalWrite(tv_lift_down_pin, LOW);
           // Fog system
-          fog_trigger_on = false; digitalWrite(fog_trigger_pin, LOW);
+          fog_trigger_on = false; timed_outputs.cancel(fog_trigger_output);
           ultrasonic_water_on = false; digitalWrite(ultrasonic_water_pin, LOW);
           fog_power_on = false; digitalWrite(fog_power_pin, LOW);
           // Doors/locks to safe default (locked)
@@ -464,7 +469,7 @@ void setup()
           ready["timestamp_ms"] = millis();
           char rbuf[196]; serializeJson(ready, rbuf, sizeof(rbuf));
           String rTopic = String(mqtt_namespace) + "/" + room_id + "/" + naming::CAT_EVENTS + "/" + controller_id + "/shutdown_ready";
-          mqtt.get_client().publish(rTopic.c_str(), rbuf, false);
+          mqtt.publishTopic(rTopic.c_str(), rbuf);
         }
       }
       // Fog Machine Power
@@ -503,11 +508,9 @@ void setup()
           if (durationMs > 3000) durationMs = 3000;
           ack_duration_ms = durationMs;
           Serial.print(F("[BoilerRmA] Fog trigger pulse: ")); Serial.print(durationMs); Serial.println(F(" ms"));
+          // Released by the pulse timer; on_timed_output_done() reports the end
           fog_trigger_on = true;
-          digitalWrite(fog_trigger_pin, HIGH);
-          delay((unsigned long)durationMs);
-          fog_trigger_on = false;
-          digitalWrite(fog_trigger_pin, LOW);
+          timed_outputs.pulse(fog_trigger_output, (uint32_t)durationMs * 1000UL);
           publish_hardware_status();
         }
       }
@@ -562,7 +565,7 @@ void setup()
       char buf[196]; serializeJson(ack, buf, sizeof(buf));
       // Topic: <tenant>/<room>/acknowledgement/<controller>/<device>/<command>
       String ackTopic = String(mqtt_namespace) + "/" + room_id + "/" + naming::CAT_ACKNOWLEDGEMENT + "/" + controller_id + "/" + device + "/" + command;
-      mqtt.get_client().publish(ackTopic.c_str(), buf, false);
+      mqtt.publishTopic(ackTopic.c_str(), buf);
       Serial.print(F("[BoilerRmA] ACK -> "));
       Serial.println(ackTopic); });
   }
@@ -578,6 +581,8 @@ void loop()
 {
   // 1. LISTEN for commands from Sentient
   mqtt.loop();
+  manifest.loop();
+  timed_outputs.loop();
 
   // 2. DETECT IR sensor input and publish if detected
   check_ir_sensor();
@@ -585,7 +590,8 @@ void loop()
   // 3. EXECUTE LED updates
   FastLED.show();
 
-  delay(10);
+  // IR decodes are polled every 10 ms; MQTT traffic wakes the loop early
+  mqtt.idle(10);
 }
 
 // ══════════════════════════════════════════════════════════════════════════════
@@ -630,7 +636,7 @@ void check_ir_sensor()
     String topic = String(mqtt_namespace) + "/" + room_id + "/" + naming::CAT_SENSORS + "/" + controller_id + "/" + naming::DEV_BOILER_ROOM_BARREL + "/ir_code";
     String payload;
     serializeJson(doc, payload);
-    mqtt.get_client().publish(topic.c_str(), payload.c_str(), false);
+    mqtt.publishTopic(topic.c_str(), payload.c_str());
   }
 
   // Update tracking
@@ -656,9 +662,6 @@ void build_capability_manifest()
       room_id,
       controller_id);
 
-  // Auto-generate entire manifest from device registry - ONE LINE!
-  deviceRegistry.buildManifest(manifest);
-
   // That's it! No manual device/topic registration needed!
   // All devices and topics are defined once in the Device Registry section above.
 }
@@ -707,6 +710,22 @@ bool build_heartbeat_payload(JsonDocument &doc, void *ctx)
 // Status Publishing
 // ──────────────────────────────────────────────────────────────────────────────
 
+void on_timed_output_done(const SentientPulseDone &done, void *ctx)
+{
+  (void)ctx;
+  // A Replaced completion means a newer trigger or a cancel owns the output
+  // now; only a pulse that ran to its end releases the fog trigger
+  if (done.result != SentientPulseResult::Done)
+  {
+    return;
+  }
+  if (done.output == fog_trigger_output && fog_trigger_on)
+  {
+    fog_trigger_on = false;
+    publish_hardware_status();
+  }
+}
+
 void publish_hardware_status()
 {
   JsonDocument doc;
@@ -21,10 +21,11 @@
 #define MQTT_MAX_PACKET_SIZE 1024 // Raised for larger control/registration packets
 #endif
 
-#include <SentientCapabilityManifest.h>
+#include <SentientManifestStream.h>
 #include <SentientMQTT.h>
 #include <SentientDeviceRegistry.h>
 #include <ArduinoJson.h>
+#include <SentientRfidReaders.h>
 #if __has_include(<NativeEthernet.h>)
 #include <NativeEthernet.h>
 #define SENTIENT_HAS_NATIVE_ETHERNET 1
@@ -72,7 +73,6 @@ const int maglocks_pin = 36;
 // Configuration Constants
 // ──────────────────────────────────────────────────────────────────────────────
 const unsigned long heartbeat_interval_ms = 5000;
-const int id_buffer_len = 20;
 
 // ──────────────────────────────────────────────────────────────────────────────
 // MQTT Configuration
@@ -87,37 +87,26 @@ static const size_t metadata_json_capacity = 2048;
 // ──────────────────────────────────────────────────────────────────────────────
 // Hardware State Variables (NOT game state - just hardware execution flags)
 // ──────────────────────────────────────────────────────────────────────────────
-// RFID tag buffers
-char tag_buffer_a[id_buffer_len] = "";
-char tag_buffer_b[id_buffer_len] = "";
-char tag_buffer_c[id_buffer_len] = "";
-char tag_buffer_d[id_buffer_len] = "";
-char tag_buffer_e[id_buffer_len] = "";
-char tag_buffer_f[id_buffer_len] = "";
-
-// Tag presence flags
-bool tag_present_a = false;
-bool tag_present_b = false;
-bool tag_present_c = false;
-bool tag_present_d = false;
-bool tag_present_e = false;
-bool tag_present_f = false;
-
-// Last published states for change detection
-char last_tag_a[id_buffer_len] = "";
-char last_tag_b[id_buffer_len] = "";
-char last_tag_c[id_buffer_len] = "";
-char last_tag_d[id_buffer_len] = "";
-char last_tag_e[id_buffer_len] = "";
-char last_tag_f[id_buffer_len] = "";
-
-// Last TIR states for change detection
-bool last_tir_a = false;
-bool last_tir_b = false;
-bool last_tir_c = false;
-bool last_tir_d = false;
-bool last_tir_e = false;
-bool last_tir_f = false;
+// RFID readers, in registry order: A..F
+struct RfidReaderDef
+{
+  HardwareSerial &port;
+  int tir_pin;
+  const char *device_id;
+  const char *sensor_name;
+};
+
+const RfidReaderDef rfid_readers[] = {
+    {RFID_A, tir_pin_a, naming::DEV_RFID_A, naming::SENSOR_RFID_TAG_A},
+    {RFID_B, tir_pin_b, naming::DEV_RFID_B, naming::SENSOR_RFID_TAG_B},
+    {RFID_C, tir_pin_c, naming::DEV_RFID_C, naming::SENSOR_RFID_TAG_C},
+    {RFID_D, tir_pin_d, naming::DEV_RFID_D, naming::SENSOR_RFID_TAG_D},
+    {RFID_E, tir_pin_e, naming::DEV_RFID_E, naming::SENSOR_RFID_TAG_E},
+    {RFID_F, tir_pin_f, naming::DEV_RFID_F, naming::SENSOR_RFID_TAG_F}};
+const int rfid_reader_count = sizeof(rfid_readers) / sizeof(rfid_readers[0]);
+
+// Per-port framing, checksum validation and TIR-fused presence
+SentientRfidReaders rfid;
 
 // Actuator state
 bool actuator_moving = false;
@@ -125,10 +114,7 @@ bool actuator_moving = false;
 // ──────────────────────────────────────────────────────────────────────────────
 // Forward Declarations
 // ──────────────────────────────────────────────────────────────────────────────
-void handle_rfid_reader(HardwareSerial &rfid, char *tag_buffer, bool *tag_present,
-                        bool *last_tir, int tir_pin, const char *reader_name, const char *sensor_name);
-void process_rfid_byte(char incoming_char, char *tag_buffer);
-void publish_rfid_state(const char *reader_name, const char *sensor_name, const char *tag_id, bool is_present);
+void publish_rfid_state(int reader);
 void handle_mqtt_command(const char *command, const JsonDocument &payload, void *ctx);
 void publish_command_acknowledgement(const char *device_id, const char *command);
 
@@ -137,91 +123,99 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
 // ══════════════════════════════════════════════════════════════════════════════
 
 // Define command arrays
-const char *actuator_commands[] = {
+constexpr const char *actuator_commands[] PROGMEM = {
     naming::CMD_ACTUATOR_FORWARD,
     naming::CMD_ACTUATOR_REVERSE,
     naming::CMD_ACTUATOR_STOP};
 
-const char *maglock_commands[] = {
+constexpr const char *maglock_commands[] PROGMEM = {
     naming::CMD_MAGLOCKS_LOCK,
     naming::CMD_MAGLOCKS_UNLOCK};
 
 // Define sensor arrays for each RFID reader
-const char *rfid_a_sensors[] = {
+constexpr const char *rfid_a_sensors[] PROGMEM = {
     naming::SENSOR_RFID_TAG_A,
     naming::SENSOR_TIR_A};
 
-const char *rfid_b_sensors[] = {
+constexpr const char *rfid_b_sensors[] PROGMEM = {
     naming::SENSOR_RFID_TAG_B,
     naming::SENSOR_TIR_B};
 
-const char *rfid_c_sensors[] = {
+constexpr const char *rfid_c_sensors[] PROGMEM = {
     naming::SENSOR_RFID_TAG_C,
     naming::SENSOR_TIR_C};
 
-const char *rfid_d_sensors[] = {
+constexpr const char *rfid_d_sensors[] PROGMEM = {
     naming::SENSOR_RFID_TAG_D,
     naming::SENSOR_TIR_D};
 
-const char *rfid_e_sensors[] = {
+constexpr const char *rfid_e_sensors[] PROGMEM = {
     naming::SENSOR_RFID_TAG_E,
     naming::SENSOR_TIR_E};
 
-const char *rfid_f_sensors[] = {
+constexpr const char *rfid_f_sensors[] PROGMEM = {
     naming::SENSOR_RFID_TAG_F,
     naming::SENSOR_TIR_F};
 
 // Create device definitions with canonical IDs and friendly names
-SentientDeviceDef dev_rfid_a(
+constexpr SentientDeviceDef dev_rfid_a PROGMEM(
     naming::DEV_RFID_A,
     naming::FRIENDLY_RFID_A,
     "sensor",
     rfid_a_sensors, 2, true); // true = input device (sensor only)
 
-SentientDeviceDef dev_rfid_b(
+constexpr SentientDeviceDef dev_rfid_b PROGMEM(
     naming::DEV_RFID_B,
     naming::FRIENDLY_RFID_B,
     "sensor",
     rfid_b_sensors, 2, true); // true = input device (sensor only)
 
-SentientDeviceDef dev_rfid_c(
+constexpr SentientDeviceDef dev_rfid_c PROGMEM(
     naming::DEV_RFID_C,
     naming::FRIENDLY_RFID_C,
     "sensor",
     rfid_c_sensors, 2, true); // true = input device (sensor only)
 
-SentientDeviceDef dev_rfid_d(
+constexpr SentientDeviceDef dev_rfid_d PROGMEM(
     naming::DEV_RFID_D,
     naming::FRIENDLY_RFID_D,
     "sensor",
     rfid_d_sensors, 2, true); // true = input device (sensor only)
 
-SentientDeviceDef dev_rfid_e(
+constexpr SentientDeviceDef dev_rfid_e PROGMEM(
     naming::DEV_RFID_E,
     naming::FRIENDLY_RFID_E,
     "sensor",
     rfid_e_sensors, 2, true); // true = input device (sensor only)
 
-SentientDeviceDef dev_rfid_f(
+constexpr SentientDeviceDef dev_rfid_f PROGMEM(
     naming::DEV_RFID_F,
     naming::FRIENDLY_RFID_F,
     "sensor",
     rfid_f_sensors, 2, true); // true = input device (sensor only)
 
-SentientDeviceDef dev_actuator(
+constexpr SentientDeviceDef dev_actuator PROGMEM(
     naming::DEV_ACTUATOR,
     naming::FRIENDLY_ACTUATOR,
     "actuator",
     actuator_commands, 3);
 
-SentientDeviceDef dev_maglocks(
+constexpr SentientDeviceDef dev_maglocks PROGMEM(
     naming::DEV_MAGLOCKS,
     naming::FRIENDLY_MAGLOCKS,
     "relay",
     maglock_commands, 2);
 
 // Create the device registry
-SentientDeviceRegistry deviceRegistry;
+SENTIENT_DEVICE_REGISTRY(deviceRegistry,
+  &dev_rfid_a,
+  &dev_rfid_b,
+  &dev_rfid_c,
+  &dev_rfid_d,
+  &dev_rfid_e,
+  &dev_rfid_f,
+  &dev_actuator,
+  &dev_maglocks);
 
 // ══════════════════════════════════════════════════════════════════════════════
 // SECTION 3: SENTIENT MQTT INITIALIZATION
@@ -253,7 +247,7 @@ SentientMQTT sentient(make_mqtt_config());
 // SECTION 3.5: CAPABILITY MANIFEST
 // ══════════════════════════════════════════════════════════════════════════════
 
-SentientCapabilityManifest manifest;
+SentientManifestStream manifest(deviceRegistry);
 
 // ══════════════════════════════════════════════════════════════════════════════
 // SECTION 4: SETUP
@@ -270,21 +264,12 @@ void setup()
   Serial.println("╚════════════════════════════════════════════════╝");
   Serial.println();
 
-  // Initialize RFID Serial Ports
-  RFID_A.begin(9600);
-  RFID_B.begin(9600);
-  RFID_C.begin(9600);
-  RFID_D.begin(9600);
-  RFID_E.begin(9600);
-  RFID_F.begin(9600);
-
-  // Initialize TIR sensor pins
-  pinMode(tir_pin_a, INPUT_PULLDOWN);
-  pinMode(tir_pin_b, INPUT_PULLDOWN);
-  pinMode(tir_pin_c, INPUT_PULLDOWN);
-  pinMode(tir_pin_d, INPUT_PULLDOWN);
-  pinMode(tir_pin_e, INPUT_PULLDOWN);
-  pinMode(tir_pin_f, INPUT_PULLDOWN);
+  // Initialize RFID serial ports and TIR sensor pins
+  for (int i = 0; i < rfid_reader_count; i++)
+  {
+    rfid.add(rfid_readers[i].port, rfid_readers[i].tir_pin, INPUT_PULLDOWN);
+  }
+  rfid.begin(9600);
 
   // Initialize actuator and maglock pins
   pinMode(actuator_fwd_pin, OUTPUT);
@@ -300,16 +285,6 @@ void setup()
 
   Serial.println("[INIT] Hardware initialized");
 
-  // Register all devices
-  Serial.println("[INIT] Registering devices...");
-  deviceRegistry.addDevice(&dev_rfid_a);
-  deviceRegistry.addDevice(&dev_rfid_b);
-  deviceRegistry.addDevice(&dev_rfid_c);
-  deviceRegistry.addDevice(&dev_rfid_d);
-  deviceRegistry.addDevice(&dev_rfid_e);
-  deviceRegistry.addDevice(&dev_rfid_f);
-  deviceRegistry.addDevice(&dev_actuator);
-  deviceRegistry.addDevice(&dev_maglocks);
   deviceRegistry.printSummary();
 
   // Build capability manifest
@@ -321,8 +296,6 @@ void setup()
       naming::ROOM_ID,
       naming::CONTROLLER_ID);
 
-  // Auto-generate manifest from device registry
-  deviceRegistry.buildManifest(manifest);
   Serial.println("[INIT] Manifest built from device registry");
 
   // Initialize Sentient MQTT
@@ -346,9 +319,9 @@ void setup()
 
     // Register with Sentient system
     Serial.println("[INIT] Registering with Sentient system...");
-    if (manifest.publish_registration(sentient.get_client(), naming::ROOM_ID, naming::CONTROLLER_ID))
+    if (manifest.publish_registration(sentient, naming::ROOM_ID, naming::CONTROLLER_ID))
     {
-      Serial.println("[INIT] Registration successful!");
+      Serial.println("[INIT] Registration started");
     }
     else
     {
@@ -375,123 +348,49 @@ void loop()
   // LISTEN: Maintain MQTT connection and process incoming messages
   // ────────────────────────────────────────────────────────────────────────────
   sentient.loop();
+  manifest.loop();
 
   // ────────────────────────────────────────────────────────────────────────────
   // DETECT: Monitor all RFID readers and publish tag changes
   // ────────────────────────────────────────────────────────────────────────────
-  handle_rfid_reader(RFID_A, tag_buffer_a, &tag_present_a, &last_tir_a, tir_pin_a, naming::DEV_RFID_A, naming::SENSOR_RFID_TAG_A);
-  handle_rfid_reader(RFID_B, tag_buffer_b, &tag_present_b, &last_tir_b, tir_pin_b, naming::DEV_RFID_B, naming::SENSOR_RFID_TAG_B);
-  handle_rfid_reader(RFID_C, tag_buffer_c, &tag_present_c, &last_tir_c, tir_pin_c, naming::DEV_RFID_C, naming::SENSOR_RFID_TAG_C);
-  handle_rfid_reader(RFID_D, tag_buffer_d, &tag_present_d, &last_tir_d, tir_pin_d, naming::DEV_RFID_D, naming::SENSOR_RFID_TAG_D);
-  handle_rfid_reader(RFID_E, tag_buffer_e, &tag_present_e, &last_tir_e, tir_pin_e, naming::DEV_RFID_E, naming::SENSOR_RFID_TAG_E);
-  handle_rfid_reader(RFID_F, tag_buffer_f, &tag_present_f, &last_tir_f, tir_pin_f, naming::DEV_RFID_F, naming::SENSOR_RFID_TAG_F);
-
-  // ────────────────────────────────────────────────────────────────────────────
-  // EXECUTE: All command execution happens in execute_command() callback
-  // ────────────────────────────────────────────────────────────────────────────
-}
-
-// ══════════════════════════════════════════════════════════════════════════════
-// SECTION 6: RFID READER FUNCTIONS
-// ══════════════════════════════════════════════════════════════════════════════
-
-void handle_rfid_reader(HardwareSerial &rfid, char *tag_buffer, bool *tag_present,
-                        bool *last_tir, int tir_pin, const char *reader_name, const char *sensor_name)
-{
-  // Process incoming RFID data
-  while (rfid.available())
-  {
-    char incoming_char = rfid.read();
-    process_rfid_byte(incoming_char, tag_buffer);
-  }
-
-  // Check Tag-in-Range (TIR) sensor
-  bool current_tir = (digitalRead(tir_pin) == HIGH);
-
-  // Update tag presence based on TIR sensor
-  if (!current_tir)
-  {
-    // No tag in range
-    if (*tag_present)
-    {
-      // Tag was present, now removed
-      *tag_present = false;
-      tag_buffer[0] = '\0';
-      publish_rfid_state(reader_name, sensor_name, "", false);
-    }
-  }
-  else
+  const uint32_t rfid_changed = rfid.update();
+  for (int i = 0; i < rfid_reader_count; i++)
   {
-    // Tag in range
-    if (!*tag_present && tag_buffer[0] != '\0')
+    if (rfid_changed & SentientRfidReaders::bit(i))
     {
-      // New tag detected
-      *tag_present = true;
-      publish_rfid_state(reader_name, sensor_name, tag_buffer, true);
+      publish_rfid_state(i);
     }
   }
 
-  *last_tir = current_tir;
-}
-
-void process_rfid_byte(char incoming_char, char *tag_buffer)
-{
-  static char temp_buffer[32];
-  static int buffer_index = 0;
-  static bool packet_started = false;
-
-  if (incoming_char == 0x02)
-  {
-    // STX - Start of packet
-    buffer_index = 0;
-    packet_started = true;
-  }
-  else if (incoming_char == 0x03 && packet_started)
-  {
-    // ETX - End of packet
-    temp_buffer[buffer_index] = '\0';
-
-    // Remove trailing CR if present
-    int len = strlen(temp_buffer);
-    if (len > 0 && temp_buffer[len - 1] == '\r')
-    {
-      temp_buffer[len - 1] = '\0';
-    }
-
-    // Copy to tag buffer
-    strncpy(tag_buffer, temp_buffer, id_buffer_len - 1);
-    tag_buffer[id_buffer_len - 1] = '\0';
-
-    packet_started = false;
-  }
-  else if (packet_started && buffer_index < (int)sizeof(temp_buffer) - 1)
-  {
-    // Store character
-    temp_buffer[buffer_index++] = incoming_char;
-  }
+  // ────────────────────────────────────────────────────────────────────────────
+  // EXECUTE: All command execution happens in execute_command() callback
+  // ────────────────────────────────────────────────────────────────────────────
 }
 
 // ══════════════════════════════════════════════════════════════════════════════
 // SECTION 7: SENSOR PUBLISHING
 // ══════════════════════════════════════════════════════════════════════════════
 
-void publish_rfid_state(const char *reader_name, const char *sensor_name, const char *tag_id, bool is_present)
+void publish_rfid_state(int reader)
 {
-  if (!sentient.isConnected())
-    return;
+  const bool is_present = rfid.present(reader);
+  char tag_id[SENTIENT_RFID_TAG_TEXT];
+  SentientRfidReaders::formatTag(rfid.tag(reader), tag_id);
 
+  // No connection check: tag arrivals during a broker blip are queued and replayed
   // Build JSON document
   JsonDocument doc;
-  doc["reader"] = reader_name;
+  doc["reader"] = rfid_readers[reader].device_id;
   doc["tag_id"] = tag_id;
   doc["present"] = is_present;
   doc["timestamp"] = millis();
+  doc["latency_us"] = rfid.ageMicros(reader); // Frame or TIR edge on the wire -> publish
 
   // Publish to sensors/{reader_name}/{sensor_name}
-  sentient.publishJson(naming::CAT_SENSORS, sensor_name, doc);
+  sentient.publishJson(naming::CAT_SENSORS, rfid_readers[reader].sensor_name, doc);
 
   Serial.print("[RFID] ");
-  Serial.print(reader_name);
+  Serial.print(rfid_readers[reader].device_id);
   Serial.print(": ");
   if (is_present)
   {
@@ -612,7 +511,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
                     String(naming::CAT_ACKNOWLEDGEMENT) + "/" + String(naming::CONTROLLER_ID) + "/" +
                     String(device_id) + "/" + String(command);
 
-  sentient.get_client().publish(ackTopic.c_str(), buf, false);
+  sentient.publishTopic(ackTopic.c_str(), buf);
 
   Serial.print("[ACK] -> ");
   Serial.println(ackTopic);
@@ -17,10 +17,14 @@
 // - Clock fog power, blacklight, laser light
 // ═══════════════════════════════════════════════════════════════════════════════
 
+#define SENTIENT_PROFILE 1 // Loop timing on metrics/profile
 #include <SentientMQTT.h>
 #include <SentientDeviceRegistry.h>
 #include <SentientCapabilityManifest.h>
+#include <SentientMotionPlanner.h>
 #include <ArduinoJson.h>
+#include <SentientEncoder.h>
+#include <SentientAnalogScanner.h>
 #include <FastLED.h>
 #include "controller_naming.h"
 #include "FirmwareMetadata.h"
@@ -54,6 +58,7 @@ using namespace naming;
 #define RESISTOR_6 21
 #define RESISTOR_7 22
 #define RESISTOR_8 23
+#define RESISTOR_REFERENCE_OHMS 100.0 // Series reference resistor of each divider
 
 // Crank Puzzle Rotary Encoders
 #define ENCODER_BOTTOM_CLK 24
@@ -107,11 +112,54 @@ SentientMQTTConfig build_mqtt_config()
 
 SentientMQTT sentient(build_mqtt_config());
 SentientCapabilityManifest manifest;
-SentientDeviceRegistry deviceRegistry;
 
 // Forward declaration for acknowledgement publishing
 void publish_command_acknowledgement(const char *device_id, const char *command);
 
+// Legacy string-valued commands. They are not tied to a device, so they are
+// routed under any device segment (or none) and take the payload string.
+void activateHandler(const char *value);
+void stateHandler(const char *data);
+void pilasterHandler(const char *data);
+void fogMachineHandler(const char *data);
+void blacklightHandler(const char *data);
+void operatorMaglockHandler(const char *data);
+void woodDoorMaglockHandler(const char *data);
+void exitDoorFWDHandler(const char *data);
+void exitDoorRWDHandler(const char *data);
+void metalDoorFWDHandler(const char *data);
+void metalDoorRWDHandler(const char *data);
+void laserLightHandler(const char *data);
+
+struct ValueCommand
+{
+    const char *name;
+    void (*handler)(const char *value);
+};
+
+const ValueCommand value_commands[] = {
+    {"activate", activateHandler},
+    {"state", stateHandler},
+    {"pilaster", pilasterHandler},
+    {"fogMachine", fogMachineHandler},
+    {"blacklights", blacklightHandler},
+    {"OperatorMaglock", operatorMaglockHandler},
+    {"WoodDoorMaglock", woodDoorMaglockHandler},
+    {"ExitDoorFWD", exitDoorFWDHandler},
+    {"ExitDoorRWD", exitDoorRWDHandler},
+    {"MetalDoorFWD", metalDoorFWDHandler},
+    {"MetalDoorRWD", metalDoorRWDHandler},
+    {"laserLights", laserLightHandler},
+};
+
+void handle_value_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx)
+{
+    if (payload.is<const char *>())
+    {
+        static_cast<const ValueCommand *>(ctx)->handler(payload.as<const char *>());
+    }
+}
+
 void build_capability_manifest()
 {
     manifest.set_controller_info(
@@ -151,22 +199,24 @@ bool systemActive = false;
 bool ledStripsActive = false;
 
 // Stepper Control Variables
-long minutePosition = 0;
-long hourPosition = 0;
-long gearPosition = 0;
+// Step pulses come from the SentientMotion timer ISR; axes are 0 = minute, 1 = hour, 2 = gear.
+// All three form group 0, so every move starts and finishes on all hands together.
+SentientMotionPlanner steppers;
 long minuteTarget = 0;
 long hourTarget = 0;
 long gearTarget = 0;
-unsigned long lastStepTime = 0;
-const unsigned long minStepInterval = 500;           // Minimum interval (max speed): 500μs (2000 steps/sec)
-const unsigned long maxStepInterval = 1000;          // Maximum interval (start speed): 1000μs (1000 steps/sec)
-const unsigned long accelSteps = 500;                // Steps to accelerate/decelerate over
-unsigned long currentStepInterval = maxStepInterval; // Current step timing (starts slow)
-long minuteStepsRemaining = 0;
-long hourStepsRemaining = 0;
-long gearStepsRemaining = 0;
-bool isAccelerating = false;
-bool isDecelerating = false;
+const float stepperStartRate = 1000.0;    // Start/stop speed: 1000 steps/sec
+const float stepperMaxRate = 2000.0;      // Cruise speed: 2000 steps/sec
+const float stepperAcceleration = 3000.0; // Average steps/sec² - S-curve reaches cruise speed in 750 steps
+const char *stepperMoveLabel = nullptr;   // Move in progress (drivers enabled), nullptr when idle
+unsigned long stepperMoveStartTime = 0;
+unsigned long stepperMoveTimeout = 0;
+long stepperMoveOrigin[3] = {0, 0, 0};
+bool stepperMovePending = false; // Targets changed while a move was running
+const char *stepperPendingLabel = nullptr;
+unsigned long stepperPendingTimeout = 0;
+bool gearAnimating = false; // Gears turning for effect; position restored when the move ends
+long gearRestPosition = 0;
 
 // Pilaster Stage Variables
 float currentTime = 0.0;                 // Current time in hours (0.0 = midnight, 6.5 = 6:30)
@@ -180,13 +230,18 @@ char pilasterData[50] = "";
 bool newPilasterData = false;
 
 // Crank Stage Variables
-volatile int encoderBottomCount = 0;
-volatile int encoderTopCount = 0;
-volatile int encoderTopBCount = 0;
-int lastEncoderBottomCount = 0;
+SentientEncoder encoderBottom;
+SentientEncoder encoderTopA;
+SentientEncoder encoderTopB;
+int lastEncoderBottomCount = 0; // Counts as of the last paced update
 int lastEncoderTopCount = 0;
 int lastEncoderTopBCount = 0;
 
+// Operator Stage: the eight dividers, scanned and filtered in the background
+SentientAnalogScanner resistorInputs;
+const int resistorPins[8] = {RESISTOR_1, RESISTOR_2, RESISTOR_3, RESISTOR_4,
+                             RESISTOR_5, RESISTOR_6, RESISTOR_7, RESISTOR_8};
+
 // Telemetry change detection
 char lastTelemetry[200] = "";
 bool telemetryInitialized = false;
@@ -227,6 +282,7 @@ void setup()
     initializeSteppers();
     initializeFastLED();
     initializeEncoders();
+    initializeResistorInputs();
     initializeOutputs();
 
     // Build capability manifest
@@ -246,36 +302,10 @@ void setup()
     }
 
     // Register Action Handlers
-    sentient.setCommandCallback([](const char *command, const JsonDocument &payload, void *context)
-                                {
-        if (payload.is<const char*>()) {
-            const char* value = payload.as<const char*>();
-            if (strcmp(command, "activate") == 0) {
-                activateHandler(value);
-            } else if (strcmp(command, "state") == 0) {
-                stateHandler(value);
-            } else if (strcmp(command, "pilaster") == 0) {
-                pilasterHandler(value);
-            } else if (strcmp(command, "fogMachine") == 0) {
-                fogMachineHandler(value);
-            } else if (strcmp(command, "blacklights") == 0) {
-                blacklightHandler(value);
-            } else if (strcmp(command, "OperatorMaglock") == 0) {
-                operatorMaglockHandler(value);
-            } else if (strcmp(command, "WoodDoorMaglock") == 0) {
-                woodDoorMaglockHandler(value);
-            } else if (strcmp(command, "ExitDoorFWD") == 0) {
-                exitDoorFWDHandler(value);
-            } else if (strcmp(command, "ExitDoorRWD") == 0) {
-                exitDoorRWDHandler(value);
-            } else if (strcmp(command, "MetalDoorFWD") == 0) {
-                metalDoorFWDHandler(value);
-            } else if (strcmp(command, "MetalDoorRWD") == 0) {
-                metalDoorRWDHandler(value);
-            } else if (strcmp(command, "laserLights") == 0) {
-                laserLightHandler(value);
-            }
-        } });
+    for (const ValueCommand &command : value_commands)
+    {
+        sentient.onCommand(SENTIENT_ANY_DEVICE, command.name, handle_value_command, const_cast<ValueCommand *>(&command));
+    }
 
     Serial.println("Clock Puzzle Controller Ready");
 }
@@ -284,13 +314,16 @@ void loop()
 {
     // Handle MQTT loop and registration
     static bool registered = false;
-    sentient.loop();
+    {
+        SENTIENT_PROBE("mqtt_loop");
+        sentient.loop();
+    }
 
     // Register after MQTT connection is established
     if (!registered && sentient.isConnected())
     {
         Serial.println("[Clock] Registering with Sentient system...");
-        if (manifest.publish_registration(sentient.get_client(), ROOM_ID, CONTROLLER_ID))
+        if (manifest.publish_registration(sentient, ROOM_ID, CONTROLLER_ID))
         {
             Serial.println("[Clock] Registration successful!");
             registered = true;
@@ -301,9 +334,20 @@ void loop()
         }
     }
 
-    handleStateMachine();
-    updateClockState();
-    runSteppers();
+    {
+        SENTIENT_PROBE("state_machine");
+        handleStateMachine();
+    }
+    {
+        SENTIENT_PROBE("clock_state");
+        updateClockState();
+    }
+    {
+        SENTIENT_PROBE("steppers");
+        serviceSteppers();
+    }
+
+    SENTIENT_PROFILE_REPORT(sentient, 10000);
 }
 
 // ═══════════════════════════════════════════════════════════════
@@ -326,38 +370,20 @@ void setStepperTarget(int motor, long target)
     {
     case 0: // Minute motor
         minuteTarget = target;
-        minuteStepsRemaining = abs(target - minutePosition);
         break;
     case 1: // Hour motor
         hourTarget = target;
-        hourStepsRemaining = abs(target - hourPosition);
         break;
     case 2: // Gear motor
         gearTarget = target;
-        gearStepsRemaining = abs(target - gearPosition);
         break;
     }
-
-    // Reset acceleration when new target is set
-    currentStepInterval = maxStepInterval; // Start slow
-    isAccelerating = false;
-    isDecelerating = false;
 }
 
 // Get current position of a stepper motor
 long getStepperPosition(int motor)
 {
-    switch (motor)
-    {
-    case 0:
-        return minutePosition;
-    case 1:
-        return hourPosition;
-    case 2:
-        return gearPosition;
-    default:
-        return 0;
-    }
+    return steppers.position(motor);
 }
 
 // Check if stepper has reached target
@@ -366,212 +392,107 @@ bool stepperAtTarget(int motor)
     switch (motor)
     {
     case 0:
-        return minutePosition == minuteTarget;
+        return getStepperPosition(0) == minuteTarget;
     case 1:
-        return hourPosition == hourTarget;
+        return getStepperPosition(1) == hourTarget;
     case 2:
-        return gearPosition == gearTarget;
+        return getStepperPosition(2) == gearTarget;
     default:
         return true;
     }
 }
 
-// Step a single motor in differential mode
-void stepMotor(int motor, bool direction)
+// Start moving all motors toward their targets in the background. Moves never
+// overlap: a request made while one is running waits for it to finish, and the
+// latest targets win.
+void startStepperMove(const char *label, unsigned long timeoutMs)
 {
-    int stepPos, stepNeg, dirPos, dirNeg;
-
-    // Get pin assignments for the motor
-    switch (motor)
-    {
-    case 0: // Minute motor
-        stepPos = CLOCK_MINUTE_STEP_POS;
-        stepNeg = CLOCK_MINUTE_STEP_NEG;
-        dirPos = CLOCK_MINUTE_DIR_POS;
-        dirNeg = CLOCK_MINUTE_DIR_NEG;
-        break;
-    case 1: // Hour motor
-        stepPos = CLOCK_HOUR_STEP_POS;
-        stepNeg = CLOCK_HOUR_STEP_NEG;
-        dirPos = CLOCK_HOUR_DIR_POS;
-        dirNeg = CLOCK_HOUR_DIR_NEG;
-        break;
-    case 2: // Gear motor
-        stepPos = CLOCK_GEARS_STEP_POS;
-        stepNeg = CLOCK_GEARS_STEP_NEG;
-        dirPos = CLOCK_GEARS_DIR_POS;
-        dirNeg = CLOCK_GEARS_DIR_NEG;
-        break;
-    default:
-        return; // Invalid motor
-    }
-
-    // Debug: Print step pulse generation for first few steps
-    static int stepCount[3] = {0, 0, 0};
-    if (stepCount[motor] < 10) // Only print first 10 steps per motor to avoid spam
+    if (stepperMoveLabel != nullptr)
     {
-        Serial.println("Motor " + String(motor) + " step " + String(stepCount[motor]) +
-                       " - DIR:" + String(direction) + " on pins " + String(stepPos) + "/" + String(stepNeg));
+        Serial.println(String(label) + " queued until " + String(stepperMoveLabel) + " finishes");
+        stepperMovePending = true;
+        stepperPendingLabel = label;
+        stepperPendingTimeout = timeoutMs;
+        return;
     }
-    stepCount[motor]++;
 
-    // Set direction (invert direction for minute motor if it goes backwards)
-    if (motor == 0) // Minute motor - invert direction
-    {
-        digitalWrite(dirPos, direction ? LOW : HIGH);
-        digitalWrite(dirNeg, direction ? HIGH : LOW);
-    }
-    else // Hour and gear motors - normal direction
+    for (int motor = 0; motor < 3; motor++)
     {
-        digitalWrite(dirPos, direction ? HIGH : LOW);
-        digitalWrite(dirNeg, direction ? LOW : HIGH);
+        stepperMoveOrigin[motor] = getStepperPosition(motor);
     }
+    long targets[3] = {minuteTarget, hourTarget, gearTarget};
 
-    // Generate step pulse - DM542 differential signaling
-    // For DM542: STEP+ goes HIGH, STEP- stays LOW for step pulse
-    digitalWrite(stepPos, HIGH);
-    digitalWrite(stepNeg, LOW);
-    delayMicroseconds(10); // Pulse width for DM542
-    digitalWrite(stepPos, LOW);
-    digitalWrite(stepNeg, LOW);
-    delayMicroseconds(10); // Settling time
-
-    // Update position
-    switch (motor)
+    // Animate gears when hands are moving to look realistic: turn them clockwise
+    // for as long as the longest hand move, then put their position back
+    long handSteps = max(abs(minuteTarget - stepperMoveOrigin[0]), abs(hourTarget - stepperMoveOrigin[1]));
+    if (gearTarget == stepperMoveOrigin[2] && handSteps > 0)
     {
-    case 0:
-        minutePosition += direction ? 1 : -1;
-        break;
-    case 1:
-        hourPosition += direction ? 1 : -1;
-        break;
-    case 2:
-        gearPosition += direction ? 1 : -1;
-        break;
+        gearAnimating = true;
+        gearRestPosition = gearTarget;
+        targets[2] = gearTarget + handSteps;
     }
-}
 
-// Animate gear motor without position tracking (for visual effect)
-void animateGearMotor(bool direction)
-{
-    // Set direction
-    digitalWrite(CLOCK_GEARS_DIR_POS, direction ? HIGH : LOW);
-    digitalWrite(CLOCK_GEARS_DIR_NEG, direction ? LOW : HIGH);
-
-    // Generate step pulse - DM542 differential signaling
-    digitalWrite(CLOCK_GEARS_STEP_POS, HIGH);
-    digitalWrite(CLOCK_GEARS_STEP_NEG, LOW);
-    delayMicroseconds(10); // Pulse width for DM542
-    digitalWrite(CLOCK_GEARS_STEP_POS, LOW);
-    digitalWrite(CLOCK_GEARS_STEP_NEG, LOW);
-    delayMicroseconds(10); // Settling time
+    // Enable stepper motors (LOW = enabled for most stepper drivers)
+    digitalWrite(STEPPER_ENABLE, LOW);
+    steppers.moveTo(0, targets);
 
-    // Note: Don't update gearPosition for animation - this is just visual effect
+    stepperMoveLabel = label;
+    stepperMoveStartTime = millis();
+    stepperMoveTimeout = timeoutMs;
 }
 
-// Run all steppers toward their targets with acceleration
-void runSteppers()
+// Called from loop(): reports progress and releases the drivers once every motor has arrived
+void serviceSteppers()
 {
-    unsigned long currentTime = micros();
-
-    // Calculate dynamic step interval based on movement progress
-    currentStepInterval = calculateStepInterval();
+    static unsigned long lastDebugTime = 0;
 
-    // Check if it's time for the next step
-    if (currentTime - lastStepTime >= currentStepInterval)
+    if (stepperMoveLabel == nullptr)
     {
-        lastStepTime = currentTime;
-
-        // Track if any hand is moving for gear animation
-        bool handIsMoving = false;
-
-        // Move minute motor toward target
-        if (minutePosition != minuteTarget)
-        {
-            bool direction = minuteTarget > minutePosition;
-            stepMotor(0, direction);
-            minuteStepsRemaining = abs(minuteTarget - minutePosition);
-            handIsMoving = true;
-        }
+        return;
+    }
 
-        // Move hour motor toward target
-        if (hourPosition != hourTarget)
+    if (steppers.busy())
+    {
+        // Print debug info every 500ms during movement
+        if (millis() - lastDebugTime > 500)
         {
-            bool direction = hourTarget > hourPosition;
-            stepMotor(1, direction);
-            hourStepsRemaining = abs(hourTarget - hourPosition);
-            handIsMoving = true;
+            Serial.println("Movement progress - Current: M:" + String(getStepperPosition(0)) +
+                           " H:" + String(getStepperPosition(1)) + " G:" + String(getStepperPosition(2)) +
+                           " | Target: M:" + String(minuteTarget) +
+                           " H:" + String(hourTarget) + " G:" + String(gearTarget));
+            lastDebugTime = millis();
         }
 
-        // Move gear motor toward target OR animate gears when hands are moving
-        if (gearPosition != gearTarget)
-        {
-            bool direction = gearTarget > gearPosition;
-            stepMotor(2, direction);
-            gearStepsRemaining = abs(gearTarget - gearPosition);
-        }
-        else if (handIsMoving)
+        if (millis() - stepperMoveStartTime <= stepperMoveTimeout)
         {
-            // Animate gears when hands are moving to look realistic
-            // Use dedicated animation function that doesn't affect position tracking
-            animateGearMotor(true); // Constant clockwise rotation for animation
+            return;
         }
+        Serial.println("WARNING: " + String(stepperMoveLabel) + " timeout after " + String(stepperMoveTimeout / 1000) + " seconds!");
+        steppers.halt();
     }
-}
-
-// Calculate dynamic step interval with acceleration/deceleration
-unsigned long calculateStepInterval()
-{
-    // Find the maximum steps remaining from any active motor
-    long maxStepsRemaining = max(minuteStepsRemaining, max(hourStepsRemaining, gearStepsRemaining));
 
-    if (maxStepsRemaining == 0)
+    if (gearAnimating)
     {
-        return maxStepInterval; // No movement, return to slow speed
+        // Note: Don't track gear animation - this is just visual effect
+        steppers.setPosition(2, gearRestPosition);
+        gearAnimating = false;
     }
 
-    // Calculate total steps for the current movement
-    long totalSteps = max(abs(minuteTarget - minutePosition),
-                          max(abs(hourTarget - hourPosition),
-                              abs(gearTarget - gearPosition)));
+    // Disable stepper motors to reduce power consumption and heat (HIGH = disabled)
+    digitalWrite(STEPPER_ENABLE, HIGH);
 
-    if (totalSteps <= accelSteps * 2)
-    {
-        // Short movement - use linear ramp up/down
-        float progress = (float)(totalSteps - maxStepsRemaining) / (float)totalSteps;
-        if (progress < 0.5)
-        {
-            // Accelerating (first half)
-            return maxStepInterval - (unsigned long)((maxStepInterval - minStepInterval) * progress * 2);
-        }
-        else
-        {
-            // Decelerating (second half)
-            return minStepInterval + (unsigned long)((maxStepInterval - minStepInterval) * (progress - 0.5) * 2);
-        }
-    }
-    else
-    {
-        // Long movement - accelerate for accelSteps, cruise, then decelerate
-        long stepsTaken = totalSteps - maxStepsRemaining;
+    Serial.println(String(stepperMoveLabel) + " complete in " + String(millis() - stepperMoveStartTime) + "ms");
+    Serial.println("Final positions - Minute: " + String(getStepperPosition(0)) +
+                   ", Hour: " + String(getStepperPosition(1)) + ", Gear: " + String(getStepperPosition(2)));
+    Serial.println("Steps moved - Minute: " + String(getStepperPosition(0) - stepperMoveOrigin[0]) +
+                   ", Hour: " + String(getStepperPosition(1) - stepperMoveOrigin[1]) +
+                   ", Gear: " + String(getStepperPosition(2) - stepperMoveOrigin[2]));
+    stepperMoveLabel = nullptr;
 
-        if (stepsTaken < accelSteps)
-        {
-            // Accelerating phase
-            float progress = (float)stepsTaken / (float)accelSteps;
-            return maxStepInterval - (unsigned long)((maxStepInterval - minStepInterval) * progress);
-        }
-        else if (maxStepsRemaining < accelSteps)
-        {
-            // Decelerating phase
-            float progress = (float)(accelSteps - maxStepsRemaining) / (float)accelSteps;
-            return minStepInterval + (unsigned long)((maxStepInterval - minStepInterval) * progress);
-        }
-        else
-        {
-            // Cruising phase - full speed
-            return minStepInterval;
-        }
+    if (stepperMovePending)
+    {
+        stepperMovePending = false;
+        startStepperMove(stepperPendingLabel, stepperPendingTimeout);
     }
 }
 
@@ -676,9 +597,9 @@ void handleCrankStage()
     if (millis() - lastPrint > 1000) // Print every second
     {
         Serial.println("=== CRANK STAGE DEBUG ===");
-        Serial.println("Encoder Bottom Count: " + String(encoderBottomCount));
-        Serial.println("Encoder TopA Count: " + String(encoderTopCount));
-        Serial.println("Encoder TopB Count: " + String(encoderTopBCount));
+        Serial.println("Encoder Bottom Count: " + String(encoderBottom.position()));
+        Serial.println("Encoder TopA Count: " + String(encoderTopA.position()));
+        Serial.println("Encoder TopB Count: " + String(encoderTopB.position()));
         Serial.println("Last Encoder Bottom: " + String(lastEncoderBottomCount));
         Serial.println("Last Encoder TopA: " + String(lastEncoderTopCount));
         Serial.println("Last Encoder TopB: " + String(lastEncoderTopBCount));
@@ -689,11 +610,16 @@ void handleCrankStage()
         lastPrint = millis();
     }
 
-    // Monitor rotary encoders and send MQTT when target reached
-    if (encoderBottomCount != lastEncoderBottomCount ||
-        encoderTopCount != lastEncoderTopCount ||
-        encoderTopBCount != lastEncoderTopBCount)
+    // Monitor rotary encoders and send MQTT when target reached. Updates are
+    // paced by the encoders: every 50 ms while a crank turns, once when it stops.
+    const bool bottomDue = encoderBottom.publishDue();
+    const bool topADue = encoderTopA.publishDue();
+    const bool topBDue = encoderTopB.publishDue();
+    if (bottomDue || topADue || topBDue)
     {
+        const int encoderBottomCount = encoderBottom.position();
+        const int encoderTopCount = encoderTopA.position();
+        const int encoderTopBCount = encoderTopB.position();
         Serial.println("ENCODER CHANGE - Bottom: " + String(encoderBottomCount) +
                        ", TopA: " + String(encoderTopCount) +
                        ", TopB: " + String(encoderTopBCount));
@@ -806,39 +732,49 @@ void initializeFastLED()
 
 void initializeSteppers()
 {
-    // Initialize custom stepper control system
-    Serial.println("Initializing custom stepper control system...");
-
-    // Reset all positions and targets
-    minutePosition = 0;
-    hourPosition = 0;
-    gearPosition = 0;
+    // Initialize timer-driven stepper control system
+    Serial.println("Initializing stepper engine...");
+
+    // Axis order must match the motor numbers used everywhere else (0 = minute, 1 = hour, 2 = gear)
+    SentientAxisConfig axis;
+    axis.group = 0;
+    axis.pins = {CLOCK_MINUTE_STEP_POS, CLOCK_MINUTE_STEP_NEG, CLOCK_MINUTE_DIR_POS, CLOCK_MINUTE_DIR_NEG, true}; // Minute motor runs backwards
+    steppers.addAxis(axis);
+    axis.pins = {CLOCK_HOUR_STEP_POS, CLOCK_HOUR_STEP_NEG, CLOCK_HOUR_DIR_POS, CLOCK_HOUR_DIR_NEG, false};
+    steppers.addAxis(axis);
+    axis.pins = {CLOCK_GEARS_STEP_POS, CLOCK_GEARS_STEP_NEG, CLOCK_GEARS_DIR_POS, CLOCK_GEARS_DIR_NEG, false};
+    steppers.addAxis(axis);
+
+    SentientMotionConfig motion;
+    motion.startRate = stepperStartRate;
+    motion.maxRate = stepperMaxRate;
+    motion.acceleration = stepperAcceleration;
+    motion.profile = SentientMotionProfile::SCurve;
+    steppers.configureGroup(0, motion);
+
+    // Reset all targets
     minuteTarget = 0;
     hourTarget = 0;
     gearTarget = 0;
 
-    lastStepTime = micros();
-
-    Serial.println("Custom stepper system ready - 800 steps/sec, DM542 differential signaling");
+    Serial.println("Stepper engine ready - 2000 steps/sec, DM542 differential signaling");
 }
 
 void initializeEncoders()
 {
-    // Encoder pins
-    pinMode(ENCODER_BOTTOM_CLK, INPUT_PULLUP);
-    pinMode(ENCODER_BOTTOM_DT, INPUT_PULLUP);
-    pinMode(ENCODER_TOPA_CLK, INPUT_PULLUP);
-    pinMode(ENCODER_TOPA_DT, INPUT_PULLUP);
-    pinMode(ENCODER_TOPB_CLK, INPUT_PULLUP);
-    pinMode(ENCODER_TOPB_DT, INPUT_PULLUP);
-
-    // Attach interrupts for encoders - using RISING like GearOne
-    attachInterrupt(digitalPinToInterrupt(ENCODER_BOTTOM_CLK), encoderBottomCLKISR, RISING);
-    attachInterrupt(digitalPinToInterrupt(ENCODER_BOTTOM_DT), encoderBottomDTISR, RISING);
-    attachInterrupt(digitalPinToInterrupt(ENCODER_TOPA_CLK), encoderTopACLKISR, RISING);
-    attachInterrupt(digitalPinToInterrupt(ENCODER_TOPA_DT), encoderTopADTISR, RISING);
-    attachInterrupt(digitalPinToInterrupt(ENCODER_TOPB_CLK), encoderTopBCLKISR, RISING);
-    attachInterrupt(digitalPinToInterrupt(ENCODER_TOPB_DT), encoderTopBDTISR, RISING);
+    // CLK leads DT when the count goes up. 2 counts per cycle keeps the
+    // scale of the old rising-edge counting, so the crank thresholds hold.
+    SentientEncoderConfig encoder;
+    encoder.countsPerCycle = 2;
+    encoder.pinA = ENCODER_BOTTOM_CLK;
+    encoder.pinB = ENCODER_BOTTOM_DT;
+    encoderBottom.begin(encoder);
+    encoder.pinA = ENCODER_TOPA_CLK;
+    encoder.pinB = ENCODER_TOPA_DT;
+    encoderTopA.begin(encoder);
+    encoder.pinA = ENCODER_TOPB_CLK;
+    encoder.pinB = ENCODER_TOPB_DT;
+    encoderTopB.begin(encoder);
 
     Serial.println("Encoder setup complete:");
     Serial.println("  Encoder Bottom CLK Pin: " + String(ENCODER_BOTTOM_CLK));
@@ -847,7 +783,6 @@ void initializeEncoders()
     Serial.println("  Encoder TopA DT Pin: " + String(ENCODER_TOPA_DT));
     Serial.println("  Encoder TopB CLK Pin: " + String(ENCODER_TOPB_CLK));
     Serial.println("  Encoder TopB DT Pin: " + String(ENCODER_TOPB_DT));
-    Serial.println("  Interrupts attached to pins " + String(ENCODER_BOTTOM_CLK) + ", " + String(ENCODER_TOPA_CLK) + ", and " + String(ENCODER_TOPB_CLK));
 }
 
 void initializeOutputs()
@@ -892,25 +827,11 @@ void calibrateMinuteMotor(const char *data)
     Serial.println("=== MINUTE MOTOR CALIBRATION ===");
     Serial.println("Starting " + String(steps) + " step rotation test");
     Serial.println("Watch the minute hand and count full rotations");
-    Serial.println("Position before: " + String(minutePosition));
+    Serial.println("Position before: " + String(getStepperPosition(0)));
 
-    digitalWrite(STEPPER_ENABLE, LOW);
-
-    long startPosition = minutePosition;
-    setStepperTarget(0, minutePosition + steps);
-
-    unsigned long startTime = millis();
-    while (!stepperAtTarget(0) && (millis() - startTime < 30000)) // 30 second timeout
-    {
-        runSteppers();
-    }
-
-    long endPosition = minutePosition;
-    digitalWrite(STEPPER_ENABLE, HIGH);
-
-    Serial.println("Position after: " + String(endPosition));
-    Serial.println("Steps moved: " + String(endPosition - startPosition));
-    Serial.println("=== CALIBRATION COMPLETE ===");
+    // Runs in the background; the steps moved are reported when it finishes
+    setStepperTarget(0, minuteTarget + steps);
+    startStepperMove("Minute motor calibration", 30000); // 30 second timeout
 }
 
 void calibrateHourMotor(const char *data)
@@ -922,25 +843,11 @@ void calibrateHourMotor(const char *data)
     Serial.println("=== HOUR MOTOR CALIBRATION ===");
     Serial.println("Starting " + String(steps) + " step rotation test");
     Serial.println("Watch the hour hand and count full rotations");
-    Serial.println("Position before: " + String(hourPosition));
-
-    digitalWrite(STEPPER_ENABLE, LOW);
+    Serial.println("Position before: " + String(getStepperPosition(1)));
 
-    long startPosition = hourPosition;
-    setStepperTarget(1, hourPosition + steps);
-
-    unsigned long startTime = millis();
-    while (!stepperAtTarget(1) && (millis() - startTime < 30000)) // 30 second timeout
-    {
-        runSteppers();
-    }
-
-    long endPosition = hourPosition;
-    digitalWrite(STEPPER_ENABLE, HIGH);
-
-    Serial.println("Position after: " + String(endPosition));
-    Serial.println("Steps moved: " + String(endPosition - startPosition));
-    Serial.println("=== CALIBRATION COMPLETE ===");
+    // Runs in the background; the steps moved are reported when it finishes
+    setStepperTarget(1, hourTarget + steps);
+    startStepperMove("Hour motor calibration", 30000); // 30 second timeout
 }
 
 void calibrateGearMotor(const char *data)
@@ -952,49 +859,36 @@ void calibrateGearMotor(const char *data)
     Serial.println("=== GEAR MOTOR CALIBRATION ===");
     Serial.println("Starting " + String(steps) + " step rotation test");
     Serial.println("Watch the gears and count full rotations");
-    Serial.println("Position before: " + String(gearPosition));
-
-    digitalWrite(STEPPER_ENABLE, LOW);
-
-    long startPosition = gearPosition;
-    setStepperTarget(2, gearPosition + steps);
-
-    unsigned long startTime = millis();
-    while (!stepperAtTarget(2) && (millis() - startTime < 30000)) // 30 second timeout
-    {
-        runSteppers();
-    }
-
-    long endPosition = gearPosition;
-    digitalWrite(STEPPER_ENABLE, HIGH);
+    Serial.println("Position before: " + String(getStepperPosition(2)));
 
-    Serial.println("Position after: " + String(endPosition));
-    Serial.println("Steps moved: " + String(endPosition - startPosition));
-    Serial.println("=== CALIBRATION COMPLETE ===");
+    // Runs in the background; the steps moved are reported when it finishes
+    setStepperTarget(2, gearTarget + steps);
+    startStepperMove("Gear motor calibration", 30000); // 30 second timeout
 }
 
 // ================= RESISTOR READING FUNCTIONS =================
-float readResistance(int pin)
+void initializeResistorInputs()
 {
-    // Take multiple readings for averaging to improve stability
-    const int numReadings = 5;
-    int totalRaw = 0;
-
-    for (int i = 0; i < numReadings; i++)
+    // Channel i is resistorPins[i]; hysteresis keeps divider noise out of the telemetry
+    SentientAnalogFilter filter;
+    filter.smoothing = 3;
+    filter.hysteresis = 2;
+    for (int i = 0; i < 8; i++)
     {
-        totalRaw += analogRead(pin);
-        // No delay needed - ADC is fast enough
+        resistorInputs.add(resistorPins[i], filter);
     }
+    resistorInputs.begin();
+}
 
-    int rawValue = totalRaw / numReadings;
-
-    // Convert to voltage (assuming 5V reference and 10-bit ADC)
-    float voltage = (rawValue / 1023.0) * 5.0;
+float readResistance(int channel)
+{
+    // Latest filtered scan; no conversion happens here
+    const float supply = 3.3; // Dividers run from the Teensy's 3.3 V, which is also the ADC reference
+    float voltage = resistorInputs.voltage(channel);
 
     // Calculate resistance using voltage divider formula
-    // Assuming 100 ohm reference resistor in series (per documentation)
     float resistance;
-    if (voltage > 4.99) // Avoid division by zero
+    if (voltage > supply - 0.01) // Avoid division by zero
     {
         resistance = 999999.0; // Very high resistance (open circuit)
     }
@@ -1004,7 +898,7 @@ float readResistance(int pin)
     }
     else
     {
-        resistance = (5.0 - voltage) / voltage * 100.0; // 100 ohm reference resistor
+        resistance = (supply - voltage) / voltage * RESISTOR_REFERENCE_OHMS;
     }
 
     return resistance;
@@ -1043,70 +937,22 @@ void moveClockToTime(float timeInHours)
 
 void moveClockHands(int minutePos, int hourPos, int gearPos)
 {
-    Serial.println("Moving clock hands with custom stepper control - Minute: " + String(minutePos) +
+    Serial.println("Moving clock hands - Minute: " + String(minutePos) +
                    ", Hour: " + String(hourPos) + ", Gear: " + String(gearPos));
 
-    // Test STEPPER_ENABLE pin before and after
-    Serial.println("STEPPER_ENABLE pin state before: " + String(digitalRead(STEPPER_ENABLE)));
-
-    // Enable stepper motors (LOW = enabled for most stepper drivers)
-    digitalWrite(STEPPER_ENABLE, LOW);
-    Serial.println("Stepper motors ENABLED - pin state: " + String(digitalRead(STEPPER_ENABLE)));
-
     // Set all target positions first
-    minuteTarget = minutePos;
-    hourTarget = hourPos;
-    gearTarget = gearPos;
-
-    // Calculate steps remaining for all motors
-    minuteStepsRemaining = abs(minutePos - minutePosition);
-    hourStepsRemaining = abs(hourPos - hourPosition);
-    gearStepsRemaining = abs(gearPos - gearPosition);
-
-    // Reset acceleration state once for the entire movement
-    currentStepInterval = maxStepInterval; // Start slow
-    isAccelerating = false;
-    isDecelerating = false;
-
-    Serial.println("Custom stepper targets set - waiting for movement completion...");
-    Serial.println("Current positions - Minute: " + String(minutePosition) +
-                   ", Hour: " + String(hourPosition) + ", Gear: " + String(gearPosition));
+    setStepperTarget(0, minutePos);
+    setStepperTarget(1, hourPos);
+    setStepperTarget(2, gearPos);
+
+    Serial.println("Current positions - Minute: " + String(getStepperPosition(0)) +
+                   ", Hour: " + String(getStepperPosition(1)) + ", Gear: " + String(getStepperPosition(2)));
     Serial.println("Target positions - Minute: " + String(minuteTarget) +
                    ", Hour: " + String(hourTarget) + ", Gear: " + String(gearTarget));
 
-    unsigned long moveStartTime = millis();
-    unsigned long lastDebugTime = 0;
-
-    // Wait for all steppers to reach their target positions
-    while (!allSteppersAtTarget())
-    {
-        runSteppers(); // Explicitly call runSteppers() since this may be called from MQTT handlers
-
-        // Print debug info every 500ms during movement
-        if (millis() - lastDebugTime > 500)
-        {
-            Serial.println("Movement progress - Current: M:" + String(minutePosition) +
-                           " H:" + String(hourPosition) + " G:" + String(gearPosition) +
-                           " | Target: M:" + String(minuteTarget) +
-                           " H:" + String(hourTarget) + " G:" + String(gearTarget));
-            lastDebugTime = millis();
-        }
-
-        // Timeout after 30 seconds to prevent infinite loop
-        if (millis() - moveStartTime > 30000)
-        {
-            Serial.println("WARNING: Movement timeout after 30 seconds!");
-            Serial.println("Final positions - Minute: " + String(minutePosition) +
-                           ", Hour: " + String(hourPosition) + ", Gear: " + String(gearPosition));
-            break;
-        }
-    }
-
-    Serial.println("All steppers reached target positions");
-
-    // Disable stepper motors to reduce power consumption and heat (HIGH = disabled)
-    digitalWrite(STEPPER_ENABLE, HIGH);
-    Serial.println("Stepper motors DISABLED - pin state: " + String(digitalRead(STEPPER_ENABLE)));
+    // Step pulses run from the step timer while loop() keeps servicing MQTT;
+    // serviceSteppers() disables the motors once every hand has arrived
+    startStepperMove("Clock hand move", 30000);
 }
 
 // ================= STATE MONITORING FUNCTIONS =================
@@ -1114,6 +960,9 @@ void updateClockState()
 {
     // Update any periodic clock state monitoring
     // This can include encoder readings, sensor checks, etc.
+    encoderBottom.loop();
+    encoderTopA.loop();
+    encoderTopB.loop();
 
     // Update MQTT data based on current state
     updateMQTTData();
@@ -1142,20 +991,20 @@ void updateMQTTData()
 
     case CRANK:
         sprintf(telemetry, "State:%01X,Encoders:%d:%d:%d",
-                currentState, encoderBottomCount, encoderTopCount, encoderTopBCount);
+                currentState, lastEncoderBottomCount, lastEncoderTopCount, lastEncoderTopBCount);
         break;
 
     case OPERATOR:
     {
         // Read all 8 resistor values for MQTT transmission (divided by 100 for easier reading)
-        float r1 = readResistance(RESISTOR_1) / 100.0;
-        float r2 = readResistance(RESISTOR_2) / 100.0;
-        float r3 = readResistance(RESISTOR_3) / 100.0;
-        float r4 = readResistance(RESISTOR_4) / 100.0;
-        float r5 = readResistance(RESISTOR_5) / 100.0;
-        float r6 = readResistance(RESISTOR_6) / 100.0;
-        float r7 = readResistance(RESISTOR_7) / 100.0;
-        float r8 = readResistance(RESISTOR_8) / 100.0;
+        float r1 = readResistance(0) / 100.0;
+        float r2 = readResistance(1) / 100.0;
+        float r3 = readResistance(2) / 100.0;
+        float r4 = readResistance(3) / 100.0;
+        float r5 = readResistance(4) / 100.0;
+        float r6 = readResistance(5) / 100.0;
+        float r7 = readResistance(6) / 100.0;
+        float r8 = readResistance(7) / 100.0;
 
         sprintf(telemetry, "State:%01X,R1:%.0f,R2:%.0f,R3:%.0f,R4:%.0f,R5:%.0f,R6:%.0f,R7:%.0f,R8:%.0f",
                 currentState, r1, r2, r3, r4, r5, r6, r7, r8);
@@ -1194,18 +1043,8 @@ void testMinuteMotor(const char *data)
         steps = 50; // Default to 50 steps
 
     Serial.println("Testing minute motor: " + String(steps) + " steps");
-    digitalWrite(STEPPER_ENABLE, LOW);
-
-    setStepperTarget(0, minutePosition + steps);
-
-    unsigned long startTime = millis();
-    while (!stepperAtTarget(0) && (millis() - startTime < 10000))
-    {
-        runSteppers();
-    }
-
-    digitalWrite(STEPPER_ENABLE, HIGH);
-    Serial.println("Minute motor test complete. Final position: " + String(minutePosition));
+    setStepperTarget(0, minuteTarget + steps);
+    startStepperMove("Minute motor test", 10000);
 }
 
 void testHourMotor(const char *data)
@@ -1215,18 +1054,8 @@ void testHourMotor(const char *data)
         steps = 50; // Default to 50 steps
 
     Serial.println("Testing hour motor: " + String(steps) + " steps");
-    digitalWrite(STEPPER_ENABLE, LOW);
-
-    setStepperTarget(1, hourPosition + steps);
-
-    unsigned long startTime = millis();
-    while (!stepperAtTarget(1) && (millis() - startTime < 10000))
-    {
-        runSteppers();
-    }
-
-    digitalWrite(STEPPER_ENABLE, HIGH);
-    Serial.println("Hour motor test complete. Final position: " + String(hourPosition));
+    setStepperTarget(1, hourTarget + steps);
+    startStepperMove("Hour motor test", 10000);
 }
 
 void testGearMotor(const char *data)
@@ -1236,18 +1065,8 @@ void testGearMotor(const char *data)
         steps = 50; // Default to 50 steps
 
     Serial.println("Testing gear motor: " + String(steps) + " steps");
-    digitalWrite(STEPPER_ENABLE, LOW);
-
-    setStepperTarget(2, gearPosition + steps);
-
-    unsigned long startTime = millis();
-    while (!stepperAtTarget(2) && (millis() - startTime < 10000))
-    {
-        runSteppers();
-    }
-
-    digitalWrite(STEPPER_ENABLE, HIGH);
-    Serial.println("Gear motor test complete. Final position: " + String(gearPosition));
+    setStepperTarget(2, gearTarget + steps);
+    startStepperMove("Gear motor test", 10000);
 }
 
 void testStepperEnable(const char *data)
@@ -1424,9 +1243,12 @@ void stateHandler(const char *data)
     {
         currentState = CRANK;
         // Reset encoder counts when entering crank stage
-        encoderBottomCount = 0;
-        encoderTopCount = 0;
-        encoderTopBCount = 0;
+        encoderBottom.setPosition(0);
+        encoderTopA.setPosition(0);
+        encoderTopB.setPosition(0);
+        lastEncoderBottomCount = 0;
+        lastEncoderTopCount = 0;
+        lastEncoderTopBCount = 0;
         Serial.println("State changed to CRANK - Encoders reset");
     }
     else if (strcmp(data, "operator") == 0 || numericState == 4)
@@ -1569,85 +1391,6 @@ void metalDoorRWDHandler(const char *data)
     }
 }
 
-// ═══════════════════════════════════════════════════════════════
-//                    INTERRUPT SERVICE ROUTINES
-// ═══════════════════════════════════════════════════════════════
-
-// ================= BOTTOM ENCODER ISR FUNCTIONS =================
-void encoderBottomCLKISR()
-{
-    if (digitalRead(ENCODER_BOTTOM_DT) == LOW)
-    {
-        encoderBottomCount++;
-    }
-    else
-    {
-        encoderBottomCount--;
-    }
-}
-
-void encoderBottomDTISR()
-{
-    if (digitalRead(ENCODER_BOTTOM_CLK) == LOW)
-    {
-        encoderBottomCount--;
-    }
-    else
-    {
-        encoderBottomCount++;
-    }
-}
-
-// ================= TOP-A ENCODER ISR FUNCTIONS =================
-void encoderTopACLKISR()
-{
-    if (digitalRead(ENCODER_TOPA_DT) == LOW)
-    {
-        encoderTopCount++;
-    }
-    else
-    {
-        encoderTopCount--;
-    }
-}
-
-void encoderTopADTISR()
-{
-    if (digitalRead(ENCODER_TOPA_CLK) == LOW)
-    {
-        encoderTopCount--;
-    }
-    else
-    {
-        encoderTopCount++;
-    }
-}
-
-// ================= TOP-B ENCODER ISR FUNCTIONS =================
-void encoderTopBCLKISR()
-{
-    if (digitalRead(ENCODER_TOPB_DT) == LOW)
-    {
-        encoderTopBCount++;
-    }
-    else
-    {
-        encoderTopBCount--;
-    }
-}
-
-void encoderTopBDTISR()
-{
-    if (digitalRead(ENCODER_TOPB_CLK) == LOW)
-    {
-        encoderTopBCount--;
-    }
-    else
-    {
-        encoderTopBCount++;
-    }
-}
-
 void fogMachineHandler(const char *data)
 {
     bool shouldTurnOn = false;
@@ -1746,7 +1489,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
                       String(CAT_ACKNOWLEDGEMENT) + "/" + String(CONTROLLER_ID) + "/" +
                       String(device_id) + "/" + String(command);
 
-    sentient.get_client().publish(ackTopic.c_str(), buf, false);
+    sentient.publishTopic(ackTopic.c_str(), buf);
 
     Serial.print("[ACK] -> ");
     Serial.println(ackTopic);
@@ -7,8 +7,8 @@
 // ⚠️  is v2.3.0 library upgrade only - game logic extraction required.
 // ═══════════════════════════════════════════════════════════════════════════════
 // HARDWARE:
-// - 9 floor button sensors with debouncing
-// - 9 FastLED WS2812B strips (60 LEDs each = 540 total LEDs)
+// - 9 floor button sensors, edges timestamped in the pin interrupt
+// - 9 WS2812B strips (60 LEDs each = 540 total LEDs), driven in parallel over DMA
 // - DM542 stepper motor for drawer mechanism (differential signaling)
 // - 4 proximity sensors (drawer open/close main/sub)
 // - Drawer maglock, cuckoo solenoid, IR sensor, photocell
@@ -16,11 +16,17 @@
 // ═══════════════════════════════════════════════════════════════════════════════
 
 #include <Wire.h>
+#define SENTIENT_PROFILE 1 // Loop timing on metrics/profile
 #include <SentientMQTT.h>
 #include <SentientDeviceRegistry.h>
 #include <SentientCapabilityManifest.h>
+#include <SentientMotionPlanner.h>
 #include <ArduinoJson.h>
 #include <FastLED.h>
+#include <SentientLedBus.h>
+#include <SentientLedKernels.h>
+#include <SentientLedStream.h>
+#include <SentientInputEvents.h>
 #define SUPPRESS_ERROR_MESSAGE_FOR_BEGIN // Suppress IRremote begin() error
 #include <IRremote.hpp>
 #include "controller_naming.h"
@@ -96,7 +102,6 @@ SentientMQTTConfig build_mqtt_config()
 
 SentientMQTT sentient(build_mqtt_config());
 SentientCapabilityManifest manifest;
-SentientDeviceRegistry deviceRegistry;
 
 void build_capability_manifest()
 {
@@ -135,6 +140,8 @@ const int sequence3[][3] = {
 
 // Floor Button Pins
 const int floorButtons[] = {BUTTON1, BUTTON2, BUTTON3, BUTTON4, BUTTON5, BUTTON6, BUTTON7, BUTTON8, BUTTON9};
+SentientInputEvents floorEvents; // Input i = floorButtons[i] = LED strip i + 1
+uint32_t beatStartUs = 0;        // micros() when the current beat's LEDs lit
 int state = 0; // Current state of the puzzle
 
 // Sequence timing variables
@@ -159,7 +166,6 @@ const unsigned long BUTTON_CHECK_DELAY = 500; // Check buttons every 500ms
 
 // Button press tracking for sequences
 bool buttonPressed[9] = {false};   // Track button states
-bool lastButtonState[9] = {false}; // Track previous button states
 bool correctPress[9] = {false};    // Track correct presses in current step
 bool wrongPress[9] = {false};      // Track wrong presses in current step
 int totalCorrectPresses = 0;       // Track total correct presses in sequence
@@ -191,18 +197,18 @@ bool beatResults3[8] = {false}; // Track for sequence 3
 const int IR_RECEIVE_PIN = 12; // Using IRSENSOR pin
 bool irReceiverActive = false;
 
-// Stepper motor configuration - Use correct pins for DM542 driver
-// Custom motor control variables (replacing AccelStepper)
+// Stepper motor configuration - DM542 driver on PUL+/DIR+
+// Step pulses come from the SentientMotion timer ISR, which also stops the
+// drawer at the opened/closed sensors in the direction of travel
+SentientMotionPlanner drawerMotor;
+int drawerAxis = -1;
+const float DRAWER_STEP_RATE = 1000.0; // steps/sec (constant speed, no ramp)
 bool stepperActive = false;
 bool drawerOpen = true;
 
-// Custom motor movement variables
-bool isMoving = false;
+// Drawer movement variables
+bool isMoving = false;     // Run commanded and not yet reported as stopped
 bool moveDirection = true; // true = positive (open), false = negative (close)
-unsigned long lastStepTime = 0;
-unsigned long stepInterval = 1000; // microseconds between steps (1ms = 1000 steps/sec)
-long stepsToGo = 0;
-long currentPosition = 0;
 
 // Lever state variables
 bool leverActivated = false;
@@ -243,6 +249,22 @@ CRGB photocellLED[PHOTOCELL_LED_COUNT];
 #define LEVERRGBLED_COUNT 1
 CRGB leverLED[LEVERRGBLED_COUNT];
 
+// All 11 data pins (9 floor strips, photocell and lever LEDs) go out in
+// parallel over DMA; the single LEDs are padded to a full strip.
+#define LED_BUS_STRIPS (NUM_STRIPS + 2)
+DMAMEM uint8_t ledFrame[SENTIENT_LED_FRAME_BYTES(LED_BUS_STRIPS, LEDS_PER_STRIP)];
+SentientLedBus ledBus(LEDS_PER_STRIP);
+
+// Show-control stream: the 9 floor strips packed from universe 1 (or DDP
+// offset 0). Stream strip i is bus strip i.
+SentientLedStream ledStream;
+
+void showStreamFrame(uint32_t stripMask, void *)
+{
+  SENTIENT_PROBE("led_show");
+  ledBus.show(stripMask);
+}
+
 void setup()
 {
   Serial.begin(115200);
@@ -261,30 +283,25 @@ void setup()
   digitalWrite(DRAWERCOBLIGHTS, LOW); // Turn off drawer cob lights
   digitalWrite(DRAWERMAGLOCK, HIGH);  // Turn off drawer mag lock
 
-  // Initialize FastLED - Add each strip with its own data pin
-  FastLED.addLeds<WS2812, LED1, GRB>(leds, 0 * LEDS_PER_STRIP, LEDS_PER_STRIP); // LED1 = pin 3, strip 0
-  FastLED.addLeds<WS2812, LED2, GRB>(leds, 1 * LEDS_PER_STRIP, LEDS_PER_STRIP); // LED2 = pin 0, strip 1
-  FastLED.addLeds<WS2812, LED3, GRB>(leds, 2 * LEDS_PER_STRIP, LEDS_PER_STRIP); // LED3 = pin 6, strip 2
-  FastLED.addLeds<WS2812, LED4, GRB>(leds, 3 * LEDS_PER_STRIP, LEDS_PER_STRIP); // LED4 = pin 4, strip 3
-  FastLED.addLeds<WS2812, LED5, GRB>(leds, 4 * LEDS_PER_STRIP, LEDS_PER_STRIP); // LED5 = pin 1, strip 4
-  FastLED.addLeds<WS2812, LED6, GRB>(leds, 5 * LEDS_PER_STRIP, LEDS_PER_STRIP); // LED6 = pin 7, strip 5
-  FastLED.addLeds<WS2812, LED7, GRB>(leds, 6 * LEDS_PER_STRIP, LEDS_PER_STRIP); // LED7 = pin 5, strip 6
-  FastLED.addLeds<WS2812, LED8, GRB>(leds, 7 * LEDS_PER_STRIP, LEDS_PER_STRIP); // LED8 = pin 2, strip 7
-  FastLED.addLeds<WS2812, LED9, GRB>(leds, 8 * LEDS_PER_STRIP, LEDS_PER_STRIP); // LED9 = pin 8, strip 8
+  // Initialize LED bus - each strip keeps its own data pin
+  for (int i = 0; i < NUM_STRIPS; i++)
+  {
+    ledBus.addStrip(stripDataPins[i], leds + i * LEDS_PER_STRIP, LEDS_PER_STRIP);
+    ledStream.addStrip(leds + i * LEDS_PER_STRIP, LEDS_PER_STRIP, i == 0 ? 1 : 0);
+  }
+  ledStream.onFrame(showStreamFrame);
 
   // Add photocell RGB LED
-  FastLED.addLeds<WS2812, PHOTOCELL_LED, GRB>(photocellLED, PHOTOCELL_LED_COUNT);
+  ledBus.addStrip(PHOTOCELL_LED, photocellLED, PHOTOCELL_LED_COUNT);
 
   // Add lever RGB LED (shines on photocell)
-  FastLED.addLeds<WS2812, LEVERRGBLED, GRB>(leverLED, LEVERRGBLED_COUNT);
+  ledBus.addStrip(LEVERRGBLED, leverLED, LEVERRGBLED_COUNT);
 
-  FastLED.setBrightness(200); // Set brightness (0-255)
+  ledBus.begin(ledFrame, sizeof(ledFrame));
+  ledBus.setBrightness(200); // Set brightness (0-255)
 
   // Set all LEDs to black as default
-  for (int i = 0; i < TOTAL_LEDS; i++)
-  {
-    leds[i] = CRGB::Black;
-  }
+  clearAllLEDs();
 
   // Set photocell LED to black (off) as default
   photocellLED[0] = CRGB::Black;
@@ -292,13 +309,14 @@ void setup()
   // Set lever LED to white (on) to shine on photocell
   leverLED[0] = CRGB::White;
 
-  FastLED.show();
+  ledBus.show();
 
   // Initialize Floor Buttons
   for (size_t i = 0; i < sizeof(floorButtons) / sizeof(floorButtons[0]); i++)
   {
-    pinMode(floorButtons[i], INPUT_PULLUP);
+    floorEvents.add(floorButtons[i]);
   }
+  floorEvents.begin();
 
   // Initialize proximity sensors
   pinMode(DRAWEROPENED_MAIN, INPUT_PULLUP);
@@ -321,19 +339,28 @@ void setup()
   {
     Serial.println("[Floor] MQTT initialization successful");
   }
+  ledStream.begin();
 
-  // Initialize stepper motor pins for DM542 driver
-  pinMode(MOTOR_PULPOS, OUTPUT); // Pulse pin
-  pinMode(MOTOR_DIRPOS, OUTPUT); // Direction pin
+  // Initialize stepper motor for DM542 driver (pulse and direction pins)
+  SentientAxisConfig drawerConfig;
+  drawerConfig.pins = {MOTOR_PULPOS, SENTIENT_NO_PIN, MOTOR_DIRPOS, SENTIENT_NO_PIN, true}; // DIR LOW opens the drawer
+  drawerAxis = drawerMotor.addAxis(drawerConfig);
 
-  Serial.println("Motor driver pins initialized");
+  // Either sensor of a pair stops the drawer when it is reached (HIGH = reached)
+  drawerMotor.addLimitInput(drawerAxis, 1, DRAWEROPENED_MAIN, HIGH);
+  drawerMotor.addLimitInput(drawerAxis, 1, DRAWEROPENED_SUB, HIGH);
+  drawerMotor.addLimitInput(drawerAxis, -1, DRAWERCLOSED_MAIN, HIGH);
+  drawerMotor.addLimitInput(drawerAxis, -1, DRAWERCLOSED_SUB, HIGH);
+
+  SentientMotionConfig drawerMotion;
+  drawerMotion.startRate = DRAWER_STEP_RATE;
+  drawerMotion.maxRate = DRAWER_STEP_RATE;
+  drawerMotor.configureGroup(0, drawerMotion);
 
-  // Initialize custom motor control - replacing AccelStepper
-  currentPosition = 0;
+  Serial.println("Motor driver pins initialized");
   isMoving = false;
-  stepsToGo = 0;
 
-  Serial.println("DM542 driver initialized with custom motor control");
+  Serial.println("DM542 driver initialized with timer-driven motor control");
   Serial.print("Motor pins - PULSE: ");
   Serial.print(MOTOR_PULPOS);
   Serial.print(", DIRECTION: ");
@@ -370,13 +397,24 @@ void loop()
 {
   // Handle MQTT loop and registration
   static bool registered = false;
-  sentient.loop();
+  {
+    SENTIENT_PROBE("mqtt_loop");
+    sentient.loop();
+  }
+  {
+    SENTIENT_PROBE("floor_events");
+    floorEvents.loop();
+  }
+  {
+    SENTIENT_PROBE("led_stream");
+    ledStream.service();
+  }
 
   // Register after MQTT connection is established
   if (!registered && sentient.isConnected())
   {
     Serial.println("[Floor] Registering with Sentient system...");
-    if (manifest.publish_registration(sentient.get_client(), ROOM_ID, CONTROLLER_ID))
+    if (manifest.publish_registration(sentient, ROOM_ID, CONTROLLER_ID))
     {
       Serial.println("[Floor] Registration successful!");
       registered = true;
@@ -395,75 +433,51 @@ void loop()
     Serial.println("Solenoid deactivated");
   }
 
-  switch (state)
-  {
-  case 0:
-    // Wait for start command
-    testLEDs();
-    break;
-  case 1:
-    // Start the beat sequence
-    sequenceOne();
-    break;
-  case 2:
-    // Start the second sequence
-    sequenceTwo();
-    break;
-  case 3:
-    // Start the third sequence
-    sequenceThree();
-    break;
-  case 4:
-    // Test floor buttons
-    testFloorButtons();
-    break;
-  case 5:
-    // Lever control with IR sensor
-    leverState();
-    break;
-  case 6:
-    // Drawer control with stepper motor
-    drawerState();
-    break;
-
-  default:
-    break;
-  }
-}
-
-// Simple motor control functions
-// Custom motor control function
-void customMotorRun()
-{
-  if (!isMoving)
-    return;
-
-  unsigned long currentTime = micros();
-  if (currentTime - lastStepTime >= stepInterval)
   {
-    // Set direction pin - REVERSED LOGIC
-    digitalWrite(MOTOR_DIRPOS, moveDirection ? LOW : HIGH);
-
-    // Generate pulse
-    digitalWrite(MOTOR_PULPOS, HIGH);
-    delayMicroseconds(10); // Short pulse width
-    digitalWrite(MOTOR_PULPOS, LOW);
-
-    // Update position
-    if (moveDirection)
+    SENTIENT_PROBE("state");
+    switch (state)
     {
-      currentPosition++;
-    }
-    else
-    {
-      currentPosition--;
+    case 0:
+      // Wait for start command; a show-control stream owns the strips while it runs
+      if (!ledStream.active())
+      {
+        testLEDs();
+      }
+      break;
+    case 1:
+      // Start the beat sequence
+      sequenceOne();
+      break;
+    case 2:
+      // Start the second sequence
+      sequenceTwo();
+      break;
+    case 3:
+      // Start the third sequence
+      sequenceThree();
+      break;
+    case 4:
+      // Test floor buttons
+      testFloorButtons();
+      break;
+    case 5:
+      // Lever control with IR sensor
+      leverState();
+      break;
+    case 6:
+      // Drawer control with stepper motor
+      drawerState();
+      break;
+
+    default:
+      break;
     }
-    lastStepTime = currentTime;
-
-    // Motor will continue until stopped by sensor check in drawerState()
   }
+
+  SENTIENT_PROFILE_REPORT(sentient, 10000);
 }
 
+// Simple motor control functions
 void drawerState()
 {
   // Initialize stepper if not already active
@@ -474,11 +488,10 @@ void drawerState()
     sentient.publishText("Telemetry", "data", "Motor control activated");
   }
 
-  // Run custom motor control
-  customMotorRun();
+  drawerMotor.loop();
 
-  // Check proximity sensors to stop automatically
-  if (isMoving && checkProximitySensors())
+  // The step ISR stops the motor at the sensors; report it once it has come to rest
+  if (isMoving && !drawerMotor.busy() && checkProximitySensors())
   {
     isMoving = false;
     Serial.println("Motor stopped by proximity sensor");
@@ -533,17 +546,17 @@ void moveToOpen()
 
   Serial.println("Moving to OPEN position - will stop at sensor");
   Serial.print("Motor current position: ");
-  Serial.println(currentPosition);
+  Serial.println(drawerMotor.position(drawerAxis));
 
-  // Set up custom motor movement - no step limit, move until sensor
+  // No step limit - run until an opened sensor trips
   moveDirection = true; // positive direction for open
   isMoving = true;
-  lastStepTime = micros();
+  drawerMotor.runAxis(drawerAxis, 1, DRAWER_STEP_RATE);
 
   sentient.publishText("Telemetry", "data", "Moving to OPEN position");
   drawerMoving = true;
 
-  Serial.println("Custom motor control started - OPEN direction");
+  Serial.println("Motor run started - OPEN direction");
 }
 
 void moveToClose()
@@ -563,21 +576,22 @@ void moveToClose()
 
   Serial.println("Moving to CLOSE position - will stop at sensor");
   Serial.print("Motor current position: ");
-  Serial.println(currentPosition);
+  Serial.println(drawerMotor.position(drawerAxis));
 
-  // Set up custom motor movement - no step limit, move until sensor
+  // No step limit - run until a closed sensor trips
   moveDirection = false; // negative direction for close
   isMoving = true;
-  lastStepTime = micros();
+  drawerMotor.runAxis(drawerAxis, -1, DRAWER_STEP_RATE);
 
   sentient.publishText("Telemetry", "data", "Moving to CLOSE position");
   drawerMoving = true;
 
-  Serial.println("Custom motor control started - CLOSE direction");
+  Serial.println("Motor run started - CLOSE direction");
 }
 
 void stopMotor()
 {
+  drawerMotor.stop(0);
   isMoving = false;
   drawerMoving = false;
   Serial.println("Motor stopped manually");
@@ -586,6 +600,12 @@ void stopMotor()
 
 void testMotorPins()
 {
+  if (drawerMotor.busy())
+  {
+    Serial.println("Motor moving - stop it before testing pins");
+    return;
+  }
+
   Serial.println("Testing motor pins manually...");
 
   // Test direction pin
@@ -708,6 +728,7 @@ void sequenceOne()
   {
     Serial4.println("start");
     sequenceStarted = true;
+    beatStartUs = micros();
     lastSequenceUpdate = currentTime;
     totalCorrectPresses = 0;
     totalExpectedPresses = 0;
@@ -735,25 +756,8 @@ void sequenceOne()
     if (currentSequenceStep > 0)
     {
       int prevStep = currentSequenceStep - 1;
-      int led1 = sequence1[prevStep][0];
-      int led2 = sequence1[prevStep][1];
-
-      int expectedForPrevBeat = 0;
-      if (led1 != 0)
-        expectedForPrevBeat++;
-      if (led2 != 0)
-        expectedForPrevBeat++;
-
-      int correctForPrevBeat = 0;
-      int wrongForPrevBeat = 0;
-
-      for (int i = 0; i < 9; i++)
-      {
-        if (correctPress[i])
-          correctForPrevBeat++;
-        if (wrongPress[i])
-          wrongForPrevBeat++;
-      }
+      int expectedForPrevBeat, correctForPrevBeat, wrongForPrevBeat;
+      judgeBeat(sequence1[prevStep], 2, expectedForPrevBeat, correctForPrevBeat, wrongForPrevBeat);
 
       beatResults[prevStep] = (correctForPrevBeat == expectedForPrevBeat && wrongForPrevBeat == 0);
 
@@ -774,7 +778,7 @@ void sequenceOne()
     {
       // Sequence complete, check results and send sound effect
       clearAllLEDs();
-      FastLED.show();
+      ledBus.show();
 
       // Create MQTT message with beat results
       Serial.println("Debug - Beat Results Array:");
@@ -861,7 +865,8 @@ void sequenceOne()
     if (led2 != 0)
       lightUpStrip(led2 - 1, CRGB::Yellow);
 
-    FastLED.show();
+    ledBus.show();
+    beatStartUs = micros();
 
     currentSequenceStep++;
     lastSequenceUpdate = currentTime;
@@ -902,6 +907,7 @@ void sequenceTwo()
   {
     Serial4.println("start");
     sequence2Started = true;
+    beatStartUs = micros();
     lastSequence2Update = currentTime;
     totalCorrectPresses2 = 0;
     totalExpectedPresses2 = 0;
@@ -929,25 +935,8 @@ void sequenceTwo()
     if (currentSequence2Step > 0)
     {
       int prevStep = currentSequence2Step - 1;
-      int led1 = sequence2[prevStep][0];
-      int led2 = sequence2[prevStep][1];
-
-      int expectedForPrevBeat = 0;
-      if (led1 != 0)
-        expectedForPrevBeat++;
-      if (led2 != 0)
-        expectedForPrevBeat++;
-
-      int correctForPrevBeat = 0;
-      int wrongForPrevBeat = 0;
-
-      for (int i = 0; i < 9; i++)
-      {
-        if (correctPress[i])
-          correctForPrevBeat++;
-        if (wrongPress[i])
-          wrongForPrevBeat++;
-      }
+      int expectedForPrevBeat, correctForPrevBeat, wrongForPrevBeat;
+      judgeBeat(sequence2[prevStep], 2, expectedForPrevBeat, correctForPrevBeat, wrongForPrevBeat);
 
       beatResults2[prevStep] = (correctForPrevBeat == expectedForPrevBeat && wrongForPrevBeat == 0);
 
@@ -968,7 +957,7 @@ void sequenceTwo()
     {
       // Sequence complete, check results and send sound effect
       clearAllLEDs();
-      FastLED.show();
+      ledBus.show();
 
       // Create MQTT message with beat results
       Serial.println("Debug - Beat Results Array:");
@@ -1056,7 +1045,8 @@ void sequenceTwo()
       if (led2 != 0)
         lightUpStrip(led2 - 1, CRGB::Blue);
 
-      FastLED.show();
+      ledBus.show();
+      beatStartUs = micros();
 
       currentSequence2Step++;
       lastSequence2Update = currentTime;
@@ -1098,6 +1088,7 @@ void sequenceThree()
   {
     Serial4.println("start");
     sequence3Started = true;
+    beatStartUs = micros();
     lastSequence3Update = currentTime;
     totalCorrectPresses3 = 0;
     totalExpectedPresses3 = 0;
@@ -1125,28 +1116,8 @@ void sequenceThree()
     if (currentSequence3Step > 0)
     {
       int prevStep = currentSequence3Step - 1;
-      int led1 = sequence3[prevStep][0];
-      int led2 = sequence3[prevStep][1];
-      int led3 = sequence3[prevStep][2];
-
-      int expectedForPrevBeat = 0;
-      if (led1 != 0)
-        expectedForPrevBeat++;
-      if (led2 != 0)
-        expectedForPrevBeat++;
-      if (led3 != 0)
-        expectedForPrevBeat++;
-
-      int correctForPrevBeat = 0;
-      int wrongForPrevBeat = 0;
-
-      for (int i = 0; i < 9; i++)
-      {
-        if (correctPress[i])
-          correctForPrevBeat++;
-        if (wrongPress[i])
-          wrongForPrevBeat++;
-      }
+      int expectedForPrevBeat, correctForPrevBeat, wrongForPrevBeat;
+      judgeBeat(sequence3[prevStep], 3, expectedForPrevBeat, correctForPrevBeat, wrongForPrevBeat);
 
       beatResults3[prevStep] = (correctForPrevBeat == expectedForPrevBeat && wrongForPrevBeat == 0);
 
@@ -1167,7 +1138,7 @@ void sequenceThree()
     {
       // Sequence complete, check results and send sound effect
       clearAllLEDs();
-      FastLED.show();
+      ledBus.show();
 
       // Create MQTT message with beat results
       Serial.println("Debug - Beat Results Array:");
@@ -1260,7 +1231,8 @@ void sequenceThree()
       if (led3 != 0)
         lightUpStrip(led3 - 1, CRGB::Purple);
 
-      FastLED.show();
+      ledBus.show();
+      beatStartUs = micros();
 
       currentSequence3Step++;
       lastSequence3Update = currentTime;
@@ -1275,21 +1247,16 @@ void sequenceThree()
 
 void clearAllLEDs()
 {
-  for (int i = 0; i < TOTAL_LEDS; i++)
-  {
-    leds[i] = CRGB::Black;
-  }
+  SentientLedKernels::fill(leds[0].raw, TOTAL_LEDS, 0);
 }
 
 void lightUpStrip(int stripIndex, CRGB color)
 {
   if (stripIndex >= 0 && stripIndex < NUM_STRIPS)
   {
-    int startLED = stripIndex * LEDS_PER_STRIP;
-    for (int i = 0; i < LEDS_PER_STRIP; i++)
-    {
-      leds[startLED + i] = color;
-    }
+    // Whole strip in word stores
+    SentientLedKernels::fill(leds[stripIndex * LEDS_PER_STRIP].raw, LEDS_PER_STRIP,
+                             SentientLedKernels::pack(color.r, color.g, color.b));
   }
 }
 
@@ -1306,7 +1273,7 @@ void leverState()
 
     // Turn on bright white LED for photocell using FastLED
     photocellLED[0] = CRGB::White;
-    FastLED.show();
+    ledBus.show();
 
     Serial.println("State 5: IR sensor auto-activated, Photocell LED ON");
     sentient.publishText("Telemetry", "data", "State5:IR_Auto_Active,Photocell_ON");
@@ -1457,7 +1424,7 @@ void deactivateLever()
 
     // Turn off photocell LED when leaving lever state using FastLED
     photocellLED[0] = CRGB::Black;
-    FastLED.show();
+    ledBus.show();
     Serial.println("Lever deactivated - Photocell LED OFF");
   }
 }
@@ -1478,7 +1445,7 @@ void activateIR(const char *value)
       IrReceiver.begin(IR_RECEIVE_PIN, false);
       irReceiverActive = true;
       photocellLED[0] = CRGB::White;
-      FastLED.show();
+      ledBus.show();
       Serial.println("Manual IR override: Activated");
     }
     else
@@ -1494,7 +1461,7 @@ void activateIR(const char *value)
       IrReceiver.stop();
       irReceiverActive = false;
       photocellLED[0] = CRGB::Black;
-      FastLED.show();
+      ledBus.show();
       Serial.println("Manual IR override: Deactivated");
     }
     sentient.publishText("Telemetry", "data", "IR_Manual_Override:OFF");
@@ -1510,10 +1477,10 @@ void activateIR(const char *value)
 
 void deactivateDrawer()
 {
+  drawerMotor.stop(0);
   stepperActive = false;
   drawerMoving = false;
   isMoving = false;
-  stepsToGo = 0;
   Serial.println("Motor control deactivated");
 }
 
@@ -1541,7 +1508,7 @@ void stateChange(const char *value)
   if (state == 5 && newState != 5)
   {
     photocellLED[0] = CRGB::Black;
-    FastLED.show();
+    ledBus.show();
     Serial.println("Leaving lever state - Photocell LED OFF");
   }
 
@@ -1555,7 +1522,7 @@ void stateChange(const char *value)
     // The leverState() function will handle IR initialization automatically
     // Just ensure photocell LED is ready
     photocellLED[0] = CRGB::White;
-    FastLED.show();
+    ledBus.show();
     Serial.println("State 5 ready - IR will auto-activate in leverState()");
   }
 
@@ -1608,84 +1575,119 @@ void leverControl(const char *value)
 }
 
 // Add missing button press checking functions
-void checkButtonPresses()
+// Next press of the current beat from the event queue, published with its
+// offset from the beat. Earlier presses were judged with the previous beat.
+bool nextBeatPress(int &button)
 {
-  for (int i = 0; i < 9; i++)
+  SentientInputEvent event;
+  while (floorEvents.pop(event))
   {
-    bool currentButtonState = (digitalRead(floorButtons[i]) == LOW);
-
-    // Detect button press (transition from not pressed to pressed)
-    if (currentButtonState && !lastButtonState[i])
+    if (event.active && (int32_t)(event.micros - beatStartUs) >= 0)
     {
-      // Check if this button corresponds to an active LED
-      if (isLEDActive(i + 1))
-      { // Convert to 1-based LED number
-        correctPress[i] = true;
-        totalCorrectPresses++;
-      }
-      else
-      {
-        // Wrong button pressed
-        wrongPress[i] = true;
-        totalWrongPresses++;
-      }
+      publishButtonPress(event);
+      button = event.input;
+      return true;
     }
-
-    lastButtonState[i] = currentButtonState;
   }
+  return false;
 }
 
-void checkButtonPresses2()
+void publishButtonPress(const SentientInputEvent &event)
 {
+  StaticJsonDocument<128> doc;
+  doc["button"] = event.input + 1;
+  doc["at_us"] = event.micros;
+  doc["beat_offset_ms"] = (event.micros - beatStartUs) / 1000.0f;
+  sentient.publishJson(CAT_SENSORS, DEV_FLOOR_BUTTONS, SENSOR_BUTTON_PRESS, doc);
+}
+
+// Judge a finished beat from the press history rather than from what loop()
+// happened to see: every lit strip stepped on, and nothing else, between the
+// LEDs lighting and now
+void judgeBeat(const int *beatLeds, int ledCount, int &expected, int &correct, int &wrong)
+{
+  const uint32_t nowUs = micros();
+  expected = 0;
+  correct = 0;
+  wrong = 0;
   for (int i = 0; i < 9; i++)
   {
-    bool currentButtonState = (digitalRead(floorButtons[i]) == LOW);
+    bool lit = false;
+    for (int j = 0; j < ledCount; j++)
+    {
+      lit = lit || beatLeds[j] == i + 1;
+    }
+    const bool pressed = floorEvents.pressedBetween(i, beatStartUs, nowUs);
+    if (lit)
+    {
+      expected++;
+      if (pressed)
+        correct++;
+    }
+    else if (pressed)
+    {
+      wrong++;
+    }
+  }
+}
 
-    // Detect button press (transition from not pressed to pressed)
-    if (currentButtonState && !lastButtonState[i])
+void checkButtonPresses()
+{
+  int i;
+  while (nextBeatPress(i))
+  {
+    // Check if this button corresponds to an active LED
+    if (isLEDActive(i + 1))
+    { // Convert to 1-based LED number
+      correctPress[i] = true;
+      totalCorrectPresses++;
+    }
+    else
     {
-      // Check if this button corresponds to an active LED
-      if (isLEDActive2(i + 1))
-      { // Convert to 1-based LED number
-        correctPress[i] = true;
-        totalCorrectPresses2++;
-      }
-      else
-      {
-        // Wrong button pressed
-        wrongPress[i] = true;
-        totalWrongPresses2++;
-      }
+      // Wrong button pressed
+      wrongPress[i] = true;
+      totalWrongPresses++;
     }
+  }
+}
 
-    lastButtonState[i] = currentButtonState;
+void checkButtonPresses2()
+{
+  int i;
+  while (nextBeatPress(i))
+  {
+    // Check if this button corresponds to an active LED
+    if (isLEDActive2(i + 1))
+    { // Convert to 1-based LED number
+      correctPress[i] = true;
+      totalCorrectPresses2++;
+    }
+    else
+    {
+      // Wrong button pressed
+      wrongPress[i] = true;
+      totalWrongPresses2++;
+    }
   }
 }
 
 void checkButtonPresses3()
 {
-  for (int i = 0; i < 9; i++)
-  {
-    bool currentButtonState = (digitalRead(floorButtons[i]) == LOW);
-
-    // Detect button press (transition from not pressed to pressed)
-    if (currentButtonState && !lastButtonState[i])
+  int i;
+  while (nextBeatPress(i))
+  {
+    // Check if this button corresponds to an active LED
+    if (isLEDActive3(i + 1))
+    { // Convert to 1-based LED number
+      correctPress[i] = true;
+      totalCorrectPresses3++;
+    }
+    else
     {
-      // Check if this button corresponds to an active LED
-      if (isLEDActive3(i + 1))
-      { // Convert to 1-based LED number
-        correctPress[i] = true;
-        totalCorrectPresses3++;
-      }
-      else
-      {
-        // Wrong button pressed
-        wrongPress[i] = true;
-        totalWrongPresses3++;
-      }
+      // Wrong button pressed
+      wrongPress[i] = true;
+      totalWrongPresses3++;
     }
-
-    lastButtonState[i] = currentButtonState;
   }
 }
 
@@ -1748,7 +1750,7 @@ void updateCorrectPresses()
 
   if (needsUpdate)
   {
-    FastLED.show();
+    ledBus.show();
   }
 }
 
@@ -1768,20 +1770,20 @@ void testFloorButtons()
 
     for (int i = 0; i < 9; i++)
     {
-      int buttonState = digitalRead(floorButtons[i]);
-      sprintf(tempBuffer, "B%d:%s", i + 1, (buttonState == LOW ? "PRESSED" : "RELEASED"));
+      bool buttonState = floorEvents.active(i);
+      sprintf(tempBuffer, "B%d:%s", i + 1, (buttonState ? "PRESSED" : "RELEASED"));
       strcat(buttonStatus, tempBuffer);
       if (i < 8)
         strcat(buttonStatus, ", ");
 
       // Light up corresponding LED if button is pressed
-      if (buttonState == LOW)
+      if (buttonState)
       {
         lightUpStrip(i, CRGB::Yellow);
       }
     }
 
-    FastLED.show();
+    ledBus.show();
 
     Serial.println(buttonStatus);
     sentient.publishText("Telemetry", "data", buttonStatus);
@@ -1799,7 +1801,7 @@ void testLEDs()
 
   for (int i = 0; i < 9; i++)
   {
-    bool currentButtonState = (digitalRead(floorButtons[i]) == LOW);
+    bool currentButtonState = floorEvents.active(i);
 
     // Light up LED if button is pressed
     if (currentButtonState)
@@ -1822,7 +1824,7 @@ void testLEDs()
     lastTestButtonState[i] = currentButtonState;
   }
 
-  FastLED.show();
+  ledBus.show();
 }
 
 // ══════════════════════════════════════════════════════════════════════════════
@@ -1849,7 +1851,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
                       String(CAT_ACKNOWLEDGEMENT) + "/" + String(CONTROLLER_ID) + "/" +
                       String(device_id) + "/" + String(command);
 
-    sentient.get_client().publish(ackTopic.c_str(), buf, false);
+    sentient.publishTopic(ackTopic.c_str(), buf);
 
     Serial.print(F("[ACK] -> "));
     Serial.println(ackTopic);
@@ -4,9 +4,10 @@
 // ══════════════════════════════════════════════════════════════════════════════
 
 #include <SentientMQTT.h>
-#include <SentientCapabilityManifest.h>
+#include <SentientManifestStream.h>
 #include <SentientDeviceRegistry.h>
 #include <ArduinoJson.h>
+#include <SentientRfidReaders.h>
 #include "controller_naming.h"
 
 // ══════════════════════════════════════════════════════════════════════════════
@@ -65,19 +66,23 @@ const unsigned long heartbeat_interval_ms = 5000; // 5 seconds
 // STATE MANAGEMENT
 // ══════════════════════════════════════════════════════════════════════════════
 
-// RFID tag storage
-const int TAG_LENGTH = 20;
-char tag_a[TAG_LENGTH] = "";
-char tag_b[TAG_LENGTH] = "";
-char tag_c[TAG_LENGTH] = "";
-char tag_d[TAG_LENGTH] = "";
-char tag_e[TAG_LENGTH] = "";
+// RFID readers: per-port framing, checksum validation and TIR-fused presence
+struct RfidReaderDef
+{
+    HardwareSerial &port;
+    int tir_pin;
+    const char *device_id;
+};
+
+const RfidReaderDef rfid_readers[] = {
+    {RFID_A, PIN_TIR_A, naming::DEV_RFID_A},
+    {RFID_B, PIN_TIR_B, naming::DEV_RFID_B},
+    {RFID_C, PIN_TIR_C, naming::DEV_RFID_C},
+    {RFID_D, PIN_TIR_D, naming::DEV_RFID_D},
+    {RFID_E, PIN_TIR_E, naming::DEV_RFID_E}};
+const int RFID_READER_COUNT = sizeof(rfid_readers) / sizeof(rfid_readers[0]);
 
-char last_tag_a[TAG_LENGTH] = "";
-char last_tag_b[TAG_LENGTH] = "";
-char last_tag_c[TAG_LENGTH] = "";
-char last_tag_d[TAG_LENGTH] = "";
-char last_tag_e[TAG_LENGTH] = "";
+SentientRfidReaders rfid;
 
 // Resistor values (bucketed to 0, 100, 200, 300)
 int resistor_a = 0;
@@ -97,50 +102,64 @@ bool last_knife_switch_state = false;
 // ══════════════════════════════════════════════════════════════════════════════
 
 // RFID sensors (input only)
-const char *rfid_a_sensors[] = {naming::SENSOR_RFID_TAG};
-const char *rfid_b_sensors[] = {naming::SENSOR_RFID_TAG};
-const char *rfid_c_sensors[] = {naming::SENSOR_RFID_TAG};
-const char *rfid_d_sensors[] = {naming::SENSOR_RFID_TAG};
-const char *rfid_e_sensors[] = {naming::SENSOR_RFID_TAG};
-
-SentientDeviceDef dev_rfid_a(naming::DEV_RFID_A, naming::FRIENDLY_RFID_A, "rfid_reader", rfid_a_sensors, 1, true);
-SentientDeviceDef dev_rfid_b(naming::DEV_RFID_B, naming::FRIENDLY_RFID_B, "rfid_reader", rfid_b_sensors, 1, true);
-SentientDeviceDef dev_rfid_c(naming::DEV_RFID_C, naming::FRIENDLY_RFID_C, "rfid_reader", rfid_c_sensors, 1, true);
-SentientDeviceDef dev_rfid_d(naming::DEV_RFID_D, naming::FRIENDLY_RFID_D, "rfid_reader", rfid_d_sensors, 1, true);
-SentientDeviceDef dev_rfid_e(naming::DEV_RFID_E, naming::FRIENDLY_RFID_E, "rfid_reader", rfid_e_sensors, 1, true);
+constexpr const char *rfid_a_sensors[] PROGMEM = {naming::SENSOR_RFID_TAG};
+constexpr const char *rfid_b_sensors[] PROGMEM = {naming::SENSOR_RFID_TAG};
+constexpr const char *rfid_c_sensors[] PROGMEM = {naming::SENSOR_RFID_TAG};
+constexpr const char *rfid_d_sensors[] PROGMEM = {naming::SENSOR_RFID_TAG};
+constexpr const char *rfid_e_sensors[] PROGMEM = {naming::SENSOR_RFID_TAG};
+
+constexpr SentientDeviceDef dev_rfid_a PROGMEM(naming::DEV_RFID_A, naming::FRIENDLY_RFID_A, "rfid_reader", rfid_a_sensors, 1, true);
+constexpr SentientDeviceDef dev_rfid_b PROGMEM(naming::DEV_RFID_B, naming::FRIENDLY_RFID_B, "rfid_reader", rfid_b_sensors, 1, true);
+constexpr SentientDeviceDef dev_rfid_c PROGMEM(naming::DEV_RFID_C, naming::FRIENDLY_RFID_C, "rfid_reader", rfid_c_sensors, 1, true);
+constexpr SentientDeviceDef dev_rfid_d PROGMEM(naming::DEV_RFID_D, naming::FRIENDLY_RFID_D, "rfid_reader", rfid_d_sensors, 1, true);
+constexpr SentientDeviceDef dev_rfid_e PROGMEM(naming::DEV_RFID_E, naming::FRIENDLY_RFID_E, "rfid_reader", rfid_e_sensors, 1, true);
 
 // Fuse sensors (input only)
-const char *fuse_a_sensors[] = {naming::SENSOR_RESISTOR_VALUE};
-const char *fuse_b_sensors[] = {naming::SENSOR_RESISTOR_VALUE};
-const char *fuse_c_sensors[] = {naming::SENSOR_RESISTOR_VALUE};
+constexpr const char *fuse_a_sensors[] PROGMEM = {naming::SENSOR_RESISTOR_VALUE};
+constexpr const char *fuse_b_sensors[] PROGMEM = {naming::SENSOR_RESISTOR_VALUE};
+constexpr const char *fuse_c_sensors[] PROGMEM = {naming::SENSOR_RESISTOR_VALUE};
 
-SentientDeviceDef dev_fuse_a(naming::DEV_FUSE_A, naming::FRIENDLY_FUSE_A, "resistor_sensor", fuse_a_sensors, 1, true);
-SentientDeviceDef dev_fuse_b(naming::DEV_FUSE_B, naming::FRIENDLY_FUSE_B, "resistor_sensor", fuse_b_sensors, 1, true);
-SentientDeviceDef dev_fuse_c(naming::DEV_FUSE_C, naming::FRIENDLY_FUSE_C, "resistor_sensor", fuse_c_sensors, 1, true);
+constexpr SentientDeviceDef dev_fuse_a PROGMEM(naming::DEV_FUSE_A, naming::FRIENDLY_FUSE_A, "resistor_sensor", fuse_a_sensors, 1, true);
+constexpr SentientDeviceDef dev_fuse_b PROGMEM(naming::DEV_FUSE_B, naming::FRIENDLY_FUSE_B, "resistor_sensor", fuse_b_sensors, 1, true);
+constexpr SentientDeviceDef dev_fuse_c PROGMEM(naming::DEV_FUSE_C, naming::FRIENDLY_FUSE_C, "resistor_sensor", fuse_c_sensors, 1, true);
 
 // Knife switch sensor (input only)
-const char *knife_switch_sensors[] = {naming::SENSOR_SWITCH_STATE};
-SentientDeviceDef dev_knife_switch(naming::DEV_KNIFE_SWITCH, naming::FRIENDLY_KNIFE_SWITCH, "switch", knife_switch_sensors, 1, true);
+constexpr const char *knife_switch_sensors[] PROGMEM = {naming::SENSOR_SWITCH_STATE};
+constexpr SentientDeviceDef dev_knife_switch PROGMEM(naming::DEV_KNIFE_SWITCH, naming::FRIENDLY_KNIFE_SWITCH, "switch", knife_switch_sensors, 1, true);
 
 // Actuator (output device)
-const char *actuator_commands[] = {
+constexpr const char *actuator_commands[] PROGMEM = {
     naming::CMD_ACTUATOR_FORWARD,
     naming::CMD_ACTUATOR_REVERSE,
     naming::CMD_ACTUATOR_STOP};
-SentientDeviceDef dev_actuator(naming::DEV_ACTUATOR, naming::FRIENDLY_ACTUATOR, "actuator", actuator_commands, 3);
+constexpr SentientDeviceDef dev_actuator PROGMEM(naming::DEV_ACTUATOR, naming::FRIENDLY_ACTUATOR, "actuator", actuator_commands, 3);
 
 // Maglocks (output devices)
-const char *maglock_commands[] = {naming::CMD_DROP_PANEL};
-SentientDeviceDef dev_maglock_b(naming::DEV_MAGLOCK_B, naming::FRIENDLY_MAGLOCK_B, "maglock", maglock_commands, 1);
-SentientDeviceDef dev_maglock_c(naming::DEV_MAGLOCK_C, naming::FRIENDLY_MAGLOCK_C, "maglock", maglock_commands, 1);
-SentientDeviceDef dev_maglock_d(naming::DEV_MAGLOCK_D, naming::FRIENDLY_MAGLOCK_D, "maglock", maglock_commands, 1);
+constexpr const char *maglock_commands[] PROGMEM = {naming::CMD_DROP_PANEL};
+constexpr SentientDeviceDef dev_maglock_b PROGMEM(naming::DEV_MAGLOCK_B, naming::FRIENDLY_MAGLOCK_B, "maglock", maglock_commands, 1);
+constexpr SentientDeviceDef dev_maglock_c PROGMEM(naming::DEV_MAGLOCK_C, naming::FRIENDLY_MAGLOCK_C, "maglock", maglock_commands, 1);
+constexpr SentientDeviceDef dev_maglock_d PROGMEM(naming::DEV_MAGLOCK_D, naming::FRIENDLY_MAGLOCK_D, "maglock", maglock_commands, 1);
 
 // Metal gate (output device)
-const char *metal_gate_commands[] = {naming::CMD_UNLOCK_GATE};
-SentientDeviceDef dev_metal_gate(naming::DEV_METAL_GATE, naming::FRIENDLY_METAL_GATE, "maglock", metal_gate_commands, 1);
+constexpr const char *metal_gate_commands[] PROGMEM = {naming::CMD_UNLOCK_GATE};
+constexpr SentientDeviceDef dev_metal_gate PROGMEM(naming::DEV_METAL_GATE, naming::FRIENDLY_METAL_GATE, "maglock", metal_gate_commands, 1);
 
 // Create the device registry
-SentientDeviceRegistry deviceRegistry;
+SENTIENT_DEVICE_REGISTRY(deviceRegistry,
+    &dev_rfid_a,
+    &dev_rfid_b,
+    &dev_rfid_c,
+    &dev_rfid_d,
+    &dev_rfid_e,
+    &dev_fuse_a,
+    &dev_fuse_b,
+    &dev_fuse_c,
+    &dev_knife_switch,
+    &dev_actuator,
+    &dev_maglock_b,
+    &dev_maglock_c,
+    &dev_maglock_d,
+    &dev_metal_gate);
 
 // ══════════════════════════════════════════════════════════════════════════════
 // SENTIENT MQTT INITIALIZATION
@@ -166,7 +185,7 @@ SentientMQTTConfig make_mqtt_config()
 }
 
 SentientMQTT sentient(make_mqtt_config());
-SentientCapabilityManifest manifest;
+SentientManifestStream manifest(deviceRegistry);
 
 // Forward declarations
 void handle_mqtt_command(const char *command, const JsonDocument &payload, void *ctx);
@@ -174,8 +193,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
 void monitor_rfid_readers();
 void monitor_resistor_sensors();
 void monitor_knife_switch();
-void handle_rfid_reader(HardwareSerial &serial, char *tag_buffer, char *last_tag_buffer, int tir_pin, const char *device_id);
-void clean_tag(char *tag);
+void publish_rfid_tag(int reader);
 int calculate_resistor_value(int pin);
 int round_resistor_value(int raw_value);
 
@@ -192,19 +210,12 @@ void setup()
     delay(2000);
     Serial.println(F("[Fuse] Starting..."));
 
-    // Initialize RFID readers
-    RFID_A.begin(9600);
-    RFID_B.begin(9600);
-    RFID_C.begin(9600);
-    RFID_D.begin(9600);
-    RFID_E.begin(9600);
-
-    // Initialize TIR sensor pins
-    pinMode(PIN_TIR_A, INPUT_PULLDOWN);
-    pinMode(PIN_TIR_B, INPUT_PULLDOWN);
-    pinMode(PIN_TIR_C, INPUT_PULLDOWN);
-    pinMode(PIN_TIR_D, INPUT_PULLDOWN);
-    pinMode(PIN_TIR_E, INPUT_PULLDOWN);
+    // Initialize RFID readers and their TIR sensor pins
+    for (int i = 0; i < RFID_READER_COUNT; i++)
+    {
+        rfid.add(rfid_readers[i].port, rfid_readers[i].tir_pin, INPUT_PULLDOWN);
+    }
+    rfid.begin(9600);
 
     // Initialize knife switch
     pinMode(PIN_KNIFE_SWITCH, INPUT_PULLDOWN);
@@ -227,22 +238,6 @@ void setup()
     pinMode(PIN_METAL_GATE, OUTPUT);
     digitalWrite(PIN_METAL_GATE, HIGH);
 
-    // Register all devices
-    Serial.println(F("[INIT] Registering devices..."));
-    deviceRegistry.addDevice(&dev_rfid_a);
-    deviceRegistry.addDevice(&dev_rfid_b);
-    deviceRegistry.addDevice(&dev_rfid_c);
-    deviceRegistry.addDevice(&dev_rfid_d);
-    deviceRegistry.addDevice(&dev_rfid_e);
-    deviceRegistry.addDevice(&dev_fuse_a);
-    deviceRegistry.addDevice(&dev_fuse_b);
-    deviceRegistry.addDevice(&dev_fuse_c);
-    deviceRegistry.addDevice(&dev_knife_switch);
-    deviceRegistry.addDevice(&dev_actuator);
-    deviceRegistry.addDevice(&dev_maglock_b);
-    deviceRegistry.addDevice(&dev_maglock_c);
-    deviceRegistry.addDevice(&dev_maglock_d);
-    deviceRegistry.addDevice(&dev_metal_gate);
     deviceRegistry.printSummary();
 
     // Build capability manifest
@@ -254,7 +249,6 @@ void setup()
         naming::ROOM_ID,
         naming::CONTROLLER_ID);
 
-    deviceRegistry.buildManifest(manifest);
     Serial.println(F("[INIT] Manifest built from device registry"));
 
     // Initialize Sentient MQTT
@@ -278,9 +272,9 @@ void setup()
 
         // Register with Sentient system
         Serial.println(F("[INIT] Registering with Sentient system..."));
-        if (manifest.publish_registration(sentient.get_client(), naming::ROOM_ID, naming::CONTROLLER_ID))
+        if (manifest.publish_registration(sentient, naming::ROOM_ID, naming::CONTROLLER_ID))
         {
-            Serial.println(F("[INIT] Registration successful!"));
+            Serial.println(F("[INIT] Registration started"));
         }
         else
         {
@@ -303,6 +297,7 @@ void loop()
 {
     // 1. LISTEN for commands from Sentient
     sentient.loop();
+    manifest.loop();
 
     // 2. MONITOR sensors and publish changes
     monitor_rfid_readers();
@@ -405,7 +400,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
                       String(naming::CAT_ACKNOWLEDGEMENT) + "/" + String(naming::CONTROLLER_ID) + "/" +
                       String(device_id) + "/" + String(command);
 
-    sentient.get_client().publish(ackTopic.c_str(), buf, false);
+    sentient.publishTopic(ackTopic.c_str(), buf);
 
     Serial.print(F("[ACK] -> "));
     Serial.println(ackTopic);
@@ -417,76 +412,32 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
 
 void monitor_rfid_readers()
 {
-    handle_rfid_reader(RFID_A, tag_a, last_tag_a, PIN_TIR_A, naming::DEV_RFID_A);
-    handle_rfid_reader(RFID_B, tag_b, last_tag_b, PIN_TIR_B, naming::DEV_RFID_B);
-    handle_rfid_reader(RFID_C, tag_c, last_tag_c, PIN_TIR_C, naming::DEV_RFID_C);
-    handle_rfid_reader(RFID_D, tag_d, last_tag_d, PIN_TIR_D, naming::DEV_RFID_D);
-    handle_rfid_reader(RFID_E, tag_e, last_tag_e, PIN_TIR_E, naming::DEV_RFID_E);
-}
-
-void handle_rfid_reader(HardwareSerial &serial, char *tag_buffer, char *last_tag_buffer, int tir_pin, const char *device_id)
-{
-    // Read RFID data
-    if (serial.available())
+    const uint32_t changed = rfid.update();
+    for (int i = 0; i < RFID_READER_COUNT; i++)
     {
-        static char buffer[16];
-        static int count = 0;
-        static bool packet_started = false;
-
-        char incoming_char = serial.read();
-
-        if (incoming_char == 0x02)
-        { // STX
-            count = 0;
-            packet_started = true;
-        }
-        else if (incoming_char == 0x03 && packet_started)
-        { // ETX
-            buffer[count] = '\0';
-            strncpy(tag_buffer, buffer, TAG_LENGTH - 1);
-            tag_buffer[TAG_LENGTH - 1] = '\0';
-            clean_tag(tag_buffer);
-            packet_started = false;
-        }
-        else if (packet_started && count < sizeof(buffer) - 1)
+        if (changed & SentientRfidReaders::bit(i))
         {
-            buffer[count++] = incoming_char;
+            publish_rfid_tag(i);
         }
     }
-
-    // Clear tag if TIR sensor indicates tag removed
-    if (digitalRead(tir_pin) == LOW && strlen(tag_buffer) > 0)
-    {
-        tag_buffer[0] = '\0';
-    }
-
-    // Publish on change
-    if (strcmp(tag_buffer, last_tag_buffer) != 0 && sentient.isConnected())
-    {
-        JsonDocument doc;
-        doc["tag"] = (strlen(tag_buffer) > 0) ? tag_buffer : "EMPTY";
-        sentient.publishJson(naming::CAT_SENSORS, naming::SENSOR_RFID_TAG, doc);
-
-        Serial.print(F("[RFID] "));
-        Serial.print(device_id);
-        Serial.print(F(": "));
-        Serial.println(strlen(tag_buffer) > 0 ? tag_buffer : "EMPTY");
-
-        strncpy(last_tag_buffer, tag_buffer, TAG_LENGTH);
-    }
 }
 
-void clean_tag(char *tag)
+void publish_rfid_tag(int reader)
 {
-    int j = 0;
-    for (int i = 0; tag[i] != '\0'; i++)
-    {
-        if (tag[i] != '\n' && tag[i] != '\r')
-        {
-            tag[j++] = tag[i];
-        }
-    }
-    tag[j] = '\0';
+    char tag[SENTIENT_RFID_TAG_TEXT];
+    SentientRfidReaders::formatTag(rfid.tag(reader), tag);
+    const char *device_id = rfid_readers[reader].device_id;
+
+    // No connection check: changes during a broker blip are queued and replayed
+    JsonDocument doc;
+    doc["tag"] = rfid.present(reader) ? tag : "EMPTY";
+    doc["latency_us"] = rfid.ageMicros(reader); // Frame or TIR edge on the wire -> publish
+    sentient.publishJson(naming::CAT_SENSORS, device_id, naming::SENSOR_RFID_TAG, doc);
+
+    Serial.print(F("[RFID] "));
+    Serial.print(device_id);
+    Serial.print(F(": "));
+    Serial.println(rfid.present(reader) ? tag : "EMPTY");
 }
 
 // ══════════════════════════════════════════════════════════════════════════════
@@ -26,9 +26,10 @@
 
 #include <SentientMQTT.h>
 #include <SentientDeviceRegistry.h>
-#include <SentientCapabilityManifest.h>
+#include <SentientManifestStream.h>
 #include <AccelStepper.h>
 #include <EEPROM.h>
+#include <SentientAnalogScanner.h>
 
 #include "FirmwareMetadata.h"
 #include "controller_naming.h"
@@ -89,9 +90,9 @@ const int valve_3_max = 896;
 const int valve_4_zero = 10;
 const int valve_4_max = 960;
 
-// Signal filtering
-const int num_analog_readings = 3;
-const float filter_alpha = 0.25f;
+// Signal filtering (pots are read at 10 bits, the resolution of the calibration above)
+const uint8_t valve_smoothing = 4;          // Scanner IIR: settles in about 16 ms at 1 kHz scans
+const uint8_t valve_hysteresis = 1;         // Counts a pot must move before the reading follows
 const int psi_deadband = 1;                 // PSI must change by this amount to trigger movement
 const unsigned long movement_delay_ms = 75; // Minimum time between movements
 
@@ -127,11 +128,11 @@ int last_published_valve_4_psi = -1;
 unsigned long last_sensor_publish_time = 0;
 const unsigned long sensor_publish_interval_ms = 60000;
 
-// Filtered analog values
-float filtered_analog_1 = 0.0f;
-float filtered_analog_3 = 0.0f;
-float filtered_analog_4 = 0.0f;
-bool filters_initialized = false;
+// Valve pots, scanned and filtered in the background
+SentientAnalogScanner valve_inputs;
+int valve_1_channel = -1;
+int valve_3_channel = -1;
+int valve_4_channel = -1;
 
 // Movement tracking
 int previous_target_psi_1 = -1;
@@ -153,33 +154,33 @@ AccelStepper stepper_4(AccelStepper::DRIVER, gauge_4_step_pin, gauge_4_dir_pin);
 // ============================================================================
 
 // Gauge device commands (all gauges respond to these)
-const char *gauge_commands[] = {
+constexpr const char *gauge_commands[] PROGMEM = {
     naming::CMD_ACTIVATE_GAUGES,
     naming::CMD_DEACTIVATE_GAUGES,
     naming::CMD_ADJUST_GAUGE_ZERO,
     naming::CMD_SET_CURRENT_AS_ZERO};
 
 // Sensor arrays for each gauge (valve PSI sensor)
-const char *gauge_1_sensors[] = {naming::SENSOR_VALVE_1_PSI};
-const char *gauge_3_sensors[] = {naming::SENSOR_VALVE_3_PSI};
-const char *gauge_4_sensors[] = {naming::SENSOR_VALVE_4_PSI};
+constexpr const char *gauge_1_sensors[] PROGMEM = {naming::SENSOR_VALVE_1_PSI};
+constexpr const char *gauge_3_sensors[] PROGMEM = {naming::SENSOR_VALVE_3_PSI};
+constexpr const char *gauge_4_sensors[] PROGMEM = {naming::SENSOR_VALVE_4_PSI};
 
 // Create device definitions (bidirectional: commands + sensors)
-SentientDeviceDef dev_gauge_1(
+constexpr SentientDeviceDef dev_gauge_1 PROGMEM(
     naming::DEV_GAUGE_1,
     naming::FRIENDLY_GAUGE_1,
     "gauge_assembly",
     gauge_commands, 4,
     gauge_1_sensors, 1);
 
-SentientDeviceDef dev_gauge_3(
+constexpr SentientDeviceDef dev_gauge_3 PROGMEM(
     naming::DEV_GAUGE_3,
     naming::FRIENDLY_GAUGE_3,
     "gauge_assembly",
     gauge_commands, 4,
     gauge_3_sensors, 1);
 
-SentientDeviceDef dev_gauge_4(
+constexpr SentientDeviceDef dev_gauge_4 PROGMEM(
     naming::DEV_GAUGE_4,
     naming::FRIENDLY_GAUGE_4,
     "gauge_assembly",
@@ -187,7 +188,10 @@ SentientDeviceDef dev_gauge_4(
     gauge_4_sensors, 1);
 
 // Create the device registry
-SentientDeviceRegistry deviceRegistry;
+SENTIENT_DEVICE_REGISTRY(deviceRegistry,
+    &dev_gauge_1,
+    &dev_gauge_3,
+    &dev_gauge_4);
 
 // ──────────────────────────────────────────────────────────────────────────────
 // Forward Declarations
@@ -206,7 +210,7 @@ String extract_command_value(const JsonDocument &payload);
 void publish_command_acknowledgement(const char *device_id, const char *command);
 
 // MQTT objects
-SentientCapabilityManifest manifest;
+SentientManifestStream manifest(deviceRegistry);
 SentientMQTT mqtt(build_mqtt_config());
 
 // ============================================================================
@@ -252,6 +256,21 @@ void setup()
     digitalWrite(gauge_3_enable_pin, HIGH);
     digitalWrite(gauge_4_enable_pin, HIGH);
 
+    // ========================================
+    // Start background valve pot scanning
+    // ========================================
+    SentientAnalogFilter valve_filter;
+    valve_filter.smoothing = valve_smoothing;
+    valve_filter.hysteresis = valve_hysteresis;
+    valve_1_channel = valve_inputs.add(valve_1_pot_pin, valve_filter);
+    valve_3_channel = valve_inputs.add(valve_3_pot_pin, valve_filter);
+    valve_4_channel = valve_inputs.add(valve_4_pot_pin, valve_filter);
+
+    SentientAnalogConfig analog_config;
+    analog_config.bits = 10;
+    analog_config.oversample = 8;
+    valve_inputs.begin(analog_config);
+
     // ========================================
     // Configure steppers
     // ========================================
@@ -297,10 +316,6 @@ void setup()
     // ========================================
     // Register Devices
     // ========================================
-    Serial.println("[Gauge 1-3-4] Registering devices...");
-    deviceRegistry.addDevice(&dev_gauge_1);
-    deviceRegistry.addDevice(&dev_gauge_3);
-    deviceRegistry.addDevice(&dev_gauge_4);
     deviceRegistry.printSummary();
 
     // ========================================
@@ -339,9 +354,9 @@ void setup()
 
             // Register with Sentient system
             Serial.println("[Gauge 1-3-4] Registering with Sentient system...");
-            if (manifest.publish_registration(mqtt.get_client(), naming::ROOM_ID, naming::CONTROLLER_ID))
+            if (manifest.publish_registration(mqtt, naming::ROOM_ID, naming::CONTROLLER_ID))
             {
-                Serial.println("[Gauge 1-3-4] Registration successful!");
+                Serial.println("[Gauge 1-3-4] Registration started");
             }
             else
             {
@@ -369,6 +384,7 @@ void loop()
 {
     // 1. LISTEN - Process MQTT commands from Sentient
     mqtt.loop();
+    manifest.loop();
 
     // 2. DETECT - Read valve positions and publish changes
     read_valve_positions();
@@ -428,7 +444,6 @@ void handle_mqtt_command(const char *command, const JsonDocument &payload, void
         previous_target_psi_1 = -1;
         previous_target_psi_3 = -1;
         previous_target_psi_4 = -1;
-        filters_initialized = false;
 
         Serial.println("[GAUGES] Deactivated - moving to zero");
         publish_hardware_status();
@@ -576,7 +591,6 @@ void handle_mqtt_command(const char *command, const JsonDocument &payload, void
         previous_target_psi_1 = -1;
         previous_target_psi_3 = -1;
         previous_target_psi_4 = -1;
-        filters_initialized = false;
 
         publish_hardware_status();
         Serial.println("[RESET] All gauges at zero, motors disabled");
@@ -605,9 +619,6 @@ void build_capability_manifest()
         firmware::VERSION,
         naming::ROOM_ID,
         naming::CONTROLLER_ID);
-
-    // Auto-generate entire manifest from device registry
-    deviceRegistry.buildManifest(manifest);
 }
 
 // ──────────────────────────────────────────────────────────────────────────────
@@ -716,37 +727,15 @@ void load_gauge_positions()
 // ──────────────────────────────────────────────────────────────────────────────
 void read_valve_positions()
 {
-    // Average readings for noise reduction
-    int sum1 = 0, sum3 = 0, sum4 = 0;
-    for (int i = 0; i < num_analog_readings; i++)
-    {
-        sum1 += analogRead(valve_1_pot_pin);
-        sum3 += analogRead(valve_3_pot_pin);
-        sum4 += analogRead(valve_4_pot_pin);
-    }
-
-    float raw1 = sum1 / (float)num_analog_readings;
-    float raw3 = sum3 / (float)num_analog_readings;
-    float raw4 = sum4 / (float)num_analog_readings;
-
-    // Initialize filters on first run
-    if (!filters_initialized)
-    {
-        filtered_analog_1 = raw1;
-        filtered_analog_3 = raw3;
-        filtered_analog_4 = raw4;
-        filters_initialized = true;
-    }
-
-    // Apply exponential moving average filter
-    filtered_analog_1 = (filter_alpha * raw1) + ((1.0f - filter_alpha) * filtered_analog_1);
-    filtered_analog_3 = (filter_alpha * raw3) + ((1.0f - filter_alpha) * filtered_analog_3);
-    filtered_analog_4 = (filter_alpha * raw4) + ((1.0f - filter_alpha) * filtered_analog_4);
+    // Median, low-pass and hysteresis are applied by the scanner; nothing waits here
+    int analog_1 = valve_inputs.read(valve_1_channel);
+    int analog_3 = valve_inputs.read(valve_3_channel);
+    int analog_4 = valve_inputs.read(valve_4_channel);
 
     // Convert to PSI
-    valve_1_psi = map((int)filtered_analog_1, valve_1_zero, valve_1_max, psi_min, psi_max);
-    valve_3_psi = map((int)filtered_analog_3, valve_3_zero, valve_3_max, psi_min, psi_max);
-    valve_4_psi = map((int)filtered_analog_4, valve_4_zero, valve_4_max, psi_min, psi_max);
+    valve_1_psi = map(analog_1, valve_1_zero, valve_1_max, psi_min, psi_max);
+    valve_3_psi = map(analog_3, valve_3_zero, valve_3_max, psi_min, psi_max);
+    valve_4_psi = map(analog_4, valve_4_zero, valve_4_max, psi_min, psi_max);
 
     // Constrain to valid range
     valve_1_psi = constrain(valve_1_psi, psi_min, psi_max);
@@ -811,13 +800,12 @@ void check_and_publish_sensor_changes()
     // ========================================
     if (valve_1_psi != last_published_valve_1_psi || force_publish)
     {
-        JsonDocument doc;
+        JsonDocument &doc = mqtt.scratchDocument();
         doc["psi"] = valve_1_psi;
         doc["gauge_psi"] = gauge_1_psi;
         doc["ts"] = millis();
 
-        String item = String(naming::DEV_GAUGE_1) + "/" + naming::SENSOR_VALVE_1_PSI;
-        mqtt.publishJson(naming::CAT_SENSORS, item.c_str(), doc);
+        mqtt.publishJson(naming::CAT_SENSORS, naming::DEV_GAUGE_1, naming::SENSOR_VALVE_1_PSI, doc);
         last_published_valve_1_psi = valve_1_psi;
     }
 
@@ -826,13 +814,12 @@ void check_and_publish_sensor_changes()
     // ========================================
     if (valve_3_psi != last_published_valve_3_psi || force_publish)
     {
-        JsonDocument doc;
+        JsonDocument &doc = mqtt.scratchDocument();
         doc["psi"] = valve_3_psi;
         doc["gauge_psi"] = gauge_3_psi;
         doc["ts"] = millis();
 
-        String item = String(naming::DEV_GAUGE_3) + "/" + naming::SENSOR_VALVE_3_PSI;
-        mqtt.publishJson(naming::CAT_SENSORS, item.c_str(), doc);
+        mqtt.publishJson(naming::CAT_SENSORS, naming::DEV_GAUGE_3, naming::SENSOR_VALVE_3_PSI, doc);
         last_published_valve_3_psi = valve_3_psi;
     }
 
@@ -841,13 +828,12 @@ void check_and_publish_sensor_changes()
     // ========================================
     if (valve_4_psi != last_published_valve_4_psi || force_publish)
     {
-        JsonDocument doc;
+        JsonDocument &doc = mqtt.scratchDocument();
         doc["psi"] = valve_4_psi;
         doc["gauge_psi"] = gauge_4_psi;
         doc["ts"] = millis();
 
-        String item = String(naming::DEV_GAUGE_4) + "/" + naming::SENSOR_VALVE_4_PSI;
-        mqtt.publishJson(naming::CAT_SENSORS, item.c_str(), doc);
+        mqtt.publishJson(naming::CAT_SENSORS, naming::DEV_GAUGE_4, naming::SENSOR_VALVE_4_PSI, doc);
         last_published_valve_4_psi = valve_4_psi;
     }
 
@@ -863,7 +849,7 @@ void check_and_publish_sensor_changes()
 // ──────────────────────────────────────────────────────────────────────────────
 void publish_hardware_status()
 {
-    JsonDocument doc;
+    JsonDocument &doc = mqtt.scratchDocument();
     doc["gauges_active"] = gauges_active;
     doc["gauge_1_psi"] = gauge_1_psi;
     doc["gauge_3_psi"] = gauge_3_psi;
@@ -918,7 +904,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
                       String(naming::CAT_ACKNOWLEDGEMENT) + "/" + String(naming::CONTROLLER_ID) + "/" +
                       String(device_id) + "/" + String(command);
 
-    mqtt.get_client().publish(ackTopic.c_str(), buf, false);
+    mqtt.publishTopic(ackTopic.c_str(), buf);
 
     Serial.print(F("[ACK] -> "));
     Serial.println(ackTopic);
@@ -26,9 +26,10 @@
 
 #include <SentientMQTT.h>
 #include <SentientDeviceRegistry.h>
-#include <SentientCapabilityManifest.h>
+#include <SentientManifestStream.h>
 #include <AccelStepper.h>
 #include <EEPROM.h>
+#include <SentientAnalogScanner.h>
 
 #include "FirmwareMetadata.h"
 #include "controller_naming.h"
@@ -89,9 +90,9 @@ const int valve_5_max = 730;
 const int valve_7_zero = 5;
 const int valve_7_max = 932;
 
-// Signal filtering
-const int num_analog_readings = 3;
-const float filter_alpha = 0.25f;
+// Signal filtering (pots are read at 10 bits, the resolution of the calibration above)
+const uint8_t valve_smoothing = 4;          // Scanner IIR: settles in about 16 ms at 1 kHz scans
+const uint8_t valve_hysteresis = 1;         // Counts a pot must move before the reading follows
 const int psi_deadband = 1;                 // PSI must change by this amount to trigger movement
 const unsigned long movement_delay_ms = 75; // Minimum time between movements
 
@@ -127,11 +128,11 @@ int last_published_valve_7_psi = -1;
 unsigned long last_sensor_publish_time = 0;
 const unsigned long sensor_publish_interval_ms = 60000;
 
-// Filtered analog values
-float filtered_analog_2 = 0.0f;
-float filtered_analog_5 = 0.0f;
-float filtered_analog_7 = 0.0f;
-bool filters_initialized = false;
+// Valve pots, scanned and filtered in the background
+SentientAnalogScanner valve_inputs;
+int valve_2_channel = -1;
+int valve_5_channel = -1;
+int valve_7_channel = -1;
 
 // Movement tracking
 int previous_target_psi_2 = -1;
@@ -153,33 +154,33 @@ AccelStepper stepper_7(AccelStepper::DRIVER, gauge_7_step_pin, gauge_7_dir_pin);
 // ============================================================================
 
 // Gauge device commands (all gauges respond to these)
-const char *gauge_commands[] = {
+constexpr const char *gauge_commands[] PROGMEM = {
     naming::CMD_ACTIVATE_GAUGES,
     naming::CMD_INACTIVATE_GAUGES,
     naming::CMD_ADJUST_GAUGE_ZERO,
     naming::CMD_SET_CURRENT_AS_ZERO};
 
 // Sensor arrays for each gauge (valve PSI sensor)
-const char *gauge_2_sensors[] = {naming::SENSOR_VALVE_2_PSI};
-const char *gauge_5_sensors[] = {naming::SENSOR_VALVE_5_PSI};
-const char *gauge_7_sensors[] = {naming::SENSOR_VALVE_7_PSI};
+constexpr const char *gauge_2_sensors[] PROGMEM = {naming::SENSOR_VALVE_2_PSI};
+constexpr const char *gauge_5_sensors[] PROGMEM = {naming::SENSOR_VALVE_5_PSI};
+constexpr const char *gauge_7_sensors[] PROGMEM = {naming::SENSOR_VALVE_7_PSI};
 
 // Create device definitions (bidirectional: commands + sensors)
-SentientDeviceDef dev_gauge_2(
+constexpr SentientDeviceDef dev_gauge_2 PROGMEM(
     naming::DEV_GAUGE_2,
     naming::FRIENDLY_GAUGE_2,
     "gauge_assembly",
     gauge_commands, 4,
     gauge_2_sensors, 1);
 
-SentientDeviceDef dev_gauge_5(
+constexpr SentientDeviceDef dev_gauge_5 PROGMEM(
     naming::DEV_GAUGE_5,
     naming::FRIENDLY_GAUGE_5,
     "gauge_assembly",
     gauge_commands, 4,
     gauge_5_sensors, 1);
 
-SentientDeviceDef dev_gauge_7(
+constexpr SentientDeviceDef dev_gauge_7 PROGMEM(
     naming::DEV_GAUGE_7,
     naming::FRIENDLY_GAUGE_7,
     "gauge_assembly",
@@ -187,7 +188,10 @@ SentientDeviceDef dev_gauge_7(
     gauge_7_sensors, 1);
 
 // Create the device registry
-SentientDeviceRegistry deviceRegistry;
+SENTIENT_DEVICE_REGISTRY(deviceRegistry,
+    &dev_gauge_2,
+    &dev_gauge_5,
+    &dev_gauge_7);
 
 // ──────────────────────────────────────────────────────────────────────────────
 // Forward Declarations
@@ -206,7 +210,7 @@ String extract_command_value(const JsonDocument &payload);
 void publish_command_acknowledgement(const char *device_id, const char *command);
 
 // MQTT objects
-SentientCapabilityManifest manifest;
+SentientManifestStream manifest(deviceRegistry);
 SentientMQTT mqtt(build_mqtt_config());
 
 // ============================================================================
@@ -252,6 +256,21 @@ void setup()
     digitalWrite(gauge_5_enable_pin, HIGH);
     digitalWrite(gauge_7_enable_pin, HIGH);
 
+    // ========================================
+    // Start background valve pot scanning
+    // ========================================
+    SentientAnalogFilter valve_filter;
+    valve_filter.smoothing = valve_smoothing;
+    valve_filter.hysteresis = valve_hysteresis;
+    valve_2_channel = valve_inputs.add(valve_2_pot_pin, valve_filter);
+    valve_5_channel = valve_inputs.add(valve_5_pot_pin, valve_filter);
+    valve_7_channel = valve_inputs.add(valve_7_pot_pin, valve_filter);
+
+    SentientAnalogConfig analog_config;
+    analog_config.bits = 10;
+    analog_config.oversample = 8;
+    valve_inputs.begin(analog_config);
+
     // ========================================
     // Configure steppers
     // ========================================
@@ -297,10 +316,6 @@ void setup()
     // ========================================
     // Register Devices
     // ========================================
-    Serial.println("[Gauge 2-5-7] Registering devices...");
-    deviceRegistry.addDevice(&dev_gauge_2);
-    deviceRegistry.addDevice(&dev_gauge_5);
-    deviceRegistry.addDevice(&dev_gauge_7);
     deviceRegistry.printSummary();
 
     // ========================================
@@ -339,9 +354,9 @@ void setup()
 
             // Register with Sentient system
             Serial.println("[Gauge 2-5-7] Registering with Sentient system...");
-            if (manifest.publish_registration(mqtt.get_client(), naming::ROOM_ID, naming::CONTROLLER_ID))
+            if (manifest.publish_registration(mqtt, naming::ROOM_ID, naming::CONTROLLER_ID))
             {
-                Serial.println("[Gauge 2-5-7] Registration successful!");
+                Serial.println("[Gauge 2-5-7] Registration started");
             }
             else
             {
@@ -369,6 +384,7 @@ void loop()
 {
     // 1. LISTEN - Process MQTT commands from Sentient
     mqtt.loop();
+    manifest.loop();
 
     // 2. DETECT - Read valve positions and publish changes
     read_valve_positions();
@@ -428,7 +444,6 @@ void handle_mqtt_command(const char *command, const JsonDocument &payload, void
         previous_target_psi_2 = -1;
         previous_target_psi_5 = -1;
         previous_target_psi_7 = -1;
-        filters_initialized = false;
 
         Serial.println("[GAUGES] Inactivated - moving to zero");
         publish_hardware_status();
@@ -576,7 +591,6 @@ void handle_mqtt_command(const char *command, const JsonDocument &payload, void
         previous_target_psi_2 = -1;
         previous_target_psi_5 = -1;
         previous_target_psi_7 = -1;
-        filters_initialized = false;
 
         publish_hardware_status();
         Serial.println("[RESET] All gauges at zero, motors disabled");
@@ -605,9 +619,6 @@ void build_capability_manifest()
         firmware::VERSION,
         naming::ROOM_ID,
         naming::CONTROLLER_ID);
-
-    // Auto-generate entire manifest from device registry
-    deviceRegistry.buildManifest(manifest);
 }
 
 // ──────────────────────────────────────────────────────────────────────────────
@@ -716,37 +727,15 @@ void load_gauge_positions()
 // ──────────────────────────────────────────────────────────────────────────────
 void read_valve_positions()
 {
-    // Average readings for noise reduction
-    int sum2 = 0, sum5 = 0, sum7 = 0;
-    for (int i = 0; i < num_analog_readings; i++)
-    {
-        sum2 += analogRead(valve_2_pot_pin);
-        sum5 += analogRead(valve_5_pot_pin);
-        sum7 += analogRead(valve_7_pot_pin);
-    }
-
-    float raw2 = sum2 / (float)num_analog_readings;
-    float raw5 = sum5 / (float)num_analog_readings;
-    float raw7 = sum7 / (float)num_analog_readings;
-
-    // Initialize filters on first run
-    if (!filters_initialized)
-    {
-        filtered_analog_2 = raw2;
-        filtered_analog_5 = raw5;
-        filtered_analog_7 = raw7;
-        filters_initialized = true;
-    }
-
-    // Apply exponential moving average filter
-    filtered_analog_2 = (filter_alpha * raw2) + ((1.0f - filter_alpha) * filtered_analog_2);
-    filtered_analog_5 = (filter_alpha * raw5) + ((1.0f - filter_alpha) * filtered_analog_5);
-    filtered_analog_7 = (filter_alpha * raw7) + ((1.0f - filter_alpha) * filtered_analog_7);
+    // Median, low-pass and hysteresis are applied by the scanner; nothing waits here
+    int analog_2 = valve_inputs.read(valve_2_channel);
+    int analog_5 = valve_inputs.read(valve_5_channel);
+    int analog_7 = valve_inputs.read(valve_7_channel);
 
     // Convert to PSI
-    valve_2_psi = map((int)filtered_analog_2, valve_2_zero, valve_2_max, psi_min, psi_max);
-    valve_5_psi = map((int)filtered_analog_5, valve_5_zero, valve_5_max, psi_min, psi_max);
-    valve_7_psi = map((int)filtered_analog_7, valve_7_zero, valve_7_max, psi_min, psi_max);
+    valve_2_psi = map(analog_2, valve_2_zero, valve_2_max, psi_min, psi_max);
+    valve_5_psi = map(analog_5, valve_5_zero, valve_5_max, psi_min, psi_max);
+    valve_7_psi = map(analog_7, valve_7_zero, valve_7_max, psi_min, psi_max);
 
     // Constrain to valid range
     valve_2_psi = constrain(valve_2_psi, psi_min, psi_max);
@@ -811,13 +800,12 @@ void check_and_publish_sensor_changes()
     // ========================================
     if (valve_2_psi != last_published_valve_2_psi || force_publish)
     {
-        JsonDocument doc;
+        JsonDocument &doc = mqtt.scratchDocument();
         doc["psi"] = valve_2_psi;
         doc["gauge_psi"] = gauge_2_psi;
         doc["ts"] = millis();
 
-        String item = String(naming::DEV_GAUGE_2) + "/" + naming::SENSOR_VALVE_2_PSI;
-        mqtt.publishJson(naming::CAT_SENSORS, item.c_str(), doc);
+        mqtt.publishJson(naming::CAT_SENSORS, naming::DEV_GAUGE_2, naming::SENSOR_VALVE_2_PSI, doc);
         last_published_valve_2_psi = valve_2_psi;
     }
 
@@ -826,13 +814,12 @@ void check_and_publish_sensor_changes()
     // ========================================
     if (valve_5_psi != last_published_valve_5_psi || force_publish)
     {
-        JsonDocument doc;
+        JsonDocument &doc = mqtt.scratchDocument();
         doc["psi"] = valve_5_psi;
         doc["gauge_psi"] = gauge_5_psi;
         doc["ts"] = millis();
 
-        String item = String(naming::DEV_GAUGE_5) + "/" + naming::SENSOR_VALVE_5_PSI;
-        mqtt.publishJson(naming::CAT_SENSORS, item.c_str(), doc);
+        mqtt.publishJson(naming::CAT_SENSORS, naming::DEV_GAUGE_5, naming::SENSOR_VALVE_5_PSI, doc);
         last_published_valve_5_psi = valve_5_psi;
     }
 
@@ -841,13 +828,12 @@ void check_and_publish_sensor_changes()
     // ========================================
     if (valve_7_psi != last_published_valve_7_psi || force_publish)
     {
-        JsonDocument doc;
+        JsonDocument &doc = mqtt.scratchDocument();
         doc["psi"] = valve_7_psi;
         doc["gauge_psi"] = gauge_7_psi;
         doc["ts"] = millis();
 
-        String item = String(naming::DEV_GAUGE_7) + "/" + naming::SENSOR_VALVE_7_PSI;
-        mqtt.publishJson(naming::CAT_SENSORS, item.c_str(), doc);
+        mqtt.publishJson(naming::CAT_SENSORS, naming::DEV_GAUGE_7, naming::SENSOR_VALVE_7_PSI, doc);
         last_published_valve_7_psi = valve_7_psi;
     }
 
@@ -863,7 +849,7 @@ void check_and_publish_sensor_changes()
 // ──────────────────────────────────────────────────────────────────────────────
 void publish_hardware_status()
 {
-    JsonDocument doc;
+    JsonDocument &doc = mqtt.scratchDocument();
     doc["gauges_active"] = gauges_active;
     doc["gauge_2_psi"] = gauge_2_psi;
     doc["gauge_5_psi"] = gauge_5_psi;
@@ -918,7 +904,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
                       String(naming::CAT_ACKNOWLEDGEMENT) + "/" + String(naming::CONTROLLER_ID) + "/" +
                       String(device_id) + "/" + String(command);
 
-    mqtt.get_client().publish(ackTopic.c_str(), buf, false);
+    mqtt.publishTopic(ackTopic.c_str(), buf);
 
     Serial.print(F("[ACK] -> "));
     Serial.println(ackTopic);
@@ -58,6 +58,8 @@ namespace naming
     constexpr const char *CMD_FLICKER_MODE_8 = "flicker_mode_3";
     constexpr const char *CMD_GAUGE_LEDS_ON = "gauge_leds_on";
     constexpr const char *CMD_GAUGE_LEDS_OFF = "gauge_leds_off";
+    // Ceiling and gauge LEDs: effect + parameters in the payload
+    constexpr const char *CMD_SET_EFFECT = "set_effect";
     // Calibration commands
     constexpr const char *CMD_ADJUST_GAUGE_ZERO = "adjust_gauge_zero";
     constexpr const char *CMD_SET_CURRENT_AS_ZERO = "set_current_as_zero";
@@ -75,6 +77,7 @@ namespace naming
     constexpr const char *FRIENDLY_CMD_FLICKER_MODE_3 = "Flicker Mode 3";
     constexpr const char *FRIENDLY_CMD_GAUGE_LEDS_ON = "Gauge LEDs On";
     constexpr const char *FRIENDLY_CMD_GAUGE_LEDS_OFF = "Gauge LEDs Off";
+    constexpr const char *FRIENDLY_CMD_SET_EFFECT = "Set LED Effect";
     constexpr const char *FRIENDLY_CMD_ADJUST_GAUGE_ZERO = "Adjust Gauge Zero";
     constexpr const char *FRIENDLY_CMD_SET_CURRENT_AS_ZERO = "Set Current As Zero";
 
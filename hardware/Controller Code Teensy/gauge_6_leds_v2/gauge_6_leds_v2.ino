@@ -26,11 +26,14 @@
  */
 
 #include <SentientMQTT.h>
+#include <SentientTaskScheduler.h>
 #include <SentientDeviceRegistry.h>
-#include <SentientCapabilityManifest.h>
+#include <SentientManifestStream.h>
 #include <AccelStepper.h>
 #include <FastLED.h>
+#include <SentientLedEffects.h>
 #include <EEPROM.h>
+#include <SentientAnalogScanner.h>
 
 #include "FirmwareMetadata.h"
 #include "controller_naming.h"
@@ -100,6 +103,7 @@ const int eeprom_addr_gauge6 = 0;
 // Ceiling LEDs
 const int num_ceiling_leds = 219;
 CRGB ceiling_leds[num_ceiling_leds];
+uint8_t ceiling_fire_state[SENTIENT_LED_FIRE_STATE_BYTES(num_ceiling_leds)];
 
 // Ceiling LED sections (clock face pattern)
 const int section_start[] = {0, 0, 25, 48, 73, 99, 125, 149, 174, 198};
@@ -126,29 +130,38 @@ const uint32_t flicker_orange = 0xFF8000;
 const uint32_t flicker_yellow = 0xFFFF00;
 const uint32_t flicker_purple = 0x800080;
 
+const uint16_t flicker_period_ms = 500; // Bursts of 50-250 ms, 100-500 ms apart
+
 // ============================================================================
-// FLICKER ANIMATION STATE
+// LED EFFECT ENGINE
 // ============================================================================
 
-struct FlickerState
+// Fixed frame rate; each strip is only sent when its pixels changed
+const uint8_t led_frames_per_second = 60;
+SentientLedEffects led_effects(led_frames_per_second);
+int ceiling_segment = -1;
+int gauge_segments[7] = {-1, -1, -1, -1, -1, -1, -1};
+
+// Command routing context for each LED device's set_effect
+struct LedGroup
 {
-    bool enabled = false;
-    bool active = false;
-    unsigned long next_burst_at = 0;
-    unsigned long flicker_end = 0;
-    uint32_t color1 = 0;
-    uint32_t color2 = 0;
-    bool use_two_colors = false;
-    bool use_second_color = false;
+    int *segments;
+    int count;
+    const char *label;
 };
-
-FlickerState gauge_flicker[7];
+LedGroup ceiling_group = {&ceiling_segment, 1, "CEILING"};
+LedGroup gauge_led_group = {gauge_segments, 7, "GAUGE LEDS"};
 
 // ============================================================================
 // SENSOR CONFIGURATION
 // ============================================================================
 
-const int photoresistor_threshold = 500;
+const int photoresistor_threshold = 500; // 10-bit, like the valve calibration
+
+// Pot and photoresistors, scanned and filtered in the background
+SentientAnalogScanner analog_inputs;
+int valve_6_channel = -1;
+int lever_channels[7] = {-1, -1, -1, -1, -1, -1, -1}; // Levers 1 (red) .. 7 (purple)
 
 // Sensor states
 bool lever_1_red_open = false;
@@ -171,8 +184,12 @@ bool last_published_lever_7_purple_open = false;
 bool levers_initialized = false;
 
 // Periodic publishing
-unsigned long last_sensor_publish_time = 0;
 const unsigned long sensor_publish_interval = 60000;
+const uint32_t gauge_tracking_interval_ms = 10;
+const uint32_t sensor_scan_interval_ms = 20;
+
+// Periodic work; the stepper and LED engine still run every loop()
+SentientTaskScheduler tasks;
 
 // ============================================================================
 // HARDWARE STATE
@@ -188,104 +205,116 @@ AccelStepper stepper_6(AccelStepper::DRIVER, gauge_6_step_pin, gauge_6_dir_pin);
 // ============================================================================
 
 // Gauge 6 commands and sensors
-const char *gauge_6_commands[] = {
+constexpr const char *gauge_6_commands[] PROGMEM = {
     CMD_ACTIVATE_GAUGES,
     CMD_DEACTIVATE_GAUGES,
     CMD_ADJUST_GAUGE_ZERO,
     CMD_SET_CURRENT_AS_ZERO};
-const char *gauge_6_sensors[] = {SENSOR_VALVE_6_PSI};
+constexpr const char *gauge_6_sensors[] PROGMEM = {SENSOR_VALVE_6_PSI};
 
 // Lever sensors (no commands)
-const char *lever_state_sensors[] = {"state"};
+constexpr const char *lever_state_sensors[] PROGMEM = {"state"};
 
 // Ceiling LED commands
-const char *ceiling_led_commands[] = {
+constexpr const char *ceiling_led_commands[] PROGMEM = {
     CMD_CEILING_OFF,
     CMD_CEILING_PATTERN_1,
     CMD_CEILING_PATTERN_2,
-    CMD_CEILING_PATTERN_3};
+    CMD_CEILING_PATTERN_3,
+    CMD_SET_EFFECT};
 
 // Gauge indicator LED commands
-const char *gauge_led_commands[] = {
+constexpr const char *gauge_led_commands[] PROGMEM = {
     CMD_FLICKER_OFF,
     CMD_FLICKER_MODE_2,
     CMD_FLICKER_MODE_5,
     CMD_FLICKER_MODE_8,
     CMD_GAUGE_LEDS_ON,
-    CMD_GAUGE_LEDS_OFF};
+    CMD_GAUGE_LEDS_OFF,
+    CMD_SET_EFFECT};
 
 // Device definitions
-SentientDeviceDef dev_gauge_6(
+constexpr SentientDeviceDef dev_gauge_6 PROGMEM(
     DEV_GAUGE_6,
     FRIENDLY_GAUGE_6,
     "gauge_assembly",
     gauge_6_commands, 4,
     gauge_6_sensors, 1);
 
-SentientDeviceDef dev_lever_1_red(
+constexpr SentientDeviceDef dev_lever_1_red PROGMEM(
     DEV_LEVER_1_RED,
     FRIENDLY_LEVER_1_RED,
     "photoresistor",
     nullptr, 0,
     lever_state_sensors, 1);
 
-SentientDeviceDef dev_lever_2_blue(
+constexpr SentientDeviceDef dev_lever_2_blue PROGMEM(
     DEV_LEVER_2_BLUE,
     FRIENDLY_LEVER_2_BLUE,
     "photoresistor",
     nullptr, 0,
     lever_state_sensors, 1);
 
-SentientDeviceDef dev_lever_3_green(
+constexpr SentientDeviceDef dev_lever_3_green PROGMEM(
     DEV_LEVER_3_GREEN,
     FRIENDLY_LEVER_3_GREEN,
     "photoresistor",
     nullptr, 0,
     lever_state_sensors, 1);
 
-SentientDeviceDef dev_lever_4_white(
+constexpr SentientDeviceDef dev_lever_4_white PROGMEM(
     DEV_LEVER_4_WHITE,
     FRIENDLY_LEVER_4_WHITE,
     "photoresistor",
     nullptr, 0,
     lever_state_sensors, 1);
 
-SentientDeviceDef dev_lever_5_orange(
+constexpr SentientDeviceDef dev_lever_5_orange PROGMEM(
     DEV_LEVER_5_ORANGE,
     FRIENDLY_LEVER_5_ORANGE,
     "photoresistor",
     nullptr, 0,
     lever_state_sensors, 1);
 
-SentientDeviceDef dev_lever_6_yellow(
+constexpr SentientDeviceDef dev_lever_6_yellow PROGMEM(
     DEV_LEVER_6_YELLOW,
     FRIENDLY_LEVER_6_YELLOW,
     "photoresistor",
     nullptr, 0,
     lever_state_sensors, 1);
 
-SentientDeviceDef dev_lever_7_purple(
+constexpr SentientDeviceDef dev_lever_7_purple PROGMEM(
     DEV_LEVER_7_PURPLE,
     FRIENDLY_LEVER_7_PURPLE,
     "photoresistor",
     nullptr, 0,
     lever_state_sensors, 1);
 
-SentientDeviceDef dev_ceiling_leds(
+constexpr SentientDeviceDef dev_ceiling_leds PROGMEM(
     DEV_CEILING_LEDS,
     FRIENDLY_CEILING_LEDS,
     "led_strip",
-    ceiling_led_commands, 4,
+    ceiling_led_commands, 5,
     nullptr, 0);
 
-SentientDeviceDef dev_gauge_leds(
+constexpr SentientDeviceDef dev_gauge_leds PROGMEM(
     DEV_GAUGE_LEDS,
     FRIENDLY_GAUGE_LEDS,
     "led_strip",
-    gauge_led_commands, 6,
+    gauge_led_commands, 7,
     nullptr, 0);
 
-SentientDeviceRegistry deviceRegistry;
+SENTIENT_DEVICE_REGISTRY(deviceRegistry,
+    &dev_gauge_6,
+    &dev_lever_1_red,
+    &dev_lever_2_blue,
+    &dev_lever_3_green,
+    &dev_lever_4_white,
+    &dev_lever_5_orange,
+    &dev_lever_6_yellow,
+    &dev_lever_7_purple,
+    &dev_ceiling_leds,
+    &dev_gauge_leds);
 
 // ============================================================================
 // FORWARD DECLARATIONS
@@ -295,29 +324,32 @@ void build_capability_manifest();
 SentientMQTTConfig build_mqtt_config();
 bool build_heartbeat_payload(JsonDocument &doc, void *ctx);
 void handle_mqtt_command(const char *command, const JsonDocument &payload, void *ctx);
+void handle_effect_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx);
 void update_gauge_tracking();
 void monitor_sensors();
 void publish_sensor_changes(bool force_publish);
 void publish_hardware_status();
 void save_gauge_position(int gauge_number);
 void load_gauge_positions();
+void clear_ceiling();
 void set_ceiling_off();
 void set_ceiling_pattern_1();
 void set_ceiling_pattern_2();
 void set_ceiling_pattern_3();
+void set_gauge_leds_base();
+void set_gauge_flicker(int gauge_index, uint32_t color1, uint32_t color2);
 void set_flicker_off();
 void set_flicker_mode_2();
 void set_flicker_mode_5();
 void set_flicker_mode_8();
-void update_gauge_flicker();
 String extract_command_value(const JsonDocument &payload);
-void publish_command_acknowledgement(const char *device_id, const char *command);
+void publish_command_acknowledgement(const char *device_id, const char *command, bool success = true);
 
 // ============================================================================
 // MQTT OBJECTS
 // ============================================================================
 
-SentientCapabilityManifest manifest;
+SentientManifestStream manifest(deviceRegistry);
 SentientMQTT mqtt(build_mqtt_config());
 
 // ============================================================================
@@ -355,45 +387,49 @@ void setup()
     // Load saved gauge position
     load_gauge_positions();
 
-    // Configure analog inputs
-    pinMode(valve_6_pot_pin, INPUT);
-    pinMode(lever_1_red_pin, INPUT);
-    pinMode(lever_2_blue_pin, INPUT);
-    pinMode(lever_3_green_pin, INPUT);
-    pinMode(lever_4_white_pin, INPUT);
-    pinMode(lever_5_orange_pin, INPUT);
-    pinMode(lever_6_yellow_pin, INPUT);
-    pinMode(lever_7_purple_pin, INPUT);
-
-    // Initialize LEDs
-    FastLED.addLeds<WS2811, ceiling_leds_pin, RGB>(ceiling_leds, num_ceiling_leds);
-    FastLED.addLeds<WS2812B, gauge_led_1_pin, GRB>(gauge_leds[0], 1);
-    FastLED.addLeds<WS2812B, gauge_led_2_pin, GRB>(gauge_leds[1], 1);
-    FastLED.addLeds<WS2812B, gauge_led_3_pin, GRB>(gauge_leds[2], 1);
-    FastLED.addLeds<WS2812B, gauge_led_4_pin, GRB>(gauge_leds[3], 1);
-    FastLED.addLeds<WS2812B, gauge_led_5_pin, GRB>(gauge_leds[4], 1);
-    FastLED.addLeds<WS2812B, gauge_led_6_pin, GRB>(gauge_leds[5], 1);
-    FastLED.addLeds<WS2812B, gauge_led_7_pin, GRB>(gauge_leds[6], 1);
-    FastLED.clear();
-    FastLED.show();
+    // Configure analog inputs: both ADCs scan them in the background
+    SentientAnalogFilter pot_filter;
+    pot_filter.smoothing = 4;
+    pot_filter.hysteresis = 1; // A pot resting between two codes must not move the needle
+    valve_6_channel = analog_inputs.add(valve_6_pot_pin, pot_filter);
+
+    SentientAnalogFilter light_filter;
+    light_filter.smoothing = 2;
+    const int lever_pins[7] = {lever_1_red_pin, lever_2_blue_pin, lever_3_green_pin, lever_4_white_pin,
+                               lever_5_orange_pin, lever_6_yellow_pin, lever_7_purple_pin};
+    for (int i = 0; i < 7; i++)
+    {
+        lever_channels[i] = analog_inputs.add(lever_pins[i], light_filter);
+    }
+
+    SentientAnalogConfig analog_config;
+    analog_config.bits = 10;
+    analog_config.oversample = 8;
+    analog_inputs.begin(analog_config);
+
+    // Initialize LEDs: one segment per controller, so a flickering gauge LED
+    // no longer resends the 219 ceiling LEDs
+    ceiling_segment = led_effects.addSegment(ceiling_leds, num_ceiling_leds, ceiling_fire_state);
+    led_effects.mirrorTo(ceiling_segment, FastLED.addLeds<WS2811, ceiling_leds_pin, RGB>(ceiling_leds, num_ceiling_leds));
+    for (int i = 0; i < 7; i++)
+    {
+        gauge_segments[i] = led_effects.addSegment(gauge_leds[i], 1);
+    }
+    led_effects.mirrorTo(gauge_segments[0], FastLED.addLeds<WS2812B, gauge_led_1_pin, GRB>(gauge_leds[0], 1));
+    led_effects.mirrorTo(gauge_segments[1], FastLED.addLeds<WS2812B, gauge_led_2_pin, GRB>(gauge_leds[1], 1));
+    led_effects.mirrorTo(gauge_segments[2], FastLED.addLeds<WS2812B, gauge_led_3_pin, GRB>(gauge_leds[2], 1));
+    led_effects.mirrorTo(gauge_segments[3], FastLED.addLeds<WS2812B, gauge_led_4_pin, GRB>(gauge_leds[3], 1));
+    led_effects.mirrorTo(gauge_segments[4], FastLED.addLeds<WS2812B, gauge_led_5_pin, GRB>(gauge_leds[4], 1));
+    led_effects.mirrorTo(gauge_segments[5], FastLED.addLeds<WS2812B, gauge_led_6_pin, GRB>(gauge_leds[5], 1));
+    led_effects.mirrorTo(gauge_segments[6], FastLED.addLeds<WS2812B, gauge_led_7_pin, GRB>(gauge_leds[6], 1));
+    set_ceiling_off();
+    set_flicker_off();
 
     Serial.println("[Gauge 6 LEDs] FastLED initialized");
     Serial.print("[Gauge 6 LEDs] Ceiling LEDs: ");
     Serial.println(num_ceiling_leds);
     Serial.println("[Gauge 6 LEDs] Gauge indicator LEDs: 7");
 
-    // Register devices
-    Serial.println("[Gauge 6 LEDs] Registering devices...");
-    deviceRegistry.addDevice(&dev_gauge_6);
-    deviceRegistry.addDevice(&dev_lever_1_red);
-    deviceRegistry.addDevice(&dev_lever_2_blue);
-    deviceRegistry.addDevice(&dev_lever_3_green);
-    deviceRegistry.addDevice(&dev_lever_4_white);
-    deviceRegistry.addDevice(&dev_lever_5_orange);
-    deviceRegistry.addDevice(&dev_lever_6_yellow);
-    deviceRegistry.addDevice(&dev_lever_7_purple);
-    deviceRegistry.addDevice(&dev_ceiling_leds);
-    deviceRegistry.addDevice(&dev_gauge_leds);
     deviceRegistry.printSummary();
 
     // Build capability manifest
@@ -410,6 +446,8 @@ void setup()
     else
     {
         Serial.println("[Gauge 6 LEDs] MQTT initialization successful");
+        mqtt.onCommand(DEV_CEILING_LEDS, CMD_SET_EFFECT, handle_effect_command, &ceiling_group);
+        mqtt.onCommand(DEV_GAUGE_LEDS, CMD_SET_EFFECT, handle_effect_command, &gauge_led_group);
         mqtt.setCommandCallback(handle_mqtt_command);
         mqtt.setHeartbeatBuilder(build_heartbeat_payload);
 
@@ -428,9 +466,9 @@ void setup()
 
             // Register with Sentient system
             Serial.println("[Gauge 6 LEDs] Registering with Sentient system...");
-            if (manifest.publish_registration(mqtt.get_client(), ROOM_ID, CONTROLLER_ID))
+            if (manifest.publish_registration(mqtt, ROOM_ID, CONTROLLER_ID))
             {
-                Serial.println("[Gauge 6 LEDs] Registration successful!");
+                Serial.println("[Gauge 6 LEDs] Registration started");
             }
             else
             {
@@ -447,6 +485,15 @@ void setup()
         }
     }
 
+    // Gauge follows its valve first, then levers, then the large status document
+    tasks.every("gauge_tracking", gauge_tracking_interval_ms, [](void *) { update_gauge_tracking(); }, nullptr, 3);
+    tasks.every("sensors", sensor_scan_interval_ms, [](void *) { monitor_sensors(); }, nullptr, 2);
+    tasks.restart(tasks.every("sensor_refresh", sensor_publish_interval, [](void *) { publish_sensor_changes(true); }, nullptr, 1),
+                  sensor_publish_interval);
+    tasks.restart(tasks.every("status", heartbeat_interval_ms, [](void *) { publish_hardware_status(); }, nullptr, 0),
+                  heartbeat_interval_ms);
+    tasks.reportEvery(mqtt);
+
     Serial.println("════════════════════════════════════════════════════════════");
     Serial.println("Setup complete. Entering main loop...");
     Serial.println("════════════════════════════════════════════════════════════");
@@ -459,18 +506,10 @@ void setup()
 void loop()
 {
     mqtt.loop();
+    manifest.loop();
     stepper_6.run();
-    update_gauge_tracking();
-    monitor_sensors();
-    update_gauge_flicker();
-
-    // Periodic status publish
-    static unsigned long last_status_publish = 0;
-    if (millis() - last_status_publish >= heartbeat_interval_ms)
-    {
-        publish_hardware_status();
-        last_status_publish = millis();
-    }
+    led_effects.service();
+    tasks.run();
 }
 
 // ============================================================================
@@ -508,8 +547,6 @@ void build_capability_manifest()
         firmware::VERSION,
         ROOM_ID,
         CONTROLLER_ID);
-
-    deviceRegistry.buildManifest(manifest);
 }
 
 bool build_heartbeat_payload(JsonDocument &doc, void * /*ctx*/)
@@ -652,10 +689,8 @@ void handle_mqtt_command(const char *command, const JsonDocument &payload, void
     {
         for (int i = 0; i < 7; i++)
         {
-            gauge_flicker[i].enabled = false;
-            gauge_leds[i][0] = CRGB(color_gauge_base);
+            led_effects.fill(gauge_segments[i], CRGB(color_gauge_base));
         }
-        FastLED.show();
         Serial.println(F("[GAUGE LEDS] All ON (base color)"));
         publish_command_acknowledgement(DEV_GAUGE_LEDS, command);
     }
@@ -663,10 +698,8 @@ void handle_mqtt_command(const char *command, const JsonDocument &payload, void
     {
         for (int i = 0; i < 7; i++)
         {
-            gauge_flicker[i].enabled = false;
-            gauge_leds[i][0] = CRGB::Black;
+            led_effects.off(gauge_segments[i]);
         }
-        FastLED.show();
         Serial.println(F("[GAUGE LEDS] All OFF"));
         publish_command_acknowledgement(DEV_GAUGE_LEDS, command);
     }
@@ -686,7 +719,7 @@ void update_gauge_tracking()
     if (!gauges_active)
         return;
 
-    int raw_reading = analogRead(valve_6_pot_pin);
+    int raw_reading = analog_inputs.read(valve_6_channel);
     int target_steps = map(raw_reading, valve_6_zero, valve_6_max, gauge_min_steps, gauge_max_steps);
     target_steps = constrain(target_steps, gauge_min_steps, gauge_max_steps);
 
@@ -700,24 +733,17 @@ void update_gauge_tracking()
 
 void monitor_sensors()
 {
-    unsigned long current_time = millis();
-
-    // Read photoresistors
-    lever_1_red_open = (analogRead(lever_1_red_pin) > photoresistor_threshold);
-    lever_2_blue_open = (analogRead(lever_2_blue_pin) > photoresistor_threshold);
-    lever_3_green_open = (analogRead(lever_3_green_pin) > photoresistor_threshold);
-    lever_4_white_open = (analogRead(lever_4_white_pin) > photoresistor_threshold);
-    lever_5_orange_open = (analogRead(lever_5_orange_pin) > photoresistor_threshold);
-    lever_6_yellow_open = (analogRead(lever_6_yellow_pin) > photoresistor_threshold);
-    lever_7_purple_open = (analogRead(lever_7_purple_pin) > photoresistor_threshold);
-
-    bool force_publish = (current_time - last_sensor_publish_time >= sensor_publish_interval);
-    publish_sensor_changes(force_publish);
-
-    if (force_publish)
-    {
-        last_sensor_publish_time = current_time;
-    }
+    // Read photoresistors (latest filtered scan)
+    lever_1_red_open = (analog_inputs.read(lever_channels[0]) > photoresistor_threshold);
+    lever_2_blue_open = (analog_inputs.read(lever_channels[1]) > photoresistor_threshold);
+    lever_3_green_open = (analog_inputs.read(lever_channels[2]) > photoresistor_threshold);
+    lever_4_white_open = (analog_inputs.read(lever_channels[3]) > photoresistor_threshold);
+    lever_5_orange_open = (analog_inputs.read(lever_channels[4]) > photoresistor_threshold);
+    lever_6_yellow_open = (analog_inputs.read(lever_channels[5]) > photoresistor_threshold);
+    lever_7_purple_open = (analog_inputs.read(lever_channels[6]) > photoresistor_threshold);
+
+    // The sensor_refresh task republishes everything once a minute
+    publish_sensor_changes(false);
 }
 
 void publish_sensor_changes(bool force_publish)
@@ -789,203 +815,140 @@ void publish_sensor_changes(bool force_publish)
     }
 }
 
+// ============================================================================
+// LED EFFECT COMMAND
+// ============================================================================
+
+// set_effect, e.g. {"effect": "chase", "color": "orange", "period_ms": 40}.
+// Gauge LEDs take an optional "gauge" (1-7); without it all seven change.
+void handle_effect_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx)
+{
+    LedGroup &group = *static_cast<LedGroup *>(ctx);
+
+    int first = 0;
+    int last = group.count - 1;
+    if (payload["gauge"].is<int>())
+    {
+        first = last = payload["gauge"].as<int>() - 1;
+    }
+
+    bool ok = first >= 0 && last < group.count;
+    for (int i = first; ok && i <= last; i++)
+    {
+        ok = led_effects.configure(group.segments[i], payload.as<JsonVariantConst>());
+    }
+
+    Serial.print(F("["));
+    Serial.print(group.label);
+    Serial.print(F("] Effect: "));
+    Serial.println(ok ? SentientLedEffects::effectName(led_effects.params(group.segments[first]).effect) : "rejected");
+    publish_command_acknowledgement(cmd.deviceId, cmd.name, ok);
+}
+
 // ============================================================================
 // CEILING LED PATTERNS
 // ============================================================================
 
+// Patterns are drawn by hand: stop any ceiling effect and start from black
+void clear_ceiling()
+{
+    SentientLedEffectParams manual;
+    led_effects.setEffect(ceiling_segment, manual);
+    fill_solid(ceiling_leds, num_ceiling_leds, CRGB::Black);
+    led_effects.markDirty(ceiling_segment);
+}
+
 void set_ceiling_off()
 {
-    FastLED.clear();
-    FastLED.show();
+    led_effects.off(ceiling_segment);
 }
 
 void set_ceiling_pattern_1()
 {
-    FastLED.clear();
+    clear_ceiling();
     fill_solid(&ceiling_leds[section_start[2]], section_length[2], CRGB(color_clock_blue));
     fill_solid(&ceiling_leds[section_start[7]], section_length[7], CRGB(color_clock_green));
-    FastLED.show();
 }
 
 void set_ceiling_pattern_2()
 {
-    FastLED.clear();
+    clear_ceiling();
     fill_solid(&ceiling_leds[section_start[1]], section_length[1], CRGB(color_clock_red));
     fill_solid(&ceiling_leds[section_start[5]], section_length[5], CRGB(color_clock_white));
     fill_solid(&ceiling_leds[section_start[8]], section_length[8], CRGB(color_clock_orange));
-    FastLED.show();
 }
 
 void set_ceiling_pattern_3()
 {
-    FastLED.clear();
+    clear_ceiling();
     fill_solid(&ceiling_leds[section_start[1]], section_length[1], CRGB(color_clock_purple));
     fill_solid(&ceiling_leds[section_start[2]], section_length[2], CRGB(color_clock_blue));
     fill_solid(&ceiling_leds[section_start[5]], section_length[5], CRGB(color_clock_yellow));
     fill_solid(&ceiling_leds[section_start[7]], section_length[7], CRGB(color_clock_green));
-    FastLED.show();
 }
 
 // ============================================================================
 // GAUGE INDICATOR LED FLICKER MODES
 // ============================================================================
 
-void set_flicker_off()
+// Every gauge LED steady on the base colour
+void set_gauge_leds_base()
 {
     for (int i = 0; i < 7; i++)
     {
-        gauge_flicker[i].enabled = false;
-        gauge_leds[i][0] = CRGB::Black;
+        led_effects.fill(gauge_segments[i], CRGB(color_gauge_base));
     }
-    FastLED.show();
 }
 
-void set_flicker_mode_2()
+// Bursts alternate at random between the two colours; dark between bursts
+void set_gauge_flicker(int gauge_index, uint32_t color1, uint32_t color2)
+{
+    SentientLedEffectParams flicker;
+    flicker.effect = SentientLedEffect::Flicker;
+    flicker.color = CRGB(color1);
+    flicker.color2 = CRGB(color2);
+    flicker.background = CRGB::Black;
+    flicker.periodMs = flicker_period_ms;
+    led_effects.setEffect(gauge_segments[gauge_index], flicker);
+}
+
+void set_flicker_off()
 {
-    // Gauges 4 & 6 flicker
     for (int i = 0; i < 7; i++)
     {
-        gauge_flicker[i].enabled = false;
-        gauge_leds[i][0] = CRGB(color_gauge_base);
+        led_effects.off(gauge_segments[i]);
     }
+}
 
-    gauge_flicker[3].enabled = true;
-    gauge_flicker[3].color1 = flicker_blue;
-    gauge_flicker[3].color2 = color_gauge_base;
-    gauge_flicker[3].use_two_colors = true;
-
-    gauge_flicker[5].enabled = true;
-    gauge_flicker[5].color1 = flicker_green;
-    gauge_flicker[5].color2 = color_gauge_base;
-    gauge_flicker[5].use_two_colors = true;
-
-    FastLED.show();
+void set_flicker_mode_2()
+{
+    // Gauges 4 & 6 flicker
+    set_gauge_leds_base();
+    set_gauge_flicker(3, flicker_blue, color_gauge_base);
+    set_gauge_flicker(5, flicker_green, color_gauge_base);
 }
 
 void set_flicker_mode_5()
 {
     // Gauges 1, 2, 3, 7 flicker
-    for (int i = 0; i < 7; i++)
-    {
-        gauge_flicker[i].enabled = false;
-        gauge_leds[i][0] = CRGB(color_gauge_base);
-    }
-
-    gauge_flicker[0].enabled = true;
-    gauge_flicker[0].color1 = flicker_red;
-    gauge_flicker[0].color2 = color_gauge_base;
-    gauge_flicker[0].use_two_colors = true;
-
-    gauge_flicker[1].enabled = true;
-    gauge_flicker[1].color1 = flicker_orange;
-    gauge_flicker[1].color2 = color_gauge_base;
-    gauge_flicker[1].use_two_colors = true;
-
-    gauge_flicker[2].enabled = true;
-    gauge_flicker[2].color1 = flicker_white;
-    gauge_flicker[2].color2 = color_gauge_base;
-    gauge_flicker[2].use_two_colors = true;
-
-    gauge_flicker[6].enabled = true;
-    gauge_flicker[6].color1 = flicker_orange;
-    gauge_flicker[6].color2 = color_gauge_base;
-    gauge_flicker[6].use_two_colors = true;
-
-    FastLED.show();
+    set_gauge_leds_base();
+    set_gauge_flicker(0, flicker_red, color_gauge_base);
+    set_gauge_flicker(1, flicker_orange, color_gauge_base);
+    set_gauge_flicker(2, flicker_white, color_gauge_base);
+    set_gauge_flicker(6, flicker_orange, color_gauge_base);
 }
 
 void set_flicker_mode_8()
 {
     // All 7 gauges flicker
-    for (int i = 0; i < 7; i++)
-    {
-        gauge_flicker[i].enabled = false;
-        gauge_leds[i][0] = CRGB(color_gauge_base);
-    }
-
-    gauge_flicker[0].enabled = true;
-    gauge_flicker[0].color1 = flicker_red;
-    gauge_flicker[0].color2 = color_gauge_base;
-    gauge_flicker[0].use_two_colors = true;
-
-    gauge_flicker[1].enabled = true;
-    gauge_flicker[1].color1 = flicker_orange;
-    gauge_flicker[1].color2 = flicker_purple;
-    gauge_flicker[1].use_two_colors = true;
-
-    gauge_flicker[2].enabled = true;
-    gauge_flicker[2].color1 = flicker_white;
-    gauge_flicker[2].color2 = color_gauge_base;
-    gauge_flicker[2].use_two_colors = true;
-
-    gauge_flicker[3].enabled = true;
-    gauge_flicker[3].color1 = flicker_blue;
-    gauge_flicker[3].color2 = color_gauge_base;
-    gauge_flicker[3].use_two_colors = true;
-
-    gauge_flicker[4].enabled = true;
-    gauge_flicker[4].color1 = flicker_purple;
-    gauge_flicker[4].color2 = color_gauge_base;
-    gauge_flicker[4].use_two_colors = true;
-
-    gauge_flicker[5].enabled = true;
-    gauge_flicker[5].color1 = flicker_orange;
-    gauge_flicker[5].color2 = color_gauge_base;
-    gauge_flicker[5].use_two_colors = true;
-
-    gauge_flicker[6].enabled = true;
-    gauge_flicker[6].color1 = flicker_orange;
-    gauge_flicker[6].color2 = color_gauge_base;
-    gauge_flicker[6].use_two_colors = true;
-
-    FastLED.show();
-}
-
-// ============================================================================
-// FLICKER ANIMATION UPDATE
-// ============================================================================
-
-void update_gauge_flicker()
-{
-    unsigned long now = millis();
-    bool any_active = false;
-
-    for (int i = 0; i < 7; i++)
-    {
-        if (!gauge_flicker[i].enabled)
-            continue;
-
-        FlickerState &fs = gauge_flicker[i];
-
-        if (!fs.active)
-        {
-            if (now >= fs.next_burst_at)
-            {
-                fs.active = true;
-                fs.flicker_end = now + random(50, 250);
-                fs.use_second_color = (fs.use_two_colors && random(2) == 0);
-                fs.next_burst_at = now + random(100, 500);
-            }
-        }
-
-        if (fs.active && now <= fs.flicker_end)
-        {
-            CRGB color = (fs.use_two_colors && fs.use_second_color) ? CRGB(fs.color2) : CRGB(fs.color1);
-            color.nscale8_video(random(256));
-            gauge_leds[i][0] = color;
-            any_active = true;
-        }
-        else if (fs.active && now > fs.flicker_end)
-        {
-            fs.active = false;
-            gauge_leds[i][0] = CRGB::Black;
-        }
-    }
-
-    if (any_active)
-    {
-        FastLED.show();
-    }
+    set_gauge_leds_base();
+    set_gauge_flicker(0, flicker_red, color_gauge_base);
+    set_gauge_flicker(1, flicker_orange, flicker_purple);
+    set_gauge_flicker(2, flicker_white, color_gauge_base);
+    set_gauge_flicker(3, flicker_blue, color_gauge_base);
+    set_gauge_flicker(4, flicker_purple, color_gauge_base);
+    set_gauge_flicker(5, flicker_orange, color_gauge_base);
+    set_gauge_flicker(6, flicker_orange, color_gauge_base);
 }
 
 // ============================================================================
@@ -1058,7 +1021,7 @@ String extract_command_value(const JsonDocument &payload)
 // COMMAND ACKNOWLEDGEMENT
 // ============================================================================
 
-void publish_command_acknowledgement(const char *device_id, const char *command)
+void publish_command_acknowledgement(const char *device_id, const char *command, bool success)
 {
     if (!mqtt.isConnected())
         return;
@@ -1067,7 +1030,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
     ack["controller_id"] = CONTROLLER_ID;
     ack["device_id"] = device_id;
     ack["command"] = command;
-    ack["success"] = true;
+    ack["success"] = success;
     ack["timestamp_ms"] = millis();
 
     char buf[196];
@@ -1078,7 +1041,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
                       String(CAT_ACKNOWLEDGEMENT) + "/" + String(CONTROLLER_ID) + "/" +
                       String(device_id) + "/" + String(command);
 
-    mqtt.get_client().publish(ackTopic.c_str(), buf, false);
+    mqtt.publishTopic(ackTopic.c_str(), buf);
 
     Serial.print(F("[ACK] -> "));
     Serial.println(ackTopic);
@@ -4,9 +4,10 @@
 // ══════════════════════════════════════════════════════════════════════════════
 
 #include <SentientMQTT.h>
-#include <SentientCapabilityManifest.h>
+#include <SentientManifestStream.h>
 #include <SentientDeviceRegistry.h>
 #include <ArduinoJson.h>
+#include <SentientEncoder.h>
 #include "controller_naming.h"
 
 // ══════════════════════════════════════════════════════════════════════════════
@@ -39,54 +40,53 @@ const unsigned long heartbeat_interval_ms = 5000; // 5 seconds
 // STATE MANAGEMENT
 // ══════════════════════════════════════════════════════════════════════════════
 
-// Encoder counters (volatile for interrupt safety)
-volatile long counter_a = 0;
-volatile long counter_b = 0;
-
-// Previous counter values for change detection
-long last_counter_a = 0;
-long last_counter_b = 0;
+// Encoders (white wire = channel A, green wire = channel B)
+SentientEncoder encoder_a;
+SentientEncoder encoder_b;
 
 // ══════════════════════════════════════════════════════════════════════════════
 // SECTION 2: DEVICE REGISTRY (SINGLE SOURCE OF TRUTH!)
 // ══════════════════════════════════════════════════════════════════════════════
 
 // Encoder A sensors
-const char *encoder_a_sensors[] = {
+constexpr const char *encoder_a_sensors[] PROGMEM = {
     naming::SENSOR_ENCODER_A_COUNT};
 
 // Encoder B sensors
-const char *encoder_b_sensors[] = {
+constexpr const char *encoder_b_sensors[] PROGMEM = {
     naming::SENSOR_ENCODER_B_COUNT};
 
 // Controller commands
-const char *controller_commands[] = {
+constexpr const char *controller_commands[] PROGMEM = {
     naming::CMD_LAB,
     naming::CMD_STUDY,
     naming::CMD_BOILER,
     naming::CMD_RESET};
 
 // Device definitions
-SentientDeviceDef dev_encoder_a(
+constexpr SentientDeviceDef dev_encoder_a PROGMEM(
     naming::DEV_ENCODER_A,
     naming::FRIENDLY_ENCODER_A,
     "sensor",
     encoder_a_sensors, 1, true); // input only
 
-SentientDeviceDef dev_encoder_b(
+constexpr SentientDeviceDef dev_encoder_b PROGMEM(
     naming::DEV_ENCODER_B,
     naming::FRIENDLY_ENCODER_B,
     "sensor",
     encoder_b_sensors, 1, true); // input only
 
-SentientDeviceDef dev_controller(
+constexpr SentientDeviceDef dev_controller PROGMEM(
     naming::DEV_CONTROLLER,
     naming::FRIENDLY_CONTROLLER,
     "controller",
     controller_commands, 4);
 
 // Create the device registry
-SentientDeviceRegistry deviceRegistry;
+SENTIENT_DEVICE_REGISTRY(deviceRegistry,
+    &dev_encoder_a,
+    &dev_encoder_b,
+    &dev_controller);
 
 // ══════════════════════════════════════════════════════════════════════════════
 // SECTION 3: SENTIENT MQTT INITIALIZATION
@@ -112,14 +112,12 @@ SentientMQTTConfig make_mqtt_config()
 }
 
 SentientMQTT sentient(make_mqtt_config());
-SentientCapabilityManifest manifest;
+SentientManifestStream manifest(deviceRegistry);
 
 // Forward declarations
 void handle_mqtt_command(const char *command, const JsonDocument &payload, void *ctx);
 void publish_command_acknowledgement(const char *device_id, const char *command);
 void read_encoders();
-void counter_a_isr();
-void counter_b_isr();
 
 // ══════════════════════════════════════════════════════════════════════════════
 // SECTION 4: SETUP
@@ -134,23 +132,16 @@ void setup()
     delay(2000);
     Serial.println(F("[Gear] Starting..."));
 
-    // Setup encoder pins
-    pinMode(PIN_ENCODER_A_WHITE, INPUT_PULLUP);
-    pinMode(PIN_ENCODER_A_GREEN, INPUT_PULLUP);
-    pinMode(PIN_ENCODER_B_WHITE, INPUT_PULLUP);
-    pinMode(PIN_ENCODER_B_GREEN, INPUT_PULLUP);
-
-    // Attach interrupts for encoders
-    attachInterrupt(digitalPinToInterrupt(PIN_ENCODER_A_WHITE), counter_a_white_isr, RISING);
-    attachInterrupt(digitalPinToInterrupt(PIN_ENCODER_A_GREEN), counter_a_green_isr, RISING);
-    attachInterrupt(digitalPinToInterrupt(PIN_ENCODER_B_WHITE), counter_b_white_isr, RISING);
-    attachInterrupt(digitalPinToInterrupt(PIN_ENCODER_B_GREEN), counter_b_green_isr, RISING);
-
-    // Register all devices
-    Serial.println(F("[INIT] Registering devices..."));
-    deviceRegistry.addDevice(&dev_encoder_a);
-    deviceRegistry.addDevice(&dev_encoder_b);
-    deviceRegistry.addDevice(&dev_controller);
+    // Setup encoders: 2 counts per cycle, the same scale as the old rising-edge counting
+    SentientEncoderConfig encoder;
+    encoder.countsPerCycle = 2;
+    encoder.pinA = PIN_ENCODER_A_WHITE;
+    encoder.pinB = PIN_ENCODER_A_GREEN;
+    encoder_a.begin(encoder);
+    encoder.pinA = PIN_ENCODER_B_WHITE;
+    encoder.pinB = PIN_ENCODER_B_GREEN;
+    encoder_b.begin(encoder);
+
     deviceRegistry.printSummary();
 
     // Build capability manifest
@@ -162,7 +153,6 @@ void setup()
         naming::ROOM_ID,
         naming::CONTROLLER_ID);
 
-    deviceRegistry.buildManifest(manifest);
     Serial.println(F("[INIT] Manifest built from device registry"));
 
     // Initialize Sentient MQTT
@@ -186,9 +176,9 @@ void setup()
 
         // Register with Sentient system
         Serial.println(F("[INIT] Registering with Sentient system..."));
-        if (manifest.publish_registration(sentient.get_client(), naming::ROOM_ID, naming::CONTROLLER_ID))
+        if (manifest.publish_registration(sentient, naming::ROOM_ID, naming::CONTROLLER_ID))
         {
-            Serial.println(F("[INIT] Registration successful!"));
+            Serial.println(F("[INIT] Registration started"));
         }
         else
         {
@@ -211,6 +201,7 @@ void loop()
 {
     // 1. LISTEN for commands from Sentient
     sentient.loop();
+    manifest.loop();
 
     // 2. DETECT encoder changes and publish if needed
     read_encoders();
@@ -259,10 +250,8 @@ void handle_mqtt_command(const char *command, const JsonDocument &payload, void
         }
         else if (strcmp(command, naming::CMD_RESET) == 0)
         {
-            counter_a = 0;
-            counter_b = 0;
-            last_counter_a = 0;
-            last_counter_b = 0;
+            encoder_a.setPosition(0);
+            encoder_b.setPosition(0);
             Serial.println(F("[RESET] Encoder counters reset"));
         }
         else
@@ -299,7 +288,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
                       String(naming::CAT_ACKNOWLEDGEMENT) + "/" + String(naming::CONTROLLER_ID) + "/" +
                       String(device_id) + "/" + String(command);
 
-    sentient.get_client().publish(ackTopic.c_str(), buf, false);
+    sentient.publishTopic(ackTopic.c_str(), buf);
 
     Serial.print(F("[ACK] -> "));
     Serial.println(ackTopic);
@@ -311,37 +300,31 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
 
 void read_encoders()
 {
-    static unsigned long last_publish = 0;
-    unsigned long now = millis();
-
-    // Check if encoder values have changed
-    bool changed = false;
-
-    noInterrupts(); // Atomic read of volatile variables
-    long current_a = counter_a;
-    long current_b = counter_b;
-    interrupts();
-
-    if (current_a != last_counter_a || current_b != last_counter_b)
+    encoder_a.loop();
+    encoder_b.loop();
+    if (!sentient.isConnected())
     {
-        changed = true;
-        last_counter_a = current_a;
-        last_counter_b = current_b;
+        return;
     }
 
-    // Publish on change or every 5 seconds
-    if ((changed || (now - last_publish >= 5000)) && sentient.isConnected())
+    // Paced by the encoders: every 50 ms while either turns, once more when
+    // it settles, silent at rest. Both go out together, as before.
+    const bool due_a = encoder_a.publishDue();
+    const bool due_b = encoder_b.publishDue();
+    if (due_a || due_b)
     {
-        last_publish = now;
-
+        const long current_a = encoder_a.position();
+        const long current_b = encoder_b.position();
         JsonDocument doc;
 
         // Publish individual encoder counts
         doc["count"] = current_a;
+        doc["velocity"] = encoder_a.velocity();
         sentient.publishJson(naming::CAT_SENSORS, naming::SENSOR_ENCODER_A_COUNT, doc);
         doc.clear();
 
         doc["count"] = current_b;
+        doc["velocity"] = encoder_b.velocity();
         sentient.publishJson(naming::CAT_SENSORS, naming::SENSOR_ENCODER_B_COUNT, doc);
         doc.clear();
 
@@ -351,68 +334,9 @@ void read_encoders()
         sentient.publishJson(naming::CAT_SENSORS, naming::SENSOR_COUNTERS, doc);
         doc.clear();
 
-        if (changed)
-        {
-            Serial.print(F("[ENCODERS] A: "));
-            Serial.print(current_a);
-            Serial.print(F(", B: "));
-            Serial.println(current_b);
-        }
-    }
-}
-
-// ══════════════════════════════════════════════════════════════════════════════
-// SECTION 8: ENCODER INTERRUPT HANDLERS
-// ══════════════════════════════════════════════════════════════════════════════
-
-// Encoder A - White wire interrupt
-void counter_a_white_isr()
-{
-    if (digitalRead(PIN_ENCODER_A_GREEN) == LOW)
-    {
-        counter_a++;
-    }
-    else
-    {
-        counter_a--;
-    }
-}
-
-// Encoder A - Green wire interrupt
-void counter_a_green_isr()
-{
-    if (digitalRead(PIN_ENCODER_A_WHITE) == LOW)
-    {
-        counter_a--;
-    }
-    else
-    {
-        counter_a++;
-    }
-}
-
-// Encoder B - White wire interrupt
-void counter_b_white_isr()
-{
-    if (digitalRead(PIN_ENCODER_B_GREEN) == LOW)
-    {
-        counter_b++;
-    }
-    else
-    {
-        counter_b--;
-    }
-}
-
-// Encoder B - Green wire interrupt
-void counter_b_green_isr()
-{
-    if (digitalRead(PIN_ENCODER_B_WHITE) == LOW)
-    {
-        counter_b--;
-    }
-    else
-    {
-        counter_b++;
+        Serial.print(F("[ENCODERS] A: "));
+        Serial.print(current_a);
+        Serial.print(F(", B: "));
+        Serial.println(current_b);
     }
 }
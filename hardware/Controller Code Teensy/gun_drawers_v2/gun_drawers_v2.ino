@@ -4,7 +4,7 @@
 // ══════════════════════════════════════════════════════════════════════════════
 
 #include <SentientMQTT.h>
-#include <SentientCapabilityManifest.h>
+#include <SentientManifestStream.h>
 #include <SentientDeviceRegistry.h>
 #include <ArduinoJson.h>
 #include "controller_naming.h"
@@ -37,18 +37,22 @@ const unsigned long heartbeat_interval_ms = 5000; // 5 seconds
 // ══════════════════════════════════════════════════════════════════════════════
 
 // Drawer commands
-const char *drawer_commands[] = {
+constexpr const char *drawer_commands[] PROGMEM = {
     naming::CMD_RELEASE_DRAWER,
     naming::CMD_LOCK_DRAWER};
 
 // Individual drawer devices
-SentientDeviceDef dev_drawer_elegant(naming::DEV_DRAWER_ELEGANT, naming::FRIENDLY_DRAWER_ELEGANT, "electromagnet", drawer_commands, 2);
-SentientDeviceDef dev_drawer_alchemist(naming::DEV_DRAWER_ALCHEMIST, naming::FRIENDLY_DRAWER_ALCHEMIST, "electromagnet", drawer_commands, 2);
-SentientDeviceDef dev_drawer_bounty(naming::DEV_DRAWER_BOUNTY, naming::FRIENDLY_DRAWER_BOUNTY, "electromagnet", drawer_commands, 2);
-SentientDeviceDef dev_drawer_mechanic(naming::DEV_DRAWER_MECHANIC, naming::FRIENDLY_DRAWER_MECHANIC, "electromagnet", drawer_commands, 2);
+constexpr SentientDeviceDef dev_drawer_elegant PROGMEM(naming::DEV_DRAWER_ELEGANT, naming::FRIENDLY_DRAWER_ELEGANT, "electromagnet", drawer_commands, 2);
+constexpr SentientDeviceDef dev_drawer_alchemist PROGMEM(naming::DEV_DRAWER_ALCHEMIST, naming::FRIENDLY_DRAWER_ALCHEMIST, "electromagnet", drawer_commands, 2);
+constexpr SentientDeviceDef dev_drawer_bounty PROGMEM(naming::DEV_DRAWER_BOUNTY, naming::FRIENDLY_DRAWER_BOUNTY, "electromagnet", drawer_commands, 2);
+constexpr SentientDeviceDef dev_drawer_mechanic PROGMEM(naming::DEV_DRAWER_MECHANIC, naming::FRIENDLY_DRAWER_MECHANIC, "electromagnet", drawer_commands, 2);
 
 // Create the device registry
-SentientDeviceRegistry deviceRegistry;
+SENTIENT_DEVICE_REGISTRY(deviceRegistry,
+    &dev_drawer_elegant,
+    &dev_drawer_alchemist,
+    &dev_drawer_bounty,
+    &dev_drawer_mechanic);
 
 // ══════════════════════════════════════════════════════════════════════════════
 // SENTIENT MQTT INITIALIZATION
@@ -74,7 +78,7 @@ SentientMQTTConfig make_mqtt_config()
 }
 
 SentientMQTT sentient(make_mqtt_config());
-SentientCapabilityManifest manifest;
+SentientManifestStream manifest(deviceRegistry);
 
 // Forward declarations
 void handle_mqtt_command(const char *command, const JsonDocument &payload, void *ctx);
@@ -106,12 +110,6 @@ void setup()
 
     Serial.println(F("[INIT] All drawers locked"));
 
-    // Register all devices
-    Serial.println(F("[INIT] Registering devices..."));
-    deviceRegistry.addDevice(&dev_drawer_elegant);
-    deviceRegistry.addDevice(&dev_drawer_alchemist);
-    deviceRegistry.addDevice(&dev_drawer_bounty);
-    deviceRegistry.addDevice(&dev_drawer_mechanic);
     deviceRegistry.printSummary();
 
     // Build capability manifest
@@ -123,7 +121,6 @@ void setup()
         naming::ROOM_ID,
         naming::CONTROLLER_ID);
 
-    deviceRegistry.buildManifest(manifest);
     Serial.println(F("[INIT] Manifest built from device registry"));
 
     // Initialize Sentient MQTT
@@ -147,9 +144,9 @@ void setup()
 
         // Register with Sentient system
         Serial.println(F("[INIT] Registering with Sentient system..."));
-        if (manifest.publish_registration(sentient.get_client(), naming::ROOM_ID, naming::CONTROLLER_ID))
+        if (manifest.publish_registration(sentient, naming::ROOM_ID, naming::CONTROLLER_ID))
         {
-            Serial.println(F("[INIT] Registration successful!"));
+            Serial.println(F("[INIT] Registration started"));
         }
         else
         {
@@ -172,6 +169,7 @@ void loop()
 {
     // LISTEN for commands from Sentient
     sentient.loop();
+    manifest.loop();
 }
 
 // ══════════════════════════════════════════════════════════════════════════════
@@ -289,7 +287,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
                       String(naming::CAT_ACKNOWLEDGEMENT) + "/" + String(naming::CONTROLLER_ID) + "/" +
                       String(device_id) + "/" + String(command);
 
-    sentient.get_client().publish(ackTopic.c_str(), buf, false);
+    sentient.publishTopic(ackTopic.c_str(), buf);
 
     Serial.print(F("[ACK] -> "));
     Serial.println(ackTopic);
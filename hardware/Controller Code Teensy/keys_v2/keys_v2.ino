@@ -9,7 +9,9 @@
  * HARDWARE:
  * - 8x Key switches (4 color pairs: Green, Yellow, Blue, Red)
  * - 4x WS2812B LEDs (one per color box)
- * - Each color has two switches that must be pressed simultaneously
+ * - Each color has two switches that must be pressed simultaneously: both
+ *   held, and their presses (timestamped in the pin interrupt) within
+ *   pair_window_ms of each other
  *
  * STATELESS ARCHITECTURE:
  * - Publishes individual switch states AND pair states on change
@@ -23,8 +25,9 @@
 
 #include <SentientMQTT.h>
 #include <SentientDeviceRegistry.h>
-#include <SentientCapabilityManifest.h>
+#include <SentientManifestStream.h>
 #include <FastLED.h>
+#include <SentientInputEvents.h>
 
 #include "FirmwareMetadata.h"
 #include "controller_naming.h"
@@ -56,6 +59,24 @@ const int pin_blue_bottom = 8;
 const int pin_red_left = 9;
 const int pin_red_bottom = 10;
 
+// Event inputs, registered in this order
+enum KeyInput
+{
+    key_green_bottom,
+    key_green_right,
+    key_yellow_right,
+    key_yellow_top,
+    key_blue_left,
+    key_blue_bottom,
+    key_red_left,
+    key_red_bottom,
+    key_count
+};
+
+SentientInputEvents keys;
+const uint32_t pair_window_ms = 300; // Max gap between the two presses of a pair
+uint32_t key_edge_us[key_count] = {}; // micros() of each key's latest edge
+
 // LEDs
 const int led_pin = 2;
 const int num_leds = 4;
@@ -132,75 +153,79 @@ const unsigned long sensor_publish_interval = 60000; // 60 seconds
 // ============================================================================
 
 // Green key box
-const char *green_box_commands[] = {
+constexpr const char *green_box_commands[] PROGMEM = {
     CMD_GREEN_BOX_LED_ON,
     CMD_GREEN_BOX_LED_OFF,
     CMD_GREEN_BOX_COLOR};
-const char *green_box_sensors[] = {
+constexpr const char *green_box_sensors[] PROGMEM = {
     SENSOR_GREEN_PAIR,
     SENSOR_GREEN_BOTTOM,
     SENSOR_GREEN_RIGHT};
 
 // Yellow key box
-const char *yellow_box_commands[] = {
+constexpr const char *yellow_box_commands[] PROGMEM = {
     CMD_YELLOW_BOX_LED_ON,
     CMD_YELLOW_BOX_LED_OFF,
     CMD_YELLOW_BOX_COLOR};
-const char *yellow_box_sensors[] = {
+constexpr const char *yellow_box_sensors[] PROGMEM = {
     SENSOR_YELLOW_PAIR,
     SENSOR_YELLOW_RIGHT,
     SENSOR_YELLOW_TOP};
 
 // Blue key box
-const char *blue_box_commands[] = {
+constexpr const char *blue_box_commands[] PROGMEM = {
     CMD_BLUE_BOX_LED_ON,
     CMD_BLUE_BOX_LED_OFF,
     CMD_BLUE_BOX_COLOR};
-const char *blue_box_sensors[] = {
+constexpr const char *blue_box_sensors[] PROGMEM = {
     SENSOR_BLUE_PAIR,
     SENSOR_BLUE_LEFT,
     SENSOR_BLUE_BOTTOM};
 
 // Red key box
-const char *red_box_commands[] = {
+constexpr const char *red_box_commands[] PROGMEM = {
     CMD_RED_BOX_LED_ON,
     CMD_RED_BOX_LED_OFF,
     CMD_RED_BOX_COLOR};
-const char *red_box_sensors[] = {
+constexpr const char *red_box_sensors[] PROGMEM = {
     SENSOR_RED_PAIR,
     SENSOR_RED_LEFT,
     SENSOR_RED_BOTTOM};
 
 // Device definitions
-SentientDeviceDef dev_green_box(
+constexpr SentientDeviceDef dev_green_box PROGMEM(
     DEV_GREEN_KEY_BOX,
     FRIENDLY_GREEN_KEY_BOX,
     "key_box",
     green_box_commands, 3,
     green_box_sensors, 3);
 
-SentientDeviceDef dev_yellow_box(
+constexpr SentientDeviceDef dev_yellow_box PROGMEM(
     DEV_YELLOW_KEY_BOX,
     FRIENDLY_YELLOW_KEY_BOX,
     "key_box",
     yellow_box_commands, 3,
     yellow_box_sensors, 3);
 
-SentientDeviceDef dev_blue_box(
+constexpr SentientDeviceDef dev_blue_box PROGMEM(
     DEV_BLUE_KEY_BOX,
     FRIENDLY_BLUE_KEY_BOX,
     "key_box",
     blue_box_commands, 3,
     blue_box_sensors, 3);
 
-SentientDeviceDef dev_red_box(
+constexpr SentientDeviceDef dev_red_box PROGMEM(
     DEV_RED_KEY_BOX,
     FRIENDLY_RED_KEY_BOX,
     "key_box",
     red_box_commands, 3,
     red_box_sensors, 3);
 
-SentientDeviceRegistry deviceRegistry;
+SENTIENT_DEVICE_REGISTRY(deviceRegistry,
+    &dev_green_box,
+    &dev_yellow_box,
+    &dev_blue_box,
+    &dev_red_box);
 
 // ============================================================================
 // FORWARD DECLARATIONS
@@ -220,14 +245,9 @@ String extract_command_value(const JsonDocument &payload);
 // MQTT OBJECTS
 // ============================================================================
 
-SentientCapabilityManifest manifest;
+SentientManifestStream manifest(deviceRegistry);
 SentientMQTT mqtt(build_mqtt_config());
 
-// Registration retry state
-bool registration_sent = false;
-unsigned long last_registration_attempt_ms = 0;
-const unsigned long registration_retry_interval_ms = 10000; // 10 seconds
-
 // ============================================================================
 // SETUP
 // ============================================================================
@@ -259,14 +279,15 @@ void setup()
     digitalWrite(power_led_pin, HIGH);
 
     // Configure switch pins
-    pinMode(pin_green_bottom, INPUT_PULLUP);
-    pinMode(pin_green_right, INPUT_PULLUP);
-    pinMode(pin_yellow_right, INPUT_PULLUP);
-    pinMode(pin_yellow_top, INPUT_PULLUP);
-    pinMode(pin_blue_left, INPUT_PULLUP);
-    pinMode(pin_blue_bottom, INPUT_PULLUP);
-    pinMode(pin_red_left, INPUT_PULLUP);
-    pinMode(pin_red_bottom, INPUT_PULLUP);
+    keys.add(pin_green_bottom);
+    keys.add(pin_green_right);
+    keys.add(pin_yellow_right);
+    keys.add(pin_yellow_top);
+    keys.add(pin_blue_left);
+    keys.add(pin_blue_bottom);
+    keys.add(pin_red_left);
+    keys.add(pin_red_bottom);
+    keys.begin();
 
     // Initialize FastLED
     FastLED.addLeds<WS2812B, led_pin, GRB>(leds, num_leds);
@@ -274,12 +295,6 @@ void setup()
     update_leds();
     Serial.println("[Keys] FastLED initialized (4 LEDs)");
 
-    // Register devices
-    Serial.println("[Keys] Registering devices...");
-    deviceRegistry.addDevice(&dev_green_box);
-    deviceRegistry.addDevice(&dev_yellow_box);
-    deviceRegistry.addDevice(&dev_blue_box);
-    deviceRegistry.addDevice(&dev_red_box);
     deviceRegistry.printSummary();
 
     // Build capability manifest
@@ -308,30 +323,26 @@ void setup()
             delay(100);
         }
 
-        if (mqtt.isConnected())
-        {
-            Serial.println("[Keys] Broker connected!");
-
-            // Register with Sentient system
-            Serial.println("[Keys] Registering with Sentient system...");
-            if (manifest.publish_registration(mqtt.get_client(), ROOM_ID, CONTROLLER_ID))
-            {
-                Serial.println("[Keys] Registration successful!");
-                registration_sent = true;
-            }
-            else
-            {
-                Serial.println("[Keys] Registration failed - will retry later");
-                registration_sent = false;
-                last_registration_attempt_ms = millis();
-            }
+        const bool connected = mqtt.isConnected();
+        Serial.println(connected ? "[Keys] Broker connected!" : "[Keys] Broker connection timeout - continuing offline");
 
-            // Publish initial sensor states
-            publish_sensor_changes(true);
+        // Register with Sentient system. The manifest stream sends once the broker
+        // is connected, retries a failed registration and registers again after
+        // every reconnect.
+        Serial.println("[Keys] Registering with Sentient system...");
+        if (manifest.publish_registration(mqtt, ROOM_ID, CONTROLLER_ID))
+        {
+            Serial.println("[Keys] Registration started");
         }
         else
         {
-            Serial.println("[Keys] Broker connection timeout - continuing offline");
+            Serial.println("[Keys] Registration pending - will retry");
+        }
+
+        if (connected)
+        {
+            // Publish initial sensor states
+            publish_sensor_changes(true);
         }
     }
 
@@ -347,6 +358,8 @@ void setup()
 void loop()
 {
     mqtt.loop();
+    manifest.loop();
+    keys.loop();
     read_switches();
 
     // Check for periodic publish
@@ -359,25 +372,6 @@ void loop()
     {
         last_sensor_publish_time = current_time;
     }
-
-    // Retry capability registration until successful
-    if (mqtt.isConnected() && !registration_sent)
-    {
-        if (last_registration_attempt_ms == 0 || (millis() - last_registration_attempt_ms) >= registration_retry_interval_ms)
-        {
-            Serial.println(F("[Keys] Retrying registration..."));
-            if (manifest.publish_registration(mqtt.get_client(), ROOM_ID, CONTROLLER_ID))
-            {
-                Serial.println(F("[Keys] Registration successful (retry)!"));
-                registration_sent = true;
-            }
-            else
-            {
-                Serial.println(F("[Keys] Registration still failing"));
-            }
-            last_registration_attempt_ms = millis();
-        }
-    }
 }
 
 // ============================================================================
@@ -416,8 +410,6 @@ void build_capability_manifest()
         firmware::VERSION,
         ROOM_ID,
         CONTROLLER_ID);
-
-    deviceRegistry.buildManifest(manifest);
 }
 
 bool build_heartbeat_payload(JsonDocument &doc, void * /*ctx*/)
@@ -628,7 +620,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
                       String(CAT_ACKNOWLEDGEMENT) + "/" + String(CONTROLLER_ID) + "/" +
                       String(device_id) + "/" + String(command);
 
-    mqtt.get_client().publish(ackTopic.c_str(), buf, false);
+    mqtt.publishTopic(ackTopic.c_str(), buf);
 
     Serial.print(F("[ACK] -> "));
     Serial.println(ackTopic);
@@ -640,21 +632,32 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
 
 void read_switches()
 {
-    // Read individual switches (inverted: LOW = active = pressed)
-    green_bottom_state = (digitalRead(pin_green_bottom) == LOW);
-    green_right_state = (digitalRead(pin_green_right) == LOW);
-    yellow_right_state = (digitalRead(pin_yellow_right) == LOW);
-    yellow_top_state = (digitalRead(pin_yellow_top) == LOW);
-    blue_left_state = (digitalRead(pin_blue_left) == LOW);
-    blue_bottom_state = (digitalRead(pin_blue_bottom) == LOW);
-    red_left_state = (digitalRead(pin_red_left) == LOW);
-    red_bottom_state = (digitalRead(pin_red_bottom) == LOW);
-
-    // Calculate pair states (both keys must be pressed simultaneously)
-    green_pair_state = (green_bottom_state && green_right_state);
-    yellow_pair_state = (yellow_right_state && yellow_top_state);
-    blue_pair_state = (blue_left_state && blue_bottom_state);
-    red_pair_state = (red_left_state && red_bottom_state);
+    // Edge times for the publishes; the levels come from the event engine
+    SentientInputEvent event;
+    while (keys.pop(event))
+    {
+        key_edge_us[event.input] = event.micros;
+    }
+
+    green_bottom_state = keys.active(key_green_bottom);
+    green_right_state = keys.active(key_green_right);
+    yellow_right_state = keys.active(key_yellow_right);
+    yellow_top_state = keys.active(key_yellow_top);
+    blue_left_state = keys.active(key_blue_left);
+    blue_bottom_state = keys.active(key_blue_bottom);
+    red_left_state = keys.active(key_red_left);
+    red_bottom_state = keys.active(key_red_bottom);
+
+    // Calculate pair states (both keys held, and pressed simultaneously)
+    const uint32_t window_us = pair_window_ms * 1000;
+    green_pair_state = green_bottom_state && green_right_state &&
+                       keys.pressedTogether(key_green_bottom, key_green_right, window_us);
+    yellow_pair_state = yellow_right_state && yellow_top_state &&
+                        keys.pressedTogether(key_yellow_right, key_yellow_top, window_us);
+    blue_pair_state = blue_left_state && blue_bottom_state &&
+                      keys.pressedTogether(key_blue_left, key_blue_bottom, window_us);
+    red_pair_state = red_left_state && red_bottom_state &&
+                     keys.pressedTogether(key_red_left, key_red_bottom, window_us);
 }
 
 // ============================================================================
@@ -663,9 +666,7 @@ void read_switches()
 
 void publish_sensor_changes(bool force_publish)
 {
-    if (!mqtt.isConnected())
-        return;
-
+    // No connection check: SentientMQTT queues edges while offline and replays them
     JsonDocument doc;
 
     // Publish individual switch states on change
@@ -673,6 +674,7 @@ void publish_sensor_changes(bool force_publish)
     {
         doc.clear();
         doc["state"] = green_bottom_state ? 1 : 0;
+        doc["at_us"] = key_edge_us[key_green_bottom];
         mqtt.publishJson(CAT_SENSORS, (String(DEV_GREEN_KEY_BOX) + "/" + SENSOR_GREEN_BOTTOM).c_str(), doc);
         last_green_bottom = green_bottom_state;
     }
@@ -681,6 +683,7 @@ void publish_sensor_changes(bool force_publish)
     {
         doc.clear();
         doc["state"] = green_right_state ? 1 : 0;
+        doc["at_us"] = key_edge_us[key_green_right];
         mqtt.publishJson(CAT_SENSORS, (String(DEV_GREEN_KEY_BOX) + "/" + SENSOR_GREEN_RIGHT).c_str(), doc);
         last_green_right = green_right_state;
     }
@@ -689,6 +692,7 @@ void publish_sensor_changes(bool force_publish)
     {
         doc.clear();
         doc["state"] = yellow_right_state ? 1 : 0;
+        doc["at_us"] = key_edge_us[key_yellow_right];
         mqtt.publishJson(CAT_SENSORS, (String(DEV_YELLOW_KEY_BOX) + "/" + SENSOR_YELLOW_RIGHT).c_str(), doc);
         last_yellow_right = yellow_right_state;
     }
@@ -697,6 +701,7 @@ void publish_sensor_changes(bool force_publish)
     {
         doc.clear();
         doc["state"] = yellow_top_state ? 1 : 0;
+        doc["at_us"] = key_edge_us[key_yellow_top];
         mqtt.publishJson(CAT_SENSORS, (String(DEV_YELLOW_KEY_BOX) + "/" + SENSOR_YELLOW_TOP).c_str(), doc);
         last_yellow_top = yellow_top_state;
     }
@@ -705,6 +710,7 @@ void publish_sensor_changes(bool force_publish)
     {
         doc.clear();
         doc["state"] = blue_left_state ? 1 : 0;
+        doc["at_us"] = key_edge_us[key_blue_left];
         mqtt.publishJson(CAT_SENSORS, (String(DEV_BLUE_KEY_BOX) + "/" + SENSOR_BLUE_LEFT).c_str(), doc);
         last_blue_left = blue_left_state;
     }
@@ -713,6 +719,7 @@ void publish_sensor_changes(bool force_publish)
     {
         doc.clear();
         doc["state"] = blue_bottom_state ? 1 : 0;
+        doc["at_us"] = key_edge_us[key_blue_bottom];
         mqtt.publishJson(CAT_SENSORS, (String(DEV_BLUE_KEY_BOX) + "/" + SENSOR_BLUE_BOTTOM).c_str(), doc);
         last_blue_bottom = blue_bottom_state;
     }
@@ -721,6 +728,7 @@ void publish_sensor_changes(bool force_publish)
     {
         doc.clear();
         doc["state"] = red_left_state ? 1 : 0;
+        doc["at_us"] = key_edge_us[key_red_left];
         mqtt.publishJson(CAT_SENSORS, (String(DEV_RED_KEY_BOX) + "/" + SENSOR_RED_LEFT).c_str(), doc);
         last_red_left = red_left_state;
     }
@@ -729,6 +737,7 @@ void publish_sensor_changes(bool force_publish)
     {
         doc.clear();
         doc["state"] = red_bottom_state ? 1 : 0;
+        doc["at_us"] = key_edge_us[key_red_bottom];
         mqtt.publishJson(CAT_SENSORS, (String(DEV_RED_KEY_BOX) + "/" + SENSOR_RED_BOTTOM).c_str(), doc);
         last_red_bottom = red_bottom_state;
     }
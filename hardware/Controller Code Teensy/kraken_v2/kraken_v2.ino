@@ -13,6 +13,7 @@
 #include <SentientCapabilityManifest.h>
 #include <SentientDeviceRegistry.h>
 #include <ArduinoJson.h>
+#include <SentientEncoder.h>
 #include "controller_naming.h"
 #include "FirmwareMetadata.h"
 
@@ -39,7 +40,6 @@ SentientMQTTConfig build_mqtt_config()
 
 SentientMQTT sentient(build_mqtt_config());
 SentientCapabilityManifest manifest;
-SentientDeviceRegistry deviceRegistry;
 
 void build_capability_manifest()
 {
@@ -68,9 +68,9 @@ void build_capability_manifest()
 #define WHEELA 8 // White Wire
 #define WHEELB 9 // Green Wire
 
-// This variable will increase or decrease depending on the rotation of encoder
-volatile long x, counterA = 0;
-volatile long y, counterB = 0;
+// Counts up when the green wire leads the white one
+SentientEncoder wheel;
+long wheelCount = 0; // Last paced wheel position, as published
 
 String sensorDetail;
 String direction;
@@ -104,8 +104,6 @@ void setup()
     Serial.println(CONTROLLER_ID);
     Serial.println("════════════════════════════════════════════════\n");
 
-    pinMode(WHEELB, INPUT_PULLUP);
-    pinMode(WHEELA, INPUT_PULLUP);
     pinMode(FWD1, INPUT_PULLUP);
     pinMode(FWD2, INPUT_PULLUP);
     pinMode(FWD3, INPUT_PULLUP);
@@ -116,8 +114,12 @@ void setup()
 
     pinMode(POWERLED, OUTPUT);
 
-    attachInterrupt(WHEELB, CounterA, RISING); // Green Wire
-    attachInterrupt(WHEELA, CounterB, RISING); // White Wire
+    // 2 counts per cycle keeps the scale of the old rising-edge counting
+    SentientEncoderConfig wheelConfig;
+    wheelConfig.pinA = WHEELB; // Green Wire
+    wheelConfig.pinB = WHEELA; // White Wire
+    wheelConfig.countsPerCycle = 2;
+    wheel.begin(wheelConfig);
 
     digitalWrite(POWERLED, HIGH);
 
@@ -152,7 +154,7 @@ void loop()
     if (!registered && sentient.isConnected())
     {
         Serial.println("[Kraken] Registering with Sentient system...");
-        if (manifest.publish_registration(sentient.get_client(), ROOM_ID, CONTROLLER_ID))
+        if (manifest.publish_registration(sentient, ROOM_ID, CONTROLLER_ID))
         {
             Serial.println("[Kraken] Registration successful!");
             registered = true;
@@ -163,7 +165,14 @@ void loop()
         }
     }
 
-    Serial.print(counterA);
+    // Wheel updates go out every 50 ms while it spins and once when it stops
+    wheel.loop();
+    if (wheel.publishDue())
+    {
+        wheelCount = wheel.position();
+    }
+
+    Serial.print(wheel.position());
     Serial.print(":");
     Serial.print(digitalRead(FWD1));
     Serial.print(":");
@@ -210,7 +219,7 @@ void loop()
 
     // Send telemetry with current sensor readings
     char telemetryData[32];
-    sprintf(telemetryData, "%ld:%d", counterA, throttle);
+    sprintf(telemetryData, "%ld:%d", wheelCount, throttle);
 
     // CHANGE DETECTION: Only publish if data has changed and MQTT is connected
     bool dataChanged = (!telemetryInitialized) || (strcmp(telemetryData, lastTelemetry) != 0);
@@ -228,38 +237,14 @@ void loop()
     sentient.loop();
 }
 
-void CounterA()
-{
-    if (digitalRead(WHEELA) == LOW)
-    {
-        counterA++;
-    }
-    else
-    {
-        counterA--;
-    }
-}
-
-void CounterB()
-{
-    if (digitalRead(WHEELB) == LOW)
-    {
-        counterA--;
-    }
-    else
-    {
-        counterA++;
-    }
-}
-
 // ------------------- COMMAND HANDLERS -------------------
 void handleCommand(const char *command, const JsonDocument &payload, void *context)
 {
     if (strcmp(command, "reset_counter") == 0)
     {
         Serial.println("[COMMAND] Reset counter command received");
-        counterA = 0;
-        counterB = 0;
+        wheel.setPosition(0);
+        wheelCount = 0;
         telemetryInitialized = false; // Force telemetry update
         Serial.println("  Wheel counter reset to 0");
         publish_command_acknowledgement(CONTROLLER_ID, command);
@@ -287,7 +272,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
                       String(CAT_ACKNOWLEDGEMENT) + "/" + String(CONTROLLER_ID) + "/" +
                       String(device_id) + "/" + String(command);
 
-    sentient.get_client().publish(ackTopic.c_str(), buf, false);
+    sentient.publishTopic(ackTopic.c_str(), buf);
 
     Serial.print(F("[ACK] -> "));
     Serial.println(ackTopic);
@@ -4,10 +4,10 @@
 // ══════════════════════════════════════════════════════════════════════════════
 
 #include <SentientMQTT.h>
-#include <SentientCapabilityManifest.h>
+#include <SentientManifestStream.h>
 #include <SentientDeviceRegistry.h>
 #include <ArduinoJson.h>
-#include <AccelStepper.h>
+#include <SentientMotionPlanner.h>
 #include "controller_naming.h"
 
 // ══════════════════════════════════════════════════════════════════════════════
@@ -34,8 +34,7 @@ const int PIN_D2_ENABLE = 36;
 const int PIN_CANISTER_CHARGING = 41;
 
 // Stepper motor configuration
-const float STEPPER_SPEED = 400.0;
-const float STEPPER_ACCEL = 200.0;
+const float STEPPER_SPEED = 400.0; // steps/sec, constant speed
 
 // ══════════════════════════════════════════════════════════════════════════════
 // MQTT CONFIGURATION
@@ -52,12 +51,22 @@ const unsigned long heartbeat_interval_ms = 5000;
 // STATE MANAGEMENT
 // ══════════════════════════════════════════════════════════════════════════════
 
+// Door steppers: coils switched from the SentientMotion timer ISR. Each door
+// is one motion group, so paired motors step in lockstep.
+SentientMotionPlanner door_motors;
+
+enum DoorGroup : uint8_t
+{
+    GROUP_DOOR_1,
+    GROUP_DOOR_2
+};
+
 // Door 1 steppers (pins: Pul+, Pul-, Dir+, Dir-)
-AccelStepper d1_stepper_one(AccelStepper::FULL4WIRE, 24, 25, 26, 27);
-AccelStepper d1_stepper_two(AccelStepper::FULL4WIRE, 28, 29, 30, 31);
+const uint8_t D1_STEPPER_ONE_PINS[4] = {24, 25, 26, 27};
+const uint8_t D1_STEPPER_TWO_PINS[4] = {28, 29, 30, 31};
 
 // Door 2 stepper
-AccelStepper d2_stepper_one(AccelStepper::FULL4WIRE, 4, 5, 6, 7);
+const uint8_t D2_STEPPER_ONE_PINS[4] = {4, 5, 6, 7};
 
 enum DoorDirection
 {
@@ -83,15 +92,18 @@ int d2_closed_b_last = -1;
 // DEVICE REGISTRY
 // ══════════════════════════════════════════════════════════════════════════════
 
-const char *door_commands[] = {naming::CMD_DOOR_OPEN, naming::CMD_DOOR_CLOSE, naming::CMD_DOOR_STOP};
-const char *door_sensors[] = {naming::SENSOR_OPEN_A, naming::SENSOR_OPEN_B, naming::SENSOR_CLOSED_A, naming::SENSOR_CLOSED_B};
-const char *charging_commands[] = {naming::CMD_CHARGING_ON, naming::CMD_CHARGING_OFF};
+constexpr const char *door_commands[] PROGMEM = {naming::CMD_DOOR_OPEN, naming::CMD_DOOR_CLOSE, naming::CMD_DOOR_STOP};
+constexpr const char *door_sensors[] PROGMEM = {naming::SENSOR_OPEN_A, naming::SENSOR_OPEN_B, naming::SENSOR_CLOSED_A, naming::SENSOR_CLOSED_B};
+constexpr const char *charging_commands[] PROGMEM = {naming::CMD_CHARGING_ON, naming::CMD_CHARGING_OFF};
 
-SentientDeviceDef dev_door_one(naming::DEV_DOOR_ONE, "Door One", "stepper_door", door_commands, 3, door_sensors, 4);
-SentientDeviceDef dev_door_two(naming::DEV_DOOR_TWO, "Door Two", "stepper_door", door_commands, 3, door_sensors, 4);
-SentientDeviceDef dev_canister_charging(naming::DEV_CANISTER_CHARGING, "Canister Charging", "digital_output", charging_commands, 2);
+constexpr SentientDeviceDef dev_door_one PROGMEM(naming::DEV_DOOR_ONE, "Door One", "stepper_door", door_commands, 3, door_sensors, 4);
+constexpr SentientDeviceDef dev_door_two PROGMEM(naming::DEV_DOOR_TWO, "Door Two", "stepper_door", door_commands, 3, door_sensors, 4);
+constexpr SentientDeviceDef dev_canister_charging PROGMEM(naming::DEV_CANISTER_CHARGING, "Canister Charging", "digital_output", charging_commands, 2);
 
-SentientDeviceRegistry deviceRegistry;
+SENTIENT_DEVICE_REGISTRY(deviceRegistry,
+    &dev_door_one,
+    &dev_door_two,
+    &dev_canister_charging);
 
 // ══════════════════════════════════════════════════════════════════════════════
 // SENTIENT MQTT INITIALIZATION
@@ -117,7 +129,7 @@ SentientMQTTConfig make_mqtt_config()
 }
 
 SentientMQTT sentient(make_mqtt_config());
-SentientCapabilityManifest manifest;
+SentientManifestStream manifest(deviceRegistry);
 
 void handle_mqtt_command(const char *command, const JsonDocument &payload, void *ctx);
 void publish_command_acknowledgement(const char *device_id, const char *command);
@@ -126,6 +138,26 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
 // DOOR CONTROL FUNCTIONS
 // ══════════════════════════════════════════════════════════════════════════════
 
+void run_door(uint8_t group, DoorDirection dir)
+{
+    const int8_t travel = dir == OPENING ? 1 : -1;
+    const int8_t directions[2] = {travel, travel}; // Paired motors turn the same way
+    door_motors.run(group, directions, STEPPER_SPEED);
+}
+
+void add_door_stepper(uint8_t group, const uint8_t *pins)
+{
+    SentientAxisConfig axis;
+    axis.group = group;
+    axis.driver = SentientStepperDriver::FourWire;
+    for (int i = 0; i < 4; i++)
+    {
+        axis.coilPins[i] = pins[i];
+    }
+    axis.coilSequence = SENTIENT_COILS_FULL_STEP; // Same coil order as AccelStepper FULL4WIRE
+    door_motors.addAxis(axis);
+}
+
 void set_door_direction(int door_num, DoorDirection dir)
 {
     if (door_num == 1)
@@ -133,13 +165,13 @@ void set_door_direction(int door_num, DoorDirection dir)
         d1_direction = dir;
         if (dir == STOPPED)
         {
-            d1_stepper_one.stop();
-            d1_stepper_two.stop();
+            door_motors.stop(GROUP_DOOR_1);
             digitalWrite(PIN_D1_ENABLE, LOW);
         }
         else
         {
             digitalWrite(PIN_D1_ENABLE, HIGH);
+            run_door(GROUP_DOOR_1, dir);
         }
     }
     else if (door_num == 2)
@@ -147,47 +179,17 @@ void set_door_direction(int door_num, DoorDirection dir)
         d2_direction = dir;
         if (dir == STOPPED)
         {
-            d2_stepper_one.stop();
+            door_motors.stop(GROUP_DOOR_2);
             digitalWrite(PIN_D2_ENABLE, LOW);
         }
         else
         {
             digitalWrite(PIN_D2_ENABLE, HIGH);
+            run_door(GROUP_DOOR_2, dir);
         }
     }
 }
 
-void update_door_motors()
-{
-    // Door 1
-    if (d1_direction == OPENING)
-    {
-        d1_stepper_one.setSpeed(STEPPER_SPEED);
-        d1_stepper_two.setSpeed(STEPPER_SPEED);
-        d1_stepper_one.runSpeed();
-        d1_stepper_two.runSpeed();
-    }
-    else if (d1_direction == CLOSING)
-    {
-        d1_stepper_one.setSpeed(-STEPPER_SPEED);
-        d1_stepper_two.setSpeed(-STEPPER_SPEED);
-        d1_stepper_one.runSpeed();
-        d1_stepper_two.runSpeed();
-    }
-
-    // Door 2
-    if (d2_direction == OPENING)
-    {
-        d2_stepper_one.setSpeed(STEPPER_SPEED);
-        d2_stepper_one.runSpeed();
-    }
-    else if (d2_direction == CLOSING)
-    {
-        d2_stepper_one.setSpeed(-STEPPER_SPEED);
-        d2_stepper_one.runSpeed();
-    }
-}
-
 // ══════════════════════════════════════════════════════════════════════════════
 // SENSOR MONITORING
 // ══════════════════════════════════════════════════════════════════════════════
@@ -293,25 +295,24 @@ void setup()
     digitalWrite(PIN_CANISTER_CHARGING, LOW);
 
     // Configure steppers
-    d1_stepper_one.setMaxSpeed(STEPPER_SPEED);
-    d1_stepper_one.setAcceleration(STEPPER_ACCEL);
-    d1_stepper_two.setMaxSpeed(STEPPER_SPEED);
-    d1_stepper_two.setAcceleration(STEPPER_ACCEL);
-    d2_stepper_one.setMaxSpeed(STEPPER_SPEED);
-    d2_stepper_one.setAcceleration(STEPPER_ACCEL);
+    add_door_stepper(GROUP_DOOR_1, D1_STEPPER_ONE_PINS);
+    add_door_stepper(GROUP_DOOR_1, D1_STEPPER_TWO_PINS);
+    add_door_stepper(GROUP_DOOR_2, D2_STEPPER_ONE_PINS);
+
+    SentientMotionConfig motion;
+    motion.startRate = STEPPER_SPEED;
+    motion.maxRate = STEPPER_SPEED;
+    door_motors.configureGroup(GROUP_DOOR_1, motion);
+    door_motors.configureGroup(GROUP_DOOR_2, motion);
 
     Serial.begin(115200);
     delay(2000);
     Serial.println(F("[Lab Cage A] Starting..."));
 
-    deviceRegistry.addDevice(&dev_door_one);
-    deviceRegistry.addDevice(&dev_door_two);
-    deviceRegistry.addDevice(&dev_canister_charging);
     deviceRegistry.printSummary();
 
     manifest.set_controller_info(naming::CONTROLLER_ID, naming::CONTROLLER_FRIENDLY_NAME,
                                  firmware::VERSION, naming::ROOM_ID, naming::CONTROLLER_ID);
-    deviceRegistry.buildManifest(manifest);
 
     sentient.begin();
     sentient.setCommandCallback(handle_mqtt_command);
@@ -325,7 +326,7 @@ void setup()
 
     if (sentient.isConnected())
     {
-        manifest.publish_registration(sentient.get_client(), naming::ROOM_ID, naming::CONTROLLER_ID);
+        manifest.publish_registration(sentient, naming::ROOM_ID, naming::CONTROLLER_ID);
     }
 
     Serial.println(F("[Lab Cage A] Ready"));
@@ -338,7 +339,8 @@ void setup()
 void loop()
 {
     sentient.loop();
-    update_door_motors();
+    manifest.loop();
+    door_motors.loop();
     monitor_sensors();
 }
 
@@ -451,7 +453,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
                       String(naming::CAT_ACKNOWLEDGEMENT) + "/" + String(naming::CONTROLLER_ID) + "/" +
                       String(device_id) + "/" + String(command);
 
-    sentient.get_client().publish(ackTopic.c_str(), buf, false);
+    sentient.publishTopic(ackTopic.c_str(), buf);
 
     Serial.print(F("[ACK] -> "));
     Serial.println(ackTopic);
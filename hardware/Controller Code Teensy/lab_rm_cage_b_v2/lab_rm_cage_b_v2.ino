@@ -4,10 +4,10 @@
 // ══════════════════════════════════════════════════════════════════════════════
 
 #include <SentientMQTT.h>
-#include <SentientCapabilityManifest.h>
+#include <SentientManifestStream.h>
 #include <SentientDeviceRegistry.h>
 #include <ArduinoJson.h>
-#include <AccelStepper.h>
+#include <SentientMotionPlanner.h>
 #include "controller_naming.h"
 
 // ══════════════════════════════════════════════════════════════════════════════
@@ -38,8 +38,7 @@ const int PIN_D5_CLOSED_B = 23;
 const int PIN_D5_ENABLE = 36; // Shared with D4
 
 // Stepper motor configuration
-const float STEPPER_SPEED = 400.0;
-const float STEPPER_ACCEL = 200.0;
+const float STEPPER_SPEED = 400.0; // steps/sec, constant speed
 
 // ══════════════════════════════════════════════════════════════════════════════
 // MQTT CONFIGURATION
@@ -56,16 +55,27 @@ const unsigned long heartbeat_interval_ms = 5000;
 // STATE MANAGEMENT
 // ══════════════════════════════════════════════════════════════════════════════
 
+// Door steppers: coils switched from the SentientMotion timer ISR. Each door
+// is one motion group, so paired motors step in lockstep.
+SentientMotionPlanner door_motors;
+
+enum DoorGroup : uint8_t
+{
+    GROUP_DOOR_3,
+    GROUP_DOOR_4,
+    GROUP_DOOR_5
+};
+
 // Door 3 steppers (2 motors)
-AccelStepper d3_stepper_one(AccelStepper::FULL4WIRE, 24, 25, 26, 27);
-AccelStepper d3_stepper_two(AccelStepper::FULL4WIRE, 28, 29, 30, 31);
+const uint8_t D3_STEPPER_ONE_PINS[4] = {24, 25, 26, 27};
+const uint8_t D3_STEPPER_TWO_PINS[4] = {28, 29, 30, 31};
 
 // Door 4 stepper (1 motor)
-AccelStepper d4_stepper_one(AccelStepper::FULL4WIRE, 4, 5, 6, 7);
+const uint8_t D4_STEPPER_ONE_PINS[4] = {4, 5, 6, 7};
 
 // Door 5 steppers (2 motors)
-AccelStepper d5_stepper_one(AccelStepper::FULL4WIRE, 16, 17, 18, 19);
-AccelStepper d5_stepper_two(AccelStepper::FULL4WIRE, 38, 39, 40, 41);
+const uint8_t D5_STEPPER_ONE_PINS[4] = {16, 17, 18, 19};
+const uint8_t D5_STEPPER_TWO_PINS[4] = {38, 39, 40, 41};
 
 enum DoorDirection
 {
@@ -87,14 +97,17 @@ int d5_open_a_last = -1, d5_open_b_last = -1, d5_closed_a_last = -1, d5_closed_b
 // DEVICE REGISTRY
 // ══════════════════════════════════════════════════════════════════════════════
 
-const char *door_commands[] = {naming::CMD_DOOR_OPEN, naming::CMD_DOOR_CLOSE, naming::CMD_DOOR_STOP};
-const char *door_sensors[] = {naming::SENSOR_OPEN_A, naming::SENSOR_OPEN_B, naming::SENSOR_CLOSED_A, naming::SENSOR_CLOSED_B};
+constexpr const char *door_commands[] PROGMEM = {naming::CMD_DOOR_OPEN, naming::CMD_DOOR_CLOSE, naming::CMD_DOOR_STOP};
+constexpr const char *door_sensors[] PROGMEM = {naming::SENSOR_OPEN_A, naming::SENSOR_OPEN_B, naming::SENSOR_CLOSED_A, naming::SENSOR_CLOSED_B};
 
-SentientDeviceDef dev_door_three(naming::DEV_DOOR_THREE, "Door Three", "stepper_door", door_commands, 3, door_sensors, 4);
-SentientDeviceDef dev_door_four(naming::DEV_DOOR_FOUR, "Door Four", "stepper_door", door_commands, 3, door_sensors, 4);
-SentientDeviceDef dev_door_five(naming::DEV_DOOR_FIVE, "Door Five", "stepper_door", door_commands, 3, door_sensors, 4);
+constexpr SentientDeviceDef dev_door_three PROGMEM(naming::DEV_DOOR_THREE, "Door Three", "stepper_door", door_commands, 3, door_sensors, 4);
+constexpr SentientDeviceDef dev_door_four PROGMEM(naming::DEV_DOOR_FOUR, "Door Four", "stepper_door", door_commands, 3, door_sensors, 4);
+constexpr SentientDeviceDef dev_door_five PROGMEM(naming::DEV_DOOR_FIVE, "Door Five", "stepper_door", door_commands, 3, door_sensors, 4);
 
-SentientDeviceRegistry deviceRegistry;
+SENTIENT_DEVICE_REGISTRY(deviceRegistry,
+    &dev_door_three,
+    &dev_door_four,
+    &dev_door_five);
 
 // ══════════════════════════════════════════════════════════════════════════════
 // SENTIENT MQTT INITIALIZATION
@@ -120,7 +133,7 @@ SentientMQTTConfig make_mqtt_config()
 }
 
 SentientMQTT sentient(make_mqtt_config());
-SentientCapabilityManifest manifest;
+SentientManifestStream manifest(deviceRegistry);
 
 void handle_mqtt_command(const char *command, const JsonDocument &payload, void *ctx);
 void publish_command_acknowledgement(const char *device_id, const char *command);
@@ -129,6 +142,26 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
 // DOOR CONTROL FUNCTIONS
 // ══════════════════════════════════════════════════════════════════════════════
 
+void run_door(uint8_t group, DoorDirection dir)
+{
+    const int8_t travel = dir == OPENING ? 1 : -1;
+    const int8_t directions[2] = {travel, travel}; // Paired motors turn the same way
+    door_motors.run(group, directions, STEPPER_SPEED);
+}
+
+void add_door_stepper(uint8_t group, const uint8_t *pins)
+{
+    SentientAxisConfig axis;
+    axis.group = group;
+    axis.driver = SentientStepperDriver::FourWire;
+    for (int i = 0; i < 4; i++)
+    {
+        axis.coilPins[i] = pins[i];
+    }
+    axis.coilSequence = SENTIENT_COILS_FULL_STEP; // Same coil order as AccelStepper FULL4WIRE
+    door_motors.addAxis(axis);
+}
+
 void set_door_direction(int door_num, DoorDirection dir)
 {
     if (door_num == 3)
@@ -136,13 +169,13 @@ void set_door_direction(int door_num, DoorDirection dir)
         d3_direction = dir;
         if (dir == STOPPED)
         {
-            d3_stepper_one.stop();
-            d3_stepper_two.stop();
+            door_motors.stop(GROUP_DOOR_3);
             digitalWrite(PIN_D3_ENABLE, LOW);
         }
         else
         {
             digitalWrite(PIN_D3_ENABLE, HIGH);
+            run_door(GROUP_DOOR_3, dir);
         }
     }
     else if (door_num == 4)
@@ -150,12 +183,13 @@ void set_door_direction(int door_num, DoorDirection dir)
         d4_direction = dir;
         if (dir == STOPPED)
         {
-            d4_stepper_one.stop();
+            door_motors.stop(GROUP_DOOR_4);
             digitalWrite(PIN_D4_ENABLE, LOW);
         }
         else
         {
             digitalWrite(PIN_D4_ENABLE, HIGH);
+            run_door(GROUP_DOOR_4, dir);
         }
     }
     else if (door_num == 5)
@@ -163,8 +197,7 @@ void set_door_direction(int door_num, DoorDirection dir)
         d5_direction = dir;
         if (dir == STOPPED)
         {
-            d5_stepper_one.stop();
-            d5_stepper_two.stop();
+            door_motors.stop(GROUP_DOOR_5);
             // D5 shares enable with D4 - only disable if both stopped
             if (d4_direction == STOPPED)
             {
@@ -174,57 +207,11 @@ void set_door_direction(int door_num, DoorDirection dir)
         else
         {
             digitalWrite(PIN_D5_ENABLE, HIGH);
+            run_door(GROUP_DOOR_5, dir);
         }
     }
 }
 
-void update_door_motors()
-{
-    // Door 3 (2 motors)
-    if (d3_direction == OPENING)
-    {
-        d3_stepper_one.setSpeed(STEPPER_SPEED);
-        d3_stepper_two.setSpeed(STEPPER_SPEED);
-        d3_stepper_one.runSpeed();
-        d3_stepper_two.runSpeed();
-    }
-    else if (d3_direction == CLOSING)
-    {
-        d3_stepper_one.setSpeed(-STEPPER_SPEED);
-        d3_stepper_two.setSpeed(-STEPPER_SPEED);
-        d3_stepper_one.runSpeed();
-        d3_stepper_two.runSpeed();
-    }
-
-    // Door 4 (1 motor)
-    if (d4_direction == OPENING)
-    {
-        d4_stepper_one.setSpeed(STEPPER_SPEED);
-        d4_stepper_one.runSpeed();
-    }
-    else if (d4_direction == CLOSING)
-    {
-        d4_stepper_one.setSpeed(-STEPPER_SPEED);
-        d4_stepper_one.runSpeed();
-    }
-
-    // Door 5 (2 motors)
-    if (d5_direction == OPENING)
-    {
-        d5_stepper_one.setSpeed(STEPPER_SPEED);
-        d5_stepper_two.setSpeed(STEPPER_SPEED);
-        d5_stepper_one.runSpeed();
-        d5_stepper_two.runSpeed();
-    }
-    else if (d5_direction == CLOSING)
-    {
-        d5_stepper_one.setSpeed(-STEPPER_SPEED);
-        d5_stepper_two.setSpeed(-STEPPER_SPEED);
-        d5_stepper_one.runSpeed();
-        d5_stepper_two.runSpeed();
-    }
-}
-
 // ══════════════════════════════════════════════════════════════════════════════
 // SENSOR MONITORING
 // ══════════════════════════════════════════════════════════════════════════════
@@ -351,29 +338,27 @@ void setup()
     // D5 shares enable with D4
 
     // Configure steppers
-    d3_stepper_one.setMaxSpeed(STEPPER_SPEED);
-    d3_stepper_one.setAcceleration(STEPPER_ACCEL);
-    d3_stepper_two.setMaxSpeed(STEPPER_SPEED);
-    d3_stepper_two.setAcceleration(STEPPER_ACCEL);
-    d4_stepper_one.setMaxSpeed(STEPPER_SPEED);
-    d4_stepper_one.setAcceleration(STEPPER_ACCEL);
-    d5_stepper_one.setMaxSpeed(STEPPER_SPEED);
-    d5_stepper_one.setAcceleration(STEPPER_ACCEL);
-    d5_stepper_two.setMaxSpeed(STEPPER_SPEED);
-    d5_stepper_two.setAcceleration(STEPPER_ACCEL);
+    add_door_stepper(GROUP_DOOR_3, D3_STEPPER_ONE_PINS);
+    add_door_stepper(GROUP_DOOR_3, D3_STEPPER_TWO_PINS);
+    add_door_stepper(GROUP_DOOR_4, D4_STEPPER_ONE_PINS);
+    add_door_stepper(GROUP_DOOR_5, D5_STEPPER_ONE_PINS);
+    add_door_stepper(GROUP_DOOR_5, D5_STEPPER_TWO_PINS);
+
+    SentientMotionConfig motion;
+    motion.startRate = STEPPER_SPEED;
+    motion.maxRate = STEPPER_SPEED;
+    door_motors.configureGroup(GROUP_DOOR_3, motion);
+    door_motors.configureGroup(GROUP_DOOR_4, motion);
+    door_motors.configureGroup(GROUP_DOOR_5, motion);
 
     Serial.begin(115200);
     delay(2000);
     Serial.println(F("[Lab Cage B] Starting..."));
 
-    deviceRegistry.addDevice(&dev_door_three);
-    deviceRegistry.addDevice(&dev_door_four);
-    deviceRegistry.addDevice(&dev_door_five);
     deviceRegistry.printSummary();
 
     manifest.set_controller_info(naming::CONTROLLER_ID, naming::CONTROLLER_FRIENDLY_NAME,
                                  firmware::VERSION, naming::ROOM_ID, naming::CONTROLLER_ID);
-    deviceRegistry.buildManifest(manifest);
 
     sentient.begin();
     sentient.setCommandCallback(handle_mqtt_command);
@@ -387,7 +372,7 @@ void setup()
 
     if (sentient.isConnected())
     {
-        manifest.publish_registration(sentient.get_client(), naming::ROOM_ID, naming::CONTROLLER_ID);
+        manifest.publish_registration(sentient, naming::ROOM_ID, naming::CONTROLLER_ID);
     }
 
     Serial.println(F("[Lab Cage B] Ready"));
@@ -400,7 +385,8 @@ void setup()
 void loop()
 {
     sentient.loop();
-    update_door_motors();
+    manifest.loop();
+    door_motors.loop();
     monitor_sensors();
 }
 
@@ -518,7 +504,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
                       String(naming::CAT_ACKNOWLEDGEMENT) + "/" + String(naming::CONTROLLER_ID) + "/" +
                       String(device_id) + "/" + String(command);
 
-    sentient.get_client().publish(ackTopic.c_str(), buf, false);
+    sentient.publishTopic(ackTopic.c_str(), buf);
 
     Serial.print(F("[ACK] -> "));
     Serial.println(ackTopic);
@@ -5,7 +5,7 @@
 
 #define SUPPRESS_ERROR_MESSAGE_FOR_BEGIN // IRremote library compatibility
 #include <SentientMQTT.h>
-#include <SentientCapabilityManifest.h>
+#include <SentientManifestStream.h>
 #include <SentientDeviceRegistry.h>
 #include <ArduinoJson.h>
 #include <AccelStepper.h>
@@ -100,22 +100,27 @@ int right_open_a_last = -1, right_open_b_last = -1, right_closed_a_last = -1, ri
 // DEVICE REGISTRY
 // ══════════════════════════════════════════════════════════════════════════════
 
-const char *hoist_commands[] = {naming::CMD_UP, naming::CMD_DOWN, naming::CMD_STOP};
-const char *hoist_sensors[] = {naming::SENSOR_UP_A, naming::SENSOR_UP_B, naming::SENSOR_DOWN_A, naming::SENSOR_DOWN_B};
+constexpr const char *hoist_commands[] PROGMEM = {naming::CMD_UP, naming::CMD_DOWN, naming::CMD_STOP};
+constexpr const char *hoist_sensors[] PROGMEM = {naming::SENSOR_UP_A, naming::SENSOR_UP_B, naming::SENSOR_DOWN_A, naming::SENSOR_DOWN_B};
 
-const char *door_commands[] = {naming::CMD_DOOR_OPEN, naming::CMD_DOOR_CLOSE, naming::CMD_DOOR_STOP};
-const char *door_sensors[] = {naming::SENSOR_OPEN_A, naming::SENSOR_OPEN_B, naming::SENSOR_CLOSED_A, naming::SENSOR_CLOSED_B};
+constexpr const char *door_commands[] PROGMEM = {naming::CMD_DOOR_OPEN, naming::CMD_DOOR_CLOSE, naming::CMD_DOOR_STOP};
+constexpr const char *door_sensors[] PROGMEM = {naming::SENSOR_OPEN_A, naming::SENSOR_OPEN_B, naming::SENSOR_CLOSED_A, naming::SENSOR_CLOSED_B};
 
-const char *rope_commands[] = {naming::CMD_DROP, naming::CMD_RESET};
-const char *ir_sensors[] = {naming::SENSOR_IR_CODE};
+constexpr const char *rope_commands[] PROGMEM = {naming::CMD_DROP, naming::CMD_RESET};
+constexpr const char *ir_sensors[] PROGMEM = {naming::SENSOR_IR_CODE};
 
-SentientDeviceDef dev_hoist(naming::DEV_HOIST, "Hoist", "stepper_hoist", hoist_commands, 3, hoist_sensors, 4);
-SentientDeviceDef dev_left_door(naming::DEV_LAB_DOOR_LEFT, "Left Lab Door", "stepper_door", door_commands, 3, door_sensors, 4);
-SentientDeviceDef dev_right_door(naming::DEV_LAB_DOOR_RIGHT, "Right Lab Door", "stepper_door", door_commands, 3, door_sensors, 4);
-SentientDeviceDef dev_rope_drop(naming::DEV_ROPE_DROP, "Rope Drop", "solenoid", rope_commands, 2);
-SentientDeviceDef dev_ir_receiver(naming::DEV_IR_RECEIVER, "Gun IR Receiver", "ir_receiver", nullptr, 0, ir_sensors, 1);
+constexpr SentientDeviceDef dev_hoist PROGMEM(naming::DEV_HOIST, "Hoist", "stepper_hoist", hoist_commands, 3, hoist_sensors, 4);
+constexpr SentientDeviceDef dev_left_door PROGMEM(naming::DEV_LAB_DOOR_LEFT, "Left Lab Door", "stepper_door", door_commands, 3, door_sensors, 4);
+constexpr SentientDeviceDef dev_right_door PROGMEM(naming::DEV_LAB_DOOR_RIGHT, "Right Lab Door", "stepper_door", door_commands, 3, door_sensors, 4);
+constexpr SentientDeviceDef dev_rope_drop PROGMEM(naming::DEV_ROPE_DROP, "Rope Drop", "solenoid", rope_commands, 2);
+constexpr SentientDeviceDef dev_ir_receiver PROGMEM(naming::DEV_IR_RECEIVER, "Gun IR Receiver", "ir_receiver", nullptr, 0, ir_sensors, 1);
 
-SentientDeviceRegistry deviceRegistry;
+SENTIENT_DEVICE_REGISTRY(deviceRegistry,
+    &dev_hoist,
+    &dev_left_door,
+    &dev_right_door,
+    &dev_rope_drop,
+    &dev_ir_receiver);
 
 // ══════════════════════════════════════════════════════════════════════════════
 // SENTIENT MQTT INITIALIZATION
@@ -141,7 +146,7 @@ SentientMQTTConfig make_mqtt_config()
 }
 
 SentientMQTT sentient(make_mqtt_config());
-SentientCapabilityManifest manifest;
+SentientManifestStream manifest(deviceRegistry);
 
 void handle_mqtt_command(const char *command, const JsonDocument &payload, void *ctx);
 void publish_command_acknowledgement(const char *device_id, const char *command);
@@ -414,16 +419,10 @@ void setup()
     delay(2000);
     Serial.println(F("[Lab Doors & Hoist] Starting..."));
 
-    deviceRegistry.addDevice(&dev_hoist);
-    deviceRegistry.addDevice(&dev_left_door);
-    deviceRegistry.addDevice(&dev_right_door);
-    deviceRegistry.addDevice(&dev_rope_drop);
-    deviceRegistry.addDevice(&dev_ir_receiver);
     deviceRegistry.printSummary();
 
     manifest.set_controller_info(naming::CONTROLLER_ID, naming::CONTROLLER_FRIENDLY_NAME,
                                  firmware::VERSION, naming::ROOM_ID, naming::CONTROLLER_ID);
-    deviceRegistry.buildManifest(manifest);
 
     sentient.begin();
     sentient.setCommandCallback(handle_mqtt_command);
@@ -437,7 +436,7 @@ void setup()
 
     if (sentient.isConnected())
     {
-        manifest.publish_registration(sentient.get_client(), naming::ROOM_ID, naming::CONTROLLER_ID);
+        manifest.publish_registration(sentient, naming::ROOM_ID, naming::CONTROLLER_ID);
     }
 
     Serial.println(F("[Lab Doors & Hoist] Ready"));
@@ -450,6 +449,7 @@ void setup()
 void loop()
 {
     sentient.loop();
+    manifest.loop();
     update_motors();
     monitor_sensors();
     check_ir_receiver();
@@ -590,7 +590,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
                       String(naming::CAT_ACKNOWLEDGEMENT) + "/" + String(naming::CONTROLLER_ID) + "/" +
                       String(device_id) + "/" + String(command);
 
-    sentient.get_client().publish(ackTopic.c_str(), buf, false);
+    sentient.publishTopic(ackTopic.c_str(), buf);
 
     Serial.print(F("[ACK] -> "));
     Serial.println(ackTopic);
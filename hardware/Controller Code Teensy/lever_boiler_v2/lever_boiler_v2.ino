@@ -17,7 +17,9 @@
 
 #include <SentientMQTT.h>
 #include <SentientDeviceRegistry.h>
-#include <SentientCapabilityManifest.h>
+#include <SentientManifestStream.h>
+#include <SentientMotionPlanner.h>
+#include <SentientPulseOutputs.h>
 
 // Suppress IRremote begin() error - we're using receiver only
 #define SUPPRESS_ERROR_MESSAGE_FOR_BEGIN
@@ -71,13 +73,8 @@ const unsigned long sensor_publish_interval_ms = 60000; // 60s
 const unsigned long ir_switch_interval = 200;           // ms
 const uint32_t target_ir_code = 0x51;                   // allowed gun code
 
-// Stepper sequence and timing
-const int step_sequence[4][4] = {
-    {1, 0, 0, 0},
-    {0, 1, 0, 0},
-    {0, 0, 1, 0},
-    {0, 0, 0, 1}};
-const int stepper_delay_us = 1000; // microseconds between steps
+// Stepper timing (wave drive: one coil at a time, SENTIENT_COILS_WAVE)
+const float stepper_rate = 1000.0; // steps/sec
 
 // =============================================================================
 // RUNTIME STATE
@@ -119,8 +116,15 @@ enum StepperDir
 };
 StepperDir stepper_dir = DIR_STOP;
 bool stepper_moving = false;
-int step_index = 0;
-unsigned long last_step_time_us = 0;
+
+// Coils are stepped from the SentientMotion timer ISR, which also stops the
+// post at the proximity limit in the direction of travel
+SentientMotionPlanner newell_motor;
+int newell_axis = -1;
+
+// Power LED feedback blinks run from a timer instead of delay()
+SentientPulseOutputs timed_outputs;
+int power_led_output = -1;
 
 // Publishing cadence
 unsigned long last_sensor_publish_time = 0;
@@ -131,58 +135,61 @@ bool sensors_initialized = false;
 // =============================================================================
 
 // Lever Boiler
-const char *boiler_commands[] = {
+constexpr const char *boiler_commands[] PROGMEM = {
     CMD_MAGLOCK_BOILER_UNLOCK,
     CMD_MAGLOCK_BOILER_LOCK,
     CMD_LEVER_LED_BOILER_ON,
     CMD_LEVER_LED_BOILER_OFF};
-const char *boiler_sensors[] = {
+constexpr const char *boiler_sensors[] PROGMEM = {
     SENSOR_BOILER_PHOTOCELL,
     SENSOR_BOILER_IR_CODE};
 
 // Lever Stairs
-const char *stairs_commands[] = {
+constexpr const char *stairs_commands[] PROGMEM = {
     CMD_MAGLOCK_STAIRS_UNLOCK,
     CMD_MAGLOCK_STAIRS_LOCK,
     CMD_LEVER_LED_STAIRS_ON,
     CMD_LEVER_LED_STAIRS_OFF};
-const char *stairs_sensors[] = {
+constexpr const char *stairs_sensors[] PROGMEM = {
     SENSOR_STAIRS_PHOTOCELL,
     SENSOR_STAIRS_IR_CODE};
 
 // Newell Post
-const char *newell_commands[] = {
+constexpr const char *newell_commands[] PROGMEM = {
     CMD_NEWELL_LIGHT_ON,
     CMD_NEWELL_LIGHT_OFF,
     CMD_STEPPER_UP,
     CMD_STEPPER_DOWN,
     CMD_STEPPER_STOP};
-const char *newell_sensors[] = {
+constexpr const char *newell_sensors[] PROGMEM = {
     SENSOR_NEWELL_POST_TOP_PROXIMITY,
     SENSOR_NEWELL_POST_BOTTOM_PROXIMITY};
 
-SentientDeviceDef dev_lever_boiler(
+constexpr SentientDeviceDef dev_lever_boiler PROGMEM(
     DEV_LEVER_BOILER,
     FRIENDLY_LEVER_BOILER,
     "lever_station",
     boiler_commands, 4,
     boiler_sensors, 2);
 
-SentientDeviceDef dev_lever_stairs(
+constexpr SentientDeviceDef dev_lever_stairs PROGMEM(
     DEV_LEVER_STAIRS,
     FRIENDLY_LEVER_STAIRS,
     "lever_station",
     stairs_commands, 4,
     stairs_sensors, 2);
 
-SentientDeviceDef dev_newell_post(
+constexpr SentientDeviceDef dev_newell_post PROGMEM(
     DEV_NEWELL_POST,
     FRIENDLY_NEWELL_POST,
     "newell_post",
     newell_commands, 5,
     newell_sensors, 2);
 
-SentientDeviceRegistry deviceRegistry;
+SENTIENT_DEVICE_REGISTRY(deviceRegistry,
+    &dev_lever_boiler,
+    &dev_lever_stairs,
+    &dev_newell_post);
 
 // =============================================================================
 // FORWARD DECLARATIONS
@@ -197,8 +204,7 @@ void read_sensors();
 void publish_sensor_changes(bool force_publish);
 void publish_hardware_status();
 void handle_ir_signal(int pin);
-void set_stepper_pins(int a, int b, int c, int d);
-void step_motor(int direction);
+void setup_stepper();
 void stop_stepper();
 void move_stepper_up();
 void move_stepper_down();
@@ -207,7 +213,7 @@ void move_stepper_down();
 // MQTT OBJECTS
 // =============================================================================
 
-SentientCapabilityManifest manifest;
+SentientManifestStream manifest(deviceRegistry);
 SentientMQTT mqtt(build_mqtt_config());
 
 // =============================================================================
@@ -237,7 +243,7 @@ void setup()
     Serial.println();
 
     // GPIO setup
-    pinMode(power_led_pin, OUTPUT);
+    power_led_output = timed_outputs.add(power_led_pin, LOW); // Lit at rest; a pulse blinks it off
     pinMode(maglock_boiler_pin, OUTPUT);
     pinMode(maglock_stairs_pin, OUTPUT);
     pinMode(lever_led_boiler_pin, OUTPUT);
@@ -246,29 +252,20 @@ void setup()
     pinMode(newell_prox_up_pin, INPUT_PULLDOWN);
     pinMode(newell_prox_down_pin, INPUT_PULLDOWN);
 
-    pinMode(stepper_pin_1, OUTPUT);
-    pinMode(stepper_pin_2, OUTPUT);
-    pinMode(stepper_pin_3, OUTPUT);
-    pinMode(stepper_pin_4, OUTPUT);
+    setup_stepper();
 
     // Initial states
-    digitalWrite(power_led_pin, HIGH);
     digitalWrite(maglock_boiler_pin, HIGH); // Locked
     digitalWrite(maglock_stairs_pin, HIGH);
     digitalWrite(lever_led_boiler_pin, HIGH); // LED on by default
     digitalWrite(lever_led_stairs_pin, HIGH);
     digitalWrite(newell_post_light_pin, LOW);
-    set_stepper_pins(0, 0, 0, 0);
 
     // IR init
     IrReceiver.begin(current_ir_pin, DISABLE_LED_FEEDBACK, power_led_pin);
     last_ir_switch_time = millis();
 
     // Register devices and build manifest
-    Serial.println("[LeverBoiler] Registering devices...");
-    deviceRegistry.addDevice(&dev_lever_boiler);
-    deviceRegistry.addDevice(&dev_lever_stairs);
-    deviceRegistry.addDevice(&dev_newell_post);
     deviceRegistry.printSummary();
 
     Serial.println("[LeverBoiler] Building capability manifest...");
@@ -294,9 +291,9 @@ void setup()
         if (mqtt.isConnected())
         {
             Serial.println("[LeverBoiler] Broker connected!");
-            if (manifest.publish_registration(mqtt.get_client(), ROOM_ID, CONTROLLER_ID))
+            if (manifest.publish_registration(mqtt, ROOM_ID, CONTROLLER_ID))
             {
-                Serial.println("[LeverBoiler] Registration successful!");
+                Serial.println("[LeverBoiler] Registration started");
             }
             else
             {
@@ -318,6 +315,8 @@ void setup()
 void loop()
 {
     mqtt.loop();
+    manifest.loop();
+    timed_outputs.loop();
 
     // IR read and alternate sensors
     if (ir_enabled && IrReceiver.decode())
@@ -342,21 +341,12 @@ void loop()
     if (force_pub)
         last_sensor_publish_time = millis();
 
-    // Stepper control
-    if (stepper_moving)
+    // Stepper control: the step ISR stops the motor at the limits, report it here
+    newell_motor.loop();
+    if (stepper_moving && !newell_motor.busy())
     {
-        // Stop at limits
-        if ((stepper_dir == DIR_UP && digitalRead(newell_prox_up_pin) == HIGH) ||
-            (stepper_dir == DIR_DOWN && digitalRead(newell_prox_down_pin) == HIGH))
-        {
-            stop_stepper();
-            publish_hardware_status();
-        }
-        else
-        {
-            // Run motor
-            step_motor((int)stepper_dir);
-        }
+        stop_stepper();
+        publish_hardware_status();
     }
 }
 
@@ -393,8 +383,6 @@ void build_capability_manifest()
         firmware::VERSION,
         ROOM_ID,
         CONTROLLER_ID);
-
-    deviceRegistry.buildManifest(manifest);
 }
 
 bool build_heartbeat_payload(JsonDocument &doc, void * /*ctx*/)
@@ -536,7 +524,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
                       String(CAT_ACKNOWLEDGEMENT) + "/" + String(CONTROLLER_ID) + "/" +
                       String(device_id) + "/" + String(command);
 
-    mqtt.get_client().publish(ackTopic.c_str(), buf, false);
+    mqtt.publishTopic(ackTopic.c_str(), buf);
 
     Serial.print(F("[ACK] -> "));
     Serial.println(ackTopic);
@@ -561,9 +549,8 @@ void read_sensors()
 
 void publish_sensor_changes(bool force_publish)
 {
-    if (!mqtt.isConnected())
-        return;
-    JsonDocument doc;
+    // No connection check: SentientMQTT queues edges while offline and replays them
+    JsonDocument &doc = mqtt.scratchDocument();
 
     // Boiler sensors - Only publish on STATE change (OPEN/CLOSED), not raw value fluctuations
     if (!sensors_initialized || force_publish || boiler_valve_open != last_boiler_valve_open)
@@ -571,7 +558,7 @@ void publish_sensor_changes(bool force_publish)
         doc.clear();
         doc["open"] = boiler_valve_open ? 1 : 0;
         doc["raw"] = photocell_boiler;
-        mqtt.publishJson(CAT_SENSORS, (String(DEV_LEVER_BOILER) + "/" + SENSOR_BOILER_PHOTOCELL).c_str(), doc);
+        mqtt.publishJson(CAT_SENSORS, DEV_LEVER_BOILER, SENSOR_BOILER_PHOTOCELL, doc);
         last_boiler_valve_open = boiler_valve_open;
         last_photocell_boiler = photocell_boiler;
     }
@@ -582,7 +569,7 @@ void publish_sensor_changes(bool force_publish)
         doc.clear();
         doc["open"] = stairs_valve_open ? 1 : 0;
         doc["raw"] = photocell_stairs;
-        mqtt.publishJson(CAT_SENSORS, (String(DEV_LEVER_STAIRS) + "/" + SENSOR_STAIRS_PHOTOCELL).c_str(), doc);
+        mqtt.publishJson(CAT_SENSORS, DEV_LEVER_STAIRS, SENSOR_STAIRS_PHOTOCELL, doc);
         last_stairs_valve_open = stairs_valve_open;
         last_photocell_stairs = photocell_stairs;
     }
@@ -592,14 +579,14 @@ void publish_sensor_changes(bool force_publish)
     {
         doc.clear();
         doc["state"] = prox_up ? 1 : 0;
-        mqtt.publishJson(CAT_SENSORS, (String(DEV_NEWELL_POST) + "/" + SENSOR_NEWELL_POST_TOP_PROXIMITY).c_str(), doc);
+        mqtt.publishJson(CAT_SENSORS, DEV_NEWELL_POST, SENSOR_NEWELL_POST_TOP_PROXIMITY, doc);
         last_prox_up = prox_up;
     }
     if (!sensors_initialized || force_publish || prox_down != last_prox_down)
     {
         doc.clear();
         doc["state"] = prox_down ? 1 : 0;
-        mqtt.publishJson(CAT_SENSORS, (String(DEV_NEWELL_POST) + "/" + SENSOR_NEWELL_POST_BOTTOM_PROXIMITY).c_str(), doc);
+        mqtt.publishJson(CAT_SENSORS, DEV_NEWELL_POST, SENSOR_NEWELL_POST_BOTTOM_PROXIMITY, doc);
         last_prox_down = prox_down;
     }
 
@@ -644,59 +631,46 @@ void handle_ir_signal(int pin)
     const char *dev = (pin == ir_sensor_1_pin) ? DEV_LEVER_BOILER : DEV_LEVER_STAIRS;
     const char *sensor = (pin == ir_sensor_1_pin) ? SENSOR_BOILER_IR_CODE : SENSOR_STAIRS_IR_CODE;
 
-    JsonDocument doc;
+    JsonDocument &doc = mqtt.scratchDocument();
     doc["code"] = (int)command;
     doc["raw"] = (int)raw;
-    mqtt.publishJson(CAT_SENSORS, (String(dev) + "/" + sensor).c_str(), doc);
-
-    // Feedback blink on power LED
-    digitalWrite(power_led_pin, LOW);
-    delay(60);
-    digitalWrite(power_led_pin, HIGH);
-    delay(60);
-    digitalWrite(power_led_pin, LOW);
-    delay(60);
-    digitalWrite(power_led_pin, HIGH);
+    mqtt.publishJson(CAT_SENSORS, dev, sensor, doc);
+
+    // Feedback blink on power LED: off 60 ms, on 60 ms, off 60 ms
+    timed_outputs.train(power_led_output, 60000, 60000, 2);
 }
 
 // =============================================================================
 // STEPPER CONTROL
 // =============================================================================
 
-void set_stepper_pins(int a, int b, int c, int d)
-{
-    digitalWrite(stepper_pin_1, a);
-    digitalWrite(stepper_pin_2, b);
-    digitalWrite(stepper_pin_3, c);
-    digitalWrite(stepper_pin_4, d);
-}
-
-void step_motor(int direction)
+void setup_stepper()
 {
-    unsigned long now = micros();
-    if ((long)(now - last_step_time_us) < stepper_delay_us)
-        return;
-
-    step_index += direction;
-    if (step_index < 0)
-        step_index = 3;
-    if (step_index > 3)
-        step_index = 0;
-
-    set_stepper_pins(
-        step_sequence[step_index][0],
-        step_sequence[step_index][1],
-        step_sequence[step_index][2],
-        step_sequence[step_index][3]);
-
-    last_step_time_us = now;
+    SentientAxisConfig axis;
+    axis.driver = SentientStepperDriver::FourWire;
+    axis.coilPins[0] = stepper_pin_1;
+    axis.coilPins[1] = stepper_pin_2;
+    axis.coilPins[2] = stepper_pin_3;
+    axis.coilPins[3] = stepper_pin_4;
+    axis.coilSequence = SENTIENT_COILS_WAVE;
+    axis.releaseWhenIdle = true; // Coils off whenever the post is not moving
+    newell_axis = newell_motor.addAxis(axis);
+
+    // Prox inputs are configured INPUT_PULLDOWN in setup() and read HIGH at the limit
+    newell_motor.addLimitInput(newell_axis, DIR_UP, newell_prox_up_pin, HIGH);
+    newell_motor.addLimitInput(newell_axis, DIR_DOWN, newell_prox_down_pin, HIGH);
+
+    SentientMotionConfig motion;
+    motion.startRate = stepper_rate;
+    motion.maxRate = stepper_rate;
+    newell_motor.configureGroup(0, motion);
 }
 
 void stop_stepper()
 {
+    newell_motor.stop(0);
     stepper_dir = DIR_STOP;
     stepper_moving = false;
-    set_stepper_pins(0, 0, 0, 0);
     Serial.println(F("[Newell] Stepper stopped"));
 }
 
@@ -710,6 +684,7 @@ void move_stepper_up()
     }
     stepper_dir = DIR_UP;
     stepper_moving = true;
+    newell_motor.runAxis(newell_axis, DIR_UP, stepper_rate);
     Serial.println(F("[Newell] Moving UP"));
 }
 
@@ -723,5 +698,6 @@ void move_stepper_down()
     }
     stepper_dir = DIR_DOWN;
     stepper_moving = true;
+    newell_motor.runAxis(newell_axis, DIR_DOWN, stepper_rate);
     Serial.println(F("[Newell] Moving DOWN"));
 }
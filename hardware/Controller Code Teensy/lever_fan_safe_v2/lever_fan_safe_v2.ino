@@ -5,10 +5,10 @@
 
 #define SUPPRESS_ERROR_MESSAGE_FOR_BEGIN // IRremote library compatibility
 #include <SentientMQTT.h>
-#include <SentientCapabilityManifest.h>
+#include <SentientManifestStream.h>
 #include <SentientDeviceRegistry.h>
 #include <ArduinoJson.h>
-#include <AccelStepper.h>
+#include <SentientMotionPlanner.h>
 #include <IRremote.hpp>
 #include "controller_naming.h"
 
@@ -30,6 +30,7 @@ const int PIN_STEPPER_1 = 33;
 const int PIN_STEPPER_2 = 34;
 const int PIN_STEPPER_3 = 35;
 const int PIN_STEPPER_4 = 36;
+const float FAN_STEP_RATE = 1500.0; // steps/sec, constant speed
 
 const int PHOTOCELL_THRESHOLD = 300;
 const unsigned long IR_SWITCH_INTERVAL = 200; // ms between IR sensor switching
@@ -49,7 +50,9 @@ const unsigned long heartbeat_interval_ms = 5000;
 // STATE MANAGEMENT
 // ══════════════════════════════════════════════════════════════════════════════
 
-AccelStepper stepper(AccelStepper::FULL4WIRE, PIN_STEPPER_1, PIN_STEPPER_2, PIN_STEPPER_3, PIN_STEPPER_4);
+// Fan stepper coils are switched from the SentientMotion timer ISR
+SentientMotionPlanner fan_motor;
+int fan_axis = -1;
 
 int photocell_safe = 0;
 int photocell_fan = 0;
@@ -68,29 +71,36 @@ bool fan_motor_running = false;
 // ══════════════════════════════════════════════════════════════════════════════
 
 // Photocell sensors
-const char *photocell_sensors[] = {naming::SENSOR_LEVER_POSITION};
-SentientDeviceDef dev_photocell_safe(naming::DEV_PHOTOCELL_SAFE, "Safe Photocell", "photocell", photocell_sensors, 1, true);
-SentientDeviceDef dev_photocell_fan(naming::DEV_PHOTOCELL_FAN, "Fan Photocell", "photocell", photocell_sensors, 1, true);
+constexpr const char *photocell_sensors[] PROGMEM = {naming::SENSOR_LEVER_POSITION};
+constexpr SentientDeviceDef dev_photocell_safe PROGMEM(naming::DEV_PHOTOCELL_SAFE, "Safe Photocell", "photocell", photocell_sensors, 1, true);
+constexpr SentientDeviceDef dev_photocell_fan PROGMEM(naming::DEV_PHOTOCELL_FAN, "Fan Photocell", "photocell", photocell_sensors, 1, true);
 
 // IR receivers
-const char *ir_sensors[] = {naming::SENSOR_IR_CODE};
-const char *ir_commands[] = {naming::CMD_IR_ENABLE, naming::CMD_IR_DISABLE};
-SentientDeviceDef dev_ir_safe(naming::DEV_IR_SAFE, "Safe IR Receiver", "ir_receiver", ir_commands, 2, ir_sensors, 1);
-SentientDeviceDef dev_ir_fan(naming::DEV_IR_FAN, "Fan IR Receiver", "ir_receiver", ir_commands, 2, ir_sensors, 1);
+constexpr const char *ir_sensors[] PROGMEM = {naming::SENSOR_IR_CODE};
+constexpr const char *ir_commands[] PROGMEM = {naming::CMD_IR_ENABLE, naming::CMD_IR_DISABLE};
+constexpr SentientDeviceDef dev_ir_safe PROGMEM(naming::DEV_IR_SAFE, "Safe IR Receiver", "ir_receiver", ir_commands, 2, ir_sensors, 1);
+constexpr SentientDeviceDef dev_ir_fan PROGMEM(naming::DEV_IR_FAN, "Fan IR Receiver", "ir_receiver", ir_commands, 2, ir_sensors, 1);
 
 // Maglock
-const char *maglock_commands[] = {naming::CMD_LOCK, naming::CMD_UNLOCK};
-SentientDeviceDef dev_maglock_fan(naming::DEV_MAGLOCK_FAN, "Fan Maglock", "maglock", maglock_commands, 2);
+constexpr const char *maglock_commands[] PROGMEM = {naming::CMD_LOCK, naming::CMD_UNLOCK};
+constexpr SentientDeviceDef dev_maglock_fan PROGMEM(naming::DEV_MAGLOCK_FAN, "Fan Maglock", "maglock", maglock_commands, 2);
 
 // Solenoid
-const char *solenoid_commands[] = {naming::CMD_OPEN, naming::CMD_CLOSE};
-SentientDeviceDef dev_solenoid_safe(naming::DEV_SOLENOID_SAFE, "Safe Solenoid", "solenoid", solenoid_commands, 2);
+constexpr const char *solenoid_commands[] PROGMEM = {naming::CMD_OPEN, naming::CMD_CLOSE};
+constexpr SentientDeviceDef dev_solenoid_safe PROGMEM(naming::DEV_SOLENOID_SAFE, "Safe Solenoid", "solenoid", solenoid_commands, 2);
 
 // Fan motor
-const char *fan_commands[] = {naming::CMD_FAN_ON, naming::CMD_FAN_OFF};
-SentientDeviceDef dev_fan_motor(naming::DEV_FAN_MOTOR, "Fan Motor", "motor", fan_commands, 2);
-
-SentientDeviceRegistry deviceRegistry;
+constexpr const char *fan_commands[] PROGMEM = {naming::CMD_FAN_ON, naming::CMD_FAN_OFF};
+constexpr SentientDeviceDef dev_fan_motor PROGMEM(naming::DEV_FAN_MOTOR, "Fan Motor", "motor", fan_commands, 2);
+
+SENTIENT_DEVICE_REGISTRY(deviceRegistry,
+    &dev_photocell_safe,
+    &dev_photocell_fan,
+    &dev_ir_safe,
+    &dev_ir_fan,
+    &dev_maglock_fan,
+    &dev_solenoid_safe,
+    &dev_fan_motor);
 
 // ══════════════════════════════════════════════════════════════════════════════
 // SENTIENT MQTT INITIALIZATION
@@ -116,7 +126,7 @@ SentientMQTTConfig make_mqtt_config()
 }
 
 SentientMQTT sentient(make_mqtt_config());
-SentientCapabilityManifest manifest;
+SentientManifestStream manifest(deviceRegistry);
 
 void handle_mqtt_command(const char *command, const JsonDocument &payload, void *ctx);
 void publish_command_acknowledgement(const char *device_id, const char *command);
@@ -146,9 +156,18 @@ void setup()
     pinMode(PIN_PHOTOCELL_FAN, INPUT);
 
     // Initialize stepper
-    stepper.setMaxSpeed(3000);
-    stepper.setSpeed(0);
-    stepper.stop();
+    SentientAxisConfig axis;
+    axis.driver = SentientStepperDriver::FourWire;
+    axis.coilPins[0] = PIN_STEPPER_1;
+    axis.coilPins[1] = PIN_STEPPER_2;
+    axis.coilPins[2] = PIN_STEPPER_3;
+    axis.coilPins[3] = PIN_STEPPER_4;
+    fan_axis = fan_motor.addAxis(axis);
+
+    SentientMotionConfig motion;
+    motion.startRate = FAN_STEP_RATE;
+    motion.maxRate = FAN_STEP_RATE;
+    fan_motor.configureGroup(0, motion);
 
     // Initialize IR receiver
     IrReceiver.begin(current_ir_pin, ENABLE_LED_FEEDBACK);
@@ -157,19 +176,10 @@ void setup()
     delay(2000);
     Serial.println(F("[LeverFanSafe] Starting..."));
 
-    // Register devices
-    deviceRegistry.addDevice(&dev_photocell_safe);
-    deviceRegistry.addDevice(&dev_photocell_fan);
-    deviceRegistry.addDevice(&dev_ir_safe);
-    deviceRegistry.addDevice(&dev_ir_fan);
-    deviceRegistry.addDevice(&dev_maglock_fan);
-    deviceRegistry.addDevice(&dev_solenoid_safe);
-    deviceRegistry.addDevice(&dev_fan_motor);
     deviceRegistry.printSummary();
 
     manifest.set_controller_info(naming::CONTROLLER_ID, naming::CONTROLLER_FRIENDLY_NAME,
                                  firmware::VERSION, naming::ROOM_ID, naming::CONTROLLER_ID);
-    deviceRegistry.buildManifest(manifest);
 
     sentient.begin();
     sentient.setCommandCallback(handle_mqtt_command);
@@ -183,7 +193,7 @@ void setup()
 
     if (sentient.isConnected())
     {
-        manifest.publish_registration(sentient.get_client(), naming::ROOM_ID, naming::CONTROLLER_ID);
+        manifest.publish_registration(sentient, naming::ROOM_ID, naming::CONTROLLER_ID);
     }
 
     Serial.println(F("[LeverFanSafe] Ready"));
@@ -196,6 +206,7 @@ void setup()
 void loop()
 {
     sentient.loop();
+    manifest.loop();
     monitor_sensors();
 
     // Handle IR signal
@@ -214,11 +225,7 @@ void loop()
         switch_ir_sensor();
     }
 
-    // Run stepper if fan motor enabled
-    if (fan_motor_running && digitalRead(PIN_FAN_MOTOR_ENABLE) == HIGH)
-    {
-        stepper.runSpeed();
-    }
+    fan_motor.loop();
 }
 
 // ══════════════════════════════════════════════════════════════════════════════
@@ -267,14 +274,14 @@ void handle_mqtt_command(const char *command, const JsonDocument &payload, void
         {
             digitalWrite(PIN_FAN_MOTOR_ENABLE, LOW);
             fan_motor_running = true;
-            stepper.setSpeed(1500);
+            fan_motor.runAxis(fan_axis, 1, FAN_STEP_RATE);
             Serial.println(F("[CMD] Fan Motor ON"));
         }
         else if (strcmp(command, naming::CMD_FAN_OFF) == 0)
         {
             digitalWrite(PIN_FAN_MOTOR_ENABLE, HIGH);
             fan_motor_running = false;
-            stepper.setSpeed(0);
+            fan_motor.stop(0);
             Serial.println(F("[CMD] Fan Motor OFF"));
         }
     }
@@ -329,7 +336,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
                       String(naming::CAT_ACKNOWLEDGEMENT) + "/" + String(naming::CONTROLLER_ID) + "/" +
                       String(device_id) + "/" + String(command);
 
-    sentient.get_client().publish(ackTopic.c_str(), buf, false);
+    sentient.publishTopic(ackTopic.c_str(), buf);
 
     Serial.print(F("[ACK] -> "));
     Serial.println(ackTopic);
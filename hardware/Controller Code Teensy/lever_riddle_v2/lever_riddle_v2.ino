@@ -5,7 +5,7 @@
 
 #define SUPPRESS_ERROR_MESSAGE_FOR_BEGIN // IRremote library compatibility
 #include <SentientMQTT.h>
-#include <SentientCapabilityManifest.h>
+#include <SentientManifestStream.h>
 #include <SentientDeviceRegistry.h>
 #include <ArduinoJson.h>
 #include <IRremote.hpp>
@@ -68,39 +68,50 @@ char last_ir_code[64] = "";
 // ══════════════════════════════════════════════════════════════════════════════
 
 // Hall effect sensors
-const char *hall_sensors[] = {naming::SENSOR_MAGNET};
-SentientDeviceDef dev_hall_a(naming::DEV_HALL_A, "Hall Sensor A", "hall_effect", hall_sensors, 1, true);
-SentientDeviceDef dev_hall_b(naming::DEV_HALL_B, "Hall Sensor B", "hall_effect", hall_sensors, 1, true);
-SentientDeviceDef dev_hall_c(naming::DEV_HALL_C, "Hall Sensor C", "hall_effect", hall_sensors, 1, true);
-SentientDeviceDef dev_hall_d(naming::DEV_HALL_D, "Hall Sensor D", "hall_effect", hall_sensors, 1, true);
+constexpr const char *hall_sensors[] PROGMEM = {naming::SENSOR_MAGNET};
+constexpr SentientDeviceDef dev_hall_a PROGMEM(naming::DEV_HALL_A, "Hall Sensor A", "hall_effect", hall_sensors, 1, true);
+constexpr SentientDeviceDef dev_hall_b PROGMEM(naming::DEV_HALL_B, "Hall Sensor B", "hall_effect", hall_sensors, 1, true);
+constexpr SentientDeviceDef dev_hall_c PROGMEM(naming::DEV_HALL_C, "Hall Sensor C", "hall_effect", hall_sensors, 1, true);
+constexpr SentientDeviceDef dev_hall_d PROGMEM(naming::DEV_HALL_D, "Hall Sensor D", "hall_effect", hall_sensors, 1, true);
 
 // Photocell
-const char *photocell_sensors[] = {naming::SENSOR_LEVER_POSITION};
-SentientDeviceDef dev_photocell(naming::DEV_PHOTOCELL, "Photocell Lever", "photocell", photocell_sensors, 1, true);
+constexpr const char *photocell_sensors[] PROGMEM = {naming::SENSOR_LEVER_POSITION};
+constexpr SentientDeviceDef dev_photocell PROGMEM(naming::DEV_PHOTOCELL, "Photocell Lever", "photocell", photocell_sensors, 1, true);
 
 // Cube button
-const char *button_sensors[] = {naming::SENSOR_BUTTON_STATE};
-SentientDeviceDef dev_cube_button(naming::DEV_CUBE_BUTTON, "Cube Button", "button", button_sensors, 1, true);
+constexpr const char *button_sensors[] PROGMEM = {naming::SENSOR_BUTTON_STATE};
+constexpr SentientDeviceDef dev_cube_button PROGMEM(naming::DEV_CUBE_BUTTON, "Cube Button", "button", button_sensors, 1, true);
 
 // IR receiver
-const char *ir_sensors[] = {naming::SENSOR_IR_CODE};
-const char *ir_commands[] = {naming::CMD_IR_ENABLE, naming::CMD_IR_DISABLE};
-SentientDeviceDef dev_ir_receiver(naming::DEV_IR_RECEIVER, "IR Receiver", "ir_receiver", ir_commands, 2, ir_sensors, 1);
+constexpr const char *ir_sensors[] PROGMEM = {naming::SENSOR_IR_CODE};
+constexpr const char *ir_commands[] PROGMEM = {naming::CMD_IR_ENABLE, naming::CMD_IR_DISABLE};
+constexpr SentientDeviceDef dev_ir_receiver PROGMEM(naming::DEV_IR_RECEIVER, "IR Receiver", "ir_receiver", ir_commands, 2, ir_sensors, 1);
 
 // Maglock
-const char *maglock_commands[] = {naming::CMD_LOCK, naming::CMD_UNLOCK};
-SentientDeviceDef dev_maglock(naming::DEV_MAGLOCK, "Maglock", "maglock", maglock_commands, 2);
+constexpr const char *maglock_commands[] PROGMEM = {naming::CMD_LOCK, naming::CMD_UNLOCK};
+constexpr SentientDeviceDef dev_maglock PROGMEM(naming::DEV_MAGLOCK, "Maglock", "maglock", maglock_commands, 2);
 
 // LED strips
-const char *led_commands[] = {naming::CMD_SET_COLOR};
-SentientDeviceDef dev_led_strip(naming::DEV_LED_STRIP, "Main LED Strip", "led_strip", led_commands, 1);
-SentientDeviceDef dev_led_lever(naming::DEV_LED_LEVER, "Lever LED Strip", "led_strip", led_commands, 1);
+constexpr const char *led_commands[] PROGMEM = {naming::CMD_SET_COLOR};
+constexpr SentientDeviceDef dev_led_strip PROGMEM(naming::DEV_LED_STRIP, "Main LED Strip", "led_strip", led_commands, 1);
+constexpr SentientDeviceDef dev_led_lever PROGMEM(naming::DEV_LED_LEVER, "Lever LED Strip", "led_strip", led_commands, 1);
 
 // COB light
-const char *cob_commands[] = {naming::CMD_LIGHT_ON, naming::CMD_LIGHT_OFF};
-SentientDeviceDef dev_cob_light(naming::DEV_COB_LIGHT, "COB Light", "light", cob_commands, 2);
-
-SentientDeviceRegistry deviceRegistry;
+constexpr const char *cob_commands[] PROGMEM = {naming::CMD_LIGHT_ON, naming::CMD_LIGHT_OFF};
+constexpr SentientDeviceDef dev_cob_light PROGMEM(naming::DEV_COB_LIGHT, "COB Light", "light", cob_commands, 2);
+
+SENTIENT_DEVICE_REGISTRY(deviceRegistry,
+    &dev_hall_a,
+    &dev_hall_b,
+    &dev_hall_c,
+    &dev_hall_d,
+    &dev_photocell,
+    &dev_cube_button,
+    &dev_ir_receiver,
+    &dev_maglock,
+    &dev_led_strip,
+    &dev_led_lever,
+    &dev_cob_light);
 
 // ══════════════════════════════════════════════════════════════════════════════
 // SENTIENT MQTT INITIALIZATION
@@ -126,7 +137,7 @@ SentientMQTTConfig make_mqtt_config()
 }
 
 SentientMQTT sentient(make_mqtt_config());
-SentientCapabilityManifest manifest;
+SentientManifestStream manifest(deviceRegistry);
 
 void handle_mqtt_command(const char *command, const JsonDocument &payload, void *ctx);
 void publish_command_acknowledgement(const char *device_id, const char *command);
@@ -167,23 +178,10 @@ void setup()
     delay(2000);
     Serial.println(F("[LeverRiddle] Starting..."));
 
-    // Register devices
-    deviceRegistry.addDevice(&dev_hall_a);
-    deviceRegistry.addDevice(&dev_hall_b);
-    deviceRegistry.addDevice(&dev_hall_c);
-    deviceRegistry.addDevice(&dev_hall_d);
-    deviceRegistry.addDevice(&dev_photocell);
-    deviceRegistry.addDevice(&dev_cube_button);
-    deviceRegistry.addDevice(&dev_ir_receiver);
-    deviceRegistry.addDevice(&dev_maglock);
-    deviceRegistry.addDevice(&dev_led_strip);
-    deviceRegistry.addDevice(&dev_led_lever);
-    deviceRegistry.addDevice(&dev_cob_light);
     deviceRegistry.printSummary();
 
     manifest.set_controller_info(naming::CONTROLLER_ID, naming::CONTROLLER_FRIENDLY_NAME,
                                  firmware::VERSION, naming::ROOM_ID, naming::CONTROLLER_ID);
-    deviceRegistry.buildManifest(manifest);
 
     // Initialize IR receiver after serial
     IrReceiver.begin(PIN_IR_RECEIVE, DISABLE_LED_FEEDBACK);
@@ -200,7 +198,7 @@ void setup()
 
     if (sentient.isConnected())
     {
-        manifest.publish_registration(sentient.get_client(), naming::ROOM_ID, naming::CONTROLLER_ID);
+        manifest.publish_registration(sentient, naming::ROOM_ID, naming::CONTROLLER_ID);
     }
 
     Serial.println(F("[LeverRiddle] Ready"));
@@ -213,6 +211,7 @@ void setup()
 void loop()
 {
     sentient.loop();
+    manifest.loop();
     monitor_sensors();
 
     if (ir_enabled && IrReceiver.decode())
@@ -323,7 +322,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
                       String(naming::CAT_ACKNOWLEDGEMENT) + "/" + String(naming::CONTROLLER_ID) + "/" +
                       String(device_id) + "/" + String(command);
 
-    sentient.get_client().publish(ackTopic.c_str(), buf, false);
+    sentient.publishTopic(ackTopic.c_str(), buf);
 
     Serial.print(F("[ACK] -> "));
     Serial.println(ackTopic);
@@ -34,6 +34,8 @@ namespace naming
     constexpr const char *CMD_LAB_SET_SQUARES_COLOR = "set_squares_color";
     constexpr const char *CMD_LAB_SET_GRATES_BRIGHTNESS = "set_grates_brightness";
     constexpr const char *CMD_LAB_SET_GRATES_COLOR = "set_grates_color";
+    constexpr const char *CMD_LAB_SET_SQUARES_EFFECT = "set_squares_effect";
+    constexpr const char *CMD_LAB_SET_GRATES_EFFECT = "set_grates_effect";
     constexpr const char *CMD_SCONCES_ON = "sconces_on";
     constexpr const char *CMD_SCONCES_OFF = "sconces_off";
     constexpr const char *CMD_CRAWLSPACE_ON = "crawlspace_on";
@@ -42,6 +44,7 @@ namespace naming
     // Friendly command names
     constexpr const char *FRIENDLY_CMD_SET_BRIGHTNESS = "Set Brightness";
     constexpr const char *FRIENDLY_CMD_SET_COLOR = "Set Color";
+    constexpr const char *FRIENDLY_CMD_SET_EFFECT = "Set Effect";
     constexpr const char *FRIENDLY_CMD_ON = "Turn On";
     constexpr const char *FRIENDLY_CMD_OFF = "Turn Off";
 
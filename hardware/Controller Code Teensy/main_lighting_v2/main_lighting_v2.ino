@@ -14,7 +14,7 @@
  * - Crawlspace Lights (digital relay)
  *
  * STATELESS ARCHITECTURE:
- * - Device-scoped command routing via MQTT topic parsing
+ * - Device-scoped command routing via SentientMQTT command routes
  * - Command acknowledgments published on events channel
  * - Pure command-driven controller with state updates
  * - No autonomous behavior - executes commands from Sentient
@@ -27,11 +27,14 @@
 #define MQTT_MAX_PACKET_SIZE 512
 #endif
 
-#include <SentientCapabilityManifest.h>
+#include <SentientManifestStream.h>
 #include <SentientMQTT.h>
 #include <SentientDeviceRegistry.h>
 #include <ArduinoJson.h>
 #include <FastLED.h>
+#include <SentientLedBus.h>
+#include <SentientLedEffects.h>
+#include <SentientLedStream.h>
 
 #include "FirmwareMetadata.h"
 #include "controller_naming.h"
@@ -41,7 +44,8 @@
 // ──────────────────────────────────────────────────────────────────────────────
 // *** Study Lights - Analog dimmer control (PWM 0-255)
 // *** Boiler Room Lights - Analog dimmer control (PWM 0-255)
-// *** Lab Lights - 11 FastLED strips (8 ceiling squares + 3 floor grates)
+// *** Lab Lights - 11 WS2812B strips (8 ceiling squares + 3 floor grates), parallel DMA output,
+//                  each zone mirrored from one buffer and animated by the effect engine
 // *** Sconces - Digital relay control (ON/OFF)
 // *** Crawlspace Lights - Digital relay control (ON/OFF)
 
@@ -50,7 +54,7 @@
 // ──────────────────────────────────────────────────────────────────────────────
 const int power_led_pin = 13;
 
-// LED Strips (FastLED)
+// LED Strips (SentientLED bus)
 const int ceiling_square_a_pin = 4;
 const int ceiling_square_b_pin = 3;
 const int ceiling_square_c_pin = 5;
@@ -74,77 +78,94 @@ const int crawlspace_lights_pin = 11;
 // LED configuration
 const int num_leds_per_strip = 300;
 
-CRGB leds_sa[num_leds_per_strip];
-CRGB leds_sb[num_leds_per_strip];
-CRGB leds_sc[num_leds_per_strip];
-CRGB leds_sd[num_leds_per_strip];
-CRGB leds_se[num_leds_per_strip];
-CRGB leds_sf[num_leds_per_strip];
-CRGB leds_sg[num_leds_per_strip];
-CRGB leds_sh[num_leds_per_strip];
-CRGB leds_g1[num_leds_per_strip];
-CRGB leds_g2[num_leds_per_strip];
-CRGB leds_g3[num_leds_per_strip];
+// Every strip of a zone shows the same pixels: one buffer per zone, mirrored to its strips
+CRGB leds_squares[num_leds_per_strip];
+CRGB leds_grates[num_leds_per_strip];
+uint8_t squares_fire_state[SENTIENT_LED_FIRE_STATE_BYTES(num_leds_per_strip)];
+uint8_t grates_fire_state[SENTIENT_LED_FIRE_STATE_BYTES(num_leds_per_strip)];
+
+// All 11 strips go out in parallel over DMA: one frame takes as long as one strip
+const int num_led_strips = 11;
+DMAMEM uint8_t led_frame[SENTIENT_LED_FRAME_BYTES(num_led_strips, num_leds_per_strip)];
+SentientLedBus led_bus(num_leds_per_strip);
+
+// Effect engine: fixed frame rate, a zone's strips are only latched when its pixels changed
+const uint8_t led_frames_per_second = 60;
+SentientLedEffects led_effects(led_frames_per_second);
+int lab_squares_segment = -1;
+int lab_grates_segment = -1;
+
+// Show-control stream: squares from universe 1, grates from universe 3
+// (300 pixels = 2 universes each); DDP sees squares then grates
+SentientLedStream led_stream;
 
 // ============================================================================
 // DEVICE REGISTRY (SINGLE SOURCE OF TRUTH!) — Updated to canonical device IDs
 // ============================================================================
 
 // Study Lights — analog dimmer commands
-const char *study_lights_commands[] = {
+constexpr const char *study_lights_commands[] PROGMEM = {
     naming::CMD_STUDY_SET_BRIGHTNESS};
 
 // Boiler Room Lights — analog dimmer commands
-const char *boiler_lights_commands[] = {
+constexpr const char *boiler_lights_commands[] PROGMEM = {
     naming::CMD_BOILER_SET_BRIGHTNESS};
 
 // Lab Lights Squares — FastLED ceiling strips commands
-const char *lab_lights_squares_commands[] = {
+constexpr const char *lab_lights_squares_commands[] PROGMEM = {
     naming::CMD_LAB_SET_SQUARES_BRIGHTNESS,
-    naming::CMD_LAB_SET_SQUARES_COLOR};
+    naming::CMD_LAB_SET_SQUARES_COLOR,
+    naming::CMD_LAB_SET_SQUARES_EFFECT};
 
 // Lab Lights Grates — FastLED floor grate commands
-const char *lab_lights_grates_commands[] = {
+constexpr const char *lab_lights_grates_commands[] PROGMEM = {
     naming::CMD_LAB_SET_GRATES_BRIGHTNESS,
-    naming::CMD_LAB_SET_GRATES_COLOR};
+    naming::CMD_LAB_SET_GRATES_COLOR,
+    naming::CMD_LAB_SET_GRATES_EFFECT};
 
 // Sconces — digital relay commands
-const char *sconces_commands[] = {
+constexpr const char *sconces_commands[] PROGMEM = {
     naming::CMD_SCONCES_ON,
     naming::CMD_SCONCES_OFF};
 
 // Crawlspace Lights — digital relay commands
-const char *crawlspace_lights_commands[] = {
+constexpr const char *crawlspace_lights_commands[] PROGMEM = {
     naming::CMD_CRAWLSPACE_ON,
     naming::CMD_CRAWLSPACE_OFF};
 
 // Create device definitions with friendly names
-SentientDeviceDef dev_study_lights(
+constexpr SentientDeviceDef dev_study_lights PROGMEM(
     naming::DEV_STUDY_LIGHTS, naming::FRIENDLY_STUDY_LIGHTS, "dimmer",
     study_lights_commands, 1);
 
-SentientDeviceDef dev_boiler_lights(
+constexpr SentientDeviceDef dev_boiler_lights PROGMEM(
     naming::DEV_BOILER_LIGHTS, naming::FRIENDLY_BOILER_LIGHTS, "dimmer",
     boiler_lights_commands, 1);
 
-SentientDeviceDef dev_lab_lights_squares(
+constexpr SentientDeviceDef dev_lab_lights_squares PROGMEM(
     naming::DEV_LAB_LIGHTS_SQUARES, naming::FRIENDLY_LAB_LIGHTS_SQUARES, "led_strip",
-    lab_lights_squares_commands, 2);
+    lab_lights_squares_commands, 3);
 
-SentientDeviceDef dev_lab_lights_grates(
+constexpr SentientDeviceDef dev_lab_lights_grates PROGMEM(
     naming::DEV_LAB_LIGHTS_GRATES, naming::FRIENDLY_LAB_LIGHTS_GRATES, "led_strip",
-    lab_lights_grates_commands, 2);
+    lab_lights_grates_commands, 3);
 
-SentientDeviceDef dev_sconces(
+constexpr SentientDeviceDef dev_sconces PROGMEM(
     naming::DEV_SCONCES, naming::FRIENDLY_SCONCES, "relay",
     sconces_commands, 2);
 
-SentientDeviceDef dev_crawlspace_lights(
+constexpr SentientDeviceDef dev_crawlspace_lights PROGMEM(
     naming::DEV_CRAWLSPACE_LIGHTS, naming::FRIENDLY_CRAWLSPACE_LIGHTS, "relay",
     crawlspace_lights_commands, 2);
 
 // Create the device registry (manifest builder will use these IDs and names)
-SentientDeviceRegistry deviceRegistry;
+SENTIENT_DEVICE_REGISTRY(deviceRegistry,
+  &dev_study_lights,
+  &dev_boiler_lights,
+  &dev_lab_lights_squares,
+  &dev_lab_lights_grates,
+  &dev_sconces,
+  &dev_crawlspace_lights);
 
 // ──────────────────────────────────────────────────────────────────────────────
 // Configuration Constants
@@ -182,17 +203,59 @@ CRGB lab_grates_color = CRGB::Blue;
 bool sconces_on = false;
 bool crawlspace_lights_on = false;
 
+// ──────────────────────────────────────────────────────────────────────────────
+// Command Routing Contexts (one per device, passed to its route handler)
+// ──────────────────────────────────────────────────────────────────────────────
+struct DimmerChannel
+{
+  int pin;
+  int *level;
+  const char *label;
+};
+
+struct LabZone
+{
+  int *segment;            // Effect engine segment holding the zone's pixels
+  uint8_t first_bus_strip; // Zone strips are added to led_bus consecutively
+  uint8_t strip_count;
+  uint8_t *brightness;
+  CRGB *color;
+  bool *on;
+  CRGB default_color;
+  const char *label;
+};
+
+struct RelayChannel
+{
+  int pin;
+  bool *on;
+  const char *label;
+};
+
+DimmerChannel study_channel = {study_lights_pin, &study_dimmer, "Study lights"};
+DimmerChannel boiler_channel = {boiler_lights_pin, &boiler_dimmer, "Boiler lights"};
+LabZone lab_squares_zone = {&lab_squares_segment, 0, 8, &lab_squares_brightness, &lab_squares_color, &lab_squares_on, CRGB::Yellow, "Lab squares"};
+LabZone lab_grates_zone = {&lab_grates_segment, 8, 3, &lab_grates_brightness, &lab_grates_color, &lab_grates_on, CRGB::Blue, "Lab grates"};
+RelayChannel sconces_channel = {sconces_pin, &sconces_on, "Sconces"};
+RelayChannel crawlspace_channel = {crawlspace_lights_pin, &crawlspace_lights_on, "Crawlspace lights"};
+
 // ──────────────────────────────────────────────────────────────────────────────
 // Forward Declarations (required for MQTT initialization)
 // ──────────────────────────────────────────────────────────────────────────────
 void build_capability_manifest();
 SentientMQTTConfig build_mqtt_config();
 bool build_heartbeat_payload(JsonDocument &doc, void *ctx);
+void handle_dimmer_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx);
+void handle_lab_brightness_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx);
+void handle_lab_color_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx);
+void handle_lab_effect_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx);
+void show_stream_frame(uint32_t strip_mask, void *ctx);
+void handle_relay_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx);
 
 // ──────────────────────────────────────────────────────────────────────────────
 // MQTT Objects
 // ──────────────────────────────────────────────────────────────────────────────
-SentientCapabilityManifest manifest;
+SentientManifestStream manifest(deviceRegistry);
 SentientMQTT mqtt(build_mqtt_config());
 
 // ══════════════════════════════════════════════════════════════════════════════
@@ -229,48 +292,57 @@ void setup()
   digitalWrite(sconces_pin, LOW);
   digitalWrite(crawlspace_lights_pin, LOW);
 
-  // Configure LED strips
-  FastLED.addLeds<WS2812B, ceiling_square_a_pin, GRB>(leds_sa, num_leds_per_strip);
-  FastLED.addLeds<WS2812B, ceiling_square_b_pin, GRB>(leds_sb, num_leds_per_strip);
-  FastLED.addLeds<WS2812B, ceiling_square_c_pin, GRB>(leds_sc, num_leds_per_strip);
-  FastLED.addLeds<WS2812B, ceiling_square_d_pin, GRB>(leds_sd, num_leds_per_strip);
-  FastLED.addLeds<WS2812B, ceiling_square_e_pin, GRB>(leds_se, num_leds_per_strip);
-  FastLED.addLeds<WS2812B, ceiling_square_f_pin, GRB>(leds_sf, num_leds_per_strip);
-  FastLED.addLeds<WS2812B, ceiling_square_g_pin, GRB>(leds_sg, num_leds_per_strip);
-  FastLED.addLeds<WS2812B, ceiling_square_h_pin, GRB>(leds_sh, num_leds_per_strip);
-  FastLED.addLeds<WS2812B, grate_1_pin, GRB>(leds_g1, num_leds_per_strip);
-  FastLED.addLeds<WS2812B, grate_2_pin, GRB>(leds_g2, num_leds_per_strip);
-  FastLED.addLeds<WS2812B, grate_3_pin, GRB>(leds_g3, num_leds_per_strip);
-
-  FastLED.setBrightness(255);
-  fill_solid(leds_sa, num_leds_per_strip, CRGB::Black);
-  fill_solid(leds_sb, num_leds_per_strip, CRGB::Black);
-  fill_solid(leds_sc, num_leds_per_strip, CRGB::Black);
-  fill_solid(leds_sd, num_leds_per_strip, CRGB::Black);
-  fill_solid(leds_se, num_leds_per_strip, CRGB::Black);
-  fill_solid(leds_sf, num_leds_per_strip, CRGB::Black);
-  fill_solid(leds_sg, num_leds_per_strip, CRGB::Black);
-  fill_solid(leds_sh, num_leds_per_strip, CRGB::Black);
-  fill_solid(leds_g1, num_leds_per_strip, CRGB::Black);
-  fill_solid(leds_g2, num_leds_per_strip, CRGB::Black);
-  fill_solid(leds_g3, num_leds_per_strip, CRGB::Black);
-  FastLED.show();
+  // Configure LED strips (squares then grates, matching the zones' first_bus_strip)
+  led_bus.addStrip(ceiling_square_a_pin, leds_squares, num_leds_per_strip);
+  led_bus.addStrip(ceiling_square_b_pin, leds_squares, num_leds_per_strip);
+  led_bus.addStrip(ceiling_square_c_pin, leds_squares, num_leds_per_strip);
+  led_bus.addStrip(ceiling_square_d_pin, leds_squares, num_leds_per_strip);
+  led_bus.addStrip(ceiling_square_e_pin, leds_squares, num_leds_per_strip);
+  led_bus.addStrip(ceiling_square_f_pin, leds_squares, num_leds_per_strip);
+  led_bus.addStrip(ceiling_square_g_pin, leds_squares, num_leds_per_strip);
+  led_bus.addStrip(ceiling_square_h_pin, leds_squares, num_leds_per_strip);
+  led_bus.addStrip(grate_1_pin, leds_grates, num_leds_per_strip);
+  led_bus.addStrip(grate_2_pin, leds_grates, num_leds_per_strip);
+  led_bus.addStrip(grate_3_pin, leds_grates, num_leds_per_strip);
+  led_bus.begin(led_frame, sizeof(led_frame));
+
+  // One segment per zone, mirrored to the zone's bus strips (start out black with the first frame)
+  lab_squares_segment = led_effects.addSegment(leds_squares, num_leds_per_strip, squares_fire_state);
+  lab_grates_segment = led_effects.addSegment(leds_grates, num_leds_per_strip, grates_fire_state);
+  const LabZone *zones[] = {&lab_squares_zone, &lab_grates_zone};
+  for (const LabZone *zone : zones)
+  {
+    for (uint8_t i = 0; i < zone->strip_count; i++)
+    {
+      led_effects.mirrorTo(*zone->segment, led_bus, zone->first_bus_strip + i);
+    }
+  }
+
+  // Stream strip 0 is the squares zone, 1 the grates zone
+  led_stream.addStrip(leds_squares, num_leds_per_strip, 1);
+  led_stream.addStrip(leds_grates, num_leds_per_strip, 3);
+  led_stream.onFrame(show_stream_frame);
 
   Serial.println(F("[MainLighting] Hardware initialized"));
 
   // Register all devices (SINGLE SOURCE OF TRUTH!) — canonical IDs + friendly names
-  Serial.println(F("[MainLighting] Registering devices (canonical)..."));
-  deviceRegistry.addDevice(&dev_study_lights);
-  deviceRegistry.addDevice(&dev_boiler_lights);
-  deviceRegistry.addDevice(&dev_lab_lights_squares);
-  deviceRegistry.addDevice(&dev_lab_lights_grates);
-  deviceRegistry.addDevice(&dev_sconces);
-  deviceRegistry.addDevice(&dev_crawlspace_lights);
   deviceRegistry.printSummary();
 
   // Build capability manifest
   build_capability_manifest();
 
+  // Route device-scoped commands (commands/<controller>/<device>/<command>)
+  mqtt.onCommand(naming::DEV_STUDY_LIGHTS, naming::CMD_STUDY_SET_BRIGHTNESS, handle_dimmer_command, &study_channel);
+  mqtt.onCommand(naming::DEV_BOILER_LIGHTS, naming::CMD_BOILER_SET_BRIGHTNESS, handle_dimmer_command, &boiler_channel);
+  mqtt.onCommand(naming::DEV_LAB_LIGHTS_SQUARES, naming::CMD_LAB_SET_SQUARES_BRIGHTNESS, handle_lab_brightness_command, &lab_squares_zone);
+  mqtt.onCommand(naming::DEV_LAB_LIGHTS_SQUARES, naming::CMD_LAB_SET_SQUARES_COLOR, handle_lab_color_command, &lab_squares_zone);
+  mqtt.onCommand(naming::DEV_LAB_LIGHTS_GRATES, naming::CMD_LAB_SET_GRATES_BRIGHTNESS, handle_lab_brightness_command, &lab_grates_zone);
+  mqtt.onCommand(naming::DEV_LAB_LIGHTS_GRATES, naming::CMD_LAB_SET_GRATES_COLOR, handle_lab_color_command, &lab_grates_zone);
+  mqtt.onCommand(naming::DEV_LAB_LIGHTS_SQUARES, naming::CMD_LAB_SET_SQUARES_EFFECT, handle_lab_effect_command, &lab_squares_zone);
+  mqtt.onCommand(naming::DEV_LAB_LIGHTS_GRATES, naming::CMD_LAB_SET_GRATES_EFFECT, handle_lab_effect_command, &lab_grates_zone);
+  mqtt.onCommands(naming::DEV_SCONCES, sconces_commands, 2, handle_relay_command, &sconces_channel);
+  mqtt.onCommands(naming::DEV_CRAWLSPACE_LIGHTS, crawlspace_lights_commands, 2, handle_relay_command, &crawlspace_channel);
+
   // Initialize MQTT
   Serial.println(F("[MainLighting] Initializing MQTT..."));
   if (!mqtt.begin())
@@ -280,9 +352,9 @@ void setup()
   }
 
   Serial.println(F("[MainLighting] MQTT connected successfully!"));
+  led_stream.begin();
 
   // Set callbacks
-  // We override command routing to parse device + command from topic
   mqtt.setHeartbeatBuilder(build_heartbeat_payload);
 
   // Wait for broker connection (max 5 seconds)
@@ -300,9 +372,9 @@ void setup()
 
     // Register with Sentient system
     Serial.println(F("[MainLighting] Registering with Sentient system..."));
-    if (manifest.publish_registration(mqtt.get_client(), room_id, controller_id))
+    if (manifest.publish_registration(mqtt, room_id, controller_id))
     {
-      Serial.println(F("[MainLighting] Registration successful!"));
+      Serial.println(F("[MainLighting] Registration started"));
     }
     else
     {
@@ -317,270 +389,6 @@ void setup()
     Serial.println(F("[MainLighting] Broker connection timeout - will retry in main loop"));
   }
 
-  // Subscribe to device-scoped commands and set our own message handler
-  {
-    String topic = String(mqtt_namespace) + "/" + room_id + "/" + naming::CAT_COMMANDS + "/" + controller_id + "/+/+";
-    mqtt.get_client().subscribe(topic.c_str());
-    Serial.print(F("[MainLighting] Subscribed (device+command): "));
-    Serial.println(topic);
-    mqtt.get_client().setCallback([](char *topic, uint8_t *payload, unsigned int length)
-                                  {
-      // Parse topic → device + command
-      String device, command;
-      // Extract segments (expect: client/room/commands/controller/device/command)
-      int seg = 0; const char *p = topic;
-      const char *segStart[8] = {nullptr}; size_t segLen[8] = {0};
-      segStart[0] = p;
-      while (*p && seg < 8) { if (*p == '/') { segLen[seg] = p - segStart[seg]; seg++; if (seg < 8) segStart[seg] = p + 1; } p++; }
-      if (seg < 8 && segStart[seg]) { segLen[seg] = p - segStart[seg]; seg++; }
-      auto equalsSeg = [&](int idx, const char *lit) -> bool {
-        size_t litLen = strlen(lit); return segLen[idx] == litLen && strncmp(segStart[idx], lit, litLen) == 0; };
-      if (seg >= 6 && equalsSeg(0, mqtt_namespace) && equalsSeg(1, room_id) && equalsSeg(2, naming::CAT_COMMANDS) && equalsSeg(3, controller_id)) {
-        device = String(segStart[4]).substring(0, segLen[4]);
-        command = String(segStart[5]).substring(0, segLen[5]);
-        // Serial observability for command receipt
-        Serial.print(F("[MainLighting] CMD recv: device="));
-        Serial.print(device);
-        Serial.print(F(" command="));
-        Serial.print(command);
-        Serial.print(F(" payload_len="));
-        Serial.println(length);
-      } else {
-        return; // Not for us
-      }
-
-      // Parse payload (JSON or raw)
-      DynamicJsonDocument doc(256);
-      bool hasJson = false;
-      if (length > 0) {
-        DeserializationError err = deserializeJson(doc, payload, length);
-        hasJson = !err;
-        if (err) {
-          // Note: payload not valid JSON, treat as raw string
-          Serial.println(F("[MainLighting] Payload parse: non-JSON, treating as raw"));
-          doc.clear(); doc["value"] = String((const char *)payload).substring(0, length);
-        }
-      }
-
-      long ack_duration_ms = -1; // will be included in ACK if >= 0
-
-      // Dispatch commands by device
-      // Study Lights
-      if (device == naming::DEV_STUDY_LIGHTS) {
-        if (command == naming::CMD_STUDY_SET_BRIGHTNESS) {
-          int brightness = 255; // default full brightness
-          if (hasJson && !doc["brightness"].isNull()) {
-            brightness = doc["brightness"].as<int>();
-          } else if (hasJson && !doc["value"].isNull()) {
-            brightness = doc["value"].as<int>();
-          }
-          brightness = constrain(brightness, 0, 255);
-          study_dimmer = brightness;
-          analogWrite(study_lights_pin, study_dimmer);
-          Serial.print(F("[MainLighting] Study lights set to: "));
-          Serial.println(study_dimmer);
-          publish_hardware_status();
-        }
-      }
-      // Boiler Room Lights
-      else if (device == naming::DEV_BOILER_LIGHTS) {
-        if (command == naming::CMD_BOILER_SET_BRIGHTNESS) {
-          int brightness = 255; // default full brightness
-          if (hasJson && !doc["brightness"].isNull()) {
-            brightness = doc["brightness"].as<int>();
-          } else if (hasJson && !doc["value"].isNull()) {
-            brightness = doc["value"].as<int>();
-          }
-          brightness = constrain(brightness, 0, 255);
-          boiler_dimmer = brightness;
-          analogWrite(boiler_lights_pin, boiler_dimmer);
-          Serial.print(F("[MainLighting] Boiler lights set to: "));
-          Serial.println(boiler_dimmer);
-          publish_hardware_status();
-        }
-      }
-      // Lab Lights Squares (Ceiling FastLED)
-      else if (device == naming::DEV_LAB_LIGHTS_SQUARES) {
-        if (command == naming::CMD_LAB_SET_SQUARES_BRIGHTNESS) {
-          int brightness = 255; // default full brightness
-          if (hasJson && !doc["brightness"].isNull()) {
-            brightness = doc["brightness"].as<int>();
-          } else if (hasJson && !doc["value"].isNull()) {
-            brightness = doc["value"].as<int>();
-          }
-          brightness = constrain(brightness, 0, 255);
-          lab_squares_brightness = brightness;
-          
-          if (brightness == 0) {
-            // Turn off ceiling squares
-            fill_solid(leds_sa, num_leds_per_strip, CRGB::Black);
-            fill_solid(leds_sb, num_leds_per_strip, CRGB::Black);
-            fill_solid(leds_sc, num_leds_per_strip, CRGB::Black);
-            fill_solid(leds_sd, num_leds_per_strip, CRGB::Black);
-            fill_solid(leds_se, num_leds_per_strip, CRGB::Black);
-            fill_solid(leds_sf, num_leds_per_strip, CRGB::Black);
-            fill_solid(leds_sg, num_leds_per_strip, CRGB::Black);
-            fill_solid(leds_sh, num_leds_per_strip, CRGB::Black);
-            lab_squares_on = false;
-          } else {
-            // Set brightness and turn on with current color
-            FastLED.setBrightness(lab_squares_brightness);
-            fill_solid(leds_sa, num_leds_per_strip, lab_squares_color);
-            fill_solid(leds_sb, num_leds_per_strip, lab_squares_color);
-            fill_solid(leds_sc, num_leds_per_strip, lab_squares_color);
-            fill_solid(leds_sd, num_leds_per_strip, lab_squares_color);
-            fill_solid(leds_se, num_leds_per_strip, lab_squares_color);
-            fill_solid(leds_sf, num_leds_per_strip, lab_squares_color);
-            fill_solid(leds_sg, num_leds_per_strip, lab_squares_color);
-            fill_solid(leds_sh, num_leds_per_strip, lab_squares_color);
-            lab_squares_on = true;
-          }
-          FastLED.show();
-          Serial.print(F("[MainLighting] Lab squares brightness: "));
-          Serial.println(lab_squares_brightness);
-          publish_hardware_status();
-        }
-        else if (command == naming::CMD_LAB_SET_SQUARES_COLOR) {
-          // Parse color from JSON payload
-          if (hasJson && !doc["color"].isNull()) {
-            String colorStr = doc["color"].as<String>();
-            colorStr.toLowerCase();
-            
-            if (colorStr == "yellow") lab_squares_color = CRGB::Yellow;
-            else if (colorStr == "red") lab_squares_color = CRGB::Red;
-            else if (colorStr == "green") lab_squares_color = CRGB::Green;
-            else if (colorStr == "blue") lab_squares_color = CRGB::Blue;
-            else if (colorStr == "white") lab_squares_color = CRGB::White;
-            else if (colorStr == "purple") lab_squares_color = CRGB::Purple;
-            else if (colorStr == "orange") lab_squares_color = CRGB::Orange;
-            else lab_squares_color = CRGB::Yellow; // default
-            
-            // Apply color to ceiling squares if lights are on
-            if (lab_squares_on) {
-              fill_solid(leds_sa, num_leds_per_strip, lab_squares_color);
-              fill_solid(leds_sb, num_leds_per_strip, lab_squares_color);
-              fill_solid(leds_sc, num_leds_per_strip, lab_squares_color);
-              fill_solid(leds_sd, num_leds_per_strip, lab_squares_color);
-              fill_solid(leds_se, num_leds_per_strip, lab_squares_color);
-              fill_solid(leds_sf, num_leds_per_strip, lab_squares_color);
-              fill_solid(leds_sg, num_leds_per_strip, lab_squares_color);
-              fill_solid(leds_sh, num_leds_per_strip, lab_squares_color);
-              FastLED.show();
-            }
-            
-            Serial.print(F("[MainLighting] Lab squares color: "));
-            Serial.println(colorStr);
-            publish_hardware_status();
-          }
-        }
-      }
-      // Lab Lights Grates (Floor FastLED)
-      else if (device == naming::DEV_LAB_LIGHTS_GRATES) {
-        if (command == naming::CMD_LAB_SET_GRATES_BRIGHTNESS) {
-          int brightness = 255; // default full brightness
-          if (hasJson && !doc["brightness"].isNull()) {
-            brightness = doc["brightness"].as<int>();
-          } else if (hasJson && !doc["value"].isNull()) {
-            brightness = doc["value"].as<int>();
-          }
-          brightness = constrain(brightness, 0, 255);
-          lab_grates_brightness = brightness;
-          
-          if (brightness == 0) {
-            // Turn off floor grates
-            fill_solid(leds_g1, num_leds_per_strip, CRGB::Black);
-            fill_solid(leds_g2, num_leds_per_strip, CRGB::Black);
-            fill_solid(leds_g3, num_leds_per_strip, CRGB::Black);
-            lab_grates_on = false;
-          } else {
-            // Set brightness and turn on with current color
-            FastLED.setBrightness(lab_grates_brightness);
-            fill_solid(leds_g1, num_leds_per_strip, lab_grates_color);
-            fill_solid(leds_g2, num_leds_per_strip, lab_grates_color);
-            fill_solid(leds_g3, num_leds_per_strip, lab_grates_color);
-            lab_grates_on = true;
-          }
-          FastLED.show();
-          Serial.print(F("[MainLighting] Lab grates brightness: "));
-          Serial.println(lab_grates_brightness);
-          publish_hardware_status();
-        }
-        else if (command == naming::CMD_LAB_SET_GRATES_COLOR) {
-          // Parse color from JSON payload
-          if (hasJson && !doc["color"].isNull()) {
-            String colorStr = doc["color"].as<String>();
-            colorStr.toLowerCase();
-            
-            if (colorStr == "yellow") lab_grates_color = CRGB::Yellow;
-            else if (colorStr == "red") lab_grates_color = CRGB::Red;
-            else if (colorStr == "green") lab_grates_color = CRGB::Green;
-            else if (colorStr == "blue") lab_grates_color = CRGB::Blue;
-            else if (colorStr == "white") lab_grates_color = CRGB::White;
-            else if (colorStr == "purple") lab_grates_color = CRGB::Purple;
-            else if (colorStr == "orange") lab_grates_color = CRGB::Orange;
-            else lab_grates_color = CRGB::Blue; // default
-            
-            // Apply color to floor grates if lights are on
-            if (lab_grates_on) {
-              fill_solid(leds_g1, num_leds_per_strip, lab_grates_color);
-              fill_solid(leds_g2, num_leds_per_strip, lab_grates_color);
-              fill_solid(leds_g3, num_leds_per_strip, lab_grates_color);
-              FastLED.show();
-            }
-            
-            Serial.print(F("[MainLighting] Lab grates color: "));
-            Serial.println(colorStr);
-            publish_hardware_status();
-          }
-        }
-      }
-      // Sconces
-      else if (device == naming::DEV_SCONCES) {
-        if (command == naming::CMD_SCONCES_ON) {
-          digitalWrite(sconces_pin, HIGH);
-          sconces_on = true;
-          Serial.println(F("[MainLighting] Sconces: ON"));
-          publish_hardware_status();
-        }
-        else if (command == naming::CMD_SCONCES_OFF) {
-          digitalWrite(sconces_pin, LOW);
-          sconces_on = false;
-          Serial.println(F("[MainLighting] Sconces: OFF"));
-          publish_hardware_status();
-        }
-      }
-      // Crawlspace Lights
-      else if (device == naming::DEV_CRAWLSPACE_LIGHTS) {
-        if (command == naming::CMD_CRAWLSPACE_ON) {
-          digitalWrite(crawlspace_lights_pin, HIGH);
-          crawlspace_lights_on = true;
-          Serial.println(F("[MainLighting] Crawlspace lights: ON"));
-          publish_hardware_status();
-        }
-        else if (command == naming::CMD_CRAWLSPACE_OFF) {
-          digitalWrite(crawlspace_lights_pin, LOW);
-          crawlspace_lights_on = false;
-          Serial.println(F("[MainLighting] Crawlspace lights: OFF"));
-          publish_hardware_status();
-        }
-      }
-
-      // Publish command acknowledgement to dedicated acknowledgement topic
-      StaticJsonDocument<160> ack;
-      ack["controller_id"] = controller_id;
-      ack["device_id"] = device;
-      ack["command"] = command;
-      ack["success"] = true;
-      ack["timestamp_ms"] = millis();
-      if (ack_duration_ms >= 0) { ack["duration_ms"] = (long)ack_duration_ms; }
-      char buf[196]; serializeJson(ack, buf, sizeof(buf));
-      // Topic: <tenant>/<room>/acknowledgement/<controller>/<device>/<command>
-      String ackTopic = String(mqtt_namespace) + "/" + room_id + "/" + naming::CAT_ACKNOWLEDGEMENT + "/" + controller_id + "/" + device + "/" + command;
-      mqtt.get_client().publish(ackTopic.c_str(), buf, false);
-      Serial.print(F("[MainLighting] ACK -> "));
-      Serial.println(ackTopic); });
-  }
-
   Serial.println(F("[MainLighting] Ready - awaiting Sentient commands"));
 }
 
@@ -592,26 +400,215 @@ void loop()
 {
   // 1. LISTEN for commands from Sentient
   mqtt.loop();
+  manifest.loop();
 
-  // 2. EXECUTE LED updates (non-blocking)
-  static unsigned long last_led_update = 0;
-  if (millis() - last_led_update >= 20) // Update LEDs every 20ms
-  {
-    FastLED.show();
-    last_led_update = millis();
-  }
+  // 2. EXECUTE LED updates: stream frames land in the zone buffers, effects
+  //    render at the frame rate, and only changed zones are latched and sent
+  //    (non-blocking: DMA sends the frame)
+  led_stream.service();
+  led_effects.service();
 
   // 3. Service MQTT again to ensure heartbeats aren't blocked
   mqtt.loop();
 
-  delay(5);
+  // Effects render every 5 ms at most; commands and stream frames wake it early
+  mqtt.idle(5);
 }
 
 // ══════════════════════════════════════════════════════════════════════════════
-// SECTION 4: (Legacy handler removed) — All commands are routed via topic-based
-//            device+command parsing inside the MQTT callback set in setup().
+// SECTION 4: COMMAND HANDLERS (routed by SentientMQTT on device + command)
 // ══════════════════════════════════════════════════════════════════════════════
 
+// Brightness from {"brightness": n}, {"value": n} or a bare number; full brightness otherwise
+int read_brightness(const JsonDocument &payload)
+{
+  int brightness = 255;
+  if (payload["brightness"].is<int>())
+  {
+    brightness = payload["brightness"].as<int>();
+  }
+  else if (payload["value"].is<int>())
+  {
+    brightness = payload["value"].as<int>();
+  }
+  else if (payload.is<int>())
+  {
+    brightness = payload.as<int>();
+  }
+  return constrain(brightness, 0, 255);
+}
+
+CRGB parse_color(const char *name, CRGB fallback)
+{
+  if (strcasecmp(name, "yellow") == 0)
+    return CRGB::Yellow;
+  if (strcasecmp(name, "red") == 0)
+    return CRGB::Red;
+  if (strcasecmp(name, "green") == 0)
+    return CRGB::Green;
+  if (strcasecmp(name, "blue") == 0)
+    return CRGB::Blue;
+  if (strcasecmp(name, "white") == 0)
+    return CRGB::White;
+  if (strcasecmp(name, "purple") == 0)
+    return CRGB::Purple;
+  if (strcasecmp(name, "orange") == 0)
+    return CRGB::Orange;
+  return fallback;
+}
+
+void set_lab_zone_brightness(const LabZone &zone, uint8_t brightness)
+{
+  for (int i = 0; i < zone.strip_count; i++)
+  {
+    led_bus.setBrightness(zone.first_bus_strip + i, brightness);
+  }
+  led_effects.markDirty(*zone.segment); // Resend at the new brightness
+}
+
+void publish_command_acknowledgement(const SentientCommand &cmd, bool success = true)
+{
+  StaticJsonDocument<160> ack;
+  ack["controller_id"] = controller_id;
+  ack["device_id"] = cmd.deviceId;
+  ack["command"] = cmd.name;
+  ack["success"] = success;
+  ack["timestamp_ms"] = millis();
+  char buf[196];
+  serializeJson(ack, buf, sizeof(buf));
+
+  // Topic: <tenant>/<room>/acknowledgement/<controller>/<device>/<command>
+  char ackTopic[160];
+  snprintf(ackTopic, sizeof(ackTopic), "%s/%s/%s/%s/%s/%s", mqtt_namespace, room_id,
+           naming::CAT_ACKNOWLEDGEMENT, controller_id, cmd.deviceId, cmd.name);
+  mqtt.publishTopic(ackTopic, buf);
+  Serial.print(F("[MainLighting] ACK -> "));
+  Serial.println(ackTopic);
+}
+
+void handle_dimmer_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx)
+{
+  DimmerChannel &channel = *static_cast<DimmerChannel *>(ctx);
+
+  *channel.level = read_brightness(payload);
+  analogWrite(channel.pin, *channel.level);
+  Serial.print(F("[MainLighting] "));
+  Serial.print(channel.label);
+  Serial.print(F(" set to: "));
+  Serial.println(*channel.level);
+  publish_hardware_status();
+  publish_command_acknowledgement(cmd);
+}
+
+void handle_lab_brightness_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx)
+{
+  LabZone &zone = *static_cast<LabZone *>(ctx);
+
+  *zone.brightness = read_brightness(payload);
+  if (*zone.brightness == 0)
+  {
+    led_effects.off(*zone.segment);
+    *zone.on = false;
+  }
+  else
+  {
+    // Set brightness; a dark zone turns on with the current color, a running effect keeps going
+    set_lab_zone_brightness(zone, *zone.brightness);
+    if (!*zone.on)
+    {
+      led_effects.fill(*zone.segment, *zone.color);
+    }
+    *zone.on = true;
+  }
+  Serial.print(F("[MainLighting] "));
+  Serial.print(zone.label);
+  Serial.print(F(" brightness: "));
+  Serial.println(*zone.brightness);
+  publish_hardware_status();
+  publish_command_acknowledgement(cmd);
+}
+
+void handle_lab_color_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx)
+{
+  LabZone &zone = *static_cast<LabZone *>(ctx);
+
+  const char *color = payload["color"];
+  if (color)
+  {
+    *zone.color = parse_color(color, zone.default_color);
+    if (*zone.on)
+    {
+      led_effects.fill(*zone.segment, *zone.color);
+    }
+    Serial.print(F("[MainLighting] "));
+    Serial.print(zone.label);
+    Serial.print(F(" color: "));
+    Serial.println(color);
+    publish_hardware_status();
+  }
+  publish_command_acknowledgement(cmd);
+}
+
+// {"effect": "fire"}, {"effect": "pulse", "color": "blue", "period_ms": 3000}, ...
+void handle_lab_effect_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx)
+{
+  LabZone &zone = *static_cast<LabZone *>(ctx);
+
+  const bool ok = led_effects.configure(*zone.segment, payload.as<JsonVariantConst>());
+  if (ok)
+  {
+    const SentientLedEffectParams &params = led_effects.params(*zone.segment);
+    if (params.effect == SentientLedEffect::Solid)
+    {
+      *zone.color = params.color;
+    }
+    *zone.on = led_effects.lit(*zone.segment);
+  }
+  Serial.print(F("[MainLighting] "));
+  Serial.print(zone.label);
+  Serial.print(F(" effect: "));
+  Serial.println(ok ? SentientLedEffects::effectName(led_effects.params(*zone.segment).effect) : "rejected");
+  publish_hardware_status();
+  publish_command_acknowledgement(cmd, ok);
+}
+
+// A stream frame takes its zones over from the effects until a command
+// sets a new effect; the engine sends the zone with its next frame
+void show_stream_frame(uint32_t strip_mask, void *ctx)
+{
+  LabZone *const zones[] = {&lab_squares_zone, &lab_grates_zone};
+  for (uint8_t i = 0; i < 2; i++)
+  {
+    if (!(strip_mask & (1UL << i)))
+    {
+      continue;
+    }
+    LabZone &zone = *zones[i];
+    if (led_effects.params(*zone.segment).effect != SentientLedEffect::Manual)
+    {
+      SentientLedEffectParams manual = led_effects.params(*zone.segment);
+      manual.effect = SentientLedEffect::Manual;
+      led_effects.setEffect(*zone.segment, manual);
+      *zone.on = true;
+    }
+    led_effects.markDirty(*zone.segment);
+  }
+}
+
+void handle_relay_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx)
+{
+  RelayChannel &channel = *static_cast<RelayChannel *>(ctx);
+
+  // Command lists are {on, off}
+  *channel.on = cmd.index == 0;
+  digitalWrite(channel.pin, *channel.on ? HIGH : LOW);
+  Serial.print(F("[MainLighting] "));
+  Serial.print(channel.label);
+  Serial.println(*channel.on ? F(": ON") : F(": OFF"));
+  publish_hardware_status();
+  publish_command_acknowledgement(cmd);
+}
+
 // ══════════════════════════════════════════════════════════════════════════════
 // SECTION 5: ALL OTHER FUNCTIONS
 // ══════════════════════════════════════════════════════════════════════════════
@@ -629,9 +626,6 @@ void build_capability_manifest()
       room_id,
       controller_id);
 
-  // Auto-generate entire manifest from device registry - ONE LINE!
-  deviceRegistry.buildManifest(manifest);
-
   // That's it! No manual device/topic registration needed!
   // All devices and topics are defined once in the Device Registry section above.
 }
@@ -695,8 +689,12 @@ void publish_hardware_status()
   doc["lab_squares_brightness"] = lab_squares_brightness;
   doc["lab_grates_on"] = lab_grates_on;
   doc["lab_grates_brightness"] = lab_grates_brightness;
+  doc["lab_squares_effect"] = SentientLedEffects::effectName(led_effects.params(lab_squares_segment).effect);
+  doc["lab_grates_effect"] = SentientLedEffects::effectName(led_effects.params(lab_grates_segment).effect);
   doc["sconces"] = sconces_on;
   doc["crawlspace"] = crawlspace_lights_on;
+  doc["led_stream_active"] = led_stream.active();
+  doc["led_stream_fps"] = led_stream.framesPerSecond();
   doc["ts"] = millis();
 
   mqtt.publishJson("status", "hardware", doc);
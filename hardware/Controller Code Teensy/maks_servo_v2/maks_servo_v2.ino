@@ -4,7 +4,7 @@
 // ══════════════════════════════════════════════════════════════════════════════
 
 #include <SentientMQTT.h>
-#include <SentientCapabilityManifest.h>
+#include <SentientManifestStream.h>
 #include <SentientDeviceRegistry.h>
 #include <ArduinoJson.h>
 #include <PWMServo.h>
@@ -42,10 +42,11 @@ int current_position = CLOSED_POSITION;
 // DEVICE REGISTRY
 // ══════════════════════════════════════════════════════════════════════════════
 
-const char *servo_commands[] = {naming::CMD_OPEN, naming::CMD_CLOSE, naming::CMD_SET_POSITION};
-SentientDeviceDef dev_servo(naming::DEV_SERVO, naming::FRIENDLY_SERVO, "servo", servo_commands, 3);
+constexpr const char *servo_commands[] PROGMEM = {naming::CMD_OPEN, naming::CMD_CLOSE, naming::CMD_SET_POSITION};
+constexpr SentientDeviceDef dev_servo PROGMEM(naming::DEV_SERVO, naming::FRIENDLY_SERVO, "servo", servo_commands, 3);
 
-SentientDeviceRegistry deviceRegistry;
+SENTIENT_DEVICE_REGISTRY(deviceRegistry,
+    &dev_servo);
 
 // ══════════════════════════════════════════════════════════════════════════════
 // SENTIENT MQTT INITIALIZATION
@@ -71,7 +72,7 @@ SentientMQTTConfig make_mqtt_config()
 }
 
 SentientMQTT sentient(make_mqtt_config());
-SentientCapabilityManifest manifest;
+SentientManifestStream manifest(deviceRegistry);
 
 void handle_mqtt_command(const char *command, const JsonDocument &payload, void *ctx);
 void publish_command_acknowledgement(const char *device_id, const char *command);
@@ -92,12 +93,10 @@ void setup()
     delay(2000);
     Serial.println(F("[MaksServo] Starting..."));
 
-    deviceRegistry.addDevice(&dev_servo);
     deviceRegistry.printSummary();
 
     manifest.set_controller_info(naming::CONTROLLER_ID, naming::CONTROLLER_FRIENDLY_NAME,
                                  firmware::VERSION, naming::ROOM_ID, naming::CONTROLLER_ID);
-    deviceRegistry.buildManifest(manifest);
 
     sentient.begin();
     sentient.setCommandCallback(handle_mqtt_command);
@@ -111,7 +110,7 @@ void setup()
 
     if (sentient.isConnected())
     {
-        manifest.publish_registration(sentient.get_client(), naming::ROOM_ID, naming::CONTROLLER_ID);
+        manifest.publish_registration(sentient, naming::ROOM_ID, naming::CONTROLLER_ID);
     }
 
     Serial.println(F("[MaksServo] Ready"));
@@ -124,7 +123,10 @@ void setup()
 void loop()
 {
     sentient.loop();
-    delay(100);
+    manifest.loop();
+
+    // Sleep until a command or a library deadline instead of a fixed delay
+    sentient.idle(100);
 }
 
 // ══════════════════════════════════════════════════════════════════════════════
@@ -193,7 +195,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
                       String(naming::CAT_ACKNOWLEDGEMENT) + "/" + String(naming::CONTROLLER_ID) + "/" +
                       String(device_id) + "/" + String(command);
 
-    sentient.get_client().publish(ackTopic.c_str(), buf, false);
+    sentient.publishTopic(ackTopic.c_str(), buf);
 
     Serial.print(F("[ACK] -> "));
     Serial.println(ackTopic);
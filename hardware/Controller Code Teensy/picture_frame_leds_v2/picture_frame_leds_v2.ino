@@ -4,10 +4,11 @@
 // ══════════════════════════════════════════════════════════════════════════════
 
 #include <SentientMQTT.h>
-#include <SentientCapabilityManifest.h>
+#include <SentientManifestStream.h>
 #include <SentientDeviceRegistry.h>
 #include <ArduinoJson.h>
-#include <Adafruit_NeoPixel.h>
+#include <SentientLedBus.h>
+#include <SentientLedStream.h>
 #include "controller_naming.h"
 
 // ══════════════════════════════════════════════════════════════════════════════
@@ -57,7 +58,14 @@ const unsigned long heartbeat_interval_ms = 5000;
 // STATE MANAGEMENT
 // ══════════════════════════════════════════════════════════════════════════════
 
-Adafruit_NeoPixel strips[NUM_STRIPS];
+// All 32 strips go out in parallel over DMA; leds[] is the draw buffer
+CRGB leds[NUM_STRIPS][NUM_LEDS_PER_STRIP];
+DMAMEM uint8_t led_frame[SENTIENT_LED_FRAME_BYTES(NUM_STRIPS, NUM_LEDS_PER_STRIP)];
+SentientLedBus led_bus(NUM_LEDS_PER_STRIP);
+
+// Show-control stream: one universe per TV (1-4), its 8 strips packed in
+// order; DDP sees all 32 strips back to back. Stream strip i is bus strip i.
+SentientLedStream led_stream;
 bool tv_power[4] = {true, true, true, true};
 uint8_t tv_brightness[4] = {10, 10, 10, 10};
 TVColor current_colors[4];
@@ -66,15 +74,33 @@ TVColor current_colors[4];
 // DEVICE REGISTRY
 // ══════════════════════════════════════════════════════════════════════════════
 
-const char *tv_commands[] = {naming::CMD_POWER_ON, naming::CMD_POWER_OFF, naming::CMD_SET_COLOR, naming::CMD_SET_BRIGHTNESS, naming::CMD_FLICKER};
+constexpr const char *tv_commands[] PROGMEM = {naming::CMD_POWER_ON, naming::CMD_POWER_OFF, naming::CMD_SET_COLOR, naming::CMD_SET_BRIGHTNESS, naming::CMD_FLICKER};
+
+constexpr SentientDeviceDef dev_tv_vincent PROGMEM(naming::DEV_TV_VINCENT, "Vincent TV LEDs", "led_strip", tv_commands, 5);
+constexpr SentientDeviceDef dev_tv_edith PROGMEM(naming::DEV_TV_EDITH, "Edith TV LEDs", "led_strip", tv_commands, 5);
+constexpr SentientDeviceDef dev_tv_maks PROGMEM(naming::DEV_TV_MAKS, "Maks TV LEDs", "led_strip", tv_commands, 5);
+constexpr SentientDeviceDef dev_tv_oliver PROGMEM(naming::DEV_TV_OLIVER, "Oliver TV LEDs", "led_strip", tv_commands, 5);
+constexpr SentientDeviceDef dev_all_tvs PROGMEM(naming::DEV_ALL_TVS, "All TVs", "led_strip", tv_commands, 5);
 
-SentientDeviceDef dev_tv_vincent(naming::DEV_TV_VINCENT, "Vincent TV LEDs", "led_strip", tv_commands, 5);
-SentientDeviceDef dev_tv_edith(naming::DEV_TV_EDITH, "Edith TV LEDs", "led_strip", tv_commands, 5);
-SentientDeviceDef dev_tv_maks(naming::DEV_TV_MAKS, "Maks TV LEDs", "led_strip", tv_commands, 5);
-SentientDeviceDef dev_tv_oliver(naming::DEV_TV_OLIVER, "Oliver TV LEDs", "led_strip", tv_commands, 5);
-SentientDeviceDef dev_all_tvs(naming::DEV_ALL_TVS, "All TVs", "led_strip", tv_commands, 5);
+SENTIENT_DEVICE_REGISTRY(deviceRegistry,
+    &dev_tv_vincent,
+    &dev_tv_edith,
+    &dev_tv_maks,
+    &dev_tv_oliver,
+    &dev_all_tvs);
 
-SentientDeviceRegistry deviceRegistry;
+// TVs addressed by each device (command routing context)
+struct TVRange
+{
+    int first;
+    int last;
+};
+
+TVRange vincent_tvs = {0, 0};
+TVRange edith_tvs = {1, 1};
+TVRange maks_tvs = {2, 2};
+TVRange oliver_tvs = {3, 3};
+TVRange all_tvs = {0, 3};
 
 // ══════════════════════════════════════════════════════════════════════════════
 // SENTIENT MQTT INITIALIZATION
@@ -100,13 +126,14 @@ SentientMQTTConfig make_mqtt_config()
 }
 
 SentientMQTT sentient(make_mqtt_config());
-SentientCapabilityManifest manifest;
+SentientManifestStream manifest(deviceRegistry);
 
-void handle_mqtt_command(const char *command, const JsonDocument &payload, void *ctx);
+void handle_tv_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx);
 void publish_command_acknowledgement(const char *device_id, const char *command);
 void set_tv_color(int tv_index, uint8_t r, uint8_t g, uint8_t b);
 void set_tv_power(int tv_index, bool on);
 void set_tv_brightness(int tv_index, uint8_t brightness);
+void show_stream_frame(uint32_t strip_mask, void *ctx);
 
 // ══════════════════════════════════════════════════════════════════════════════
 // SETUP
@@ -117,15 +144,16 @@ void setup()
     pinMode(PIN_POWER_LED, OUTPUT);
     digitalWrite(PIN_POWER_LED, HIGH);
 
-    // Initialize all NeoPixel strips
+    // Initialize all LED strips (cleared)
     for (int i = 0; i < NUM_STRIPS; i++)
     {
-        strips[i] = Adafruit_NeoPixel(NUM_LEDS_PER_STRIP, TV_PINS[i], NEO_GRB + NEO_KHZ800);
-        strips[i].begin();
-        strips[i].setBrightness(10);
-        strips[i].clear();
-        strips[i].show();
+        led_bus.addStrip(TV_PINS[i], leds[i], NUM_LEDS_PER_STRIP);
+        led_stream.addStrip(leds[i], NUM_LEDS_PER_STRIP, i % STRIPS_PER_TV == 0 ? i / STRIPS_PER_TV + 1 : 0);
     }
+    led_stream.onFrame(show_stream_frame);
+    led_bus.setBrightness(10);
+    led_bus.begin(led_frame, sizeof(led_frame));
+    led_bus.show();
 
     // Set default colors
     for (int i = 0; i < 4; i++)
@@ -137,19 +165,19 @@ void setup()
     delay(2000);
     Serial.println(F("[PictureFrameLEDs] Starting..."));
 
-    deviceRegistry.addDevice(&dev_tv_vincent);
-    deviceRegistry.addDevice(&dev_tv_edith);
-    deviceRegistry.addDevice(&dev_tv_maks);
-    deviceRegistry.addDevice(&dev_tv_oliver);
-    deviceRegistry.addDevice(&dev_all_tvs);
     deviceRegistry.printSummary();
 
     manifest.set_controller_info(naming::CONTROLLER_ID, naming::CONTROLLER_FRIENDLY_NAME,
                                  firmware::VERSION, naming::ROOM_ID, naming::CONTROLLER_ID);
-    deviceRegistry.buildManifest(manifest);
+
+    sentient.onCommands(naming::DEV_TV_VINCENT, tv_commands, 5, handle_tv_command, &vincent_tvs);
+    sentient.onCommands(naming::DEV_TV_EDITH, tv_commands, 5, handle_tv_command, &edith_tvs);
+    sentient.onCommands(naming::DEV_TV_MAKS, tv_commands, 5, handle_tv_command, &maks_tvs);
+    sentient.onCommands(naming::DEV_TV_OLIVER, tv_commands, 5, handle_tv_command, &oliver_tvs);
+    sentient.onCommands(naming::DEV_ALL_TVS, tv_commands, 5, handle_tv_command, &all_tvs);
 
     sentient.begin();
-    sentient.setCommandCallback(handle_mqtt_command);
+    led_stream.begin();
 
     unsigned long connection_start = millis();
     while (!sentient.isConnected() && (millis() - connection_start < 5000))
@@ -160,7 +188,7 @@ void setup()
 
     if (sentient.isConnected())
     {
-        manifest.publish_registration(sentient.get_client(), naming::ROOM_ID, naming::CONTROLLER_ID);
+        manifest.publish_registration(sentient, naming::ROOM_ID, naming::CONTROLLER_ID);
     }
 
     // Initialize with default colors
@@ -180,67 +208,52 @@ void setup()
 void loop()
 {
     sentient.loop();
-    delay(50);
+    manifest.loop();
+    led_stream.service();
+
+    // Stream frames and commands both arrive as Ethernet frames, which end
+    // the sleep, so there is no need to stay awake while a stream runs
+    sentient.idle(50);
 }
 
 // ══════════════════════════════════════════════════════════════════════════════
 // COMMAND HANDLER
 // ══════════════════════════════════════════════════════════════════════════════
 
-void handle_mqtt_command(const char *command, const JsonDocument &payload, void *ctx)
+// Indices into tv_commands
+enum TVCommand
 {
-    if (!payload["device_id"].is<const char *>())
-        return;
-
-    const char *device_id = payload["device_id"];
-
-    // Determine which TV(s) to control
-    int tv_start = -1, tv_end = -1;
-
-    if (strcmp(device_id, naming::DEV_TV_VINCENT) == 0)
-    {
-        tv_start = tv_end = 0;
-    }
-    else if (strcmp(device_id, naming::DEV_TV_EDITH) == 0)
-    {
-        tv_start = tv_end = 1;
-    }
-    else if (strcmp(device_id, naming::DEV_TV_MAKS) == 0)
-    {
-        tv_start = tv_end = 2;
-    }
-    else if (strcmp(device_id, naming::DEV_TV_OLIVER) == 0)
-    {
-        tv_start = tv_end = 3;
-    }
-    else if (strcmp(device_id, naming::DEV_ALL_TVS) == 0)
-    {
-        tv_start = 0;
-        tv_end = 3;
-    }
+    TV_POWER_ON,
+    TV_POWER_OFF,
+    TV_SET_COLOR,
+    TV_SET_BRIGHTNESS,
+    TV_FLICKER
+};
 
-    if (tv_start == -1)
-        return;
+void handle_tv_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx)
+{
+    const TVRange &range = *static_cast<const TVRange *>(ctx);
+    const int tv_start = range.first;
+    const int tv_end = range.last;
 
     // Execute command on selected TV(s)
     for (int tv = tv_start; tv <= tv_end; tv++)
     {
-        if (strcmp(command, naming::CMD_POWER_ON) == 0)
+        switch (cmd.index)
         {
+        case TV_POWER_ON:
             set_tv_power(tv, true);
             Serial.print(F("[CMD] TV "));
             Serial.print(tv);
             Serial.println(F(" ON"));
-        }
-        else if (strcmp(command, naming::CMD_POWER_OFF) == 0)
-        {
+            break;
+        case TV_POWER_OFF:
             set_tv_power(tv, false);
             Serial.print(F("[CMD] TV "));
             Serial.print(tv);
             Serial.println(F(" OFF"));
-        }
-        else if (strcmp(command, naming::CMD_SET_COLOR) == 0)
-        {
+            break;
+        case TV_SET_COLOR:
             if (payload["r"].is<int>() && payload["g"].is<int>() && payload["b"].is<int>())
             {
                 uint8_t r = payload["r"];
@@ -256,18 +269,19 @@ void handle_mqtt_command(const char *command, const JsonDocument &payload, void
                 Serial.print(F(","));
                 Serial.println(b);
             }
-        }
-        else if (strcmp(command, naming::CMD_SET_BRIGHTNESS) == 0 && payload["brightness"].is<int>())
-        {
-            uint8_t brightness = payload["brightness"];
-            set_tv_brightness(tv, brightness);
-            Serial.print(F("[CMD] TV "));
-            Serial.print(tv);
-            Serial.print(F(" brightness: "));
-            Serial.println(brightness);
-        }
-        else if (strcmp(command, naming::CMD_FLICKER) == 0)
-        {
+            break;
+        case TV_SET_BRIGHTNESS:
+            if (payload["brightness"].is<int>())
+            {
+                uint8_t brightness = payload["brightness"];
+                set_tv_brightness(tv, brightness);
+                Serial.print(F("[CMD] TV "));
+                Serial.print(tv);
+                Serial.print(F(" brightness: "));
+                Serial.println(brightness);
+            }
+            break;
+        case TV_FLICKER:
             // Simple flicker effect
             for (int i = 0; i < 5; i++)
             {
@@ -279,11 +293,12 @@ void handle_mqtt_command(const char *command, const JsonDocument &payload, void
             Serial.print(F("[CMD] TV "));
             Serial.print(tv);
             Serial.println(F(" flickered"));
+            break;
         }
     }
 
     // Publish acknowledgement for successful command
-    publish_command_acknowledgement(device_id, command);
+    publish_command_acknowledgement(cmd.deviceId, cmd.name);
 }
 
 // ══════════════════════════════════════════════════════════════════════════════
@@ -310,7 +325,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
                       String(naming::CAT_ACKNOWLEDGEMENT) + "/" + String(naming::CONTROLLER_ID) + "/" +
                       String(device_id) + "/" + String(command);
 
-    sentient.get_client().publish(ackTopic.c_str(), buf, false);
+    sentient.publishTopic(ackTopic.c_str(), buf);
 
     Serial.print(F("[ACK] -> "));
     Serial.println(ackTopic);
@@ -331,13 +346,9 @@ void set_tv_color(int tv_index, uint8_t r, uint8_t g, uint8_t b)
 
         for (int strip = strip_start; strip < strip_end; strip++)
         {
-            uint32_t color = strips[strip].Color(r, g, b);
-            for (int led = 0; led < NUM_LEDS_PER_STRIP; led++)
-            {
-                strips[strip].setPixelColor(led, color);
-            }
-            strips[strip].show();
+            fill_solid(leds[strip], NUM_LEDS_PER_STRIP, CRGB(r, g, b));
         }
+        led_bus.show();
     }
 }
 
@@ -348,24 +359,13 @@ void set_tv_power(int tv_index, bool on)
     int strip_start = tv_index * STRIPS_PER_TV;
     int strip_end = strip_start + STRIPS_PER_TV;
 
+    const CRGB color = on ? CRGB(current_colors[tv_index].r, current_colors[tv_index].g, current_colors[tv_index].b)
+                          : CRGB(CRGB::Black);
     for (int strip = strip_start; strip < strip_end; strip++)
     {
-        if (on)
-        {
-            uint32_t color = strips[strip].Color(current_colors[tv_index].r,
-                                                 current_colors[tv_index].g,
-                                                 current_colors[tv_index].b);
-            for (int led = 0; led < NUM_LEDS_PER_STRIP; led++)
-            {
-                strips[strip].setPixelColor(led, color);
-            }
-        }
-        else
-        {
-            strips[strip].clear();
-        }
-        strips[strip].show();
+        fill_solid(leds[strip], NUM_LEDS_PER_STRIP, color);
     }
+    led_bus.show();
 }
 
 void set_tv_brightness(int tv_index, uint8_t brightness)
@@ -377,7 +377,12 @@ void set_tv_brightness(int tv_index, uint8_t brightness)
 
     for (int strip = strip_start; strip < strip_end; strip++)
     {
-        strips[strip].setBrightness(brightness);
-        strips[strip].show();
+        led_bus.setBrightness(strip, brightness);
     }
+    led_bus.show();
+}
+
+void show_stream_frame(uint32_t strip_mask, void *ctx)
+{
+    led_bus.show(strip_mask);
 }
@@ -38,7 +38,6 @@ SentientMQTTConfig build_mqtt_config()
 
 SentientMQTT sentient(build_mqtt_config());
 SentientCapabilityManifest manifest;
-SentientDeviceRegistry deviceRegistry;
 
 void build_capability_manifest()
 {
@@ -131,7 +130,7 @@ void loop()
   if (!registered && sentient.isConnected())
   {
     Serial.println("[Pilaster] Registering with Sentient system...");
-    if (manifest.publish_registration(sentient.get_client(), ROOM_ID, CONTROLLER_ID))
+    if (manifest.publish_registration(sentient, ROOM_ID, CONTROLLER_ID))
     {
       Serial.println("[Pilaster] Registration successful!");
       registered = true;
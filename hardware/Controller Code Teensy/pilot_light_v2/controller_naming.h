@@ -51,6 +51,8 @@ namespace naming
     // Flange LEDs
     constexpr const char *CMD_FLANGE_ON = "flange_on";
     constexpr const char *CMD_FLANGE_OFF = "flange_off";
+    // Both LED devices: effect + parameters in the payload
+    constexpr const char *CMD_SET_EFFECT = "set_effect";
     // Controller-level commands
     constexpr const char *CMD_RESET = "reset";
     constexpr const char *CMD_REQUEST_STATUS = "request_status";
@@ -68,6 +70,8 @@ namespace naming
     // Flange LEDs
     constexpr const char *FRIENDLY_CMD_FLANGE_ON = "Flange LEDs On";
     constexpr const char *FRIENDLY_CMD_FLANGE_OFF = "Flange LEDs Off";
+    // Both LED devices
+    constexpr const char *FRIENDLY_CMD_SET_EFFECT = "Set LED Effect";
     // Controller-level commands
     constexpr const char *FRIENDLY_CMD_RESET = "Reset All Hardware";
     constexpr const char *FRIENDLY_CMD_REQUEST_STATUS = "Request Status";
@@ -26,11 +26,12 @@
 #define MQTT_MAX_PACKET_SIZE 1024 // Raised for larger control/registration packets
 #endif
 
-#include <SentientCapabilityManifest.h>
+#include <SentientManifestStream.h>
 #include <SentientMQTT.h>
 #include <SentientDeviceRegistry.h>
 #include <ArduinoJson.h>
 #include <FastLED.h>
+#include <SentientLedEffects.h>
 #include <Adafruit_TCS34725.h>
 #include <Wire.h>
 #if __has_include(<NativeEthernet.h>)
@@ -70,6 +71,7 @@ const int led_flange_pin = 24;     // Flange Status LED Strip
 // Configuration Constants
 // ──────────────────────────────────────────────────────────────────────────────
 const int num_leds = 34;
+const uint8_t led_frames_per_second = 60;
 const unsigned long heartbeat_interval_ms = 5000;
 const int color_temp_threshold = 50; // Change detection threshold for color sensor
 const int lux_threshold = 10;        // Change detection threshold for lux
@@ -96,17 +98,25 @@ bool manual_heartbeat_requested = false;
 // ──────────────────────────────────────────────────────────────────────────────
 // Hardware Objects
 // ──────────────────────────────────────────────────────────────────────────────
-// LED arrays
-CRGB leds_b1s1[num_leds];
-CRGB leds_b1s2[num_leds];
-CRGB leds_b1s3[num_leds];
-CRGB leds_b2s1[num_leds];
-CRGB leds_b2s2[num_leds];
-CRGB leds_b2s3[num_leds];
+// LED buffers: the six boiler strips mirror one fire buffer
+CRGB leds_fire[num_leds];
+uint8_t fire_state[SENTIENT_LED_FIRE_STATE_BYTES(num_leds)];
 CRGB leds_flange[num_leds];
-CRGBPalette16 fire_palette;
-int heat[num_leds];
-int flame[num_leds];
+
+// Effect engine: fixed frame rate, strips only sent when their pixels changed
+SentientLedEffects led_effects(led_frames_per_second);
+int fire_segment = -1;
+int flange_segment = -1;
+
+// Command routing context for each LED device's set_effect
+struct LedChannel
+{
+    int *segment;
+    bool *on;
+    const char *label;
+};
+LedChannel fire_channel = {&fire_segment, &fire_leds_active, "Fire LEDs"};
+LedChannel flange_channel = {&flange_segment, &flange_leds_on, "Flange LEDs"};
 
 // Sensor hardware
 Adafruit_TCS34725 tcs(TCS34725_INTEGRATIONTIME_154MS, TCS34725_GAIN_1X);
@@ -121,70 +131,78 @@ const unsigned long sensor_publish_interval_ms = 60000; // Publish every 60 seco
 // ============================================================================
 
 // Define command arrays
-const char *fire_leds_commands[] = {
+constexpr const char *fire_leds_commands[] PROGMEM = {
     naming::CMD_FIRE_LEDS_ON,
-    naming::CMD_FIRE_LEDS_OFF};
+    naming::CMD_FIRE_LEDS_OFF,
+    naming::CMD_SET_EFFECT};
 
-const char *monitor_commands[] = {
+constexpr const char *monitor_commands[] PROGMEM = {
     naming::CMD_MONITOR_ON,
     naming::CMD_MONITOR_OFF};
 
-const char *newell_commands[] = {
+constexpr const char *newell_commands[] PROGMEM = {
     naming::CMD_NEWELL_POWER_ON,
     naming::CMD_NEWELL_POWER_OFF};
 
-const char *flange_commands[] = {
+constexpr const char *flange_commands[] PROGMEM = {
     naming::CMD_FLANGE_ON,
-    naming::CMD_FLANGE_OFF};
+    naming::CMD_FLANGE_OFF,
+    naming::CMD_SET_EFFECT};
 
-const char *controller_commands[] = {
+constexpr const char *controller_commands[] PROGMEM = {
     naming::CMD_RESET,
     naming::CMD_REQUEST_STATUS};
 
 // Define sensor arrays
-const char *color_sensor_sensors[] = {
+constexpr const char *color_sensor_sensors[] PROGMEM = {
     naming::SENSOR_COLOR_TEMP,
     naming::SENSOR_LUX};
 
 // Create device definitions with canonical IDs and friendly names
-SentientDeviceDef dev_fire_leds(
+constexpr SentientDeviceDef dev_fire_leds PROGMEM(
     naming::DEV_FIRE_LEDS,
     naming::FRIENDLY_FIRE_LEDS,
     "led_strip",
-    fire_leds_commands, 2);
+    fire_leds_commands, 3);
 
-SentientDeviceDef dev_monitor_relay(
+constexpr SentientDeviceDef dev_monitor_relay PROGMEM(
     naming::DEV_MONITOR_POWER_RELAY,
     naming::FRIENDLY_MONITOR_RELAY,
     "relay",
     monitor_commands, 2);
 
-SentientDeviceDef dev_newell_relay(
+constexpr SentientDeviceDef dev_newell_relay PROGMEM(
     naming::DEV_NEWELL_POWER_RELAY,
     naming::FRIENDLY_NEWELL_RELAY,
     "relay",
     newell_commands, 2);
 
-SentientDeviceDef dev_flange_leds(
+constexpr SentientDeviceDef dev_flange_leds PROGMEM(
     naming::DEV_FLANGE_LEDS,
     naming::FRIENDLY_FLANGE_LEDS,
     "led_strip",
-    flange_commands, 2);
+    flange_commands, 3);
 
-SentientDeviceDef dev_color_sensor(
+constexpr SentientDeviceDef dev_color_sensor PROGMEM(
     naming::DEV_PILOTLIGHT_COLOR_SENSOR,
     naming::FRIENDLY_COLOR_SENSOR,
     "sensor",
     color_sensor_sensors, 2, true); // true = input device
 
-SentientDeviceDef dev_controller(
+constexpr SentientDeviceDef dev_controller PROGMEM(
     naming::DEV_CONTROLLER,
     naming::FRIENDLY_CONTROLLER,
     "controller",
     controller_commands, 2);
 
 // Create the device registry
-SentientDeviceRegistry deviceRegistry;
+SENTIENT_DEVICE_REGISTRY(deviceRegistry,
+    &dev_fire_leds,
+    &dev_monitor_relay,
+    &dev_newell_relay,
+    &dev_flange_leds,
+    &dev_color_sensor,
+    &dev_controller);
 
 // ──────────────────────────────────────────────────────────────────────────────
 // Forward Declarations
@@ -193,8 +211,9 @@ void build_capability_manifest();
 SentientMQTTConfig build_mqtt_config();
 bool build_heartbeat_payload(JsonDocument &doc, void *ctx);
 void handle_mqtt_command(const char *command, const JsonDocument &payload, void *ctx);
-void publish_command_acknowledgement(const char *device_id, const char *command);
-void fill_fire_frame();
+void handle_effect_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx);
+void publish_command_acknowledgement(const char *device_id, const char *command, bool success = true);
+void start_fire();
 void check_and_publish_sensor_changes();
 void publish_hardware_status();
 void publish_full_status();
@@ -205,7 +224,7 @@ bool parse_truth(const String &value);
 String extract_command_value(const JsonDocument &payload);
 
 // MQTT objects
-SentientCapabilityManifest manifest;
+SentientManifestStream manifest(deviceRegistry);
 SentientMQTT mqtt(build_mqtt_config());
 
 // ──────────────────────────────────────────────────────────────────────────────
@@ -294,23 +313,23 @@ void setup()
     digitalWrite(boiler_monitor_pin, LOW);
     digitalWrite(newell_power_pin, HIGH); // Newell defaults to ON
 
-    // Initialize LED strips
-    FastLED.addLeds<WS2812B, led_pin_a, GRB>(leds_b1s1, num_leds);
-    FastLED.addLeds<WS2812B, led_pin_b, GRB>(leds_b1s2, num_leds);
-    FastLED.addLeds<WS2812B, led_pin_c, GRB>(leds_b1s3, num_leds);
-    FastLED.addLeds<WS2812B, led_pin_d, GRB>(leds_b2s1, num_leds);
-    FastLED.addLeds<WS2812B, led_pin_e, GRB>(leds_b2s2, num_leds);
-    FastLED.addLeds<WS2812B, led_pin_f, GRB>(leds_b2s3, num_leds);
-    FastLED.addLeds<WS2812B, led_flange_pin, GRB>(leds_flange, num_leds);
+    // Initialize LED strips: one controller per pin, the boiler pins all on the fire buffer
+    fire_segment = led_effects.addSegment(leds_fire, num_leds, fire_state);
+    led_effects.mirrorTo(fire_segment, FastLED.addLeds<WS2812B, led_pin_a, GRB>(leds_fire, num_leds));
+    led_effects.mirrorTo(fire_segment, FastLED.addLeds<WS2812B, led_pin_b, GRB>(leds_fire, num_leds));
+    led_effects.mirrorTo(fire_segment, FastLED.addLeds<WS2812B, led_pin_c, GRB>(leds_fire, num_leds));
+    led_effects.mirrorTo(fire_segment, FastLED.addLeds<WS2812B, led_pin_d, GRB>(leds_fire, num_leds));
+    led_effects.mirrorTo(fire_segment, FastLED.addLeds<WS2812B, led_pin_e, GRB>(leds_fire, num_leds));
+    led_effects.mirrorTo(fire_segment, FastLED.addLeds<WS2812B, led_pin_f, GRB>(leds_fire, num_leds));
+    flange_segment = led_effects.addSegment(leds_flange, num_leds);
+    led_effects.mirrorTo(flange_segment, FastLED.addLeds<WS2812B, led_flange_pin, GRB>(leds_flange, num_leds));
     FastLED.setBrightness(250);
 
-    fire_palette = CRGBPalette16(0x3A79EB, 0x6495ED, 0xFC6000);
-    randomSeed(analogRead(A0));
+    random16_add_entropy(analogRead(A0));
 
-    // Set initial LED state
-    FastLED.clear();
-    fill_solid(leds_flange, num_leds, CRGB::Green);
-    FastLED.show();
+    // Set initial LED state (sent with the first frame)
+    led_effects.off(fire_segment);
+    led_effects.fill(flange_segment, CRGB::Green);
 
     // Try to initialize color sensor
     color_sensor_available = tcs.begin();
@@ -318,13 +337,6 @@ void setup()
     Serial.println(color_sensor_available ? F("found") : F("missing"));
 
     // Register all devices (SINGLE SOURCE OF TRUTH!)
-    Serial.println(F("[PilotLight] Registering devices..."));
-    deviceRegistry.addDevice(&dev_fire_leds);
-    deviceRegistry.addDevice(&dev_monitor_relay);
-    deviceRegistry.addDevice(&dev_newell_relay);
-    deviceRegistry.addDevice(&dev_flange_leds);
-    deviceRegistry.addDevice(&dev_color_sensor);
-    deviceRegistry.addDevice(&dev_controller);
     deviceRegistry.printSummary();
 
     // Build capability manifest
@@ -342,6 +354,8 @@ void setup()
     {
         Serial.println(F("[PilotLight] MQTT initialization successful"));
         debug_network(); // Immediate network diagnostics
+        mqtt.onCommand(naming::DEV_FIRE_LEDS, naming::CMD_SET_EFFECT, handle_effect_command, &fire_channel);
+        mqtt.onCommand(naming::DEV_FLANGE_LEDS, naming::CMD_SET_EFFECT, handle_effect_command, &flange_channel);
         mqtt.setCommandCallback(handle_mqtt_command);
         mqtt.setHeartbeatBuilder(build_heartbeat_payload);
 
@@ -360,9 +374,9 @@ void setup()
 
             // Register with Sentient system
             Serial.println(F("[PilotLight] Registering with Sentient system..."));
-            if (manifest.publish_registration(mqtt.get_client(), naming::ROOM_ID, naming::CONTROLLER_ID))
+            if (manifest.publish_registration(mqtt, naming::ROOM_ID, naming::CONTROLLER_ID))
             {
-                Serial.println(F("[PilotLight] Registration successful!"));
+                Serial.println(F("[PilotLight] Registration started"));
             }
             else
             {
@@ -392,15 +406,13 @@ void loop()
 {
     // 1. LISTEN for commands from Sentient
     mqtt.loop();
+    manifest.loop();
 
     // 2. DETECT sensor changes and publish if needed
     check_and_publish_sensor_changes();
 
-    // 3. EXECUTE active hardware operations
-    if (fire_leds_active)
-    {
-        fill_fire_frame(); // Run fire animation
-    }
+    // 3. EXECUTE active hardware operations (renders and sends only when a frame is due)
+    led_effects.service();
 
     // Handle manual heartbeat requests
     if (manual_heartbeat_requested)
@@ -431,6 +443,7 @@ void handle_mqtt_command(const char *command, const JsonDocument &payload, void
     // ──────────────────────────────────────────────────────────────────────────
     if (cmd.equals(naming::CMD_FIRE_LEDS_ON))
     {
+        start_fire();
         fire_leds_active = true;
         Serial.println(F("[PilotLight] Fire LEDs: ON"));
         publish_hardware_status();
@@ -438,14 +451,7 @@ void handle_mqtt_command(const char *command, const JsonDocument &payload, void
     else if (cmd.equals(naming::CMD_FIRE_LEDS_OFF))
     {
         fire_leds_active = false;
-        // Turn all fire LED strips to black
-        fill_solid(leds_b1s1, num_leds, CRGB::Black);
-        fill_solid(leds_b1s2, num_leds, CRGB::Black);
-        fill_solid(leds_b1s3, num_leds, CRGB::Black);
-        fill_solid(leds_b2s1, num_leds, CRGB::Black);
-        fill_solid(leds_b2s2, num_leds, CRGB::Black);
-        fill_solid(leds_b2s3, num_leds, CRGB::Black);
-        FastLED.show();
+        led_effects.off(fire_segment);
         Serial.println(F("[PilotLight] Fire LEDs: OFF"));
         publish_hardware_status();
     }
@@ -492,16 +498,14 @@ void handle_mqtt_command(const char *command, const JsonDocument &payload, void
     else if (cmd.equals(naming::CMD_FLANGE_ON))
     {
         flange_leds_on = true;
-        fill_solid(leds_flange, num_leds, CRGB::Green);
-        FastLED.show();
+        led_effects.fill(flange_segment, CRGB::Green);
         Serial.println(F("[PilotLight] Flange LEDs: ON (Green)"));
         publish_hardware_status();
     }
     else if (cmd.equals(naming::CMD_FLANGE_OFF))
     {
         flange_leds_on = false;
-        fill_solid(leds_flange, num_leds, CRGB::Black);
-        FastLED.show();
+        led_effects.off(flange_segment);
         Serial.println(F("[PilotLight] Flange LEDs: OFF"));
         publish_hardware_status();
     }
@@ -523,14 +527,8 @@ void handle_mqtt_command(const char *command, const JsonDocument &payload, void
         flange_leds_on = false;
 
         // Turn off all LEDs
-        fill_solid(leds_b1s1, num_leds, CRGB::Black);
-        fill_solid(leds_b1s2, num_leds, CRGB::Black);
-        fill_solid(leds_b1s3, num_leds, CRGB::Black);
-        fill_solid(leds_b2s1, num_leds, CRGB::Black);
-        fill_solid(leds_b2s2, num_leds, CRGB::Black);
-        fill_solid(leds_b2s3, num_leds, CRGB::Black);
-        fill_solid(leds_flange, num_leds, CRGB::Red); // Red = reset/error state
-        FastLED.show();
+        led_effects.off(fire_segment);
+        led_effects.fill(flange_segment, CRGB::Red); // Red = reset/error state
 
         // Turn off all relays
         digitalWrite(boiler_monitor_pin, LOW);
@@ -558,7 +556,7 @@ void handle_mqtt_command(const char *command, const JsonDocument &payload, void
 // ──────────────────────────────────────────────────────────────────────────────
 // Command Acknowledgement
 // ──────────────────────────────────────────────────────────────────────────────
-void publish_command_acknowledgement(const char *device_id, const char *command)
+void publish_command_acknowledgement(const char *device_id, const char *command, bool success)
 {
     if (!mqtt.isConnected())
         return;
@@ -567,7 +565,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
     ack["controller_id"] = naming::CONTROLLER_ID;
     ack["device_id"] = device_id;
     ack["command"] = command;
-    ack["success"] = true;
+    ack["success"] = success;
     ack["timestamp_ms"] = millis();
 
     char buf[196];
@@ -578,62 +576,44 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
                       String(naming::CAT_ACKNOWLEDGEMENT) + "/" + String(naming::CONTROLLER_ID) + "/" +
                       String(device_id) + "/" + String(command);
 
-    mqtt.get_client().publish(ackTopic.c_str(), buf, false);
+    mqtt.publishTopic(ackTopic.c_str(), buf);
 
     Serial.print(F("[ACK] -> "));
     Serial.println(ackTopic);
 }
 
-// Hardware execution function - Fire animation
-void fill_fire_frame()
+// ──────────────────────────────────────────────────────────────────────────────
+// LED Effects
+// ──────────────────────────────────────────────────────────────────────────────
+// Boiler fire: blue to cornflower to orange as heat rises
+void start_fire()
 {
-    static int boom_index = -1;
-    static unsigned long last_debug = 0;
-
-    // Debug output every 5 seconds
-    if (millis() - last_debug > 5000)
-    {
-        Serial.println(F("[PilotLight] Fire animation running..."));
-        last_debug = millis();
-    }
+    SentientLedEffectParams fire;
+    fire.effect = SentientLedEffect::Fire;
+    fire.color = CRGB(0xFC6000);
+    fire.color2 = CRGB(0x6495ED);
+    fire.background = CRGB(0x3A79EB);
+    fire.level = 250;
+    fire.variation = 50;
+    led_effects.setEffect(fire_segment, fire);
+}
 
-    // Fire animation logic
-    int i = random(0, num_leds);
-    heat[i] = qsub8(heat[i], random8(1, 10));
-    flame[i] = random(-50, 50);
-    if (flame[i] == 0)
-    {
-        flame[i] = random(1, 50);
-    }
+// set_effect on either LED device, e.g. {"effect": "pulse", "color": "#00FF00", "period_ms": 1500}
+void handle_effect_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx)
+{
+    LedChannel &channel = *static_cast<LedChannel *>(ctx);
 
-    for (int idx = 0; idx < num_leds; idx++)
+    const bool ok = led_effects.configure(*channel.segment, payload.as<JsonVariantConst>());
+    if (ok)
     {
-        heat[idx] = min(255, max(100, heat[idx] + flame[idx]));
-
-        CRGB color = ColorFromPalette(fire_palette, scale8(heat[idx], 240), scale8(heat[idx], 250), LINEARBLEND);
-        leds_b1s1[idx] = color;
-        leds_b1s2[idx] = color;
-        leds_b1s3[idx] = color;
-        leds_b2s1[idx] = color;
-        leds_b2s2[idx] = color;
-        leds_b2s3[idx] = color;
-
-        if (heat[idx] > 250)
-        {
-            boom_index = idx;
-        }
-
-        flame[idx] = (heat[idx] + flame[idx] > 255) ? random(-50, -1)
-                     : (heat[idx] < 0)              ? random(1, 50)
-                                                    : flame[idx];
-
-        if (heat[idx] < 250 && boom_index == idx)
-        {
-            boom_index = -1;
-        }
+        *channel.on = led_effects.lit(*channel.segment);
     }
-
-    FastLED.show();
+    Serial.print(F("[PilotLight] "));
+    Serial.print(channel.label);
+    Serial.print(F(" effect: "));
+    Serial.println(ok ? SentientLedEffects::effectName(led_effects.params(*channel.segment).effect) : "rejected");
+    publish_hardware_status();
+    publish_command_acknowledgement(cmd.deviceId, cmd.name, ok);
 }
 
 // ============================================================================
@@ -653,9 +633,6 @@ void build_capability_manifest()
         naming::ROOM_ID,
         naming::CONTROLLER_ID);
 
-    // Auto-generate entire manifest from device registry - ONE LINE!
-    deviceRegistry.buildManifest(manifest);
-
     // That's it! No manual device/topic registration needed!
     // All devices and topics are defined once in the Device Registry section above.
 }
@@ -836,6 +813,9 @@ void publish_full_status()
     doc["monitor_power"] = boiler_monitor_on;
     doc["newell_power"] = newell_power_on;
     doc["flange_leds"] = flange_leds_on;
+    doc["fire_effect"] = SentientLedEffects::effectName(led_effects.params(fire_segment).effect);
+    doc["flange_effect"] = SentientLedEffects::effectName(led_effects.params(flange_segment).effect);
+    doc["led_frame_us"] = led_effects.maxFrameMicros();
     doc["uptime"] = millis();
     doc["ts"] = millis();
     doc["uid"] = naming::CONTROLLER_ID;
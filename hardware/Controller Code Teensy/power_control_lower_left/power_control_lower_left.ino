@@ -25,7 +25,7 @@
 #define MQTT_MAX_PACKET_SIZE 512
 #endif
 
-#include <SentientCapabilityManifest.h>
+#include <SentientManifestStream.h>
 #include <SentientMQTT.h>
 #include <SentientDeviceRegistry.h>
 #include <ArduinoJson.h>
@@ -78,12 +78,12 @@ bool clock_5v_state = false;
 // ============================================================================
 
 // Standard power commands (on/off)
-const char *power_commands[] = {
+constexpr const char *power_commands[] PROGMEM = {
     naming::CMD_POWER_ON,
     naming::CMD_POWER_OFF};
 
 // Controller-level commands
-const char *controller_commands[] = {
+constexpr const char *controller_commands[] PROGMEM = {
     naming::CMD_ALL_ON,
     naming::CMD_ALL_OFF,
     naming::CMD_EMERGENCY_OFF,
@@ -91,16 +91,43 @@ const char *controller_commands[] = {
     naming::CMD_REQUEST_STATUS};
 
 // Create device definitions for all 6 relays
-SentientDeviceDef dev_lever_riddle_cube_24v(naming::DEV_LEVER_RIDDLE_CUBE_24V, naming::FRIENDLY_LEVER_RIDDLE_CUBE_24V, "relay", power_commands, 2);
-SentientDeviceDef dev_lever_riddle_cube_12v(naming::DEV_LEVER_RIDDLE_CUBE_12V, naming::FRIENDLY_LEVER_RIDDLE_CUBE_12V, "relay", power_commands, 2);
-SentientDeviceDef dev_lever_riddle_cube_5v(naming::DEV_LEVER_RIDDLE_CUBE_5V, naming::FRIENDLY_LEVER_RIDDLE_CUBE_5V, "relay", power_commands, 2);
-SentientDeviceDef dev_clock_24v(naming::DEV_CLOCK_24V, naming::FRIENDLY_CLOCK_24V, "relay", power_commands, 2);
-SentientDeviceDef dev_clock_12v(naming::DEV_CLOCK_12V, naming::FRIENDLY_CLOCK_12V, "relay", power_commands, 2);
-SentientDeviceDef dev_clock_5v(naming::DEV_CLOCK_5V, naming::FRIENDLY_CLOCK_5V, "relay", power_commands, 2);
-SentientDeviceDef dev_controller(naming::DEV_CONTROLLER, naming::FRIENDLY_CONTROLLER, "controller", controller_commands, 5);
+constexpr SentientDeviceDef dev_lever_riddle_cube_24v PROGMEM(naming::DEV_LEVER_RIDDLE_CUBE_24V, naming::FRIENDLY_LEVER_RIDDLE_CUBE_24V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_lever_riddle_cube_12v PROGMEM(naming::DEV_LEVER_RIDDLE_CUBE_12V, naming::FRIENDLY_LEVER_RIDDLE_CUBE_12V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_lever_riddle_cube_5v PROGMEM(naming::DEV_LEVER_RIDDLE_CUBE_5V, naming::FRIENDLY_LEVER_RIDDLE_CUBE_5V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_clock_24v PROGMEM(naming::DEV_CLOCK_24V, naming::FRIENDLY_CLOCK_24V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_clock_12v PROGMEM(naming::DEV_CLOCK_12V, naming::FRIENDLY_CLOCK_12V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_clock_5v PROGMEM(naming::DEV_CLOCK_5V, naming::FRIENDLY_CLOCK_5V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_controller PROGMEM(naming::DEV_CONTROLLER, naming::FRIENDLY_CONTROLLER, "controller", controller_commands, 5);
 
 // Create the device registry
-SentientDeviceRegistry deviceRegistry;
+SENTIENT_DEVICE_REGISTRY(deviceRegistry,
+    &dev_lever_riddle_cube_24v,
+    &dev_lever_riddle_cube_12v,
+    &dev_lever_riddle_cube_5v,
+    &dev_clock_24v,
+    &dev_clock_12v,
+    &dev_clock_5v,
+    &dev_controller);
+
+// ──────────────────────────────────────────────────────────────────────────────
+// Relay Command Routing (one binding per relay device, passed as route context)
+// ──────────────────────────────────────────────────────────────────────────────
+struct RelayBinding
+{
+    int pin;
+    bool &state;
+    const char *name;
+    const char *device_id;
+};
+
+RelayBinding relay_bindings[] = {
+    {lever_riddle_cube_24v_pin, lever_riddle_cube_24v_state, "Lever Riddle Cube 24V", naming::DEV_LEVER_RIDDLE_CUBE_24V},
+    {lever_riddle_cube_12v_pin, lever_riddle_cube_12v_state, "Lever Riddle Cube 12V", naming::DEV_LEVER_RIDDLE_CUBE_12V},
+    {lever_riddle_cube_5v_pin, lever_riddle_cube_5v_state, "Lever Riddle Cube 5V", naming::DEV_LEVER_RIDDLE_CUBE_5V},
+    {clock_24v_pin, clock_24v_state, "Clock 24V", naming::DEV_CLOCK_24V},
+    {clock_12v_pin, clock_12v_state, "Clock 12V", naming::DEV_CLOCK_12V},
+    {clock_5v_pin, clock_5v_state, "Clock 5V", naming::DEV_CLOCK_5V},
+};
 
 // ──────────────────────────────────────────────────────────────────────────────
 // Forward Declarations
@@ -108,7 +135,8 @@ SentientDeviceRegistry deviceRegistry;
 void build_capability_manifest();
 SentientMQTTConfig build_mqtt_config();
 bool build_heartbeat_payload(JsonDocument &doc, void *ctx);
-void handle_mqtt_command(const char *command, const JsonDocument &payload, void *ctx);
+void handle_relay_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx);
+void handle_controller_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx);
 void set_relay_state(int pin, bool state, bool &state_var, const char *device_name, const char *device_id, const char *command);
 void publish_relay_state(const char *device_id, bool state);
 void publish_command_acknowledgement(const char *device_id, const char *command, bool state);
@@ -122,7 +150,7 @@ const char *build_device_identifier();
 const char *get_hardware_label();
 
 // MQTT objects
-SentientCapabilityManifest manifest;
+SentientManifestStream manifest(deviceRegistry);
 SentientMQTT mqtt(build_mqtt_config());
 
 // ============================================================================
@@ -173,15 +201,6 @@ void setup()
 
     Serial.println(F("[PowerCtrl] All 6 relays initialized to OFF"));
 
-    // Register all devices
-    Serial.println(F("[PowerCtrl] Registering devices..."));
-    deviceRegistry.addDevice(&dev_lever_riddle_cube_24v);
-    deviceRegistry.addDevice(&dev_lever_riddle_cube_12v);
-    deviceRegistry.addDevice(&dev_lever_riddle_cube_5v);
-    deviceRegistry.addDevice(&dev_clock_24v);
-    deviceRegistry.addDevice(&dev_clock_12v);
-    deviceRegistry.addDevice(&dev_clock_5v);
-    deviceRegistry.addDevice(&dev_controller);
     deviceRegistry.printSummary();
 
     // Build capability manifest
@@ -189,6 +208,13 @@ void setup()
     build_capability_manifest();
     Serial.println(F("[PowerCtrl] Manifest built successfully"));
 
+    // Route commands/<controller>/<device>/<command> straight to the relay it targets
+    for (RelayBinding &relay : relay_bindings)
+    {
+        mqtt.onCommands(relay.device_id, power_commands, 2, handle_relay_command, &relay);
+    }
+    mqtt.onCommands(naming::DEV_CONTROLLER, controller_commands, 5, handle_controller_command);
+
     // Initialize MQTT
     Serial.println(F("[PowerCtrl] Initializing MQTT..."));
     if (!mqtt.begin())
@@ -215,24 +241,15 @@ void setup()
 
             // Register with Sentient system
             Serial.println(F("[PowerCtrl] Registering with Sentient system..."));
-            if (manifest.publish_registration(mqtt.get_client(), naming::ROOM_ID, naming::CONTROLLER_ID))
+            if (manifest.publish_registration(mqtt, naming::ROOM_ID, naming::CONTROLLER_ID))
             {
-                Serial.println(F("[PowerCtrl] Registration successful!"));
+                Serial.println(F("[PowerCtrl] Registration started"));
             }
             else
             {
                 Serial.println(F("[PowerCtrl] Registration failed - will retry later"));
             }
 
-            // Subscribe to device-scoped commands
-            String topic = String(naming::CLIENT_ID) + "/" + naming::ROOM_ID + "/commands/" + naming::CONTROLLER_ID + "/+/+";
-            mqtt.get_client().subscribe(topic.c_str());
-            Serial.print(F("[PowerCtrl] Subscribed to: "));
-            Serial.println(topic);
-
-            // Set custom message handler for device routing
-            mqtt.get_client().setCallback(handle_mqtt_command);
-
             // Report actual physical relay states as single source of truth
             // This ensures database and cache reflect actual hardware state after power-up
             Serial.println(F("[PowerCtrl] Reporting actual relay states..."));
@@ -257,135 +274,59 @@ void loop()
 {
     // LISTEN for commands from Sentient
     mqtt.loop();
+    manifest.loop();
 }
 
 // ============================================================================
 // SECTION 4: COMMAND HANDLER
 // ============================================================================
 
-void handle_mqtt_command(char *topic, uint8_t *payload, unsigned int length)
+// Indices into controller_commands
+enum ControllerCommand
 {
-    // Parse topic to extract device and command
-    String device, command;
-
-    // Parse topic segments: client/room/commands/controller/device/command
-    int seg = 0;
-    const char *p = topic;
-    const char *segStart[8] = {nullptr};
-    size_t segLen[8] = {0};
-    segStart[0] = p;
-
-    while (*p && seg < 8)
-    {
-        if (*p == '/')
-        {
-            segLen[seg] = p - segStart[seg];
-            seg++;
-            if (seg < 8)
-                segStart[seg] = p + 1;
-        }
-        p++;
-    }
-    if (seg < 8 && segStart[seg])
-    {
-        segLen[seg] = p - segStart[seg];
-        seg++;
-    }
+    CONTROLLER_ALL_ON,
+    CONTROLLER_ALL_OFF,
+    CONTROLLER_EMERGENCY_OFF,
+    CONTROLLER_RESET,
+    CONTROLLER_REQUEST_STATUS
+};
+
+void handle_relay_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx)
+{
+    RelayBinding &relay = *static_cast<RelayBinding *>(ctx);
 
-    auto equalsSeg = [&](int idx, const char *lit) -> bool
-    {
-        size_t litLen = strlen(lit);
-        return segLen[idx] == litLen && strncmp(segStart[idx], lit, litLen) == 0;
-    };
+    // power_commands: 0 = power_on, 1 = power_off
+    set_relay_state(relay.pin, cmd.index == 0, relay.state, relay.name, relay.device_id, cmd.name);
+}
 
-    // Validate topic structure and extract device/command
-    if (seg >= 6 && equalsSeg(0, naming::CLIENT_ID) && equalsSeg(1, naming::ROOM_ID) &&
-        equalsSeg(2, "commands") && equalsSeg(3, naming::CONTROLLER_ID))
+void handle_controller_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx)
+{
+    switch (cmd.index)
     {
-        device = String(segStart[4]).substring(0, segLen[4]);
-        command = String(segStart[5]).substring(0, segLen[5]);
-
-        Serial.print(F("[PowerCtrl] Device: "));
-        Serial.print(device);
-        Serial.print(F(" Command: "));
-        Serial.println(command);
-
-        // Route to device-specific handlers
-        if (device == naming::DEV_LEVER_RIDDLE_CUBE_24V)
-        {
-            if (command == "power_on")
-                set_relay_state(lever_riddle_cube_24v_pin, true, lever_riddle_cube_24v_state, "Lever Riddle Cube 24V", naming::DEV_LEVER_RIDDLE_CUBE_24V, "power_on");
-            else if (command == "power_off")
-                set_relay_state(lever_riddle_cube_24v_pin, false, lever_riddle_cube_24v_state, "Lever Riddle Cube 24V", naming::DEV_LEVER_RIDDLE_CUBE_24V, "power_off");
-        }
-        else if (device == naming::DEV_LEVER_RIDDLE_CUBE_12V)
-        {
-            if (command == "power_on")
-                set_relay_state(lever_riddle_cube_12v_pin, true, lever_riddle_cube_12v_state, "Lever Riddle Cube 12V", naming::DEV_LEVER_RIDDLE_CUBE_12V, "power_on");
-            else if (command == "power_off")
-                set_relay_state(lever_riddle_cube_12v_pin, false, lever_riddle_cube_12v_state, "Lever Riddle Cube 12V", naming::DEV_LEVER_RIDDLE_CUBE_12V, "power_off");
-        }
-        else if (device == naming::DEV_LEVER_RIDDLE_CUBE_5V)
-        {
-            if (command == "power_on")
-                set_relay_state(lever_riddle_cube_5v_pin, true, lever_riddle_cube_5v_state, "Lever Riddle Cube 5V", naming::DEV_LEVER_RIDDLE_CUBE_5V, "power_on");
-            else if (command == "power_off")
-                set_relay_state(lever_riddle_cube_5v_pin, false, lever_riddle_cube_5v_state, "Lever Riddle Cube 5V", naming::DEV_LEVER_RIDDLE_CUBE_5V, "power_off");
-        }
-        else if (device == naming::DEV_CLOCK_24V)
-        {
-            if (command == "power_on")
-                set_relay_state(clock_24v_pin, true, clock_24v_state, "Clock 24V", naming::DEV_CLOCK_24V, "power_on");
-            else if (command == "power_off")
-                set_relay_state(clock_24v_pin, false, clock_24v_state, "Clock 24V", naming::DEV_CLOCK_24V, "power_off");
-        }
-        else if (device == naming::DEV_CLOCK_12V)
-        {
-            if (command == "power_on")
-                set_relay_state(clock_12v_pin, true, clock_12v_state, "Clock 12V", naming::DEV_CLOCK_12V, "power_on");
-            else if (command == "power_off")
-                set_relay_state(clock_12v_pin, false, clock_12v_state, "Clock 12V", naming::DEV_CLOCK_12V, "power_off");
-        }
-        else if (device == naming::DEV_CLOCK_5V)
-        {
-            if (command == "power_on")
-                set_relay_state(clock_5v_pin, true, clock_5v_state, "Clock 5V", naming::DEV_CLOCK_5V, "power_on");
-            else if (command == "power_off")
-                set_relay_state(clock_5v_pin, false, clock_5v_state, "Clock 5V", naming::DEV_CLOCK_5V, "power_off");
-        }
-        else if (device == naming::DEV_CONTROLLER)
-        {
-            // Controller-level commands
-            if (command == naming::CMD_ALL_ON)
-            {
-                Serial.println(F("[PowerCtrl] ALL ON command"));
-                all_relays_on();
-                publish_hardware_status();
-            }
-            else if (command == naming::CMD_ALL_OFF)
-            {
-                Serial.println(F("[PowerCtrl] ALL OFF command"));
-                all_relays_off();
-                publish_hardware_status();
-            }
-            else if (command == naming::CMD_EMERGENCY_OFF)
-            {
-                Serial.println(F("[PowerCtrl] EMERGENCY OFF command"));
-                emergency_power_off();
-                publish_hardware_status();
-            }
-            else if (command == naming::CMD_RESET)
-            {
-                Serial.println(F("[PowerCtrl] RESET command"));
-                all_relays_off();
-                publish_hardware_status();
-            }
-            else if (command == naming::CMD_REQUEST_STATUS)
-            {
-                Serial.println(F("[PowerCtrl] Status requested"));
-                publish_full_status();
-            }
-        }
+    case CONTROLLER_ALL_ON:
+        Serial.println(F("[PowerCtrl] ALL ON command"));
+        all_relays_on();
+        publish_hardware_status();
+        break;
+    case CONTROLLER_ALL_OFF:
+        Serial.println(F("[PowerCtrl] ALL OFF command"));
+        all_relays_off();
+        publish_hardware_status();
+        break;
+    case CONTROLLER_EMERGENCY_OFF:
+        Serial.println(F("[PowerCtrl] EMERGENCY OFF command"));
+        emergency_power_off();
+        publish_hardware_status();
+        break;
+    case CONTROLLER_RESET:
+        Serial.println(F("[PowerCtrl] RESET command"));
+        all_relays_off();
+        publish_hardware_status();
+        break;
+    case CONTROLLER_REQUEST_STATUS:
+        Serial.println(F("[PowerCtrl] Status requested"));
+        publish_full_status();
+        break;
     }
 }
 
@@ -413,7 +354,7 @@ void publish_relay_state(const char *device_id, bool state)
     char jsonBuffer[128];
     serializeJson(doc, jsonBuffer);
 
-    mqtt.get_client().publish(topic.c_str(), jsonBuffer);
+    mqtt.publishTopic(topic.c_str(), jsonBuffer);
 
     Serial.print(F("[PowerCtrl] Published state for "));
     Serial.print(device_id);
@@ -446,7 +387,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command,
     char jsonBuffer[128];
     serializeJson(doc, jsonBuffer);
 
-    mqtt.get_client().publish(topic.c_str(), jsonBuffer);
+    mqtt.publishTopic(topic.c_str(), jsonBuffer);
 
     Serial.print(F("[PowerCtrl] Published ACK for "));
     Serial.print(device_id);
@@ -632,9 +573,6 @@ void build_capability_manifest()
         firmware::VERSION,
         naming::ROOM_ID,
         naming::CONTROLLER_ID);
-
-    // Auto-generate entire manifest from device registry
-    deviceRegistry.buildManifest(manifest);
 }
 
 SentientMQTTConfig build_mqtt_config()
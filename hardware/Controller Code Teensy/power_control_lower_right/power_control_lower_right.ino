@@ -32,7 +32,7 @@
 #define MQTT_MAX_PACKET_SIZE 512
 #endif
 
-#include <SentientCapabilityManifest.h>
+#include <SentientManifestStream.h>
 #include <SentientMQTT.h>
 #include <SentientDeviceRegistry.h>
 #include <ArduinoJson.h>
@@ -135,12 +135,12 @@ bool empty_34_state = false;
 // ============================================================================
 
 // Standard power commands (on/off)
-const char *power_commands[] = {
+constexpr const char *power_commands[] PROGMEM = {
     naming::CMD_POWER_ON,
     naming::CMD_POWER_OFF};
 
 // Controller-level commands
-const char *controller_commands[] = {
+constexpr const char *controller_commands[] PROGMEM = {
     naming::CMD_ALL_ON,
     naming::CMD_ALL_OFF,
     naming::CMD_EMERGENCY_OFF,
@@ -148,34 +148,97 @@ const char *controller_commands[] = {
     naming::CMD_REQUEST_STATUS};
 
 // Create device definitions for all 24 relays
-SentientDeviceDef dev_gear_24v(naming::DEV_GEAR_24V, naming::FRIENDLY_GEAR_24V, "relay", power_commands, 2);
-SentientDeviceDef dev_gear_12v(naming::DEV_GEAR_12V, naming::FRIENDLY_GEAR_12V, "relay", power_commands, 2);
-SentientDeviceDef dev_gear_5v(naming::DEV_GEAR_5V, naming::FRIENDLY_GEAR_5V, "relay", power_commands, 2);
-SentientDeviceDef dev_floor_24v(naming::DEV_FLOOR_24V, naming::FRIENDLY_FLOOR_24V, "relay", power_commands, 2);
-SentientDeviceDef dev_floor_12v(naming::DEV_FLOOR_12V, naming::FRIENDLY_FLOOR_12V, "relay", power_commands, 2);
-SentientDeviceDef dev_floor_5v(naming::DEV_FLOOR_5V, naming::FRIENDLY_FLOOR_5V, "relay", power_commands, 2);
-SentientDeviceDef dev_riddle_rpi_5v(naming::DEV_RIDDLE_RPI_5V, naming::FRIENDLY_RIDDLE_RPI_5V, "relay", power_commands, 2);
-SentientDeviceDef dev_riddle_rpi_12v(naming::DEV_RIDDLE_RPI_12V, naming::FRIENDLY_RIDDLE_RPI_12V, "relay", power_commands, 2);
-SentientDeviceDef dev_riddle_5v(naming::DEV_RIDDLE_5V, naming::FRIENDLY_RIDDLE_5V, "relay", power_commands, 2);
-SentientDeviceDef dev_boiler_room_subpanel_24v(naming::DEV_BOILER_ROOM_SUBPANEL_24V, naming::FRIENDLY_BOILER_ROOM_SUBPANEL_24V, "relay", power_commands, 2);
-SentientDeviceDef dev_boiler_room_subpanel_12v(naming::DEV_BOILER_ROOM_SUBPANEL_12V, naming::FRIENDLY_BOILER_ROOM_SUBPANEL_12V, "relay", power_commands, 2);
-SentientDeviceDef dev_boiler_room_subpanel_5v(naming::DEV_BOILER_ROOM_SUBPANEL_5V, naming::FRIENDLY_BOILER_ROOM_SUBPANEL_5V, "relay", power_commands, 2);
-SentientDeviceDef dev_lab_room_subpanel_24v(naming::DEV_LAB_ROOM_SUBPANEL_24V, naming::FRIENDLY_LAB_ROOM_SUBPANEL_24V, "relay", power_commands, 2);
-SentientDeviceDef dev_lab_room_subpanel_12v(naming::DEV_LAB_ROOM_SUBPANEL_12V, naming::FRIENDLY_LAB_ROOM_SUBPANEL_12V, "relay", power_commands, 2);
-SentientDeviceDef dev_lab_room_subpanel_5v(naming::DEV_LAB_ROOM_SUBPANEL_5V, naming::FRIENDLY_LAB_ROOM_SUBPANEL_5V, "relay", power_commands, 2);
-SentientDeviceDef dev_study_room_subpanel_24v(naming::DEV_STUDY_ROOM_SUBPANEL_24V, naming::FRIENDLY_STUDY_ROOM_SUBPANEL_24V, "relay", power_commands, 2);
-SentientDeviceDef dev_study_room_subpanel_12v(naming::DEV_STUDY_ROOM_SUBPANEL_12V, naming::FRIENDLY_STUDY_ROOM_SUBPANEL_12V, "relay", power_commands, 2);
-SentientDeviceDef dev_study_room_subpanel_5v(naming::DEV_STUDY_ROOM_SUBPANEL_5V, naming::FRIENDLY_STUDY_ROOM_SUBPANEL_5V, "relay", power_commands, 2);
-SentientDeviceDef dev_gun_drawers_24v(naming::DEV_GUN_DRAWERS_24V, naming::FRIENDLY_GUN_DRAWERS_24V, "relay", power_commands, 2);
-SentientDeviceDef dev_gun_drawers_12v(naming::DEV_GUN_DRAWERS_12V, naming::FRIENDLY_GUN_DRAWERS_12V, "relay", power_commands, 2);
-SentientDeviceDef dev_gun_drawers_5v(naming::DEV_GUN_DRAWERS_5V, naming::FRIENDLY_GUN_DRAWERS_5V, "relay", power_commands, 2);
-SentientDeviceDef dev_keys_5v(naming::DEV_KEYS_5V, naming::FRIENDLY_KEYS_5V, "relay", power_commands, 2);
-SentientDeviceDef dev_empty_35(naming::DEV_EMPTY_35, naming::FRIENDLY_EMPTY_35, "relay", power_commands, 2);
-SentientDeviceDef dev_empty_34(naming::DEV_EMPTY_34, naming::FRIENDLY_EMPTY_34, "relay", power_commands, 2);
-SentientDeviceDef dev_controller(naming::DEV_CONTROLLER, naming::FRIENDLY_CONTROLLER, "controller", controller_commands, 5);
+constexpr SentientDeviceDef dev_gear_24v PROGMEM(naming::DEV_GEAR_24V, naming::FRIENDLY_GEAR_24V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_gear_12v PROGMEM(naming::DEV_GEAR_12V, naming::FRIENDLY_GEAR_12V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_gear_5v PROGMEM(naming::DEV_GEAR_5V, naming::FRIENDLY_GEAR_5V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_floor_24v PROGMEM(naming::DEV_FLOOR_24V, naming::FRIENDLY_FLOOR_24V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_floor_12v PROGMEM(naming::DEV_FLOOR_12V, naming::FRIENDLY_FLOOR_12V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_floor_5v PROGMEM(naming::DEV_FLOOR_5V, naming::FRIENDLY_FLOOR_5V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_riddle_rpi_5v PROGMEM(naming::DEV_RIDDLE_RPI_5V, naming::FRIENDLY_RIDDLE_RPI_5V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_riddle_rpi_12v PROGMEM(naming::DEV_RIDDLE_RPI_12V, naming::FRIENDLY_RIDDLE_RPI_12V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_riddle_5v PROGMEM(naming::DEV_RIDDLE_5V, naming::FRIENDLY_RIDDLE_5V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_boiler_room_subpanel_24v PROGMEM(naming::DEV_BOILER_ROOM_SUBPANEL_24V, naming::FRIENDLY_BOILER_ROOM_SUBPANEL_24V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_boiler_room_subpanel_12v PROGMEM(naming::DEV_BOILER_ROOM_SUBPANEL_12V, naming::FRIENDLY_BOILER_ROOM_SUBPANEL_12V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_boiler_room_subpanel_5v PROGMEM(naming::DEV_BOILER_ROOM_SUBPANEL_5V, naming::FRIENDLY_BOILER_ROOM_SUBPANEL_5V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_lab_room_subpanel_24v PROGMEM(naming::DEV_LAB_ROOM_SUBPANEL_24V, naming::FRIENDLY_LAB_ROOM_SUBPANEL_24V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_lab_room_subpanel_12v PROGMEM(naming::DEV_LAB_ROOM_SUBPANEL_12V, naming::FRIENDLY_LAB_ROOM_SUBPANEL_12V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_lab_room_subpanel_5v PROGMEM(naming::DEV_LAB_ROOM_SUBPANEL_5V, naming::FRIENDLY_LAB_ROOM_SUBPANEL_5V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_study_room_subpanel_24v PROGMEM(naming::DEV_STUDY_ROOM_SUBPANEL_24V, naming::FRIENDLY_STUDY_ROOM_SUBPANEL_24V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_study_room_subpanel_12v PROGMEM(naming::DEV_STUDY_ROOM_SUBPANEL_12V, naming::FRIENDLY_STUDY_ROOM_SUBPANEL_12V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_study_room_subpanel_5v PROGMEM(naming::DEV_STUDY_ROOM_SUBPANEL_5V, naming::FRIENDLY_STUDY_ROOM_SUBPANEL_5V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_gun_drawers_24v PROGMEM(naming::DEV_GUN_DRAWERS_24V, naming::FRIENDLY_GUN_DRAWERS_24V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_gun_drawers_12v PROGMEM(naming::DEV_GUN_DRAWERS_12V, naming::FRIENDLY_GUN_DRAWERS_12V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_gun_drawers_5v PROGMEM(naming::DEV_GUN_DRAWERS_5V, naming::FRIENDLY_GUN_DRAWERS_5V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_keys_5v PROGMEM(naming::DEV_KEYS_5V, naming::FRIENDLY_KEYS_5V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_empty_35 PROGMEM(naming::DEV_EMPTY_35, naming::FRIENDLY_EMPTY_35, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_empty_34 PROGMEM(naming::DEV_EMPTY_34, naming::FRIENDLY_EMPTY_34, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_controller PROGMEM(naming::DEV_CONTROLLER, naming::FRIENDLY_CONTROLLER, "controller", controller_commands, 5);
 
 // Create the device registry
-SentientDeviceRegistry deviceRegistry;
+SENTIENT_DEVICE_REGISTRY(deviceRegistry,
+    &dev_gear_24v,
+    &dev_gear_12v,
+    &dev_gear_5v,
+    &dev_floor_24v,
+    &dev_floor_12v,
+    &dev_floor_5v,
+    &dev_riddle_rpi_5v,
+    &dev_riddle_rpi_12v,
+    &dev_riddle_5v,
+    &dev_boiler_room_subpanel_24v,
+    &dev_boiler_room_subpanel_12v,
+    &dev_boiler_room_subpanel_5v,
+    &dev_lab_room_subpanel_24v,
+    &dev_lab_room_subpanel_12v,
+    &dev_lab_room_subpanel_5v,
+    &dev_study_room_subpanel_24v,
+    &dev_study_room_subpanel_12v,
+    &dev_study_room_subpanel_5v,
+    &dev_gun_drawers_24v,
+    &dev_gun_drawers_12v,
+    &dev_gun_drawers_5v,
+    &dev_keys_5v,
+    &dev_empty_35,
+    &dev_empty_34,
+    &dev_controller);
+
+// ──────────────────────────────────────────────────────────────────────────────
+// Relay Command Routing (one binding per relay device, passed as route context)
+// ──────────────────────────────────────────────────────────────────────────────
+struct RelayBinding
+{
+    int pin;
+    bool &state;
+    const char *name;
+    const char *device_id;
+};
+
+RelayBinding relay_bindings[] = {
+    {gear_24v_pin, gear_24v_state, "Gear 24V", naming::DEV_GEAR_24V},
+    {gear_12v_pin, gear_12v_state, "Gear 12V", naming::DEV_GEAR_12V},
+    {gear_5v_pin, gear_5v_state, "Gear 5V", naming::DEV_GEAR_5V},
+    {floor_24v_pin, floor_24v_state, "Floor 24V", naming::DEV_FLOOR_24V},
+    {floor_12v_pin, floor_12v_state, "Floor 12V", naming::DEV_FLOOR_12V},
+    {floor_5v_pin, floor_5v_state, "Floor 5V", naming::DEV_FLOOR_5V},
+    {riddle_rpi_5v_pin, riddle_rpi_5v_state, "Riddle RPi 5V", naming::DEV_RIDDLE_RPI_5V},
+    {riddle_rpi_12v_pin, riddle_rpi_12v_state, "Riddle RPi 12V", naming::DEV_RIDDLE_RPI_12V},
+    {riddle_5v_pin, riddle_5v_state, "Riddle 5V", naming::DEV_RIDDLE_5V},
+    {boiler_room_subpanel_24v_pin, boiler_room_subpanel_24v_state, "Boiler Subpanel 24V", naming::DEV_BOILER_ROOM_SUBPANEL_24V},
+    {boiler_room_subpanel_12v_pin, boiler_room_subpanel_12v_state, "Boiler Subpanel 12V", naming::DEV_BOILER_ROOM_SUBPANEL_12V},
+    {boiler_room_subpanel_5v_pin, boiler_room_subpanel_5v_state, "Boiler Subpanel 5V", naming::DEV_BOILER_ROOM_SUBPANEL_5V},
+    {lab_room_subpanel_24v_pin, lab_room_subpanel_24v_state, "Lab Subpanel 24V", naming::DEV_LAB_ROOM_SUBPANEL_24V},
+    {lab_room_subpanel_12v_pin, lab_room_subpanel_12v_state, "Lab Subpanel 12V", naming::DEV_LAB_ROOM_SUBPANEL_12V},
+    {lab_room_subpanel_5v_pin, lab_room_subpanel_5v_state, "Lab Subpanel 5V", naming::DEV_LAB_ROOM_SUBPANEL_5V},
+    {study_room_subpanel_24v_pin, study_room_subpanel_24v_state, "Study Subpanel 24V", naming::DEV_STUDY_ROOM_SUBPANEL_24V},
+    {study_room_subpanel_12v_pin, study_room_subpanel_12v_state, "Study Subpanel 12V", naming::DEV_STUDY_ROOM_SUBPANEL_12V},
+    {study_room_subpanel_5v_pin, study_room_subpanel_5v_state, "Study Subpanel 5V", naming::DEV_STUDY_ROOM_SUBPANEL_5V},
+    {gun_drawers_24v_pin, gun_drawers_24v_state, "Gun Drawers 24V", naming::DEV_GUN_DRAWERS_24V},
+    {gun_drawers_12v_pin, gun_drawers_12v_state, "Gun Drawers 12V", naming::DEV_GUN_DRAWERS_12V},
+    {gun_drawers_5v_pin, gun_drawers_5v_state, "Gun Drawers 5V", naming::DEV_GUN_DRAWERS_5V},
+    {keys_5v_pin, keys_5v_state, "Keys 5V", naming::DEV_KEYS_5V},
+    {empty_35_pin, empty_35_state, "Empty 35", naming::DEV_EMPTY_35},
+    {empty_34_pin, empty_34_state, "Empty 34", naming::DEV_EMPTY_34},
+};
 
 // ──────────────────────────────────────────────────────────────────────────────
 // Forward Declarations
@@ -183,7 +246,8 @@ SentientDeviceRegistry deviceRegistry;
 void build_capability_manifest();
 SentientMQTTConfig build_mqtt_config();
 bool build_heartbeat_payload(JsonDocument &doc, void *ctx);
-void handle_mqtt_command(const char *command, const JsonDocument &payload, void *ctx);
+void handle_relay_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx);
+void handle_controller_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx);
 void set_relay_state(int pin, bool state, bool &state_var, const char *device_name, const char *device_id, const char *command);
 void publish_relay_state(const char *device_id, bool state);
 void publish_command_acknowledgement(const char *device_id, const char *command, bool state);
@@ -197,7 +261,7 @@ const char *build_device_identifier();
 const char *get_hardware_label();
 
 // MQTT objects
-SentientCapabilityManifest manifest;
+SentientManifestStream manifest(deviceRegistry);
 SentientMQTT mqtt(build_mqtt_config());
 
 // ============================================================================
@@ -284,33 +348,6 @@ void setup()
 
     Serial.println(F("[PowerCtrl] All 24 relays initialized to OFF"));
 
-    // Register all devices
-    Serial.println(F("[PowerCtrl] Registering devices..."));
-    deviceRegistry.addDevice(&dev_gear_24v);
-    deviceRegistry.addDevice(&dev_gear_12v);
-    deviceRegistry.addDevice(&dev_gear_5v);
-    deviceRegistry.addDevice(&dev_floor_24v);
-    deviceRegistry.addDevice(&dev_floor_12v);
-    deviceRegistry.addDevice(&dev_floor_5v);
-    deviceRegistry.addDevice(&dev_riddle_rpi_5v);
-    deviceRegistry.addDevice(&dev_riddle_rpi_12v);
-    deviceRegistry.addDevice(&dev_riddle_5v);
-    deviceRegistry.addDevice(&dev_boiler_room_subpanel_24v);
-    deviceRegistry.addDevice(&dev_boiler_room_subpanel_12v);
-    deviceRegistry.addDevice(&dev_boiler_room_subpanel_5v);
-    deviceRegistry.addDevice(&dev_lab_room_subpanel_24v);
-    deviceRegistry.addDevice(&dev_lab_room_subpanel_12v);
-    deviceRegistry.addDevice(&dev_lab_room_subpanel_5v);
-    deviceRegistry.addDevice(&dev_study_room_subpanel_24v);
-    deviceRegistry.addDevice(&dev_study_room_subpanel_12v);
-    deviceRegistry.addDevice(&dev_study_room_subpanel_5v);
-    deviceRegistry.addDevice(&dev_gun_drawers_24v);
-    deviceRegistry.addDevice(&dev_gun_drawers_12v);
-    deviceRegistry.addDevice(&dev_gun_drawers_5v);
-    deviceRegistry.addDevice(&dev_keys_5v);
-    deviceRegistry.addDevice(&dev_empty_35);
-    deviceRegistry.addDevice(&dev_empty_34);
-    deviceRegistry.addDevice(&dev_controller);
     deviceRegistry.printSummary();
 
     // Build capability manifest
@@ -318,6 +355,13 @@ void setup()
     build_capability_manifest();
     Serial.println(F("[PowerCtrl] Manifest built successfully"));
 
+    // Route commands/<controller>/<device>/<command> straight to the relay it targets
+    for (RelayBinding &relay : relay_bindings)
+    {
+        mqtt.onCommands(relay.device_id, power_commands, 2, handle_relay_command, &relay);
+    }
+    mqtt.onCommands(naming::DEV_CONTROLLER, controller_commands, 5, handle_controller_command);
+
     // Initialize MQTT
     Serial.println(F("[PowerCtrl] Initializing MQTT..."));
     if (!mqtt.begin())
@@ -344,24 +388,15 @@ void setup()
 
             // Register with Sentient system
             Serial.println(F("[PowerCtrl] Registering with Sentient system..."));
-            if (manifest.publish_registration(mqtt.get_client(), naming::ROOM_ID, naming::CONTROLLER_ID))
+            if (manifest.publish_registration(mqtt, naming::ROOM_ID, naming::CONTROLLER_ID))
             {
-                Serial.println(F("[PowerCtrl] Registration successful!"));
+                Serial.println(F("[PowerCtrl] Registration started"));
             }
             else
             {
                 Serial.println(F("[PowerCtrl] Registration failed - will retry later"));
             }
 
-            // Subscribe to device-scoped commands
-            String topic = String(naming::CLIENT_ID) + "/" + naming::ROOM_ID + "/commands/" + naming::CONTROLLER_ID + "/+/+";
-            mqtt.get_client().subscribe(topic.c_str());
-            Serial.print(F("[PowerCtrl] Subscribed to: "));
-            Serial.println(topic);
-
-            // Set custom message handler for device routing
-            mqtt.get_client().setCallback(handle_mqtt_command);
-
             // Report actual physical relay states as single source of truth
             // This ensures database and cache reflect actual hardware state after power-up
             Serial.println(F("[PowerCtrl] Reporting actual relay states..."));
@@ -386,261 +421,59 @@ void loop()
 {
     // LISTEN for commands from Sentient
     mqtt.loop();
+    manifest.loop();
 }
 
 // ============================================================================
 // SECTION 4: COMMAND HANDLER
 // ============================================================================
 
-void handle_mqtt_command(char *topic, uint8_t *payload, unsigned int length)
+// Indices into controller_commands
+enum ControllerCommand
 {
-    // Parse topic to extract device and command
-    String device, command;
-
-    // Parse topic segments: client/room/commands/controller/device/command
-    int seg = 0;
-    const char *p = topic;
-    const char *segStart[8] = {nullptr};
-    size_t segLen[8] = {0};
-    segStart[0] = p;
-
-    while (*p && seg < 8)
-    {
-        if (*p == '/')
-        {
-            segLen[seg] = p - segStart[seg];
-            seg++;
-            if (seg < 8)
-                segStart[seg] = p + 1;
-        }
-        p++;
-    }
-    if (seg < 8 && segStart[seg])
-    {
-        segLen[seg] = p - segStart[seg];
-        seg++;
-    }
+    CONTROLLER_ALL_ON,
+    CONTROLLER_ALL_OFF,
+    CONTROLLER_EMERGENCY_OFF,
+    CONTROLLER_RESET,
+    CONTROLLER_REQUEST_STATUS
+};
+
+void handle_relay_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx)
+{
+    RelayBinding &relay = *static_cast<RelayBinding *>(ctx);
 
-    auto equalsSeg = [&](int idx, const char *lit) -> bool
-    {
-        size_t litLen = strlen(lit);
-        return segLen[idx] == litLen && strncmp(segStart[idx], lit, litLen) == 0;
-    };
+    // power_commands: 0 = power_on, 1 = power_off
+    set_relay_state(relay.pin, cmd.index == 0, relay.state, relay.name, relay.device_id, cmd.name);
+}
 
-    // Validate topic structure and extract device/command
-    if (seg >= 6 && equalsSeg(0, naming::CLIENT_ID) && equalsSeg(1, naming::ROOM_ID) &&
-        equalsSeg(2, "commands") && equalsSeg(3, naming::CONTROLLER_ID))
+void handle_controller_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx)
+{
+    switch (cmd.index)
     {
-        device = String(segStart[4]).substring(0, segLen[4]);
-        command = String(segStart[5]).substring(0, segLen[5]);
-
-        Serial.print(F("[PowerCtrl] Device: "));
-        Serial.print(device);
-        Serial.print(F(" Command: "));
-        Serial.println(command);
-
-        // Route to device-specific handlers
-        if (device == naming::DEV_GEAR_24V)
-        {
-            if (command == "power_on")
-                set_relay_state(gear_24v_pin, true, gear_24v_state, "Gear 24V", naming::DEV_GEAR_24V, "power_on");
-            else if (command == "power_off")
-                set_relay_state(gear_24v_pin, false, gear_24v_state, "Gear 24V", naming::DEV_GEAR_24V, "power_off");
-        }
-        else if (device == naming::DEV_GEAR_12V)
-        {
-            if (command == "power_on")
-                set_relay_state(gear_12v_pin, true, gear_12v_state, "Gear 12V", naming::DEV_GEAR_12V, "power_on");
-            else if (command == "power_off")
-                set_relay_state(gear_12v_pin, false, gear_12v_state, "Gear 12V", naming::DEV_GEAR_12V, "power_off");
-        }
-        else if (device == naming::DEV_GEAR_5V)
-        {
-            if (command == "power_on")
-                set_relay_state(gear_5v_pin, true, gear_5v_state, "Gear 5V", naming::DEV_GEAR_5V, "power_on");
-            else if (command == "power_off")
-                set_relay_state(gear_5v_pin, false, gear_5v_state, "Gear 5V", naming::DEV_GEAR_5V, "power_off");
-        }
-        else if (device == naming::DEV_FLOOR_24V)
-        {
-            if (command == "power_on")
-                set_relay_state(floor_24v_pin, true, floor_24v_state, "Floor 24V", naming::DEV_FLOOR_24V, "power_on");
-            else if (command == "power_off")
-                set_relay_state(floor_24v_pin, false, floor_24v_state, "Floor 24V", naming::DEV_FLOOR_24V, "power_off");
-        }
-        else if (device == naming::DEV_FLOOR_12V)
-        {
-            if (command == "power_on")
-                set_relay_state(floor_12v_pin, true, floor_12v_state, "Floor 12V", naming::DEV_FLOOR_12V, "power_on");
-            else if (command == "power_off")
-                set_relay_state(floor_12v_pin, false, floor_12v_state, "Floor 12V", naming::DEV_FLOOR_12V, "power_off");
-        }
-        else if (device == naming::DEV_FLOOR_5V)
-        {
-            if (command == "power_on")
-                set_relay_state(floor_5v_pin, true, floor_5v_state, "Floor 5V", naming::DEV_FLOOR_5V, "power_on");
-            else if (command == "power_off")
-                set_relay_state(floor_5v_pin, false, floor_5v_state, "Floor 5V", naming::DEV_FLOOR_5V, "power_off");
-        }
-        else if (device == naming::DEV_RIDDLE_RPI_5V)
-        {
-            if (command == "power_on")
-                set_relay_state(riddle_rpi_5v_pin, true, riddle_rpi_5v_state, "Riddle RPi 5V", naming::DEV_RIDDLE_RPI_5V, "power_on");
-            else if (command == "power_off")
-                set_relay_state(riddle_rpi_5v_pin, false, riddle_rpi_5v_state, "Riddle RPi 5V", naming::DEV_RIDDLE_RPI_5V, "power_off");
-        }
-        else if (device == naming::DEV_RIDDLE_RPI_12V)
-        {
-            if (command == "power_on")
-                set_relay_state(riddle_rpi_12v_pin, true, riddle_rpi_12v_state, "Riddle RPi 12V", naming::DEV_RIDDLE_RPI_12V, "power_on");
-            else if (command == "power_off")
-                set_relay_state(riddle_rpi_12v_pin, false, riddle_rpi_12v_state, "Riddle RPi 12V", naming::DEV_RIDDLE_RPI_12V, "power_off");
-        }
-        else if (device == naming::DEV_RIDDLE_5V)
-        {
-            if (command == "power_on")
-                set_relay_state(riddle_5v_pin, true, riddle_5v_state, "Riddle 5V", naming::DEV_RIDDLE_5V, "power_on");
-            else if (command == "power_off")
-                set_relay_state(riddle_5v_pin, false, riddle_5v_state, "Riddle 5V", naming::DEV_RIDDLE_5V, "power_off");
-        }
-        else if (device == naming::DEV_BOILER_ROOM_SUBPANEL_24V)
-        {
-            if (command == "power_on")
-                set_relay_state(boiler_room_subpanel_24v_pin, true, boiler_room_subpanel_24v_state, "Boiler Subpanel 24V", naming::DEV_BOILER_ROOM_SUBPANEL_24V, "power_on");
-            else if (command == "power_off")
-                set_relay_state(boiler_room_subpanel_24v_pin, false, boiler_room_subpanel_24v_state, "Boiler Subpanel 24V", naming::DEV_BOILER_ROOM_SUBPANEL_24V, "power_off");
-        }
-        else if (device == naming::DEV_BOILER_ROOM_SUBPANEL_12V)
-        {
-            if (command == "power_on")
-                set_relay_state(boiler_room_subpanel_12v_pin, true, boiler_room_subpanel_12v_state, "Boiler Subpanel 12V", naming::DEV_BOILER_ROOM_SUBPANEL_12V, "power_on");
-            else if (command == "power_off")
-                set_relay_state(boiler_room_subpanel_12v_pin, false, boiler_room_subpanel_12v_state, "Boiler Subpanel 12V", naming::DEV_BOILER_ROOM_SUBPANEL_12V, "power_off");
-        }
-        else if (device == naming::DEV_BOILER_ROOM_SUBPANEL_5V)
-        {
-            if (command == "power_on")
-                set_relay_state(boiler_room_subpanel_5v_pin, true, boiler_room_subpanel_5v_state, "Boiler Subpanel 5V", naming::DEV_BOILER_ROOM_SUBPANEL_5V, "power_on");
-            else if (command == "power_off")
-                set_relay_state(boiler_room_subpanel_5v_pin, false, boiler_room_subpanel_5v_state, "Boiler Subpanel 5V", naming::DEV_BOILER_ROOM_SUBPANEL_5V, "power_off");
-        }
-        else if (device == naming::DEV_LAB_ROOM_SUBPANEL_24V)
-        {
-            if (command == "power_on")
-                set_relay_state(lab_room_subpanel_24v_pin, true, lab_room_subpanel_24v_state, "Lab Subpanel 24V", naming::DEV_LAB_ROOM_SUBPANEL_24V, "power_on");
-            else if (command == "power_off")
-                set_relay_state(lab_room_subpanel_24v_pin, false, lab_room_subpanel_24v_state, "Lab Subpanel 24V", naming::DEV_LAB_ROOM_SUBPANEL_24V, "power_off");
-        }
-        else if (device == naming::DEV_LAB_ROOM_SUBPANEL_12V)
-        {
-            if (command == "power_on")
-                set_relay_state(lab_room_subpanel_12v_pin, true, lab_room_subpanel_12v_state, "Lab Subpanel 12V", naming::DEV_LAB_ROOM_SUBPANEL_12V, "power_on");
-            else if (command == "power_off")
-                set_relay_state(lab_room_subpanel_12v_pin, false, lab_room_subpanel_12v_state, "Lab Subpanel 12V", naming::DEV_LAB_ROOM_SUBPANEL_12V, "power_off");
-        }
-        else if (device == naming::DEV_LAB_ROOM_SUBPANEL_5V)
-        {
-            if (command == "power_on")
-                set_relay_state(lab_room_subpanel_5v_pin, true, lab_room_subpanel_5v_state, "Lab Subpanel 5V", naming::DEV_LAB_ROOM_SUBPANEL_5V, "power_on");
-            else if (command == "power_off")
-                set_relay_state(lab_room_subpanel_5v_pin, false, lab_room_subpanel_5v_state, "Lab Subpanel 5V", naming::DEV_LAB_ROOM_SUBPANEL_5V, "power_off");
-        }
-        else if (device == naming::DEV_STUDY_ROOM_SUBPANEL_24V)
-        {
-            if (command == "power_on")
-                set_relay_state(study_room_subpanel_24v_pin, true, study_room_subpanel_24v_state, "Study Subpanel 24V", naming::DEV_STUDY_ROOM_SUBPANEL_24V, "power_on");
-            else if (command == "power_off")
-                set_relay_state(study_room_subpanel_24v_pin, false, study_room_subpanel_24v_state, "Study Subpanel 24V", naming::DEV_STUDY_ROOM_SUBPANEL_24V, "power_off");
-        }
-        else if (device == naming::DEV_STUDY_ROOM_SUBPANEL_12V)
-        {
-            if (command == "power_on")
-                set_relay_state(study_room_subpanel_12v_pin, true, study_room_subpanel_12v_state, "Study Subpanel 12V", naming::DEV_STUDY_ROOM_SUBPANEL_12V, "power_on");
-            else if (command == "power_off")
-                set_relay_state(study_room_subpanel_12v_pin, false, study_room_subpanel_12v_state, "Study Subpanel 12V", naming::DEV_STUDY_ROOM_SUBPANEL_12V, "power_off");
-        }
-        else if (device == naming::DEV_STUDY_ROOM_SUBPANEL_5V)
-        {
-            if (command == "power_on")
-                set_relay_state(study_room_subpanel_5v_pin, true, study_room_subpanel_5v_state, "Study Subpanel 5V", naming::DEV_STUDY_ROOM_SUBPANEL_5V, "power_on");
-            else if (command == "power_off")
-                set_relay_state(study_room_subpanel_5v_pin, false, study_room_subpanel_5v_state, "Study Subpanel 5V", naming::DEV_STUDY_ROOM_SUBPANEL_5V, "power_off");
-        }
-        else if (device == naming::DEV_GUN_DRAWERS_24V)
-        {
-            if (command == "power_on")
-                set_relay_state(gun_drawers_24v_pin, true, gun_drawers_24v_state, "Gun Drawers 24V", naming::DEV_GUN_DRAWERS_24V, "power_on");
-            else if (command == "power_off")
-                set_relay_state(gun_drawers_24v_pin, false, gun_drawers_24v_state, "Gun Drawers 24V", naming::DEV_GUN_DRAWERS_24V, "power_off");
-        }
-        else if (device == naming::DEV_GUN_DRAWERS_12V)
-        {
-            if (command == "power_on")
-                set_relay_state(gun_drawers_12v_pin, true, gun_drawers_12v_state, "Gun Drawers 12V", naming::DEV_GUN_DRAWERS_12V, "power_on");
-            else if (command == "power_off")
-                set_relay_state(gun_drawers_12v_pin, false, gun_drawers_12v_state, "Gun Drawers 12V", naming::DEV_GUN_DRAWERS_12V, "power_off");
-        }
-        else if (device == naming::DEV_GUN_DRAWERS_5V)
-        {
-            if (command == "power_on")
-                set_relay_state(gun_drawers_5v_pin, true, gun_drawers_5v_state, "Gun Drawers 5V", naming::DEV_GUN_DRAWERS_5V, "power_on");
-            else if (command == "power_off")
-                set_relay_state(gun_drawers_5v_pin, false, gun_drawers_5v_state, "Gun Drawers 5V", naming::DEV_GUN_DRAWERS_5V, "power_off");
-        }
-        else if (device == naming::DEV_KEYS_5V)
-        {
-            if (command == "power_on")
-                set_relay_state(keys_5v_pin, true, keys_5v_state, "Keys 5V", naming::DEV_KEYS_5V, "power_on");
-            else if (command == "power_off")
-                set_relay_state(keys_5v_pin, false, keys_5v_state, "Keys 5V", naming::DEV_KEYS_5V, "power_off");
-        }
-        else if (device == naming::DEV_EMPTY_35)
-        {
-            if (command == "power_on")
-                set_relay_state(empty_35_pin, true, empty_35_state, "Empty 35", naming::DEV_EMPTY_35, "power_on");
-            else if (command == "power_off")
-                set_relay_state(empty_35_pin, false, empty_35_state, "Empty 35", naming::DEV_EMPTY_35, "power_off");
-        }
-        else if (device == naming::DEV_EMPTY_34)
-        {
-            if (command == "power_on")
-                set_relay_state(empty_34_pin, true, empty_34_state, "Empty 34", naming::DEV_EMPTY_34, "power_on");
-            else if (command == "power_off")
-                set_relay_state(empty_34_pin, false, empty_34_state, "Empty 34", naming::DEV_EMPTY_34, "power_off");
-        }
-        else if (device == naming::DEV_CONTROLLER)
-        {
-            // Controller-level commands
-            if (command == naming::CMD_ALL_ON)
-            {
-                Serial.println(F("[PowerCtrl] ALL ON command"));
-                all_relays_on();
-                publish_hardware_status();
-            }
-            else if (command == naming::CMD_ALL_OFF)
-            {
-                Serial.println(F("[PowerCtrl] ALL OFF command"));
-                all_relays_off();
-                publish_hardware_status();
-            }
-            else if (command == naming::CMD_EMERGENCY_OFF)
-            {
-                Serial.println(F("[PowerCtrl] EMERGENCY OFF command"));
-                emergency_power_off();
-                publish_hardware_status();
-            }
-            else if (command == naming::CMD_RESET)
-            {
-                Serial.println(F("[PowerCtrl] RESET command"));
-                all_relays_off();
-                publish_hardware_status();
-            }
-            else if (command == naming::CMD_REQUEST_STATUS)
-            {
-                Serial.println(F("[PowerCtrl] Status requested"));
-                publish_full_status();
-            }
-        }
+    case CONTROLLER_ALL_ON:
+        Serial.println(F("[PowerCtrl] ALL ON command"));
+        all_relays_on();
+        publish_hardware_status();
+        break;
+    case CONTROLLER_ALL_OFF:
+        Serial.println(F("[PowerCtrl] ALL OFF command"));
+        all_relays_off();
+        publish_hardware_status();
+        break;
+    case CONTROLLER_EMERGENCY_OFF:
+        Serial.println(F("[PowerCtrl] EMERGENCY OFF command"));
+        emergency_power_off();
+        publish_hardware_status();
+        break;
+    case CONTROLLER_RESET:
+        Serial.println(F("[PowerCtrl] RESET command"));
+        all_relays_off();
+        publish_hardware_status();
+        break;
+    case CONTROLLER_REQUEST_STATUS:
+        Serial.println(F("[PowerCtrl] Status requested"));
+        publish_full_status();
+        break;
     }
 }
 
@@ -668,7 +501,7 @@ void publish_relay_state(const char *device_id, bool state)
     char jsonBuffer[128];
     serializeJson(doc, jsonBuffer);
 
-    mqtt.get_client().publish(topic.c_str(), jsonBuffer);
+    mqtt.publishTopic(topic.c_str(), jsonBuffer);
 
     Serial.print(F("[PowerCtrl] Published state for "));
     Serial.print(device_id);
@@ -701,7 +534,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command,
     char jsonBuffer[128];
     serializeJson(doc, jsonBuffer);
 
-    mqtt.get_client().publish(topic.c_str(), jsonBuffer);
+    mqtt.publishTopic(topic.c_str(), jsonBuffer);
 
     Serial.print(F("[PowerCtrl] Published ACK for "));
     Serial.print(device_id);
@@ -1067,9 +900,6 @@ void build_capability_manifest()
         firmware::VERSION,
         naming::ROOM_ID,
         naming::CONTROLLER_ID);
-
-    // Auto-generate entire manifest from device registry
-    deviceRegistry.buildManifest(manifest);
 }
 
 SentientMQTTConfig build_mqtt_config()
@@ -33,7 +33,7 @@
 #define MQTT_MAX_PACKET_SIZE 512
 #endif
 
-#include <SentientCapabilityManifest.h>
+#include <SentientManifestStream.h>
 #include <SentientMQTT.h>
 #include <SentientDeviceRegistry.h>
 #include <ArduinoJson.h>
@@ -138,12 +138,12 @@ bool vault_5v_state = false;
 // ============================================================================
 
 // Standard power commands (on/off)
-const char *power_commands[] = {
+constexpr const char *power_commands[] PROGMEM = {
     naming::CMD_POWER_ON,
     naming::CMD_POWER_OFF};
 
 // Controller-level commands
-const char *controller_commands[] = {
+constexpr const char *controller_commands[] PROGMEM = {
     naming::CMD_ALL_ON,
     naming::CMD_ALL_OFF,
     naming::CMD_EMERGENCY_OFF,
@@ -151,34 +151,97 @@ const char *controller_commands[] = {
     naming::CMD_REQUEST_STATUS};
 
 // Create device definitions for all 24 relays
-SentientDeviceDef dev_main_lighting_24v(naming::DEV_MAIN_LIGHTING_24V, naming::FRIENDLY_MAIN_LIGHTING_24V, "relay", power_commands, 2);
-SentientDeviceDef dev_main_lighting_12v(naming::DEV_MAIN_LIGHTING_12V, naming::FRIENDLY_MAIN_LIGHTING_12V, "relay", power_commands, 2);
-SentientDeviceDef dev_main_lighting_5v(naming::DEV_MAIN_LIGHTING_5V, naming::FRIENDLY_MAIN_LIGHTING_5V, "relay", power_commands, 2);
-SentientDeviceDef dev_gauges_12v_a(naming::DEV_GAUGES_12V_A, naming::FRIENDLY_GAUGES_12V_A, "relay", power_commands, 2);
-SentientDeviceDef dev_gauges_12v_b(naming::DEV_GAUGES_12V_B, naming::FRIENDLY_GAUGES_12V_B, "relay", power_commands, 2);
-SentientDeviceDef dev_gauges_5v(naming::DEV_GAUGES_5V, naming::FRIENDLY_GAUGES_5V, "relay", power_commands, 2);
-SentientDeviceDef dev_lever_boiler_5v(naming::DEV_LEVER_BOILER_5V, naming::FRIENDLY_LEVER_BOILER_5V, "relay", power_commands, 2);
-SentientDeviceDef dev_lever_boiler_12v(naming::DEV_LEVER_BOILER_12V, naming::FRIENDLY_LEVER_BOILER_12V, "relay", power_commands, 2);
-SentientDeviceDef dev_pilot_light_5v(naming::DEV_PILOT_LIGHT_5V, naming::FRIENDLY_PILOT_LIGHT_5V, "relay", power_commands, 2);
-SentientDeviceDef dev_kraken_controls_5v(naming::DEV_KRAKEN_CONTROLS_5V, naming::FRIENDLY_KRAKEN_CONTROLS_5V, "relay", power_commands, 2);
-SentientDeviceDef dev_fuse_12v(naming::DEV_FUSE_12V, naming::FRIENDLY_FUSE_12V, "relay", power_commands, 2);
-SentientDeviceDef dev_fuse_5v(naming::DEV_FUSE_5V, naming::FRIENDLY_FUSE_5V, "relay", power_commands, 2);
-SentientDeviceDef dev_syringe_24v(naming::DEV_SYRINGE_24V, naming::FRIENDLY_SYRINGE_24V, "relay", power_commands, 2);
-SentientDeviceDef dev_syringe_12v(naming::DEV_SYRINGE_12V, naming::FRIENDLY_SYRINGE_12V, "relay", power_commands, 2);
-SentientDeviceDef dev_syringe_5v(naming::DEV_SYRINGE_5V, naming::FRIENDLY_SYRINGE_5V, "relay", power_commands, 2);
-SentientDeviceDef dev_chemical_24v(naming::DEV_CHEMICAL_24V, naming::FRIENDLY_CHEMICAL_24V, "relay", power_commands, 2);
-SentientDeviceDef dev_chemical_12v(naming::DEV_CHEMICAL_12V, naming::FRIENDLY_CHEMICAL_12V, "relay", power_commands, 2);
-SentientDeviceDef dev_chemical_5v(naming::DEV_CHEMICAL_5V, naming::FRIENDLY_CHEMICAL_5V, "relay", power_commands, 2);
-SentientDeviceDef dev_crawl_space_blacklight(naming::DEV_CRAWL_SPACE_BLACKLIGHT, naming::FRIENDLY_CRAWL_SPACE_BLACKLIGHT, "relay", power_commands, 2);
-SentientDeviceDef dev_floor_audio_amp(naming::DEV_FLOOR_AUDIO_AMP, naming::FRIENDLY_FLOOR_AUDIO_AMP, "relay", power_commands, 2);
-SentientDeviceDef dev_kraken_radar_amp(naming::DEV_KRAKEN_RADAR_AMP, naming::FRIENDLY_KRAKEN_RADAR_AMP, "relay", power_commands, 2);
-SentientDeviceDef dev_vault_24v(naming::DEV_VAULT_24V, naming::FRIENDLY_VAULT_24V, "relay", power_commands, 2);
-SentientDeviceDef dev_vault_12v(naming::DEV_VAULT_12V, naming::FRIENDLY_VAULT_12V, "relay", power_commands, 2);
-SentientDeviceDef dev_vault_5v(naming::DEV_VAULT_5V, naming::FRIENDLY_VAULT_5V, "relay", power_commands, 2);
-SentientDeviceDef dev_controller(naming::DEV_CONTROLLER, naming::FRIENDLY_CONTROLLER, "controller", controller_commands, 5);
+constexpr SentientDeviceDef dev_main_lighting_24v PROGMEM(naming::DEV_MAIN_LIGHTING_24V, naming::FRIENDLY_MAIN_LIGHTING_24V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_main_lighting_12v PROGMEM(naming::DEV_MAIN_LIGHTING_12V, naming::FRIENDLY_MAIN_LIGHTING_12V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_main_lighting_5v PROGMEM(naming::DEV_MAIN_LIGHTING_5V, naming::FRIENDLY_MAIN_LIGHTING_5V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_gauges_12v_a PROGMEM(naming::DEV_GAUGES_12V_A, naming::FRIENDLY_GAUGES_12V_A, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_gauges_12v_b PROGMEM(naming::DEV_GAUGES_12V_B, naming::FRIENDLY_GAUGES_12V_B, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_gauges_5v PROGMEM(naming::DEV_GAUGES_5V, naming::FRIENDLY_GAUGES_5V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_lever_boiler_5v PROGMEM(naming::DEV_LEVER_BOILER_5V, naming::FRIENDLY_LEVER_BOILER_5V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_lever_boiler_12v PROGMEM(naming::DEV_LEVER_BOILER_12V, naming::FRIENDLY_LEVER_BOILER_12V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_pilot_light_5v PROGMEM(naming::DEV_PILOT_LIGHT_5V, naming::FRIENDLY_PILOT_LIGHT_5V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_kraken_controls_5v PROGMEM(naming::DEV_KRAKEN_CONTROLS_5V, naming::FRIENDLY_KRAKEN_CONTROLS_5V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_fuse_12v PROGMEM(naming::DEV_FUSE_12V, naming::FRIENDLY_FUSE_12V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_fuse_5v PROGMEM(naming::DEV_FUSE_5V, naming::FRIENDLY_FUSE_5V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_syringe_24v PROGMEM(naming::DEV_SYRINGE_24V, naming::FRIENDLY_SYRINGE_24V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_syringe_12v PROGMEM(naming::DEV_SYRINGE_12V, naming::FRIENDLY_SYRINGE_12V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_syringe_5v PROGMEM(naming::DEV_SYRINGE_5V, naming::FRIENDLY_SYRINGE_5V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_chemical_24v PROGMEM(naming::DEV_CHEMICAL_24V, naming::FRIENDLY_CHEMICAL_24V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_chemical_12v PROGMEM(naming::DEV_CHEMICAL_12V, naming::FRIENDLY_CHEMICAL_12V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_chemical_5v PROGMEM(naming::DEV_CHEMICAL_5V, naming::FRIENDLY_CHEMICAL_5V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_crawl_space_blacklight PROGMEM(naming::DEV_CRAWL_SPACE_BLACKLIGHT, naming::FRIENDLY_CRAWL_SPACE_BLACKLIGHT, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_floor_audio_amp PROGMEM(naming::DEV_FLOOR_AUDIO_AMP, naming::FRIENDLY_FLOOR_AUDIO_AMP, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_kraken_radar_amp PROGMEM(naming::DEV_KRAKEN_RADAR_AMP, naming::FRIENDLY_KRAKEN_RADAR_AMP, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_vault_24v PROGMEM(naming::DEV_VAULT_24V, naming::FRIENDLY_VAULT_24V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_vault_12v PROGMEM(naming::DEV_VAULT_12V, naming::FRIENDLY_VAULT_12V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_vault_5v PROGMEM(naming::DEV_VAULT_5V, naming::FRIENDLY_VAULT_5V, "relay", power_commands, 2);
+constexpr SentientDeviceDef dev_controller PROGMEM(naming::DEV_CONTROLLER, naming::FRIENDLY_CONTROLLER, "controller", controller_commands, 5);
 
 // Create the device registry
-SentientDeviceRegistry deviceRegistry;
+SENTIENT_DEVICE_REGISTRY(deviceRegistry,
+    &dev_main_lighting_24v,
+    &dev_main_lighting_12v,
+    &dev_main_lighting_5v,
+    &dev_gauges_12v_a,
+    &dev_gauges_12v_b,
+    &dev_gauges_5v,
+    &dev_lever_boiler_5v,
+    &dev_lever_boiler_12v,
+    &dev_pilot_light_5v,
+    &dev_kraken_controls_5v,
+    &dev_fuse_12v,
+    &dev_fuse_5v,
+    &dev_syringe_24v,
+    &dev_syringe_12v,
+    &dev_syringe_5v,
+    &dev_chemical_24v,
+    &dev_chemical_12v,
+    &dev_chemical_5v,
+    &dev_crawl_space_blacklight,
+    &dev_floor_audio_amp,
+    &dev_kraken_radar_amp,
+    &dev_vault_24v,
+    &dev_vault_12v,
+    &dev_vault_5v,
+    &dev_controller);
+
+// ──────────────────────────────────────────────────────────────────────────────
+// Relay Command Routing (one binding per relay device, passed as route context)
+// ──────────────────────────────────────────────────────────────────────────────
+struct RelayBinding
+{
+    int pin;
+    bool &state;
+    const char *name;
+    const char *device_id;
+};
+
+RelayBinding relay_bindings[] = {
+    {main_lighting_24v_pin, main_lighting_24v_state, "Main Lighting 24V", naming::DEV_MAIN_LIGHTING_24V},
+    {main_lighting_12v_pin, main_lighting_12v_state, "Main Lighting 12V", naming::DEV_MAIN_LIGHTING_12V},
+    {main_lighting_5v_pin, main_lighting_5v_state, "Main Lighting 5V", naming::DEV_MAIN_LIGHTING_5V},
+    {gauges_12v_a_pin, gauges_12v_a_state, "Gauges 12V A", naming::DEV_GAUGES_12V_A},
+    {gauges_12v_b_pin, gauges_12v_b_state, "Gauges 12V B", naming::DEV_GAUGES_12V_B},
+    {gauges_5v_pin, gauges_5v_state, "Gauges 5V", naming::DEV_GAUGES_5V},
+    {lever_boiler_5v_pin, lever_boiler_5v_state, "Lever Boiler 5V", naming::DEV_LEVER_BOILER_5V},
+    {lever_boiler_12v_pin, lever_boiler_12v_state, "Lever Boiler 12V", naming::DEV_LEVER_BOILER_12V},
+    {pilot_light_5v_pin, pilot_light_5v_state, "Pilot Light 5V", naming::DEV_PILOT_LIGHT_5V},
+    {kraken_controls_5v_pin, kraken_controls_5v_state, "Kraken Controls 5V", naming::DEV_KRAKEN_CONTROLS_5V},
+    {fuse_12v_pin, fuse_12v_state, "Fuse 12V", naming::DEV_FUSE_12V},
+    {fuse_5v_pin, fuse_5v_state, "Fuse 5V", naming::DEV_FUSE_5V},
+    {syringe_24v_pin, syringe_24v_state, "Syringe 24V", naming::DEV_SYRINGE_24V},
+    {syringe_12v_pin, syringe_12v_state, "Syringe 12V", naming::DEV_SYRINGE_12V},
+    {syringe_5v_pin, syringe_5v_state, "Syringe 5V", naming::DEV_SYRINGE_5V},
+    {chemical_24v_pin, chemical_24v_state, "Chemical 24V", naming::DEV_CHEMICAL_24V},
+    {chemical_12v_pin, chemical_12v_state, "Chemical 12V", naming::DEV_CHEMICAL_12V},
+    {chemical_5v_pin, chemical_5v_state, "Chemical 5V", naming::DEV_CHEMICAL_5V},
+    {crawl_space_blacklight_pin, crawl_space_blacklight_state, "Crawl Space Blacklight", naming::DEV_CRAWL_SPACE_BLACKLIGHT},
+    {floor_audio_amp_pin, floor_audio_amp_state, "Floor Audio Amp", naming::DEV_FLOOR_AUDIO_AMP},
+    {kraken_radar_amp_pin, kraken_radar_amp_state, "Kraken Radar Amp", naming::DEV_KRAKEN_RADAR_AMP},
+    {vault_24v_pin, vault_24v_state, "Vault 24V", naming::DEV_VAULT_24V},
+    {vault_12v_pin, vault_12v_state, "Vault 12V", naming::DEV_VAULT_12V},
+    {vault_5v_pin, vault_5v_state, "Vault 5V", naming::DEV_VAULT_5V},
+};
 
 // ──────────────────────────────────────────────────────────────────────────────
 // Forward Declarations
@@ -186,7 +249,8 @@ SentientDeviceRegistry deviceRegistry;
 void build_capability_manifest();
 SentientMQTTConfig build_mqtt_config();
 bool build_heartbeat_payload(JsonDocument &doc, void *ctx);
-void handle_mqtt_command(const char *command, const JsonDocument &payload, void *ctx);
+void handle_relay_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx);
+void handle_controller_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx);
 void set_relay_state(int pin, bool state, bool &state_var, const char *device_name, const char *device_id, const char *command);
 void publish_relay_state(const char *device_id, bool state);
 void publish_command_acknowledgement(const char *device_id, const char *command, bool state);
@@ -200,7 +264,7 @@ const char *build_device_identifier();
 const char *get_hardware_label();
 
 // MQTT objects
-SentientCapabilityManifest manifest;
+SentientManifestStream manifest(deviceRegistry);
 SentientMQTT mqtt(build_mqtt_config());
 
 // ============================================================================
@@ -287,33 +351,6 @@ void setup()
 
     Serial.println(F("[PowerCtrl] All 24 relays initialized to OFF"));
 
-    // Register all devices
-    Serial.println(F("[PowerCtrl] Registering devices..."));
-    deviceRegistry.addDevice(&dev_main_lighting_24v);
-    deviceRegistry.addDevice(&dev_main_lighting_12v);
-    deviceRegistry.addDevice(&dev_main_lighting_5v);
-    deviceRegistry.addDevice(&dev_gauges_12v_a);
-    deviceRegistry.addDevice(&dev_gauges_12v_b);
-    deviceRegistry.addDevice(&dev_gauges_5v);
-    deviceRegistry.addDevice(&dev_lever_boiler_5v);
-    deviceRegistry.addDevice(&dev_lever_boiler_12v);
-    deviceRegistry.addDevice(&dev_pilot_light_5v);
-    deviceRegistry.addDevice(&dev_kraken_controls_5v);
-    deviceRegistry.addDevice(&dev_fuse_12v);
-    deviceRegistry.addDevice(&dev_fuse_5v);
-    deviceRegistry.addDevice(&dev_syringe_24v);
-    deviceRegistry.addDevice(&dev_syringe_12v);
-    deviceRegistry.addDevice(&dev_syringe_5v);
-    deviceRegistry.addDevice(&dev_chemical_24v);
-    deviceRegistry.addDevice(&dev_chemical_12v);
-    deviceRegistry.addDevice(&dev_chemical_5v);
-    deviceRegistry.addDevice(&dev_crawl_space_blacklight);
-    deviceRegistry.addDevice(&dev_floor_audio_amp);
-    deviceRegistry.addDevice(&dev_kraken_radar_amp);
-    deviceRegistry.addDevice(&dev_vault_24v);
-    deviceRegistry.addDevice(&dev_vault_12v);
-    deviceRegistry.addDevice(&dev_vault_5v);
-    deviceRegistry.addDevice(&dev_controller);
     deviceRegistry.printSummary();
 
     // Build capability manifest
@@ -321,6 +358,13 @@ void setup()
     build_capability_manifest();
     Serial.println(F("[PowerCtrl] Manifest built successfully"));
 
+    // Route commands/<controller>/<device>/<command> straight to the relay it targets
+    for (RelayBinding &relay : relay_bindings)
+    {
+        mqtt.onCommands(relay.device_id, power_commands, 2, handle_relay_command, &relay);
+    }
+    mqtt.onCommands(naming::DEV_CONTROLLER, controller_commands, 5, handle_controller_command);
+
     // Initialize MQTT
     Serial.println(F("[PowerCtrl] Initializing MQTT..."));
     if (!mqtt.begin())
@@ -347,253 +391,15 @@ void setup()
 
             // Register with Sentient system
             Serial.println(F("[PowerCtrl] Registering with Sentient system..."));
-            if (manifest.publish_registration(mqtt.get_client(), naming::ROOM_ID, naming::CONTROLLER_ID))
+            if (manifest.publish_registration(mqtt, naming::ROOM_ID, naming::CONTROLLER_ID))
             {
-                Serial.println(F("[PowerCtrl] Registration successful!"));
+                Serial.println(F("[PowerCtrl] Registration started"));
             }
             else
             {
                 Serial.println(F("[PowerCtrl] Registration failed - will retry later"));
             }
 
-            // Subscribe to device-scoped commands
-            String topic = String(naming::CLIENT_ID) + "/" + naming::ROOM_ID + "/commands/" + naming::CONTROLLER_ID + "/+/+";
-            mqtt.get_client().subscribe(topic.c_str());
-            Serial.print(F("[PowerCtrl] Subscribed to: "));
-            Serial.println(topic); // Set custom message handler for device routing
-            mqtt.get_client().setCallback([](char *topic, uint8_t *payload, unsigned int length)
-                                          {
-                // Parse topic to extract device and command
-                String device, command;
-                
-                // Parse topic segments: client/room/commands/controller/device/command
-                int seg = 0;
-                const char *p = topic;
-                const char *segStart[8] = {nullptr};
-                size_t segLen[8] = {0};
-                segStart[0] = p;
-                
-                while (*p && seg < 8) {
-                    if (*p == '/') {
-                        segLen[seg] = p - segStart[seg];
-                        seg++;
-                        if (seg < 8) segStart[seg] = p + 1;
-                    }
-                    p++;
-                }
-                if (seg < 8 && segStart[seg]) {
-                    segLen[seg] = p - segStart[seg];
-                    seg++;
-                }
-                
-                auto equalsSeg = [&](int idx, const char *lit) -> bool {
-                    size_t litLen = strlen(lit);
-                    return segLen[idx] == litLen && strncmp(segStart[idx], lit, litLen) == 0;
-                };
-                
-                // Validate topic structure and extract device/command
-                if (seg >= 6 && equalsSeg(0, naming::CLIENT_ID) && equalsSeg(1, naming::ROOM_ID) && 
-                    equalsSeg(2, "commands") && equalsSeg(3, naming::CONTROLLER_ID)) {
-                    device = String(segStart[4]).substring(0, segLen[4]);
-                    command = String(segStart[5]).substring(0, segLen[5]);
-                    
-                    Serial.print(F("[PowerCtrl] Device: "));
-                    Serial.print(device);
-                    Serial.print(F(" Command: "));
-                    Serial.println(command);
-                    
-                    // Route to device-specific handlers
-                    if (device == naming::DEV_MAIN_LIGHTING_24V) {
-                        if (command == "power_on") {
-                            set_relay_state(main_lighting_24v_pin, true, main_lighting_24v_state, "Main Lighting 24V", naming::DEV_MAIN_LIGHTING_24V, "power_on");
-                        } else if (command == "power_off") {
-                            set_relay_state(main_lighting_24v_pin, false, main_lighting_24v_state, "Main Lighting 24V", naming::DEV_MAIN_LIGHTING_24V, "power_off");
-                        }
-                    }
-                    else if (device == naming::DEV_MAIN_LIGHTING_12V) {
-                        if (command == "power_on") {
-                            set_relay_state(main_lighting_12v_pin, true, main_lighting_12v_state, "Main Lighting 12V", naming::DEV_MAIN_LIGHTING_12V, "power_on");
-                        } else if (command == "power_off") {
-                            set_relay_state(main_lighting_12v_pin, false, main_lighting_12v_state, "Main Lighting 12V", naming::DEV_MAIN_LIGHTING_12V, "power_off");
-                        }
-                    }
-                    else if (device == naming::DEV_MAIN_LIGHTING_5V) {
-                        if (command == "power_on") {
-                            set_relay_state(main_lighting_5v_pin, true, main_lighting_5v_state, "Main Lighting 5V", naming::DEV_MAIN_LIGHTING_5V, "power_on");
-                        } else if (command == "power_off") {
-                            set_relay_state(main_lighting_5v_pin, false, main_lighting_5v_state, "Main Lighting 5V", naming::DEV_MAIN_LIGHTING_5V, "power_off");
-                        }
-                    }
-                    else if (device == naming::DEV_GAUGES_12V_A) {
-                        if (command == "power_on") {
-                            set_relay_state(gauges_12v_a_pin, true, gauges_12v_a_state, "Gauges 12V A", naming::DEV_GAUGES_12V_A, "power_on");
-                        } else if (command == "power_off") {
-                            set_relay_state(gauges_12v_a_pin, false, gauges_12v_a_state, "Gauges 12V A", naming::DEV_GAUGES_12V_A, "power_off");
-                        }
-                    }
-                    else if (device == naming::DEV_GAUGES_12V_B) {
-                        if (command == "power_on") {
-                            set_relay_state(gauges_12v_b_pin, true, gauges_12v_b_state, "Gauges 12V B", naming::DEV_GAUGES_12V_B, "power_on");
-                        } else if (command == "power_off") {
-                            set_relay_state(gauges_12v_b_pin, false, gauges_12v_b_state, "Gauges 12V B", naming::DEV_GAUGES_12V_B, "power_off");
-                        }
-                    }
-                    else if (device == naming::DEV_GAUGES_5V) {
-                        if (command == "power_on") {
-                            set_relay_state(gauges_5v_pin, true, gauges_5v_state, "Gauges 5V", naming::DEV_GAUGES_5V, "power_on");
-                        } else if (command == "power_off") {
-                            set_relay_state(gauges_5v_pin, false, gauges_5v_state, "Gauges 5V", naming::DEV_GAUGES_5V, "power_off");
-                        }
-                    }
-                    else if (device == naming::DEV_LEVER_BOILER_5V) {
-                        if (command == "power_on") {
-                            set_relay_state(lever_boiler_5v_pin, true, lever_boiler_5v_state, "Lever Boiler 5V", naming::DEV_LEVER_BOILER_5V, "power_on");
-                        } else if (command == "power_off") {
-                            set_relay_state(lever_boiler_5v_pin, false, lever_boiler_5v_state, "Lever Boiler 5V", naming::DEV_LEVER_BOILER_5V, "power_off");
-                        }
-                    }
-                    else if (device == naming::DEV_LEVER_BOILER_12V) {
-                        if (command == "power_on") {
-                            set_relay_state(lever_boiler_12v_pin, true, lever_boiler_12v_state, "Lever Boiler 12V", naming::DEV_LEVER_BOILER_12V, "power_on");
-                        } else if (command == "power_off") {
-                            set_relay_state(lever_boiler_12v_pin, false, lever_boiler_12v_state, "Lever Boiler 12V", naming::DEV_LEVER_BOILER_12V, "power_off");
-                        }
-                    }
-                    else if (device == naming::DEV_PILOT_LIGHT_5V) {
-                        if (command == "power_on") {
-                            set_relay_state(pilot_light_5v_pin, true, pilot_light_5v_state, "Pilot Light 5V", naming::DEV_PILOT_LIGHT_5V, "power_on");
-                        } else if (command == "power_off") {
-                            set_relay_state(pilot_light_5v_pin, false, pilot_light_5v_state, "Pilot Light 5V", naming::DEV_PILOT_LIGHT_5V, "power_off");
-                        }
-                    }
-                    else if (device == naming::DEV_KRAKEN_CONTROLS_5V) {
-                        if (command == "power_on") {
-                            set_relay_state(kraken_controls_5v_pin, true, kraken_controls_5v_state, "Kraken Controls 5V", naming::DEV_KRAKEN_CONTROLS_5V, "power_on");
-                        } else if (command == "power_off") {
-                            set_relay_state(kraken_controls_5v_pin, false, kraken_controls_5v_state, "Kraken Controls 5V", naming::DEV_KRAKEN_CONTROLS_5V, "power_off");
-                        }
-                    }
-                    else if (device == naming::DEV_FUSE_12V) {
-                        if (command == "power_on") {
-                            set_relay_state(fuse_12v_pin, true, fuse_12v_state, "Fuse 12V", naming::DEV_FUSE_12V, "power_on");
-                        } else if (command == "power_off") {
-                            set_relay_state(fuse_12v_pin, false, fuse_12v_state, "Fuse 12V", naming::DEV_FUSE_12V, "power_off");
-                        }
-                    }
-                    else if (device == naming::DEV_FUSE_5V) {
-                        if (command == "power_on") {
-                            set_relay_state(fuse_5v_pin, true, fuse_5v_state, "Fuse 5V", naming::DEV_FUSE_5V, "power_on");
-                        } else if (command == "power_off") {
-                            set_relay_state(fuse_5v_pin, false, fuse_5v_state, "Fuse 5V", naming::DEV_FUSE_5V, "power_off");
-                        }
-                    }
-                    else if (device == naming::DEV_SYRINGE_24V) {
-                        if (command == "power_on") {
-                            set_relay_state(syringe_24v_pin, true, syringe_24v_state, "Syringe 24V", naming::DEV_SYRINGE_24V, "power_on");
-                        } else if (command == "power_off") {
-                            set_relay_state(syringe_24v_pin, false, syringe_24v_state, "Syringe 24V", naming::DEV_SYRINGE_24V, "power_off");
-                        }
-                    }
-                    else if (device == naming::DEV_SYRINGE_12V) {
-                        if (command == "power_on") {
-                            set_relay_state(syringe_12v_pin, true, syringe_12v_state, "Syringe 12V", naming::DEV_SYRINGE_12V, "power_on");
-                        } else if (command == "power_off") {
-                            set_relay_state(syringe_12v_pin, false, syringe_12v_state, "Syringe 12V", naming::DEV_SYRINGE_12V, "power_off");
-                        }
-                    }
-                    else if (device == naming::DEV_SYRINGE_5V) {
-                        if (command == "power_on") {
-                            set_relay_state(syringe_5v_pin, true, syringe_5v_state, "Syringe 5V", naming::DEV_SYRINGE_5V, "power_on");
-                        } else if (command == "power_off") {
-                            set_relay_state(syringe_5v_pin, false, syringe_5v_state, "Syringe 5V", naming::DEV_SYRINGE_5V, "power_off");
-                        }
-                    }
-                    else if (device == naming::DEV_CHEMICAL_24V) {
-                        if (command == "power_on") {
-                            set_relay_state(chemical_24v_pin, true, chemical_24v_state, "Chemical 24V", naming::DEV_CHEMICAL_24V, "power_on");
-                        } else if (command == "power_off") {
-                            set_relay_state(chemical_24v_pin, false, chemical_24v_state, "Chemical 24V", naming::DEV_CHEMICAL_24V, "power_off");
-                        }
-                    }
-                    else if (device == naming::DEV_CHEMICAL_12V) {
-                        if (command == "power_on") {
-                            set_relay_state(chemical_12v_pin, true, chemical_12v_state, "Chemical 12V", naming::DEV_CHEMICAL_12V, "power_on");
-                        } else if (command == "power_off") {
-                            set_relay_state(chemical_12v_pin, false, chemical_12v_state, "Chemical 12V", naming::DEV_CHEMICAL_12V, "power_off");
-                        }
-                    }
-                    else if (device == naming::DEV_CHEMICAL_5V) {
-                        if (command == "power_on") {
-                            set_relay_state(chemical_5v_pin, true, chemical_5v_state, "Chemical 5V", naming::DEV_CHEMICAL_5V, "power_on");
-                        } else if (command == "power_off") {
-                            set_relay_state(chemical_5v_pin, false, chemical_5v_state, "Chemical 5V", naming::DEV_CHEMICAL_5V, "power_off");
-                        }
-                    }
-                    else if (device == naming::DEV_CRAWL_SPACE_BLACKLIGHT) {
-                        if (command == "power_on") {
-                            set_relay_state(crawl_space_blacklight_pin, true, crawl_space_blacklight_state, "Crawl Space Blacklight", naming::DEV_CRAWL_SPACE_BLACKLIGHT, "power_on");
-                        } else if (command == "power_off") {
-                            set_relay_state(crawl_space_blacklight_pin, false, crawl_space_blacklight_state, "Crawl Space Blacklight", naming::DEV_CRAWL_SPACE_BLACKLIGHT, "power_off");
-                        }
-                    }
-                    else if (device == naming::DEV_FLOOR_AUDIO_AMP) {
-                        if (command == "power_on") {
-                            set_relay_state(floor_audio_amp_pin, true, floor_audio_amp_state, "Floor Audio Amp", naming::DEV_FLOOR_AUDIO_AMP, "power_on");
-                        } else if (command == "power_off") {
-                            set_relay_state(floor_audio_amp_pin, false, floor_audio_amp_state, "Floor Audio Amp", naming::DEV_FLOOR_AUDIO_AMP, "power_off");
-                        }
-                    }
-                    else if (device == naming::DEV_KRAKEN_RADAR_AMP) {
-                        if (command == "power_on") {
-                            set_relay_state(kraken_radar_amp_pin, true, kraken_radar_amp_state, "Kraken Radar Amp", naming::DEV_KRAKEN_RADAR_AMP, "power_on");
-                        } else if (command == "power_off") {
-                            set_relay_state(kraken_radar_amp_pin, false, kraken_radar_amp_state, "Kraken Radar Amp", naming::DEV_KRAKEN_RADAR_AMP, "power_off");
-                        }
-                    }
-                    else if (device == naming::DEV_VAULT_24V) {
-                        if (command == "power_on") {
-                            set_relay_state(vault_24v_pin, true, vault_24v_state, "Vault 24V", naming::DEV_VAULT_24V, "power_on");
-                        } else if (command == "power_off") {
-                            set_relay_state(vault_24v_pin, false, vault_24v_state, "Vault 24V", naming::DEV_VAULT_24V, "power_off");
-                        }
-                    }
-                    else if (device == naming::DEV_VAULT_12V) {
-                        if (command == "power_on") {
-                            set_relay_state(vault_12v_pin, true, vault_12v_state, "Vault 12V", naming::DEV_VAULT_12V, "power_on");
-                        } else if (command == "power_off") {
-                            set_relay_state(vault_12v_pin, false, vault_12v_state, "Vault 12V", naming::DEV_VAULT_12V, "power_off");
-                        }
-                    }
-                    else if (device == naming::DEV_VAULT_5V) {
-                        if (command == "power_on") {
-                            set_relay_state(vault_5v_pin, true, vault_5v_state, "Vault 5V", naming::DEV_VAULT_5V, "power_on");
-                        } else if (command == "power_off") {
-                            set_relay_state(vault_5v_pin, false, vault_5v_state, "Vault 5V", naming::DEV_VAULT_5V, "power_off");
-                        }
-                    }
-                    else if (device == naming::DEV_CONTROLLER) {
-                        // Controller-level commands handled separately
-                        if (command == naming::CMD_ALL_ON) {
-                            all_relays_on();
-                        } else if (command == naming::CMD_ALL_OFF) {
-                            all_relays_off();
-                        } else if (command == naming::CMD_EMERGENCY_OFF) {
-                            emergency_power_off();
-                        } else if (command == naming::CMD_RESET) {
-                            all_relays_off();
-                        } else if (command == naming::CMD_REQUEST_STATUS) {
-                            publish_full_status();
-                        }
-                    }
-                    else {
-                        Serial.print(F("[PowerCtrl] Unknown device: "));
-                        Serial.println(device);
-                    }
-
-                    // Publish status update after command
-                    publish_hardware_status();
-                } });
-
             // Report actual physical relay states as single source of truth
             // This ensures database and cache reflect actual hardware state after power-up
             Serial.println(F("[PowerCtrl] Reporting actual relay states..."));
@@ -618,70 +424,60 @@ void loop()
 {
     // LISTEN for commands from Sentient
     mqtt.loop();
+    manifest.loop();
 }
 
 // ============================================================================
 // SECTION 4: COMMAND HANDLER
 // ============================================================================
 
-void handle_mqtt_command(const char *command, const JsonDocument &payload, void *ctx)
+// Indices into controller_commands
+enum ControllerCommand
 {
-    String cmd = String(command);
-
-    Serial.print(F("[PowerCtrl] Command: "));
-    Serial.println(command);
-
-    // ──────────────────────────────────────────────────────────────────────────
-    // INDIVIDUAL DEVICE COMMANDS
-    // ──────────────────────────────────────────────────────────────────────────
+    CONTROLLER_ALL_ON,
+    CONTROLLER_ALL_OFF,
+    CONTROLLER_EMERGENCY_OFF,
+    CONTROLLER_RESET,
+    CONTROLLER_REQUEST_STATUS
+};
+
+void handle_relay_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx)
+{
+    RelayBinding &relay = *static_cast<RelayBinding *>(ctx);
 
-    // Main Lighting
-    if (cmd.equals(naming::CMD_POWER_ON))
-    {
-        // Command routing handled by device context from MQTT topic
-        // This simplified handler will be expanded with device-specific routing
-    }
-    else if (cmd.equals(naming::CMD_POWER_OFF))
-    {
-        // Same as above
-    }
+    // power_commands: 0 = power_on, 1 = power_off
+    set_relay_state(relay.pin, cmd.index == 0, relay.state, relay.name, relay.device_id, cmd.name);
+    publish_hardware_status();
+}
 
-    // ──────────────────────────────────────────────────────────────────────────
-    // CONTROLLER-LEVEL COMMANDS
-    // ──────────────────────────────────────────────────────────────────────────
-    else if (cmd.equals(naming::CMD_ALL_ON))
+void handle_controller_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx)
+{
+    switch (cmd.index)
     {
+    case CONTROLLER_ALL_ON:
         Serial.println(F("[PowerCtrl] ALL ON command"));
         all_relays_on();
         publish_hardware_status();
-    }
-    else if (cmd.equals(naming::CMD_ALL_OFF))
-    {
+        break;
+    case CONTROLLER_ALL_OFF:
         Serial.println(F("[PowerCtrl] ALL OFF command"));
         all_relays_off();
         publish_hardware_status();
-    }
-    else if (cmd.equals(naming::CMD_EMERGENCY_OFF))
-    {
+        break;
+    case CONTROLLER_EMERGENCY_OFF:
         Serial.println(F("[PowerCtrl] EMERGENCY OFF command"));
         emergency_power_off();
         publish_hardware_status();
-    }
-    else if (cmd.equals(naming::CMD_RESET))
-    {
+        break;
+    case CONTROLLER_RESET:
         Serial.println(F("[PowerCtrl] RESET command"));
         all_relays_off();
         publish_hardware_status();
-    }
-    else if (cmd.equals(naming::CMD_REQUEST_STATUS))
-    {
+        break;
+    case CONTROLLER_REQUEST_STATUS:
         Serial.println(F("[PowerCtrl] Status requested"));
         publish_full_status();
-    }
-    else
-    {
-        Serial.print(F("[PowerCtrl] Unknown command: "));
-        Serial.println(command);
+        break;
     }
 }
 
@@ -709,7 +505,7 @@ void publish_relay_state(const char *device_id, bool state)
     char jsonBuffer[128];
     serializeJson(doc, jsonBuffer);
 
-    mqtt.get_client().publish(topic.c_str(), jsonBuffer);
+    mqtt.publishTopic(topic.c_str(), jsonBuffer);
 
     Serial.print(F("[PowerCtrl] Published state for "));
     Serial.print(device_id);
@@ -742,7 +538,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command,
     char jsonBuffer[128];
     serializeJson(doc, jsonBuffer);
 
-    mqtt.get_client().publish(topic.c_str(), jsonBuffer);
+    mqtt.publishTopic(topic.c_str(), jsonBuffer);
 
     Serial.print(F("[PowerCtrl] Published ACK for "));
     Serial.print(device_id);
@@ -1108,9 +904,6 @@ void build_capability_manifest()
         firmware::VERSION,
         naming::ROOM_ID,
         naming::CONTROLLER_ID);
-
-    // Auto-generate entire manifest from device registry
-    deviceRegistry.buildManifest(manifest);
 }
 
 SentientMQTTConfig build_mqtt_config()
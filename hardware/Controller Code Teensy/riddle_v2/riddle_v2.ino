@@ -5,11 +5,12 @@
 
 #define SUPPRESS_ERROR_MESSAGE_FOR_BEGIN
 #include <SentientMQTT.h>
-#include <SentientCapabilityManifest.h>
+#include <SentientManifestStream.h>
 #include <SentientDeviceRegistry.h>
 #include <ArduinoJson.h>
 #include <Adafruit_NeoPixel.h>
 #include <AccelStepper.h>
+#include <SentientInputs.h>
 #include "controller_naming.h"
 
 // ══════════════════════════════════════════════════════════════════════════════
@@ -136,6 +137,49 @@ const int knob_pin_f2[] = {6, 15, 18, 35, 38};
 const int knob_pin_g1[] = {2, 9, 10, 25, 26, 49};
 const int knob_pin_g4[] = {4, 5, 16, 17, 36, 37};
 
+// Knob inputs and the letters each one lights
+struct Knob
+{
+    uint8_t pin;
+    const int *leds;
+    uint8_t led_count;
+};
+
+#define KNOB(pin, leds) {pin, leds, sizeof(leds) / sizeof(leds[0])}
+
+const Knob knobs[] = {
+    KNOB(PIN_KNOB_A2, knob_pin_a2),
+    KNOB(PIN_KNOB_A3, knob_pin_a3),
+    KNOB(PIN_B1, knob_pin_b1),
+    KNOB(PIN_B2, knob_pin_b2),
+    KNOB(PIN_B3, knob_pin_b3),
+    KNOB(PIN_B4, knob_pin_b4),
+    KNOB(PIN_C1, knob_pin_c1),
+    KNOB(PIN_C2, knob_pin_c2),
+    KNOB(PIN_C3, knob_pin_c3),
+    KNOB(PIN_C4, knob_pin_c4),
+    KNOB(PIN_D1, knob_pin_d1),
+    KNOB(PIN_D2, knob_pin_d2),
+    KNOB(PIN_D3, knob_pin_d3),
+    KNOB(PIN_D4, knob_pin_d4),
+    KNOB(PIN_E1, knob_pin_e1),
+    KNOB(PIN_E2, knob_pin_e2),
+    KNOB(PIN_E3, knob_pin_e3),
+    KNOB(PIN_E4, knob_pin_e4),
+    KNOB(PIN_F1, knob_pin_f1),
+    KNOB(PIN_F2, knob_pin_f2),
+    KNOB(PIN_F3, knob_pin_f3),
+    KNOB(PIN_F4, knob_pin_f4),
+    KNOB(PIN_G1, knob_pin_g1),
+    KNOB(PIN_G4, knob_pin_g4)};
+const int NUM_KNOBS = sizeof(knobs) / sizeof(knobs[0]);
+
+// Debounced inputs: knobs are inputs 0..NUM_KNOBS-1 (active HIGH), then the buttons
+SentientInputs inputs;
+int input_button[3];
+uint32_t knob_inputs = 0;   // Input mask covering every knob
+uint32_t button_inputs = 0; // Input mask covering the buttons
+
 // Hardware objects
 Adafruit_NeoPixel strip(NUM_LEDS, PIN_LED_STRIP, NEO_GRB + NEO_KHZ800);
 AccelStepper stepper_one(AccelStepper::FULL4WIRE, PIN_STEPPER1_1, PIN_STEPPER1_2, PIN_STEPPER1_3, PIN_STEPPER1_4);
@@ -146,29 +190,29 @@ AccelStepper stepper_two(AccelStepper::FULL4WIRE, PIN_STEPPER2_1, PIN_STEPPER2_2
 // ══════════════════════════════════════════════════════════════════════════════
 
 // Door commands
-const char *door_commands[] = {
+constexpr const char *door_commands[] PROGMEM = {
     naming::CMD_DOOR_LIFT,
     naming::CMD_DOOR_LOWER,
     naming::CMD_DOOR_STOP};
 
 // Maglock commands
-const char *maglock_commands[] = {
+constexpr const char *maglock_commands[] PROGMEM = {
     naming::CMD_MAGLOCK_LOCK,
     naming::CMD_MAGLOCK_UNLOCK};
 
 // LED strip commands
-const char *led_commands[] = {
+constexpr const char *led_commands[] PROGMEM = {
     naming::CMD_LEDS_ON,
     naming::CMD_LEDS_OFF,
     naming::CMD_LEDS_SET_BRIGHTNESS};
 
 // Controller state command
-const char *controller_commands[] = {
+constexpr const char *controller_commands[] PROGMEM = {
     naming::CMD_SET_STATE,
     naming::CMD_RESET};
 
 // Door sensors
-const char *door_sensors[] = {
+constexpr const char *door_sensors[] PROGMEM = {
     naming::SENSOR_DOOR_POSITION,
     naming::SENSOR_ENDSTOP_UP_R,
     naming::SENSOR_ENDSTOP_UP_L,
@@ -176,61 +220,68 @@ const char *door_sensors[] = {
     naming::SENSOR_ENDSTOP_DN_L};
 
 // Knob sensors
-const char *knob_sensors[] = {
+constexpr const char *knob_sensors[] PROGMEM = {
     naming::SENSOR_KNOB_STATE,
     naming::SENSOR_ACTIVE_CLUE};
 
 // Button sensors
-const char *button_sensors[] = {
+constexpr const char *button_sensors[] PROGMEM = {
     naming::SENSOR_BUTTON_1,
     naming::SENSOR_BUTTON_2,
     naming::SENSOR_BUTTON_3};
 
 // Device definitions
-SentientDeviceDef dev_door(
+constexpr SentientDeviceDef dev_door PROGMEM(
     naming::DEV_DOOR,
     naming::FRIENDLY_DOOR,
     "actuator",
     door_commands, 3);
 
-SentientDeviceDef dev_maglock(
+constexpr SentientDeviceDef dev_maglock PROGMEM(
     naming::DEV_MAGLOCK,
     naming::FRIENDLY_MAGLOCK,
     "relay",
     maglock_commands, 2);
 
-SentientDeviceDef dev_leds(
+constexpr SentientDeviceDef dev_leds PROGMEM(
     naming::DEV_LED_STRIP,
     naming::FRIENDLY_LED_STRIP,
     "led_strip",
     led_commands, 3);
 
-SentientDeviceDef dev_controller(
+constexpr SentientDeviceDef dev_controller PROGMEM(
     naming::CONTROLLER_ID,
     naming::CONTROLLER_FRIENDLY_NAME,
     "controller",
     controller_commands, 2);
 
-SentientDeviceDef dev_door_sensors(
+constexpr SentientDeviceDef dev_door_sensors PROGMEM(
     naming::DEV_DOOR,
     naming::FRIENDLY_DOOR,
     "sensor",
     door_sensors, 5, true); // input only
 
-SentientDeviceDef dev_knobs(
+constexpr SentientDeviceDef dev_knobs PROGMEM(
     naming::DEV_KNOBS,
     naming::FRIENDLY_KNOBS,
     "sensor",
     knob_sensors, 2, true); // input only
 
-SentientDeviceDef dev_buttons(
+constexpr SentientDeviceDef dev_buttons PROGMEM(
     naming::DEV_BUTTONS,
     naming::FRIENDLY_BUTTONS,
     "sensor",
     button_sensors, 3, true); // input only
 
 // Create the device registry
-SentientDeviceRegistry deviceRegistry;
+SENTIENT_DEVICE_REGISTRY(deviceRegistry,
+    &dev_door,
+    &dev_maglock,
+    &dev_leds,
+    &dev_controller,
+    &dev_door_sensors,
+    &dev_knobs,
+    &dev_buttons);
 
 // ══════════════════════════════════════════════════════════════════════════════
 // SECTION 3: SENTIENT MQTT INITIALIZATION
@@ -256,12 +307,13 @@ SentientMQTTConfig make_mqtt_config()
 }
 
 SentientMQTT sentient(make_mqtt_config());
-SentientCapabilityManifest manifest;
+SentientManifestStream manifest(deviceRegistry);
 
 // Forward declarations
 void handle_mqtt_command(const char *command, const JsonDocument &payload, void *ctx);
 void publish_command_acknowledgement(const char *device_id, const char *command);
 void read_sensors();
+void publish_buttons();
 void update_leds();
 void handle_knobs();
 void button_riddle();
@@ -282,34 +334,18 @@ void setup()
     Serial.println(F("[Riddle] Starting..."));
 
     // Setup input pins
-    pinMode(PIN_KNOB_A2, INPUT_PULLUP);
-    pinMode(PIN_KNOB_A3, INPUT_PULLUP);
-    pinMode(PIN_B1, INPUT_PULLUP);
-    pinMode(PIN_B2, INPUT_PULLUP);
-    pinMode(PIN_B3, INPUT_PULLUP);
-    pinMode(PIN_B4, INPUT_PULLUP);
-    pinMode(PIN_C1, INPUT_PULLUP);
-    pinMode(PIN_C2, INPUT_PULLUP);
-    pinMode(PIN_C3, INPUT_PULLUP);
-    pinMode(PIN_C4, INPUT_PULLUP);
-    pinMode(PIN_D1, INPUT_PULLUP);
-    pinMode(PIN_D2, INPUT_PULLUP);
-    pinMode(PIN_D3, INPUT_PULLUP);
-    pinMode(PIN_D4, INPUT_PULLUP);
-    pinMode(PIN_E1, INPUT_PULLUP);
-    pinMode(PIN_E2, INPUT_PULLUP);
-    pinMode(PIN_E3, INPUT_PULLUP);
-    pinMode(PIN_E4, INPUT_PULLUP);
-    pinMode(PIN_F1, INPUT_PULLUP);
-    pinMode(PIN_F2, INPUT_PULLUP);
-    pinMode(PIN_F3, INPUT_PULLUP);
-    pinMode(PIN_F4, INPUT_PULLUP);
-    pinMode(PIN_G1, INPUT_PULLUP);
-    pinMode(PIN_G4, INPUT_PULLUP);
-
-    pinMode(PIN_BUTTON_1, INPUT_PULLUP);
-    pinMode(PIN_BUTTON_2, INPUT_PULLUP);
-    pinMode(PIN_BUTTON_3, INPUT_PULLUP);
+    for (int i = 0; i < NUM_KNOBS; i++)
+    {
+        knob_inputs |= SentientInputs::bit(inputs.add(knobs[i].pin, false));
+    }
+    input_button[0] = inputs.add(PIN_BUTTON_1);
+    input_button[1] = inputs.add(PIN_BUTTON_2);
+    input_button[2] = inputs.add(PIN_BUTTON_3);
+    for (int i = 0; i < 3; i++)
+    {
+        button_inputs |= SentientInputs::bit(input_button[i]);
+    }
+    inputs.begin(10);
 
     pinMode(PIN_ENDSTOP_UP_R, INPUT_PULLUP);
     pinMode(PIN_ENDSTOP_UP_L, INPUT_PULLUP);
@@ -331,15 +367,6 @@ void setup()
     strip.setBrightness(50);
     strip.show();
 
-    // Register all devices
-    Serial.println(F("[INIT] Registering devices..."));
-    deviceRegistry.addDevice(&dev_door);
-    deviceRegistry.addDevice(&dev_maglock);
-    deviceRegistry.addDevice(&dev_leds);
-    deviceRegistry.addDevice(&dev_controller);
-    deviceRegistry.addDevice(&dev_door_sensors);
-    deviceRegistry.addDevice(&dev_knobs);
-    deviceRegistry.addDevice(&dev_buttons);
     deviceRegistry.printSummary(); // Build capability manifest
     Serial.println(F("[INIT] Building capability manifest..."));
     manifest.set_controller_info(
@@ -349,7 +376,6 @@ void setup()
         naming::ROOM_ID,
         naming::CONTROLLER_ID);
 
-    deviceRegistry.buildManifest(manifest);
     Serial.println(F("[INIT] Manifest built from device registry"));
 
     // Initialize Sentient MQTT
@@ -373,9 +399,9 @@ void setup()
 
         // Register with Sentient system
         Serial.println(F("[INIT] Registering with Sentient system..."));
-        if (manifest.publish_registration(sentient.get_client(), naming::ROOM_ID, naming::CONTROLLER_ID))
+        if (manifest.publish_registration(sentient, naming::ROOM_ID, naming::CONTROLLER_ID))
         {
-            Serial.println(F("[INIT] Registration successful!"));
+            Serial.println(F("[INIT] Registration started"));
         }
         else
         {
@@ -398,8 +424,10 @@ void loop()
 {
     // 1. LISTEN for commands from Sentient
     sentient.loop();
+    manifest.loop();
 
     // 2. DETECT sensor changes and publish if needed
+    inputs.update();
     read_sensors();
 
     // 3. EXECUTE state-specific operations
@@ -577,7 +605,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
                       String(naming::CAT_ACKNOWLEDGEMENT) + "/" + String(naming::CONTROLLER_ID) + "/" +
                       String(device_id) + "/" + String(command);
 
-    sentient.get_client().publish(ackTopic.c_str(), buf, false);
+    sentient.publishTopic(ackTopic.c_str(), buf);
 
     Serial.print(F("[ACK] -> "));
     Serial.println(ackTopic);
@@ -629,197 +657,65 @@ void read_sensors()
             doc.clear();
         }
 
-        // Publish button states
-        doc["button_1"] = !digitalRead(PIN_BUTTON_1);
-        doc["button_2"] = !digitalRead(PIN_BUTTON_2);
-        doc["button_3"] = !digitalRead(PIN_BUTTON_3);
-        sentient.publishJson(naming::CAT_SENSORS, naming::SENSOR_BUTTON_1, doc);
-        doc.clear();
+        publish_buttons();
     }
+    else if (inputs.changed() & button_inputs)
+    {
+        // Debounced button changes go out straight away
+        publish_buttons();
+    }
+}
+
+void publish_buttons()
+{
+    JsonDocument doc;
+    doc["button_1"] = inputs.active(input_button[0]);
+    doc["button_2"] = inputs.active(input_button[1]);
+    doc["button_3"] = inputs.active(input_button[2]);
+    sentient.publishJson(naming::CAT_SENSORS, naming::SENSOR_BUTTON_1, doc);
 } // ══════════════════════════════════════════════════════════════════════════════
 // SECTION 8: KNOB PUZZLE LOGIC
 // ══════════════════════════════════════════════════════════════════════════════
 
 void button_riddle()
 {
-    static bool last_button1 = HIGH;
-    static bool last_button2 = HIGH;
-    static bool last_button3 = HIGH;
-
-    bool button1 = digitalRead(PIN_BUTTON_1);
-    bool button2 = digitalRead(PIN_BUTTON_2);
-    bool button3 = digitalRead(PIN_BUTTON_3);
-
-    // Detect button press (transition from HIGH to LOW)
-    if (button1 == LOW && last_button1 == HIGH)
-    {
-        active_clue = 1;
-        Serial.println(F("[BUTTON] Clue 1 selected"));
-    }
-    else if (button2 == LOW && last_button2 == HIGH)
+    // Debounced press edges; the first button pressed wins
+    const uint32_t pressed = inputs.pressed();
+    for (int i = 0; i < 3; i++)
     {
-        active_clue = 2;
-        Serial.println(F("[BUTTON] Clue 2 selected"));
-    }
-    else if (button3 == LOW && last_button3 == HIGH)
-    {
-        active_clue = 3;
-        Serial.println(F("[BUTTON] Clue 3 selected"));
+        if (pressed & SentientInputs::bit(input_button[i]))
+        {
+            active_clue = i + 1;
+            Serial.print(F("[BUTTON] Clue "));
+            Serial.print(active_clue);
+            Serial.println(F(" selected"));
+            break;
+        }
     }
-
-    last_button1 = button1;
-    last_button2 = button2;
-    last_button3 = button3;
 }
 
 void handle_knobs()
 {
-    // Reset LED letters array
-    memset(led_letters, 0, sizeof(led_letters));
-
-    // Check each knob and update LED mapping
-    if (digitalRead(PIN_KNOB_A2) == HIGH)
-    {
-        for (size_t i = 0; i < sizeof(knob_pin_a2) / sizeof(knob_pin_a2[0]); i++)
-            led_letters[knob_pin_a2[i]]++;
-    }
-
-    if (digitalRead(PIN_KNOB_A3) == HIGH)
-    {
-        for (size_t i = 0; i < sizeof(knob_pin_a3) / sizeof(knob_pin_a3[0]); i++)
-            led_letters[knob_pin_a3[i]]++;
-    }
-
-    if (digitalRead(PIN_B1) == HIGH)
-    {
-        for (size_t i = 0; i < sizeof(knob_pin_b1) / sizeof(knob_pin_b1[0]); i++)
-            led_letters[knob_pin_b1[i]]++;
-    }
-
-    if (digitalRead(PIN_B2) == HIGH)
-    {
-        for (size_t i = 0; i < sizeof(knob_pin_b2) / sizeof(knob_pin_b2[0]); i++)
-            led_letters[knob_pin_b2[i]]++;
-    }
-
-    if (digitalRead(PIN_B3) == HIGH)
-    {
-        for (size_t i = 0; i < sizeof(knob_pin_b3) / sizeof(knob_pin_b3[0]); i++)
-            led_letters[knob_pin_b3[i]]++;
-    }
-
-    if (digitalRead(PIN_B4) == HIGH)
-    {
-        for (size_t i = 0; i < sizeof(knob_pin_b4) / sizeof(knob_pin_b4[0]); i++)
-            led_letters[knob_pin_b4[i]]++;
-    }
-
-    if (digitalRead(PIN_C1) == HIGH)
-    {
-        for (size_t i = 0; i < sizeof(knob_pin_c1) / sizeof(knob_pin_c1[0]); i++)
-            led_letters[knob_pin_c1[i]]++;
-    }
-
-    if (digitalRead(PIN_C2) == HIGH)
-    {
-        for (size_t i = 0; i < sizeof(knob_pin_c2) / sizeof(knob_pin_c2[0]); i++)
-            led_letters[knob_pin_c2[i]]++;
-    }
-
-    if (digitalRead(PIN_C3) == HIGH)
-    {
-        for (size_t i = 0; i < sizeof(knob_pin_c3) / sizeof(knob_pin_c3[0]); i++)
-            led_letters[knob_pin_c3[i]]++;
-    }
-
-    if (digitalRead(PIN_C4) == HIGH)
-    {
-        for (size_t i = 0; i < sizeof(knob_pin_c4) / sizeof(knob_pin_c4[0]); i++)
-            led_letters[knob_pin_c4[i]]++;
-    }
-
-    if (digitalRead(PIN_D1) == HIGH)
-    {
-        for (size_t i = 0; i < sizeof(knob_pin_d1) / sizeof(knob_pin_d1[0]); i++)
-            led_letters[knob_pin_d1[i]]++;
-    }
-
-    if (digitalRead(PIN_D2) == HIGH)
-    {
-        for (size_t i = 0; i < sizeof(knob_pin_d2) / sizeof(knob_pin_d2[0]); i++)
-            led_letters[knob_pin_d2[i]]++;
-    }
-
-    if (digitalRead(PIN_D3) == HIGH)
-    {
-        for (size_t i = 0; i < sizeof(knob_pin_d3) / sizeof(knob_pin_d3[0]); i++)
-            led_letters[knob_pin_d3[i]]++;
-    }
-
-    if (digitalRead(PIN_D4) == HIGH)
-    {
-        for (size_t i = 0; i < sizeof(knob_pin_d4) / sizeof(knob_pin_d4[0]); i++)
-            led_letters[knob_pin_d4[i]]++;
-    }
-
-    if (digitalRead(PIN_E1) == HIGH)
-    {
-        for (size_t i = 0; i < sizeof(knob_pin_e1) / sizeof(knob_pin_e1[0]); i++)
-            led_letters[knob_pin_e1[i]]++;
-    }
-
-    if (digitalRead(PIN_E2) == HIGH)
-    {
-        for (size_t i = 0; i < sizeof(knob_pin_e2) / sizeof(knob_pin_e2[0]); i++)
-            led_letters[knob_pin_e2[i]]++;
-    }
-
-    if (digitalRead(PIN_E3) == HIGH)
-    {
-        for (size_t i = 0; i < sizeof(knob_pin_e3) / sizeof(knob_pin_e3[0]); i++)
-            led_letters[knob_pin_e3[i]]++;
-    }
-
-    if (digitalRead(PIN_E4) == HIGH)
-    {
-        for (size_t i = 0; i < sizeof(knob_pin_e4) / sizeof(knob_pin_e4[0]); i++)
-            led_letters[knob_pin_e4[i]]++;
-    }
-
-    if (digitalRead(PIN_F1) == HIGH)
-    {
-        for (size_t i = 0; i < sizeof(knob_pin_f1) / sizeof(knob_pin_f1[0]); i++)
-            led_letters[knob_pin_f1[i]]++;
-    }
-
-    if (digitalRead(PIN_F2) == HIGH)
-    {
-        for (size_t i = 0; i < sizeof(knob_pin_f2) / sizeof(knob_pin_f2[0]); i++)
-            led_letters[knob_pin_f2[i]]++;
-    }
-
-    if (digitalRead(PIN_F3) == HIGH)
-    {
-        for (size_t i = 0; i < sizeof(knob_pin_f3) / sizeof(knob_pin_f3[0]); i++)
-            led_letters[knob_pin_f3[i]]++;
-    }
-
-    if (digitalRead(PIN_F4) == HIGH)
+    // Recount only when a knob has moved since the last count
+    static uint32_t counted_knobs = ~0ul;
+    const uint32_t knob_state = inputs.state() & knob_inputs;
+    if (knob_state == counted_knobs)
     {
-        for (size_t i = 0; i < sizeof(knob_pin_f4) / sizeof(knob_pin_f4[0]); i++)
-            led_letters[knob_pin_f4[i]]++;
+        return;
     }
+    counted_knobs = knob_state;
 
-    if (digitalRead(PIN_G1) == HIGH)
-    {
-        for (size_t i = 0; i < sizeof(knob_pin_g1) / sizeof(knob_pin_g1[0]); i++)
-            led_letters[knob_pin_g1[i]]++;
-    }
+    // Reset LED letters array
+    memset(led_letters, 0, sizeof(led_letters));
 
-    if (digitalRead(PIN_G4) == HIGH)
+    // Each knob that is on lights its letters
+    for (int k = 0; k < NUM_KNOBS; k++)
     {
-        for (size_t i = 0; i < sizeof(knob_pin_g4) / sizeof(knob_pin_g4[0]); i++)
-            led_letters[knob_pin_g4[i]]++;
+        if (inputs.active(k))
+        {
+            for (uint8_t i = 0; i < knobs[k].led_count; i++)
+                led_letters[knobs[k].leds[i]]++;
+        }
     }
 }
 
@@ -4,9 +4,10 @@
 // ══════════════════════════════════════════════════════════════════════════════
 
 #include <SentientMQTT.h>
-#include <SentientCapabilityManifest.h>
+#include <SentientManifestStream.h>
 #include <SentientDeviceRegistry.h>
 #include <ArduinoJson.h>
+#include <SentientInputs.h>
 #include "controller_naming.h"
 #include "FirmwareMetadata.h"
 
@@ -70,42 +71,73 @@ const unsigned long heartbeat_interval_ms = 5000;
 // STATE MANAGEMENT
 // ══════════════════════════════════════════════════════════════════════════════
 
-// Sensor state tracking
-int porthole_a1_last = -1, porthole_a2_last = -1;
-int porthole_b1_last = -1, porthole_b2_last = -1;
-int porthole_c1_last = -1, porthole_c2_last = -1;
-
-int tentacle_a1_last = -1, tentacle_a2_last = -1, tentacle_a3_last = -1, tentacle_a4_last = -1;
-int tentacle_b1_last = -1, tentacle_b2_last = -1, tentacle_b3_last = -1, tentacle_b4_last = -1;
-int tentacle_c1_last = -1, tentacle_c2_last = -1, tentacle_c3_last = -1, tentacle_c4_last = -1;
-int tentacle_d1_last = -1, tentacle_d2_last = -1, tentacle_d3_last = -1, tentacle_d4_last = -1;
+// Sensor inputs, in input index order
+struct SensorInput
+{
+    uint8_t pin;
+    const char *device_id;
+    const char *sensor_name;
+};
+
+const SensorInput sensor_inputs[] = {
+    {PIN_PORTHOLE_A1, naming::DEV_PORTHOLE_CONTROLLER, naming::SENSOR_PORTHOLE_A1},
+    {PIN_PORTHOLE_A2, naming::DEV_PORTHOLE_CONTROLLER, naming::SENSOR_PORTHOLE_A2},
+    {PIN_PORTHOLE_B1, naming::DEV_PORTHOLE_CONTROLLER, naming::SENSOR_PORTHOLE_B1},
+    {PIN_PORTHOLE_B2, naming::DEV_PORTHOLE_CONTROLLER, naming::SENSOR_PORTHOLE_B2},
+    {PIN_PORTHOLE_C1, naming::DEV_PORTHOLE_CONTROLLER, naming::SENSOR_PORTHOLE_C1},
+    {PIN_PORTHOLE_C2, naming::DEV_PORTHOLE_CONTROLLER, naming::SENSOR_PORTHOLE_C2},
+    {PIN_TENTACLE_A1, naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_A1},
+    {PIN_TENTACLE_A2, naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_A2},
+    {PIN_TENTACLE_A3, naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_A3},
+    {PIN_TENTACLE_A4, naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_A4},
+    {PIN_TENTACLE_B1, naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_B1},
+    {PIN_TENTACLE_B2, naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_B2},
+    {PIN_TENTACLE_B3, naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_B3},
+    {PIN_TENTACLE_B4, naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_B4},
+    {PIN_TENTACLE_C1, naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_C1},
+    {PIN_TENTACLE_C2, naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_C2},
+    {PIN_TENTACLE_C3, naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_C3},
+    {PIN_TENTACLE_C4, naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_C4},
+    {PIN_TENTACLE_D1, naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_D1},
+    {PIN_TENTACLE_D2, naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_D2},
+    {PIN_TENTACLE_D3, naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_D3},
+    {PIN_TENTACLE_D4, naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_D4}};
+const int NUM_SENSOR_INPUTS = sizeof(sensor_inputs) / sizeof(sensor_inputs[0]);
+
+// Debounced, sampled from the GPIO ports in the background
+SentientInputs inputs;
 
 // ══════════════════════════════════════════════════════════════════════════════
 // DEVICE REGISTRY
 // ══════════════════════════════════════════════════════════════════════════════
 
-const char *mover_commands[] = {naming::CMD_UP, naming::CMD_DOWN, naming::CMD_STOP};
-const char *motor_commands[] = {naming::CMD_MOTOR_ON, naming::CMD_MOTOR_OFF};
-const char *porthole_control_commands[] = {naming::CMD_OPEN, naming::CMD_CLOSE};
+constexpr const char *mover_commands[] PROGMEM = {naming::CMD_UP, naming::CMD_DOWN, naming::CMD_STOP};
+constexpr const char *motor_commands[] PROGMEM = {naming::CMD_MOTOR_ON, naming::CMD_MOTOR_OFF};
+constexpr const char *porthole_control_commands[] PROGMEM = {naming::CMD_OPEN, naming::CMD_CLOSE};
 
-const char *porthole_sensors[] = {
+constexpr const char *porthole_sensors[] PROGMEM = {
     naming::SENSOR_PORTHOLE_A1, naming::SENSOR_PORTHOLE_A2,
     naming::SENSOR_PORTHOLE_B1, naming::SENSOR_PORTHOLE_B2,
     naming::SENSOR_PORTHOLE_C1, naming::SENSOR_PORTHOLE_C2};
 
-const char *tentacle_sensors[] = {
+constexpr const char *tentacle_sensors[] PROGMEM = {
     naming::SENSOR_TENTACLE_A1, naming::SENSOR_TENTACLE_A2, naming::SENSOR_TENTACLE_A3, naming::SENSOR_TENTACLE_A4,
     naming::SENSOR_TENTACLE_B1, naming::SENSOR_TENTACLE_B2, naming::SENSOR_TENTACLE_B3, naming::SENSOR_TENTACLE_B4,
     naming::SENSOR_TENTACLE_C1, naming::SENSOR_TENTACLE_C2, naming::SENSOR_TENTACLE_C3, naming::SENSOR_TENTACLE_C4,
     naming::SENSOR_TENTACLE_D1, naming::SENSOR_TENTACLE_D2, naming::SENSOR_TENTACLE_D3, naming::SENSOR_TENTACLE_D4};
 
-SentientDeviceDef dev_tentacle_mover_a(naming::DEV_TENTACLE_MOVER_A, "Tentacle Mover A", "motor", mover_commands, 3);
-SentientDeviceDef dev_tentacle_mover_b(naming::DEV_TENTACLE_MOVER_B, "Tentacle Mover B", "motor", mover_commands, 3);
-SentientDeviceDef dev_riddle_motor(naming::DEV_RIDDLE_MOTOR, "Riddle Motor", "motor", motor_commands, 2);
-SentientDeviceDef dev_porthole_controller(naming::DEV_PORTHOLE_CONTROLLER, "Porthole Controller", "actuator", porthole_control_commands, 2, porthole_sensors, 6);
-SentientDeviceDef dev_tentacle_sensors(naming::DEV_TENTACLE_SENSORS, "Tentacle Sensors", "sensor_array", nullptr, 0, tentacle_sensors, 16);
+constexpr SentientDeviceDef dev_tentacle_mover_a PROGMEM(naming::DEV_TENTACLE_MOVER_A, "Tentacle Mover A", "motor", mover_commands, 3);
+constexpr SentientDeviceDef dev_tentacle_mover_b PROGMEM(naming::DEV_TENTACLE_MOVER_B, "Tentacle Mover B", "motor", mover_commands, 3);
+constexpr SentientDeviceDef dev_riddle_motor PROGMEM(naming::DEV_RIDDLE_MOTOR, "Riddle Motor", "motor", motor_commands, 2);
+constexpr SentientDeviceDef dev_porthole_controller PROGMEM(naming::DEV_PORTHOLE_CONTROLLER, "Porthole Controller", "actuator", porthole_control_commands, 2, porthole_sensors, 6);
+constexpr SentientDeviceDef dev_tentacle_sensors PROGMEM(naming::DEV_TENTACLE_SENSORS, "Tentacle Sensors", "sensor_array", nullptr, 0, tentacle_sensors, 16);
 
-SentientDeviceRegistry deviceRegistry;
+SENTIENT_DEVICE_REGISTRY(deviceRegistry,
+    &dev_tentacle_mover_a,
+    &dev_tentacle_mover_b,
+    &dev_riddle_motor,
+    &dev_porthole_controller,
+    &dev_tentacle_sensors);
 
 // ══════════════════════════════════════════════════════════════════════════════
 // SENTIENT MQTT INITIALIZATION
@@ -131,7 +163,7 @@ SentientMQTTConfig make_mqtt_config()
 }
 
 SentientMQTT sentient(make_mqtt_config());
-SentientCapabilityManifest manifest;
+SentientManifestStream manifest(deviceRegistry);
 
 void handle_mqtt_command(const char *command, const JsonDocument &payload, void *ctx);
 void publish_command_acknowledgement(const char *device_id, const char *command);
@@ -140,151 +172,23 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
 // SENSOR MONITORING
 // ══════════════════════════════════════════════════════════════════════════════
 
-void publish_sensor(const char *device_id, const char *sensor_name, int value)
+void publish_sensor(const char *device_id, const char *sensor_name, bool active)
 {
     JsonDocument doc;
-    doc[sensor_name] = (value == LOW); // INPUT_PULLUP inverted
+    doc[sensor_name] = active; // Switch closed (INPUT_PULLUP, active LOW)
     sentient.publishJson(naming::CAT_SENSORS, device_id, doc);
 }
 
 void monitor_sensors()
 {
-    // Porthole sensors
-    int pa1 = digitalRead(PIN_PORTHOLE_A1);
-    int pa2 = digitalRead(PIN_PORTHOLE_A2);
-    int pb1 = digitalRead(PIN_PORTHOLE_B1);
-    int pb2 = digitalRead(PIN_PORTHOLE_B2);
-    int pc1 = digitalRead(PIN_PORTHOLE_C1);
-    int pc2 = digitalRead(PIN_PORTHOLE_C2);
-
-    if (pa1 != porthole_a1_last)
-    {
-        publish_sensor(naming::DEV_PORTHOLE_CONTROLLER, naming::SENSOR_PORTHOLE_A1, pa1);
-        porthole_a1_last = pa1;
-    }
-    if (pa2 != porthole_a2_last)
-    {
-        publish_sensor(naming::DEV_PORTHOLE_CONTROLLER, naming::SENSOR_PORTHOLE_A2, pa2);
-        porthole_a2_last = pa2;
-    }
-    if (pb1 != porthole_b1_last)
-    {
-        publish_sensor(naming::DEV_PORTHOLE_CONTROLLER, naming::SENSOR_PORTHOLE_B1, pb1);
-        porthole_b1_last = pb1;
-    }
-    if (pb2 != porthole_b2_last)
-    {
-        publish_sensor(naming::DEV_PORTHOLE_CONTROLLER, naming::SENSOR_PORTHOLE_B2, pb2);
-        porthole_b2_last = pb2;
-    }
-    if (pc1 != porthole_c1_last)
-    {
-        publish_sensor(naming::DEV_PORTHOLE_CONTROLLER, naming::SENSOR_PORTHOLE_C1, pc1);
-        porthole_c1_last = pc1;
-    }
-    if (pc2 != porthole_c2_last)
-    {
-        publish_sensor(naming::DEV_PORTHOLE_CONTROLLER, naming::SENSOR_PORTHOLE_C2, pc2);
-        porthole_c2_last = pc2;
-    }
-
-    // Tentacle sensors
-    int ta1 = digitalRead(PIN_TENTACLE_A1);
-    int ta2 = digitalRead(PIN_TENTACLE_A2);
-    int ta3 = digitalRead(PIN_TENTACLE_A3);
-    int ta4 = digitalRead(PIN_TENTACLE_A4);
-    int tb1 = digitalRead(PIN_TENTACLE_B1);
-    int tb2 = digitalRead(PIN_TENTACLE_B2);
-    int tb3 = digitalRead(PIN_TENTACLE_B3);
-    int tb4 = digitalRead(PIN_TENTACLE_B4);
-    int tc1 = digitalRead(PIN_TENTACLE_C1);
-    int tc2 = digitalRead(PIN_TENTACLE_C2);
-    int tc3 = digitalRead(PIN_TENTACLE_C3);
-    int tc4 = digitalRead(PIN_TENTACLE_C4);
-    int td1 = digitalRead(PIN_TENTACLE_D1);
-    int td2 = digitalRead(PIN_TENTACLE_D2);
-    int td3 = digitalRead(PIN_TENTACLE_D3);
-    int td4 = digitalRead(PIN_TENTACLE_D4);
-
-    if (ta1 != tentacle_a1_last)
-    {
-        publish_sensor(naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_A1, ta1);
-        tentacle_a1_last = ta1;
-    }
-    if (ta2 != tentacle_a2_last)
-    {
-        publish_sensor(naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_A2, ta2);
-        tentacle_a2_last = ta2;
-    }
-    if (ta3 != tentacle_a3_last)
-    {
-        publish_sensor(naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_A3, ta3);
-        tentacle_a3_last = ta3;
-    }
-    if (ta4 != tentacle_a4_last)
-    {
-        publish_sensor(naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_A4, ta4);
-        tentacle_a4_last = ta4;
-    }
-    if (tb1 != tentacle_b1_last)
-    {
-        publish_sensor(naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_B1, tb1);
-        tentacle_b1_last = tb1;
-    }
-    if (tb2 != tentacle_b2_last)
-    {
-        publish_sensor(naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_B2, tb2);
-        tentacle_b2_last = tb2;
-    }
-    if (tb3 != tentacle_b3_last)
-    {
-        publish_sensor(naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_B3, tb3);
-        tentacle_b3_last = tb3;
-    }
-    if (tb4 != tentacle_b4_last)
-    {
-        publish_sensor(naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_B4, tb4);
-        tentacle_b4_last = tb4;
-    }
-    if (tc1 != tentacle_c1_last)
-    {
-        publish_sensor(naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_C1, tc1);
-        tentacle_c1_last = tc1;
-    }
-    if (tc2 != tentacle_c2_last)
-    {
-        publish_sensor(naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_C2, tc2);
-        tentacle_c2_last = tc2;
-    }
-    if (tc3 != tentacle_c3_last)
-    {
-        publish_sensor(naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_C3, tc3);
-        tentacle_c3_last = tc3;
-    }
-    if (tc4 != tentacle_c4_last)
-    {
-        publish_sensor(naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_C4, tc4);
-        tentacle_c4_last = tc4;
-    }
-    if (td1 != tentacle_d1_last)
-    {
-        publish_sensor(naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_D1, td1);
-        tentacle_d1_last = td1;
-    }
-    if (td2 != tentacle_d2_last)
-    {
-        publish_sensor(naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_D2, td2);
-        tentacle_d2_last = td2;
-    }
-    if (td3 != tentacle_d3_last)
-    {
-        publish_sensor(naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_D3, td3);
-        tentacle_d3_last = td3;
-    }
-    if (td4 != tentacle_d4_last)
+    // Only inputs whose debounced state changed are published; the first
+    // pass after begin() reports every input once
+    uint32_t changed = inputs.update();
+    while (changed)
     {
-        publish_sensor(naming::DEV_TENTACLE_SENSORS, naming::SENSOR_TENTACLE_D4, td4);
-        tentacle_d4_last = td4;
+        const int i = __builtin_ctz(changed);
+        changed &= changed - 1;
+        publish_sensor(sensor_inputs[i].device_id, sensor_inputs[i].sensor_name, inputs.active(i));
     }
 }
 
@@ -307,35 +211,16 @@ void setup()
     digitalWrite(PIN_TENTACLE_MOVE_B1, LOW);
     digitalWrite(PIN_TENTACLE_MOVE_B2, LOW);
 
-    // Initialize porthole sensors
-    pinMode(PIN_PORTHOLE_A1, INPUT_PULLUP);
-    pinMode(PIN_PORTHOLE_A2, INPUT_PULLUP);
-    pinMode(PIN_PORTHOLE_B1, INPUT_PULLUP);
-    pinMode(PIN_PORTHOLE_B2, INPUT_PULLUP);
-    pinMode(PIN_PORTHOLE_C1, INPUT_PULLUP);
-    pinMode(PIN_PORTHOLE_C2, INPUT_PULLUP);
-
     // Initialize riddle motor
     pinMode(PIN_RIDDLE_MOTOR, OUTPUT);
     digitalWrite(PIN_RIDDLE_MOTOR, LOW);
 
-    // Initialize tentacle sensors
-    pinMode(PIN_TENTACLE_A1, INPUT_PULLUP);
-    pinMode(PIN_TENTACLE_A2, INPUT_PULLUP);
-    pinMode(PIN_TENTACLE_A3, INPUT_PULLUP);
-    pinMode(PIN_TENTACLE_A4, INPUT_PULLUP);
-    pinMode(PIN_TENTACLE_B1, INPUT_PULLUP);
-    pinMode(PIN_TENTACLE_B2, INPUT_PULLUP);
-    pinMode(PIN_TENTACLE_B3, INPUT_PULLUP);
-    pinMode(PIN_TENTACLE_B4, INPUT_PULLUP);
-    pinMode(PIN_TENTACLE_C1, INPUT_PULLUP);
-    pinMode(PIN_TENTACLE_C2, INPUT_PULLUP);
-    pinMode(PIN_TENTACLE_C3, INPUT_PULLUP);
-    pinMode(PIN_TENTACLE_C4, INPUT_PULLUP);
-    pinMode(PIN_TENTACLE_D1, INPUT_PULLUP);
-    pinMode(PIN_TENTACLE_D2, INPUT_PULLUP);
-    pinMode(PIN_TENTACLE_D3, INPUT_PULLUP);
-    pinMode(PIN_TENTACLE_D4, INPUT_PULLUP);
+    // Initialize porthole and tentacle sensors
+    for (int i = 0; i < NUM_SENSOR_INPUTS; i++)
+    {
+        inputs.add(sensor_inputs[i].pin);
+    }
+    inputs.begin(20);
 
     // Initialize porthole control
     pinMode(PIN_PORTHOLE_OPEN, OUTPUT);
@@ -347,17 +232,11 @@ void setup()
     delay(2000);
     Serial.println(F("[Study A] Starting..."));
 
-    deviceRegistry.addDevice(&dev_tentacle_mover_a);
-    deviceRegistry.addDevice(&dev_tentacle_mover_b);
-    deviceRegistry.addDevice(&dev_riddle_motor);
-    deviceRegistry.addDevice(&dev_porthole_controller);
-    deviceRegistry.addDevice(&dev_tentacle_sensors);
     // deviceRegistry.printSummary(); // Commented out - causes crash with large sensor array
 
     Serial.println(F("[Study A] Building manifest..."));
     manifest.set_controller_info(naming::CONTROLLER_ID, naming::CONTROLLER_FRIENDLY_NAME,
                                  firmware::VERSION, naming::ROOM_ID, naming::CONTROLLER_ID);
-    deviceRegistry.buildManifest(manifest);
     Serial.println(F("[Study A] Manifest built"));
 
     sentient.begin();
@@ -372,7 +251,7 @@ void setup()
 
     if (sentient.isConnected())
     {
-        manifest.publish_registration(sentient.get_client(), naming::ROOM_ID, naming::CONTROLLER_ID);
+        manifest.publish_registration(sentient, naming::ROOM_ID, naming::CONTROLLER_ID);
     }
 
     Serial.println(F("[Study A] Ready"));
@@ -385,6 +264,7 @@ void setup()
 void loop()
 {
     sentient.loop();
+    manifest.loop();
     monitor_sensors();
 }
 
@@ -516,7 +396,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
                       String(naming::CAT_ACKNOWLEDGEMENT) + "/" + String(naming::CONTROLLER_ID) + "/" +
                       String(device_id) + "/" + String(command);
 
-    sentient.get_client().publish(ackTopic.c_str(), buf, false);
+    sentient.publishTopic(ackTopic.c_str(), buf);
 
     Serial.print(F("[ACK] -> "));
     Serial.println(ackTopic);
@@ -4,8 +4,9 @@
 // ══════════════════════════════════════════════════════════════════════════════
 
 #include <SentientMQTT.h>
-#include <SentientCapabilityManifest.h>
+#include <SentientManifestStream.h>
 #include <SentientDeviceRegistry.h>
+#include <SentientMotionPlanner.h>
 #include <ArduinoJson.h>
 #include "controller_naming.h"
 #include "FirmwareMetadata.h"
@@ -67,23 +68,34 @@ const unsigned long heartbeat_interval_ms = 5000;
 // DEVICE REGISTRY
 // ══════════════════════════════════════════════════════════════════════════════
 
-const char *motor_commands[] = {naming::CMD_START, naming::CMD_STOP, naming::CMD_SLOW, naming::CMD_FAST};
-const char *power_commands[] = {naming::CMD_ON, naming::CMD_OFF};
-const char *fog_commands[] = {naming::CMD_ON, naming::CMD_OFF, naming::CMD_FOG_TRIGGER};
-
-SentientDeviceDef dev_study_fan(naming::DEV_STUDY_FAN, "Study Fan", "stepper_motor", motor_commands, 4);
-SentientDeviceDef dev_wall_gear_1(naming::DEV_WALL_GEAR_1, "Wall Gear 1", "stepper_motor", motor_commands, 4);
-SentientDeviceDef dev_wall_gear_2(naming::DEV_WALL_GEAR_2, "Wall Gear 2", "stepper_motor", motor_commands, 4);
-SentientDeviceDef dev_wall_gear_3(naming::DEV_WALL_GEAR_3, "Wall Gear 3", "stepper_motor", motor_commands, 4);
-SentientDeviceDef dev_tv_1(naming::DEV_TV_1, "TV 1", "power_control", power_commands, 2);
-SentientDeviceDef dev_tv_2(naming::DEV_TV_2, "TV 2", "power_control", power_commands, 2);
-SentientDeviceDef dev_makservo(naming::DEV_MAKSERVO, "Makservo", "power_control", power_commands, 2);
-SentientDeviceDef dev_fog_machine(naming::DEV_FOG_MACHINE, "Fog Machine", "fog_control", fog_commands, 3);
-SentientDeviceDef dev_study_fan_light(naming::DEV_STUDY_FAN_LIGHT, "Study Fan Light", "light", power_commands, 2);
-SentientDeviceDef dev_blacklights(naming::DEV_BLACKLIGHTS, "Blacklights", "light", power_commands, 2);
-SentientDeviceDef dev_nixie_leds(naming::DEV_NIXIE_LEDS, "Nixie LEDs", "light", power_commands, 2);
-
-SentientDeviceRegistry deviceRegistry;
+constexpr const char *motor_commands[] PROGMEM = {naming::CMD_START, naming::CMD_STOP, naming::CMD_SLOW, naming::CMD_FAST};
+constexpr const char *power_commands[] PROGMEM = {naming::CMD_ON, naming::CMD_OFF};
+constexpr const char *fog_commands[] PROGMEM = {naming::CMD_ON, naming::CMD_OFF, naming::CMD_FOG_TRIGGER};
+
+constexpr SentientDeviceDef dev_study_fan PROGMEM(naming::DEV_STUDY_FAN, "Study Fan", "stepper_motor", motor_commands, 4);
+constexpr SentientDeviceDef dev_wall_gear_1 PROGMEM(naming::DEV_WALL_GEAR_1, "Wall Gear 1", "stepper_motor", motor_commands, 4);
+constexpr SentientDeviceDef dev_wall_gear_2 PROGMEM(naming::DEV_WALL_GEAR_2, "Wall Gear 2", "stepper_motor", motor_commands, 4);
+constexpr SentientDeviceDef dev_wall_gear_3 PROGMEM(naming::DEV_WALL_GEAR_3, "Wall Gear 3", "stepper_motor", motor_commands, 4);
+constexpr SentientDeviceDef dev_tv_1 PROGMEM(naming::DEV_TV_1, "TV 1", "power_control", power_commands, 2);
+constexpr SentientDeviceDef dev_tv_2 PROGMEM(naming::DEV_TV_2, "TV 2", "power_control", power_commands, 2);
+constexpr SentientDeviceDef dev_makservo PROGMEM(naming::DEV_MAKSERVO, "Makservo", "power_control", power_commands, 2);
+constexpr SentientDeviceDef dev_fog_machine PROGMEM(naming::DEV_FOG_MACHINE, "Fog Machine", "fog_control", fog_commands, 3);
+constexpr SentientDeviceDef dev_study_fan_light PROGMEM(naming::DEV_STUDY_FAN_LIGHT, "Study Fan Light", "light", power_commands, 2);
+constexpr SentientDeviceDef dev_blacklights PROGMEM(naming::DEV_BLACKLIGHTS, "Blacklights", "light", power_commands, 2);
+constexpr SentientDeviceDef dev_nixie_leds PROGMEM(naming::DEV_NIXIE_LEDS, "Nixie LEDs", "light", power_commands, 2);
+
+SENTIENT_DEVICE_REGISTRY(deviceRegistry,
+    &dev_study_fan,
+    &dev_wall_gear_1,
+    &dev_wall_gear_2,
+    &dev_wall_gear_3,
+    &dev_tv_1,
+    &dev_tv_2,
+    &dev_makservo,
+    &dev_fog_machine,
+    &dev_study_fan_light,
+    &dev_blacklights,
+    &dev_nixie_leds);
 
 // ══════════════════════════════════════════════════════════════════════════════
 // SENTIENT MQTT INITIALIZATION
@@ -109,65 +121,75 @@ SentientMQTTConfig make_mqtt_config()
 }
 
 SentientMQTT sentient(make_mqtt_config());
-SentientCapabilityManifest manifest;
+SentientManifestStream manifest(deviceRegistry);
 
-void handle_mqtt_command(const char *command, const JsonDocument &payload, void *ctx);
+void handle_motor_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx);
+void handle_output_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx);
+void handle_fog_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx);
 void publish_command_acknowledgement(const char *device_id, const char *command);
 
 // ══════════════════════════════════════════════════════════════════════════════
-// STEPPER CONTROL (Direct control, no library)
+// STEPPER CONTROL (SentientMotion, timer-driven)
 // ══════════════════════════════════════════════════════════════════════════════
 
-enum MotorState
+// Each motor is its own motion group, so they start, change speed and stop independently
+enum MotorGroup : uint8_t
 {
-    STOPPED,
-    RUNNING_SLOW,
-    RUNNING_FAST
+    GROUP_FAN,
+    GROUP_GEAR_1,
+    GROUP_GEAR_2,
+    GROUP_GEAR_3
 };
 
-struct StepperMotor
+const float MOTOR_SLOW_RATE = 500.0;     // steps/sec
+const float MOTOR_FAST_RATE = 1500.0;    // steps/sec
+const float MOTOR_ACCELERATION = 1000.0; // steps/sec² when switching between slow and fast
+const int8_t MOTOR_FORWARD = 1;          // Each group holds a single axis
+
+SentientMotionPlanner motors;
+
+// Command routing context for each motor device
+struct MotorBinding
 {
-    int step_pos_pin;
-    int step_neg_pin;
-    int dir_pos_pin;
-    int dir_neg_pin;
-    MotorState state;
-    unsigned long last_step_time;
-    unsigned long step_interval; // microseconds
+    uint8_t group;
+    int enable_pin;
+    bool dedicated_enable; // Fan has its own enable; the wall gears share PIN_GEARS_ENABLE
+    const char *label;
 };
 
-StepperMotor fan_motor = {PIN_FAN_STEP_POS, PIN_FAN_STEP_NEG, PIN_FAN_DIR_POS, PIN_FAN_DIR_NEG, STOPPED, 0, 2000};
-StepperMotor gear1_motor = {PIN_GEAR1_STEP_POS, PIN_GEAR1_STEP_NEG, PIN_GEAR1_DIR_POS, PIN_GEAR1_DIR_NEG, STOPPED, 0, 2000};
-StepperMotor gear2_motor = {PIN_GEAR2_STEP_POS, PIN_GEAR2_STEP_NEG, PIN_GEAR2_DIR_POS, PIN_GEAR2_DIR_NEG, STOPPED, 0, 2000};
-StepperMotor gear3_motor = {PIN_GEAR3_STEP_POS, PIN_GEAR3_STEP_NEG, PIN_GEAR3_DIR_POS, PIN_GEAR3_DIR_NEG, STOPPED, 0, 2000};
-
-// Forward declarations
-void step_motor(StepperMotor &motor);
-void update_motors();
+MotorBinding fan_binding = {GROUP_FAN, PIN_FAN_ENABLE, true, "Study Fan"};
+MotorBinding gear1_binding = {GROUP_GEAR_1, PIN_GEARS_ENABLE, false, "Wall Gear 1"};
+MotorBinding gear2_binding = {GROUP_GEAR_2, PIN_GEARS_ENABLE, false, "Wall Gear 2"};
+MotorBinding gear3_binding = {GROUP_GEAR_3, PIN_GEARS_ENABLE, false, "Wall Gear 3"};
 
-void step_motor(StepperMotor &motor)
+// Command routing context for simple on/off outputs
+struct OutputBinding
 {
-    if (motor.state == STOPPED)
-        return;
+    int pin;
+    const char *label;
+};
 
-    unsigned long now = micros();
-    if (now - motor.last_step_time >= motor.step_interval)
-    {
-        digitalWrite(motor.step_pos_pin, HIGH);
-        digitalWrite(motor.step_neg_pin, LOW);
-        delayMicroseconds(10);
-        digitalWrite(motor.step_pos_pin, LOW);
-        digitalWrite(motor.step_neg_pin, HIGH);
-        motor.last_step_time = now;
-    }
-}
+OutputBinding tv1_binding = {PIN_TV_1, "TV 1"};
+OutputBinding tv2_binding = {PIN_TV_2, "TV 2"};
+OutputBinding makservo_binding = {PIN_MAKSERVO, "Makservo"};
+OutputBinding study_fan_light_binding = {PIN_STUDY_FAN_LIGHT, "Study Fan Light"};
+OutputBinding blacklights_binding = {PIN_BLACKLIGHTS, "Blacklights"};
+OutputBinding nixie_leds_binding = {PIN_NIXIE_LEDS, "Nixie LEDs"};
 
-void update_motors()
+void add_motor(uint8_t group, int step_pos, int step_neg, int dir_pos, int dir_neg)
 {
-    step_motor(fan_motor);
-    step_motor(gear1_motor);
-    step_motor(gear2_motor);
-    step_motor(gear3_motor);
+    // DIR has never been driven on these motors: keep the driver's default
+    // (DIR optocoupler off) as the running direction
+    SentientAxisConfig axis;
+    axis.group = group;
+    axis.pins = {(uint8_t)step_pos, (uint8_t)step_neg, (uint8_t)dir_pos, (uint8_t)dir_neg, true};
+    motors.addAxis(axis);
+
+    SentientMotionConfig motion;
+    motion.startRate = MOTOR_SLOW_RATE;
+    motion.maxRate = MOTOR_FAST_RATE;
+    motion.acceleration = MOTOR_ACCELERATION;
+    motors.configureGroup(group, motion);
 }
 
 // ══════════════════════════════════════════════════════════════════════════════
@@ -179,28 +201,13 @@ void setup()
     pinMode(PIN_POWER_LED, OUTPUT);
     digitalWrite(PIN_POWER_LED, HIGH);
 
-    // Initialize stepper pins
-    pinMode(PIN_FAN_STEP_POS, OUTPUT);
-    pinMode(PIN_FAN_STEP_NEG, OUTPUT);
-    pinMode(PIN_FAN_DIR_POS, OUTPUT);
-    pinMode(PIN_FAN_DIR_NEG, OUTPUT);
-    pinMode(PIN_FAN_ENABLE, OUTPUT);
-
-    pinMode(PIN_GEAR1_STEP_POS, OUTPUT);
-    pinMode(PIN_GEAR1_STEP_NEG, OUTPUT);
-    pinMode(PIN_GEAR1_DIR_POS, OUTPUT);
-    pinMode(PIN_GEAR1_DIR_NEG, OUTPUT);
-
-    pinMode(PIN_GEAR2_STEP_POS, OUTPUT);
-    pinMode(PIN_GEAR2_STEP_NEG, OUTPUT);
-    pinMode(PIN_GEAR2_DIR_POS, OUTPUT);
-    pinMode(PIN_GEAR2_DIR_NEG, OUTPUT);
-
-    pinMode(PIN_GEAR3_STEP_POS, OUTPUT);
-    pinMode(PIN_GEAR3_STEP_NEG, OUTPUT);
-    pinMode(PIN_GEAR3_DIR_POS, OUTPUT);
-    pinMode(PIN_GEAR3_DIR_NEG, OUTPUT);
+    // Initialize steppers (order must match MotorGroup)
+    add_motor(GROUP_FAN, PIN_FAN_STEP_POS, PIN_FAN_STEP_NEG, PIN_FAN_DIR_POS, PIN_FAN_DIR_NEG);
+    add_motor(GROUP_GEAR_1, PIN_GEAR1_STEP_POS, PIN_GEAR1_STEP_NEG, PIN_GEAR1_DIR_POS, PIN_GEAR1_DIR_NEG);
+    add_motor(GROUP_GEAR_2, PIN_GEAR2_STEP_POS, PIN_GEAR2_STEP_NEG, PIN_GEAR2_DIR_POS, PIN_GEAR2_DIR_NEG);
+    add_motor(GROUP_GEAR_3, PIN_GEAR3_STEP_POS, PIN_GEAR3_STEP_NEG, PIN_GEAR3_DIR_POS, PIN_GEAR3_DIR_NEG);
 
+    pinMode(PIN_FAN_ENABLE, OUTPUT);
     pinMode(PIN_GEARS_ENABLE, OUTPUT);
     pinMode(PIN_MOTORS_POWER, OUTPUT);
 
@@ -231,27 +238,28 @@ void setup()
     delay(2000);
     Serial.println(F("[Study B] Starting..."));
 
-    deviceRegistry.addDevice(&dev_study_fan);
-    deviceRegistry.addDevice(&dev_wall_gear_1);
-    deviceRegistry.addDevice(&dev_wall_gear_2);
-    deviceRegistry.addDevice(&dev_wall_gear_3);
-    deviceRegistry.addDevice(&dev_tv_1);
-    deviceRegistry.addDevice(&dev_tv_2);
-    deviceRegistry.addDevice(&dev_makservo);
-    deviceRegistry.addDevice(&dev_fog_machine);
-    deviceRegistry.addDevice(&dev_study_fan_light);
-    deviceRegistry.addDevice(&dev_blacklights);
-    deviceRegistry.addDevice(&dev_nixie_leds);
     // deviceRegistry.printSummary(); // Commented out to prevent stack overflow
 
     Serial.println(F("[Study B] Building manifest..."));
     manifest.set_controller_info(naming::CONTROLLER_ID, naming::CONTROLLER_FRIENDLY_NAME,
                                  firmware::VERSION, naming::ROOM_ID, naming::CONTROLLER_ID);
-    deviceRegistry.buildManifest(manifest);
     Serial.println(F("[Study B] Manifest built"));
 
+    // Route each device's commands straight to its handler; the index passed
+    // to the handler is the command's position in the arrays above
+    sentient.onCommands(naming::DEV_STUDY_FAN, motor_commands, 4, handle_motor_command, &fan_binding);
+    sentient.onCommands(naming::DEV_WALL_GEAR_1, motor_commands, 4, handle_motor_command, &gear1_binding);
+    sentient.onCommands(naming::DEV_WALL_GEAR_2, motor_commands, 4, handle_motor_command, &gear2_binding);
+    sentient.onCommands(naming::DEV_WALL_GEAR_3, motor_commands, 4, handle_motor_command, &gear3_binding);
+    sentient.onCommands(naming::DEV_TV_1, power_commands, 2, handle_output_command, &tv1_binding);
+    sentient.onCommands(naming::DEV_TV_2, power_commands, 2, handle_output_command, &tv2_binding);
+    sentient.onCommands(naming::DEV_MAKSERVO, power_commands, 2, handle_output_command, &makservo_binding);
+    sentient.onCommands(naming::DEV_STUDY_FAN_LIGHT, power_commands, 2, handle_output_command, &study_fan_light_binding);
+    sentient.onCommands(naming::DEV_BLACKLIGHTS, power_commands, 2, handle_output_command, &blacklights_binding);
+    sentient.onCommands(naming::DEV_NIXIE_LEDS, power_commands, 2, handle_output_command, &nixie_leds_binding);
+    sentient.onCommands(naming::DEV_FOG_MACHINE, fog_commands, 3, handle_fog_command);
+
     sentient.begin();
-    sentient.setCommandCallback(handle_mqtt_command);
 
     unsigned long connection_start = millis();
     while (!sentient.isConnected() && (millis() - connection_start < 5000))
@@ -262,7 +270,7 @@ void setup()
 
     if (sentient.isConnected())
     {
-        manifest.publish_registration(sentient.get_client(), naming::ROOM_ID, naming::CONTROLLER_ID);
+        manifest.publish_registration(sentient, naming::ROOM_ID, naming::CONTROLLER_ID);
     }
 
     Serial.println(F("[Study B] Ready"));
@@ -275,203 +283,86 @@ void setup()
 void loop()
 {
     sentient.loop();
-    update_motors();
+    manifest.loop();
+    motors.loop();
 }
 
 // ══════════════════════════════════════════════════════════════════════════════
 // COMMAND HANDLER
 // ══════════════════════════════════════════════════════════════════════════════
 
-void handle_mqtt_command(const char *command, const JsonDocument &payload, void *ctx)
+// Indices into motor_commands
+enum MotorCommand
 {
-    if (!payload["device_id"].is<const char *>())
-        return;
-
-    const char *device_id = payload["device_id"];
+    MOTOR_START,
+    MOTOR_STOP,
+    MOTOR_SLOW,
+    MOTOR_FAST
+};
 
-    // Study Fan
-    if (strcmp(device_id, naming::DEV_STUDY_FAN) == 0)
-    {
-        if (strcmp(command, naming::CMD_START) == 0 || strcmp(command, naming::CMD_SLOW) == 0)
-        {
-            digitalWrite(PIN_MOTORS_POWER, HIGH);
-            digitalWrite(PIN_FAN_ENABLE, LOW);
-            fan_motor.state = RUNNING_SLOW;
-            fan_motor.step_interval = 2000;
-            Serial.println(F("[CMD] Study Fan: Start/Slow"));
-            publish_command_acknowledgement(device_id, command);
-        }
-        else if (strcmp(command, naming::CMD_FAST) == 0)
-        {
-            digitalWrite(PIN_MOTORS_POWER, HIGH);
-            digitalWrite(PIN_FAN_ENABLE, LOW);
-            fan_motor.state = RUNNING_FAST;
-            fan_motor.step_interval = 667;
-            Serial.println(F("[CMD] Study Fan: Fast"));
-            publish_command_acknowledgement(device_id, command);
-        }
-        else if (strcmp(command, naming::CMD_STOP) == 0)
-        {
-            fan_motor.state = STOPPED;
-            digitalWrite(PIN_FAN_ENABLE, HIGH);
-            Serial.println(F("[CMD] Study Fan: Stop"));
-            publish_command_acknowledgement(device_id, command);
-        }
-        return;
-    }
+void handle_motor_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx)
+{
+    MotorBinding &binding = *static_cast<MotorBinding *>(ctx);
 
-    // Wall Gear 1
-    if (strcmp(device_id, naming::DEV_WALL_GEAR_1) == 0)
+    switch (cmd.index)
     {
-        if (strcmp(command, naming::CMD_START) == 0 || strcmp(command, naming::CMD_SLOW) == 0)
+    case MOTOR_START:
+    case MOTOR_SLOW:
+        digitalWrite(PIN_MOTORS_POWER, HIGH);
+        digitalWrite(binding.enable_pin, LOW);
+        motors.run(binding.group, &MOTOR_FORWARD, MOTOR_SLOW_RATE);
+        break;
+    case MOTOR_FAST:
+        if (binding.dedicated_enable)
         {
             digitalWrite(PIN_MOTORS_POWER, HIGH);
-            digitalWrite(PIN_GEARS_ENABLE, LOW);
-            gear1_motor.state = RUNNING_SLOW;
-            gear1_motor.step_interval = 2000;
-            Serial.println(F("[CMD] Wall Gear 1: Start/Slow"));
-            publish_command_acknowledgement(device_id, command);
+            digitalWrite(binding.enable_pin, LOW);
         }
-        else if (strcmp(command, naming::CMD_FAST) == 0)
+        motors.run(binding.group, &MOTOR_FORWARD, MOTOR_FAST_RATE);
+        break;
+    case MOTOR_STOP:
+        motors.stop(binding.group);
+        if (binding.dedicated_enable)
         {
-            gear1_motor.state = RUNNING_FAST;
-            gear1_motor.step_interval = 667;
-            Serial.println(F("[CMD] Wall Gear 1: Fast"));
-            publish_command_acknowledgement(device_id, command);
+            digitalWrite(binding.enable_pin, HIGH);
         }
-        else if (strcmp(command, naming::CMD_STOP) == 0)
-        {
-            gear1_motor.state = STOPPED;
-            Serial.println(F("[CMD] Wall Gear 1: Stop"));
-            publish_command_acknowledgement(device_id, command);
-        }
-        return;
+        break;
     }
 
-    // Wall Gear 2
-    if (strcmp(device_id, naming::DEV_WALL_GEAR_2) == 0)
-    {
-        if (strcmp(command, naming::CMD_START) == 0 || strcmp(command, naming::CMD_SLOW) == 0)
-        {
-            digitalWrite(PIN_MOTORS_POWER, HIGH);
-            digitalWrite(PIN_GEARS_ENABLE, LOW);
-            gear2_motor.state = RUNNING_SLOW;
-            gear2_motor.step_interval = 2000;
-            Serial.println(F("[CMD] Wall Gear 2: Start/Slow"));
-            publish_command_acknowledgement(device_id, command);
-        }
-        else if (strcmp(command, naming::CMD_FAST) == 0)
-        {
-            gear2_motor.state = RUNNING_FAST;
-            gear2_motor.step_interval = 667;
-            Serial.println(F("[CMD] Wall Gear 2: Fast"));
-            publish_command_acknowledgement(device_id, command);
-        }
-        else if (strcmp(command, naming::CMD_STOP) == 0)
-        {
-            gear2_motor.state = STOPPED;
-            Serial.println(F("[CMD] Wall Gear 2: Stop"));
-            publish_command_acknowledgement(device_id, command);
-        }
-        return;
-    }
+    Serial.printf("[CMD] %s: %s\n", binding.label, cmd.name);
+    publish_command_acknowledgement(cmd.deviceId, cmd.name);
+}
 
-    // Wall Gear 3
-    if (strcmp(device_id, naming::DEV_WALL_GEAR_3) == 0)
-    {
-        if (strcmp(command, naming::CMD_START) == 0 || strcmp(command, naming::CMD_SLOW) == 0)
-        {
-            digitalWrite(PIN_MOTORS_POWER, HIGH);
-            digitalWrite(PIN_GEARS_ENABLE, LOW);
-            gear3_motor.state = RUNNING_SLOW;
-            gear3_motor.step_interval = 2000;
-            Serial.println(F("[CMD] Wall Gear 3: Start/Slow"));
-            publish_command_acknowledgement(device_id, command);
-        }
-        else if (strcmp(command, naming::CMD_FAST) == 0)
-        {
-            gear3_motor.state = RUNNING_FAST;
-            gear3_motor.step_interval = 667;
-            Serial.println(F("[CMD] Wall Gear 3: Fast"));
-            publish_command_acknowledgement(device_id, command);
-        }
-        else if (strcmp(command, naming::CMD_STOP) == 0)
-        {
-            gear3_motor.state = STOPPED;
-            Serial.println(F("[CMD] Wall Gear 3: Stop"));
-            publish_command_acknowledgement(device_id, command);
-        }
-        return;
-    }
+void handle_output_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx)
+{
+    const OutputBinding &binding = *static_cast<const OutputBinding *>(ctx);
 
-    // Simple on/off devices
-    if (strcmp(device_id, naming::DEV_TV_1) == 0)
-    {
-        digitalWrite(PIN_TV_1, strcmp(command, naming::CMD_ON) == 0 ? HIGH : LOW);
-        Serial.printf("[CMD] TV 1: %s\n", command);
-        publish_command_acknowledgement(device_id, command);
-        return;
-    }
-    if (strcmp(device_id, naming::DEV_TV_2) == 0)
-    {
-        digitalWrite(PIN_TV_2, strcmp(command, naming::CMD_ON) == 0 ? HIGH : LOW);
-        Serial.printf("[CMD] TV 2: %s\n", command);
-        publish_command_acknowledgement(device_id, command);
-        return;
-    }
-    if (strcmp(device_id, naming::DEV_MAKSERVO) == 0)
-    {
-        digitalWrite(PIN_MAKSERVO, strcmp(command, naming::CMD_ON) == 0 ? HIGH : LOW);
-        Serial.printf("[CMD] Makservo: %s\n", command);
-        publish_command_acknowledgement(device_id, command);
-        return;
-    }
-    if (strcmp(device_id, naming::DEV_STUDY_FAN_LIGHT) == 0)
-    {
-        digitalWrite(PIN_STUDY_FAN_LIGHT, strcmp(command, naming::CMD_ON) == 0 ? HIGH : LOW);
-        Serial.printf("[CMD] Study Fan Light: %s\n", command);
-        publish_command_acknowledgement(device_id, command);
-        return;
-    }
-    if (strcmp(device_id, naming::DEV_BLACKLIGHTS) == 0)
-    {
-        digitalWrite(PIN_BLACKLIGHTS, strcmp(command, naming::CMD_ON) == 0 ? HIGH : LOW);
-        Serial.printf("[CMD] Blacklights: %s\n", command);
-        publish_command_acknowledgement(device_id, command);
-        return;
-    }
-    if (strcmp(device_id, naming::DEV_NIXIE_LEDS) == 0)
-    {
-        digitalWrite(PIN_NIXIE_LEDS, strcmp(command, naming::CMD_ON) == 0 ? HIGH : LOW);
-        Serial.printf("[CMD] Nixie LEDs: %s\n", command);
-        publish_command_acknowledgement(device_id, command);
-        return;
-    }
+    // power_commands: 0 = on, 1 = off
+    digitalWrite(binding.pin, cmd.index == 0 ? HIGH : LOW);
+    Serial.printf("[CMD] %s: %s\n", binding.label, cmd.name);
+    publish_command_acknowledgement(cmd.deviceId, cmd.name);
+}
 
-    // Fog machine
-    if (strcmp(device_id, naming::DEV_FOG_MACHINE) == 0)
+void handle_fog_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx)
+{
+    // fog_commands: 0 = on, 1 = off, 2 = trigger
+    switch (cmd.index)
     {
-        if (strcmp(command, naming::CMD_ON) == 0)
-        {
-            digitalWrite(PIN_FOG_POWER, HIGH);
-            Serial.println(F("[CMD] Fog Machine: Power ON"));
-            publish_command_acknowledgement(device_id, command);
-        }
-        else if (strcmp(command, naming::CMD_OFF) == 0)
-        {
-            digitalWrite(PIN_FOG_POWER, LOW);
-            digitalWrite(PIN_FOG_TRIGGER, LOW);
-            Serial.println(F("[CMD] Fog Machine: Power OFF"));
-            publish_command_acknowledgement(device_id, command);
-        }
-        else if (strcmp(command, naming::CMD_FOG_TRIGGER) == 0)
-        {
-            digitalWrite(PIN_FOG_TRIGGER, HIGH);
-            Serial.println(F("[CMD] Fog Machine: Trigger"));
-            publish_command_acknowledgement(device_id, command);
-        }
-        return;
+    case 0:
+        digitalWrite(PIN_FOG_POWER, HIGH);
+        Serial.println(F("[CMD] Fog Machine: Power ON"));
+        break;
+    case 1:
+        digitalWrite(PIN_FOG_POWER, LOW);
+        digitalWrite(PIN_FOG_TRIGGER, LOW);
+        Serial.println(F("[CMD] Fog Machine: Power OFF"));
+        break;
+    case 2:
+        digitalWrite(PIN_FOG_TRIGGER, HIGH);
+        Serial.println(F("[CMD] Fog Machine: Trigger"));
+        break;
     }
+    publish_command_acknowledgement(cmd.deviceId, cmd.name);
 }
 
 // ══════════════════════════════════════════════════════════════════════════════
@@ -498,7 +389,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
                       String(naming::CAT_ACKNOWLEDGEMENT) + "/" + String(naming::CONTROLLER_ID) + "/" +
                       String(device_id) + "/" + String(command);
 
-    sentient.get_client().publish(ackTopic.c_str(), buf, false);
+    sentient.publishTopic(ackTopic.c_str(), buf);
 
     Serial.print(F("[ACK] -> "));
     Serial.println(ackTopic);
@@ -4,8 +4,9 @@
 // ══════════════════════════════════════════════════════════════════════════════
 
 #include <SentientMQTT.h>
-#include <SentientCapabilityManifest.h>
+#include <SentientManifestStream.h>
 #include <SentientDeviceRegistry.h>
+#include <SentientMotionPlanner.h>
 #include <ArduinoJson.h>
 #include <TeensyDMX.h>
 #include "controller_naming.h"
@@ -65,20 +66,24 @@ const unsigned long heartbeat_interval_ms = 5000;
 // DEVICE REGISTRY
 // ══════════════════════════════════════════════════════════════════════════════
 
-const char *motor_commands[] = {naming::CMD_UP, naming::CMD_DOWN, naming::CMD_STOP};
-const char *fog_commands[] = {naming::CMD_SET_VOLUME, naming::CMD_SET_TIMER, naming::CMD_SET_FAN_SPEED};
-const char *proximity_sensors[] = {
+constexpr const char *motor_commands[] PROGMEM = {naming::CMD_UP, naming::CMD_DOWN, naming::CMD_STOP};
+constexpr const char *fog_commands[] PROGMEM = {naming::CMD_SET_VOLUME, naming::CMD_SET_TIMER, naming::CMD_SET_FAN_SPEED};
+constexpr const char *proximity_sensors[] PROGMEM = {
     naming::SENSOR_LEFT_TOP_1, naming::SENSOR_LEFT_TOP_2,
     naming::SENSOR_LEFT_BOTTOM_1, naming::SENSOR_LEFT_BOTTOM_2,
     naming::SENSOR_RIGHT_TOP_1, naming::SENSOR_RIGHT_TOP_2,
     naming::SENSOR_RIGHT_BOTTOM_1, naming::SENSOR_RIGHT_BOTTOM_2};
 
-SentientDeviceDef dev_motor_left(naming::DEV_MOTOR_LEFT, "Motor Left", "stepper_motor", motor_commands, 3);
-SentientDeviceDef dev_motor_right(naming::DEV_MOTOR_RIGHT, "Motor Right", "stepper_motor", motor_commands, 3);
-SentientDeviceDef dev_proximity_sensors(naming::DEV_PROXIMITY_SENSORS, "Proximity Sensors", "proximity_array", nullptr, 0, proximity_sensors, 8);
-SentientDeviceDef dev_fog_dmx(naming::DEV_FOG_DMX, "DMX Fog Machine", "dmx_device", fog_commands, 3);
+constexpr SentientDeviceDef dev_motor_left PROGMEM(naming::DEV_MOTOR_LEFT, "Motor Left", "stepper_motor", motor_commands, 3);
+constexpr SentientDeviceDef dev_motor_right PROGMEM(naming::DEV_MOTOR_RIGHT, "Motor Right", "stepper_motor", motor_commands, 3);
+constexpr SentientDeviceDef dev_proximity_sensors PROGMEM(naming::DEV_PROXIMITY_SENSORS, "Proximity Sensors", "proximity_array", nullptr, 0, proximity_sensors, 8);
+constexpr SentientDeviceDef dev_fog_dmx PROGMEM(naming::DEV_FOG_DMX, "DMX Fog Machine", "dmx_device", fog_commands, 3);
 
-SentientDeviceRegistry deviceRegistry;
+SENTIENT_DEVICE_REGISTRY(deviceRegistry,
+    &dev_motor_left,
+    &dev_motor_right,
+    &dev_proximity_sensors,
+    &dev_fog_dmx);
 
 // ══════════════════════════════════════════════════════════════════════════════
 // SENTIENT MQTT INITIALIZATION
@@ -104,7 +109,7 @@ SentientMQTTConfig make_mqtt_config()
 }
 
 SentientMQTT sentient(make_mqtt_config());
-SentientCapabilityManifest manifest;
+SentientManifestStream manifest(deviceRegistry);
 
 void handle_mqtt_command(const char *command, const JsonDocument &payload, void *ctx);
 void publish_command_acknowledgement(const char *device_id, const char *command);
@@ -127,45 +132,43 @@ enum MotorDirection
     MOTOR_DOWN
 };
 
+// Step pulses come from the SentientMotion timer ISR; each motor is its own group
 struct Motor
 {
-    int step_pin_1;
-    int step_pin_2;
-    int dir_pin_1;
-    int dir_pin_2;
+    uint8_t group;
     MotorDirection direction;
-    unsigned long last_step_time;
-    unsigned long step_interval; // microseconds
 };
 
-Motor motor_left = {PIN_MOTOR_LEFT_STEP_1, PIN_MOTOR_LEFT_STEP_2, PIN_MOTOR_LEFT_DIR_1, PIN_MOTOR_LEFT_DIR_2, MOTOR_STOPPED, 0, 1000};
-Motor motor_right = {PIN_MOTOR_RIGHT_STEP_1, PIN_MOTOR_RIGHT_STEP_2, PIN_MOTOR_RIGHT_DIR_1, PIN_MOTOR_RIGHT_DIR_2, MOTOR_STOPPED, 0, 1000};
+const float MOTOR_STEP_RATE = 1000.0; // steps/sec, constant speed
 
-// Forward declarations
-void step_motor(Motor &motor);
-void update_motors();
+SentientMotionPlanner motors;
+Motor motor_left = {0, MOTOR_STOPPED};
+Motor motor_right = {1, MOTOR_STOPPED};
 
-void step_motor(Motor &motor)
+void add_motor(Motor &motor, int step_pin_1, int step_pin_2, int dir_pin_1, int dir_pin_2)
 {
-    if (motor.direction == MOTOR_STOPPED)
-        return;
-
-    unsigned long now = micros();
-    if (now - motor.last_step_time >= motor.step_interval)
-    {
-        digitalWrite(motor.step_pin_1, HIGH);
-        digitalWrite(motor.step_pin_2, LOW);
-        delayMicroseconds(10);
-        digitalWrite(motor.step_pin_1, LOW);
-        digitalWrite(motor.step_pin_2, HIGH);
-        motor.last_step_time = now;
-    }
+    // UP drives DIR_1 HIGH / DIR_2 LOW
+    SentientAxisConfig axis;
+    axis.group = motor.group;
+    axis.pins = {(uint8_t)step_pin_1, (uint8_t)step_pin_2, (uint8_t)dir_pin_1, (uint8_t)dir_pin_2, false};
+    motors.addAxis(axis);
+
+    SentientMotionConfig motion;
+    motion.startRate = MOTOR_STEP_RATE;
+    motion.maxRate = MOTOR_STEP_RATE;
+    motors.configureGroup(motor.group, motion);
 }
 
-void update_motors()
+void drive_motor(Motor &motor, MotorDirection direction)
 {
-    step_motor(motor_left);
-    step_motor(motor_right);
+    motor.direction = direction;
+    if (direction == MOTOR_STOPPED)
+    {
+        motors.stop(motor.group);
+        return;
+    }
+    const int8_t travel = direction == MOTOR_UP ? 1 : -1;
+    motors.run(motor.group, &travel, MOTOR_STEP_RATE);
 }
 
 // ══════════════════════════════════════════════════════════════════════════════
@@ -231,16 +234,9 @@ void setup()
     pinMode(PIN_POWER_LED, OUTPUT);
     digitalWrite(PIN_POWER_LED, HIGH);
 
-    // Initialize motor pins
-    pinMode(PIN_MOTOR_LEFT_STEP_1, OUTPUT);
-    pinMode(PIN_MOTOR_LEFT_STEP_2, OUTPUT);
-    pinMode(PIN_MOTOR_LEFT_DIR_1, OUTPUT);
-    pinMode(PIN_MOTOR_LEFT_DIR_2, OUTPUT);
-
-    pinMode(PIN_MOTOR_RIGHT_STEP_1, OUTPUT);
-    pinMode(PIN_MOTOR_RIGHT_STEP_2, OUTPUT);
-    pinMode(PIN_MOTOR_RIGHT_DIR_1, OUTPUT);
-    pinMode(PIN_MOTOR_RIGHT_DIR_2, OUTPUT);
+    // Initialize motors
+    add_motor(motor_left, PIN_MOTOR_LEFT_STEP_1, PIN_MOTOR_LEFT_STEP_2, PIN_MOTOR_LEFT_DIR_1, PIN_MOTOR_LEFT_DIR_2);
+    add_motor(motor_right, PIN_MOTOR_RIGHT_STEP_1, PIN_MOTOR_RIGHT_STEP_2, PIN_MOTOR_RIGHT_DIR_1, PIN_MOTOR_RIGHT_DIR_2);
 
     pinMode(PIN_MOTORS_ENABLE, OUTPUT);
     pinMode(PIN_MOTORS_POWER, OUTPUT);
@@ -272,16 +268,11 @@ void setup()
     delay(2000);
     Serial.println(F("[Study D] Starting..."));
 
-    deviceRegistry.addDevice(&dev_motor_left);
-    deviceRegistry.addDevice(&dev_motor_right);
-    deviceRegistry.addDevice(&dev_proximity_sensors);
-    deviceRegistry.addDevice(&dev_fog_dmx);
     // deviceRegistry.printSummary(); // Commented out to prevent stack overflow
 
     Serial.println(F("[Study D] Building manifest..."));
     manifest.set_controller_info(naming::CONTROLLER_ID, naming::CONTROLLER_FRIENDLY_NAME,
                                  firmware::VERSION, naming::ROOM_ID, naming::CONTROLLER_ID);
-    deviceRegistry.buildManifest(manifest);
     Serial.println(F("[Study D] Manifest built"));
 
     sentient.begin();
@@ -296,7 +287,7 @@ void setup()
 
     if (sentient.isConnected())
     {
-        manifest.publish_registration(sentient.get_client(), naming::ROOM_ID, naming::CONTROLLER_ID);
+        manifest.publish_registration(sentient, naming::ROOM_ID, naming::CONTROLLER_ID);
     }
 
     Serial.println(F("[Study D] Ready"));
@@ -309,7 +300,8 @@ void setup()
 void loop()
 {
     sentient.loop();
-    update_motors();
+    manifest.loop();
+    motors.loop();
     monitor_sensors();
 }
 
@@ -331,9 +323,7 @@ void handle_mqtt_command(const char *command, const JsonDocument &payload, void
         {
             digitalWrite(PIN_MOTORS_POWER, HIGH);
             digitalWrite(PIN_MOTORS_ENABLE, LOW);
-            digitalWrite(motor_left.dir_pin_1, HIGH);
-            digitalWrite(motor_left.dir_pin_2, LOW);
-            motor_left.direction = MOTOR_UP;
+            drive_motor(motor_left, MOTOR_UP);
             Serial.println(F("[CMD] Motor Left: Up"));
             publish_command_acknowledgement(device_id, command);
         }
@@ -341,15 +331,13 @@ void handle_mqtt_command(const char *command, const JsonDocument &payload, void
         {
             digitalWrite(PIN_MOTORS_POWER, HIGH);
             digitalWrite(PIN_MOTORS_ENABLE, LOW);
-            digitalWrite(motor_left.dir_pin_1, LOW);
-            digitalWrite(motor_left.dir_pin_2, HIGH);
-            motor_left.direction = MOTOR_DOWN;
+            drive_motor(motor_left, MOTOR_DOWN);
             Serial.println(F("[CMD] Motor Left: Down"));
             publish_command_acknowledgement(device_id, command);
         }
         else if (strcmp(command, naming::CMD_STOP) == 0)
         {
-            motor_left.direction = MOTOR_STOPPED;
+            drive_motor(motor_left, MOTOR_STOPPED);
             if (motor_right.direction == MOTOR_STOPPED)
             {
                 digitalWrite(PIN_MOTORS_ENABLE, HIGH);
@@ -367,9 +355,7 @@ void handle_mqtt_command(const char *command, const JsonDocument &payload, void
         {
             digitalWrite(PIN_MOTORS_POWER, HIGH);
             digitalWrite(PIN_MOTORS_ENABLE, LOW);
-            digitalWrite(motor_right.dir_pin_1, HIGH);
-            digitalWrite(motor_right.dir_pin_2, LOW);
-            motor_right.direction = MOTOR_UP;
+            drive_motor(motor_right, MOTOR_UP);
             Serial.println(F("[CMD] Motor Right: Up"));
             publish_command_acknowledgement(device_id, command);
         }
@@ -377,15 +363,13 @@ void handle_mqtt_command(const char *command, const JsonDocument &payload, void
         {
             digitalWrite(PIN_MOTORS_POWER, HIGH);
             digitalWrite(PIN_MOTORS_ENABLE, LOW);
-            digitalWrite(motor_right.dir_pin_1, LOW);
-            digitalWrite(motor_right.dir_pin_2, HIGH);
-            motor_right.direction = MOTOR_DOWN;
+            drive_motor(motor_right, MOTOR_DOWN);
             Serial.println(F("[CMD] Motor Right: Down"));
             publish_command_acknowledgement(device_id, command);
         }
         else if (strcmp(command, naming::CMD_STOP) == 0)
         {
-            motor_right.direction = MOTOR_STOPPED;
+            drive_motor(motor_right, MOTOR_STOPPED);
             if (motor_left.direction == MOTOR_STOPPED)
             {
                 digitalWrite(PIN_MOTORS_ENABLE, HIGH);
@@ -451,7 +435,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
                       String(naming::CAT_ACKNOWLEDGEMENT) + "/" + String(naming::CONTROLLER_ID) + "/" +
                       String(device_id) + "/" + String(command);
 
-    sentient.get_client().publish(ackTopic.c_str(), buf, false);
+    sentient.publishTopic(ackTopic.c_str(), buf);
 
     Serial.print(F("[ACK] -> "));
     Serial.println(ackTopic);
@@ -4,7 +4,7 @@
 // ══════════════════════════════════════════════════════════════════════════════
 
 #include <SentientMQTT.h>
-#include <SentientCapabilityManifest.h>
+#include <SentientManifestStream.h>
 #include <SentientDeviceRegistry.h>
 #include <ArduinoJson.h>
 #include <FastLED.h>
@@ -79,38 +79,53 @@ long last_published_values[6] = {0};
 // ══════════════════════════════════════════════════════════════════════════════
 
 // Encoder sensors (input only)
-const char *encoder_sensors[] = {naming::SENSOR_ENCODER_COUNT};
+constexpr const char *encoder_sensors[] PROGMEM = {naming::SENSOR_ENCODER_COUNT};
 
-SentientDeviceDef dev_encoder_lt(naming::DEV_ENCODER_LT, "Encoder Left Top", "rotary_encoder", encoder_sensors, 1, true);
-SentientDeviceDef dev_encoder_lm(naming::DEV_ENCODER_LM, "Encoder Left Middle", "rotary_encoder", encoder_sensors, 1, true);
-SentientDeviceDef dev_encoder_lb(naming::DEV_ENCODER_LB, "Encoder Left Bottom", "rotary_encoder", encoder_sensors, 1, true);
-SentientDeviceDef dev_encoder_rt(naming::DEV_ENCODER_RT, "Encoder Right Top", "rotary_encoder", encoder_sensors, 1, true);
-SentientDeviceDef dev_encoder_rm(naming::DEV_ENCODER_RM, "Encoder Right Middle", "rotary_encoder", encoder_sensors, 1, true);
-SentientDeviceDef dev_encoder_rb(naming::DEV_ENCODER_RB, "Encoder Right Bottom", "rotary_encoder", encoder_sensors, 1, true);
+constexpr SentientDeviceDef dev_encoder_lt PROGMEM(naming::DEV_ENCODER_LT, "Encoder Left Top", "rotary_encoder", encoder_sensors, 1, true);
+constexpr SentientDeviceDef dev_encoder_lm PROGMEM(naming::DEV_ENCODER_LM, "Encoder Left Middle", "rotary_encoder", encoder_sensors, 1, true);
+constexpr SentientDeviceDef dev_encoder_lb PROGMEM(naming::DEV_ENCODER_LB, "Encoder Left Bottom", "rotary_encoder", encoder_sensors, 1, true);
+constexpr SentientDeviceDef dev_encoder_rt PROGMEM(naming::DEV_ENCODER_RT, "Encoder Right Top", "rotary_encoder", encoder_sensors, 1, true);
+constexpr SentientDeviceDef dev_encoder_rm PROGMEM(naming::DEV_ENCODER_RM, "Encoder Right Middle", "rotary_encoder", encoder_sensors, 1, true);
+constexpr SentientDeviceDef dev_encoder_rb PROGMEM(naming::DEV_ENCODER_RB, "Encoder Right Bottom", "rotary_encoder", encoder_sensors, 1, true);
 
 // LED Ring devices (output)
-const char *led_commands[] = {naming::CMD_SET_COLOR};
-SentientDeviceDef dev_led_ring_a(naming::DEV_LED_RING_A, "LED Ring A", "led_ring", led_commands, 1);
-SentientDeviceDef dev_led_ring_b(naming::DEV_LED_RING_B, "LED Ring B", "led_ring", led_commands, 1);
-SentientDeviceDef dev_led_ring_c(naming::DEV_LED_RING_C, "LED Ring C", "led_ring", led_commands, 1);
-SentientDeviceDef dev_led_ring_d(naming::DEV_LED_RING_D, "LED Ring D", "led_ring", led_commands, 1);
-SentientDeviceDef dev_led_ring_e(naming::DEV_LED_RING_E, "LED Ring E", "led_ring", led_commands, 1);
-SentientDeviceDef dev_led_ring_f(naming::DEV_LED_RING_F, "LED Ring F", "led_ring", led_commands, 1);
+constexpr const char *led_commands[] PROGMEM = {naming::CMD_SET_COLOR};
+constexpr SentientDeviceDef dev_led_ring_a PROGMEM(naming::DEV_LED_RING_A, "LED Ring A", "led_ring", led_commands, 1);
+constexpr SentientDeviceDef dev_led_ring_b PROGMEM(naming::DEV_LED_RING_B, "LED Ring B", "led_ring", led_commands, 1);
+constexpr SentientDeviceDef dev_led_ring_c PROGMEM(naming::DEV_LED_RING_C, "LED Ring C", "led_ring", led_commands, 1);
+constexpr SentientDeviceDef dev_led_ring_d PROGMEM(naming::DEV_LED_RING_D, "LED Ring D", "led_ring", led_commands, 1);
+constexpr SentientDeviceDef dev_led_ring_e PROGMEM(naming::DEV_LED_RING_E, "LED Ring E", "led_ring", led_commands, 1);
+constexpr SentientDeviceDef dev_led_ring_f PROGMEM(naming::DEV_LED_RING_F, "LED Ring F", "led_ring", led_commands, 1);
 
 // Filament LED (output)
-const char *filament_commands[] = {naming::CMD_LED_ON, naming::CMD_LED_OFF};
-SentientDeviceDef dev_filament_led(naming::DEV_FILAMENT_LED, "Filament LED", "led", filament_commands, 2);
+constexpr const char *filament_commands[] PROGMEM = {naming::CMD_LED_ON, naming::CMD_LED_OFF};
+constexpr SentientDeviceDef dev_filament_led PROGMEM(naming::DEV_FILAMENT_LED, "Filament LED", "led", filament_commands, 2);
 
 // Main Actuator (output)
-const char *actuator_commands[] = {naming::CMD_ACTUATOR_UP, naming::CMD_ACTUATOR_DOWN, naming::CMD_ACTUATOR_STOP};
-SentientDeviceDef dev_main_actuator(naming::DEV_MAIN_ACTUATOR, "Main Actuator", "actuator", actuator_commands, 3);
+constexpr const char *actuator_commands[] PROGMEM = {naming::CMD_ACTUATOR_UP, naming::CMD_ACTUATOR_DOWN, naming::CMD_ACTUATOR_STOP};
+constexpr SentientDeviceDef dev_main_actuator PROGMEM(naming::DEV_MAIN_ACTUATOR, "Main Actuator", "actuator", actuator_commands, 3);
 
 // Forge Actuator (output)
-const char *forge_commands[] = {naming::CMD_FORGE_EXTEND, naming::CMD_FORGE_RETRACT};
-SentientDeviceDef dev_forge_actuator(naming::DEV_FORGE_ACTUATOR, "Forge Actuator", "actuator", forge_commands, 2);
+constexpr const char *forge_commands[] PROGMEM = {naming::CMD_FORGE_EXTEND, naming::CMD_FORGE_RETRACT};
+constexpr SentientDeviceDef dev_forge_actuator PROGMEM(naming::DEV_FORGE_ACTUATOR, "Forge Actuator", "actuator", forge_commands, 2);
 
 // Create the device registry
-SentientDeviceRegistry deviceRegistry;
+SENTIENT_DEVICE_REGISTRY(deviceRegistry,
+    &dev_encoder_lt,
+    &dev_encoder_lm,
+    &dev_encoder_lb,
+    &dev_encoder_rt,
+    &dev_encoder_rm,
+    &dev_encoder_rb,
+    &dev_led_ring_a,
+    &dev_led_ring_b,
+    &dev_led_ring_c,
+    &dev_led_ring_d,
+    &dev_led_ring_e,
+    &dev_led_ring_f,
+    &dev_filament_led,
+    &dev_main_actuator,
+    &dev_forge_actuator);
 
 // ══════════════════════════════════════════════════════════════════════════════
 // SENTIENT MQTT INITIALIZATION
@@ -136,7 +151,7 @@ SentientMQTTConfig make_mqtt_config()
 }
 
 SentientMQTT sentient(make_mqtt_config());
-SentientCapabilityManifest manifest;
+SentientManifestStream manifest(deviceRegistry);
 
 // Forward declarations
 void handle_mqtt_command(const char *command, const JsonDocument &payload, void *ctx);
@@ -228,23 +243,6 @@ void setup()
     delay(2000);
     Serial.println(F("[Syringe] Starting..."));
 
-    // Register all devices
-    Serial.println(F("[INIT] Registering devices..."));
-    deviceRegistry.addDevice(&dev_encoder_lt);
-    deviceRegistry.addDevice(&dev_encoder_lm);
-    deviceRegistry.addDevice(&dev_encoder_lb);
-    deviceRegistry.addDevice(&dev_encoder_rt);
-    deviceRegistry.addDevice(&dev_encoder_rm);
-    deviceRegistry.addDevice(&dev_encoder_rb);
-    deviceRegistry.addDevice(&dev_led_ring_a);
-    deviceRegistry.addDevice(&dev_led_ring_b);
-    deviceRegistry.addDevice(&dev_led_ring_c);
-    deviceRegistry.addDevice(&dev_led_ring_d);
-    deviceRegistry.addDevice(&dev_led_ring_e);
-    deviceRegistry.addDevice(&dev_led_ring_f);
-    deviceRegistry.addDevice(&dev_filament_led);
-    deviceRegistry.addDevice(&dev_main_actuator);
-    deviceRegistry.addDevice(&dev_forge_actuator);
     deviceRegistry.printSummary();
 
     // Build capability manifest
@@ -256,7 +254,6 @@ void setup()
         naming::ROOM_ID,
         naming::CONTROLLER_ID);
 
-    deviceRegistry.buildManifest(manifest);
     Serial.println(F("[INIT] Manifest built from device registry"));
 
     // Initialize Sentient MQTT
@@ -280,9 +277,9 @@ void setup()
 
         // Register with Sentient system
         Serial.println(F("[INIT] Registering with Sentient system..."));
-        if (manifest.publish_registration(sentient.get_client(), naming::ROOM_ID, naming::CONTROLLER_ID))
+        if (manifest.publish_registration(sentient, naming::ROOM_ID, naming::CONTROLLER_ID))
         {
-            Serial.println(F("[INIT] Registration successful!"));
+            Serial.println(F("[INIT] Registration started"));
         }
         else
         {
@@ -305,6 +302,7 @@ void loop()
 {
     // 1. LISTEN for commands from Sentient
     sentient.loop();
+    manifest.loop();
 
     // 2. MONITOR encoders and publish changes
     monitor_encoders();
@@ -445,7 +443,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
                       String(naming::CAT_ACKNOWLEDGEMENT) + "/" + String(naming::CONTROLLER_ID) + "/" +
                       String(device_id) + "/" + String(command);
 
-    sentient.get_client().publish(ackTopic.c_str(), buf, false);
+    sentient.publishTopic(ackTopic.c_str(), buf);
 
     Serial.print(F("[ACK] -> "));
     Serial.println(ackTopic);
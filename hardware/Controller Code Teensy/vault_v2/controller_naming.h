@@ -11,10 +11,15 @@ namespace naming
     constexpr const char *CONTROLLER_ID = firmware::UNIQUE_ID; // "vault"
     constexpr const char *CONTROLLER_FRIENDLY_NAME = "Vault Puzzle Controller";
 
-    // RFID Reader (sensor only)
+    // RFID Reader
     constexpr const char *DEV_RFID_READER = "rfid_reader";
     constexpr const char *FRIENDLY_RFID_READER = "RFID Reader";
 
+    // Commands (vault tag list maintenance)
+    constexpr const char *CMD_SET_VAULT_TAG = "set_vault_tag";
+    constexpr const char *CMD_SET_VAULT_TAGS = "set_vault_tags";
+    constexpr const char *CMD_RESET_VAULT_TAGS = "reset_vault_tags";
+
     // Sensors
     constexpr const char *SENSOR_VAULT_NUMBER = "vault_number";
     constexpr const char *SENSOR_TAG_ID = "tag_id";
@@ -4,11 +4,11 @@
 // ══════════════════════════════════════════════════════════════════════════════
 
 #include <SentientMQTT.h>
-#include <SentientCapabilityManifest.h>
+#include <SentientManifestStream.h>
 #include <SentientDeviceRegistry.h>
 #include <ArduinoJson.h>
-#include <SoftwareSerial.h>
-#include <SerialRFID.h>
+#include <SentientRfidReaders.h>
+#include <SentientRfidTagTable.h>
 #include "controller_naming.h"
 
 // ══════════════════════════════════════════════════════════════════════════════
@@ -16,12 +16,11 @@
 // ══════════════════════════════════════════════════════════════════════════════
 
 const int PIN_POWER_LED = 13;
-const int PIN_RX = 15;
-const int PIN_TX = 14;
-const int PIN_TIR = 19; // Tag In Range sensor
+#define RFID_SERIAL Serial3 // Pins 14(TX), 15(RX)
+const int PIN_TIR = 19;     // Tag In Range sensor
 
-// Tag size for RFID
-#define SIZE_TAG_ID 13
+// EEPROM address of the stored vault tag list
+const int EEPROM_ADDR_VAULT_TAGS = 0;
 
 // ══════════════════════════════════════════════════════════════════════════════
 // MQTT CONFIGURATION
@@ -38,75 +37,82 @@ const unsigned long heartbeat_interval_ms = 5000; // 5 seconds
 // VAULT TAG LOOKUP TABLE
 // ══════════════════════════════════════════════════════════════════════════════
 
-// 36 vault tags mapped to vault numbers 1-36
-const char tagList[][SIZE_TAG_ID] = {
-    "0C007DAE1DC2", // Vault 1
-    "3C0088C9CFB2", // Vault 2
-    "3C008923A630", // Vault 3
-    "0C007E25A9FE", // Vault 4
-    "0A005A9CF438", // Vault 5
-    "3C00D64911B2", // Vault 6
-    "3C00D58E96F1", // Vault 7
-    "3C00D633459C", // Vault 8
-    "3C00D5EDF6F2", // Vault 9
-    "3C00D5C16C44", // Vault 10
-    "3C00D63C61B7", // Vault 11
-    "3C00D5B2F4AF", // Vault 12
-    "3C00892935A9", // Vault 13
-    "3C00891AB11E", // Vault 14
-    "3C0088EA237D", // Vault 15
-    "0C007DCE47F8", // Vault 16
-    "3C0088A0DFCB", // Vault 17
-    "3C00D5E96666", // Vault 18
-    "3C008900EB5E", // Vault 19
-    "3C00D6359C43", // Vault 20
-    "0C007D1B7D17", // Vault 21
-    "0C007E107E1C", // Vault 22
-    "3C0088804470", // Vault 23
-    "3C0088E695C7", // Vault 24
-    "3C00D5E3FEF4", // Vault 25
-    "0C007DF174F4", // Vault 26
-    "0C007DF2FF7C", // Vault 27
-    "0C007DEAE873", // Vault 28
-    "3C0089199539", // Vault 29
-    "0C007DC9BE06", // Vault 30
-    "3C0088BFDAD1", // Vault 31
-    "3C00D5CCEBCE", // Vault 32
-    "0C007D5CDFF2", // Vault 33
-    "3C0089198F23", // Vault 34
-    "3C00892541D1", // Vault 35
-    "0C007DD9832B"  // Vault 36
+// Default vault tags (48-bit tag values), vault number = position in the list.
+// set_vault_tag / set_vault_tags replace them at run time; the new list is
+// kept in EEPROM and used from then on, until reset_vault_tags.
+constexpr SentientRfidTag default_vault_tags[] = {
+    0x0C007DAE1DC2, // Vault 1
+    0x3C0088C9CFB2, // Vault 2
+    0x3C008923A630, // Vault 3
+    0x0C007E25A9FE, // Vault 4
+    0x0A005A9CF438, // Vault 5
+    0x3C00D64911B2, // Vault 6
+    0x3C00D58E96F1, // Vault 7
+    0x3C00D633459C, // Vault 8
+    0x3C00D5EDF6F2, // Vault 9
+    0x3C00D5C16C44, // Vault 10
+    0x3C00D63C61B7, // Vault 11
+    0x3C00D5B2F4AF, // Vault 12
+    0x3C00892935A9, // Vault 13
+    0x3C00891AB11E, // Vault 14
+    0x3C0088EA237D, // Vault 15
+    0x0C007DCE47F8, // Vault 16
+    0x3C0088A0DFCB, // Vault 17
+    0x3C00D5E96666, // Vault 18
+    0x3C008900EB5E, // Vault 19
+    0x3C00D6359C43, // Vault 20
+    0x0C007D1B7D17, // Vault 21
+    0x0C007E107E1C, // Vault 22
+    0x3C0088804470, // Vault 23
+    0x3C0088E695C7, // Vault 24
+    0x3C00D5E3FEF4, // Vault 25
+    0x0C007DF174F4, // Vault 26
+    0x0C007DF2FF7C, // Vault 27
+    0x0C007DEAE873, // Vault 28
+    0x3C0089199539, // Vault 29
+    0x0C007DC9BE06, // Vault 30
+    0x3C0088BFDAD1, // Vault 31
+    0x3C00D5CCEBCE, // Vault 32
+    0x0C007D5CDFF2, // Vault 33
+    0x3C0089198F23, // Vault 34
+    0x3C00892541D1, // Vault 35
+    0x0C007DD9832B  // Vault 36
 };
+static_assert(sentient_rfid::valid_tags(default_vault_tags), "Vault tag with a bad checksum or listed twice");
 
 // ══════════════════════════════════════════════════════════════════════════════
 // STATE MANAGEMENT
 // ══════════════════════════════════════════════════════════════════════════════
 
-SoftwareSerial sSerial(PIN_RX, PIN_TX);
-SerialRFID rfid(sSerial);
-
-char current_tag[SIZE_TAG_ID];
-char last_tag[SIZE_TAG_ID] = "";
-int current_vault_number = 0;
-int last_vault_number = 0;
+const uint8_t VAULT_READER = 0; // The only reader on this controller
+SentientRfidReaders rfid;
+SentientRfidTagTable vault_tags;
 
 // ══════════════════════════════════════════════════════════════════════════════
 // DEVICE REGISTRY
 // ══════════════════════════════════════════════════════════════════════════════
 
 // RFID reader sensors
-const char *rfid_sensors[] = {
+constexpr const char *rfid_sensors[] PROGMEM = {
     naming::SENSOR_VAULT_NUMBER,
     naming::SENSOR_TAG_ID};
 
-SentientDeviceDef dev_rfid_reader(
+// Vault tag list maintenance (no reflash to replace a lost tag)
+constexpr const char *vault_tag_commands[] PROGMEM = {
+    naming::CMD_SET_VAULT_TAG,
+    naming::CMD_SET_VAULT_TAGS,
+    naming::CMD_RESET_VAULT_TAGS};
+
+constexpr SentientDeviceDef dev_rfid_reader PROGMEM(
     naming::DEV_RFID_READER,
     naming::FRIENDLY_RFID_READER,
     "rfid_reader",
-    rfid_sensors, 2, true); // Input only
+    vault_tag_commands, 3,
+    rfid_sensors, 2);
 
 // Create the device registry
-SentientDeviceRegistry deviceRegistry;
+SENTIENT_DEVICE_REGISTRY(deviceRegistry,
+    &dev_rfid_reader);
 
 // ══════════════════════════════════════════════════════════════════════════════
 // SENTIENT MQTT INITIALIZATION
@@ -132,12 +138,14 @@ SentientMQTTConfig make_mqtt_config()
 }
 
 SentientMQTT sentient(make_mqtt_config());
-SentientCapabilityManifest manifest;
+SentientManifestStream manifest(deviceRegistry);
 
 // Forward declarations
 void handle_mqtt_command(const char *command, const JsonDocument &payload, void *ctx);
+void handle_vault_tag_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx);
+void publish_command_acknowledgement(const char *device_id, const char *command, bool success);
 void monitor_rfid_reader();
-int lookup_vault_number(const char *tag);
+void publish_vault_number();
 
 // ══════════════════════════════════════════════════════════════════════════════
 // SETUP
@@ -148,17 +156,15 @@ void setup()
     pinMode(PIN_POWER_LED, OUTPUT);
     digitalWrite(PIN_POWER_LED, HIGH);
 
-    pinMode(PIN_TIR, INPUT);
-
     Serial.begin(115200);
-    sSerial.begin(9600);
 
     delay(2000);
     Serial.println(F("[Vault] Starting..."));
 
-    // Register all devices
-    Serial.println(F("[INIT] Registering devices..."));
-    deviceRegistry.addDevice(&dev_rfid_reader);
+    rfid.add(RFID_SERIAL, PIN_TIR, INPUT);
+    rfid.begin(9600);
+    vault_tags.begin(default_vault_tags, EEPROM_ADDR_VAULT_TAGS);
+
     deviceRegistry.printSummary();
 
     // Build capability manifest
@@ -170,12 +176,12 @@ void setup()
         naming::ROOM_ID,
         naming::CONTROLLER_ID);
 
-    deviceRegistry.buildManifest(manifest);
     Serial.println(F("[INIT] Manifest built from device registry"));
 
     // Initialize Sentient MQTT
-    sentient.begin();
+    sentient.onCommands(naming::DEV_RFID_READER, vault_tag_commands, 3, handle_vault_tag_command);
     sentient.setCommandCallback(handle_mqtt_command);
+    sentient.begin();
 
     Serial.println(F("[INIT] Sentient MQTT initialized"));
     Serial.println(F("[INIT] Waiting for network connection..."));
@@ -194,9 +200,9 @@ void setup()
 
         // Register with Sentient system
         Serial.println(F("[INIT] Registering with Sentient system..."));
-        if (manifest.publish_registration(sentient.get_client(), naming::ROOM_ID, naming::CONTROLLER_ID))
+        if (manifest.publish_registration(sentient, naming::ROOM_ID, naming::CONTROLLER_ID))
         {
-            Serial.println(F("[INIT] Registration successful!"));
+            Serial.println(F("[INIT] Registration started"));
         }
         else
         {
@@ -219,6 +225,7 @@ void loop()
 {
     // 1. LISTEN for commands from Sentient
     sentient.loop();
+    manifest.loop();
 
     // 2. MONITOR RFID reader and publish changes
     monitor_rfid_reader();
@@ -230,79 +237,131 @@ void loop()
 
 void handle_mqtt_command(const char *command, const JsonDocument &payload, void *ctx)
 {
-    // This controller has no commands - sensor only
-    Serial.print(F("[CMD] Received (ignored - sensor only): "));
+    // Only the vault tag commands are routed; anything else is ignored
+    Serial.print(F("[CMD] Received (ignored): "));
     Serial.println(command);
 }
 
-// ══════════════════════════════════════════════════════════════════════════════
-// RFID MONITORING
-// ══════════════════════════════════════════════════════════════════════════════
-
-void monitor_rfid_reader()
+void handle_vault_tag_command(const SentientCommand &cmd, const JsonDocument &payload, void *ctx)
 {
-    // Check if tag is in range
-    bool tag_in_range = (digitalRead(PIN_TIR) == HIGH);
+    bool ok = false;
 
-    // Try to read tag
-    if (rfid.readTag(current_tag, sizeof(current_tag)))
+    // vault_tag_commands: 0 = set_vault_tag, 1 = set_vault_tags, 2 = reset_vault_tags
+    switch (cmd.index)
     {
-        // Look up vault number
-        current_vault_number = lookup_vault_number(current_tag);
-
-        // Check if vault number changed
-        if (current_vault_number != last_vault_number && sentient.isConnected())
+    case 0:
+    {
+        // {"vault": 5, "tag": "3C00D64911B2"}; an empty tag unassigns the vault
+        const int vault = payload["vault"] | 0;
+        const char *text = payload["tag"] | "";
+        const SentientRfidTag tag = text[0] ? SentientRfidReaders::parseTag(text) : 0;
+        ok = vault > 0 && (tag != 0 || text[0] == '\0') && vault_tags.assign(vault, tag);
+        break;
+    }
+    case 1:
+    {
+        // {"tags": ["0C007DAE1DC2", "3C0088C9CFB2", ...]}: vault 1, 2, ...; "" leaves a vault unassigned
+        JsonArrayConst list = payload["tags"];
+        SentientRfidTag tags[SENTIENT_RFID_TABLE_SIZE];
+        uint16_t count = 0;
+        if (list.isNull() || list.size() > SENTIENT_RFID_TABLE_SIZE)
+        {
+            break; // Rejected before anything is written to tags[]
+        }
+        ok = true;
+        for (JsonVariantConst entry : list)
         {
-            JsonDocument doc;
-
-            // Publish vault number
-            doc["vault_number"] = current_vault_number;
-            doc["tag_id"] = current_tag;
-            doc["tag_in_range"] = tag_in_range;
-            sentient.publishJson(naming::CAT_SENSORS, naming::SENSOR_VAULT_NUMBER, doc);
-
-            Serial.print(F("[RFID] Vault: "));
-            Serial.print(current_vault_number);
-            Serial.print(F(" Tag: "));
-            Serial.print(current_tag);
-            Serial.print(F(" TIR: "));
-            Serial.println(tag_in_range ? "YES" : "NO");
-
-            last_vault_number = current_vault_number;
-            strncpy(last_tag, current_tag, SIZE_TAG_ID);
+            const char *text = entry | "";
+            tags[count] = text[0] ? SentientRfidReaders::parseTag(text) : 0;
+            ok = ok && (tags[count] != 0 || text[0] == '\0');
+            count++;
         }
+        ok = ok && vault_tags.replace(tags, count);
+        break;
+    }
+    case 2:
+        ok = vault_tags.restoreDefaults();
+        break;
     }
 
-    // Clear vault number if tag removed
-    if (!tag_in_range && current_vault_number != 0)
+    Serial.print(F("[CMD] "));
+    Serial.print(cmd.name);
+    Serial.print(ok ? F(" applied, ") : F(" rejected, "));
+    Serial.print(vault_tags.count());
+    Serial.println(vault_tags.stored() ? F(" tags (stored)") : F(" tags (defaults)"));
+
+    // The tag on the reader may map to a different vault now
+    if (ok && rfid.present(VAULT_READER))
     {
-        current_vault_number = 0;
-        if (last_vault_number != 0 && sentient.isConnected())
-        {
-            JsonDocument doc;
-            doc["vault_number"] = 0;
-            doc["tag_id"] = "EMPTY";
-            doc["tag_in_range"] = false;
-            sentient.publishJson(naming::CAT_SENSORS, naming::SENSOR_VAULT_NUMBER, doc);
-
-            Serial.println(F("[RFID] Tag removed"));
-            last_vault_number = 0;
-        }
+        publish_vault_number();
     }
+    publish_command_acknowledgement(cmd.deviceId, cmd.name, ok);
+}
+
+void publish_command_acknowledgement(const char *device_id, const char *command, bool success)
+{
+    if (!sentient.isConnected())
+        return;
+
+    StaticJsonDocument<160> ack;
+    ack["controller_id"] = naming::CONTROLLER_ID;
+    ack["device_id"] = device_id;
+    ack["command"] = command;
+    ack["success"] = success;
+    ack["timestamp_ms"] = millis();
+
+    char buf[196];
+    serializeJson(ack, buf, sizeof(buf));
+
+    // Topic: <tenant>/<room>/acknowledgement/<controller>/<device>/<command>
+    String ackTopic = String(naming::CLIENT_ID) + "/" + String(naming::ROOM_ID) + "/" +
+                      String(naming::CAT_ACKNOWLEDGEMENT) + "/" + String(naming::CONTROLLER_ID) + "/" +
+                      String(device_id) + "/" + String(command);
+
+    sentient.publishTopic(ackTopic.c_str(), buf);
+
+    Serial.print(F("[ACK] -> "));
+    Serial.println(ackTopic);
 }
 
 // ══════════════════════════════════════════════════════════════════════════════
-// VAULT TAG LOOKUP
+// RFID MONITORING
 // ══════════════════════════════════════════════════════════════════════════════
 
-int lookup_vault_number(const char *tag)
+void monitor_rfid_reader()
+{
+    // Presence fuses the frame with TIR: removal is reported as soon as TIR drops
+    if (rfid.update() & SentientRfidReaders::bit(VAULT_READER))
+    {
+        publish_vault_number();
+    }
+}
+
+void publish_vault_number()
 {
-    for (int i = 0; i < 36; i++)
+    const bool present = rfid.present(VAULT_READER);
+    const SentientRfidTag tag = rfid.tag(VAULT_READER);
+    const uint16_t vault_number = vault_tags.lookup(tag); // Hash probe; 0 = unknown or no tag
+    char tag_id[SENTIENT_RFID_TAG_TEXT];
+    SentientRfidReaders::formatTag(tag, tag_id);
+
+    // No connection check: changes during a broker blip are queued and replayed
+    JsonDocument doc;
+    doc["vault_number"] = vault_number;
+    doc["tag_id"] = present ? tag_id : "EMPTY";
+    doc["tag_in_range"] = rfid.tagInRange(VAULT_READER);
+    doc["latency_us"] = rfid.ageMicros(VAULT_READER); // Frame or TIR edge on the wire -> publish
+    sentient.publishJson(naming::CAT_SENSORS, naming::SENSOR_VAULT_NUMBER, doc);
+
+    if (present)
     {
-        if (strcmp(tag, tagList[i]) == 0)
-        {
-            return i + 1; // Vault numbers are 1-indexed
-        }
+        Serial.print(F("[RFID] Vault: "));
+        Serial.print(vault_number);
+        Serial.print(F(" Tag: "));
+        Serial.println(tag_id);
+    }
+    else
+    {
+        Serial.println(F("[RFID] Tag removed"));
     }
-    return 0; // Unknown tag
 }
@@ -4,7 +4,7 @@
 // ══════════════════════════════════════════════════════════════════════════════
 
 #include <SentientMQTT.h>
-#include <SentientCapabilityManifest.h>
+#include <SentientManifestStream.h>
 #include <SentientDeviceRegistry.h>
 #include <ArduinoJson.h>
 #include "controller_naming.h"
@@ -39,19 +39,28 @@ const unsigned long heartbeat_interval_ms = 5000;
 // DEVICE REGISTRY
 // ══════════════════════════════════════════════════════════════════════════════
 
-const char *output_commands[] = {naming::CMD_OUTPUT_ON, naming::CMD_OUTPUT_OFF};
+constexpr const char *output_commands[] PROGMEM = {naming::CMD_OUTPUT_ON, naming::CMD_OUTPUT_OFF};
 
-SentientDeviceDef dev_output_one(naming::DEV_OUTPUT_ONE, "Output 1", "digital_output", output_commands, 2);
-SentientDeviceDef dev_output_two(naming::DEV_OUTPUT_TWO, "Output 2", "digital_output", output_commands, 2);
-SentientDeviceDef dev_output_three(naming::DEV_OUTPUT_THREE, "Output 3", "digital_output", output_commands, 2);
-SentientDeviceDef dev_output_four(naming::DEV_OUTPUT_FOUR, "Output 4", "digital_output", output_commands, 2);
-SentientDeviceDef dev_output_five(naming::DEV_OUTPUT_FIVE, "Output 5", "digital_output", output_commands, 2);
-SentientDeviceDef dev_output_six(naming::DEV_OUTPUT_SIX, "Output 6", "digital_output", output_commands, 2);
-SentientDeviceDef dev_output_seven(naming::DEV_OUTPUT_SEVEN, "Output 7", "digital_output", output_commands, 2);
-SentientDeviceDef dev_output_eight(naming::DEV_OUTPUT_EIGHT, "Output 8", "digital_output", output_commands, 2);
-SentientDeviceDef dev_power_switch(naming::DEV_POWER_SWITCH, "Power Switch", "digital_output", output_commands, 2);
+constexpr SentientDeviceDef dev_output_one PROGMEM(naming::DEV_OUTPUT_ONE, "Output 1", "digital_output", output_commands, 2);
+constexpr SentientDeviceDef dev_output_two PROGMEM(naming::DEV_OUTPUT_TWO, "Output 2", "digital_output", output_commands, 2);
+constexpr SentientDeviceDef dev_output_three PROGMEM(naming::DEV_OUTPUT_THREE, "Output 3", "digital_output", output_commands, 2);
+constexpr SentientDeviceDef dev_output_four PROGMEM(naming::DEV_OUTPUT_FOUR, "Output 4", "digital_output", output_commands, 2);
+constexpr SentientDeviceDef dev_output_five PROGMEM(naming::DEV_OUTPUT_FIVE, "Output 5", "digital_output", output_commands, 2);
+constexpr SentientDeviceDef dev_output_six PROGMEM(naming::DEV_OUTPUT_SIX, "Output 6", "digital_output", output_commands, 2);
+constexpr SentientDeviceDef dev_output_seven PROGMEM(naming::DEV_OUTPUT_SEVEN, "Output 7", "digital_output", output_commands, 2);
+constexpr SentientDeviceDef dev_output_eight PROGMEM(naming::DEV_OUTPUT_EIGHT, "Output 8", "digital_output", output_commands, 2);
+constexpr SentientDeviceDef dev_power_switch PROGMEM(naming::DEV_POWER_SWITCH, "Power Switch", "digital_output", output_commands, 2);
 
-SentientDeviceRegistry deviceRegistry;
+SENTIENT_DEVICE_REGISTRY(deviceRegistry,
+    &dev_output_one,
+    &dev_output_two,
+    &dev_output_three,
+    &dev_output_four,
+    &dev_output_five,
+    &dev_output_six,
+    &dev_output_seven,
+    &dev_output_eight,
+    &dev_power_switch);
 
 // ══════════════════════════════════════════════════════════════════════════════
 // SENTIENT MQTT INITIALIZATION
@@ -77,7 +86,7 @@ SentientMQTTConfig make_mqtt_config()
 }
 
 SentientMQTT sentient(make_mqtt_config());
-SentientCapabilityManifest manifest;
+SentientManifestStream manifest(deviceRegistry);
 
 void handle_mqtt_command(const char *command, const JsonDocument &payload, void *ctx);
 void publish_command_acknowledgement(const char *device_id, const char *command);
@@ -115,20 +124,10 @@ void setup()
     delay(2000);
     Serial.println(F("[Vern] Starting..."));
 
-    deviceRegistry.addDevice(&dev_output_one);
-    deviceRegistry.addDevice(&dev_output_two);
-    deviceRegistry.addDevice(&dev_output_three);
-    deviceRegistry.addDevice(&dev_output_four);
-    deviceRegistry.addDevice(&dev_output_five);
-    deviceRegistry.addDevice(&dev_output_six);
-    deviceRegistry.addDevice(&dev_output_seven);
-    deviceRegistry.addDevice(&dev_output_eight);
-    deviceRegistry.addDevice(&dev_power_switch);
     deviceRegistry.printSummary();
 
     manifest.set_controller_info(naming::CONTROLLER_ID, naming::CONTROLLER_FRIENDLY_NAME,
                                  firmware::VERSION, naming::ROOM_ID, naming::CONTROLLER_ID);
-    deviceRegistry.buildManifest(manifest);
 
     sentient.begin();
     sentient.setCommandCallback(handle_mqtt_command);
@@ -142,7 +141,7 @@ void setup()
 
     if (sentient.isConnected())
     {
-        manifest.publish_registration(sentient.get_client(), naming::ROOM_ID, naming::CONTROLLER_ID);
+        manifest.publish_registration(sentient, naming::ROOM_ID, naming::CONTROLLER_ID);
     }
 
     Serial.println(F("[Vern] Ready"));
@@ -155,6 +154,7 @@ void setup()
 void loop()
 {
     sentient.loop();
+    manifest.loop();
     delay(100);
 }
 
@@ -237,7 +237,7 @@ void publish_command_acknowledgement(const char *device_id, const char *command)
                       String(naming::CAT_ACKNOWLEDGEMENT) + "/" + String(naming::CONTROLLER_ID) + "/" +
                       String(device_id) + "/" + String(command);
 
-    sentient.get_client().publish(ackTopic.c_str(), buf, false);
+    sentient.publishTopic(ackTopic.c_str(), buf);
 
     Serial.print(F("[ACK] -> "));
     Serial.println(ackTopic);
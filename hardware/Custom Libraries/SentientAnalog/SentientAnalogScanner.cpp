@@ -0,0 +1,278 @@
+#include "SentientAnalogScanner.h"
+
+namespace
+{
+constexpr uint8_t kNoInput = 0xFF;
+constexpr uint32_t kAdcOff = 0x1F; // ADCH value that stops conversions
+
+// Teensy 4.1 analog pins -> ADC1 / ADC2 input (the core's pin_to_channel table)
+struct AnalogPin
+{
+  uint8_t pin;
+  uint8_t input[2];
+};
+
+constexpr AnalogPin kAnalogPins[] = {
+    {14, {7, 7}}, {15, {8, 8}}, {16, {12, 12}}, {17, {11, 11}}, {18, {6, 6}}, {19, {5, 5}},
+    {20, {15, 15}}, {21, {0, 0}}, {22, {13, 13}}, {23, {14, 14}},
+    {24, {1, kNoInput}}, {25, {2, kNoInput}}, // A10, A11: ADC1 only
+    {26, {kNoInput, 3}}, {27, {kNoInput, 4}}, // A12, A13: ADC2 only
+    {38, {kNoInput, 1}}, {39, {kNoInput, 2}}, // A14, A15: ADC2 only
+    {40, {9, 9}}, {41, {10, 10}}};
+
+uint16_t median3(uint16_t a, uint16_t b, uint16_t c)
+{
+  if (a > b)
+  {
+    const uint16_t t = a;
+    a = b;
+    b = t;
+  }
+  // a <= b: the median is b unless c lies below it
+  return c >= b ? b : (c > a ? c : a);
+}
+}
+
+#if defined(__IMXRT1062__)
+SentientAnalogScanner *SentientAnalogScanner::s_activeInstance = nullptr;
+
+void SentientAnalogScanner::timerThunk()
+{
+  if (s_activeInstance)
+  {
+    s_activeInstance->scan();
+  }
+}
+#endif
+
+int SentientAnalogScanner::add(uint8_t pin, const SentientAnalogFilter &filter)
+{
+  if (_started)
+  {
+    Serial.println(F("[SentientAnalogScanner] Channels must be added before begin()"));
+    return -1;
+  }
+  if (_channelCount >= SENTIENT_ANALOG_CHANNELS)
+  {
+    Serial.println(F("[SentientAnalogScanner] Too many channels; raise SENTIENT_ANALOG_CHANNELS"));
+    return -1;
+  }
+  uint8_t input;
+  bool duplicate = false;
+  for (uint8_t i = 0; i < _channelCount; i++)
+  {
+    duplicate = duplicate || _channels[i].pin == pin;
+  }
+  if (duplicate || (!adcInput(pin, 0, input) && !adcInput(pin, 1, input)))
+  {
+    Serial.print(F("[SentientAnalogScanner] Pin "));
+    Serial.print(pin);
+    Serial.println(duplicate ? F(" added twice") : F(" is not an analog input"));
+    return -1;
+  }
+
+  Channel &channel = _channels[_channelCount];
+  channel.pin = pin;
+  channel.filter = filter;
+  if (channel.filter.smoothing > 8)
+  {
+    channel.filter.smoothing = 8;
+  }
+  return _channelCount++;
+}
+
+bool SentientAnalogScanner::begin(const SentientAnalogConfig &config)
+{
+  if (_started || _channelCount == 0)
+  {
+    return false;
+  }
+  if (config.bits < 8 || config.bits > 12 || config.scanHz == 0)
+  {
+    Serial.println(F("[SentientAnalogScanner] bits must be 8..12 and scanHz above 0"));
+    return false;
+  }
+  _config = config;
+  _fullScale = (1u << config.bits) - 1;
+
+#if defined(__IMXRT1062__)
+  // Pins only one ADC reaches go first; the rest fill up the emptier ADC
+  for (uint8_t pass = 0; pass < 2; pass++)
+  {
+    for (uint8_t i = 0; i < _channelCount; i++)
+    {
+      Channel &channel = _channels[i];
+      uint8_t input1, input2;
+      const bool on1 = adcInput(channel.pin, 0, input1);
+      const bool on2 = adcInput(channel.pin, 1, input2);
+      if ((on1 && on2) != (pass == 1))
+      {
+        continue;
+      }
+      channel.adc = on1 && (!on2 || _adcs[0].count <= _adcs[1].count) ? 0 : 1;
+      channel.input = channel.adc == 0 ? input1 : input2;
+      Adc &adc = _adcs[channel.adc];
+      adc.channels[adc.count++] = i;
+    }
+  }
+
+  // The core configures both ADCs; conversions stay software triggered
+  analogReadResolution(12);
+  analogReadAveraging(config.oversample);
+  for (uint8_t i = 0; i < kAdcs; i++)
+  {
+    if (_adcs[i].count)
+    {
+      startDma(i);
+    }
+  }
+  ADC1_GC |= ADC_GC_DMAEN;
+  ADC2_GC |= ADC_GC_DMAEN;
+
+  s_activeInstance = this;
+  for (uint8_t i = 0; i < kAdcs; i++)
+  {
+    if (_adcs[i].count)
+    {
+      startScan(i);
+    }
+  }
+  _timer.begin(timerThunk, 1000000u / config.scanHz);
+#endif
+  _started = true;
+
+  Serial.print(F("[SentientAnalogScanner] "));
+  Serial.print(_channelCount);
+#if defined(__IMXRT1062__)
+  Serial.print(F(" channels ("));
+  Serial.print(_adcs[0].count);
+  Serial.print(F(" on ADC1, "));
+  Serial.print(_adcs[1].count);
+  Serial.print(F(" on ADC2), "));
+#else
+  Serial.print(F(" channels, "));
+#endif
+  Serial.print(config.scanHz);
+  Serial.print(F(" Hz scans, "));
+  Serial.print(config.bits);
+  Serial.println(F("-bit"));
+  return true;
+}
+
+void SentientAnalogScanner::scan()
+{
+#if defined(__IMXRT1062__)
+  for (uint8_t i = 0; i < kAdcs; i++)
+  {
+    if (_adcs[i].count && scanning(i))
+    {
+      // Conversions take longer than the tick; the next tick gets this scan
+      _overruns = _overruns + 1;
+      return;
+    }
+  }
+  for (uint8_t i = 0; i < kAdcs; i++)
+  {
+    const Adc &adc = _adcs[i];
+    for (uint8_t k = 0; k < adc.count; k++)
+    {
+      filter(_channels[adc.channels[k]], adc.results[k] & 0xFFF);
+    }
+  }
+  for (uint8_t i = 0; i < kAdcs; i++)
+  {
+    if (_adcs[i].count)
+    {
+      startScan(i);
+    }
+  }
+#else
+  for (uint8_t i = 0; i < _channelCount; i++)
+  {
+    filter(_channels[i], analogRead(_channels[i].pin) & 0xFFF);
+  }
+#endif
+  _scans = _scans + 1;
+}
+
+void SentientAnalogScanner::filter(Channel &channel, uint16_t sample)
+{
+  const bool first = _scans == 0;
+  if (first)
+  {
+    channel.history[0] = sample;
+    channel.history[1] = sample;
+    channel.state = (int32_t)sample << 8;
+  }
+
+  const uint16_t x = channel.filter.median ? median3(sample, channel.history[0], channel.history[1]) : sample;
+  channel.history[1] = channel.history[0];
+  channel.history[0] = sample;
+  channel.state += (((int32_t)x << 8) - channel.state) >> channel.filter.smoothing;
+
+  // Back from 12 bits << 8 to the reported resolution, rounded
+  const uint8_t shift = 8 + 12 - _config.bits;
+  uint32_t out = ((uint32_t)channel.state + (1u << (shift - 1))) >> shift;
+  if (out > _fullScale)
+  {
+    out = _fullScale;
+  }
+  channel.raw = sample >> (12 - _config.bits);
+
+  const int32_t moved = (int32_t)out - channel.value;
+  if (first || moved > channel.filter.hysteresis || -moved > channel.filter.hysteresis)
+  {
+    channel.value = out;
+  }
+}
+
+bool SentientAnalogScanner::adcInput(uint8_t pin, uint8_t adc, uint8_t &input)
+{
+  for (const AnalogPin &candidate : kAnalogPins)
+  {
+    if (candidate.pin == pin)
+    {
+      input = candidate.input[adc];
+      return input != kNoInput;
+    }
+  }
+  return false;
+}
+
+#if defined(__IMXRT1062__)
+void SentientAnalogScanner::startDma(uint8_t index)
+{
+  Adc &adc = _adcs[index];
+  volatile uint32_t &select = index == 0 ? ADC1_HC0 : ADC2_HC0;
+  volatile uint32_t &result = index == 0 ? ADC1_R0 : ADC2_R0;
+
+  // Conversion k selects input k + 1 as it completes; the last one stops the ADC
+  for (uint8_t k = 0; k < adc.count; k++)
+  {
+    adc.sequence[k] = k + 1 < adc.count ? _channels[adc.channels[k + 1]].input : kAdcOff;
+  }
+
+  // Both buffers wrap after a scan, so every scan starts at entry 0
+  adc.result.source(result);
+  adc.result.destinationBuffer(adc.results, adc.count * sizeof(adc.results[0]));
+  adc.result.triggerAtHardwareEvent(index == 0 ? DMAMUX_SOURCE_ADC1 : DMAMUX_SOURCE_ADC2);
+
+  // Linked after every result, including the last (a major loop link)
+  adc.select.sourceBuffer(adc.sequence, adc.count * sizeof(adc.sequence[0]));
+  adc.select.destination(select);
+  adc.select.triggerAtTransfersOf(adc.result);
+  adc.select.triggerAtCompletionOf(adc.result);
+  adc.result.enable();
+}
+
+void SentientAnalogScanner::startScan(uint8_t index)
+{
+  const Adc &adc = _adcs[index];
+  (index == 0 ? ADC1_HC0 : ADC2_HC0) = _channels[adc.channels[0]].input;
+}
+
+bool SentientAnalogScanner::scanning(uint8_t index) const
+{
+  return ((index == 0 ? ADC1_HC0 : ADC2_HC0) & kAdcOff) != kAdcOff;
+}
+#endif
@@ -0,0 +1,145 @@
+/*
+ * SentientAnalogScanner.h
+ *
+ * Background analog acquisition: filtered readings without analogRead().
+ *
+ * analogRead() starts a conversion and spins until it finishes, a few
+ * microseconds per sample and longer with averaging, so a sketch averaging
+ * eight pins five times spends a noticeable slice of every loop() waiting.
+ * Here the two i.MX RT1062 ADCs run in parallel, and DMA does the scanning:
+ * - each ADC takes its share of the channels (pins only one ADC can reach go
+ *   to it, the rest are balanced);
+ * - a timer tick starts a scan by selecting the first channel;
+ * - every completed conversion raises a DMA request, one DMA channel stores
+ *   the result and a linked second channel selects the next input, which
+ *   starts the next conversion;
+ * - after the last input the ADC is switched off until the next tick.
+ *
+ * Each conversion is oversampled by the ADC's hardware averaging. The next
+ * tick then filters the finished scan, per channel:
+ * - median of the last three scans, which drops single spikes;
+ * - IIR low pass, y += (x - y) / 2^smoothing;
+ * - hysteresis: the reported value moves only when the filtered one is more
+ *   than `hysteresis` counts away, so a pot resting between two codes does
+ *   not make whatever follows it hunt.
+ *
+ * read() returns the latest filtered value. Values are single aligned
+ * halfwords written by the tick, so reading one needs no lock.
+ *
+ * The scanner owns both ADCs: do not mix it with analogRead().
+ *
+ * USAGE:
+ *   SentientAnalogScanner analog;
+ *   const int pot = analog.add(A10);
+ *   analog.begin();                       // 1 kHz scans, 12-bit values
+ *   ...
+ *   int position = analog.read(pot);      // Never waits for a conversion
+ *
+ * Off-target builds (host simulation) have no ADC: scan() reads every
+ * channel with analogRead() and filters it.
+ */
+
+#ifndef SENTIENT_ANALOG_SCANNER_H
+#define SENTIENT_ANALOG_SCANNER_H
+
+#include <Arduino.h>
+
+#if defined(__IMXRT1062__)
+#include <DMAChannel.h>
+#include <IntervalTimer.h>
+#endif
+
+#ifndef SENTIENT_ANALOG_CHANNELS
+#define SENTIENT_ANALOG_CHANNELS 16 // Channels per scanner, across both ADCs
+#endif
+
+struct SentientAnalogConfig
+{
+  uint16_t scanHz = 1000;   // Scans per second (every channel once per scan)
+  uint8_t oversample = 4;   // Hardware averaging per conversion: 1, 4, 8, 16 or 32
+  uint8_t bits = 12;        // Resolution of read()/raw(), 8..12
+  float referenceVolts = 3.3f;
+};
+
+struct SentientAnalogFilter
+{
+  bool median = true;     // Median of the last three scans
+  uint8_t smoothing = 3;  // IIR strength, 0 = off; settles in about 2^smoothing scans
+  uint8_t hysteresis = 0; // Counts (at config.bits) the filtered value must move before read() follows
+};
+
+class SentientAnalogScanner
+{
+public:
+  SentientAnalogScanner() = default;
+  SentientAnalogScanner(const SentientAnalogScanner &) = delete;
+  SentientAnalogScanner &operator=(const SentientAnalogScanner &) = delete;
+
+  // Register an analog pin before begin(); returns its channel index or -1
+  int add(uint8_t pin, const SentientAnalogFilter &filter = SentientAnalogFilter());
+  bool begin(const SentientAnalogConfig &config = SentientAnalogConfig());
+
+  // Latest filtered value, 0..2^bits - 1; 0 until the first scan is in
+  uint16_t read(uint8_t channel) const { return channel < _channelCount ? _channels[channel].value : 0; }
+  // Latest unfiltered sample
+  uint16_t raw(uint8_t channel) const { return channel < _channelCount ? _channels[channel].raw : 0; }
+  float voltage(uint8_t channel) const { return read(channel) * _config.referenceVolts / _fullScale; }
+  bool ready() const { return _scans != 0; } // At least one scan filtered
+
+  uint8_t count() const { return _channelCount; }
+  uint32_t scans() const { return _scans; }
+  uint32_t overruns() const { return _overruns; } // Ticks that found a scan still running
+
+  // One tick: filter the finished scan and start the next. Runs from the
+  // timer ISR on target; host simulations call it.
+  void scan();
+
+private:
+  struct Channel
+  {
+    uint8_t pin;
+    uint8_t adc;   // 0 = ADC1, 1 = ADC2
+    uint8_t input; // ADC input (ADCH)
+    SentientAnalogFilter filter;
+    uint16_t history[2]; // Previous two samples, for the median
+    int32_t state;       // IIR output, 12-bit value << 8
+    volatile uint16_t value;
+    volatile uint16_t raw;
+  };
+
+  static constexpr uint8_t kAdcs = 2;
+
+  void filter(Channel &channel, uint16_t sample);
+  static bool adcInput(uint8_t pin, uint8_t adc, uint8_t &input);
+
+  SentientAnalogConfig _config;
+  Channel _channels[SENTIENT_ANALOG_CHANNELS] = {};
+  uint8_t _channelCount = 0;
+  uint16_t _fullScale = 4095;
+  bool _started = false;
+  volatile uint32_t _scans = 0;
+  volatile uint32_t _overruns = 0;
+
+#if defined(__IMXRT1062__)
+  struct Adc
+  {
+    uint8_t count = 0;
+    uint8_t channels[SENTIENT_ANALOG_CHANNELS]; // Scan order -> channel index
+    volatile uint32_t results[SENTIENT_ANALOG_CHANNELS]; // Written by the result DMA
+    uint32_t sequence[SENTIENT_ANALOG_CHANNELS]; // ADCH for conversions 2..n, then off
+    DMAChannel result;
+    DMAChannel select;
+  };
+
+  void startDma(uint8_t adc);
+  void startScan(uint8_t adc);
+  bool scanning(uint8_t adc) const;
+
+  Adc _adcs[kAdcs];
+  IntervalTimer _timer;
+  static SentientAnalogScanner *s_activeInstance;
+  static void timerThunk();
+#endif
+};
+
+#endif // SENTIENT_ANALOG_SCANNER_H
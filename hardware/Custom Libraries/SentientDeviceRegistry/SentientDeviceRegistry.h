@@ -9,9 +9,13 @@
  * - Topics are auto-generated from these definitions
  * - Impossible for things to get out of sync
  *
+ * Everything is resolved at compile time: device definitions, the device
+ * table and its hash index are constexpr and live in flash. Duplicate
+ * device ids (or a command listed twice on one device) fail the build.
+ *
  * USAGE:
- * 1. Define devices in your .ino file
- * 2. Call buildManifestFromRegistry() to auto-generate manifest
+ * 1. Define devices in your .ino file with constexpr
+ * 2. List them once with SENTIENT_DEVICE_REGISTRY(deviceRegistry, &dev_a, &dev_b, ...)
  * 3. That's it!
  */
 
@@ -21,9 +25,6 @@
 #include <Arduino.h>
 #include <SentientCapabilityManifest.h>
 
-// Maximum number of commands or sensors per device
-#define MAX_TOPICS_PER_DEVICE 10
-
 // ============================================================================
 // DEVICE DEFINITION STRUCTURE
 // ============================================================================
@@ -36,75 +37,177 @@ struct SentientDeviceDef
   const char *category;      // "input", "output", "bidirectional"
 
   // Commands this device responds to (output devices)
-  const char *commands[MAX_TOPICS_PER_DEVICE];
+  const char *const *commands;
   int command_count;
 
   // Sensor topics this device publishes (input devices)
-  const char *sensors[MAX_TOPICS_PER_DEVICE];
+  const char *const *sensors;
   int sensor_count;
 
   // Constructor for output device with commands
-  SentientDeviceDef(const char *id, const char *name, const char *type,
-                    const char **cmds, int cmd_count)
-      : device_id(id), friendly_name(name), device_type(type),
-        category("output"), command_count(cmd_count), sensor_count(0)
+  constexpr SentientDeviceDef(const char *id, const char *name, const char *type,
+                              const char *const *cmds, int cmd_count)
+      : device_id(id), friendly_name(name), device_type(type), category("output"),
+        commands(cmds), command_count(cmd_count), sensors(nullptr), sensor_count(0)
   {
-    for (int i = 0; i < cmd_count && i < MAX_TOPICS_PER_DEVICE; i++)
-    {
-      commands[i] = cmds[i];
-    }
-    for (int i = cmd_count; i < MAX_TOPICS_PER_DEVICE; i++)
-    {
-      commands[i] = nullptr;
-    }
-    for (int i = 0; i < MAX_TOPICS_PER_DEVICE; i++)
+  }
+
+  // Constructor for input device with sensors
+  constexpr SentientDeviceDef(const char *id, const char *name, const char *type,
+                              const char *const *snsr, int snsr_count, bool is_input)
+      : device_id(id), friendly_name(name), device_type(type), category("input"),
+        commands(nullptr), command_count(0), sensors(snsr), sensor_count(snsr_count)
+  {
+  }
+
+  // Constructor for bidirectional device
+  constexpr SentientDeviceDef(const char *id, const char *name, const char *type,
+                              const char *const *cmds, int cmd_count,
+                              const char *const *snsr, int snsr_count)
+      : device_id(id), friendly_name(name), device_type(type), category("bidirectional"),
+        commands(cmds), command_count(cmd_count), sensors(snsr), sensor_count(snsr_count)
+  {
+  }
+};
+
+// ============================================================================
+// COMPILE-TIME INDEX
+// ============================================================================
+
+namespace sentient_registry
+{
+  constexpr uint8_t kEmpty = 0xFF;
+
+  // Open-addressing slot: device table position and command position
+  struct Slot
+  {
+    uint8_t device;
+    uint8_t entry;
+  };
+
+  // FNV-1a; evaluated at compile time for the index, at run time for lookups
+  constexpr uint32_t hash(const char *text)
+  {
+    uint32_t h = 2166136261u;
+    for (; *text; ++text)
     {
-      sensors[i] = nullptr;
+      h ^= static_cast<uint8_t>(*text);
+      h *= 16777619u;
     }
+    return h;
   }
 
-  // Constructor for input device with sensors
-  SentientDeviceDef(const char *id, const char *name, const char *type,
-                    const char **snsr, int snsr_count, bool is_input)
-      : device_id(id), friendly_name(name), device_type(type),
-        category("input"), command_count(0), sensor_count(snsr_count)
+  constexpr bool equal(const char *a, const char *b)
   {
-    for (int i = 0; i < snsr_count && i < MAX_TOPICS_PER_DEVICE; i++)
+    for (; *a && *a == *b; ++a, ++b)
     {
-      sensors[i] = snsr[i];
     }
-    for (int i = snsr_count; i < MAX_TOPICS_PER_DEVICE; i++)
+    return *a == *b;
+  }
+
+  // Power of two at least twice the entry count, so probes stay short and
+  // every chain ends in an empty slot
+  constexpr size_t slots_for(size_t entries)
+  {
+    size_t slots = 4;
+    while (slots < entries * 2)
     {
-      sensors[i] = nullptr;
+      slots <<= 1;
     }
-    for (int i = 0; i < MAX_TOPICS_PER_DEVICE; i++)
+    return slots;
+  }
+
+  template <size_t N>
+  constexpr size_t command_total(const SentientDeviceDef *const (&devices)[N])
+  {
+    size_t total = 0;
+    for (size_t i = 0; i < N; i++)
     {
-      commands[i] = nullptr;
+      total += devices[i]->command_count;
     }
+    return total;
   }
 
-  // Constructor for bidirectional device
-  SentientDeviceDef(const char *id, const char *name, const char *type,
-                    const char **cmds, int cmd_count,
-                    const char **snsr, int snsr_count)
-      : device_id(id), friendly_name(name), device_type(type),
-        category("bidirectional"), command_count(cmd_count), sensor_count(snsr_count)
+  template <size_t N>
+  constexpr bool unique_device_ids(const SentientDeviceDef *const (&devices)[N])
   {
-    for (int i = 0; i < cmd_count && i < MAX_TOPICS_PER_DEVICE; i++)
+    for (size_t i = 0; i < N; i++)
     {
-      commands[i] = cmds[i];
+      for (size_t j = i + 1; j < N; j++)
+      {
+        if (equal(devices[i]->device_id, devices[j]->device_id))
+          return false;
+      }
     }
-    for (int i = cmd_count; i < MAX_TOPICS_PER_DEVICE; i++)
+    return true;
+  }
+
+  // Commands on one device map to distinct topics, so none may repeat
+  template <size_t N>
+  constexpr bool unique_commands(const SentientDeviceDef *const (&devices)[N])
+  {
+    for (size_t i = 0; i < N; i++)
     {
-      commands[i] = nullptr;
+      const SentientDeviceDef &dev = *devices[i];
+      for (int a = 0; a < dev.command_count; a++)
+      {
+        for (int b = a + 1; b < dev.command_count; b++)
+        {
+          if (equal(dev.commands[a], dev.commands[b]))
+            return false;
+        }
+      }
     }
-    for (int i = 0; i < snsr_count && i < MAX_TOPICS_PER_DEVICE; i++)
+    return true;
+  }
+}
+
+// Hash tables over device ids and command names, built by the compiler
+template <size_t DeviceSlots, size_t CommandSlots>
+struct SentientRegistryIndex
+{
+  sentient_registry::Slot devices[DeviceSlots] = {};
+  sentient_registry::Slot commands[CommandSlots] = {};
+
+  template <size_t N>
+  constexpr SentientRegistryIndex(const SentientDeviceDef *const (&defs)[N])
+  {
+    static_assert(N < sentient_registry::kEmpty, "Too many devices for one registry");
+
+    for (size_t k = 0; k < DeviceSlots; k++)
+      devices[k].device = sentient_registry::kEmpty;
+    for (size_t k = 0; k < CommandSlots; k++)
+      commands[k].device = sentient_registry::kEmpty;
+
+    for (size_t i = 0; i < N; i++)
     {
-      sensors[i] = snsr[i];
+      size_t k = sentient_registry::hash(defs[i]->device_id) & (DeviceSlots - 1);
+      while (devices[k].device != sentient_registry::kEmpty)
+        k = (k + 1) & (DeviceSlots - 1);
+      devices[k] = {static_cast<uint8_t>(i), 0};
     }
-    for (int i = snsr_count; i < MAX_TOPICS_PER_DEVICE; i++)
+
+    // Each distinct command name once; shared names ("on", "off") resolve
+    // to the first device that declares them
+    for (size_t i = 0; i < N; i++)
     {
-      sensors[i] = nullptr;
+      for (int j = 0; j < defs[i]->command_count; j++)
+      {
+        const char *name = defs[i]->commands[j];
+        size_t k = sentient_registry::hash(name) & (CommandSlots - 1);
+        bool present = false;
+        while (commands[k].device != sentient_registry::kEmpty)
+        {
+          if (sentient_registry::equal(defs[commands[k].device]->commands[commands[k].entry], name))
+          {
+            present = true;
+            break;
+          }
+          k = (k + 1) & (CommandSlots - 1);
+        }
+        if (!present)
+          commands[k] = {static_cast<uint8_t>(i), static_cast<uint8_t>(j)};
+      }
     }
   }
 };
@@ -116,50 +219,35 @@ struct SentientDeviceDef
 class SentientDeviceRegistry
 {
 private:
-  SentientDeviceDef **devices;
+  const SentientDeviceDef *const *devices;
   int device_count;
-  int max_devices;
+  const sentient_registry::Slot *device_slots;
+  size_t device_mask;
+  const sentient_registry::Slot *command_slots;
+  size_t command_mask;
 
 public:
-  SentientDeviceRegistry(int max_devs = 40)
-      : device_count(0), max_devices(max_devs)
-  {
-    devices = new SentientDeviceDef *[max_devices];
-    for (int i = 0; i < max_devices; i++)
-    {
-      devices[i] = nullptr;
-    }
-  }
-
-  ~SentientDeviceRegistry()
-  {
-    delete[] devices;
-  }
-
-  // Add a device to the registry
-  bool addDevice(SentientDeviceDef *device)
+  // Use SENTIENT_DEVICE_REGISTRY() rather than calling this directly
+  template <size_t N, size_t DeviceSlots, size_t CommandSlots>
+  constexpr SentientDeviceRegistry(const SentientDeviceDef *const (&defs)[N],
+                                   const SentientRegistryIndex<DeviceSlots, CommandSlots> &index)
+      : devices(defs), device_count(N),
+        device_slots(index.devices), device_mask(DeviceSlots - 1),
+        command_slots(index.commands), command_mask(CommandSlots - 1)
   {
-    if (device_count >= max_devices)
-    {
-      Serial.println(F("[Registry] ERROR: Max devices reached"));
-      return false;
-    }
-    devices[device_count++] = device;
-    return true;
   }
 
   // Build manifest from all registered devices
-  void buildManifest(SentientCapabilityManifest &manifest)
+  void buildManifest(SentientCapabilityManifest &manifest) const
   {
     Serial.print(F("[Registry] Building manifest for "));
     Serial.print(device_count);
     Serial.println(F(" devices"));
 
+    char topic[64];
     for (int i = 0; i < device_count; i++)
     {
-      SentientDeviceDef *dev = devices[i];
-      if (!dev)
-        continue;
+      const SentientDeviceDef *dev = devices[i];
 
       // Add device with primary command name (first command in the list)
       const char *primary_command = (dev->command_count > 0) ? dev->commands[0] : nullptr;
@@ -167,44 +255,57 @@ public:
                           dev->device_type, dev->category, primary_command);
 
       // Add command topics
-      for (int j = 0; j < dev->command_count && j < MAX_TOPICS_PER_DEVICE; j++)
+      for (int j = 0; j < dev->command_count; j++)
       {
-        if (dev->commands[j])
-        {
-          String topic = String("commands/") + dev->commands[j];
-          manifest.add_device_topic(dev->device_id, topic.c_str(), "command");
+        snprintf(topic, sizeof(topic), "commands/%s", dev->commands[j]);
+        manifest.add_device_topic(dev->device_id, topic, "command");
 
-          Serial.print(F("  [Registry] Added command: "));
-          Serial.print(dev->device_id);
-          Serial.print(F(" -> "));
-          Serial.println(topic);
-        }
+        Serial.print(F("  [Registry] Added command: "));
+        Serial.print(dev->device_id);
+        Serial.print(F(" -> "));
+        Serial.println(topic);
       }
 
       // Add sensor topics
-      for (int j = 0; j < dev->sensor_count && j < MAX_TOPICS_PER_DEVICE; j++)
+      for (int j = 0; j < dev->sensor_count; j++)
       {
-        if (dev->sensors[j])
-        {
-          String topic = String("sensors/") + dev->sensors[j];
-          manifest.add_device_topic(dev->device_id, topic.c_str(), "sensor");
+        snprintf(topic, sizeof(topic), "sensors/%s", dev->sensors[j]);
+        manifest.add_device_topic(dev->device_id, topic, "sensor");
 
-          Serial.print(F("  [Registry] Added sensor: "));
-          Serial.print(dev->device_id);
-          Serial.print(F(" -> "));
-          Serial.println(topic);
-        }
+        Serial.print(F("  [Registry] Added sensor: "));
+        Serial.print(dev->device_id);
+        Serial.print(F(" -> "));
+        Serial.println(topic);
       }
     }
 
     Serial.println(F("[Registry] Manifest build complete"));
   }
 
+  // Register every device's commands with a command router (SentientMQTT::onCommands).
+  // The handler receives the matching SentientDeviceDef as its context and the
+  // command's position in the device's list as command.index.
+  template <typename Dispatcher, typename Handler>
+  int routeCommands(Dispatcher &dispatcher, Handler handler) const
+  {
+    int routed = 0;
+    for (int i = 0; i < device_count; i++)
+    {
+      const SentientDeviceDef *dev = devices[i];
+      if (dev->command_count == 0)
+        continue;
+
+      routed += dispatcher.onCommands(dev->device_id, dev->commands, dev->command_count, handler,
+                                      const_cast<SentientDeviceDef *>(dev));
+    }
+    return routed;
+  }
+
   // Get device count
   int getDeviceCount() const { return device_count; }
 
   // Get device by index
-  SentientDeviceDef *getDevice(int index)
+  const SentientDeviceDef *getDevice(int index) const
   {
     if (index >= 0 && index < device_count)
     {
@@ -213,41 +314,40 @@ public:
     return nullptr;
   }
 
-  // Find device by ID
-  SentientDeviceDef *findDevice(const char *device_id)
+  // Find device by ID (hash lookup, independent of device count)
+  const SentientDeviceDef *findDevice(const char *device_id) const
   {
-    for (int i = 0; i < device_count; i++)
+    if (!device_id)
+      return nullptr;
+
+    for (size_t k = sentient_registry::hash(device_id) & device_mask;; k = (k + 1) & device_mask)
     {
-      if (devices[i] && strcmp(devices[i]->device_id, device_id) == 0)
-      {
-        return devices[i];
-      }
+      const sentient_registry::Slot &slot = device_slots[k];
+      if (slot.device == sentient_registry::kEmpty)
+        return nullptr;
+      if (strcmp(devices[slot.device]->device_id, device_id) == 0)
+        return devices[slot.device];
     }
-    return nullptr;
   }
 
-  // Check if command exists for any device
-  bool isValidCommand(const char *command)
+  // Check if command exists for any device (hash lookup)
+  bool isValidCommand(const char *command) const
   {
-    for (int i = 0; i < device_count; i++)
-    {
-      SentientDeviceDef *dev = devices[i];
-      if (!dev)
-        continue;
+    if (!command)
+      return false;
 
-      for (int j = 0; j < dev->command_count; j++)
-      {
-        if (dev->commands[j] && strcmp(dev->commands[j], command) == 0)
-        {
-          return true;
-        }
-      }
+    for (size_t k = sentient_registry::hash(command) & command_mask;; k = (k + 1) & command_mask)
+    {
+      const sentient_registry::Slot &slot = command_slots[k];
+      if (slot.device == sentient_registry::kEmpty)
+        return false;
+      if (strcmp(devices[slot.device]->commands[slot.entry], command) == 0)
+        return true;
     }
-    return false;
   }
 
   // Print registry summary
-  void printSummary()
+  void printSummary() const
   {
     Serial.println(F("\n========================================"));
     Serial.println(F("DEVICE REGISTRY SUMMARY"));
@@ -257,9 +357,7 @@ public:
 
     for (int i = 0; i < device_count; i++)
     {
-      SentientDeviceDef *dev = devices[i];
-      if (!dev)
-        continue;
+      const SentientDeviceDef *dev = devices[i];
 
       Serial.println();
       Serial.print(F("Device: "));
@@ -276,11 +374,8 @@ public:
         Serial.println(F("  Commands:"));
         for (int j = 0; j < dev->command_count; j++)
         {
-          if (dev->commands[j])
-          {
-            Serial.print(F("    - "));
-            Serial.println(dev->commands[j]);
-          }
+          Serial.print(F("    - "));
+          Serial.println(dev->commands[j]);
         }
       }
 
@@ -289,11 +384,8 @@ public:
         Serial.println(F("  Sensors:"));
         for (int j = 0; j < dev->sensor_count; j++)
         {
-          if (dev->sensors[j])
-          {
-            Serial.print(F("    - "));
-            Serial.println(dev->sensors[j]);
-          }
+          Serial.print(F("    - "));
+          Serial.println(dev->sensors[j]);
         }
       }
     }
@@ -301,4 +393,19 @@ public:
   }
 };
 
+// Declare a registry over constexpr device definitions. The device table,
+// its index and the registry itself are placed in flash, and the listed
+// devices are checked for duplicate ids at compile time.
+//
+//   SENTIENT_DEVICE_REGISTRY(deviceRegistry, &dev_a, &dev_b, &dev_c);
+#define SENTIENT_DEVICE_REGISTRY(name, ...)                                                            \
+  constexpr const SentientDeviceDef *const name##_devices[] PROGMEM = {__VA_ARGS__};                  \
+  static_assert(sentient_registry::unique_device_ids(name##_devices), "Duplicate device_id in " #name); \
+  static_assert(sentient_registry::unique_commands(name##_devices), "Duplicate command on a device in " #name); \
+  constexpr SentientRegistryIndex<                                                                     \
+      sentient_registry::slots_for(sizeof(name##_devices) / sizeof(name##_devices[0])),               \
+      sentient_registry::slots_for(sentient_registry::command_total(name##_devices))>                 \
+      name##_index PROGMEM(name##_devices);                                                            \
+  constexpr SentientDeviceRegistry name PROGMEM(name##_devices, name##_index)
+
 #endif // SENTIENT_DEVICE_REGISTRY_H
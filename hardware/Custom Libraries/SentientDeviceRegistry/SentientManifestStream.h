@@ -0,0 +1,571 @@
+/*
+ * SentientManifestStream.h
+ *
+ * Streams Sentient registration straight from a SentientDeviceRegistry.
+ *
+ * SentientCapabilityManifest keeps the whole manifest in a resident 4 KB
+ * JsonDocument. It then rebuilds every message in a second document,
+ * copies it into a String, and blocks in delay() between publishes.
+ *
+ * This class sends the same messages (controller first, then one per
+ * device) without building a document at all:
+ * - Each message is generated from the device definitions twice: once to
+ *   count its bytes, then once into SentientMQTT::beginPublish()/
+ *   writePayload() through a small stack chunk buffer.
+ * - The controller message goes out in publish_registration(). loop()
+ *   sends at most one device per call, spaced by the gaps the old delay()
+ *   calls gave the broker, so registration never stalls the sketch.
+ * - A message only starts once the socket's send queue has room for all of
+ *   it; while the queue is busy loop() tries the same message again after
+ *   the gap instead of failing the registration.
+ * - A registration that fails part way (broker lost, message cut short)
+ *   starts again from the controller message after a backoff, and every
+ *   reconnect registers again, so the controller is never left
+ *   half-registered and sketches have nothing to retry.
+ *
+ * USAGE:
+ *   SentientManifestStream manifest(deviceRegistry);
+ *   manifest.set_controller_info(...);                  // same as before
+ *   manifest.publish_registration(mqtt, room_id, ...);  // starts registration, once
+ *   manifest.loop();                                    // from loop()
+ */
+
+#ifndef SENTIENT_MANIFEST_STREAM_H
+#define SENTIENT_MANIFEST_STREAM_H
+
+#include <Arduino.h>
+#include <SentientMQTT.h>
+#include "SentientDeviceRegistry.h"
+
+#ifndef SENTIENT_MANIFEST_CHUNK_BYTES
+#define SENTIENT_MANIFEST_CHUNK_BYTES 128 // Bytes buffered on the stack per client write
+#endif
+#ifndef SENTIENT_MANIFEST_CONTROLLER_GAP_MS
+#define SENTIENT_MANIFEST_CONTROLLER_GAP_MS 100 // Broker processing time after the controller message
+#endif
+#ifndef SENTIENT_MANIFEST_DEVICE_GAP_MS
+#define SENTIENT_MANIFEST_DEVICE_GAP_MS 50 // Spacing between device messages
+#endif
+#ifndef SENTIENT_MANIFEST_RETRY_MS
+#define SENTIENT_MANIFEST_RETRY_MS 1'000 // First backoff after a failed registration (doubles per failure)
+#endif
+#ifndef SENTIENT_MANIFEST_RETRY_MAX_MS
+#define SENTIENT_MANIFEST_RETRY_MAX_MS 30'000 // Longest backoff
+#endif
+
+class SentientManifestStream
+{
+public:
+  explicit SentientManifestStream(const SentientDeviceRegistry &registry) : registry(registry) {}
+
+  /**
+   * Set controller metadata (pointers are kept, not copied)
+   */
+  void set_controller_info(const char *unique_id, const char *friendly_name,
+                           const char *firmware_version,
+                           const char *room_id, const char *controller_id)
+  {
+    this->unique_id = unique_id;
+    this->friendly_name = friendly_name;
+    this->firmware_version = firmware_version;
+    this->room_id = room_id;
+    this->controller_id = controller_id;
+  }
+
+  /**
+   * Start registration: the controller message goes out now if the broker
+   * is connected, then loop() streams the devices. Returns true if the
+   * controller message was sent. Either way the stream owns the retries:
+   * a failed registration starts again from the controller message after a
+   * backoff, and every reconnect registers again, so the sketch only calls
+   * this once.
+   */
+  bool publish_registration(SentientMQTT &mqtt_client, const char *room_id_uuid, const char *mqtt_device_id = "Teensy 4.1")
+  {
+    mqtt = &mqtt_client;
+    registration_room = room_id_uuid;
+    retry_ms = 0;
+    was_connected = mqtt->isConnected();
+
+    Serial.println(F("[CapabilityManifest] Starting registration..."));
+    Serial.print(F("[CapabilityManifest] Controller: "));
+    Serial.println(controller_unique_id());
+    Serial.print(F("[CapabilityManifest] Devices to register: "));
+    Serial.println(registry.getDeviceCount());
+
+    restart();
+    if (was_connected)
+    {
+      send_controller();
+    }
+    return state == State::Devices;
+  }
+
+  /**
+   * Send the next message once its gap has elapsed, and retry or register
+   * again when needed; call every loop()
+   */
+  void loop()
+  {
+    if (state == State::Idle)
+    {
+      return;
+    }
+
+    const bool connected = mqtt->isConnected();
+    if (connected != was_connected)
+    {
+      was_connected = connected;
+      if (connected && state != State::Failed) // A failed one waits out its backoff below
+      {
+        // The controller service may have missed anything sent before the drop
+        Serial.println(F("[CapabilityManifest] Broker reconnected, registering again"));
+        restart();
+      }
+      else if (in_progress())
+      {
+        Serial.println(F("[CapabilityManifest] Broker lost during registration"));
+        fail();
+      }
+    }
+    if (!connected)
+    {
+      return;
+    }
+
+    if (state == State::Failed)
+    {
+      if (millis() - last_send < retry_ms)
+      {
+        return;
+      }
+      Serial.println(F("[CapabilityManifest] Retrying registration..."));
+      restart();
+    }
+    if (!in_progress() || millis() - last_send < gap_ms)
+    {
+      return;
+    }
+    if (state == State::Controller)
+    {
+      send_controller();
+      return;
+    }
+
+    const SentientDeviceDef *device = registry.getDevice(next_device);
+    if (!device)
+    {
+      finish();
+      return;
+    }
+
+    const uint32_t step_start = micros();
+    size_t length = 0;
+    const Sent sent = send("sentient/system/register/device", device, length);
+    note_step(step_start);
+    if (sent == Sent::Busy)
+    {
+      last_send = millis(); // Nothing went out; try this device again after the gap
+      return;
+    }
+    if (sent == Sent::Failed)
+    {
+      Serial.print(F("[CapabilityManifest] Device "));
+      Serial.print(device_index);
+      Serial.println(F(" registration failed!"));
+      fail();
+      return;
+    }
+
+    if (length > largest_device_message)
+    {
+      largest_device_message = length;
+    }
+    next_device++;
+    device_index++;
+    last_send = millis();
+    gap_ms = SENTIENT_MANIFEST_DEVICE_GAP_MS;
+  }
+
+  bool in_progress() const { return state == State::Controller || state == State::Devices; }
+  bool registered() const { return state == State::Complete; }
+  bool failed() const { return state == State::Failed; } // Waiting out the backoff before a retry
+
+  // Measurements from the most recent registration
+  uint32_t wall_time_ms() const { return finished_at - started_at; }
+  uint32_t longest_step_us() const { return longest_step; }
+  uint32_t bytes_streamed() const { return streamed_bytes; }
+
+private:
+  enum class State : uint8_t
+  {
+    Idle,
+    Controller,
+    Devices,
+    Complete,
+    Failed
+  };
+
+  enum class Sent : uint8_t
+  {
+    Done,
+    Busy,  // Send queue full or broker offline: nothing was sent
+    Failed // Cut short part way (the connection is dropped)
+  };
+
+  // Counts bytes for the MQTT length header
+  struct LengthSink
+  {
+    size_t length = 0;
+    void write(const char *, size_t n) { length += n; }
+  };
+
+  // Forwards bytes to the open publish in SENTIENT_MANIFEST_CHUNK_BYTES pieces
+  struct ClientSink
+  {
+    SentientMQTT &client;
+    char buffer[SENTIENT_MANIFEST_CHUNK_BYTES];
+    size_t used = 0;
+    bool ok = true;
+
+    explicit ClientSink(SentientMQTT &client) : client(client) {}
+
+    void write(const char *data, size_t n)
+    {
+      while (n > 0)
+      {
+        size_t room = sizeof(buffer) - used;
+        size_t take = n < room ? n : room;
+        memcpy(buffer + used, data, take);
+        used += take;
+        data += take;
+        n -= take;
+        if (used == sizeof(buffer))
+        {
+          flush();
+        }
+      }
+    }
+
+    void flush()
+    {
+      if (used > 0 && ok)
+      {
+        ok = client.writePayload(reinterpret_cast<const uint8_t *>(buffer), used);
+      }
+      used = 0;
+    }
+  };
+
+  // Generate one message (controller when device is null) and publish it;
+  // length is the payload length once it is Done
+  Sent send(const char *topic, const SentientDeviceDef *device, size_t &length)
+  {
+    LengthSink measure;
+    write_message(measure, device);
+
+    if (!mqtt->beginPublish(topic, measure.length, false))
+    {
+      return Sent::Busy;
+    }
+    ClientSink out(*mqtt);
+    write_message(out, device);
+    out.flush();
+    if (!mqtt->endPublish())
+    {
+      return Sent::Failed;
+    }
+    streamed_bytes += measure.length;
+    length = measure.length;
+    return Sent::Done;
+  }
+
+  template <typename Sink>
+  void write_message(Sink &out, const SentientDeviceDef *device)
+  {
+    if (device)
+    {
+      write_device(out, *device);
+    }
+    else
+    {
+      write_controller(out);
+    }
+  }
+
+  template <typename Sink>
+  void write_controller(Sink &out)
+  {
+    raw(out, "{\"controller_id\":");
+    string(out, controller_unique_id());
+    raw(out, ",\"room_id\":");
+    string(out, registration_room);
+    raw(out, ",\"friendly_name\":");
+    string(out, or_empty(friendly_name));
+    raw(out, ",\"hardware_type\":\"Teensy 4.1\",\"mcu_model\":\"ARM Cortex-M7\",\"clock_speed_mhz\":600");
+    raw(out, ",\"firmware_version\":");
+    string(out, or_empty(firmware_version));
+    raw(out, ",\"digital_pins_total\":55,\"analog_pins_total\":18,\"heartbeat_interval_ms\":5000");
+    raw(out, ",\"controller_type\":\"microcontroller\",\"device_count\":");
+    number(out, registry.getDeviceCount());
+
+    // MQTT topic structure (CRITICAL for command routing)
+    raw(out, ",\"mqtt_namespace\":\"paragon\",\"mqtt_room_id\":");
+    string(out, or_empty(room_id));
+    raw(out, ",\"mqtt_controller_id\":");
+    string(out, or_empty(controller_id));
+
+    // Capability manifest for device sync
+    raw(out, ",\"capability_manifest\":{\"controller_id\":");
+    string(out, controller_unique_id());
+    raw(out, ",\"firmware_version\":");
+    string(out, or_empty(firmware_version));
+    raw(out, ",\"devices\":[");
+    bool first = true;
+    for (int i = 0; i < registry.getDeviceCount(); i++)
+    {
+      const SentientDeviceDef *dev = registry.getDevice(i);
+      raw(out, first ? "{\"device_id\":" : ",{\"device_id\":");
+      first = false;
+      string(out, dev->device_id);
+      raw(out, ",\"device_type\":");
+      string(out, dev->device_type);
+      raw(out, ",\"friendly_name\":");
+      string(out, dev->friendly_name);
+      raw(out, ",\"device_category\":");
+      string(out, dev->category);
+      raw(out, "}");
+    }
+    raw(out, "]}}");
+  }
+
+  template <typename Sink>
+  void write_device(Sink &out, const SentientDeviceDef &dev)
+  {
+    raw(out, "{\"controller_id\":");
+    string(out, controller_unique_id());
+    raw(out, ",\"device_index\":");
+    number(out, device_index);
+    raw(out, ",\"device_id\":");
+    string(out, dev.device_id);
+    raw(out, ",\"friendly_name\":");
+    string(out, dev.friendly_name);
+    raw(out, ",\"device_type\":");
+    string(out, dev.device_type);
+    raw(out, ",\"device_category\":");
+    string(out, dev.category);
+    if (dev.command_count > 0 && dev.commands[0][0] != '\0')
+    {
+      raw(out, ",\"device_command_name\":");
+      string(out, dev.commands[0]);
+    }
+
+    // Topics for this device (enables multi-command support)
+    raw(out, ",\"mqtt_topics\":[");
+    bool first = true;
+    for (int j = 0; j < dev.command_count; j++)
+    {
+      topic(out, first, "commands/", dev.commands[j], "command");
+    }
+    for (int j = 0; j < dev.sensor_count; j++)
+    {
+      topic(out, first, "sensors/", dev.sensors[j], "sensor");
+    }
+    raw(out, "]}");
+  }
+
+  template <typename Sink>
+  static void topic(Sink &out, bool &first, const char *prefix, const char *name, const char *type)
+  {
+    raw(out, first ? "{\"topic\":\"" : ",{\"topic\":\"");
+    first = false;
+    raw(out, prefix);
+    escaped(out, name);
+    raw(out, "\",\"topic_type\":\"");
+    raw(out, type);
+    raw(out, "\"}");
+  }
+
+  template <typename Sink>
+  static void raw(Sink &out, const char *text)
+  {
+    out.write(text, strlen(text));
+  }
+
+  template <typename Sink>
+  static void string(Sink &out, const char *text)
+  {
+    if (!text)
+    {
+      raw(out, "null");
+      return;
+    }
+    raw(out, "\"");
+    escaped(out, text);
+    raw(out, "\"");
+  }
+
+  template <typename Sink>
+  static void escaped(Sink &out, const char *text)
+  {
+    const char *run = text;
+    for (const char *p = text; *p; ++p)
+    {
+      const unsigned char c = static_cast<unsigned char>(*p);
+      if (c != '"' && c != '\\' && c >= 0x20)
+      {
+        continue;
+      }
+      out.write(run, p - run);
+      char escape[7];
+      if (c == '"' || c == '\\')
+      {
+        escape[0] = '\\';
+        escape[1] = static_cast<char>(c);
+        out.write(escape, 2);
+      }
+      else
+      {
+        snprintf(escape, sizeof(escape), "\\u%04x", c);
+        out.write(escape, 6);
+      }
+      run = p + 1;
+    }
+    raw(out, run);
+  }
+
+  template <typename Sink>
+  static void number(Sink &out, long value)
+  {
+    char digits[12];
+    int length = snprintf(digits, sizeof(digits), "%ld", value);
+    out.write(digits, length);
+  }
+
+  static const char *or_empty(const char *text) { return text ? text : ""; }
+  const char *controller_unique_id() const { return unique_id ? unique_id : "UNKNOWN"; }
+
+  void note_step(uint32_t step_start)
+  {
+    const uint32_t elapsed = micros() - step_start;
+    if (elapsed > longest_step)
+    {
+      longest_step = elapsed;
+    }
+  }
+
+  // Start over from the controller message
+  void restart()
+  {
+    next_device = 0;
+    device_index = 0;
+    streamed_bytes = 0;
+    largest_device_message = 0;
+    controller_message = 0;
+    longest_step = 0;
+    started_at = millis();
+    state = State::Controller;
+    last_send = millis();
+    gap_ms = 0;
+  }
+
+  void send_controller()
+  {
+    const uint32_t step_start = micros();
+    const Sent sent = send("sentient/system/register/controller", nullptr, controller_message);
+    note_step(step_start);
+    if (sent == Sent::Busy)
+    {
+      last_send = millis(); // Nothing went out; try again after a device gap
+      gap_ms = SENTIENT_MANIFEST_DEVICE_GAP_MS;
+      return;
+    }
+    if (sent == Sent::Failed)
+    {
+      Serial.println(F("[CapabilityManifest] Controller registration failed!"));
+      fail();
+      return;
+    }
+
+    Serial.print(F("[CapabilityManifest] Controller registered ("));
+    Serial.print(controller_message);
+    Serial.println(F(" bytes)"));
+    state = State::Devices;
+    last_send = millis();
+    gap_ms = SENTIENT_MANIFEST_CONTROLLER_GAP_MS;
+  }
+
+  // Back off, doubling up to SENTIENT_MANIFEST_RETRY_MAX_MS, then loop() restarts
+  void fail()
+  {
+    state = State::Failed;
+    last_send = millis();
+    retry_ms = retry_ms == 0 ? SENTIENT_MANIFEST_RETRY_MS : retry_ms * 2;
+    if (retry_ms > SENTIENT_MANIFEST_RETRY_MAX_MS)
+    {
+      retry_ms = SENTIENT_MANIFEST_RETRY_MAX_MS;
+    }
+    Serial.print(F("[CapabilityManifest] Retrying in "));
+    Serial.print(retry_ms);
+    Serial.println(F(" ms"));
+  }
+
+  void finish()
+  {
+    state = State::Complete;
+    finished_at = millis();
+    retry_ms = 0;
+
+    Serial.print(F("[CapabilityManifest] Registration complete! "));
+    Serial.print(device_index);
+    Serial.print(F(" devices registered in "));
+    Serial.print(wall_time_ms());
+    Serial.print(F(" ms, "));
+    Serial.print(streamed_bytes);
+    Serial.print(F(" bytes, longest loop() step "));
+    Serial.print(longest_step);
+    Serial.println(F(" us"));
+
+    // The document path kept SentientCapabilityManifest resident and, per
+    // message, a 2 KB / 512 B document plus a String copy of the payload
+    const size_t controller_peak = 2048 + controller_message + 1;
+    const size_t device_peak = 512 + largest_device_message + 1;
+    const size_t document_peak = controller_peak > device_peak ? controller_peak : device_peak;
+    Serial.print(F("[CapabilityManifest] RAM: "));
+    Serial.print(sizeof(*this));
+    Serial.print(F(" B resident + "));
+    Serial.print(sizeof(ClientSink));
+    Serial.print(F(" B stack (document path: "));
+    Serial.print(sizeof(SentientCapabilityManifest));
+    Serial.print(F(" B resident + "));
+    Serial.print(document_peak);
+    Serial.println(F(" B peak)"));
+  }
+
+  const SentientDeviceRegistry &registry;
+  SentientMQTT *mqtt = nullptr;
+
+  const char *unique_id = nullptr;
+  const char *friendly_name = nullptr;
+  const char *firmware_version = nullptr;
+  const char *room_id = nullptr;
+  const char *controller_id = nullptr;
+  const char *registration_room = nullptr;
+
+  State state = State::Idle;
+  int next_device = 0;
+  int device_index = 0;
+  unsigned long last_send = 0;
+  uint32_t gap_ms = 0;
+  uint32_t retry_ms = 0; // Current backoff; 0 until a registration fails
+  bool was_connected = false;
+
+  unsigned long started_at = 0;
+  unsigned long finished_at = 0;
+  uint32_t longest_step = 0;
+  uint32_t streamed_bytes = 0;
+  size_t controller_message = 0;
+  size_t largest_device_message = 0;
+};
+
+#endif // SENTIENT_MANIFEST_STREAM_H
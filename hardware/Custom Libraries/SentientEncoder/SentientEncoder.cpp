@@ -0,0 +1,251 @@
+#include "SentientEncoder.h"
+
+#if defined(__IMXRT1062__)
+#include <QuadEncoder.h>
+#endif
+
+namespace
+{
+constexpr int8_t kInvalid = 2;
+
+// (previous AB << 2) | current AB -> count change; A leading B counts up
+constexpr int8_t kTransitions[16] = {
+    0, -1, 1, kInvalid,  // from 00
+    1, 0, kInvalid, -1,  // from 01
+    -1, kInvalid, 0, 1,  // from 10
+    kInvalid, 1, -1, 0}; // from 11
+
+// Alpha-beta tracker gains for SENTIENT_ENCODER_SAMPLE_MS samples
+constexpr float kAlpha = 0.5f;
+constexpr float kBeta = 0.1f;
+constexpr float kAccelerationSmoothing = 0.2f;
+constexpr float kMaxSampleGap = 0.5f; // Seconds; a longer gap restarts the tracker
+
+SentientEncoder *s_software[SENTIENT_ENCODER_MAX_SOFTWARE] = {};
+uint8_t s_softwareCount = 0;
+
+#if defined(__IMXRT1062__)
+constexpr uint8_t kHardwareDecoders = 4; // ENC1..ENC4
+uint8_t s_hardwareCount = 0;
+#endif
+
+// attachInterrupt() takes no context: one thunk per software slot
+template <uint8_t Slot>
+void decodeThunk()
+{
+  s_software[Slot]->decode();
+}
+
+void (*const kThunks[])() = {decodeThunk<0>, decodeThunk<1>, decodeThunk<2>, decodeThunk<3>,
+                             decodeThunk<4>, decodeThunk<5>, decodeThunk<6>, decodeThunk<7>};
+
+static_assert(SENTIENT_ENCODER_MAX_SOFTWARE <= sizeof(kThunks) / sizeof(kThunks[0]),
+              "Add decode thunks for SENTIENT_ENCODER_MAX_SOFTWARE");
+}
+
+bool SentientEncoder::begin(const SentientEncoderConfig &config)
+{
+  if (config.pinA == 0xFF || config.pinB == 0xFF || config.pinA == config.pinB)
+  {
+    Serial.println(F("[SentientEncoder] Two distinct pins required"));
+    return false;
+  }
+  switch (config.countsPerCycle)
+  {
+  case 4:
+    _shift = 0;
+    break;
+  case 2:
+    _shift = 1;
+    break;
+  case 1:
+    _shift = 2;
+    break;
+  default:
+    Serial.println(F("[SentientEncoder] countsPerCycle must be 1, 2 or 4"));
+    return false;
+  }
+  _config = config;
+
+  Serial.print(F("[SentientEncoder] Pins "));
+  Serial.print(config.pinA);
+  Serial.print(F("/"));
+  Serial.print(config.pinB);
+
+#if defined(__IMXRT1062__)
+  if (config.allowHardware && xbarPin(config.pinA) && xbarPin(config.pinB) && s_hardwareCount < kHardwareDecoders)
+  {
+    _hardware = new QuadEncoder(++s_hardwareCount, config.pinA, config.pinB, config.pullup ? 1 : 0);
+    _hardware->setInitConfig();
+    _hardware->EncConfig.filterCount = 5;          // 6 matching samples...
+    _hardware->EncConfig.filterSamplePeriod = 255; // ...255 bus clocks apart (~10 us) reject contact bounce
+    _hardware->init();
+    Serial.print(F(": hardware decoder ENC"));
+    Serial.println(s_hardwareCount);
+    return true;
+  }
+#endif
+
+  if (s_softwareCount >= SENTIENT_ENCODER_MAX_SOFTWARE)
+  {
+    Serial.println(F(": no interrupt slot left; raise SENTIENT_ENCODER_MAX_SOFTWARE"));
+    return false;
+  }
+  pinMode(config.pinA, config.pullup ? INPUT_PULLUP : INPUT);
+  pinMode(config.pinB, config.pullup ? INPUT_PULLUP : INPUT);
+  bindPin(_a, config.pinA);
+  bindPin(_b, config.pinB);
+  _state = (readPin(_a) << 1) | readPin(_b);
+
+  const uint8_t slot = s_softwareCount++;
+  s_software[slot] = this;
+  attachInterrupt(digitalPinToInterrupt(config.pinA), kThunks[slot], CHANGE);
+  attachInterrupt(digitalPinToInterrupt(config.pinB), kThunks[slot], CHANGE);
+  Serial.println(F(": 4x decoding from pin interrupts"));
+  return true;
+}
+
+void SentientEncoder::decode()
+{
+  const uint8_t state = (readPin(_a) << 1) | readPin(_b);
+  const int8_t change = kTransitions[(_state << 2) | state];
+  if (change == kInvalid)
+  {
+    _invalid = _invalid + 1;
+  }
+  else
+  {
+    _count = _count + change;
+  }
+  _state = state;
+}
+
+void SentientEncoder::setPosition(long position)
+{
+  const int32_t raw = (int32_t)position * (1 << _shift);
+  if (_hardware)
+  {
+#if defined(__IMXRT1062__)
+    _hardware->write((uint32_t)raw);
+#endif
+  }
+  else
+  {
+    noInterrupts();
+    _count = raw;
+    interrupts();
+  }
+  _lastPosition = position;
+  _trackedPosition = position;
+  _velocity = 0.0f;
+  _acceleration = 0.0f;
+  _publishRequested = true;
+}
+
+void SentientEncoder::loop()
+{
+  const uint32_t nowUs = micros();
+  if (nowUs - _lastSampleUs < SENTIENT_ENCODER_SAMPLE_MS * 1000u)
+  {
+    return;
+  }
+  const float dt = (nowUs - _lastSampleUs) / 1e6f;
+  _lastSampleUs = nowUs;
+
+  const long current = position();
+  const uint32_t nowMs = millis();
+  if (current != _lastPosition)
+  {
+    _lastPosition = current;
+    _lastChangeMs = nowMs;
+  }
+  _moving = nowMs - _lastChangeMs < _config.idleMs;
+
+  if (!_moving || dt > kMaxSampleGap)
+  {
+    _trackedPosition = current;
+    _velocity = 0.0f;
+    _acceleration = 0.0f;
+    return;
+  }
+
+  // Predict, then correct by the residual against the measured count
+  const float predicted = _trackedPosition + _velocity * dt;
+  const float residual = current - predicted;
+  const float velocity = _velocity + kBeta * residual / dt;
+  _trackedPosition = predicted + kAlpha * residual;
+  _acceleration += kAccelerationSmoothing * ((velocity - _velocity) / dt - _acceleration);
+  _velocity = velocity;
+}
+
+bool SentientEncoder::publishDue()
+{
+  const uint32_t nowMs = millis();
+  const long current = position();
+
+  bool due;
+  if (_publishRequested)
+  {
+    due = true;
+  }
+  else if (current != _publishedPosition)
+  {
+    // Paced while turning; the final position goes out as soon as it settles
+    due = !_moving || nowMs - _lastPublishMs >= _config.movingPublishMs;
+  }
+  else
+  {
+    due = _config.idlePublishMs != 0 && nowMs - _lastPublishMs >= _config.idlePublishMs;
+  }
+
+  if (due)
+  {
+    _publishRequested = false;
+    _publishedPosition = current;
+    _lastPublishMs = nowMs;
+  }
+  return due;
+}
+
+int32_t SentientEncoder::rawCount() const
+{
+#if defined(__IMXRT1062__)
+  if (_hardware)
+  {
+    return _hardware->read();
+  }
+#endif
+  return _count;
+}
+
+bool SentientEncoder::xbarPin(uint8_t pin)
+{
+  // Teensy 4.1 pins with an XBAR input (QuadEncoder's pin table)
+  static const uint8_t kPins[] = {0, 1, 2, 3, 4, 5, 7, 8, 30, 31, 33, 36, 37};
+  for (uint8_t candidate : kPins)
+  {
+    if (candidate == pin)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+void SentientEncoder::bindPin(InputPin &port, uint8_t pin)
+{
+  port.pin = pin;
+#if defined(__IMXRT1062__)
+  port.input = portInputRegister(pin);
+  port.mask = digitalPinToBitMask(pin);
+#endif
+}
+
+bool SentientEncoder::readPin(const InputPin &port)
+{
+#if defined(__IMXRT1062__)
+  return (*port.input & port.mask) != 0;
+#else
+  return digitalRead(port.pin) == HIGH;
+#endif
+}
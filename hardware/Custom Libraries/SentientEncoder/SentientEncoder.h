@@ -0,0 +1,122 @@
+/*
+ * SentientEncoder.h
+ *
+ * Quadrature encoder input with motion estimates and adaptive telemetry.
+ *
+ * Decoding:
+ * - When both channels are on XBAR-capable pins, one of the i.MX RT1062's
+ *   four ENC quadrature decoders counts in hardware (QuadEncoder library),
+ *   with its glitch filter on. No CPU time is spent per edge.
+ * - Otherwise both channels interrupt on CHANGE and a 16-entry table turns
+ *   (previous state, new state) into -1, 0 or +1. Every edge counts (4x
+ *   decoding), both pins are read from the port register, and a skipped
+ *   state is counted as an error instead of guessing a direction.
+ *
+ * Counting is positive when channel A leads channel B (A rises while B is
+ * low). countsPerCycle scales the reported position: 4 reports every edge, 2
+ * matches the old RISING-edge handlers on both channels.
+ *
+ * loop() samples the count every SENTIENT_ENCODER_SAMPLE_MS and runs an
+ * alpha-beta tracker for velocity, plus a smoothed acceleration.
+ * publishDue() paces telemetry:
+ * - at most every movingPublishMs while the count changes;
+ * - once more when the encoder comes to rest, with the final position;
+ * - nothing while idle, unless idlePublishMs is set.
+ */
+
+#ifndef SENTIENT_ENCODER_H
+#define SENTIENT_ENCODER_H
+
+#include <Arduino.h>
+
+#ifndef SENTIENT_ENCODER_MAX_SOFTWARE
+#define SENTIENT_ENCODER_MAX_SOFTWARE 6 // Encoders decoded from pin interrupts
+#endif
+#ifndef SENTIENT_ENCODER_SAMPLE_MS
+#define SENTIENT_ENCODER_SAMPLE_MS 10 // Velocity/acceleration estimator period
+#endif
+
+struct SentientEncoderConfig
+{
+  uint8_t pinA = 0xFF;
+  uint8_t pinB = 0xFF;
+  bool pullup = true;
+  bool allowHardware = true;    // Use an ENC decoder when both pins reach XBAR
+  uint8_t countsPerCycle = 4;   // 4, 2 or 1 position counts per quadrature cycle
+  uint16_t movingPublishMs = 50; // Telemetry interval while the count changes
+  uint16_t idleMs = 250;        // No count for this long = at rest
+  uint32_t idlePublishMs = 0;   // Telemetry interval at rest (0 = silent)
+};
+
+class QuadEncoder;
+
+class SentientEncoder
+{
+public:
+  SentientEncoder() = default;
+  SentientEncoder(const SentientEncoder &) = delete;
+  SentientEncoder &operator=(const SentientEncoder &) = delete;
+
+  bool begin(const SentientEncoderConfig &config);
+  bool hardwareDecoded() const { return _hardware != nullptr; }
+
+  long position() const { return rawCount() >> _shift; }
+  void setPosition(long position);
+
+  // Call every loop(): updates the estimates and the rest detection
+  void loop();
+
+  float velocity() const { return _velocity; }         // Counts/s
+  float acceleration() const { return _acceleration; } // Counts/s^2
+  bool moving() const { return _moving; }
+
+  // True when telemetry should go out now; the position it reports is
+  // remembered for the next decision
+  bool publishDue();
+  void requestPublish() { _publishRequested = true; }
+
+  // Software decoding only: transitions where both channels changed at once
+  uint32_t invalidTransitions() const { return _invalid; }
+
+  // Pin-interrupt entry point (software decoding)
+  void decode();
+
+private:
+  struct InputPin
+  {
+#if defined(__IMXRT1062__)
+    volatile uint32_t *input;
+    uint32_t mask;
+#endif
+    uint8_t pin;
+  };
+
+  static bool xbarPin(uint8_t pin);
+  static void bindPin(InputPin &port, uint8_t pin);
+  static bool readPin(const InputPin &port);
+  int32_t rawCount() const;
+
+  SentientEncoderConfig _config;
+  uint8_t _shift = 0;
+
+  QuadEncoder *_hardware = nullptr;
+  InputPin _a = {};
+  InputPin _b = {};
+  volatile int32_t _count = 0;
+  volatile uint8_t _state = 0;
+  volatile uint32_t _invalid = 0;
+
+  uint32_t _lastSampleUs = 0;
+  long _lastPosition = 0;
+  uint32_t _lastChangeMs = 0;
+  float _trackedPosition = 0.0f;
+  float _velocity = 0.0f;
+  float _acceleration = 0.0f;
+  bool _moving = false;
+
+  long _publishedPosition = 0;
+  uint32_t _lastPublishMs = 0;
+  bool _publishRequested = true;
+};
+
+#endif // SENTIENT_ENCODER_H
@@ -0,0 +1,195 @@
+#include "SentientInputEvents.h"
+
+namespace
+{
+SentientInputEvents *s_instance = nullptr;
+
+// attachInterrupt() takes no context: one thunk per input slot
+template <uint8_t Slot>
+void edgeThunk()
+{
+  s_instance->record(Slot);
+}
+
+void (*const kThunks[])() = {edgeThunk<0>, edgeThunk<1>, edgeThunk<2>, edgeThunk<3>,
+                             edgeThunk<4>, edgeThunk<5>, edgeThunk<6>, edgeThunk<7>,
+                             edgeThunk<8>, edgeThunk<9>, edgeThunk<10>, edgeThunk<11>,
+                             edgeThunk<12>, edgeThunk<13>, edgeThunk<14>, edgeThunk<15>};
+
+static_assert(SENTIENT_EVENT_INPUTS <= sizeof(kThunks) / sizeof(kThunks[0]),
+              "Add edge thunks for SENTIENT_EVENT_INPUTS");
+}
+
+int SentientInputEvents::add(uint8_t pin, bool activeLow, uint8_t mode)
+{
+  if (_started)
+  {
+    Serial.println(F("[SentientInputEvents] Inputs must be added before begin()"));
+    return -1;
+  }
+  if (_inputCount >= SENTIENT_EVENT_INPUTS)
+  {
+    Serial.println(F("[SentientInputEvents] Too many inputs; raise SENTIENT_EVENT_INPUTS"));
+    return -1;
+  }
+  pinMode(pin, mode);
+
+  Input &input = _inputs[_inputCount];
+  input.pin = pin;
+  input.activeLow = activeLow;
+#if defined(__IMXRT1062__)
+  input.port = portInputRegister(pin);
+  input.mask = digitalPinToBitMask(pin);
+#endif
+  return _inputCount++;
+}
+
+bool SentientInputEvents::begin(uint16_t lockoutMs)
+{
+  if (_started || _inputCount == 0)
+  {
+    return false;
+  }
+  _lockoutUs = (uint32_t)lockoutMs * 1000;
+
+  const uint32_t now = micros();
+  for (uint8_t i = 0; i < _inputCount; i++)
+  {
+    _inputs[i].active = readActive(_inputs[i]);
+    _inputs[i].edgeUs = now - _lockoutUs;
+  }
+
+  s_instance = this;
+  _started = true;
+  for (uint8_t i = 0; i < _inputCount; i++)
+  {
+    attachInterrupt(digitalPinToInterrupt(_inputs[i].pin), kThunks[i], CHANGE);
+  }
+
+  Serial.print(F("[SentientInputEvents] "));
+  Serial.print(_inputCount);
+  Serial.print(F(" inputs, "));
+  Serial.print(SENTIENT_EVENT_QUEUE_SIZE);
+  Serial.println(F(" event ring"));
+  return true;
+}
+
+void SentientInputEvents::record(uint8_t slot)
+{
+  Input &input = _inputs[slot];
+  const uint32_t now = micros();
+  const bool active = readActive(input);
+  if (active == input.active || now - input.edgeUs < _lockoutUs)
+  {
+    return;
+  }
+  input.active = active;
+  input.edgeUs = now;
+  if (active)
+  {
+    input.pressedUs = now;
+    input.pressed = true;
+  }
+
+  // Single producer: fill the slot, then publish it by advancing the head
+  SentientInputEvent &event = _ring[_head & kMask];
+  event.micros = now;
+  event.input = slot;
+  event.active = active;
+  _head = _head + 1;
+}
+
+void SentientInputEvents::loop()
+{
+  for (uint8_t i = 0; i < _inputCount; i++)
+  {
+    // Cheap check first; record() re-reads the pin with the ISR held off
+    if (readActive(_inputs[i]) != _inputs[i].active)
+    {
+      noInterrupts();
+      record(i);
+      interrupts();
+    }
+  }
+}
+
+bool SentientInputEvents::pop(SentientInputEvent &event)
+{
+  while (true)
+  {
+    const uint32_t head = _head;
+    if (head - _tail > SENTIENT_EVENT_QUEUE_SIZE)
+    {
+      // The ISR lapped the reader: skip to the oldest entry still intact
+      _dropped += head - _tail - SENTIENT_EVENT_QUEUE_SIZE;
+      _tail = head - SENTIENT_EVENT_QUEUE_SIZE;
+    }
+    if (_tail == head)
+    {
+      return false;
+    }
+    event = _ring[_tail & kMask];
+
+    // Valid unless the ISR overwrote the entry while it was being copied
+    if (_head - _tail <= SENTIENT_EVENT_QUEUE_SIZE)
+    {
+      _tail++;
+      return true;
+    }
+  }
+}
+
+uint32_t SentientInputEvents::pending() const
+{
+  const uint32_t unread = _head - _tail;
+  return unread > SENTIENT_EVENT_QUEUE_SIZE ? SENTIENT_EVENT_QUEUE_SIZE : unread;
+}
+
+bool SentientInputEvents::pressedBetween(uint8_t input, uint32_t fromUs, uint32_t toUs) const
+{
+  const uint32_t head = _head;
+  const uint32_t depth = head < SENTIENT_EVENT_QUEUE_SIZE - kHistoryGuard ? head : SENTIENT_EVENT_QUEUE_SIZE - kHistoryGuard;
+  const uint32_t span = toUs - fromUs;
+
+  for (uint32_t n = 1; n <= depth; n++)
+  {
+    const SentientInputEvent &event = _ring[(head - n) & kMask];
+    const uint32_t offset = event.micros - fromUs; // Wraps past span when before fromUs
+    if (event.input == input && event.active && offset <= span)
+    {
+      return true;
+    }
+    // Newest first: once an event is older than the window, so is the rest
+    if ((int32_t)(event.micros - fromUs) < 0)
+    {
+      break;
+    }
+  }
+  return false;
+}
+
+bool SentientInputEvents::pressedTogether(uint8_t a, uint8_t b, uint32_t windowUs) const
+{
+  if (a >= _inputCount || b >= _inputCount)
+  {
+    return false;
+  }
+  noInterrupts();
+  const bool pressed = _inputs[a].pressed && _inputs[b].pressed;
+  const uint32_t atA = _inputs[a].pressedUs;
+  const uint32_t atB = _inputs[b].pressedUs;
+  interrupts();
+
+  const uint32_t apart = (int32_t)(atA - atB) < 0 ? atB - atA : atA - atB;
+  return pressed && apart <= windowUs;
+}
+
+bool SentientInputEvents::readActive(const Input &input) const
+{
+#if defined(__IMXRT1062__)
+  const bool high = (*input.port & input.mask) != 0;
+#else
+  const bool high = digitalRead(input.pin) == HIGH;
+#endif
+  return high != input.activeLow;
+}
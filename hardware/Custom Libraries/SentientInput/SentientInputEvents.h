@@ -0,0 +1,117 @@
+/*
+ * SentientInputEvents.h
+ *
+ * Timestamped input edges for puzzles that judge timing: rhythm (was the
+ * pad hit on the beat?) and simultaneity (were both keys pressed together?).
+ *
+ * Every registered pin interrupts on CHANGE. The handler stamps the edge with
+ * micros() and pushes (input, level, time) into a ring buffer, so the time
+ * of a press is the moment it happened, however busy loop() was. The ring is
+ * single-producer/single-consumer and lock-free: the ISR only advances the
+ * head, pop() only advances the tail, and both are free-running counters, so
+ * a full ring is detected and counted rather than corrupted.
+ *
+ * Contact bounce: after an accepted edge an input ignores further edges for
+ * lockoutMs, and an edge that does not change the level is dropped. loop()
+ * picks up a level that settled inside the lockout (a very short tap), so
+ * the reported level always follows the pin.
+ *
+ * Popped events stay in the ring until they are overwritten, and the window
+ * queries search that history, newest first:
+ * - pressedBetween() / pressedNear(): was the input pressed in a time window,
+ *   e.g. +-100 ms around a beat;
+ * - pressedTogether(): were the latest presses of two inputs within a window.
+ *
+ * Off-target builds (host simulation): call record() to simulate an edge.
+ */
+
+#ifndef SENTIENT_INPUT_EVENTS_H
+#define SENTIENT_INPUT_EVENTS_H
+
+#include <Arduino.h>
+
+#ifndef SENTIENT_EVENT_INPUTS
+#define SENTIENT_EVENT_INPUTS 12 // Interrupt-driven inputs per controller
+#endif
+#ifndef SENTIENT_EVENT_QUEUE_SIZE
+#define SENTIENT_EVENT_QUEUE_SIZE 64 // Ring entries (power of two); also the query history
+#endif
+
+static_assert((SENTIENT_EVENT_QUEUE_SIZE & (SENTIENT_EVENT_QUEUE_SIZE - 1)) == 0,
+              "SENTIENT_EVENT_QUEUE_SIZE must be a power of two");
+
+struct SentientInputEvent
+{
+  uint32_t micros; // When the edge happened
+  uint8_t input;   // Index returned by add()
+  bool active;     // New level: true = pressed
+};
+
+class SentientInputEvents
+{
+public:
+  SentientInputEvents() = default;
+  SentientInputEvents(const SentientInputEvents &) = delete;
+  SentientInputEvents &operator=(const SentientInputEvents &) = delete;
+
+  // Register a pin before begin(); returns its input index or -1
+  int add(uint8_t pin, bool activeLow = true, uint8_t mode = INPUT_PULLUP);
+  bool begin(uint16_t lockoutMs = 5);
+
+  // Call every loop(): catches levels that settled inside the lockout
+  void loop();
+
+  // Oldest unread event; false when there is none
+  bool pop(SentientInputEvent &event);
+  uint32_t pending() const;
+  uint32_t dropped() const { return _dropped; } // Events overwritten before pop()
+
+  bool active(uint8_t input) const { return input < _inputCount && _inputs[input].active; }
+  uint32_t lastPressMicros(uint8_t input) const { return input < _inputCount ? _inputs[input].pressedUs : 0; }
+
+  // Window queries over the retained history (times in micros())
+  bool pressedBetween(uint8_t input, uint32_t fromUs, uint32_t toUs) const;
+  bool pressedNear(uint8_t input, uint32_t atUs, uint32_t windowUs) const
+  {
+    return pressedBetween(input, atUs - windowUs, atUs + windowUs);
+  }
+  // True when both inputs have been pressed and their latest presses are
+  // at most windowUs apart
+  bool pressedTogether(uint8_t a, uint8_t b, uint32_t windowUs) const;
+
+  // Pin-interrupt entry point: sample the input and queue an edge
+  void record(uint8_t input);
+
+private:
+  struct Input
+  {
+#if defined(__IMXRT1062__)
+    volatile uint32_t *port;
+    uint32_t mask;
+#endif
+    uint8_t pin;
+    bool activeLow;
+    volatile bool active;
+    volatile bool pressed; // Seen at least one press
+    volatile uint32_t edgeUs;
+    volatile uint32_t pressedUs;
+  };
+
+  static constexpr uint32_t kMask = SENTIENT_EVENT_QUEUE_SIZE - 1;
+  // Entries this close to being overwritten are not trusted by the queries
+  static constexpr uint32_t kHistoryGuard = 4;
+
+  bool readActive(const Input &input) const;
+
+  Input _inputs[SENTIENT_EVENT_INPUTS] = {};
+  uint8_t _inputCount = 0;
+  uint32_t _lockoutUs = 0;
+  bool _started = false;
+
+  SentientInputEvent _ring[SENTIENT_EVENT_QUEUE_SIZE] = {};
+  volatile uint32_t _head = 0; // Events ever pushed (ISR)
+  uint32_t _tail = 0;          // Events ever popped (loop)
+  uint32_t _dropped = 0;
+};
+
+#endif // SENTIENT_INPUT_EVENTS_H
@@ -0,0 +1,196 @@
+#include "SentientInputs.h"
+
+#if defined(__IMXRT1062__)
+SentientInputs *SentientInputs::s_activeInstance = nullptr;
+
+void SentientInputs::timerThunk()
+{
+  if (s_activeInstance)
+  {
+    s_activeInstance->sample();
+  }
+}
+#endif
+
+int SentientInputs::add(uint8_t pin, bool activeLow, uint8_t mode)
+{
+  if (_tickUs)
+  {
+    Serial.println(F("[SentientInputs] Inputs must be added before begin()"));
+    return -1;
+  }
+  if (_inputCount >= SENTIENT_INPUT_MAX)
+  {
+    Serial.println(F("[SentientInputs] Too many inputs; raise SENTIENT_INPUT_MAX"));
+    return -1;
+  }
+
+  bool duplicate = false;
+#if defined(__IMXRT1062__)
+  volatile uint32_t *input = portInputRegister(pin);
+  const uint32_t mask = digitalPinToBitMask(pin);
+  uint8_t port = 0;
+  while (port < _portCount && _ports[port].input != input)
+  {
+    port++;
+  }
+  if (port == _portCount)
+  {
+    if (_portCount >= SENTIENT_INPUT_PORTS)
+    {
+      Serial.println(F("[SentientInputs] Too many GPIO ports; raise SENTIENT_INPUT_PORTS"));
+      return -1;
+    }
+    _ports[_portCount++].input = input;
+  }
+  duplicate = _ports[port].used & mask;
+#else
+  // Host builds: one virtual port, bit n is input n
+  const uint8_t port = 0;
+  const uint32_t mask = 1ul << _inputCount;
+  for (uint8_t i = 0; i < _inputCount; i++)
+  {
+    duplicate = duplicate || _pins[i] == pin;
+  }
+#endif
+
+  if (duplicate)
+  {
+    Serial.print(F("[SentientInputs] Pin "));
+    Serial.print(pin);
+    Serial.println(F(" added twice"));
+    return -1;
+  }
+#if !defined(__IMXRT1062__)
+  _portCount = 1;
+  _pins[_inputCount] = pin;
+#endif
+  pinMode(pin, mode);
+  Port &p = _ports[port];
+  p.used |= mask;
+  if (activeLow)
+  {
+    p.invert |= mask;
+  }
+
+  const uint8_t index = _inputCount++;
+  _bitInput[port][__builtin_ctz(mask)] = index + 1;
+  return index;
+}
+
+bool SentientInputs::begin(uint16_t debounceMs)
+{
+  if (_tickUs || _inputCount == 0)
+  {
+    return false;
+  }
+  // Four agreeing ticks make a change; 250 us keeps the ISR load negligible
+  _tickUs = (uint32_t)debounceMs * 1000 / 4;
+  if (_tickUs < 250)
+  {
+    _tickUs = 250;
+  }
+
+  // Start from the pins as they are, without waiting out a debounce
+  for (uint8_t i = 0; i < _portCount; i++)
+  {
+    Port &port = _ports[i];
+    port.state = read(port);
+    port.count0 = 0xFFFFFFFFu;
+    port.count1 = 0xFFFFFFFFu;
+    port.pending = 0;
+  }
+  _reportAll = true;
+
+#if defined(__IMXRT1062__)
+  s_activeInstance = this;
+  _timer.begin(timerThunk, _tickUs);
+#endif
+
+  Serial.print(F("[SentientInputs] "));
+  Serial.print(_inputCount);
+  Serial.print(F(" inputs on "));
+  Serial.print(_portCount);
+  Serial.print(F(" ports, "));
+  Serial.print(_tickUs * 4 / 1000.0f, 1);
+  Serial.println(F(" ms debounce"));
+  return true;
+}
+
+void SentientInputs::sample()
+{
+  for (uint8_t i = 0; i < _portCount; i++)
+  {
+    Port &port = _ports[i];
+
+    // Each bit that disagrees with its debounced state counts down from 3;
+    // a bit that agrees resets its counter. Reaching 0 toggles the state.
+    const uint32_t delta = read(port) ^ port.state;
+    port.count0 = ~(port.count0 & delta);
+    port.count1 = port.count0 ^ (port.count1 & delta);
+    const uint32_t toggle = delta & port.count0 & port.count1;
+    port.state ^= toggle;
+    port.pending = port.pending | toggle;
+  }
+}
+
+uint32_t SentientInputs::update()
+{
+  uint32_t pending[SENTIENT_INPUT_PORTS];
+  uint32_t state[SENTIENT_INPUT_PORTS];
+
+  noInterrupts();
+  for (uint8_t i = 0; i < _portCount; i++)
+  {
+    pending[i] = _ports[i].pending;
+    state[i] = _ports[i].state;
+    _ports[i].pending = 0;
+  }
+  interrupts();
+
+  // Only the ports' changed bits are visited, so a quiet scan costs nothing
+  uint32_t changed = 0;
+  for (uint8_t i = 0; i < _portCount; i++)
+  {
+    uint32_t bits = _reportAll ? _ports[i].used : pending[i];
+    while (bits)
+    {
+      const uint8_t b = __builtin_ctz(bits);
+      bits &= bits - 1;
+      const uint8_t slot = _bitInput[i][b];
+      if (slot == 0)
+      {
+        continue;
+      }
+      const uint32_t mask = bit(slot - 1);
+      const uint32_t now = (state[i] >> b) & 1 ? mask : 0;
+
+      // A press and release between two calls leaves the state where it was
+      if (_reportAll || (_state & mask) != now)
+      {
+        changed |= mask;
+        _state = (_state & ~mask) | now;
+      }
+    }
+  }
+  _reportAll = false;
+  _changed = changed;
+  return changed;
+}
+
+uint32_t SentientInputs::read(const Port &port) const
+{
+#if defined(__IMXRT1062__)
+  return (*port.input ^ port.invert) & port.used;
+#else
+  uint32_t level = 0;
+  for (uint8_t i = 0; i < _inputCount; i++)
+  {
+    if (digitalRead(_pins[i]) == HIGH)
+    {
+      level |= 1ul << i;
+    }
+  }
+  return (level ^ port.invert) & port.used;
+#endif
+}
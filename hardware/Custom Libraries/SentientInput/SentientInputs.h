@@ -0,0 +1,119 @@
+/*
+ * SentientInputs.h
+ *
+ * Debounced digital inputs, sampled a whole GPIO port at a time.
+ *
+ * On Teensy 4.1 every pin is a bit in one of four fast GPIO ports
+ * (GPIO6..GPIO9). A timer interrupt reads each port that has a registered
+ * input once per tick, so a scan costs at most four register reads however
+ * many pins are in use. Debouncing runs on whole ports at once: every bit
+ * has a two-bit vertical counter (two 32-bit words per port), and a bit only
+ * changes state after four consecutive ticks that disagree with it. A
+ * contact glitch shorter than that never reaches the debounced state and
+ * never produces a change.
+ *
+ * Changes are collected as a mask until update() hands them to the sketch,
+ * mapped to input indices (bit n = the n-th input added), so a slow loop()
+ * pass still sees every input that ended up in a new state. (A press and
+ * release that both complete within one pass cancel out.) The first update()
+ * after begin() reports every input as changed, which makes a sketch publish
+ * its initial states through the same code path as every later change.
+ *
+ * USAGE:
+ *   SentientInputs inputs;
+ *   const int door = inputs.add(PIN_DOOR);       // INPUT_PULLUP, active LOW
+ *   inputs.begin(10);                            // 10 ms debounce
+ *   ...
+ *   const uint32_t changed = inputs.update();    // Once per loop()
+ *   if (changed & inputs.bit(door)) publish(inputs.active(door));
+ *
+ * Off-target builds (host simulation) have no timer and read pins with
+ * digitalRead(): call sample() directly to advance one tick.
+ */
+
+#ifndef SENTIENT_INPUTS_H
+#define SENTIENT_INPUTS_H
+
+#include <Arduino.h>
+
+#if defined(__IMXRT1062__)
+#include <IntervalTimer.h>
+#endif
+
+#ifndef SENTIENT_INPUT_MAX
+#define SENTIENT_INPUT_MAX 32 // Inputs per engine (one bit each in the change mask)
+#endif
+#ifndef SENTIENT_INPUT_PORTS
+#define SENTIENT_INPUT_PORTS 4 // Distinct GPIO ports sampled per tick
+#endif
+
+static_assert(SENTIENT_INPUT_MAX <= 32, "Input masks are 32 bits wide");
+
+class SentientInputs
+{
+public:
+  SentientInputs() = default;
+  SentientInputs(const SentientInputs &) = delete;
+  SentientInputs &operator=(const SentientInputs &) = delete;
+
+  // Register a pin before begin(); returns its input index or -1.
+  // activeLow suits switches to ground on INPUT_PULLUP.
+  int add(uint8_t pin, bool activeLow = true, uint8_t mode = INPUT_PULLUP);
+
+  // Take the first sample and start the timer. A state change needs four
+  // consecutive agreeing ticks, so the tick is a quarter of debounceMs.
+  bool begin(uint16_t debounceMs = 8);
+
+  // Changes since the previous call (bit n = input n); call once per loop()
+  uint32_t update();
+  uint32_t changed() const { return _changed; } // The mask update() last returned
+
+  uint32_t state() const { return _state; } // Debounced, bit set = active
+  bool active(uint8_t input) const { return _state & bit(input); }
+  uint32_t pressed() const { return _changed & _state; }   // Became active at the last update()
+  uint32_t released() const { return _changed & ~_state; } // Became inactive at the last update()
+
+  static uint32_t bit(uint8_t input) { return 1ul << input; }
+  uint8_t count() const { return _inputCount; }
+  uint32_t tickMicros() const { return _tickUs; }
+
+  // One debounce tick: read the ports, advance the counters, collect
+  // changes. Runs from the timer ISR on target; host simulations call it.
+  void sample();
+
+private:
+  struct Port
+  {
+#if defined(__IMXRT1062__)
+    volatile uint32_t *input;
+#endif
+    uint32_t used;   // Bits with a registered input
+    uint32_t invert; // Bits whose input is active LOW
+    uint32_t state;  // Debounced, 1 = active
+    uint32_t count0; // Vertical counter, low bit
+    uint32_t count1; // Vertical counter, high bit
+    volatile uint32_t pending; // Debounced changes not yet collected by update()
+  };
+
+  uint32_t read(const Port &port) const;
+
+  Port _ports[SENTIENT_INPUT_PORTS] = {};
+  uint8_t _portCount = 0;
+  uint8_t _bitInput[SENTIENT_INPUT_PORTS][32] = {}; // Input index + 1 per port bit, 0 = unused
+  uint8_t _inputCount = 0;
+  uint32_t _tickUs = 0;
+
+  uint32_t _state = 0;
+  uint32_t _changed = 0;
+  bool _reportAll = false;
+
+#if defined(__IMXRT1062__)
+  IntervalTimer _timer;
+  static SentientInputs *s_activeInstance;
+  static void timerThunk();
+#else
+  uint8_t _pins[SENTIENT_INPUT_MAX] = {};
+#endif
+};
+
+#endif // SENTIENT_INPUTS_H
@@ -0,0 +1,150 @@
+#include "SentientLedBus.h"
+
+namespace
+{
+// FastLED's scale8: 255 leaves the channel untouched
+inline uint8_t scale(uint8_t channel, uint8_t brightness)
+{
+  return (uint8_t)(((uint16_t)channel * (brightness + 1)) >> 8);
+}
+}
+
+SentientLedBus::SentientLedBus(uint16_t ledsPerStrip, uint8_t config)
+    : _ledsPerStrip(ledsPerStrip), _config(config)
+{
+}
+
+int SentientLedBus::addStrip(uint8_t pin, CRGB *leds, uint16_t count)
+{
+  if (_driver)
+  {
+    Serial.println(F("[SentientLED] Strips must be added before begin()"));
+    return -1;
+  }
+  if (_stripCount >= SENTIENT_LED_MAX_STRIPS)
+  {
+    Serial.println(F("[SentientLED] Too many strips; raise SENTIENT_LED_MAX_STRIPS"));
+    return -1;
+  }
+  if (!leds || count == 0 || count > _ledsPerStrip)
+  {
+    Serial.print(F("[SentientLED] Strip on pin "));
+    Serial.print(pin);
+    Serial.println(F(" needs 1..ledsPerStrip LEDs"));
+    return -1;
+  }
+  _pins[_stripCount] = pin;
+  _strips[_stripCount] = {leds, count, 255};
+  return _stripCount++;
+}
+
+bool SentientLedBus::begin(void *frameBuffer, size_t frameBytes)
+{
+  if (_driver || _stripCount == 0)
+  {
+    return false;
+  }
+  const size_t needed = SENTIENT_LED_FRAME_BYTES(_stripCount, _ledsPerStrip);
+  if (!frameBuffer || frameBytes < needed)
+  {
+    Serial.print(F("[SentientLED] Frame buffer needs "));
+    Serial.print(needed);
+    Serial.println(F(" bytes"));
+    return false;
+  }
+
+  // Padding past each strip's last LED stays black for good
+  memset(frameBuffer, 0, needed);
+
+  // No OctoWS2811 draw buffer: the sketch's CRGB arrays play that part
+  _driver = new OctoWS2811(_ledsPerStrip, frameBuffer, nullptr, _config, _stripCount, _pins);
+  _driver->begin();
+
+  Serial.print(F("[SentientLED] "));
+  Serial.print(_stripCount);
+  Serial.print(F(" strips x "));
+  Serial.print(_ledsPerStrip);
+  Serial.print(F(" LEDs in parallel, "));
+  Serial.print(frameMicros());
+  Serial.println(F(" us per frame"));
+  return true;
+}
+
+void SentientLedBus::setBrightness(uint8_t brightness)
+{
+  for (uint8_t i = 0; i < _stripCount; i++)
+  {
+    _strips[i].brightness = brightness;
+  }
+  _stale = 0xFFFFFFFFUL;
+}
+
+void SentientLedBus::setBrightness(uint8_t strip, uint8_t brightness)
+{
+  if (strip < _stripCount)
+  {
+    _strips[strip].brightness = brightness;
+    _stale |= 1UL << strip;
+  }
+}
+
+bool SentientLedBus::busy() const
+{
+  return _driver && _driver->busy();
+}
+
+void SentientLedBus::show()
+{
+  show(0xFFFFFFFFUL);
+}
+
+void SentientLedBus::show(uint32_t stripMask)
+{
+  if (!_driver)
+  {
+    return;
+  }
+  const uint32_t start = micros();
+
+  // DMA reads the frame buffer until the previous frame is out
+  if (_driver->busy())
+  {
+    ++_waits;
+    while (_driver->busy())
+    {
+    }
+  }
+
+  // Strips left out keep their pixels in the frame buffer
+  stripMask |= _stale;
+  _stale = 0;
+  for (uint8_t s = 0; s < _stripCount; s++)
+  {
+    if (!(stripMask & (1UL << s)))
+    {
+      continue;
+    }
+    const Strip &strip = _strips[s];
+    const uint32_t base = (uint32_t)s * _ledsPerStrip;
+    if (strip.brightness == 255)
+    {
+      for (uint16_t i = 0; i < strip.count; i++)
+      {
+        const CRGB &led = strip.leds[i];
+        _driver->setPixel(base + i, led.r, led.g, led.b);
+      }
+    }
+    else
+    {
+      for (uint16_t i = 0; i < strip.count; i++)
+      {
+        const CRGB &led = strip.leds[i];
+        _driver->setPixel(base + i, scale(led.r, strip.brightness), scale(led.g, strip.brightness),
+                          scale(led.b, strip.brightness));
+      }
+    }
+  }
+
+  _driver->show();
+  _lastShowMicros = micros() - start;
+}
@@ -0,0 +1,104 @@
+/*
+ * SentientLedBus.h
+ *
+ * Parallel WS2812/WS2811 output for every strip on a controller.
+ *
+ * FastLED.show() and Adafruit_NeoPixel::show() bit-bang one strip after
+ * another with interrupts off, so a frame costs 30 us per LED per strip
+ * (about 9 ms for a 300 LED strip, times the number of strips). This class
+ * hands all strips to OctoWS2811, which clocks every data pin at once from
+ * DMA, so a frame takes as long as the longest strip, whatever the strip count.
+ *
+ * Frames are double buffered:
+ * - The sketch keeps drawing into its own CRGB arrays (the draw buffers).
+ * - show() scales them by the strip brightness into the frame buffer and
+ *   starts the transfer. It then returns without waiting for the wire.
+ * - show() only waits if the previous frame is still going out.
+ *
+ * Strips that should look the same can share one draw buffer: add it once
+ * per pin.
+ *
+ * All strips share one length (ledsPerStrip). A shorter strip is padded with
+ * black, which costs nothing on the wire since the pins run in parallel.
+ *
+ * USAGE:
+ *   DMAMEM uint8_t frame[SENTIENT_LED_FRAME_BYTES(2, 60)];
+ *   SentientLedBus ledBus(60);
+ *   ledBus.addStrip(3, ledsA, 60);
+ *   ledBus.addStrip(4, ledsB, 60);
+ *   ledBus.begin(frame, sizeof(frame));
+ *   ...
+ *   ledBus.show();
+ */
+
+#ifndef SENTIENT_LED_BUS_H
+#define SENTIENT_LED_BUS_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include <OctoWS2811.h>
+
+#ifndef SENTIENT_LED_MAX_STRIPS
+#define SENTIENT_LED_MAX_STRIPS 32 // Data pins driven by one bus
+#endif
+
+// Frame buffer size for begin(): 3 bytes per LED, every strip padded to ledsPerStrip
+#define SENTIENT_LED_FRAME_BYTES(strips, ledsPerStrip) ((size_t)(strips) * (ledsPerStrip) * 3)
+
+class SentientLedBus
+{
+public:
+  // config is an OctoWS2811 colour order and speed
+  explicit SentientLedBus(uint16_t ledsPerStrip, uint8_t config = WS2811_GRB | WS2811_800kHz);
+  SentientLedBus(const SentientLedBus &) = delete;
+  SentientLedBus &operator=(const SentientLedBus &) = delete;
+
+  // Register a strip before begin(); leds is its draw buffer (count <= ledsPerStrip).
+  // Returns the strip index or -1.
+  int addStrip(uint8_t pin, CRGB *leds, uint16_t count);
+
+  // Start the DMA engine. frameBuffer holds SENTIENT_LED_FRAME_BYTES(strips, ledsPerStrip)
+  // bytes and should be DMAMEM so the transfer stays off the tightly coupled RAM.
+  bool begin(void *frameBuffer, size_t frameBytes);
+
+  void setBrightness(uint8_t brightness); // Every strip
+  void setBrightness(uint8_t strip, uint8_t brightness);
+  uint8_t getBrightness(uint8_t strip) const { return strip < _stripCount ? _strips[strip].brightness : 0; }
+
+  // Latch the draw buffers and start sending them; the buffers may be redrawn
+  // as soon as this returns
+  void show();
+  // Latch only the strips in stripMask (bit n = strip n), plus any whose
+  // brightness changed; the others go out with the pixels they last had
+  void show(uint32_t stripMask);
+  bool busy() const;
+
+  uint8_t stripCount() const { return _stripCount; }
+  uint16_t ledsPerStrip() const { return _ledsPerStrip; }
+  uint32_t frameMicros() const { return (uint32_t)_ledsPerStrip * 30 + 300; } // Wire time, 800 kHz plus latch
+
+  // Measurements for the most recent show() calls
+  uint32_t lastShowMicros() const { return _lastShowMicros; }
+  uint32_t waits() const { return _waits; } // show() calls that found the previous frame still going out
+
+private:
+  struct Strip
+  {
+    CRGB *leds;
+    uint16_t count;
+    uint8_t brightness;
+  };
+
+  uint16_t _ledsPerStrip;
+  uint8_t _config;
+  Strip _strips[SENTIENT_LED_MAX_STRIPS] = {};
+  uint8_t _pins[SENTIENT_LED_MAX_STRIPS] = {};
+  uint8_t _stripCount = 0;
+  uint32_t _stale = 0; // Strips whose brightness changed since they were latched
+  OctoWS2811 *_driver = nullptr;
+
+  uint32_t _lastShowMicros = 0;
+  uint32_t _waits = 0;
+};
+
+#endif // SENTIENT_LED_BUS_H
@@ -0,0 +1,535 @@
+#include "SentientLedEffects.h"
+#include "SentientLedKernels.h"
+
+namespace
+{
+constexpr SentientLedEffect kEffects[] = {SentientLedEffect::Manual, SentientLedEffect::Off,
+                                          SentientLedEffect::Solid, SentientLedEffect::Fire,
+                                          SentientLedEffect::Flicker, SentientLedEffect::Pulse,
+                                          SentientLedEffect::Chase};
+
+uint8_t hexDigit(char c)
+{
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return 0xFF;
+}
+
+bool parseHex(const char *text, uint32_t &value)
+{
+  value = 0;
+  uint8_t digits = 0;
+  for (; *text; ++text, ++digits)
+  {
+    const uint8_t digit = hexDigit(*text);
+    if (digit == 0xFF || digits == 6)
+    {
+      return false;
+    }
+    value = (value << 4) | digit;
+  }
+  return digits == 6;
+}
+
+CRGB scaled(CRGB color, uint8_t level)
+{
+  color.nscale8(level);
+  return color;
+}
+
+uint32_t packed(const CRGB &color)
+{
+  return SentientLedKernels::pack(color.r, color.g, color.b);
+}
+
+uint8_t readByte(JsonVariantConst value, uint8_t fallback)
+{
+  return value.is<int>() ? (uint8_t)constrain(value.as<int>(), 0, 255) : fallback;
+}
+}
+
+SentientLedEffects::SentientLedEffects(uint8_t framesPerSecond)
+{
+  setFrameRate(framesPerSecond);
+}
+
+int SentientLedEffects::addSegment(CRGB *leds, uint16_t count, uint8_t *fireState)
+{
+  if (_segmentCount >= SENTIENT_LED_MAX_SEGMENTS)
+  {
+    Serial.println(F("[SentientLedEffects] Too many segments; raise SENTIENT_LED_MAX_SEGMENTS"));
+    return -1;
+  }
+  if (!leds || count == 0)
+  {
+    return -1;
+  }
+  Segment &segment = _segments[_segmentCount];
+  segment = {};
+  segment.leds = leds;
+  segment.count = count;
+  segment.fireState = fireState;
+  segment.dirty = true; // Whatever the buffer holds goes out with the first frame
+  return _segmentCount++;
+}
+
+bool SentientLedEffects::mirrorTo(uint8_t segment, CLEDController &controller)
+{
+  if (segment >= _segmentCount || _outputCount >= SENTIENT_LED_MAX_OUTPUTS)
+  {
+    Serial.println(F("[SentientLedEffects] Cannot add output; check the segment or raise SENTIENT_LED_MAX_OUTPUTS"));
+    return false;
+  }
+  _outputs[_outputCount++] = {&controller, segment, 0};
+  return true;
+}
+
+bool SentientLedEffects::mirrorTo(uint8_t segment, SentientLedBus &bus, uint8_t strip)
+{
+  if (segment >= _segmentCount || _outputCount >= SENTIENT_LED_MAX_OUTPUTS || strip >= bus.stripCount() ||
+      (_bus && _bus != &bus))
+  {
+    Serial.println(F("[SentientLedEffects] Cannot add bus strip; one bus per engine, strips added to the bus first"));
+    return false;
+  }
+  _bus = &bus;
+  _outputs[_outputCount++] = {nullptr, segment, strip};
+  return true;
+}
+
+void SentientLedEffects::setFrameRate(uint8_t framesPerSecond)
+{
+  _frameMicros = 1000000UL / (framesPerSecond ? framesPerSecond : 1);
+}
+
+void SentientLedEffects::put(Segment &segment, uint16_t index, const CRGB &color)
+{
+  CRGB &led = segment.leds[index];
+  if (led != color)
+  {
+    led = color;
+    segment.dirty = true;
+  }
+}
+
+void SentientLedEffects::fillSegment(Segment &segment, const CRGB &color)
+{
+  if (SentientLedKernels::fill(segment.leds[0].raw, segment.count, packed(color)))
+  {
+    segment.dirty = true;
+  }
+}
+
+bool SentientLedEffects::setEffect(uint8_t segment, const SentientLedEffectParams &params)
+{
+  if (segment >= _segmentCount)
+  {
+    return false;
+  }
+  Segment &s = _segments[segment];
+  if (params.effect == SentientLedEffect::Fire && !s.fireState)
+  {
+    Serial.println(F("[SentientLedEffects] Fire needs a segment with fire state"));
+    return false;
+  }
+
+  s.params = params;
+  s.params.periodMs = params.periodMs < 10 ? 10 : params.periodMs;
+  s.params.variation = constrain(params.variation, 1, 127);
+  s.startedMs = millis();
+  s.nextBurstMs = s.startedMs;
+  s.bursting = false;
+
+  switch (s.params.effect)
+  {
+  case SentientLedEffect::Off:
+    fillSegment(s, CRGB::Black);
+    break;
+  case SentientLedEffect::Solid:
+    fillSegment(s, scaled(s.params.color, s.params.level));
+    break;
+  case SentientLedEffect::Fire:
+  {
+    int8_t *flame = reinterpret_cast<int8_t *>(s.fireState + s.count);
+    for (uint16_t i = 0; i < s.count; i++)
+    {
+      s.fireState[i] = 100;
+      flame[i] = (int8_t)(random8(0, 2 * s.params.variation + 1) - s.params.variation);
+    }
+    break;
+  }
+  case SentientLedEffect::Flicker:
+    fillSegment(s, s.params.background);
+    break;
+  default:
+    break;
+  }
+  return true;
+}
+
+bool SentientLedEffects::fill(uint8_t segment, CRGB color)
+{
+  SentientLedEffectParams params;
+  params.effect = SentientLedEffect::Solid;
+  params.color = color;
+  return setEffect(segment, params);
+}
+
+bool SentientLedEffects::off(uint8_t segment)
+{
+  SentientLedEffectParams params;
+  params.effect = SentientLedEffect::Off;
+  return setEffect(segment, params);
+}
+
+const char *SentientLedEffects::effectName(SentientLedEffect effect)
+{
+  switch (effect)
+  {
+  case SentientLedEffect::Manual:
+    return "manual";
+  case SentientLedEffect::Off:
+    return "off";
+  case SentientLedEffect::Solid:
+    return "solid";
+  case SentientLedEffect::Fire:
+    return "fire";
+  case SentientLedEffect::Flicker:
+    return "flicker";
+  case SentientLedEffect::Pulse:
+    return "pulse";
+  case SentientLedEffect::Chase:
+    return "chase";
+  }
+  return "unknown";
+}
+
+bool SentientLedEffects::parseColor(JsonVariantConst value, CRGB &color)
+{
+  if (value.is<JsonArrayConst>())
+  {
+    JsonArrayConst rgb = value.as<JsonArrayConst>();
+    if (rgb.size() != 3)
+    {
+      return false;
+    }
+    color = CRGB(readByte(rgb[0], 0), readByte(rgb[1], 0), readByte(rgb[2], 0));
+    return true;
+  }
+  if (value.is<uint32_t>())
+  {
+    color = CRGB(value.as<uint32_t>() & 0xFFFFFF);
+    return true;
+  }
+  const char *text = value.as<const char *>();
+  if (!text)
+  {
+    return false;
+  }
+
+  uint32_t rgb;
+  if (parseHex(text[0] == '#' ? text + 1 : text, rgb))
+  {
+    color = CRGB(rgb);
+    return true;
+  }
+
+  static const struct
+  {
+    const char *name;
+    uint32_t rgb;
+  } names[] = {{"black", 0x000000}, {"off", 0x000000},  {"white", 0xFFFFFF},  {"red", 0xFF0000},
+               {"green", 0x008000}, {"blue", 0x0000FF}, {"yellow", 0xFFFF00}, {"orange", 0xFFA500},
+               {"purple", 0x800080}};
+  for (const auto &entry : names)
+  {
+    if (strcasecmp(text, entry.name) == 0)
+    {
+      color = CRGB(entry.rgb);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool SentientLedEffects::configure(uint8_t segment, JsonVariantConst payload)
+{
+  if (segment >= _segmentCount)
+  {
+    return false;
+  }
+  SentientLedEffectParams params = _segments[segment].params;
+
+  const char *name = payload["effect"];
+  if (name)
+  {
+    bool known = false;
+    for (SentientLedEffect effect : kEffects)
+    {
+      if (strcasecmp(name, effectName(effect)) == 0)
+      {
+        params.effect = effect;
+        known = true;
+        break;
+      }
+    }
+    if (!known)
+    {
+      return false;
+    }
+  }
+
+  // A single colour sets both flicker colours unless color2 is given
+  if (!payload["color"].isNull())
+  {
+    if (!parseColor(payload["color"], params.color))
+    {
+      return false;
+    }
+    params.color2 = params.color;
+  }
+  if (!payload["color2"].isNull() && !parseColor(payload["color2"], params.color2))
+  {
+    return false;
+  }
+  if (!payload["background"].isNull() && !parseColor(payload["background"], params.background))
+  {
+    return false;
+  }
+
+  if (payload["period_ms"].is<int>())
+  {
+    params.periodMs = (uint16_t)constrain(payload["period_ms"].as<int>(), 10, 60000);
+  }
+  params.level = readByte(payload["level"], params.level);
+  params.width = readByte(payload["width"], params.width);
+  params.spacing = readByte(payload["spacing"], params.spacing);
+  params.variation = readByte(payload["variation"], params.variation);
+
+  return setEffect(segment, params);
+}
+
+const SentientLedEffectParams &SentientLedEffects::params(uint8_t segment) const
+{
+  static const SentientLedEffectParams none;
+  return segment < _segmentCount ? _segments[segment].params : none;
+}
+
+bool SentientLedEffects::lit(uint8_t segment) const
+{
+  if (segment >= _segmentCount)
+  {
+    return false;
+  }
+  const Segment &s = _segments[segment];
+  switch (s.params.effect)
+  {
+  case SentientLedEffect::Off:
+    return false;
+  case SentientLedEffect::Solid:
+    return (bool)scaled(s.params.color, s.params.level);
+  case SentientLedEffect::Manual:
+    for (uint16_t i = 0; i < s.count; i++)
+    {
+      if (s.leds[i])
+      {
+        return true;
+      }
+    }
+    return false;
+  default:
+    return true;
+  }
+}
+
+void SentientLedEffects::markDirty(uint8_t segment)
+{
+  if (segment < _segmentCount)
+  {
+    _segments[segment].dirty = true;
+  }
+}
+
+void SentientLedEffects::markAllDirty()
+{
+  for (uint8_t i = 0; i < _segmentCount; i++)
+  {
+    _segments[i].dirty = true;
+  }
+}
+
+// Heat drifts by a per-LED flame step that reverses at the top and is
+// re-rolled for one random LED per frame; heat picks the palette colour.
+void SentientLedEffects::renderFire(Segment &segment)
+{
+  const SentientLedEffectParams &p = segment.params;
+  uint8_t *heat = segment.fireState;
+  int8_t *flame = reinterpret_cast<int8_t *>(segment.fireState + segment.count);
+
+  const uint16_t pick = random16(segment.count);
+  heat[pick] = qsub8(heat[pick], random8(1, 10));
+  flame[pick] = (int8_t)(random8(0, 2 * p.variation + 1) - p.variation);
+  if (flame[pick] == 0)
+  {
+    flame[pick] = (int8_t)random8(1, p.variation + 1);
+  }
+
+  const CRGBPalette16 gradient(p.background, p.color2, p.color);
+  SentientLedPalette16 palette;
+  for (uint8_t e = 0; e < 16; e++)
+  {
+    palette.entries[e] = packed(gradient[e]);
+  }
+
+  SentientLedKernels::drift(heat, flame, segment.count, 100);
+  uint8_t *pixel = segment.leds[0].raw;
+  for (uint16_t i = 0; i < segment.count; i++, pixel += 3)
+  {
+    const uint8_t h = heat[i];
+    const uint32_t color = SentientLedKernels::paletteColor(palette, scale8(h, 240), scale8(h, p.level));
+    if (SentientLedKernels::store(pixel, color))
+    {
+      segment.dirty = true;
+    }
+    if (h + flame[i] > 255)
+    {
+      flame[i] = -(int8_t)random8(1, p.variation + 1);
+    }
+  }
+}
+
+// Bursts of random brightness in color or color2, background in between
+void SentientLedEffects::renderFlicker(Segment &segment, uint32_t nowMs)
+{
+  const SentientLedEffectParams &p = segment.params;
+  if (!segment.bursting && (int32_t)(nowMs - segment.nextBurstMs) >= 0)
+  {
+    segment.bursting = true;
+    segment.burstEndMs = nowMs + random16(p.periodMs / 10, p.periodMs / 2 + 1);
+    segment.nextBurstMs = nowMs + random16(p.periodMs / 5, p.periodMs + 1);
+    segment.burstColor2 = random8() & 1;
+  }
+  if (segment.bursting)
+  {
+    if ((int32_t)(nowMs - segment.burstEndMs) <= 0)
+    {
+      CRGB color = segment.burstColor2 ? p.color2 : p.color;
+      color.nscale8_video(scale8(random8(), p.level));
+      fillSegment(segment, color);
+      return;
+    }
+    segment.bursting = false;
+  }
+  fillSegment(segment, p.background);
+}
+
+// Breathes from background to color and back once per period
+void SentientLedEffects::renderPulse(Segment &segment, uint32_t nowMs)
+{
+  const SentientLedEffectParams &p = segment.params;
+  const uint32_t elapsed = (nowMs - segment.startedMs) % p.periodMs;
+  const uint8_t phase = (uint8_t)((elapsed * 256) / p.periodMs);
+  fillSegment(segment, blend(p.background, scaled(p.color, p.level), sin8(phase + 192)));
+}
+
+// Groups of width LEDs, spacing apart, advance one LED per period
+void SentientLedEffects::renderChase(Segment &segment, uint32_t nowMs)
+{
+  const SentientLedEffectParams &p = segment.params;
+  const uint16_t spacing = p.spacing ? p.spacing : segment.count;
+  const uint16_t offset = ((nowMs - segment.startedMs) / p.periodMs) % spacing;
+  const CRGB on = scaled(p.color, p.level);
+  for (uint16_t i = 0; i < segment.count; i++)
+  {
+    put(segment, i, (i + spacing - offset) % spacing < p.width ? on : p.background);
+  }
+}
+
+bool SentientLedEffects::service()
+{
+  const uint32_t start = micros();
+  if (!_started)
+  {
+    _started = true;
+    _nextFrameMicros = start;
+  }
+  if ((int32_t)(start - _nextFrameMicros) < 0)
+  {
+    return false;
+  }
+  _nextFrameMicros += _frameMicros;
+  if ((int32_t)(start - _nextFrameMicros) >= 0)
+  {
+    // A whole period behind: restart the cadence rather than catch up in a burst
+    ++_overruns;
+    _nextFrameMicros = start + _frameMicros;
+  }
+  ++_frames;
+
+  const uint32_t nowMs = millis();
+  for (uint8_t i = 0; i < _segmentCount; i++)
+  {
+    Segment &segment = _segments[i];
+    switch (segment.params.effect)
+    {
+    case SentientLedEffect::Fire:
+      renderFire(segment);
+      break;
+    case SentientLedEffect::Flicker:
+      renderFlicker(segment, nowMs);
+      break;
+    case SentientLedEffect::Pulse:
+      renderPulse(segment, nowMs);
+      break;
+    case SentientLedEffect::Chase:
+      renderChase(segment, nowMs);
+      break;
+    default:
+      break;
+    }
+  }
+
+  bool shown = false;
+  uint32_t busStrips = 0;
+  for (uint8_t i = 0; i < _outputCount; i++)
+  {
+    const Output &output = _outputs[i];
+    if (!_segments[output.segment].dirty)
+    {
+      continue;
+    }
+    if (output.controller)
+    {
+      output.controller->showLeds(FastLED.getBrightness());
+      shown = true;
+    }
+    else
+    {
+      busStrips |= 1UL << output.strip;
+    }
+  }
+  if (busStrips)
+  {
+    _bus->show(busStrips);
+    shown = true;
+  }
+  for (uint8_t i = 0; i < _segmentCount; i++)
+  {
+    _segments[i].dirty = false;
+  }
+
+  if (shown)
+  {
+    ++_shownFrames;
+  }
+  _lastFrameMicros = micros() - start;
+  if (_lastFrameMicros > _maxFrameMicros)
+  {
+    _maxFrameMicros = _lastFrameMicros;
+  }
+  return true;
+}
@@ -0,0 +1,178 @@
+/*
+ * SentientLedEffects.h
+ *
+ * Frame-budgeted effect engine for LED controllers.
+ *
+ * Without it, sketches redraw on every loop() pass (or every 20 ms) and call
+ * show() whether or not a pixel changed, and write the same colours into
+ * every strip that should look the same. Here:
+ * - A segment is one logical CRGB buffer. It is mirrored to any number of
+ *   outputs: FastLED controllers added on the same array, or SentientLedBus
+ *   strips that share it as their draw buffer.
+ * - service() renders at most one frame per frame period (setFrameRate()).
+ *   Effects write pixels through a compare, so a segment only turns dirty
+ *   when a pixel really changed.
+ * - Only dirty segments are sent. A frame where nothing changed costs no
+ *   show() at all, and a bus latches only the strips of dirty segments.
+ *
+ * Effects are solid, fire, flicker, pulse and chase. configure() sets them
+ * from an MQTT payload such as {"effect": "pulse", "color": "#FF6000",
+ * "period_ms": 2000}; keys left out keep their current value.
+ * Fills and the fire palette go through SentientLedKernels, four channels
+ * at a time.
+ *
+ * Drawing by hand still works: use SentientLedEffect::Manual, write the
+ * segment's buffer and call markDirty(). It goes out with the next frame.
+ *
+ * USAGE:
+ *   CRGB fire[34];
+ *   uint8_t fireState[SENTIENT_LED_FIRE_STATE_BYTES(34)];
+ *   SentientLedEffects effects(60);
+ *   int seg = effects.addSegment(fire, 34, fireState);
+ *   effects.mirrorTo(seg, FastLED.addLeds<WS2812B, 2, GRB>(fire, 34));
+ *   effects.mirrorTo(seg, FastLED.addLeds<WS2812B, 3, GRB>(fire, 34));
+ *   ...
+ *   effects.service(); // every loop()
+ */
+
+#ifndef SENTIENT_LED_EFFECTS_H
+#define SENTIENT_LED_EFFECTS_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <FastLED.h>
+#include "SentientLedBus.h"
+
+#ifndef SENTIENT_LED_MAX_SEGMENTS
+#define SENTIENT_LED_MAX_SEGMENTS 16 // Logical buffers per engine
+#endif
+#ifndef SENTIENT_LED_MAX_OUTPUTS
+#define SENTIENT_LED_MAX_OUTPUTS 32 // Controllers and bus strips fed by the segments
+#endif
+
+// Fire keeps a heat and a flame byte per LED
+#define SENTIENT_LED_FIRE_STATE_BYTES(count) ((size_t)(count) * 2)
+
+enum class SentientLedEffect : uint8_t
+{
+  Manual, // The sketch draws; markDirty() sends
+  Off,
+  Solid,
+  Fire,
+  Flicker,
+  Pulse,
+  Chase
+};
+
+struct SentientLedEffectParams
+{
+  SentientLedEffect effect = SentientLedEffect::Manual;
+  CRGB color = CRGB::White;      // Solid, pulse and chase colour; flicker colour; hottest fire colour
+  CRGB color2 = CRGB::White;     // Second flicker colour (each burst picks one); middle fire colour
+  CRGB background = CRGB::Black; // Chase gaps, pulse trough, between flicker bursts; coolest fire colour
+  uint16_t periodMs = 1000;      // Pulse cycle; chase time per LED step; longest gap between flicker bursts
+  uint8_t level = 255;           // Brightness of the effect colours
+  uint8_t width = 1;             // Chase: lit LEDs per group
+  uint8_t spacing = 0;           // Chase: distance between groups (0 = one group over the whole segment)
+  uint8_t variation = 50;        // Fire: largest flame step per frame
+};
+
+class SentientLedEffects
+{
+public:
+  explicit SentientLedEffects(uint8_t framesPerSecond = 60);
+  SentientLedEffects(const SentientLedEffects &) = delete;
+  SentientLedEffects &operator=(const SentientLedEffects &) = delete;
+
+  // Register a logical buffer; fireState (SENTIENT_LED_FIRE_STATE_BYTES(count))
+  // is only needed if the segment will run the fire effect. Returns the
+  // segment index or -1.
+  int addSegment(CRGB *leds, uint16_t count, uint8_t *fireState = nullptr);
+
+  // Send the segment on an output as well; mirrors share the segment buffer.
+  // One engine drives at most one bus.
+  bool mirrorTo(uint8_t segment, CLEDController &controller);
+  bool mirrorTo(uint8_t segment, SentientLedBus &bus, uint8_t strip);
+
+  void setFrameRate(uint8_t framesPerSecond);
+  uint8_t frameRate() const { return (uint8_t)(1000000UL / _frameMicros); }
+
+  // Solid and Off draw at once; animated effects draw from the next frame.
+  // False for an unknown segment, or fire without fire state.
+  bool setEffect(uint8_t segment, const SentientLedEffectParams &params);
+  bool fill(uint8_t segment, CRGB color);
+  bool off(uint8_t segment);
+
+  // Apply {"effect", "color", "color2", "background", "period_ms", "level",
+  // "width", "spacing", "variation"} on top of the segment's current parameters.
+  // Colours are "#RRGGBB", a basic colour name, a 0xRRGGBB number or [r, g, b];
+  // color also sets color2 unless color2 is given.
+  bool configure(uint8_t segment, JsonVariantConst payload);
+
+  const SentientLedEffectParams &params(uint8_t segment) const;
+  bool lit(uint8_t segment) const; // Anything but Off or solid black
+  static const char *effectName(SentientLedEffect effect);
+  static bool parseColor(JsonVariantConst value, CRGB &color);
+
+  // Send the segment with the next frame (after drawing by hand, or after a
+  // brightness change)
+  void markDirty(uint8_t segment);
+  void markAllDirty();
+
+  // Call every loop(). Renders and sends when a frame is due; true if it did.
+  bool service();
+
+  // Frame accounting
+  uint32_t frames() const { return _frames; }             // Frame periods serviced
+  uint32_t shownFrames() const { return _shownFrames; }   // Frames that sent at least one output
+  uint32_t overruns() const { return _overruns; }         // Frames started a whole period late
+  uint32_t lastFrameMicros() const { return _lastFrameMicros; } // Render plus show
+  uint32_t maxFrameMicros() const { return _maxFrameMicros; }
+
+private:
+  struct Segment
+  {
+    CRGB *leds;
+    uint16_t count;
+    uint8_t *fireState;
+    SentientLedEffectParams params;
+    uint32_t startedMs;   // Phase origin for pulse and chase
+    uint32_t burstEndMs;  // Flicker
+    uint32_t nextBurstMs; // Flicker
+    bool bursting;
+    bool burstColor2;
+    bool dirty;
+  };
+
+  struct Output
+  {
+    CLEDController *controller; // nullptr for a bus strip
+    uint8_t segment;
+    uint8_t strip;
+  };
+
+  static void put(Segment &segment, uint16_t index, const CRGB &color);
+  static void fillSegment(Segment &segment, const CRGB &color);
+  static void renderFire(Segment &segment);
+  static void renderFlicker(Segment &segment, uint32_t nowMs);
+  static void renderPulse(Segment &segment, uint32_t nowMs);
+  static void renderChase(Segment &segment, uint32_t nowMs);
+
+  Segment _segments[SENTIENT_LED_MAX_SEGMENTS] = {};
+  uint8_t _segmentCount = 0;
+  Output _outputs[SENTIENT_LED_MAX_OUTPUTS] = {};
+  uint8_t _outputCount = 0;
+  SentientLedBus *_bus = nullptr;
+
+  uint32_t _frameMicros;
+  uint32_t _nextFrameMicros = 0;
+  bool _started = false;
+
+  uint32_t _frames = 0;
+  uint32_t _shownFrames = 0;
+  uint32_t _overruns = 0;
+  uint32_t _lastFrameMicros = 0;
+  uint32_t _maxFrameMicros = 0;
+};
+
+#endif // SENTIENT_LED_EFFECTS_H
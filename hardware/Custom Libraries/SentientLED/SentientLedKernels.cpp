@@ -0,0 +1,276 @@
+#include "SentientLedKernels.h"
+
+#include <string.h>
+
+namespace
+{
+constexpr uint32_t kLow7 = 0x7F7F7F7FUL;
+constexpr uint32_t kHigh = 0x80808080UL;
+constexpr uint32_t kOnes = 0x01010101UL;
+constexpr uint32_t kEven = 0x00FF00FFUL;
+
+inline uint32_t load(const uint8_t *bytes)
+{
+  uint32_t word;
+  memcpy(&word, bytes, sizeof(word));
+  return word;
+}
+
+inline void save(uint8_t *bytes, uint32_t word)
+{
+  memcpy(bytes, &word, sizeof(word));
+}
+
+#if SENTIENT_LED_DSP
+
+inline uint32_t qadd4(uint32_t a, uint32_t b)
+{
+  uint32_t out;
+  asm("uqadd8 %0, %1, %2" : "=r"(out) : "r"(a), "r"(b));
+  return out;
+}
+
+inline uint32_t qsub4(uint32_t a, uint32_t b)
+{
+  uint32_t out;
+  asm("uqsub8 %0, %1, %2" : "=r"(out) : "r"(a), "r"(b));
+  return out;
+}
+
+// Channels 0 and 2 as 16-bit lanes
+inline uint32_t evenLanes(uint32_t word)
+{
+  uint32_t out;
+  asm("uxtb16 %0, %1" : "=r"(out) : "r"(word));
+  return out;
+}
+
+// Channels 1 and 3 as 16-bit lanes
+inline uint32_t oddLanes(uint32_t word)
+{
+  uint32_t out;
+  asm("uxtb16 %0, %1, ror #8" : "=r"(out) : "r"(word));
+  return out;
+}
+
+#else
+
+// Add the low seven bits of each byte without crossing lanes, then
+// rebuild bit 7 and saturate every lane that carried out of it
+inline uint32_t qadd4(uint32_t a, uint32_t b)
+{
+  const uint32_t low = (a & kLow7) + (b & kLow7);
+  const uint32_t sum = low ^ ((a ^ b) & kHigh);
+  const uint32_t carry = ((a & b) | ((a ^ b) & low)) & kHigh;
+  return sum | ((carry >> 7) * 0xFF);
+}
+
+// Borrow into bit 7 of each lane, never out of it; lanes that borrowed
+// out of bit 7 went below zero
+inline uint32_t qsub4(uint32_t a, uint32_t b)
+{
+  const uint32_t low = (a | kHigh) - (b & kLow7);
+  const uint32_t diff = low ^ (~(a ^ b) & kHigh);
+  const uint32_t borrow = ((~a & b) | (~(a ^ b) & ~low)) & kHigh;
+  return diff & ~((borrow >> 7) * 0xFF);
+}
+
+inline uint32_t evenLanes(uint32_t word)
+{
+  return word & kEven;
+}
+
+inline uint32_t oddLanes(uint32_t word)
+{
+  return (word >> 8) & kEven;
+}
+
+#endif
+
+// Each 16-bit lane holds one channel times at most 256, so one 32-bit
+// multiply scales two channels without a carry between them
+inline uint32_t scale4(uint32_t word, uint16_t factor)
+{
+  const uint32_t even = ((evenLanes(word) * factor) >> 8) & kEven;
+  const uint32_t odd = (oddLanes(word) * factor) & ~kEven;
+  return even | odd;
+}
+
+// blend8: (a * (256 - t) + b * (t + 1)) / 256, at most 65535 per lane
+inline uint32_t blend4(uint32_t a, uint32_t b, uint8_t amount)
+{
+  const uint32_t keep = 256 - amount;
+  const uint32_t take = (uint32_t)amount + 1;
+  const uint32_t even = ((evenLanes(a) * keep + evenLanes(b) * take) >> 8) & kEven;
+  const uint32_t odd = (oddLanes(a) * keep + oddLanes(b) * take) & ~kEven;
+  return even | odd;
+}
+
+// 0x01 in every lane that is not zero
+inline uint32_t nonZero4(uint32_t word)
+{
+  return ((((word & kLow7) + kLow7) | word) >> 7) & kOnes;
+}
+
+// Apply op to every word of the buffer; the tail goes through a
+// zero-padded word so every byte sees the same arithmetic
+template <typename Op>
+void eachWord(uint8_t *bytes, size_t length, Op op)
+{
+  for (; length >= 4; length -= 4, bytes += 4)
+  {
+    save(bytes, op(load(bytes)));
+  }
+  if (length)
+  {
+    uint8_t tail[4] = {};
+    memcpy(tail, bytes, length);
+    save(tail, op(load(tail)));
+    memcpy(bytes, tail, length);
+  }
+}
+
+template <typename Op>
+void eachWordPair(uint8_t *bytes, const uint8_t *other, size_t length, Op op)
+{
+  for (; length >= 4; length -= 4, bytes += 4, other += 4)
+  {
+    save(bytes, op(load(bytes), load(other)));
+  }
+  if (length)
+  {
+    uint8_t tail[4] = {};
+    uint8_t otherTail[4] = {};
+    memcpy(tail, bytes, length);
+    memcpy(otherTail, other, length);
+    save(tail, op(load(tail), load(otherTail)));
+    memcpy(bytes, tail, length);
+  }
+}
+}
+
+namespace SentientLedKernels
+{
+bool fill(uint8_t *rgb, uint16_t count, uint32_t color)
+{
+  // Four pixels are exactly three words
+  uint8_t pattern[12];
+  for (uint8_t i = 0; i < 12; i += 3)
+  {
+    pattern[i] = (uint8_t)color;
+    pattern[i + 1] = (uint8_t)(color >> 8);
+    pattern[i + 2] = (uint8_t)(color >> 16);
+  }
+  const uint32_t words[3] = {load(pattern), load(pattern + 4), load(pattern + 8)};
+
+  uint32_t changed = 0;
+  size_t length = (size_t)count * 3;
+  for (; length >= 12; length -= 12, rgb += 12)
+  {
+    for (uint8_t w = 0; w < 3; w++)
+    {
+      changed |= load(rgb + 4 * w) ^ words[w];
+      save(rgb + 4 * w, words[w]);
+    }
+  }
+  for (size_t i = 0; i < length; i++)
+  {
+    changed |= rgb[i] ^ pattern[i];
+    rgb[i] = pattern[i];
+  }
+  return changed != 0;
+}
+
+void add(uint8_t *rgb, const uint8_t *other, uint16_t count)
+{
+  eachWordPair(rgb, other, (size_t)count * 3, [](uint32_t a, uint32_t b) { return qadd4(a, b); });
+}
+
+void fade(uint8_t *rgb, uint16_t count, uint8_t amount)
+{
+  if (amount == 0)
+  {
+    return;
+  }
+  const uint32_t by = amount * kOnes;
+  eachWord(rgb, (size_t)count * 3, [by](uint32_t w) { return qsub4(w, by); });
+}
+
+void scale(uint8_t *rgb, uint16_t count, uint8_t scale)
+{
+  if (scale == 255)
+  {
+    return;
+  }
+  const uint16_t factor = (uint16_t)scale + 1;
+  eachWord(rgb, (size_t)count * 3, [factor](uint32_t w) { return scale4(w, factor); });
+}
+
+void scaleVideo(uint8_t *rgb, uint16_t count, uint8_t scale)
+{
+  if (scale == 0)
+  {
+    memset(rgb, 0, (size_t)count * 3);
+    return;
+  }
+  eachWord(rgb, (size_t)count * 3, [scale](uint32_t w) { return scale4(w, scale) + nonZero4(w); });
+}
+
+void blend(uint8_t *rgb, const uint8_t *overlay, uint16_t count, uint8_t amount)
+{
+  if (amount == 0)
+  {
+    return;
+  }
+  if (amount == 255)
+  {
+    memmove(rgb, overlay, (size_t)count * 3);
+    return;
+  }
+  eachWordPair(rgb, overlay, (size_t)count * 3,
+               [amount](uint32_t a, uint32_t b) { return blend4(a, b, amount); });
+}
+
+void drift(uint8_t *values, const int8_t *steps, uint16_t count, uint8_t floor)
+{
+  const uint32_t bottom = floor * kOnes;
+  eachWordPair(values, reinterpret_cast<const uint8_t *>(steps), count,
+               [bottom](uint32_t v, uint32_t s)
+               {
+                 // Split the signed steps into what to add and what to take away
+                 const uint32_t negative = (s >> 7) & kOnes;
+                 const uint32_t mask = negative * 0xFF;
+                 const uint32_t up = s & ~mask;
+                 const uint32_t down = (~s & mask) + negative;
+                 v = qsub4(qadd4(v, up), down);
+                 return qadd4(qsub4(v, bottom), bottom);
+               });
+}
+
+uint32_t paletteColor(const SentientLedPalette16 &palette, uint8_t index, uint8_t brightness)
+{
+  const uint8_t entry = index >> 4;
+  const uint8_t fraction = index & 0x0F;
+  uint32_t color = palette.entries[entry];
+  if (fraction)
+  {
+    color = blend4(color, palette.entries[(entry + 1) & 0x0F], fraction << 4);
+  }
+  if (brightness != 255)
+  {
+    color = scale4(color, (uint16_t)brightness + 1);
+  }
+  return color;
+}
+
+bool paletteMap(uint8_t *rgb, const uint8_t *indices, uint16_t count,
+                const SentientLedPalette16 &palette, uint8_t brightness)
+{
+  bool changed = false;
+  for (uint16_t i = 0; i < count; i++, rgb += 3)
+  {
+    changed |= store(rgb, paletteColor(palette, indices[i], brightness));
+  }
+  return changed;
+}
+}
@@ -0,0 +1,96 @@
+/*
+ * SentientLedKernels.h
+ *
+ * Whole-strip pixel math, four channels per operation.
+ *
+ * FastLED's qadd8, qsub8, scale8 and blend8 handle one byte per call. These
+ * kernels load four channels into a 32-bit word and work on all of them at
+ * once:
+ * - On the Teensy 4.x (Cortex-M7) saturating add and subtract are the DSP
+ *   instructions UQADD8 and UQSUB8, and UXTB16 splits a word into two pairs
+ *   of 16-bit lanes, so one multiply scales two channels.
+ * - Anywhere else the same words go through plain 32-bit arithmetic with
+ *   identical results, so the kernels also build with a desktop compiler.
+ *   Define SENTIENT_LED_NO_DSP to force that path on the Teensy.
+ *
+ * Buffers are CRGB arrays passed as bytes (leds[0].raw) with a pixel count;
+ * no alignment is needed. Results equal FastLED's fill_solid, nscale8,
+ * nscale8_video, fadeToBlackBy-style qsub8 and nblend bit for bit.
+ * paletteColor() is within one step of ColorFromPalette(..., LINEARBLEND).
+ *
+ * A packed colour is 0x00BBGGRR, the byte order of a CRGB in memory.
+ *
+ * USAGE:
+ *   SentientLedKernels::fill(leds[0].raw, NUM_LEDS, SentientLedKernels::pack(255, 96, 0));
+ *   SentientLedKernels::scale(leds[0].raw, NUM_LEDS, 128);
+ */
+
+#ifndef SENTIENT_LED_KERNELS_H
+#define SENTIENT_LED_KERNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__ARM_FEATURE_DSP) && !defined(SENTIENT_LED_NO_DSP)
+#define SENTIENT_LED_DSP 1
+#else
+#define SENTIENT_LED_DSP 0
+#endif
+
+// Sixteen evenly spaced colours, as in a CRGBPalette16
+struct SentientLedPalette16
+{
+  uint32_t entries[16];
+};
+
+namespace SentientLedKernels
+{
+inline uint32_t pack(uint8_t r, uint8_t g, uint8_t b)
+{
+  return (uint32_t)r | ((uint32_t)g << 8) | ((uint32_t)b << 16);
+}
+
+// Set every pixel to color; true if any pixel changed
+bool fill(uint8_t *rgb, uint16_t count, uint32_t color);
+
+// Saturating add of another buffer (qadd8 per channel)
+void add(uint8_t *rgb, const uint8_t *other, uint16_t count);
+
+// Saturating subtract of amount from every channel (qsub8)
+void fade(uint8_t *rgb, uint16_t count, uint8_t amount);
+
+// Multiply every channel by (scale + 1) / 256 (nscale8)
+void scale(uint8_t *rgb, uint16_t count, uint8_t scale);
+
+// As scale(), but a lit channel never goes dark while scale > 0 (nscale8_video)
+void scaleVideo(uint8_t *rgb, uint16_t count, uint8_t scale);
+
+// Move every pixel amount/255 of the way towards overlay (nblend)
+void blend(uint8_t *rgb, const uint8_t *overlay, uint16_t count, uint8_t amount);
+
+// values[i] = max(floor, values[i] + steps[i]), saturating at 255
+void drift(uint8_t *values, const int8_t *steps, uint16_t count, uint8_t floor);
+
+// Linear blend between neighbouring entries (15 wraps to 0), then nscale8 by brightness
+uint32_t paletteColor(const SentientLedPalette16 &palette, uint8_t index, uint8_t brightness);
+
+// paletteColor() for every pixel; true if any pixel changed
+bool paletteMap(uint8_t *rgb, const uint8_t *indices, uint16_t count,
+                const SentientLedPalette16 &palette, uint8_t brightness);
+
+// Write one packed colour; true if the pixel changed
+inline bool store(uint8_t *pixel, uint32_t color)
+{
+  const uint32_t current = pack(pixel[0], pixel[1], pixel[2]);
+  if (current == color)
+  {
+    return false;
+  }
+  pixel[0] = (uint8_t)color;
+  pixel[1] = (uint8_t)(color >> 8);
+  pixel[2] = (uint8_t)(color >> 16);
+  return true;
+}
+}
+
+#endif // SENTIENT_LED_KERNELS_H
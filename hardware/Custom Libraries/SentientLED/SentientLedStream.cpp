@@ -0,0 +1,500 @@
+#include "SentientLedStream.h"
+
+namespace
+{
+constexpr size_t kE131HeaderBytes = 126; // Root, framing and DMP layers up to the start code
+constexpr size_t kE131SyncBytes = 49;
+constexpr size_t kDdpHeaderBytes = 10;
+constexpr size_t kDdpTimecodeBytes = 4;
+constexpr uint32_t kUniverseBytes = SentientLedStream::PIXELS_PER_UNIVERSE * 3;
+constexpr uint16_t kMaxUniverse = 63999;
+constexpr int8_t kLateWindow = -20; // E1.31 6.7.2: older than this is a restarted sender
+
+constexpr uint32_t kRootVectorData = 0x00000004;
+constexpr uint32_t kRootVectorExtended = 0x00000008;
+constexpr uint32_t kFramingVectorData = 0x00000002;
+constexpr uint32_t kFramingVectorSync = 0x00000001;
+constexpr uint8_t kOptionPreview = 0x80;
+constexpr uint8_t kOptionTerminated = 0x40;
+
+constexpr uint8_t kDdpVersionMask = 0xC0;
+constexpr uint8_t kDdpVersion1 = 0x40;
+constexpr uint8_t kDdpTimecode = 0x10;
+constexpr uint8_t kDdpReplyOrQuery = 0x0C;
+constexpr uint8_t kDdpPush = 0x01;
+constexpr uint8_t kDdpDefaultDevice = 1;
+
+const uint8_t kAcnPacketId[12] = {'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0};
+
+inline uint16_t be16(const uint8_t *bytes)
+{
+  return (uint16_t)((bytes[0] << 8) | bytes[1]);
+}
+
+inline uint32_t be32(const uint8_t *bytes)
+{
+  return ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) | ((uint32_t)bytes[2] << 8) | bytes[3];
+}
+
+inline size_t smaller(size_t a, size_t b)
+{
+  return a < b ? a : b;
+}
+
+// A datagram already in memory
+class BufferSource
+{
+public:
+  BufferSource(const uint8_t *data, size_t length) : _data(data), _left(length) {}
+
+  size_t remaining() const { return _left; }
+
+  size_t read(uint8_t *out, size_t length)
+  {
+    length = smaller(length, _left);
+    memcpy(out, _data, length);
+    _data += length;
+    _left -= length;
+    return length;
+  }
+
+  void skip(size_t length)
+  {
+    length = smaller(length, _left);
+    _data += length;
+    _left -= length;
+  }
+
+private:
+  const uint8_t *_data;
+  size_t _left;
+};
+
+// A datagram still in the socket: read() lands bytes where they belong
+class SocketSource
+{
+public:
+  SocketSource(SENTIENT_LED_UDP &udp, size_t length) : _udp(udp), _left(length) {}
+
+  size_t remaining() const { return _left; }
+
+  size_t read(uint8_t *out, size_t length)
+  {
+    length = smaller(length, _left);
+    const int got = length ? _udp.read(out, length) : 0;
+    const size_t bytes = got > 0 ? (size_t)got : 0;
+    _left -= bytes;
+    return bytes;
+  }
+
+  void skip(size_t length)
+  {
+    uint8_t scratch[32];
+    while (length && _left)
+    {
+      const size_t got = read(scratch, smaller(length, sizeof(scratch)));
+      if (got == 0)
+      {
+        break;
+      }
+      length -= got;
+    }
+  }
+
+private:
+  SENTIENT_LED_UDP &_udp;
+  size_t _left;
+};
+}
+
+SentientLedStream::SentientLedStream(uint8_t protocols) : _protocols(protocols)
+{
+}
+
+int SentientLedStream::addStrip(CRGB *leds, uint16_t count, uint16_t universe)
+{
+  if (_listening)
+  {
+    Serial.println(F("[SentientLedStream] Strips must be added before begin()"));
+    return -1;
+  }
+  if (_stripCount >= SENTIENT_LED_STREAM_MAX_STRIPS)
+  {
+    Serial.println(F("[SentientLedStream] Too many strips; raise SENTIENT_LED_STREAM_MAX_STRIPS"));
+    return -1;
+  }
+  if (!leds || count == 0)
+  {
+    return -1;
+  }
+
+  const uint32_t bytes = (uint32_t)count * 3;
+  const uint32_t address = universe ? (uint32_t)(universe - 1) * kUniverseBytes : _e131End;
+  const uint16_t first = (uint16_t)(address / kUniverseBytes + 1);
+  const uint32_t last = (address + bytes - 1) / kUniverseBytes + 1;
+  if (address < _e131End || last > kMaxUniverse)
+  {
+    Serial.print(F("[SentientLedStream] Universe "));
+    Serial.print(first);
+    Serial.println(F(" overlaps an earlier strip or runs past 63999"));
+    return -1;
+  }
+
+  // Universes this strip adds to the table (a packed strip may share its first)
+  const bool sharesFirst = _universeCount && _universes[_universeCount - 1].number == first;
+  const uint32_t added = last - first + 1 - (sharesFirst ? 1 : 0);
+  if (_universeCount + added > SENTIENT_LED_STREAM_MAX_UNIVERSES)
+  {
+    Serial.println(F("[SentientLedStream] Too many universes; raise SENTIENT_LED_STREAM_MAX_UNIVERSES"));
+    return -1;
+  }
+  for (uint32_t u = sharesFirst ? first + 1 : first; u <= last; u++)
+  {
+    _universes[_universeCount++] = {(uint16_t)u, 0, false};
+  }
+
+  _allUniverses = _universeCount >= 64 ? ~0ULL : (1ULL << _universeCount) - 1;
+
+  _strips[_stripCount] = {leds, count, address, _ddpEnd};
+  _e131End = address + bytes;
+  _ddpEnd += bytes;
+  return _stripCount++;
+}
+
+void SentientLedStream::onFrame(FrameHandler handler, void *context)
+{
+  _handler = handler;
+  _context = context;
+}
+
+uint16_t SentientLedStream::firstUniverse(uint8_t strip) const
+{
+  return strip < _stripCount ? (uint16_t)(_strips[strip].e131Address / kUniverseBytes + 1) : 0;
+}
+
+bool SentientLedStream::begin()
+{
+  if (_listening)
+  {
+    return true;
+  }
+  bool ok = true;
+  if (_protocols & E131)
+  {
+    ok = _e131.begin(E131_PORT) && ok;
+  }
+  if (_protocols & DDP)
+  {
+    ok = _ddp.begin(DDP_PORT) && ok;
+  }
+  _listening = ok;
+  _windowStartMs = millis();
+
+  Serial.print(F("[SentientLedStream] "));
+  Serial.print(_stripCount);
+  Serial.print(F(" strips in "));
+  Serial.print(_universeCount);
+  Serial.print(F(" universes"));
+  Serial.println(ok ? F(", listening") : F(", no UDP socket"));
+  return ok;
+}
+
+bool SentientLedStream::service()
+{
+  bool latched = false;
+  if (_listening)
+  {
+    for (uint8_t n = 0; n < SENTIENT_LED_STREAM_PACKETS_PER_SERVICE; n++)
+    {
+      const int size = (_protocols & E131) ? _e131.parsePacket() : 0;
+      if (size <= 0)
+      {
+        break;
+      }
+      SocketSource source(_e131, (size_t)size);
+      latched = handle(E131_PORT, source) || latched;
+    }
+    for (uint8_t n = 0; n < SENTIENT_LED_STREAM_PACKETS_PER_SERVICE; n++)
+    {
+      const int size = (_protocols & DDP) ? _ddp.parsePacket() : 0;
+      if (size <= 0)
+      {
+        break;
+      }
+      SocketSource source(_ddp, (size_t)size);
+      latched = handle(DDP_PORT, source) || latched;
+    }
+  }
+
+  const uint32_t now = millis();
+  if (_active && now - _lastPacketMs >= SENTIENT_LED_STREAM_TIMEOUT_MS)
+  {
+    stop();
+  }
+  if (now - _windowStartMs >= 1000)
+  {
+    _fps = (uint16_t)((_windowFrames * 1000UL) / (now - _windowStartMs));
+    _windowFrames = 0;
+    _windowStartMs = now;
+  }
+  return latched;
+}
+
+bool SentientLedStream::receive(uint16_t port, const uint8_t *packet, size_t length)
+{
+  BufferSource source(packet, length);
+  return handle(port, source);
+}
+
+template <typename Source>
+bool SentientLedStream::handle(uint16_t port, Source &source)
+{
+  ++_packets;
+  _lastPacketMs = millis();
+  if (port == E131_PORT && (_protocols & E131))
+  {
+    return handleE131(source);
+  }
+  if (port == DDP_PORT && (_protocols & DDP))
+  {
+    return handleDdp(source);
+  }
+  ++_rejected;
+  return false;
+}
+
+template <typename Source>
+bool SentientLedStream::handleE131(Source &source)
+{
+  uint8_t header[kE131HeaderBytes];
+  const size_t got = source.read(header, smaller(source.remaining(), sizeof(header)));
+  if (got < kE131SyncBytes || be16(header) != 0x0010 || memcmp(header + 4, kAcnPacketId, sizeof(kAcnPacketId)) != 0)
+  {
+    ++_rejected;
+    return false;
+  }
+
+  const uint32_t rootVector = be32(header + 18);
+  if (rootVector == kRootVectorExtended)
+  {
+    // Sync releases the frame held for it; universe discovery is ignored
+    if (be32(header + 40) == kFramingVectorSync && _syncAddress && be16(header + 45) == _syncAddress)
+    {
+      return latch(_pendingUniverses == _allUniverses);
+    }
+    return false;
+  }
+  if (rootVector != kRootVectorData || got < kE131HeaderBytes || be32(header + 40) != kFramingVectorData ||
+      header[117] != 0x02 || be16(header + 123) == 0)
+  {
+    ++_rejected;
+    return false;
+  }
+
+  const uint8_t options = header[112];
+  if (options & kOptionTerminated)
+  {
+    stop();
+    return false;
+  }
+  // Preview data is for visualisers; a nonzero start code is not pixel data
+  if ((options & kOptionPreview) || header[125] != 0)
+  {
+    return false;
+  }
+  const int index = findUniverse(be16(header + 113));
+  if (index < 0)
+  {
+    return false; // Not mapped on this controller
+  }
+
+  Universe &universe = _universes[index];
+  const uint8_t sequence = header[111];
+  if (universe.seen)
+  {
+    const int8_t step = (int8_t)(sequence - universe.sequence);
+    if (step <= 0 && step > kLateWindow)
+    {
+      ++_late;
+      return false;
+    }
+    if (step > 1)
+    {
+      _lost += step - 1;
+    }
+  }
+  universe.seen = true;
+  universe.sequence = sequence;
+
+  // The next frame started before this one completed: show what arrived
+  bool latched = false;
+  const uint64_t bit = 1ULL << index;
+  if (_pendingUniverses & bit)
+  {
+    latched = latch(false);
+  }
+
+  _syncAddress = be16(header + 109);
+  const size_t channels = smaller(be16(header + 123) - 1, kUniverseBytes);
+  _pendingStrips |= deliver(source, (universe.number - 1) * kUniverseBytes, smaller(channels, source.remaining()), false);
+  _pendingUniverses |= bit;
+  _active = true;
+
+  if (!_syncAddress && _pendingUniverses == _allUniverses)
+  {
+    latched = latch(true) || latched;
+  }
+  return latched;
+}
+
+template <typename Source>
+bool SentientLedStream::handleDdp(Source &source)
+{
+  uint8_t header[kDdpHeaderBytes];
+  if (source.read(header, sizeof(header)) < sizeof(header) || (header[0] & kDdpVersionMask) != kDdpVersion1)
+  {
+    ++_rejected;
+    return false;
+  }
+  const uint8_t flags = header[0];
+  const uint8_t type = header[2];
+  if ((flags & kDdpReplyOrQuery) || header[3] != kDdpDefaultDevice)
+  {
+    return false; // Status and configuration traffic, or another output
+  }
+  // RGB (or untyped) at 8 bits per channel
+  if (((type >> 3) & 0x07) > 1 || ((type & 0x07) != 0 && (type & 0x07) != 3))
+  {
+    ++_rejected;
+    return false;
+  }
+  if (flags & kDdpTimecode)
+  {
+    source.skip(kDdpTimecodeBytes);
+  }
+
+  // Sequence runs 1..15; 0 means the sender does not number packets
+  const uint8_t sequence = header[1] & 0x0F;
+  if (sequence && _ddpSequence)
+  {
+    const uint8_t expected = _ddpSequence % 15 + 1;
+    const uint8_t gap = (uint8_t)((sequence + 15 - expected) % 15);
+    if (gap > 7)
+    {
+      ++_late;
+      return false;
+    }
+    _lost += gap;
+  }
+  _ddpSequence = sequence;
+
+  const uint32_t offset = be32(header + 4);
+  const size_t length = smaller(be16(header + 8), source.remaining());
+
+  // Data from the top again without a push: the sender moved on
+  bool latched = false;
+  if (_pendingStrips && offset < _ddpNextAddress)
+  {
+    latched = latch(false);
+  }
+  _pendingStrips |= deliver(source, offset, length, true);
+  _ddpNextAddress = offset + length;
+  _active = true;
+
+  if (flags & kDdpPush)
+  {
+    latched = latch(true) || latched;
+  }
+  return latched;
+}
+
+// Copy [address, address + length) of the sender's address space into the
+// strips that cover it, straight from the source
+template <typename Source>
+uint32_t SentientLedStream::deliver(Source &source, uint32_t address, size_t length, bool ddp)
+{
+  uint32_t written = 0;
+  for (uint8_t s = 0; s < _stripCount && length; s++)
+  {
+    const Strip &strip = _strips[s];
+    const uint32_t start = ddp ? strip.ddpAddress : strip.e131Address;
+    const uint32_t end = start + (uint32_t)strip.count * 3;
+    if (end <= address)
+    {
+      continue;
+    }
+    if (start >= address + length)
+    {
+      break;
+    }
+    if (start > address)
+    {
+      source.skip(start - address);
+      length -= start - address;
+      address = start;
+    }
+    const size_t bytes = smaller(end - address, length);
+    const size_t got = source.read(strip.leds[0].raw + (address - start), bytes);
+    if (got)
+    {
+      written |= 1UL << s;
+    }
+    if (got < bytes)
+    {
+      break;
+    }
+    address += bytes;
+    length -= bytes;
+  }
+  return written;
+}
+
+int SentientLedStream::findUniverse(uint16_t number) const
+{
+  for (uint8_t i = 0; i < _universeCount; i++)
+  {
+    if (_universes[i].number == number)
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+bool SentientLedStream::latch(bool complete)
+{
+  const uint32_t strips = _pendingStrips;
+  _pendingStrips = 0;
+  _pendingUniverses = 0;
+  _ddpNextAddress = 0;
+  if (!strips)
+  {
+    return false;
+  }
+  if (!complete)
+  {
+    ++_incomplete;
+  }
+  ++_frames;
+  ++_windowFrames;
+  if (_handler)
+  {
+    _handler(strips, _context);
+  }
+  return true;
+}
+
+// Sender gone: forget sequence state; a partial frame is not shown
+void SentientLedStream::stop()
+{
+  _active = false;
+  _pendingStrips = 0;
+  _pendingUniverses = 0;
+  _syncAddress = 0;
+  _ddpNextAddress = 0;
+  _ddpSequence = 0;
+  for (uint8_t i = 0; i < _universeCount; i++)
+  {
+    _universes[i].seen = false;
+  }
+}
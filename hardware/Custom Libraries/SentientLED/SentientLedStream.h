@@ -0,0 +1,179 @@
+/*
+ * SentientLedStream.h
+ *
+ * Pixel streaming over UDP: E1.31 (sACN) and DDP straight into LED buffers.
+ *
+ * MQTT pattern commands cover looks the firmware already knows. For
+ * choreographed shows the backend or a lighting desk sends every frame
+ * instead, and this receiver puts it on the strips:
+ * - Strips are mapped into the sender's address space in the order they are
+ *   added. E1.31 gives a strip a starting universe (170 RGB pixels each), or
+ *   packs it right after the previous strip. DDP offsets count pixels across
+ *   all strips in the same order.
+ * - Pixel data is read from the socket directly into the strips' CRGB
+ *   arrays; only the packet header goes through a scratch buffer.
+ * - A frame is latched (onFrame() handler) when E1.31 has delivered every
+ *   mapped universe, its sync packet arrives, or DDP sets the push flag.
+ *   The handler shows the updated strips; SentientLedBus copies them into its
+ *   DMA frame, so a frame on the wire is never half old, half new.
+ * - If a universe repeats before the frame completed, the partial frame is
+ *   latched first and counted in incompleteFrames(). Late and duplicate
+ *   E1.31 packets (sequence within 20 behind) are dropped; gaps in the
+ *   sequence are counted in lostPackets().
+ *
+ * The stream is active() from the first pixel data until no packet has arrived
+ * for SENTIENT_LED_STREAM_TIMEOUT_MS or the sender marks it terminated.
+ * Send E1.31 unicast to the controller; multicast groups are not joined.
+ *
+ * receive() takes a datagram from memory, so the parser runs without a
+ * socket; hardware/scripts/led_stream_generator.py sends test frames.
+ *
+ * USAGE:
+ *   SentientLedStream stream;
+ *   stream.addStrip(ledsA, 60, 1); // Universe 1
+ *   stream.addStrip(ledsB, 60);    // Packed after ledsA
+ *   stream.onFrame(show_stream_frame);
+ *   stream.begin();                // After the network is up
+ *   ...
+ *   stream.service();              // Every loop()
+ */
+
+#ifndef SENTIENT_LED_STREAM_H
+#define SENTIENT_LED_STREAM_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+#if defined(ESP32)
+#include <WiFi.h>
+#include <WiFiUdp.h>
+#define SENTIENT_LED_UDP WiFiUDP
+#else
+#include <NativeEthernet.h>
+#include <NativeEthernetUdp.h>
+#define SENTIENT_LED_UDP EthernetUDP
+#endif
+
+#ifndef SENTIENT_LED_STREAM_MAX_STRIPS
+#define SENTIENT_LED_STREAM_MAX_STRIPS 32 // Bits in the onFrame() strip mask
+#endif
+#ifndef SENTIENT_LED_STREAM_MAX_UNIVERSES
+#define SENTIENT_LED_STREAM_MAX_UNIVERSES 64 // E1.31 universes covered by the strips
+#endif
+#ifndef SENTIENT_LED_STREAM_PACKETS_PER_SERVICE
+#define SENTIENT_LED_STREAM_PACKETS_PER_SERVICE 16 // Datagrams drained per service() and socket
+#endif
+#ifndef SENTIENT_LED_STREAM_TIMEOUT_MS
+#define SENTIENT_LED_STREAM_TIMEOUT_MS 2500 // E1.31 network data loss timeout
+#endif
+
+class SentientLedStream
+{
+public:
+  static constexpr uint8_t E131 = 0x01;
+  static constexpr uint8_t DDP = 0x02;
+  static constexpr uint16_t E131_PORT = 5568;
+  static constexpr uint16_t DDP_PORT = 4048;
+  static constexpr uint16_t PIXELS_PER_UNIVERSE = 170;
+
+  // stripMask has bit i set for every strip (addStrip() index) the frame wrote
+  typedef void (*FrameHandler)(uint32_t stripMask, void *context);
+
+  explicit SentientLedStream(uint8_t protocols = E131 | DDP);
+  SentientLedStream(const SentientLedStream &) = delete;
+  SentientLedStream &operator=(const SentientLedStream &) = delete;
+
+  // Map a strip before begin(). universe 0 packs it right after the
+  // previous strip; otherwise it starts at channel 1 of that universe, which
+  // must not overlap earlier strips. Returns the strip index or -1.
+  int addStrip(CRGB *leds, uint16_t count, uint16_t universe = 0);
+
+  void onFrame(FrameHandler handler, void *context = nullptr);
+
+  // Open the sockets; call once the network is up
+  bool begin();
+
+  // Call every loop(). Drains waiting datagrams; true if a frame was latched.
+  bool service();
+
+  // Handle one datagram from memory (port picks the protocol)
+  bool receive(uint16_t port, const uint8_t *packet, size_t length);
+
+  bool active() const { return _active; }
+  uint8_t stripCount() const { return _stripCount; }
+  uint16_t firstUniverse(uint8_t strip) const;
+
+  // Stream accounting
+  uint32_t frames() const { return _frames; }
+  uint32_t packets() const { return _packets; }
+  uint32_t lostPackets() const { return _lost; }         // Sequence gaps
+  uint32_t latePackets() const { return _late; }         // Out of order or duplicate, dropped
+  uint32_t rejectedPackets() const { return _rejected; } // Malformed or unsupported
+  uint32_t incompleteFrames() const { return _incomplete; }
+  uint16_t framesPerSecond() const { return _fps; }      // Over the last whole second
+
+private:
+  struct Strip
+  {
+    CRGB *leds;
+    uint16_t count;
+    uint32_t e131Address; // Byte offset in universe space: (universe - 1) * 510 + channel - 1
+    uint32_t ddpAddress;  // Byte offset in DDP space
+  };
+
+  struct Universe
+  {
+    uint16_t number;
+    uint8_t sequence;
+    bool seen;
+  };
+
+  template <typename Source>
+  bool handle(uint16_t port, Source &source);
+  template <typename Source>
+  bool handleE131(Source &source);
+  template <typename Source>
+  bool handleDdp(Source &source);
+  template <typename Source>
+  uint32_t deliver(Source &source, uint32_t address, size_t length, bool ddp);
+
+  int findUniverse(uint16_t number) const;
+  bool latch(bool complete);
+  void stop();
+
+  Strip _strips[SENTIENT_LED_STREAM_MAX_STRIPS] = {};
+  uint8_t _stripCount = 0;
+  uint32_t _e131End = 0; // First free byte in each address space
+  uint32_t _ddpEnd = 0;
+
+  Universe _universes[SENTIENT_LED_STREAM_MAX_UNIVERSES] = {};
+  uint8_t _universeCount = 0;
+  uint64_t _allUniverses = 0;
+  uint64_t _pendingUniverses = 0; // Written since the last latch
+  uint32_t _pendingStrips = 0;
+  uint16_t _syncAddress = 0;      // Nonzero: latch on the matching sync packet
+  uint32_t _ddpNextAddress = 0;
+  uint8_t _ddpSequence = 0;
+
+  uint8_t _protocols;
+  SENTIENT_LED_UDP _e131;
+  SENTIENT_LED_UDP _ddp;
+  bool _listening = false;
+
+  FrameHandler _handler = nullptr;
+  void *_context = nullptr;
+
+  bool _active = false;
+  uint32_t _lastPacketMs = 0;
+  uint32_t _frames = 0;
+  uint32_t _packets = 0;
+  uint32_t _lost = 0;
+  uint32_t _late = 0;
+  uint32_t _rejected = 0;
+  uint32_t _incomplete = 0;
+  uint32_t _windowStartMs = 0;
+  uint32_t _windowFrames = 0;
+  uint16_t _fps = 0;
+};
+
+#endif // SENTIENT_LED_STREAM_H
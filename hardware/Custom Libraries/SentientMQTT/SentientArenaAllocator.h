@@ -0,0 +1,212 @@
+/*
+ * SentientArenaAllocator.h
+ *
+ * Fixed-size ArduinoJson allocator for documents that are rebuilt over and
+ * over (heartbeats, sensor readings, command payloads).
+ *
+ * ArduinoJson 7 documents are always heap backed and free their pools on
+ * clear(), so a document that is cleared and refilled every loop would hit
+ * malloc/free every time. This allocator hands out blocks from one region
+ * reserved at startup and rewinds to the start as soon as every block has
+ * been released, so steady-state use performs no heap allocations at all.
+ *
+ * Exhaustion is reported the ArduinoJson way: allocate() returns nullptr and
+ * the document reports overflowed().
+ */
+
+#ifndef SENTIENT_ARENA_ALLOCATOR_H
+#define SENTIENT_ARENA_ALLOCATOR_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <new>
+
+class SentientArenaAllocator : public ArduinoJson::Allocator
+{
+public:
+  SentientArenaAllocator() = default;
+  SentientArenaAllocator(const SentientArenaAllocator &) = delete;
+  SentientArenaAllocator &operator=(const SentientArenaAllocator &) = delete;
+
+  ~SentientArenaAllocator()
+  {
+    if (_ownsStorage)
+    {
+      delete[] _storage;
+    }
+  }
+
+  // Reserve the arena from the heap (call once from setup/begin)
+  bool begin(size_t capacity)
+  {
+    if (_storage)
+    {
+      return _capacity >= capacity;
+    }
+    uint8_t *storage = new (std::nothrow) uint8_t[capacity];
+    if (!storage)
+    {
+      return false;
+    }
+    _ownsStorage = true;
+    attach(storage, capacity);
+    return true;
+  }
+
+  // Use caller-provided storage (static, DMAMEM or EXTMEM buffers)
+  void begin(void *storage, size_t capacity)
+  {
+    if (_storage)
+    {
+      return;
+    }
+    _ownsStorage = false;
+    attach(static_cast<uint8_t *>(storage), capacity);
+  }
+
+  void *allocate(size_t size) override
+  {
+    const size_t blockSize = alignUp(size);
+    if (!_storage || _offset + kHeaderSize + blockSize > _capacity)
+    {
+      _failures++;
+      return nullptr;
+    }
+
+    uint8_t *header = _storage + _offset;
+    reinterpret_cast<BlockHeader *>(header)->size = blockSize;
+    _lastBlock = _offset;
+    _offset += kHeaderSize + blockSize;
+    _liveBlocks++;
+    _allocations++;
+    if (_offset > _peak)
+    {
+      _peak = _offset;
+    }
+    return header + kHeaderSize;
+  }
+
+  void deallocate(void *ptr) override
+  {
+    if (!ptr || _liveBlocks == 0)
+    {
+      return;
+    }
+
+    _liveBlocks--;
+    if (_liveBlocks == 0)
+    {
+      rewind();
+    }
+    else if (blockOffset(ptr) == _lastBlock)
+    {
+      // Popping the newest block lets the next allocation reuse its space
+      _offset = _lastBlock;
+      _lastBlock = kNoBlock;
+    }
+  }
+
+  void *reallocate(void *ptr, size_t newSize) override
+  {
+    if (!ptr)
+    {
+      return allocate(newSize);
+    }
+
+    BlockHeader *header = headerOf(ptr);
+    const size_t blockSize = alignUp(newSize);
+    const size_t offset = blockOffset(ptr);
+
+    if (offset == _lastBlock)
+    {
+      // Newest block: grow or shrink in place
+      if (offset + kHeaderSize + blockSize > _capacity)
+      {
+        _failures++;
+        return nullptr;
+      }
+      header->size = blockSize;
+      _offset = offset + kHeaderSize + blockSize;
+      if (_offset > _peak)
+      {
+        _peak = _offset;
+      }
+      return ptr;
+    }
+
+    if (blockSize <= header->size)
+    {
+      // Shrinking an older block: keep it where it is
+      return ptr;
+    }
+
+    void *moved = allocate(newSize);
+    if (!moved)
+    {
+      return nullptr;
+    }
+    memcpy(moved, ptr, header->size);
+    deallocate(ptr);
+    return moved;
+  }
+
+  void rewind()
+  {
+    _offset = 0;
+    _liveBlocks = 0;
+    _lastBlock = kNoBlock;
+  }
+
+  size_t capacity() const { return _capacity; }
+  size_t used() const { return _offset; }
+  size_t peak() const { return _peak; }
+  uint32_t allocations() const { return _allocations; }
+  uint32_t failures() const { return _failures; }
+
+private:
+  struct BlockHeader
+  {
+    size_t size;
+  };
+
+  static constexpr size_t kAlignment = 8;
+  static constexpr size_t kHeaderSize = (sizeof(BlockHeader) + kAlignment - 1) & ~(kAlignment - 1);
+  static constexpr size_t kNoBlock = static_cast<size_t>(-1);
+
+  static size_t alignUp(size_t size)
+  {
+    return (size + kAlignment - 1) & ~(kAlignment - 1);
+  }
+
+  void attach(uint8_t *storage, size_t capacity)
+  {
+    // Keep every block 8-byte aligned regardless of where the buffer lives
+    const uintptr_t misalignment = reinterpret_cast<uintptr_t>(storage) & (kAlignment - 1);
+    const size_t skip = misalignment ? kAlignment - misalignment : 0;
+    _storage = storage + skip;
+    _capacity = capacity > skip ? capacity - skip : 0;
+    rewind();
+  }
+
+  BlockHeader *headerOf(void *ptr) const
+  {
+    return reinterpret_cast<BlockHeader *>(static_cast<uint8_t *>(ptr) - kHeaderSize);
+  }
+
+  size_t blockOffset(void *ptr) const
+  {
+    return static_cast<size_t>(static_cast<uint8_t *>(ptr) - kHeaderSize - _storage);
+  }
+
+  uint8_t *_storage = nullptr;
+  size_t _capacity = 0;
+  size_t _offset = 0;
+  size_t _peak = 0;
+  size_t _lastBlock = kNoBlock;
+  size_t _liveBlocks = 0;
+  uint32_t _allocations = 0;
+  uint32_t _failures = 0;
+  bool _ownsStorage = false;
+};
+
+#endif // SENTIENT_ARENA_ALLOCATOR_H
@@ -0,0 +1,244 @@
+#include "SentientClock.h"
+
+namespace
+{
+constexpr size_t kNtpPacketBytes = 48;
+constexpr uint8_t kNtpClientRequest = 0x23; // LI 0, version 4, mode 3 (client)
+constexpr uint8_t kNtpModeServer = 4;
+constexpr uint64_t kNtpToUnixSeconds = 2208988800ULL;
+constexpr uint16_t kLocalPort = 4123;
+constexpr uint64_t kMinDriftSpanUs = 10000000ULL; // Drift is only measured over at least 10 s
+constexpr uint64_t kAgePenaltyPpm = 15;           // RFC 5905 PHI: what an old sample's delay is worth per second
+
+uint32_t readBe32(const uint8_t *bytes)
+{
+  return ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) | ((uint32_t)bytes[2] << 8) | bytes[3];
+}
+
+void writeBe32(uint8_t *bytes, uint32_t value)
+{
+  bytes[0] = (uint8_t)(value >> 24);
+  bytes[1] = (uint8_t)(value >> 16);
+  bytes[2] = (uint8_t)(value >> 8);
+  bytes[3] = (uint8_t)value;
+}
+
+// NTP seconds.fraction to Unix microseconds
+int64_t ntpToUnixMicros(const uint8_t *bytes)
+{
+  const uint64_t seconds = readBe32(bytes);
+  const uint64_t fraction = readBe32(bytes + 4);
+  return (int64_t)((seconds - kNtpToUnixSeconds) * 1000000ULL + ((fraction * 1000000ULL) >> 32));
+}
+}
+
+bool SentientClock::begin(const IPAddress &server, uint16_t port, uint32_t pollIntervalMs)
+{
+  if (_started)
+  {
+    return true;
+  }
+  _server = server;
+  _port = port;
+  _pollIntervalMs = pollIntervalMs < 1000 ? 1000 : pollIntervalMs;
+  _started = _udp.begin(kLocalPort) != 0;
+  _lastPollMs = millis() - _pollIntervalMs;
+
+  Serial.print(F("[SentientClock] "));
+  if (_started)
+  {
+    Serial.print(F("Syncing with "));
+    Serial.println(_server);
+  }
+  else
+  {
+    Serial.println(F("No UDP socket for time sync"));
+  }
+  return _started;
+}
+
+uint64_t SentientClock::localMicros()
+{
+  const uint32_t now = micros();
+  if (now < _lastMicros)
+  {
+    _microsHigh += 1ULL << 32;
+  }
+  _lastMicros = now;
+  return _microsHigh | now;
+}
+
+void SentientClock::service()
+{
+  localMicros();
+  if (!_started)
+  {
+    return;
+  }
+
+  if (_awaiting && !readReply() && millis() - _lastPollMs >= SENTIENT_CLOCK_REPLY_TIMEOUT_MS)
+  {
+    _awaiting = false;
+    ++_timeouts;
+  }
+
+  const uint32_t interval = _windowCount < SENTIENT_CLOCK_SAMPLES ? SENTIENT_CLOCK_BURST_INTERVAL_MS : _pollIntervalMs;
+  if (!_awaiting && millis() - _lastPollMs >= interval)
+  {
+    sendRequest();
+    // A LAN reply takes well under a millisecond; catch it here rather than
+    // a whole loop() later, which would read as path delay
+    while (_awaiting && localMicros() - _sentLocal < SENTIENT_CLOCK_REPLY_SPIN_US)
+    {
+      readReply();
+    }
+  }
+}
+
+uint32_t SentientClock::msUntilDue() const
+{
+  if (!_started)
+  {
+    return UINT32_MAX;
+  }
+  const uint32_t wait = _awaiting ? SENTIENT_CLOCK_REPLY_TIMEOUT_MS
+                                  : (_windowCount < SENTIENT_CLOCK_SAMPLES ? SENTIENT_CLOCK_BURST_INTERVAL_MS : _pollIntervalMs);
+  const uint32_t elapsed = millis() - _lastPollMs;
+  return elapsed >= wait ? 0 : wait - elapsed;
+}
+
+uint64_t SentientClock::epochMicros()
+{
+  return _synced ? localToEpoch(localMicros()) : 0;
+}
+
+uint64_t SentientClock::localToEpoch(uint64_t local) const
+{
+  const int64_t since = (int64_t)(local - _reference);
+  return (uint64_t)((int64_t)local + _offset + (int64_t)(_drift * since));
+}
+
+uint64_t SentientClock::epochToLocal(uint64_t epoch) const
+{
+  // Invert epoch = local + offset + drift * (local - reference)
+  const int64_t undrifted = (int64_t)epoch - _offset - (int64_t)_reference;
+  return _reference + (uint64_t)(int64_t)(undrifted / (1.0 + _drift));
+}
+
+void SentientClock::sendRequest()
+{
+  uint8_t packet[kNtpPacketBytes] = {};
+  packet[0] = kNtpClientRequest;
+
+  // The transmit timestamp only has to come back unchanged in the reply's
+  // originate field; local time makes it unique per request
+  const uint64_t token = localMicros();
+  _sentToken[0] = (uint32_t)(token >> 32) | 0x80000000UL;
+  _sentToken[1] = (uint32_t)token;
+  writeBe32(packet + 40, _sentToken[0]);
+  writeBe32(packet + 44, _sentToken[1]);
+
+  _lastPollMs = millis();
+  if (!_udp.beginPacket(_server, _port))
+  {
+    return;
+  }
+  _udp.write(packet, sizeof(packet));
+  _sentLocal = localMicros();
+  _awaiting = _udp.endPacket() != 0;
+}
+
+bool SentientClock::readReply()
+{
+  const int size = _udp.parsePacket();
+  if (size <= 0)
+  {
+    return false;
+  }
+  const uint64_t received = localMicros();
+
+  uint8_t packet[kNtpPacketBytes];
+  if (size < (int)kNtpPacketBytes || _udp.read(packet, sizeof(packet)) != (int)sizeof(packet))
+  {
+    return false;
+  }
+  // Server mode, not a kiss-o'-death (stratum 0), answering our request
+  if ((packet[0] & 0x07) != kNtpModeServer || packet[1] == 0 || readBe32(packet + 24) != _sentToken[0] ||
+      readBe32(packet + 28) != _sentToken[1])
+  {
+    return false;
+  }
+  _awaiting = false;
+
+  const int64_t serverReceive = ntpToUnixMicros(packet + 32);
+  const int64_t serverTransmit = ntpToUnixMicros(packet + 40);
+  const int64_t sent = (int64_t)_sentLocal;
+  const int64_t arrived = (int64_t)received;
+  const int64_t roundTrip = (arrived - sent) - (serverTransmit - serverReceive);
+
+  Sample sample;
+  sample.local = received;
+  sample.offset = ((serverReceive - sent) + (serverTransmit - arrived)) / 2;
+  sample.delay = roundTrip < 0 ? 0 : (uint32_t)roundTrip;
+  ++_samples;
+  accept(sample);
+  return true;
+}
+
+void SentientClock::accept(const Sample &sample)
+{
+  _window[_windowNext] = sample;
+  _windowNext = (_windowNext + 1) % SENTIENT_CLOCK_SAMPLES;
+  if (_windowCount < SENTIENT_CLOCK_SAMPLES)
+  {
+    ++_windowCount;
+  }
+
+  // Shortest round trip wins, but an old sample has had time to drift, so
+  // its delay is charged for its age
+  const Sample *best = nullptr;
+  uint64_t bestScore = 0;
+  for (uint8_t i = 0; i < _windowCount; i++)
+  {
+    const uint64_t score = _window[i].delay + (sample.local - _window[i].local) * kAgePenaltyPpm / 1000000ULL;
+    if (!best || score < bestScore)
+    {
+      best = &_window[i];
+      bestScore = score;
+    }
+  }
+  if (_synced && best->local == _lastSampleLocal)
+  {
+    return; // Still trusting the same exchange
+  }
+
+  const int64_t predicted = (int64_t)localToEpoch(best->local) - (int64_t)best->local;
+  _lastOffset = best->offset - predicted;
+  if (!_synced || _lastOffset > SENTIENT_CLOCK_STEP_US || _lastOffset < -SENTIENT_CLOCK_STEP_US)
+  {
+    if (_synced)
+    {
+      Serial.print(F("[SentientClock] Stepped by "));
+      Serial.print((int32_t)(_lastOffset / 1000));
+      Serial.println(F(" ms"));
+    }
+    _drift = 0;
+    _driftMeasured = false;
+    _synced = true;
+  }
+  else if (best->local - _lastSampleLocal >= kMinDriftSpanUs)
+  {
+    // How fast the offset moved since the last trusted sample, smoothed
+    const double measured = (double)(best->offset - _lastSampleOffset) / (double)(best->local - _lastSampleLocal);
+    _drift = _driftMeasured ? _drift + (measured - _drift) / 4 : measured;
+    _driftMeasured = true;
+    const double limit = SENTIENT_CLOCK_MAX_DRIFT_PPM / 1e6;
+    _drift = _drift > limit ? limit : (_drift < -limit ? -limit : _drift);
+  }
+
+  _reference = best->local;
+  _offset = best->offset;
+  _roundTrip = best->delay;
+  _lastSampleLocal = best->local;
+  _lastSampleOffset = best->offset;
+}
@@ -0,0 +1,139 @@
+/*
+ * SentientClock.h
+ *
+ * Network-disciplined wall clock for SentientMQTT.
+ *
+ * millis() starts at zero on every controller, so timestamps from two
+ * controllers cannot be lined up. This clock keeps Unix time in microseconds
+ * by trading NTP packets (RFC 5905, client mode) with the time server,
+ * normally the broker host:
+ * - Each exchange yields an offset and a round trip. Of the last
+ *   SENTIENT_CLOCK_SAMPLES exchanges the one with the shortest round trip
+ *   (plus an allowance for its age) is trusted: queueing and a late poll
+ *   only ever lengthen it.
+ * - The first sample sets the clock. Each newly trusted sample after that
+ *   replaces the offset, so the clock steps by the residual error (usually
+ *   well under a millisecond, and possibly backwards) at that poll; offsets
+ *   within SENTIENT_CLOCK_STEP_US also refine the crystal's drift (ppm),
+ *   which keeps the clock running at the right rate between polls. Code
+ *   measuring short intervals should use micros(), not epochMicros().
+ * - After sending, service() polls for the reply for up to
+ *   SENTIENT_CLOCK_REPLY_SPIN_US so the receive time is not a loop() late.
+ *
+ * Local time is micros() widened to 64 bits; service() must run at least
+ * once per 71 minutes (every loop() in practice).
+ */
+
+#ifndef SENTIENT_CLOCK_H
+#define SENTIENT_CLOCK_H
+
+#include <Arduino.h>
+
+#if defined(ESP32)
+#include <WiFi.h>
+#include <WiFiUdp.h>
+#define SENTIENT_CLOCK_UDP WiFiUDP
+#else
+#include <NativeEthernet.h>
+#include <NativeEthernetUdp.h>
+#define SENTIENT_CLOCK_UDP EthernetUDP
+#endif
+
+#ifndef SENTIENT_CLOCK_SAMPLES
+#define SENTIENT_CLOCK_SAMPLES 8 // Exchanges the shortest round trip is picked from
+#endif
+#ifndef SENTIENT_CLOCK_BURST_INTERVAL_MS
+#define SENTIENT_CLOCK_BURST_INTERVAL_MS 250 // Poll spacing until the sample window is full
+#endif
+#ifndef SENTIENT_CLOCK_REPLY_TIMEOUT_MS
+#define SENTIENT_CLOCK_REPLY_TIMEOUT_MS 500
+#endif
+#ifndef SENTIENT_CLOCK_REPLY_SPIN_US
+#define SENTIENT_CLOCK_REPLY_SPIN_US 2000 // Busy-wait for a LAN reply right after sending
+#endif
+#ifndef SENTIENT_CLOCK_STEP_US
+#define SENTIENT_CLOCK_STEP_US 100000 // Offsets beyond this also discard the drift estimate
+#endif
+#ifndef SENTIENT_CLOCK_MAX_DRIFT_PPM
+#define SENTIENT_CLOCK_MAX_DRIFT_PPM 500.0
+#endif
+
+class SentientClock
+{
+public:
+  SentientClock() = default;
+  SentientClock(const SentientClock &) = delete;
+  SentientClock &operator=(const SentientClock &) = delete;
+
+  // Start polling server every pollIntervalMs (after a quick initial burst)
+  bool begin(const IPAddress &server, uint16_t port = 123, uint32_t pollIntervalMs = 16000);
+  bool started() const { return _started; }
+
+  // Call every loop()
+  void service();
+  // How long service() has nothing to do: until the next poll or reply timeout
+  uint32_t msUntilDue() const;
+
+  // micros() since boot, without the 32-bit wrap
+  uint64_t localMicros();
+
+  bool synced() const { return _synced; }
+  uint64_t epochMicros();                                       // 0 until synced
+  uint64_t epochMillis() { return epochMicros() / 1000; }
+  uint64_t epochToLocal(uint64_t epochMicros) const;            // Local time at which the clock reads epochMicros
+  uint64_t localToEpoch(uint64_t localMicros) const;
+
+  // Discipline state
+  int64_t lastOffsetMicros() const { return _lastOffset; } // Correction the last accepted sample asked for
+  uint32_t roundTripMicros() const { return _roundTrip; }  // Of the trusted sample
+  uint32_t errorMicros() const { return _roundTrip / 2; }  // Bound on the offset error from path asymmetry
+  float driftPpm() const { return (float)(_drift * 1e6); }
+  uint32_t samples() const { return _samples; }
+  uint32_t timeouts() const { return _timeouts; }
+
+private:
+  struct Sample
+  {
+    uint64_t local;  // Local receive time
+    int64_t offset;  // Epoch minus local
+    uint32_t delay;  // Round trip minus server hold time
+  };
+
+  void sendRequest();
+  bool readReply();
+  void accept(const Sample &sample);
+
+  SENTIENT_CLOCK_UDP _udp;
+  IPAddress _server;
+  uint16_t _port = 123;
+  uint32_t _pollIntervalMs = 16000;
+  bool _started = false;
+
+  uint32_t _lastMicros = 0;
+  uint64_t _microsHigh = 0;
+
+  bool _awaiting = false;
+  uint64_t _sentLocal = 0;
+  uint32_t _sentToken[2] = {0, 0}; // Our transmit timestamp, echoed by the server
+  uint32_t _lastPollMs = 0;
+
+  Sample _window[SENTIENT_CLOCK_SAMPLES] = {};
+  uint8_t _windowCount = 0;
+  uint8_t _windowNext = 0;
+
+  // epoch = local + _offset + _drift * (local - _reference)
+  bool _synced = false;
+  uint64_t _reference = 0;
+  int64_t _offset = 0;
+  double _drift = 0;
+  bool _driftMeasured = false;
+  uint64_t _lastSampleLocal = 0; // Of the last trusted sample, for drift
+  int64_t _lastSampleOffset = 0;
+
+  int64_t _lastOffset = 0;
+  uint32_t _roundTrip = 0;
+  uint32_t _samples = 0;
+  uint32_t _timeouts = 0;
+};
+
+#endif // SENTIENT_CLOCK_H
@@ -0,0 +1,146 @@
+#include "SentientCommandRouter.h"
+
+#include <cstring>
+
+SentientCommandRouter::SentientCommandRouter()
+{
+  // Node 0 is the root; it carries no character
+  _nodes[0] = {'\0', kNone, kNone, kNone};
+  _nodeCount = 1;
+}
+
+bool SentientCommandRouter::add(const char *deviceId, const char *command, SentientRouteHandler handler, void *context, uint8_t index)
+{
+  if (!command || !*command || !handler)
+  {
+    return false;
+  }
+  if (!deviceId)
+  {
+    deviceId = "";
+  }
+  if (_routeCount >= SENTIENT_ROUTER_MAX_ROUTES)
+  {
+    Serial.print(F("[SentientMQTT] Route table full, dropping "));
+    Serial.print(deviceId);
+    Serial.print('/');
+    Serial.println(command);
+    return false;
+  }
+
+  // Key is "device/command"; controller-level commands use an empty device
+  const uint16_t savedNodeCount = _nodeCount;
+  uint16_t node = 0;
+  for (const char *p = deviceId; node != kNone && *p; ++p)
+  {
+    node = insertChild(node, *p);
+  }
+  if (node != kNone)
+  {
+    node = insertChild(node, '/');
+  }
+  for (const char *p = command; node != kNone && *p; ++p)
+  {
+    node = insertChild(node, *p);
+  }
+
+  if (node == kNone)
+  {
+    // Out of nodes: unlink anything this call added so the trie stays
+    // consistent. New nodes are prepended to a child list, so skipping them
+    // along their sibling links restores the list that was there before.
+    for (uint16_t i = 0; i < savedNodeCount; ++i)
+    {
+      while (_nodes[i].child != kNone && _nodes[i].child >= savedNodeCount)
+      {
+        _nodes[i].child = _nodes[_nodes[i].child].sibling;
+      }
+      while (_nodes[i].sibling != kNone && _nodes[i].sibling >= savedNodeCount)
+      {
+        _nodes[i].sibling = _nodes[_nodes[i].sibling].sibling;
+      }
+    }
+    _nodeCount = savedNodeCount;
+    Serial.print(F("[SentientMQTT] Route trie full (raise SENTIENT_ROUTER_MAX_NODES), dropping "));
+    Serial.print(deviceId);
+    Serial.print('/');
+    Serial.println(command);
+    return false;
+  }
+
+  if (_nodes[node].route != kNone)
+  {
+    // Re-registration replaces the handler
+    Route &existing = _routes[_nodes[node].route];
+    existing.handler = handler;
+    existing.context = context;
+    existing.index = index;
+    return true;
+  }
+
+  _routes[_routeCount] = {deviceId, command, handler, context, index};
+  _nodes[node].route = _routeCount++;
+  return true;
+}
+
+bool SentientCommandRouter::dispatch(SentientCommand &command, const JsonDocument &payload) const
+{
+  uint16_t node = walk(0, command.device.data, command.device.length);
+  node = walk(node, "/", 1);
+  node = walk(node, command.command.data, command.command.length);
+  if (node == kNone || _nodes[node].route == kNone)
+  {
+    node = walk(0, SENTIENT_ANY_DEVICE "/", 2);
+    node = walk(node, command.command.data, command.command.length);
+    if (node == kNone || _nodes[node].route == kNone)
+    {
+      return false;
+    }
+  }
+
+  const Route &route = _routes[_nodes[node].route];
+  command.deviceId = route.deviceId;
+  command.name = route.command;
+  command.index = route.index;
+  route.handler(command, payload, route.context);
+  return true;
+}
+
+uint16_t SentientCommandRouter::findChild(uint16_t node, char ch) const
+{
+  for (uint16_t child = _nodes[node].child; child != kNone; child = _nodes[child].sibling)
+  {
+    if (_nodes[child].ch == ch)
+    {
+      return child;
+    }
+  }
+  return kNone;
+}
+
+uint16_t SentientCommandRouter::insertChild(uint16_t node, char ch)
+{
+  const uint16_t existing = findChild(node, ch);
+  if (existing != kNone)
+  {
+    return existing;
+  }
+  if (_nodeCount >= SENTIENT_ROUTER_MAX_NODES)
+  {
+    return kNone;
+  }
+
+  const uint16_t created = _nodeCount++;
+  _nodes[created] = {ch, kNone, _nodes[node].child, kNone};
+  _nodes[node].child = created;
+  return created;
+}
+
+uint16_t SentientCommandRouter::walk(uint16_t node, const char *text, size_t length) const
+{
+  for (size_t i = 0; node != kNone && i < length; ++i)
+  {
+    node = findChild(node, text[i]);
+  }
+  return node;
+}
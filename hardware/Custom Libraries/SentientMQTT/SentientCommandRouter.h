@@ -0,0 +1,108 @@
+/*
+ * SentientCommandRouter.h
+ *
+ * Device-scoped command dispatch for SentientMQTT.
+ *
+ * Command topics look like
+ *   [namespace]/[room]/commands/[controller]/[device]/[command]
+ * SentientMQTT strips the fixed prefix once and hands the router views of
+ * the device and command segments; nothing is copied or NUL-terminated.
+ *
+ * Routes are registered at setup time as (device_id, command) -> handler.
+ * They are stored in a character trie keyed on "device/command", so a
+ * lookup walks the topic once, in time proportional to its length, no
+ * matter how many devices or commands the controller has.
+ *
+ * A device_id of SENTIENT_ANY_DEVICE ("+") matches any device segment,
+ * including none; exact device routes are tried first.
+ */
+
+#ifndef SENTIENT_COMMAND_ROUTER_H
+#define SENTIENT_COMMAND_ROUTER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#ifndef SENTIENT_ROUTER_MAX_ROUTES
+#define SENTIENT_ROUTER_MAX_ROUTES 64 // (device, command) pairs per controller
+#endif
+#ifndef SENTIENT_ROUTER_MAX_NODES
+#define SENTIENT_ROUTER_MAX_NODES 640 // Trie nodes: one per distinct "device/command" prefix character
+#endif
+
+#define SENTIENT_ANY_DEVICE "+"
+
+// Non-owning view of a topic segment (not NUL-terminated)
+struct SentientTopicView
+{
+  const char *data = nullptr;
+  size_t length = 0;
+
+  bool empty() const { return length == 0; }
+  bool equals(const char *literal) const
+  {
+    return literal && strncmp(data ? data : "", literal, length) == 0 && literal[length] == '\0';
+  }
+};
+
+struct SentientCommand
+{
+  SentientTopicView device;  // Segment after the controller id (empty for controller-level topics)
+  SentientTopicView command; // Remaining segment(s)
+
+  // Set when a route matched: the strings it was registered with, which are
+  // NUL-terminated and safe to keep (acks, logging), and the position of the
+  // command in the list passed to SentientMQTT::onCommands(). Wildcard routes
+  // report SENTIENT_ANY_DEVICE here; the topic's device is in `device`.
+  const char *deviceId = nullptr;
+  const char *name = nullptr;
+  uint8_t index = 0;
+};
+
+using SentientRouteHandler = void (*)(const SentientCommand &command, const JsonDocument &payload, void *context);
+
+class SentientCommandRouter
+{
+public:
+  SentientCommandRouter();
+
+  bool add(const char *deviceId, const char *command, SentientRouteHandler handler, void *context, uint8_t index = 0);
+
+  // Resolve the route for command.device/command.command and call it.
+  // Fills command.deviceId/name/index; false when no route matches.
+  bool dispatch(SentientCommand &command, const JsonDocument &payload) const;
+
+  size_t routeCount() const { return _routeCount; }
+  size_t nodeCount() const { return _nodeCount; }
+
+private:
+  static constexpr uint16_t kNone = 0xFFFF;
+
+  struct Node
+  {
+    char ch;
+    uint16_t child;
+    uint16_t sibling;
+    uint16_t route;
+  };
+
+  struct Route
+  {
+    const char *deviceId;
+    const char *command;
+    SentientRouteHandler handler;
+    void *context;
+    uint8_t index;
+  };
+
+  uint16_t findChild(uint16_t node, char ch) const;
+  uint16_t insertChild(uint16_t node, char ch);
+  uint16_t walk(uint16_t node, const char *text, size_t length) const;
+
+  Node _nodes[SENTIENT_ROUTER_MAX_NODES];
+  uint16_t _nodeCount = 0;
+  Route _routes[SENTIENT_ROUTER_MAX_ROUTES];
+  uint16_t _routeCount = 0;
+};
+
+#endif // SENTIENT_COMMAND_ROUTER_H
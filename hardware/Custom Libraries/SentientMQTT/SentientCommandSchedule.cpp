@@ -0,0 +1,50 @@
+#include "SentientCommandSchedule.h"
+
+bool SentientCommandSchedule::add(uint64_t dueLocalMicros, const char *topic, const uint8_t *payload, size_t payloadLength)
+{
+  const size_t topicLength = strlen(topic);
+  if (topicLength >= SENTIENT_MQTT_SCHEDULE_TOPIC_BYTES || payloadLength >= SENTIENT_MQTT_SCHEDULE_PAYLOAD_BYTES)
+  {
+    ++_rejected;
+    return false;
+  }
+  for (Entry &entry : _entries)
+  {
+    if (entry.used)
+    {
+      continue;
+    }
+    entry.dueLocalMicros = dueLocalMicros;
+    memcpy(entry.topic, topic, topicLength + 1);
+    memcpy(entry.payload, payload, payloadLength);
+    entry.payload[payloadLength] = '\0';
+    entry.payloadLength = (uint16_t)payloadLength;
+    entry.used = true;
+    ++_depth;
+    return true;
+  }
+  ++_rejected;
+  return false;
+}
+
+SentientCommandSchedule::Entry *SentientCommandSchedule::next()
+{
+  Entry *earliest = nullptr;
+  for (Entry &entry : _entries)
+  {
+    if (entry.used && (!earliest || entry.dueLocalMicros < earliest->dueLocalMicros))
+    {
+      earliest = &entry;
+    }
+  }
+  return earliest;
+}
+
+void SentientCommandSchedule::remove(Entry *entry)
+{
+  if (entry && entry->used)
+  {
+    entry->used = false;
+    --_depth;
+  }
+}
@@ -0,0 +1,56 @@
+/*
+ * SentientCommandSchedule.h
+ *
+ * Commands held back until their execute_at time.
+ *
+ * A command whose payload carries "execute_at" (Unix milliseconds, may be
+ * fractional) is not dispatched on arrival. SentientMQTT copies its topic
+ * and raw payload into a free slot here, keyed by the local time at which
+ * the synchronised clock reaches execute_at, and dispatches it from loop()
+ * when that time comes. Slots are fixed; nothing is allocated.
+ */
+
+#ifndef SENTIENT_COMMAND_SCHEDULE_H
+#define SENTIENT_COMMAND_SCHEDULE_H
+
+#include <Arduino.h>
+
+#ifndef SENTIENT_MQTT_SCHEDULE_SLOTS
+#define SENTIENT_MQTT_SCHEDULE_SLOTS 8 // Commands waiting for their execute_at at once
+#endif
+#ifndef SENTIENT_MQTT_SCHEDULE_TOPIC_BYTES
+#define SENTIENT_MQTT_SCHEDULE_TOPIC_BYTES 96 // "[device]/[command]" after the controller's command prefix
+#endif
+#ifndef SENTIENT_MQTT_SCHEDULE_PAYLOAD_BYTES
+#define SENTIENT_MQTT_SCHEDULE_PAYLOAD_BYTES 256
+#endif
+
+class SentientCommandSchedule
+{
+public:
+  struct Entry
+  {
+    uint64_t dueLocalMicros;
+    char topic[SENTIENT_MQTT_SCHEDULE_TOPIC_BYTES];
+    char payload[SENTIENT_MQTT_SCHEDULE_PAYLOAD_BYTES];
+    uint16_t payloadLength;
+    bool used;
+  };
+
+  // False when every slot is taken or the command does not fit
+  bool add(uint64_t dueLocalMicros, const char *topic, const uint8_t *payload, size_t payloadLength);
+
+  // Earliest entry, or nullptr; valid until remove()
+  Entry *next();
+  void remove(Entry *entry);
+
+  size_t depth() const { return _depth; }
+  uint32_t rejected() const { return _rejected; }
+
+private:
+  Entry _entries[SENTIENT_MQTT_SCHEDULE_SLOTS] = {};
+  size_t _depth = 0;
+  uint32_t _rejected = 0;
+};
+
+#endif // SENTIENT_COMMAND_SCHEDULE_H
@@ -10,6 +10,10 @@
 #include <cstring>
 #include <new>
 
+#if !defined(ESP32)
+#include <NativeDns.h>
+#endif
+
 namespace
 {
   bool isValidIp(const IPAddress &ip)
@@ -21,15 +25,125 @@ namespace
   {
     return millis() / 1000;
   }
+
+  // Append "/segment" (or "segment" at the start) without allocating; false on overflow
+  bool appendSegment(char *buffer, size_t &length, const char *segment, size_t segmentLength)
+  {
+    if (!segment || segmentLength == 0)
+    {
+      return true;
+    }
+    const bool needsSlash = length > 0 && buffer[length - 1] != '/';
+    if (length + (needsSlash ? 1 : 0) + segmentLength >= SENTIENT_MQTT_MAX_TOPIC_LENGTH)
+    {
+      return false;
+    }
+    if (needsSlash)
+    {
+      buffer[length++] = '/';
+    }
+    memcpy(buffer + length, segment, segmentLength);
+    length += segmentLength;
+    buffer[length] = '\0';
+    return true;
+  }
+
+  bool appendSegment(char *buffer, size_t &length, const char *segment)
+  {
+    return appendSegment(buffer, length, segment, segment ? strlen(segment) : 0);
+  }
+
+#if !defined(ESP32)
+  // Append an MQTT length-prefixed UTF-8 string; false if it does not fit
+  bool appendMqttString(uint8_t *packet, size_t &length, size_t capacity, const char *value)
+  {
+    const size_t valueLength = value ? strlen(value) : 0;
+    if (valueLength > 0xFFFF || length + 2 + valueLength > capacity)
+    {
+      return false;
+    }
+    packet[length++] = static_cast<uint8_t>(valueLength >> 8);
+    packet[length++] = static_cast<uint8_t>(valueLength & 0xFF);
+    memcpy(packet + length, value, valueLength);
+    length += valueLength;
+    return true;
+  }
+#endif
+
+  // Batches serializer output into MQTT_MAX_TRANSFER_SIZE writes between
+  // beginPublish() and endPublish(), so payloads stream from the document
+  // into the socket without an intermediate String or heap buffer.
+  class MqttChunkWriter : public Print
+  {
+  public:
+    explicit MqttChunkWriter(PubSubClient &client) : _client(client) {}
+
+    size_t write(uint8_t c) override
+    {
+      if (_used == sizeof(_chunk))
+      {
+        flush();
+      }
+      _chunk[_used++] = c;
+      return 1;
+    }
+
+    size_t write(const uint8_t *data, size_t length) override
+    {
+      size_t remaining = length;
+      while (remaining > 0)
+      {
+        if (_used == sizeof(_chunk))
+        {
+          flush();
+        }
+        size_t count = sizeof(_chunk) - _used;
+        if (count > remaining)
+        {
+          count = remaining;
+        }
+        memcpy(_chunk + _used, data, count);
+        _used += count;
+        data += count;
+        remaining -= count;
+      }
+      return length;
+    }
+
+    void flush() override
+    {
+      if (_used == 0)
+      {
+        return;
+      }
+      if (_client.write(_chunk, _used) != _used)
+      {
+        _failed = true;
+      }
+      _used = 0;
+    }
+
+    bool ok() const { return !_failed; }
+
+  private:
+    PubSubClient &_client;
+    uint8_t _chunk[MQTT_MAX_TRANSFER_SIZE];
+    size_t _used = 0;
+    bool _failed = false;
+  };
 } // namespace
 
 SentientMQTT *SentientMQTT::s_activeInstance = nullptr;
+volatile bool SentientMQTT::s_pinWake = false;
 
 SentientMQTT::SentientMQTT(const SentientMQTTConfig &config)
-    : _config(config), _mqttClient(_networkClient) {}
+    : _config(config), _mqttClient(_networkClient), _publishDoc(&_publishArena), _commandDoc(&_commandArena) {}
 
 bool SentientMQTT::begin()
 {
+  // Paint the stack before anything deep runs so its high-water mark is true
+  SentientMemory::begin();
+
   // Either controllerId (controller) or deviceId must be set for identification
   if ((!_config.controllerId || _config.controllerId[0] == '\0') &&
       (!_config.deviceId || _config.deviceId[0] == '\0'))
@@ -49,6 +163,46 @@ bool SentientMQTT::begin()
     _config.keepAliveSeconds = 60;
   }
   _mqttClient.setKeepAlive(_config.keepAliveSeconds);
+#if !defined(ESP32)
+  _networkClient.setConnectionTimeout(_config.connectTimeoutMs > 0xFFFF ? 0xFFFF : _config.connectTimeoutMs);
+#endif
+
+  cacheTopicSegments();
+
+  // Reserve the publish arena once; every library-built payload reuses it
+  size_t arenaBytes = _config.publishJsonCapacity;
+  if (arenaBytes < SENTIENT_MQTT_MIN_ARENA_BYTES)
+  {
+    arenaBytes = SENTIENT_MQTT_MIN_ARENA_BYTES;
+  }
+  if (!_publishArena.begin(arenaBytes))
+  {
+    Serial.println(F("[SentientMQTT] publish arena allocation failed"));
+    return false;
+  }
+
+  size_t commandArenaBytes = _config.commandJsonCapacity;
+  if (commandArenaBytes < SENTIENT_MQTT_MIN_ARENA_BYTES)
+  {
+    commandArenaBytes = SENTIENT_MQTT_MIN_ARENA_BYTES;
+  }
+  if (!_commandArena.begin(commandArenaBytes))
+  {
+    Serial.println(F("[SentientMQTT] command arena allocation failed"));
+    return false;
+  }
+
+  if (_config.offlineQueueBytes > 0)
+  {
+    if (_config.offlineQueueStorage)
+    {
+      _offlineQueue.begin(_config.offlineQueueStorage, _config.offlineQueueBytes);
+    }
+    else if (!_offlineQueue.begin(_config.offlineQueueBytes))
+    {
+      Serial.println(F("[SentientMQTT] offline queue allocation failed, publishing without replay"));
+    }
+  }
 
   // Set buffer size based on publishJsonCapacity
   size_t required = static_cast<size_t>(_config.publishJsonCapacity) * 4;
@@ -76,6 +230,8 @@ bool SentientMQTT::begin()
     Serial.print(F(":"));
     Serial.println(_config.brokerPort);
     _mqttClient.setServer(_config.brokerIp, _config.brokerPort);
+    _brokerAddress = _config.brokerIp;
+    _brokerResolved = true;
   }
   else if (_config.brokerHost && _config.brokerHost[0] != '\0')
   {
@@ -91,6 +247,30 @@ bool SentientMQTT::begin()
     return false;
   }
 
+  // Seed the backoff jitter from something unique to this board so a room full
+  // of controllers spreads out after a broker restart
+  _jitterState = 2166136261u;
+#if defined(ESP32)
+  const char *seed = _config.controllerId ? _config.controllerId : "";
+  for (; *seed; ++seed)
+  {
+    _jitterState = (_jitterState ^ static_cast<uint8_t>(*seed)) * 16777619u;
+  }
+#else
+  for (uint8_t octet : _macAddress)
+  {
+    _jitterState = (_jitterState ^ octet) * 16777619u;
+  }
+#endif
+  _jitterState ^= micros();
+  if (_jitterState == 0)
+  {
+    _jitterState = 1;
+  }
+  _failedAttempts = 0;
+  _retryDelayMs = 0;
+  enterPhase(ConnectPhase::Idle);
+
   s_activeInstance = this;
   _mqttClient.setCallback(mqttCallbackThunk);
 
@@ -114,6 +294,9 @@ void SentientMQTT::loop()
 
   ensureConnected();
   _mqttClient.loop();
+  drainOfflineQueue();
+  serviceClock();
+  serviceSchedule();
 
   if (_config.autoHeartbeat && _mqttClient.connected())
   {
@@ -123,11 +306,18 @@ void SentientMQTT::loop()
       publishHeartbeat();
     }
   }
+
+  if (_idleUsed && _config.idleReportIntervalMs > 0 && _mqttClient.connected() &&
+      millis() - _lastIdleReport >= _config.idleReportIntervalMs)
+  {
+    publishIdleStatus();
+  }
 }
 
 bool SentientMQTT::publishSensor(const char *name, float value, const char *unit)
 {
-  DynamicJsonDocument doc(_config.publishJsonCapacity);
+  JsonDocument &doc = _publishDoc;
+  doc.clear();
   doc["name"] = name ? name : "sensor";
   doc["value"] = value;
   if (unit && unit[0] != '\0')
@@ -140,7 +330,8 @@ bool SentientMQTT::publishSensor(const char *name, float value, const char *unit
 
 bool SentientMQTT::publishMetric(const char *name, float value, const char *unit)
 {
-  DynamicJsonDocument doc(_config.publishJsonCapacity);
+  JsonDocument &doc = _publishDoc;
+  doc.clear();
   doc["name"] = name ? name : "metric";
   doc["value"] = value;
   if (unit && unit[0] != '\0')
@@ -148,12 +339,14 @@ bool SentientMQTT::publishMetric(const char *name, float value, const char *unit
     doc["unit"] = unit;
   }
   doc["timestamp"] = secondsSinceBoot();
-  return publishJson("metrics", name, doc);
+  const char *topic = buildTopic("metrics", name);
+  return topic && publishDocument(topic, doc, false, QueuePolicy::Coalesce);
 }
 
 bool SentientMQTT::publishState(const char *state)
 {
-  DynamicJsonDocument doc(_config.publishJsonCapacity);
+  JsonDocument &doc = _publishDoc;
+  doc.clear();
   doc["state"] = state ? state : "unknown";
   doc["timestamp"] = secondsSinceBoot();
   if (_config.deviceId)
@@ -165,7 +358,27 @@ bool SentientMQTT::publishState(const char *state)
 
 bool SentientMQTT::publishState(const char *state, const JsonDocument &extras)
 {
-  DynamicJsonDocument doc(_config.publishJsonCapacity);
+  JsonDocument &doc = _publishDoc;
+  if (&extras == &_publishDoc)
+  {
+    // Extras built in scratchDocument() are already in place; add the
+    // standard fields around them without overriding any the caller set
+    if (doc["state"].isNull())
+    {
+      doc["state"] = state ? state : "unknown";
+    }
+    if (doc["timestamp"].isNull())
+    {
+      doc["timestamp"] = secondsSinceBoot();
+    }
+    if (_config.deviceId && doc["deviceId"].isNull())
+    {
+      doc["deviceId"] = _config.deviceId;
+    }
+    return publishJson("status", "state", doc, false);
+  }
+
+  doc.clear();
   doc["state"] = state ? state : "unknown";
   doc["timestamp"] = secondsSinceBoot();
   if (_config.deviceId)
@@ -189,24 +402,77 @@ bool SentientMQTT::publishEvent(const char *eventName, const JsonDocument &paylo
 
 bool SentientMQTT::publishJson(const char *category, const char *item, const JsonDocument &payload, bool retain)
 {
-  String topic = buildTopic(category, item);
-  String message;
-  serializeJson(payload, message);
-  return publishRaw(topic, message.c_str(), retain);
+  const char *topic = buildTopic(category, item);
+  if (!topic)
+  {
+    return false;
+  }
+  return publishDocument(topic, payload, retain, policyFor(category, retain));
+}
+
+bool SentientMQTT::publishJson(const char *category, const char *device, const char *item, const JsonDocument &payload, bool retain)
+{
+  const char *topic = buildTopic(category, device, item);
+  if (!topic)
+  {
+    return false;
+  }
+  return publishDocument(topic, payload, retain, policyFor(category, retain));
 }
 
 bool SentientMQTT::publishText(const char *category, const char *item, const char *payload, bool retain)
 {
-  String topic = buildTopic(category, item);
+  const char *topic = buildTopic(category, item);
+  if (!topic)
+  {
+    return false;
+  }
   const char *safePayload = (payload && payload[0] != '\0') ? payload : "";
-  return publishRaw(topic, safePayload, retain);
+  return publishRaw(topic, safePayload, retain, policyFor(category, retain));
+}
+
+bool SentientMQTT::publishTopic(const char *topic, const char *payload, bool retain)
+{
+  if (!topic || topic[0] == '\0')
+  {
+    return false;
+  }
+  return publishRaw(topic, payload, retain, policyFor(nullptr, retain));
+}
+
+bool SentientMQTT::beginPublish(const char *topic, size_t payloadLength, bool retain)
+{
+  _publishFailed = false;
+  return topic && _mqttClient.connected() && sendRoomFor(topic, payloadLength) &&
+         _mqttClient.beginPublish(topic, payloadLength, retain);
+}
+
+bool SentientMQTT::writePayload(const uint8_t *data, size_t length)
+{
+  if (!_publishFailed && _mqttClient.write(data, length) != length)
+  {
+    _publishFailed = true;
+  }
+  return !_publishFailed;
+}
+
+bool SentientMQTT::endPublish()
+{
+  if (_mqttClient.endPublish() == 1 && !_publishFailed)
+  {
+    return true;
+  }
+  abortPublish();
+  return false;
 }
 
 bool SentientMQTT::publishHeartbeat()
 {
-  DynamicJsonDocument doc(_config.publishJsonCapacity);
+  JsonDocument &doc = _publishDoc;
+  doc.clear();
 
-  // If custom heartbeat builder is provided, use ONLY its output (stateless minimal heartbeat)
+  // If custom heartbeat builder is provided, use ONLY its output (stateless minimal heartbeat),
+  // plus the memory summary when heartbeatMemory is on
   if (_heartbeatBuilder)
   {
     if (!_heartbeatBuilder(doc, _heartbeatContext))
@@ -218,6 +484,10 @@ bool SentientMQTT::publishHeartbeat()
   {
     // Default heartbeat (legacy - for backward compatibility)
     doc["timestamp"] = secondsSinceBoot();
+    if (_clock.synced())
+    {
+      doc["epoch_ms"] = static_cast<double>(_clock.epochMillis());
+    }
     doc["state"] = _mqttClient.connected() ? "online" : "disconnected";
     if (_config.deviceId)
     {
@@ -234,12 +504,19 @@ bool SentientMQTT::publishHeartbeat()
     }
   }
 
+  if (_config.heartbeatMemory)
+  {
+    SentientMemory::addTo(doc["mem"].to<JsonObject>());
+  }
+
   return publishHeartbeat(doc);
 }
 
 bool SentientMQTT::publishHeartbeat(const JsonDocument &payload)
 {
-  bool ok = publishJson("status", "heartbeat", payload, false);
+  // Heartbeats are never queued: a late one would only misreport liveness
+  const char *topic = buildTopic("status", "heartbeat");
+  bool ok = topic && publishDocument(topic, payload, false, QueuePolicy::Drop);
   if (ok)
   {
     _lastHeartbeat = millis();
@@ -247,6 +524,30 @@ bool SentientMQTT::publishHeartbeat(const JsonDocument &payload)
   return ok;
 }
 
+JsonDocument &SentientMQTT::scratchDocument()
+{
+  _publishDoc.clear();
+  return _publishDoc;
+}
+
+bool SentientMQTT::onCommand(const char *deviceId, const char *command, SentientRouteHandler handler, void *context)
+{
+  return _router.add(deviceId, command, handler, context);
+}
+
+size_t SentientMQTT::onCommands(const char *deviceId, const char *const *commands, size_t count, SentientRouteHandler handler, void *context)
+{
+  size_t added = 0;
+  for (size_t i = 0; commands && i < count; ++i)
+  {
+    if (_router.add(deviceId, commands[i], handler, context, static_cast<uint8_t>(i)))
+    {
+      added++;
+    }
+  }
+  return added;
+}
+
 void SentientMQTT::setCommandCallback(SentientCommandCallback callback, void *context)
 {
   _commandCallback = callback;
@@ -359,6 +660,12 @@ bool SentientMQTT::configureNetwork()
   Serial.print(F("[SentientMQTT] Ethernet up, IP="));
   Serial.println(Ethernet.localIP());
 
+#if defined(__IMXRT1062__)
+  // Start the MAC's RMON counters (clear MIB_DIS): idle() watches the
+  // received-frame count to tell a network wake from any other interrupt
+  ENET_MIBC = 0;
+#endif
+
   // Initialize mDNS for network identification
   if (_config.displayName && _config.displayName[0] != '\0')
   {
@@ -424,233 +731,846 @@ bool SentientMQTT::configureNetwork()
 
 void SentientMQTT::ensureConnected()
 {
-  if (_mqttClient.connected())
+  if (_phase == ConnectPhase::Online)
   {
-    if (!_wasConnected)
+    if (_mqttClient.connected())
     {
-      _wasConnected = true;
-      if (_onConnect)
+      return;
+    }
+
+    Serial.println(F("[SentientMQTT] Broker connection lost"));
+    _networkClient.stop();
+    if (_onDisconnect)
+    {
+      _onDisconnect(_onDisconnectContext);
+    }
+    _failedAttempts = 0;
+    scheduleReconnect();
+    enterPhase(ConnectPhase::Idle);
+    return;
+  }
+
+  stepConnection();
+}
+
+void SentientMQTT::stepConnection()
+{
+  // One bounded step per call: a dead broker costs loop() a socket poll, never
+  // a TCP or CONNACK timeout.
+  switch (_phase)
+  {
+  case ConnectPhase::Idle:
+    if (millis() - _retryStartedAt >= _retryDelayMs)
+    {
+      enterPhase(ConnectPhase::Resolving);
+    }
+    return;
+
+  case ConnectPhase::Resolving:
+    if (!_brokerResolved)
+    {
+#if defined(ESP32)
+      _brokerResolved = WiFi.hostByName(_config.brokerHost, _brokerAddress) == 1;
+#else
+      // The only step that can wait: bounded, cached after the first success,
+      // and skipped entirely when brokerIp is configured.
+      DNSClient dns;
+      dns.begin(Ethernet.dnsServerIP());
+      _brokerResolved = dns.getHostByName(_config.brokerHost, _brokerAddress, SENTIENT_MQTT_DNS_TIMEOUT_MS) == 1;
+#endif
+      if (!_brokerResolved)
+      {
+        failConnection(F("DNS lookup failed"));
+        return;
+      }
+    }
+
+    buildClientId();
+    Serial.print(F("[SentientMQTT] Connecting to broker "));
+    Serial.print(_brokerAddress);
+    Serial.print(F(":"));
+    Serial.print(_config.brokerPort);
+    Serial.print(F(" as "));
+    Serial.println(_clientId);
+
+#if defined(ESP32)
+    // WiFiClient has no split connect; bound the handshake instead
+    if (!_networkClient.connect(_brokerAddress, _config.brokerPort, _config.connectTimeoutMs))
+#else
+    if (!_networkClient.beginConnect(_brokerAddress, _config.brokerPort))
+#endif
+    {
+      failConnection(F("TCP connect failed"));
+      return;
+    }
+    enterPhase(ConnectPhase::TcpConnecting);
+    return;
+
+  case ConnectPhase::TcpConnecting:
+#if !defined(ESP32)
+    switch (_networkClient.pollConnect())
+    {
+    case SentientSocketClient::ConnectStatus::Connected:
+      break;
+    case SentientSocketClient::ConnectStatus::Pending:
+      if (phaseTimedOut())
       {
-        _onConnect(_onConnectContext);
+        failConnection(F("TCP connect timed out"));
       }
-      String onlinePayload = buildConnectionPayload("online");
-      publishRaw(buildTopic("status", "connection"), onlinePayload.c_str(), false);
+      return;
+    default:
+      failConnection(F("TCP connect refused"));
+      return;
     }
+#endif
+    enterPhase(ConnectPhase::SendingConnect);
+    return;
+
+  case ConnectPhase::SendingConnect:
+#if defined(ESP32)
+  {
+    // PubSubClient skips its own TCP connect on an open socket, so this only
+    // waits for the CONNACK round trip.
+    const bool withCredentials = _config.username && _config.password;
+    const bool connected = withCredentials
+                               ? _mqttClient.connect(_clientId, _config.username, _config.password)
+                               : _mqttClient.connect(_clientId);
+    if (!connected)
+    {
+      failConnection(F("CONNACK not received"));
+      return;
+    }
+    enterPhase(ConnectPhase::Subscribing);
     return;
   }
+#else
+    if (!sendConnectPacket())
+    {
+      failConnection(F("CONNECT write failed"));
+      return;
+    }
+    enterPhase(ConnectPhase::AwaitingConnack);
+    return;
+#endif
 
-  if (_wasConnected)
+  case ConnectPhase::AwaitingConnack:
+#if !defined(ESP32)
   {
-    _wasConnected = false;
-    if (_onDisconnect)
+    uint8_t connack[4];
+    if (_networkClient.peekBytes(connack, sizeof(connack)) < sizeof(connack))
     {
-      _onDisconnect(_onDisconnectContext);
+      if (!_networkClient.connected())
+      {
+        failConnection(F("broker closed the connection"));
+      }
+      else if (phaseTimedOut())
+      {
+        failConnection(F("CONNACK timed out"));
+      }
+      return;
     }
+
+    if (connack[0] != (MQTTCONNACK) || connack[3] != 0)
+    {
+      Serial.print(F("[SentientMQTT] Broker refused connection, rc="));
+      Serial.println(connack[3]);
+      failConnection(F("CONNACK rejected"));
+      return;
+    }
+
+    // Hand the session to PubSubClient. The socket is already open, so it skips
+    // the TCP connect; its replayed CONNECT is discarded and it reads the CONNACK
+    // that is already buffered, so this returns without waiting.
+    const bool withCredentials = _config.username && _config.password;
+    _networkClient.setDiscardWrites(true);
+    const bool adopted = withCredentials
+                             ? _mqttClient.connect(_clientId, _config.username, _config.password)
+                             : _mqttClient.connect(_clientId);
+    _networkClient.setDiscardWrites(false);
+    if (!adopted)
+    {
+      failConnection(F("session handoff failed"));
+      return;
+    }
+    enterPhase(ConnectPhase::Subscribing);
   }
+#endif
+    return;
 
-  const unsigned long now = millis();
-  if (now - _lastConnectAttempt < _config.reconnectDelayMs)
+  case ConnectPhase::Subscribing:
   {
+    if (!_mqttClient.connected())
+    {
+      failConnection(F("connection dropped before subscribe"));
+      return;
+    }
+
+    // Canonical structure: [namespace]/[room]/commands/[controller_id]/[device_id]/[specific_command]
+    // Subscribe with wildcard for any device on this controller: [namespace]/[room]/commands/[controller_id]/#
+    char topic[SENTIENT_MQTT_MAX_TOPIC_LENGTH];
+    snprintf(topic, sizeof(topic), "%s#", _commandPrefix);
+
+    if (!_mqttClient.subscribe(topic))
+    {
+      failConnection(F("subscribe failed"));
+      return;
+    }
+    Serial.println(F("[SentientMQTT] Broker connected"));
+    Serial.print(F("[SentientMQTT] Subscribed to commands: "));
+    Serial.println(topic);
+
+    if (!_offlineQueue.empty())
+    {
+      Serial.print(F("[SentientMQTT] Replaying "));
+      Serial.print(_offlineQueue.depth());
+      Serial.println(F(" queued messages"));
+    }
+
+    _failedAttempts = 0;
+    enterPhase(ConnectPhase::Online);
+    _lastHeartbeat = millis();
+    if (_onConnect)
+    {
+      _onConnect(_onConnectContext);
+    }
+    publishConnectionState("online");
     return;
   }
-  _lastConnectAttempt = now;
-
-  String clientId = buildClientId();
-  String willTopic = buildTopic("status", "connection");
-  String willPayload = buildConnectionPayload("offline");
-
-  // Debug output for connection attempt
-  Serial.println(F("\n[SentientMQTT] Attempting broker connection:"));
-  Serial.print(F("  Client ID: "));
-  Serial.println(clientId);
-  Serial.print(F("  Will Topic: "));
-  Serial.println(willTopic);
-  Serial.print(F("  Will Topic Length: "));
-  Serial.println(willTopic.length());
-  Serial.print(F("  Will Payload: "));
-  Serial.println(willPayload);
-  Serial.print(F("  Will Payload Length: "));
-  Serial.println(willPayload.length());
-  Serial.print(F("  Username: "));
-  Serial.println(_config.username ? _config.username : "null");
-  Serial.print(F("  Password: "));
-  Serial.println(_config.password ? "***SET***" : "null");
-
-  bool connected = false;
-
-  // TEMPORARY: Try connecting WITHOUT Will message to isolate the issue
-  Serial.println(F("[SentientMQTT] DEBUG: Connecting WITHOUT Will message"));
-  if (_config.username && _config.password)
-  {
-    connected = _mqttClient.connect(clientId.c_str(), _config.username, _config.password);
+
+  case ConnectPhase::Online:
+    return;
   }
-  else
+}
+
+#if !defined(ESP32)
+bool SentientMQTT::sendConnectPacket()
+{
+  // MQTT 3.1.1 CONNECT with clean session and no Will, the same packet
+  // PubSubClient::connect() builds. The body starts after room for the
+  // fixed header so the whole packet goes out in one write.
+  uint8_t packet[SENTIENT_MQTT_CONNECT_PACKET_BYTES];
+  const size_t headerRoom = 3;
+  size_t length = headerRoom;
+
+  static const uint8_t protocol[] = {0x00, 0x04, 'M', 'Q', 'T', 'T', 0x04};
+  memcpy(packet + length, protocol, sizeof(protocol));
+  length += sizeof(protocol);
+
+  const bool withCredentials = _config.username && _config.password;
+  packet[length++] = withCredentials ? 0xC2 : 0x02;
+  packet[length++] = static_cast<uint8_t>(_config.keepAliveSeconds >> 8);
+  packet[length++] = static_cast<uint8_t>(_config.keepAliveSeconds & 0xFF);
+
+  if (!appendMqttString(packet, length, sizeof(packet), _clientId) ||
+      (withCredentials && (!appendMqttString(packet, length, sizeof(packet), _config.username) ||
+                           !appendMqttString(packet, length, sizeof(packet), _config.password))))
   {
-    connected = _mqttClient.connect(clientId.c_str());
+    Serial.println(F("[SentientMQTT] CONNECT packet exceeds SENTIENT_MQTT_CONNECT_PACKET_BYTES"));
+    return false;
   }
 
-  if (!connected)
+  // Fixed header: type byte plus 1-2 byte remaining length, right-aligned before the body
+  size_t remaining = length - headerRoom;
+  uint8_t remainingLength[2];
+  size_t remainingBytes = 0;
+  do
+  {
+    uint8_t digit = remaining % 128;
+    remaining /= 128;
+    if (remaining > 0)
+    {
+      digit |= 0x80;
+    }
+    remainingLength[remainingBytes++] = digit;
+  } while (remaining > 0 && remainingBytes < sizeof(remainingLength));
+
+  const size_t start = headerRoom - 1 - remainingBytes;
+  packet[start] = MQTTCONNECT;
+  memcpy(packet + start + 1, remainingLength, remainingBytes);
+
+  const size_t packetLength = length - start;
+  return _networkClient.write(packet + start, packetLength) == packetLength;
+}
+#endif
+
+void SentientMQTT::enterPhase(ConnectPhase phase)
+{
+  _phase = phase;
+  _phaseStartedAt = millis();
+}
+
+bool SentientMQTT::phaseTimedOut() const
+{
+  return millis() - _phaseStartedAt >= _config.connectTimeoutMs;
+}
+
+void SentientMQTT::failConnection(const __FlashStringHelper *reason)
+{
+  _networkClient.stop();
+  if (_failedAttempts < UINT8_MAX)
+  {
+    _failedAttempts++;
+  }
+  scheduleReconnect();
+  enterPhase(ConnectPhase::Idle);
+
+  Serial.print(F("[SentientMQTT] Broker connect failed ("));
+  Serial.print(reason);
+  Serial.print(F("), retry in "));
+  Serial.print(_retryDelayMs);
+  Serial.println(F(" ms"));
+}
+
+void SentientMQTT::scheduleReconnect()
+{
+  // Exponential backoff with equal jitter: the step doubles per failed attempt
+  // up to the ceiling and the actual delay is a random 50-100% of it, so
+  // controllers that lost the broker together do not reconnect in lockstep.
+  const uint32_t ceiling = _config.reconnectBackoffMaxMs > 0 ? _config.reconnectBackoffMaxMs : 1;
+  uint32_t step = _config.reconnectBackoffMinMs > 0 ? _config.reconnectBackoffMinMs : 1;
+  for (uint8_t attempt = 1; attempt < _failedAttempts && step < ceiling; ++attempt)
+  {
+    step = step > ceiling / 2 ? ceiling : step * 2;
+  }
+  if (step > ceiling)
+  {
+    step = ceiling;
+  }
+
+  const uint32_t half = step / 2;
+  _retryDelayMs = half + nextJitter() % (step - half + 1);
+  _retryStartedAt = millis();
+}
+
+uint32_t SentientMQTT::nextJitter()
+{
+  // xorshift32; seeded per controller in begin()
+  uint32_t x = _jitterState;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  _jitterState = x;
+  return x;
+}
+
+void SentientMQTT::handleIncoming(char *topic, uint8_t *payload, unsigned int length)
+{
+  // Only topics under our own command prefix are commands
+  if (strncmp(topic, _commandPrefix, _commandPrefixLength) != 0)
+  {
+    return;
+  }
+  const char *rest = topic + _commandPrefixLength;
+  parseCommandPayload(reinterpret_cast<const char *>(payload), length);
+  if (scheduleCommand(rest, payload, length))
+  {
+    return;
+  }
+  dispatchCommand(rest);
+}
+
+void SentientMQTT::parseCommandPayload(const char *payload, size_t length)
+{
+  // Parse straight from the caller's buffer into the command arena;
+  // non-JSON payloads are exposed as {"value": "<raw text>"}
+  _commandDoc.clear();
+  DeserializationError error = deserializeJson(_commandDoc, payload, length);
+  if (error)
+  {
+    _commandDoc.clear();
+    _commandDoc["value"] = JsonString(payload, length);
+  }
+}
+
+bool SentientMQTT::scheduleCommand(const char *rest, const uint8_t *payload, size_t length)
+{
+  JsonVariantConst executeAt = _commandDoc["execute_at"];
+  if (!executeAt.is<double>())
+  {
+    return false;
+  }
+  if (!_clock.synced())
+  {
+    // Better on arrival than never; the count shows the alignment was lost
+    ++_scheduledUnsynced;
+    return false;
+  }
+
+  // Unix ms as a double keeps microseconds exact well past 2100
+  const uint64_t dueLocal = _clock.epochToLocal(static_cast<uint64_t>(executeAt.as<double>() * 1000.0));
+  if (static_cast<int64_t>(dueLocal - _clock.localMicros()) <= 0)
+  {
+    recordSkew(dueLocal);
+    return false;
+  }
+  if (!_schedule.add(dueLocal, rest, payload, length))
+  {
+    Serial.println(F("[SentientMQTT] Command schedule full; running now"));
+    return false;
+  }
+  return true;
+}
+
+void SentientMQTT::dispatchCommand(const char *rest)
+{
+  // Split [device]/[command] without copying; _commandDoc holds the payload
+  SentientCommand command;
+  const char *slash = strchr(rest, '/');
+  if (slash)
+  {
+    command.device = {rest, static_cast<size_t>(slash - rest)};
+    rest = slash + 1;
+  }
+  command.command = {rest, strlen(rest)};
+  if (command.command.empty() || command.command.equals("#"))
   {
-    Serial.print(F("[SentientMQTT] Broker connect failed, rc="));
-    Serial.println(_mqttClient.state());
     return;
   }
 
-  Serial.println(F("[SentientMQTT] Broker connected"));
+  if (_router.dispatch(command, _commandDoc))
+  {
+    return;
+  }
+  if (!_commandCallback)
+  {
+    return;
+  }
 
-  // Subscribe to commands for this controller
-  // Canonical structure: [namespace]/[room]/commands/[controller_id]/[device_id]/[specific_command]
-  // Subscribe with wildcard for any device on this controller: [namespace]/[room]/commands/[controller_id]/#
+  // Legacy handlers read the target device from the payload; fill it in from
+  // the topic when the sender left it out
+  if (!command.device.empty() && _commandDoc.is<JsonObject>() && !_commandDoc["device_id"].is<const char *>())
   {
-    String topic;
-    // namespace
-    topic += (_config.namespaceId && _config.namespaceId[0] != '\0') ? _config.namespaceId : "paragon";
-    topic += '/';
-    // room
-    if (_config.roomId && _config.roomId[0] != '\0')
+    _commandDoc["device_id"] = JsonString(command.device.data, command.device.length);
+  }
+
+  // Legacy callbacks take the last topic segment as the command name
+  const char *lastSlash = strrchr(command.command.data, '/');
+  _commandCallback(lastSlash ? lastSlash + 1 : command.command.data, _commandDoc, _commandContext);
+}
+
+void SentientMQTT::serviceClock()
+{
+  if (!_config.syncClock)
+  {
+    return;
+  }
+  if (!_clock.started())
+  {
+    // Wait for an address: the broker's is only known once it resolves
+    if (isValidIp(_config.timeServer))
     {
-      topic += _config.roomId;
+      _clock.begin(_config.timeServer, _config.timeServerPort, _config.clockPollIntervalMs);
     }
-    topic += "/commands/";
-    // controller (controllerId)
-    if (_config.controllerId && _config.controllerId[0] != '\0')
+    else if (_brokerResolved)
     {
-      topic += _config.controllerId;
+      _clock.begin(_brokerAddress, _config.timeServerPort, _config.clockPollIntervalMs);
     }
-    topic += "/#";
+  }
+  _clock.service();
 
-    _mqttClient.subscribe(topic.c_str());
-    Serial.print(F("[SentientMQTT] Subscribed to commands: "));
-    Serial.println(topic);
+  if (_config.clockReportIntervalMs > 0 && _clock.synced() && _mqttClient.connected() &&
+      millis() - _lastClockReport >= _config.clockReportIntervalMs)
+  {
+    publishClockStatus();
   }
+}
 
-  if (_onConnect)
+void SentientMQTT::serviceSchedule()
+{
+  SentientCommandSchedule::Entry *entry = _schedule.next();
+  if (!entry || static_cast<int64_t>(entry->dueLocalMicros - _clock.localMicros()) > _config.scheduleLeadUs)
   {
-    _onConnect(_onConnectContext);
+    return;
   }
 
-  _wasConnected = true;
-  _lastHeartbeat = millis();
-  publishRaw(willTopic, buildConnectionPayload("online").c_str(), false);
+  // Parse ahead, then wait out the last stretch so the handler starts on
+  // the instant rather than whenever loop() comes round
+  parseCommandPayload(entry->payload, entry->payloadLength);
+  while (static_cast<int64_t>(entry->dueLocalMicros - _clock.localMicros()) > 0)
+  {
+  }
+  recordSkew(entry->dueLocalMicros);
+  dispatchCommand(entry->topic);
+  _schedule.remove(entry);
 }
 
-void SentientMQTT::handleIncoming(char *topic, uint8_t *payload, unsigned int length)
+void SentientMQTT::recordSkew(uint64_t dueLocalMicros)
 {
-  if (!_commandCallback)
+  const int64_t skew = static_cast<int64_t>(_clock.localMicros() - dueLocalMicros);
+  _lastSkewUs = skew > INT32_MAX ? INT32_MAX : static_cast<int32_t>(skew);
+  if (_lastSkewUs > _maxSkewUs)
   {
-    return;
+    _maxSkewUs = _lastSkewUs;
+  }
+  if (_lastSkewUs > SENTIENT_MQTT_SCHEDULE_LATE_US)
+  {
+    ++_scheduledLate;
   }
+  ++_scheduledRun;
+}
+
+bool SentientMQTT::publishClockStatus()
+{
+  JsonDocument &doc = _publishDoc;
+  doc.clear();
+  doc["synced"] = _clock.synced();
+  doc["epoch_ms"] = static_cast<double>(_clock.epochMillis());
+  doc["timestamp"] = secondsSinceBoot();
+  const int64_t offset = _clock.lastOffsetMicros();
+  doc["offset_us"] = offset > INT32_MAX ? INT32_MAX : (offset < INT32_MIN ? INT32_MIN : static_cast<int32_t>(offset));
+  doc["error_us"] = _clock.errorMicros();
+  doc["round_trip_us"] = _clock.roundTripMicros();
+  doc["drift_ppm"] = _clock.driftPpm();
+  doc["samples"] = _clock.samples();
+  doc["timeouts"] = _clock.timeouts();
+
+  // Cross-controller skew is at most the dispatch skew plus each clock's error
+  JsonObject schedule = doc["schedule"].to<JsonObject>();
+  schedule["run"] = _scheduledRun;
+  schedule["late"] = _scheduledLate;
+  schedule["unsynced"] = _scheduledUnsynced;
+  schedule["pending"] = _schedule.depth();
+  schedule["rejected"] = _schedule.rejected();
+  schedule["last_skew_us"] = _lastSkewUs;
+  schedule["max_skew_us"] = _maxSkewUs;
+
+  _lastClockReport = millis();
+  return publishJson("status", "clock", doc);
+}
 
-  const char *lastSlash = strrchr(topic, '/');
-  const char *commandStart = lastSlash ? lastSlash + 1 : topic;
-  if (commandStart[0] == '\0' || strcmp(commandStart, "#") == 0)
+void SentientMQTT::idle(uint32_t maxWaitMs)
+{
+  if (!_idleUsed)
   {
-    return;
+    _idleUsed = true;
+    _idleWindowStart = _clock.localMicros();
+    _lastIdleReport = millis();
   }
 
-  DynamicJsonDocument doc(_config.commandJsonCapacity);
-  const size_t bufferSize = static_cast<size_t>(length) + 1;
-  char *buffer = new (std::nothrow) char[bufferSize];
-  if (!buffer)
+  const uint32_t budgetUs = idleBudgetUs(maxWaitMs);
+  if (budgetUs == 0)
   {
-    Serial.println(F("[SentientMQTT] command buffer allocation failed"));
     return;
   }
-  memcpy(buffer, payload, length);
-  buffer[length] = '\0';
 
-  DeserializationError error = deserializeJson(doc, buffer);
-  if (error)
+  const uint32_t started = micros();
+  const uint32_t framesBefore = networkFrames();
+  uint32_t *reason = &_wakeDeadline;
+  while (micros() - started < budgetUs)
   {
-    doc.clear();
-    doc["value"] = buffer;
+    // Bytes can already be waiting in the socket from before the sleep
+    if (networkFrames() != framesBefore || _networkClient.available() > 0)
+    {
+      reason = &_wakeNetwork;
+      break;
+    }
+#if defined(__IMXRT1062__)
+    // Flags are checked with interrupts masked so one set just before the
+    // WFI still wakes it: a pending interrupt ends WFI even while masked.
+    // In RUN mode (Teensy's default) WFI only stops the core; the cycle
+    // counter and micros() keep time.
+    noInterrupts();
+    const bool flagged = _wakeRequested || s_pinWake;
+    if (!flagged)
+    {
+      __asm__ volatile("wfi");
+    }
+    interrupts();
+#else
+    const bool flagged = _wakeRequested || s_pinWake;
+    if (!flagged)
+    {
+      delay(1);
+    }
+#endif
+    if (flagged)
+    {
+      reason = s_pinWake ? &_wakePin : &_wakeRequests;
+      break;
+    }
   }
-
-  _commandCallback(commandStart, doc, _commandContext);
-  delete[] buffer;
+  ++*reason;
+  _wakeRequested = false;
+  s_pinWake = false;
+  _idleMicros += micros() - started;
 }
 
-bool SentientMQTT::publishRaw(const String &topic, const char *payload, bool retain)
+bool SentientMQTT::wakeOnPin(uint8_t pin, int mode)
 {
-  ensureConnected();
-  if (!_mqttClient.connected())
+  if (_wakePinCount >= SENTIENT_MQTT_WAKE_PINS)
   {
+    Serial.println(F("[SentientMQTT] Too many wake pins (raise SENTIENT_MQTT_WAKE_PINS)"));
     return false;
   }
+  attachInterrupt(digitalPinToInterrupt(pin), pinWakeThunk, mode);
+  ++_wakePinCount;
+  return true;
+}
+
+void SentientMQTT::pinWakeThunk()
+{
+  s_pinWake = true;
+}
+
+uint32_t SentientMQTT::idleBudgetUs(uint32_t maxWaitMs)
+{
+  // Everything loop() does on a timer bounds the sleep; incoming frames and
+  // pins end it early
+  uint32_t budgetMs = maxWaitMs;
+  auto cap = [&budgetMs](uint32_t ms) {
+    if (ms < budgetMs)
+    {
+      budgetMs = ms;
+    }
+  };
+  auto remaining = [](unsigned long last, uint32_t interval) -> uint32_t {
+    const uint32_t elapsed = millis() - last;
+    return elapsed >= interval ? 0 : interval - elapsed;
+  };
+
+  const bool connected = _mqttClient.connected();
+  if (!connected)
+  {
+    cap(SENTIENT_MQTT_IDLE_OFFLINE_MS);
+  }
+  else
+  {
+    cap(_config.keepAliveSeconds * 500UL);
+    if (_config.autoHeartbeat)
+    {
+      cap(remaining(_lastHeartbeat, _config.heartbeatIntervalMs));
+    }
+    if (_offlineQueue.depth() > 0)
+    {
+      cap(remaining(_lastDrain, _config.offlineDrainIntervalMs));
+    }
+    if (_config.clockReportIntervalMs > 0 && _clock.synced())
+    {
+      cap(remaining(_lastClockReport, _config.clockReportIntervalMs));
+    }
+    if (_config.idleReportIntervalMs > 0)
+    {
+      cap(remaining(_lastIdleReport, _config.idleReportIntervalMs));
+    }
+  }
+  if (_config.syncClock)
+  {
+    cap(_clock.started() ? _clock.msUntilDue() : SENTIENT_MQTT_IDLE_OFFLINE_MS);
+  }
+
+  uint64_t budgetUs = (uint64_t)budgetMs * 1000;
+  SentientCommandSchedule::Entry *entry = _schedule.next();
+  if (entry)
+  {
+    // Wake in time for serviceSchedule() to parse ahead of the instant
+    const int64_t untilLead = (int64_t)(entry->dueLocalMicros - _clock.localMicros()) - _config.scheduleLeadUs;
+    budgetUs = untilLead <= 0 ? 0 : ((uint64_t)untilLead < budgetUs ? (uint64_t)untilLead : budgetUs);
+  }
+  return budgetUs > UINT32_MAX ? UINT32_MAX : (uint32_t)budgetUs;
+}
+
+uint32_t SentientMQTT::networkFrames()
+{
+#if defined(__IMXRT1062__)
+  return ENET_RMON_R_PACKETS;
+#else
+  return 0;
+#endif
+}
 
+bool SentientMQTT::publishIdleStatus()
+{
+  const uint64_t now = _clock.localMicros();
+  const uint64_t window = now - _idleWindowStart;
+  if (window > 0)
+  {
+    _idlePercent = (float)(_idleMicros * 100.0 / (double)window);
+  }
+  _idleMicros = 0;
+  _idleWindowStart = now;
+  _lastIdleReport = millis();
+
+  JsonDocument &doc = _publishDoc;
+  doc.clear();
+  doc["idle_pct"] = _idlePercent;
+  doc["timestamp"] = secondsSinceBoot();
+  JsonObject wakes = doc["wakes"].to<JsonObject>();
+  wakes["network"] = _wakeNetwork;
+  wakes["pin"] = _wakePin;
+  wakes["requested"] = _wakeRequests;
+  wakes["deadline"] = _wakeDeadline;
+  return publishJson("status", "idle", doc);
+}
+
+bool SentientMQTT::publishRaw(const char *topic, const char *payload, bool retain, QueuePolicy policy)
+{
   if (!payload)
   {
     payload = "";
   }
+  const size_t length = strlen(payload);
 
-  bool ok = _mqttClient.publish(topic.c_str(), payload, retain);
+  // Never reconnect from the publish path: loop() owns the connection, and the
+  // topic/payload buffers passed in here are shared with the connection messages.
+  // While a backlog is replaying, new messages join the back of it to keep order.
+  if (!_mqttClient.connected() || (policy != QueuePolicy::Drop && !_offlineQueue.empty()))
+  {
+    return policy != QueuePolicy::Drop &&
+           _offlineQueue.push(topic, reinterpret_cast<const uint8_t *>(payload), length, retain,
+                              policy == QueuePolicy::Coalesce);
+  }
+
+  bool ok = sendRoomFor(topic, length) && _mqttClient.publish(topic, payload, retain);
   if (!ok)
   {
     Serial.print(F("[SentientMQTT] publish failed for topic "));
     Serial.print(topic);
     Serial.print(F(" len="));
-    Serial.print(strlen(payload));
+    Serial.print(length);
     Serial.print(F(" buffer="));
     Serial.print(_mqttClient.getBufferSize());
     Serial.print(F(" state="));
     Serial.println(_mqttClient.state());
+    if (policy != QueuePolicy::Drop)
+    {
+      ok = _offlineQueue.push(topic, reinterpret_cast<const uint8_t *>(payload), length, retain,
+                              policy == QueuePolicy::Coalesce);
+    }
   }
   return ok;
 }
 
-String SentientMQTT::buildTopic(const char *category, const char *item) const
+bool SentientMQTT::publishDocument(const char *topic, const JsonDocument &payload, bool retain, QueuePolicy policy)
 {
-  String topic;
-  topic.reserve(96);
+  if (payload.overflowed())
+  {
+    Serial.print(F("[SentientMQTT] payload overflowed publish arena for topic "));
+    Serial.println(topic);
+    return false;
+  }
 
-  auto appendSegment = [&topic](const char *segment)
+  if (!_mqttClient.connected() || (policy != QueuePolicy::Drop && !_offlineQueue.empty()))
   {
-    if (!segment || segment[0] == '\0')
-    {
-      return;
-    }
-    if (topic.length() > 0 && topic[topic.length() - 1] != '/')
-    {
-      topic += '/';
-    }
-    topic += segment;
-  };
+    return enqueueDocument(topic, payload, retain, policy);
+  }
+
+  // Stream straight into the socket: header first, then serializer output in chunks
+  const size_t length = measureJson(payload);
+  if (!sendRoomFor(topic, length))
+  {
+    // Send queue backed up (burst or dead peer): queue now instead of waiting on it
+    return enqueueDocument(topic, payload, retain, policy);
+  }
+  if (!_mqttClient.beginPublish(topic, length, retain))
+  {
+    Serial.print(F("[SentientMQTT] publish failed for topic "));
+    Serial.print(topic);
+    Serial.print(F(" len="));
+    Serial.print(length);
+    Serial.print(F(" state="));
+    Serial.println(_mqttClient.state());
+    return enqueueDocument(topic, payload, retain, policy);
+  }
+
+  MqttChunkWriter writer(_mqttClient);
+  serializeJson(payload, writer);
+  writer.flush();
+  if (_mqttClient.endPublish() == 1 && writer.ok())
+  {
+    return true;
+  }
+  abortPublish();
+  return enqueueDocument(topic, payload, retain, policy);
+}
 
-  // New topic structure: [namespace]/[room]/[category]/[controller_id]/[device_id]/[item]
-  appendSegment(_config.namespaceId ? _config.namespaceId : "paragon");
-  appendSegment(_config.roomId);
-  appendSegment(category);
-  appendSegment(_config.controllerId);
-  appendSegment(_config.deviceId);
-  appendSegment(item);
+bool SentientMQTT::enqueueDocument(const char *topic, const JsonDocument &payload, bool retain, QueuePolicy policy)
+{
+  if (policy == QueuePolicy::Drop || !_offlineQueue.enabled())
+  {
+    return false;
+  }
 
-  return topic;
+  // Serialize straight into the ring buffer record
+  const size_t length = measureJson(payload);
+  uint8_t *buffer = _offlineQueue.reserve(topic, length, retain, policy == QueuePolicy::Coalesce);
+  if (!buffer)
+  {
+    return false;
+  }
+  serializeJson(payload, reinterpret_cast<char *>(buffer), length + 1);
+  _offlineQueue.commit();
+  return true;
 }
 
-String SentientMQTT::buildClientId() const
+bool SentientMQTT::sendRoomFor(const char *topic, size_t payloadLength)
 {
-  String clientId;
-  // Use controllerId (controller_id) for client ID, not deviceId
-  if (_config.controllerId)
+#if defined(ESP32)
+  (void)topic;
+  (void)payloadLength;
+  return true;
+#else
+  // Fixed header (type and up to four length bytes), topic length, topic, payload
+  return _networkClient.hasRoomFor(5 + 2 + strlen(topic) + payloadLength);
+#endif
+}
+
+void SentientMQTT::abortPublish()
+{
+  // The header went out but not the whole payload. The broker would read the
+  // next packet as the rest of this one, so the connection has to go.
+  Serial.println(F("[SentientMQTT] publish cut short; dropping the connection"));
+  _networkClient.stop();
+}
+
+void SentientMQTT::drainOfflineQueue()
+{
+  if (_offlineQueue.empty() || _phase != ConnectPhase::Online)
   {
-    clientId += _config.controllerId;
+    return;
   }
-  else if (_config.deviceId)
+
+  const unsigned long now = millis();
+  if (now - _lastDrain < _config.offlineDrainIntervalMs)
   {
-    clientId += _config.deviceId;
+    return;
   }
-  else
+  _lastDrain = now;
+
+  SentientOfflineQueue::Message message;
+  for (uint8_t sent = 0; sent < _config.offlineDrainBurst && _offlineQueue.front(message); ++sent)
+  {
+    // Streamed so replay is not limited by the PubSubClient buffer size.
+    // A failed send stays at the head for the next tick (at-least-once).
+    if (!sendRoomFor(message.topic, message.payloadLength) ||
+        !_mqttClient.beginPublish(message.topic, message.payloadLength, message.retain))
+    {
+      return;
+    }
+    if (_mqttClient.write(message.payload, message.payloadLength) != message.payloadLength ||
+        _mqttClient.endPublish() != 1)
+    {
+      abortPublish();
+      return;
+    }
+    _offlineQueue.pop();
+  }
+}
+
+SentientMQTT::QueuePolicy SentientMQTT::policyFor(const char *category, bool retain)
+{
+  // Retained and status messages describe current state, so only the latest
+  // one per topic matters; everything else is an edge or event.
+  if (retain || (category && strcmp(category, "status") == 0))
   {
-    clientId += "controller";
+    return QueuePolicy::Coalesce;
   }
-  clientId += '-';
-  clientId += String(millis() & 0xFFFF, HEX);
-  return clientId;
+  return QueuePolicy::Queue;
 }
 
-String SentientMQTT::buildConnectionPayload(const char *state) const
+bool SentientMQTT::publishConnectionState(const char *state)
 {
-  DynamicJsonDocument doc(_config.publishJsonCapacity);
+  JsonDocument &doc = _publishDoc;
+  doc.clear();
   doc["state"] = state;
   doc["timestamp"] = secondsSinceBoot();
   if (_config.deviceId)
@@ -665,10 +1585,63 @@ String SentientMQTT::buildConnectionPayload(const char *state) const
   {
     doc["controllerId"] = _config.controllerId;
   }
+  return publishDocument(_connectionTopic, doc, false, QueuePolicy::Drop);
+}
+
+void SentientMQTT::cacheTopicSegments()
+{
+  // Topic structure: [namespace]/[room]/[category]/[controller_id]/[device_id]/[item]
+  // Everything except category and item is fixed for the lifetime of the controller.
+  _topicPrefixLength = 0;
+  _topicPrefix[0] = '\0';
+  appendSegment(_topicPrefix, _topicPrefixLength, _config.namespaceId ? _config.namespaceId : "paragon");
+  appendSegment(_topicPrefix, _topicPrefixLength, _config.roomId);
+
+  _topicScopeLength = 0;
+  _topicScope[0] = '\0';
+  appendSegment(_topicScope, _topicScopeLength, _config.controllerId);
+  appendSegment(_topicScope, _topicScopeLength, _config.deviceId);
+
+  _commandPrefixLength = 0;
+  _commandPrefix[0] = '\0';
+  appendSegment(_commandPrefix, _commandPrefixLength,
+                (_config.namespaceId && _config.namespaceId[0] != '\0') ? _config.namespaceId : "paragon");
+  appendSegment(_commandPrefix, _commandPrefixLength, _config.roomId);
+  appendSegment(_commandPrefix, _commandPrefixLength, "commands");
+  appendSegment(_commandPrefix, _commandPrefixLength, _config.controllerId);
+  if (_commandPrefixLength + 1 < sizeof(_commandPrefix))
+  {
+    _commandPrefix[_commandPrefixLength++] = '/';
+    _commandPrefix[_commandPrefixLength] = '\0';
+  }
+
+  const char *connectionTopic = buildTopic("status", "connection");
+  strncpy(_connectionTopic, connectionTopic ? connectionTopic : "", sizeof(_connectionTopic) - 1);
+  _connectionTopic[sizeof(_connectionTopic) - 1] = '\0';
+}
 
-  String payload;
-  serializeJson(doc, payload);
-  return payload;
+const char *SentientMQTT::buildTopic(const char *category, const char *item, const char *subItem)
+{
+  size_t length = _topicPrefixLength;
+  memcpy(_topicBuffer, _topicPrefix, length + 1);
+
+  if (!appendSegment(_topicBuffer, length, category) ||
+      !appendSegment(_topicBuffer, length, _topicScope, _topicScopeLength) ||
+      !appendSegment(_topicBuffer, length, item) ||
+      !appendSegment(_topicBuffer, length, subItem))
+  {
+    Serial.print(F("[SentientMQTT] topic exceeds SENTIENT_MQTT_MAX_TOPIC_LENGTH for item "));
+    Serial.println(item ? item : "");
+    return nullptr;
+  }
+  return _topicBuffer;
+}
+
+void SentientMQTT::buildClientId()
+{
+  // Use controllerId (controller_id) for client ID, not deviceId
+  const char *base = _config.controllerId ? _config.controllerId : (_config.deviceId ? _config.deviceId : "controller");
+  snprintf(_clientId, sizeof(_clientId), "%s-%lx", base, static_cast<unsigned long>(millis() & 0xFFFF));
 }
 
 void SentientMQTT::mqttCallbackThunk(char *topic, uint8_t *payload, unsigned int length)
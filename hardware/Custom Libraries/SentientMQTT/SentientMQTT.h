@@ -12,6 +12,36 @@
 #define MQTT_MAX_TRANSFER_SIZE 512 // Chunk large messages into 512-byte writes to prevent Ethernet buffer overflow
 #endif
 #include <PubSubClient.h>
+#include "SentientArenaAllocator.h"
+#include "SentientClock.h"
+#include "SentientCommandRouter.h"
+#include "SentientCommandSchedule.h"
+#include "SentientMemory.h"
+#include "SentientOfflineQueue.h"
+#include "SentientProfiler.h"
+
+#ifndef SENTIENT_MQTT_MAX_TOPIC_LENGTH
+#define SENTIENT_MQTT_MAX_TOPIC_LENGTH 160 // Fixed topic buffer, sized for namespace/room/category/controller/device/item
+#endif
+#ifndef SENTIENT_MQTT_MIN_ARENA_BYTES
+#define SENTIENT_MQTT_MIN_ARENA_BYTES 2048 // One ArduinoJson variant pool (1 KB on 32-bit) plus string storage
+#endif
+
+#ifndef SENTIENT_MQTT_CONNECT_PACKET_BYTES
+#define SENTIENT_MQTT_CONNECT_PACKET_BYTES 256 // CONNECT built by the reconnect state machine (client id + credentials)
+#endif
+#ifndef SENTIENT_MQTT_SCHEDULE_LATE_US
+#define SENTIENT_MQTT_SCHEDULE_LATE_US 1000 // Scheduled commands dispatched later than this count as late
+#endif
+#ifndef SENTIENT_MQTT_IDLE_OFFLINE_MS
+#define SENTIENT_MQTT_IDLE_OFFLINE_MS 10 // Longest idle() while the reconnect state machine has steps to take
+#endif
+#ifndef SENTIENT_MQTT_WAKE_PINS
+#define SENTIENT_MQTT_WAKE_PINS 8
+#endif
+#ifndef SENTIENT_MQTT_DNS_TIMEOUT_MS
+#define SENTIENT_MQTT_DNS_TIMEOUT_MS 250 // Upper bound for the one-time broker hostname lookup
+#endif
 
 #if defined(ESP32)
 #include <WiFi.h>
@@ -20,7 +50,8 @@
 #include <NativeEthernet.h>
 #include <TeensyID.h>
 #include <fnet.h>
-#define SENTIENT_NETWORK_CLIENT EthernetClient
+#include "SentientSocketClient.h"
+#define SENTIENT_NETWORK_CLIENT SentientSocketClient
 #endif
 
 struct SentientMQTTConfig
@@ -39,12 +70,33 @@ struct SentientMQTTConfig
   const char *hostnamePrefix = nullptr; // Optional prefix for network hostname (e.g., "CL" for Clockwork)
 
   uint16_t keepAliveSeconds = 60;
-  uint32_t reconnectDelayMs = 5'000;
+  uint32_t reconnectBackoffMinMs = 500;    // First retry delay; doubles after every failed attempt
+  uint32_t reconnectBackoffMaxMs = 30'000; // Backoff ceiling; each delay is jittered to 50-100% of the step
+  uint32_t connectTimeoutMs = 3'000;       // Deadline for each connect phase (DNS, TCP handshake, CONNACK)
   uint32_t heartbeatIntervalMs = 5'000;
   bool autoHeartbeat = true;
+  bool heartbeatMemory = true; // Heap, stack and RAM region usage under "mem" in every heartbeat
+
+  uint16_t commandJsonCapacity = 512; // Size of the reusable command arena (raised to SENTIENT_MQTT_MIN_ARENA_BYTES)
+  uint16_t publishJsonCapacity = 512; // Size of the reusable publish arena (raised to SENTIENT_MQTT_MIN_ARENA_BYTES)
+
+  // Messages published while the broker is unreachable are held here and
+  // replayed after reconnect. 0 disables the queue (offline publishes fail).
+  size_t offlineQueueBytes = 4096;
+  void *offlineQueueStorage = nullptr;  // Optional caller buffer of offlineQueueBytes (e.g. an EXTMEM array)
+  uint8_t offlineDrainBurst = 4;        // Messages replayed per drain tick
+  uint16_t offlineDrainIntervalMs = 20; // Spacing between drain ticks so replay never floods the broker or loop()
 
-  uint16_t commandJsonCapacity = 512;
-  uint16_t publishJsonCapacity = 512;
+  // Wall clock disciplined over NTP, and commands held until their
+  // "execute_at" (Unix ms). An unset timeServer uses the broker host.
+  bool syncClock = true;
+  IPAddress timeServer;
+  uint16_t timeServerPort = 123;
+  uint32_t clockPollIntervalMs = 16'000;
+  uint32_t clockReportIntervalMs = 30'000; // status/clock telemetry; 0 disables
+  uint16_t scheduleLeadUs = 2'000;         // Parse a scheduled command this early, then spin to its instant
+
+  uint32_t idleReportIntervalMs = 30'000; // status/idle telemetry once idle() is in use; 0 disables
 
 #if defined(ESP32)
   const char *wifiSsid = nullptr;
@@ -77,35 +129,178 @@ public:
   bool publishState(const char *state, const JsonDocument &extras);
   bool publishEvent(const char *eventName, const JsonDocument &payload);
   bool publishJson(const char *category, const char *item, const JsonDocument &payload, bool retain = false);
+  bool publishJson(const char *category, const char *device, const char *item, const JsonDocument &payload, bool retain = false);
   bool publishText(const char *category, const char *item, const char *payload, bool retain = false);
+  // A topic the caller built in full (acknowledgements, system topics); waits
+  // for send queue room and falls back to the offline queue like the others
+  bool publishTopic(const char *topic, const char *payload, bool retain = false);
   bool publishHeartbeat();
   bool publishHeartbeat(const JsonDocument &payload);
 
+  // Reusable, arena-backed document for building payloads without heap allocation.
+  // Cleared on every call; contents are only valid until the next publish.
+  // Library publishers that build their own payload (publishSensor, publishMetric,
+  // publishHeartbeat, ...) reuse this same document, so fill it only to pass it
+  // straight to publishJson/publishEvent/publishState(state, extras).
+  JsonDocument &scratchDocument();
+
+  // Route [device]/[command] under this controller's command topic to a handler.
+  // Pass an empty deviceId for controller-level commands, or SENTIENT_ANY_DEVICE to
+  // match the command under any device. Routed commands never reach the command
+  // callback, which remains the fallback for everything else.
+  bool onCommand(const char *deviceId, const char *command, SentientRouteHandler handler, void *context = nullptr);
+  size_t onCommands(const char *deviceId, const char *const *commands, size_t count, SentientRouteHandler handler, void *context = nullptr);
+
   void setCommandCallback(SentientCommandCallback callback, void *context = nullptr);
   void setHeartbeatBuilder(SentientHeartbeatBuilder callback, void *context = nullptr);
   void setOnConnect(SentientConnectionCallback callback, void *context = nullptr);
   void setOnDisconnect(SentientConnectionCallback callback, void *context = nullptr);
 
   bool isConnected() { return _mqttClient.connected(); }
+  size_t offlineQueueDepth() const { return _offlineQueue.depth(); }
+  uint32_t offlineQueueDropped() const { return _offlineQueue.dropped(); }
   const SentientMQTTConfig &config() const { return _config; }
+
+  // Unix time from the synchronised clock; 0 until the first exchange
+  SentientClock &clock() { return _clock; }
+  uint64_t epochMillis() { return _clock.epochMillis(); }
+  size_t scheduledDepth() const { return _schedule.depth(); }
+  bool publishClockStatus();
+
+  // Call at the end of loop() instead of delay(). Sleeps (WFI on Teensy)
+  // until an Ethernet frame arrives, a wake pin fires, wake() is called or
+  // maxWaitMs passes, and never past the library's own next deadline
+  // (heartbeat, clock poll, scheduled command, reconnect step).
+  void idle(uint32_t maxWaitMs);
+  bool wakeOnPin(uint8_t pin, int mode = CHANGE); // attachInterrupt() that ends idle()
+  void wake() { _wakeRequested = true; }          // Safe from ISRs
+  float idlePercent() const { return _idlePercent; } // Over the last report window
+  bool publishIdleStatus();
   PubSubClient &get_client() { return _mqttClient; }
 
+  // Streamed publish for payloads generated as they are written (see
+  // SentientManifestStream). beginPublish() only starts once the send queue
+  // has room for the whole message, so false means nothing was sent and the
+  // message can simply be tried again. A message that fails after it has
+  // started is truncated on the wire, so endPublish() drops the connection
+  // for it and loop() reconnects.
+  bool beginPublish(const char *topic, size_t payloadLength, bool retain = false);
+  bool writePayload(const uint8_t *data, size_t length);
+  bool endPublish();
+
 private:
+  // Broker connection steps; ensureConnected() advances at most one per loop()
+  enum class ConnectPhase : uint8_t
+  {
+    Idle,
+    Resolving,
+    TcpConnecting,
+    SendingConnect,
+    AwaitingConnack,
+    Subscribing,
+    Online
+  };
+
+  // What to do with a message that cannot be sent right now
+  enum class QueuePolicy : uint8_t
+  {
+    Drop,     // Stale once missed (heartbeats, connection state)
+    Queue,    // Edges and events: replay every one, in order
+    Coalesce  // Snapshots: replay only the latest per topic
+  };
+
   bool configureNetwork();
   void ensureConnected();
+  void stepConnection();
+#if !defined(ESP32)
+  bool sendConnectPacket();
+#endif
+  void enterPhase(ConnectPhase phase);
+  bool phaseTimedOut() const;
+  void failConnection(const __FlashStringHelper *reason);
+  void scheduleReconnect();
+  uint32_t nextJitter();
   void handleIncoming(char *topic, uint8_t *payload, unsigned int length);
-  bool publishRaw(const String &topic, const char *payload, bool retain);
+  void parseCommandPayload(const char *payload, size_t length);
+  bool scheduleCommand(const char *rest, const uint8_t *payload, size_t length);
+  void dispatchCommand(const char *rest);
+  void serviceClock();
+  void serviceSchedule();
+  void recordSkew(uint64_t dueLocalMicros);
+  uint32_t idleBudgetUs(uint32_t maxWaitMs);
+  static uint32_t networkFrames();
+  bool publishRaw(const char *topic, const char *payload, bool retain, QueuePolicy policy);
+  bool publishDocument(const char *topic, const JsonDocument &payload, bool retain, QueuePolicy policy);
+  bool enqueueDocument(const char *topic, const JsonDocument &payload, bool retain, QueuePolicy policy);
+  bool sendRoomFor(const char *topic, size_t payloadLength);
+  void abortPublish();
+  void drainOfflineQueue();
+  static QueuePolicy policyFor(const char *category, bool retain);
+  bool publishConnectionState(const char *state);
 
-  String buildTopic(const char *category, const char *item = nullptr) const;
-  String buildClientId() const;
-  String buildConnectionPayload(const char *state) const;
+  void cacheTopicSegments();
+  const char *buildTopic(const char *category, const char *item = nullptr, const char *subItem = nullptr);
+  void buildClientId();
 
   SentientMQTTConfig _config;
   SENTIENT_NETWORK_CLIENT _networkClient;
   PubSubClient _mqttClient;
-  unsigned long _lastConnectAttempt = 0;
+
+  // Topic segments resolved once in begin(): "<namespace>/<room>/" and "<controller>/<device>"
+  char _topicPrefix[SENTIENT_MQTT_MAX_TOPIC_LENGTH] = {0};
+  size_t _topicPrefixLength = 0;
+  char _topicScope[SENTIENT_MQTT_MAX_TOPIC_LENGTH] = {0};
+  size_t _topicScopeLength = 0;
+  char _connectionTopic[SENTIENT_MQTT_MAX_TOPIC_LENGTH] = {0};
+  char _commandPrefix[SENTIENT_MQTT_MAX_TOPIC_LENGTH] = {0}; // "<namespace>/<room>/commands/<controller>/"
+  size_t _commandPrefixLength = 0;
+  char _topicBuffer[SENTIENT_MQTT_MAX_TOPIC_LENGTH] = {0};
+
+  // Reusable document for library-built payloads (sensor, metric, state, heartbeat)
+  SentientArenaAllocator _publishArena;
+  JsonDocument _publishDoc;
+
+  // Reusable document for incoming command payloads
+  SentientArenaAllocator _commandArena;
+  JsonDocument _commandDoc;
+  SentientCommandRouter _router;
+
+  SentientClock _clock;
+  SentientCommandSchedule _schedule;
+  unsigned long _lastClockReport = 0;
+  uint32_t _scheduledRun = 0;
+  uint32_t _scheduledLate = 0;      // Dispatched more than SENTIENT_MQTT_SCHEDULE_LATE_US after execute_at
+  uint32_t _scheduledUnsynced = 0;  // Carried execute_at but ran on arrival: clock not synced yet
+  int32_t _lastSkewUs = 0;          // Dispatch minus execute_at on the local clock
+  int32_t _maxSkewUs = 0;
+
+  // idle() bookkeeping
+  volatile bool _wakeRequested = false;
+  bool _idleUsed = false;
+  uint64_t _idleMicros = 0;        // Slept in the current report window
+  uint64_t _idleWindowStart = 0;   // localMicros() the window opened at
+  float _idlePercent = 0.0f;
+  unsigned long _lastIdleReport = 0;
+  uint32_t _wakeNetwork = 0;
+  uint32_t _wakePin = 0;
+  uint32_t _wakeRequests = 0;
+  uint32_t _wakeDeadline = 0;
+  uint8_t _wakePinCount = 0;
+
+  SentientOfflineQueue _offlineQueue;
+  unsigned long _lastDrain = 0;
+  bool _publishFailed = false; // A write in the open streamed publish failed
   unsigned long _lastHeartbeat = 0;
-  bool _wasConnected = false;
+
+  ConnectPhase _phase = ConnectPhase::Idle;
+  unsigned long _phaseStartedAt = 0;
+  unsigned long _retryStartedAt = 0;
+  uint32_t _retryDelayMs = 0;
+  uint8_t _failedAttempts = 0;
+  uint32_t _jitterState = 0;
+  IPAddress _brokerAddress;
+  bool _brokerResolved = false;
+  char _clientId[64] = {0};
 
 #if !defined(ESP32)
   uint8_t _macAddress[6] = {0};
@@ -127,6 +322,8 @@ private:
 
   static SentientMQTT *s_activeInstance;
   static void mqttCallbackThunk(char *topic, uint8_t *payload, unsigned int length);
+  static volatile bool s_pinWake;
+  static void pinWakeThunk();
 };
 
 #endif // SENTIENT_MQTT_H
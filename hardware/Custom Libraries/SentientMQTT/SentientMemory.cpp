@@ -0,0 +1,415 @@
+#include "SentientMemory.h"
+#include "SentientMQTT.h"
+
+#if defined(__IMXRT1062__)
+#include <malloc.h>
+#include <smalloc.h>
+#elif defined(ESP32)
+#include <esp_heap_caps.h>
+#endif
+
+// Defined in SentientMemoryHooks.c; referencing them here also pulls the
+// wrappers into the link
+extern "C"
+{
+  typedef void (*sentient_memory_hook_t)(void *block, size_t size, void *released, void *site);
+  extern volatile uint32_t sentient_memory_allocs;
+  extern volatile uint32_t sentient_memory_frees;
+  extern sentient_memory_hook_t sentient_memory_hook;
+}
+
+#if defined(__IMXRT1062__)
+// Teensy 4 linker script and core
+extern "C"
+{
+  extern unsigned long _sdata;
+  extern unsigned long _ebss;
+  extern unsigned long _estack;
+  extern unsigned long _itcm_block_count;
+  extern unsigned long _heap_start;
+  extern unsigned long _heap_end;
+  extern unsigned long _extram_start;
+  extern unsigned long _extram_end;
+  extern char *__brkval;
+  extern uint8_t external_psram_size;
+  extern struct smalloc_pool extmem_smalloc_pool;
+}
+#endif
+
+SentientMemorySite SentientMemory::s_sites[SENTIENT_MEMORY_TRACK_SITES] = {};
+SentientMemory::Block SentientMemory::s_blocks[SENTIENT_MEMORY_TRACK_BLOCKS] = {};
+uint16_t SentientMemory::s_blockCount = 0;
+uint32_t SentientMemory::s_untracked = 0;
+
+namespace
+{
+constexpr uint32_t kPaint = 0x5EA7C0DE;
+constexpr uint32_t kPaintGuardBytes = 512; // Left unpainted below the caller's frame
+constexpr uint32_t kRam1Bytes = 512 * 1024;
+constexpr uint32_t kRam2Base = 0x20200000;
+
+bool s_painted = false;
+uint32_t s_rateAllocs = 0;
+uint32_t s_rateMs = 0;
+uint32_t s_lastSitesMs = 0;
+
+#if defined(__IMXRT1062__)
+inline uint32_t addressOf(const void *symbol)
+{
+  return (uint32_t)(uintptr_t)symbol;
+}
+
+// Walk newlib's heap chunk by chunk: each chunk's size word holds the
+// "previous chunk in use" flag, and the last chunk below the break is the
+// top chunk, which malloc can grow up to _heap_end. Returns the largest
+// free chunk's payload, or 0 if the heap does not look as expected.
+uint32_t largestHeapBlock()
+{
+  const uint32_t brk = addressOf(__brkval);
+  const uint32_t heapEnd = addressOf(&_heap_end);
+  uint32_t chunk = (addressOf(&_heap_start) + 7) & ~7u;
+  uint32_t largest = 0;
+  while (chunk + 8 <= brk)
+  {
+    const uint32_t size = *(const uint32_t *)(chunk + 4) & ~3u;
+    const uint32_t next = chunk + size;
+    if (size < 16 || next > brk)
+    {
+      return 0;
+    }
+    uint32_t freeBytes = 0;
+    if (next + 8 > brk)
+    {
+      freeBytes = size + (heapEnd - brk); // Top chunk
+    }
+    else if ((*(const uint32_t *)(next + 4) & 1u) == 0)
+    {
+      freeBytes = size;
+    }
+    if (freeBytes > 8 && freeBytes - 8 > largest)
+    {
+      largest = freeBytes - 8;
+    }
+    chunk = next;
+  }
+  // Nothing allocated yet, or only the unclaimed space above the break
+  return largest > 0 ? largest : heapEnd - brk;
+}
+#endif
+}
+
+void SentientMemory::begin()
+{
+  if (s_painted)
+  {
+    return;
+  }
+#if defined(__IMXRT1062__)
+  volatile uint32_t marker = 0;
+  const uint32_t limit = (addressOf((const void *)&marker) - kPaintGuardBytes) & ~3u;
+  for (uint32_t *word = (uint32_t *)((addressOf(&_ebss) + 3) & ~3u); addressOf(word) < limit; ++word)
+  {
+    *word = kPaint;
+  }
+  s_painted = true;
+#endif
+  s_rateAllocs = sentient_memory_allocs;
+  s_rateMs = millis();
+}
+
+uint32_t SentientMemory::stackHighWater()
+{
+#if defined(__IMXRT1062__)
+  const uint32_t top = addressOf(&_estack);
+  if (!s_painted)
+  {
+    volatile uint32_t marker = 0;
+    return top - addressOf((const void *)&marker);
+  }
+  // The stack grows down, so the lowest word it overwrote is the first one
+  // above the bottom that lost the pattern
+  const uint32_t *word = (const uint32_t *)((addressOf(&_ebss) + 3) & ~3u);
+  while (addressOf(word) < top && *word == kPaint)
+  {
+    ++word;
+  }
+  return top - addressOf(word);
+#else
+  return 0;
+#endif
+}
+
+void SentientMemory::sample(SentientMemoryStats &out)
+{
+  out = SentientMemoryStats{};
+  out.allocations = sentient_memory_allocs;
+  out.frees = sentient_memory_frees;
+
+#if defined(__IMXRT1062__)
+  const struct mallinfo info = mallinfo();
+  const uint32_t brk = addressOf(__brkval);
+  const uint32_t heapEnd = addressOf(&_heap_end);
+  out.heapUsed = info.uordblks;
+  out.heapFree = info.fordblks + (heapEnd - brk);
+  out.heapLargest = largestHeapBlock();
+
+  const uint32_t itcmBytes = addressOf(&_itcm_block_count) * 32 * 1024;
+  const uint32_t dataBytes = addressOf(&_ebss) - addressOf(&_sdata);
+  out.stackUsed = stackHighWater();
+  out.stackFree = kRam1Bytes - itcmBytes - dataBytes - out.stackUsed;
+  // ITCM is allocated to code in whole 32 KB blocks; the rest of a block is unusable
+  out.ram1Used = itcmBytes + dataBytes + out.stackUsed;
+  out.ram1Free = out.stackFree;
+
+  out.ram2Used = (addressOf(&_heap_start) - kRam2Base) + out.heapUsed;
+  out.ram2Free = out.heapFree;
+
+  out.extmemSize = (uint32_t)external_psram_size * 1024 * 1024;
+  if (out.extmemSize > 0)
+  {
+    const uint32_t statics = addressOf(&_extram_end) - addressOf(&_extram_start);
+    size_t pool = 0;
+    size_t user = 0;
+    size_t freeBytes = 0;
+    int blocks = 0;
+    if (sm_malloc_stats_pool(&extmem_smalloc_pool, &pool, &user, &freeBytes, &blocks))
+    {
+      out.extmemUsed = statics + (pool - freeBytes);
+      out.extmemFree = freeBytes;
+    }
+    else
+    {
+      out.extmemUsed = statics;
+      out.extmemFree = out.extmemSize - statics;
+    }
+  }
+#elif defined(ESP32)
+  out.heapFree = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+  out.heapLargest = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+  out.heapUsed = heap_caps_get_total_size(MALLOC_CAP_8BIT) - out.heapFree;
+  out.stackFree = uxTaskGetStackHighWaterMark(nullptr);
+#endif
+}
+
+void SentientMemory::addTo(JsonObject mem)
+{
+  SentientMemoryStats stats;
+  sample(stats);
+
+  const uint32_t now = millis();
+  const uint32_t elapsed = now - s_rateMs;
+  const float rate = elapsed > 0 ? (stats.allocations - s_rateAllocs) * 1000.0f / elapsed : 0.0f;
+  s_rateAllocs = stats.allocations;
+  s_rateMs = now;
+
+  mem["heap_free"] = stats.heapFree;
+  mem["heap_largest"] = stats.heapLargest;
+  mem["heap_used"] = stats.heapUsed;
+  // Share of the free heap a single allocation cannot reach
+  mem["frag_pct"] = stats.heapFree ? 100 - (uint32_t)((uint64_t)stats.heapLargest * 100 / stats.heapFree) : 0;
+  mem["allocs"] = stats.allocations;
+  mem["frees"] = stats.frees;
+  mem["alloc_rate"] = rate;
+  mem["stack_max"] = stats.stackUsed;
+  mem["stack_free"] = stats.stackFree;
+#if defined(__IMXRT1062__)
+  mem["ram1_used"] = stats.ram1Used;
+  mem["ram1_free"] = stats.ram1Free;
+  mem["ram2_used"] = stats.ram2Used;
+  mem["ram2_free"] = stats.ram2Free;
+  if (stats.extmemSize > 0)
+  {
+    mem["ext_used"] = stats.extmemUsed;
+    mem["ext_free"] = stats.extmemFree;
+  }
+#endif
+}
+
+// ─── Allocation tracker ──────────────────────────────────────────────────────
+
+void SentientMemory::startTracking()
+{
+  noInterrupts();
+  memset(s_sites, 0, sizeof(s_sites));
+  memset(s_blocks, 0, sizeof(s_blocks));
+  s_blockCount = 0;
+  s_untracked = 0;
+  sentient_memory_hook = track;
+  interrupts();
+  s_lastSitesMs = millis();
+}
+
+void SentientMemory::stopTracking()
+{
+  sentient_memory_hook = nullptr;
+}
+
+bool SentientMemory::tracking()
+{
+  return sentient_memory_hook != nullptr;
+}
+
+uint32_t SentientMemory::blockSlot(const void *ptr)
+{
+  // Blocks are 8-byte aligned; Fibonacci hashing spreads the rest
+  return ((uint32_t)((uintptr_t)ptr >> 3) * 2654435761u) & (SENTIENT_MEMORY_TRACK_BLOCKS - 1);
+}
+
+uint8_t SentientMemory::siteFor(uint32_t pc, const char *scope)
+{
+  constexpr uint8_t kOverflow = SENTIENT_MEMORY_TRACK_SITES - 1;
+  if (scope)
+  {
+    pc = 0; // A scope is one site wherever in it malloc was called
+  }
+  for (uint8_t i = 0; i < kOverflow; ++i)
+  {
+    if (s_sites[i].pc == pc && s_sites[i].scope == scope)
+    {
+      return i;
+    }
+    if (s_sites[i].pc == 0 && !s_sites[i].scope)
+    {
+      s_sites[i].pc = pc;
+      s_sites[i].scope = scope;
+      return i;
+    }
+  }
+  return kOverflow;
+}
+
+void SentientMemory::forget(void *ptr)
+{
+  constexpr uint32_t kMask = SENTIENT_MEMORY_TRACK_BLOCKS - 1;
+  uint32_t slot = blockSlot(ptr);
+  for (uint32_t probes = 0; s_blocks[slot].ptr != ptr; ++probes)
+  {
+    if (!s_blocks[slot].ptr || probes >= kMask)
+    {
+      return; // Allocated before tracking started, or never fitted
+    }
+    slot = (slot + 1) & kMask;
+  }
+
+  SentientMemorySite &site = s_sites[s_blocks[slot].site];
+  site.live -= 1;
+  site.liveBytes -= s_blocks[slot].size;
+  --s_blockCount;
+
+  // Backward-shift deletion keeps every probe chain unbroken without tombstones
+  uint32_t hole = slot;
+  for (uint32_t next = (hole + 1) & kMask; s_blocks[next].ptr; next = (next + 1) & kMask)
+  {
+    const uint32_t home = blockSlot(s_blocks[next].ptr);
+    if (((next - home) & kMask) >= ((next - hole) & kMask))
+    {
+      s_blocks[hole] = s_blocks[next];
+      hole = next;
+    }
+  }
+  s_blocks[hole] = Block{};
+}
+
+void SentientMemory::track(void *block, size_t size, void *released, void *site)
+{
+  noInterrupts();
+  if (released)
+  {
+    forget(released);
+  }
+  if (block)
+  {
+    const uint8_t index = siteFor((uint32_t)(uintptr_t)site, sentient_memory_scope);
+    SentientMemorySite &entry = s_sites[index];
+    entry.allocs += 1;
+    // Keep a quarter of the table empty so probe chains stay short
+    if (s_blockCount >= SENTIENT_MEMORY_TRACK_BLOCKS - SENTIENT_MEMORY_TRACK_BLOCKS / 4)
+    {
+      ++s_untracked;
+    }
+    else
+    {
+      uint32_t slot = blockSlot(block);
+      while (s_blocks[slot].ptr)
+      {
+        slot = (slot + 1) & (SENTIENT_MEMORY_TRACK_BLOCKS - 1);
+      }
+      s_blocks[slot] = Block{block, (uint32_t)size, index};
+      ++s_blockCount;
+      entry.live += 1;
+      entry.liveBytes += size;
+    }
+  }
+  interrupts();
+}
+
+uint8_t SentientMemory::topSites(SentientMemorySite *out, uint8_t maxSites)
+{
+  SentientMemorySite sites[SENTIENT_MEMORY_TRACK_SITES];
+  noInterrupts();
+  memcpy(sites, s_sites, sizeof(sites));
+  interrupts();
+
+  uint8_t count = 0;
+  while (count < maxSites)
+  {
+    int best = -1;
+    for (uint8_t i = 0; i < SENTIENT_MEMORY_TRACK_SITES; ++i)
+    {
+      if (sites[i].allocs > 0 && (best < 0 || sites[i].liveBytes > sites[best].liveBytes))
+      {
+        best = i;
+      }
+    }
+    if (best < 0)
+    {
+      break;
+    }
+    out[count++] = sites[best];
+    sites[best].allocs = 0;
+  }
+  return count;
+}
+
+bool SentientMemory::publishSites(SentientMQTT &mqtt, uint8_t maxSites)
+{
+  if (maxSites > SENTIENT_MEMORY_TRACK_SITES)
+  {
+    maxSites = SENTIENT_MEMORY_TRACK_SITES;
+  }
+  SentientMemorySite top[SENTIENT_MEMORY_TRACK_SITES];
+  const uint8_t count = topSites(top, maxSites);
+
+  JsonDocument &doc = mqtt.scratchDocument();
+  doc["timestamp"] = millis() / 1000;
+  doc["untracked"] = s_untracked;
+  JsonArray sites = doc["sites"].to<JsonArray>();
+  for (uint8_t i = 0; i < count; ++i)
+  {
+    JsonObject entry = sites.add<JsonObject>();
+    if (top[i].scope)
+    {
+      entry["scope"] = top[i].scope;
+    }
+    else
+    {
+      char pc[11];
+      snprintf(pc, sizeof(pc), "0x%08lx", (unsigned long)top[i].pc);
+      entry["pc"] = pc; // Copied into the document
+    }
+    entry["live"] = top[i].live;
+    entry["live_bytes"] = top[i].liveBytes;
+    entry["allocs"] = top[i].allocs;
+  }
+  s_lastSitesMs = millis();
+  return mqtt.publishJson("metrics", "memory", doc);
+}
+
+bool SentientMemory::reportSites(SentientMQTT &mqtt, uint32_t intervalMs, uint8_t maxSites)
+{
+  if (!tracking() || millis() - s_lastSitesMs < intervalMs || !mqtt.isConnected())
+  {
+    return false;
+  }
+  return publishSites(mqtt, maxSites);
+}
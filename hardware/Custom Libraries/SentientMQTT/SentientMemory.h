@@ -0,0 +1,147 @@
+/*
+ * SentientMemory.h
+ *
+ * Heap, stack and RAM region telemetry, so slow leaks, heap fragmentation
+ * and stack creep show up on the dashboard long before they reset a
+ * controller.
+ *
+ * SentientMQTT::begin() paints the free stack with a known pattern; the
+ * stack's high-water mark is the lowest word no longer holding it. The heap
+ * is read from newlib's allocator: free bytes, and the largest block a
+ * single malloc could still get, walking the heap's chunks. malloc, calloc,
+ * realloc and free are wrapped (SentientMemoryHooks.c) to count
+ * allocations. Each heartbeat carries the summary under "mem" unless
+ * SentientMQTTConfig::heartbeatMemory is off.
+ *
+ * On Teensy 4.1 the regions are RAM1 (ITCM code, DTCM data and stack), RAM2
+ * (DMAMEM statics and the heap) and EXTMEM (PSRAM statics and
+ * extmem_malloc). ESP32 builds report the heap and the loop task's stack
+ * only.
+ *
+ * The allocation tracker is optional: after startTracking() every block is
+ * attributed to the address that called malloc, and publishSites() sends
+ * the sites holding the most live memory on metrics/memory. Resolve the
+ * addresses with addr2line against the sketch's .elf. Blocks allocated
+ * before tracking started are not attributed; start it early in setup().
+ *
+ * The address is only the direct caller of malloc. Memory that goes through
+ * a wrapper is charged to the wrapper: every String to WString's
+ * changeBuffer(), every ArduinoJson document to its allocator, so those
+ * sites say nothing about which code grew them. Name the code instead with
+ * SENTIENT_MEMORY_SCOPE("publish_status") at the top of a block; until the
+ * block exits, allocations are attributed to that name (reported as
+ * "scope" instead of "pc"). Scopes nest, the innermost wins, and an
+ * interrupt that allocates inside one is charged to it too.
+ */
+
+#ifndef SENTIENT_MEMORY_H
+#define SENTIENT_MEMORY_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#ifndef SENTIENT_MEMORY_TRACK_SITES
+#define SENTIENT_MEMORY_TRACK_SITES 32 // Distinct call sites; the last slot collects the overflow
+#endif
+#ifndef SENTIENT_MEMORY_TRACK_BLOCKS
+#define SENTIENT_MEMORY_TRACK_BLOCKS 256 // Live blocks attributed at once (power of two)
+#endif
+
+static_assert((SENTIENT_MEMORY_TRACK_BLOCKS & (SENTIENT_MEMORY_TRACK_BLOCKS - 1)) == 0,
+              "SENTIENT_MEMORY_TRACK_BLOCKS must be a power of two");
+
+class SentientMQTT;
+
+extern "C" const char *volatile sentient_memory_scope; // SentientMemoryHooks.c
+
+struct SentientMemoryStats
+{
+  uint32_t heapFree;    // Free chunks plus room left for the heap to grow
+  uint32_t heapLargest; // Largest single allocation that would succeed now
+  uint32_t heapUsed;    // Bytes in allocated chunks
+  uint32_t allocations; // malloc/calloc/realloc since boot
+  uint32_t frees;
+  uint32_t stackUsed; // Deepest the stack has been (high-water mark)
+  uint32_t stackFree; // Never-touched stack left below the mark
+  uint32_t ram1Used;  // Code, data, bss and stack high-water mark
+  uint32_t ram1Free;
+  uint32_t ram2Used; // DMAMEM statics plus the heap as far as it has grown
+  uint32_t ram2Free;
+  uint32_t extmemSize; // 0 without PSRAM
+  uint32_t extmemUsed; // EXTMEM statics plus extmem_malloc blocks
+  uint32_t extmemFree;
+};
+
+struct SentientMemorySite
+{
+  const char *scope;  // SENTIENT_MEMORY_SCOPE name, or nullptr
+  uint32_t pc;        // Address that called malloc; 0 for a scope and the overflow slot
+  uint32_t live;      // Blocks still allocated
+  uint32_t liveBytes; // Bytes they hold
+  uint32_t allocs;    // Allocations since tracking started
+};
+
+class SentientMemory
+{
+public:
+  // Paint the unused stack; SentientMQTT::begin() calls this. Later calls do nothing.
+  static void begin();
+
+  static void sample(SentientMemoryStats &out);
+  // The heartbeat summary; the allocation rate is over the time since the previous call
+  static void addTo(JsonObject mem);
+
+  static uint32_t stackHighWater(); // Bytes; the current depth if the stack was never painted
+
+  // Allocation tracker
+  static void startTracking();
+  static void stopTracking();
+  static bool tracking();
+  static uint32_t untracked() { return s_untracked; } // Blocks the tables had no room for
+  // Copy up to maxSites sites, most live bytes first; returns the number copied
+  static uint8_t topSites(SentientMemorySite *out, uint8_t maxSites);
+  // The top sites on metrics/memory
+  static bool publishSites(SentientMQTT &mqtt, uint8_t maxSites = 10);
+  // publishSites() once intervalMs has passed since the last report; call every loop()
+  static bool reportSites(SentientMQTT &mqtt, uint32_t intervalMs, uint8_t maxSites = 10);
+
+  // Tracker entry point for the malloc wrappers
+  static void track(void *block, size_t size, void *released, void *site);
+
+private:
+  struct Block
+  {
+    void *ptr;
+    uint32_t size;
+    uint8_t site;
+  };
+
+  static uint32_t blockSlot(const void *ptr);
+  static uint8_t siteFor(uint32_t pc, const char *scope);
+  static void forget(void *ptr);
+
+  static SentientMemorySite s_sites[SENTIENT_MEMORY_TRACK_SITES];
+  static Block s_blocks[SENTIENT_MEMORY_TRACK_BLOCKS];
+  static uint16_t s_blockCount;
+  static uint32_t s_untracked;
+};
+
+// Attributes the allocations made while it lives to name; see SENTIENT_MEMORY_SCOPE
+class SentientMemoryScope
+{
+public:
+  explicit SentientMemoryScope(const char *name) : _previous(sentient_memory_scope) { sentient_memory_scope = name; }
+  ~SentientMemoryScope() { sentient_memory_scope = _previous; }
+  SentientMemoryScope(const SentientMemoryScope &) = delete;
+  SentientMemoryScope &operator=(const SentientMemoryScope &) = delete;
+
+private:
+  const char *_previous;
+};
+
+#define SENTIENT_MEMORY_SCOPE_JOIN(a, b) a##b
+#define SENTIENT_MEMORY_SCOPE_NAME(line) SENTIENT_MEMORY_SCOPE_JOIN(sentientMemoryScope_, line)
+// Tag allocations until the enclosing block exits; name must outlive the report (a literal)
+#define SENTIENT_MEMORY_SCOPE(name) SentientMemoryScope SENTIENT_MEMORY_SCOPE_NAME(__LINE__)(name)
+
+#endif // SENTIENT_MEMORY_H
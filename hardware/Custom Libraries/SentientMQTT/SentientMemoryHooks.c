@@ -0,0 +1,99 @@
+/*
+ * SentientMemoryHooks.c
+ *
+ * Counting wrappers around newlib's malloc family for SentientMemory. They
+ * replace the C library's malloc/free/calloc/realloc at link time, forward
+ * to the reentrant _r versions, and count every call; when the allocation
+ * tracker is running they also hand each block and its call site to it.
+ * The tracker prefers the innermost SENTIENT_MEMORY_SCOPE name, kept in
+ * sentient_memory_scope, over the call site.
+ *
+ * Plain C so the definitions match libc's declarations exactly. Only Teensy
+ * 4 (newlib) is wrapped; elsewhere the counters stay at zero.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef void (*sentient_memory_hook_t)(void *block, size_t size, void *released, void *site);
+
+volatile uint32_t sentient_memory_allocs = 0;
+volatile uint32_t sentient_memory_frees = 0;
+sentient_memory_hook_t sentient_memory_hook = 0;
+const char *volatile sentient_memory_scope = 0;
+
+#if defined(__IMXRT1062__)
+#include <malloc.h>
+#include <reent.h>
+
+// The site is whoever called malloc: operator new tail-calls it, so a
+// new-expression is attributed to the code that wrote it, but String and
+// ArduinoJson allocations are attributed to their own internals (see
+// SENTIENT_MEMORY_SCOPE)
+#define SENTIENT_MEMORY_SITE __builtin_return_address(0)
+
+void *malloc(size_t size)
+{
+  void *block = _malloc_r(_REENT, size);
+  if (block)
+  {
+    ++sentient_memory_allocs;
+    if (sentient_memory_hook)
+    {
+      sentient_memory_hook(block, size, 0, SENTIENT_MEMORY_SITE);
+    }
+  }
+  return block;
+}
+
+void free(void *block)
+{
+  if (!block)
+  {
+    return;
+  }
+  ++sentient_memory_frees;
+  if (sentient_memory_hook)
+  {
+    sentient_memory_hook(0, 0, block, SENTIENT_MEMORY_SITE);
+  }
+  _free_r(_REENT, block);
+}
+
+void *calloc(size_t count, size_t size)
+{
+  void *block = _calloc_r(_REENT, count, size);
+  if (block)
+  {
+    ++sentient_memory_allocs;
+    if (sentient_memory_hook)
+    {
+      sentient_memory_hook(block, count * size, 0, SENTIENT_MEMORY_SITE);
+    }
+  }
+  return block;
+}
+
+void *realloc(void *released, size_t size)
+{
+  void *block = _realloc_r(_REENT, released, size);
+  if (!block && size != 0)
+  {
+    return 0; // Failed: the old block is untouched
+  }
+  // A move or resize counts as freeing the old block and allocating the new
+  if (released)
+  {
+    ++sentient_memory_frees;
+  }
+  if (block)
+  {
+    ++sentient_memory_allocs;
+  }
+  if (sentient_memory_hook)
+  {
+    sentient_memory_hook(block, block ? size : 0, released, SENTIENT_MEMORY_SITE);
+  }
+  return block;
+}
+#endif
@@ -0,0 +1,270 @@
+#include "SentientOfflineQueue.h"
+
+#include <cstring>
+#include <new>
+
+SentientOfflineQueue::~SentientOfflineQueue()
+{
+  if (_ownsStorage)
+  {
+    delete[] _storage;
+  }
+}
+
+bool SentientOfflineQueue::begin(size_t capacity)
+{
+  if (_storage)
+  {
+    return _capacity >= capacity;
+  }
+  uint8_t *storage = new (std::nothrow) uint8_t[capacity];
+  if (!storage)
+  {
+    return false;
+  }
+  _ownsStorage = true;
+  attach(storage, capacity);
+  return true;
+}
+
+void SentientOfflineQueue::begin(void *storage, size_t capacity)
+{
+  if (_storage || !storage)
+  {
+    return;
+  }
+  _ownsStorage = false;
+  attach(static_cast<uint8_t *>(storage), capacity);
+}
+
+uint8_t *SentientOfflineQueue::reserve(const char *topic, size_t payloadLength, bool retain, bool coalesce)
+{
+  if (!_storage || !topic)
+  {
+    return nullptr;
+  }
+  if (_pending != SIZE_MAX)
+  {
+    // Previous reservation was never committed: let it drain as a no-op
+    recordAt(_pending)->flags |= kFlagSuperseded;
+    _pending = SIZE_MAX;
+  }
+
+  const size_t topicLength = strlen(topic);
+  size_t size = sizeof(RecordHeader) + topicLength + 1 + payloadLength + 1;
+  size = (size + kAlignment - 1) & ~(kAlignment - 1);
+  if (size > 0xFFFF || size > _capacity)
+  {
+    _dropped++;
+    return nullptr;
+  }
+
+  size_t offset = 0;
+  if (!allocate(size, offset))
+  {
+    _dropped++;
+    return nullptr;
+  }
+
+  RecordHeader *header = recordAt(offset);
+  header->size = static_cast<uint16_t>(size);
+  header->topicLength = static_cast<uint16_t>(topicLength);
+  header->payloadLength = static_cast<uint16_t>(payloadLength);
+  header->flags = (retain ? kFlagRetain : 0) | (coalesce ? kFlagCoalesce : 0);
+  header->reserved = 0;
+
+  char *topicOut = reinterpret_cast<char *>(header + 1);
+  memcpy(topicOut, topic, topicLength + 1);
+  uint8_t *payloadOut = reinterpret_cast<uint8_t *>(topicOut + topicLength + 1);
+  payloadOut[payloadLength] = '\0';
+
+  _tail = offset + size;
+  _recordCount++;
+  _pending = offset;
+  return payloadOut;
+}
+
+void SentientOfflineQueue::commit()
+{
+  if (_pending == SIZE_MAX)
+  {
+    return;
+  }
+
+  RecordHeader *header = recordAt(_pending);
+  if (header->flags & kFlagCoalesce)
+  {
+    supersede(reinterpret_cast<const char *>(header + 1), header->topicLength);
+  }
+  _pending = SIZE_MAX;
+  _liveCount++;
+}
+
+bool SentientOfflineQueue::push(const char *topic, const uint8_t *payload, size_t payloadLength, bool retain, bool coalesce)
+{
+  uint8_t *buffer = reserve(topic, payloadLength, retain, coalesce);
+  if (!buffer)
+  {
+    return false;
+  }
+  if (payloadLength > 0)
+  {
+    memcpy(buffer, payload, payloadLength);
+  }
+  commit();
+  return true;
+}
+
+bool SentientOfflineQueue::front(Message &message)
+{
+  discardSuperseded();
+  if (_liveCount == 0)
+  {
+    return false;
+  }
+
+  const RecordHeader *header = recordAt(_head);
+  const char *topic = reinterpret_cast<const char *>(header + 1);
+  message.topic = topic;
+  message.payload = reinterpret_cast<const uint8_t *>(topic + header->topicLength + 1);
+  message.payloadLength = header->payloadLength;
+  message.retain = (header->flags & kFlagRetain) != 0;
+  return true;
+}
+
+void SentientOfflineQueue::pop()
+{
+  discardSuperseded();
+  if (_recordCount == 0)
+  {
+    return;
+  }
+  removeOldest(false);
+  discardSuperseded();
+}
+
+void SentientOfflineQueue::attach(uint8_t *storage, size_t capacity)
+{
+  // Keep record headers 4-byte aligned regardless of where the buffer lives
+  const uintptr_t misalignment = reinterpret_cast<uintptr_t>(storage) & (kAlignment - 1);
+  const size_t skip = misalignment ? kAlignment - misalignment : 0;
+  _storage = storage + skip;
+  _capacity = capacity > skip ? (capacity - skip) & ~(kAlignment - 1) : 0;
+  _head = 0;
+  _tail = 0;
+  _recordCount = 0;
+  _liveCount = 0;
+  _pending = SIZE_MAX;
+}
+
+SentientOfflineQueue::RecordHeader *SentientOfflineQueue::recordAt(size_t offset) const
+{
+  return reinterpret_cast<RecordHeader *>(_storage + offset);
+}
+
+size_t SentientOfflineQueue::normalise(size_t offset) const
+{
+  // Too close to the end for a header, or an explicit wrap marker: continue at 0
+  if (offset >= _capacity || _capacity - offset < sizeof(RecordHeader))
+  {
+    return 0;
+  }
+  return (recordAt(offset)->flags & kFlagWrap) ? 0 : offset;
+}
+
+bool SentientOfflineQueue::allocate(size_t size, size_t &offset)
+{
+  for (;;)
+  {
+    if (_recordCount == 0)
+    {
+      _head = 0;
+      _tail = 0;
+    }
+
+    const bool full = _recordCount > 0 && _tail == _head;
+    if (!full)
+    {
+      if (_tail >= _head)
+      {
+        if (_capacity - _tail >= size)
+        {
+          offset = _tail;
+          return true;
+        }
+        if (_head >= size)
+        {
+          if (_capacity - _tail >= sizeof(RecordHeader))
+          {
+            RecordHeader *marker = recordAt(_tail);
+            marker->size = static_cast<uint16_t>(_capacity - _tail);
+            marker->flags = kFlagWrap;
+          }
+          _tail = 0;
+          offset = 0;
+          return true;
+        }
+      }
+      else if (_head - _tail >= size)
+      {
+        offset = _tail;
+        return true;
+      }
+    }
+
+    if (_recordCount == 0)
+    {
+      return false;
+    }
+    removeOldest(true);
+  }
+}
+
+void SentientOfflineQueue::removeOldest(bool evicted)
+{
+  const RecordHeader *header = recordAt(_head);
+  if (!(header->flags & kFlagSuperseded))
+  {
+    _liveCount--;
+    if (evicted)
+    {
+      _dropped++;
+    }
+  }
+
+  _recordCount--;
+  if (_recordCount == 0)
+  {
+    _head = 0;
+    _tail = 0;
+    return;
+  }
+  _head = normalise(_head + header->size);
+}
+
+void SentientOfflineQueue::supersede(const char *topic, size_t topicLength)
+{
+  size_t offset = _head;
+  for (size_t i = 0; i < _recordCount; ++i)
+  {
+    RecordHeader *header = recordAt(offset);
+    if (offset != _pending &&
+        (header->flags & (kFlagCoalesce | kFlagSuperseded)) == kFlagCoalesce &&
+        header->topicLength == topicLength &&
+        memcmp(header + 1, topic, topicLength) == 0)
+    {
+      header->flags |= kFlagSuperseded;
+      _liveCount--;
+      _coalesced++;
+    }
+    offset = normalise(offset + header->size);
+  }
+}
+
+void SentientOfflineQueue::discardSuperseded()
+{
+  while (_recordCount > 0 && _head != _pending && (recordAt(_head)->flags & kFlagSuperseded))
+  {
+    removeOldest(false);
+  }
+}
@@ -0,0 +1,99 @@
+/*
+ * SentientOfflineQueue.h
+ *
+ * Fixed-size ring buffer of outgoing MQTT messages, filled while the broker
+ * is unreachable and drained by SentientMQTT after it reconnects.
+ *
+ * Each record holds its topic and payload inline (both NUL-terminated) so a
+ * queued message can be handed straight to PubSubClient::publish() without
+ * copying. Records never wrap: when the tail reaches the end of the buffer a
+ * wrap marker sends it back to the start. When space runs out the oldest
+ * record is evicted, so the queue always keeps the most recent history.
+ *
+ * Messages pushed with coalesce=true supersede any earlier coalescable record
+ * on the same topic (state snapshots); everything else is kept in order
+ * (sensor edges, events).
+ */
+
+#ifndef SENTIENT_OFFLINE_QUEUE_H
+#define SENTIENT_OFFLINE_QUEUE_H
+
+#include <Arduino.h>
+
+class SentientOfflineQueue
+{
+public:
+  struct Message
+  {
+    const char *topic;
+    const uint8_t *payload;
+    size_t payloadLength;
+    bool retain;
+  };
+
+  SentientOfflineQueue() = default;
+  SentientOfflineQueue(const SentientOfflineQueue &) = delete;
+  SentientOfflineQueue &operator=(const SentientOfflineQueue &) = delete;
+  ~SentientOfflineQueue();
+
+  // Reserve the buffer from the heap, or use caller storage (DMAMEM/EXTMEM)
+  bool begin(size_t capacity);
+  void begin(void *storage, size_t capacity);
+
+  // Two-step push: reserve room for the payload, fill it, then commit.
+  // The returned buffer has payloadLength + 1 bytes (room for a terminator).
+  uint8_t *reserve(const char *topic, size_t payloadLength, bool retain, bool coalesce);
+  void commit();
+
+  bool push(const char *topic, const uint8_t *payload, size_t payloadLength, bool retain, bool coalesce);
+
+  // Oldest live message; valid until pop()
+  bool front(Message &message);
+  void pop();
+
+  bool enabled() const { return _storage != nullptr; }
+  bool empty() const { return _liveCount == 0; }
+  size_t depth() const { return _liveCount; }
+  size_t capacity() const { return _capacity; }
+  uint32_t dropped() const { return _dropped; }
+  uint32_t coalesced() const { return _coalesced; }
+
+private:
+  struct RecordHeader
+  {
+    uint16_t size;
+    uint16_t topicLength;
+    uint16_t payloadLength;
+    uint8_t flags;
+    uint8_t reserved;
+  };
+
+  static constexpr uint8_t kFlagRetain = 0x01;
+  static constexpr uint8_t kFlagCoalesce = 0x02;
+  static constexpr uint8_t kFlagSuperseded = 0x04;
+  static constexpr uint8_t kFlagWrap = 0x08;
+  static constexpr size_t kAlignment = 4;
+
+  void attach(uint8_t *storage, size_t capacity);
+  RecordHeader *recordAt(size_t offset) const;
+  size_t normalise(size_t offset) const;
+  bool allocate(size_t size, size_t &offset);
+  void removeOldest(bool evicted);
+  void supersede(const char *topic, size_t topicLength);
+  void discardSuperseded();
+
+  uint8_t *_storage = nullptr;
+  size_t _capacity = 0;
+  bool _ownsStorage = false;
+
+  size_t _head = 0;
+  size_t _tail = 0;
+  size_t _recordCount = 0; // Records in the buffer, including superseded ones
+  size_t _liveCount = 0;
+  size_t _pending = SIZE_MAX; // Offset of a reserved, uncommitted record
+
+  uint32_t _dropped = 0;
+  uint32_t _coalesced = 0;
+};
+
+#endif // SENTIENT_OFFLINE_QUEUE_H
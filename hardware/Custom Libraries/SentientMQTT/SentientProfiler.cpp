@@ -0,0 +1,125 @@
+#include "SentientProfiler.h"
+#include "SentientMQTT.h"
+
+SentientProbe *SentientProbe::s_first = nullptr;
+
+namespace
+{
+uint32_t s_windowStartUs = 0;
+uint32_t s_lastReportMs = 0;
+bool s_windowOpen = false;
+}
+
+SentientProbe::SentientProbe(const char *name) : _name(name ? name : "probe")
+{
+#if defined(__IMXRT1062__)
+  // Teensy's startup already runs the counter for micros(); make sure anyway
+  ARM_DEMCR |= ARM_DEMCR_TRCENA;
+  ARM_DWT_CTRL |= ARM_DWT_CTRL_CYCCNTENA;
+#endif
+  if (!s_windowOpen)
+  {
+    s_windowStartUs = micros();
+    s_lastReportMs = millis();
+    s_windowOpen = true;
+  }
+  _next = s_first;
+  s_first = this;
+}
+
+uint32_t SentientProbe::bucketUpper(uint8_t bucket)
+{
+  constexpr uint32_t kExact = 1u << kSubBits;
+  if (bucket < kExact)
+  {
+    return bucket;
+  }
+  const uint8_t exponent = bucket / kExact + kSubBits - 1;
+  const uint8_t sub = bucket % kExact;
+  const uint64_t lower = (uint64_t)(kExact + sub) << (exponent - kSubBits);
+  return (uint32_t)(lower + (1ull << (exponent - kSubBits)) - 1);
+}
+
+uint32_t SentientProbe::percentileCycles(uint8_t percent) const
+{
+  if (_count == 0)
+  {
+    return 0;
+  }
+  // Smallest sample with at least percent% of the samples at or below it
+  uint32_t rank = (uint32_t)(((uint64_t)_count * percent + 99) / 100);
+  if (rank == 0)
+  {
+    rank = 1;
+  }
+  uint32_t seen = 0;
+  for (uint8_t bucket = 0; bucket < kBuckets; ++bucket)
+  {
+    seen += _buckets[bucket];
+    if (seen >= rank)
+    {
+      // The bucket's top, but never above what was actually seen
+      const uint32_t upper = bucketUpper(bucket);
+      return upper < _max ? upper : _max;
+    }
+  }
+  return _max;
+}
+
+void SentientProbe::reset()
+{
+  memset(_buckets, 0, sizeof(_buckets));
+  _count = 0;
+  _max = 0;
+  _total = 0;
+}
+
+float SentientProfiler::cyclesToMicros(uint64_t cycles)
+{
+#if defined(__IMXRT1062__)
+  return (float)((double)cycles * 1e6 / (double)F_CPU_ACTUAL);
+#else
+  return (float)cycles; // Host builds count micros() directly
+#endif
+}
+
+bool SentientProfiler::publish(SentientMQTT &mqtt)
+{
+  const uint32_t now = micros();
+  const uint32_t windowUs = now - s_windowStartUs;
+
+  JsonDocument &doc = mqtt.scratchDocument();
+  doc["window_ms"] = windowUs / 1000;
+  doc["timestamp"] = millis() / 1000;
+  JsonArray probes = doc["probes"].to<JsonArray>();
+  for (SentientProbe *probe = SentientProbe::first(); probe; probe = probe->next())
+  {
+    JsonObject entry = probes.add<JsonObject>();
+    const uint32_t count = probe->count();
+    entry["name"] = probe->name();
+    entry["count"] = count;
+    entry["mean_us"] = count ? cyclesToMicros(probe->totalCycles()) / count : 0.0f;
+    entry["p50_us"] = cyclesToMicros(probe->percentileCycles(50));
+    entry["p99_us"] = cyclesToMicros(probe->percentileCycles(99));
+    entry["max_us"] = cyclesToMicros(probe->maxCycles());
+    entry["load_pct"] = windowUs ? cyclesToMicros(probe->totalCycles()) * 100.0f / windowUs : 0.0f;
+  }
+  const bool ok = mqtt.publishJson("metrics", "profile", doc);
+
+  for (SentientProbe *probe = SentientProbe::first(); probe; probe = probe->next())
+  {
+    probe->reset();
+  }
+  s_windowStartUs = now;
+  s_lastReportMs = millis();
+  return ok;
+}
+
+bool SentientProfiler::report(SentientMQTT &mqtt, uint32_t intervalMs)
+{
+  if (!SentientProbe::first() || millis() - s_lastReportMs < intervalMs || !mqtt.isConnected())
+  {
+    return false;
+  }
+  return publish(mqtt);
+}
@@ -0,0 +1,146 @@
+/*
+ * SentientProfiler.h
+ *
+ * Where loop() time goes, measured with the Cortex-M7 cycle counter (DWT
+ * CYCCNT) and published as latency histograms.
+ *
+ * Drop a probe at the top of a scope; it times the rest of the scope:
+ *
+ *   {
+ *     SENTIENT_PROBE("mqtt_loop");
+ *     sentient.loop();
+ *   }
+ *   SENTIENT_PROFILE_REPORT(sentient, 10000); // metrics/profile every 10 s
+ *
+ * A probe costs two counter reads and a bucket increment. Buckets are
+ * log-linear: four per power of two of cycles, so a percentile read from
+ * them is within 25% (exact below 8 cycles); the maximum is kept exactly.
+ * Each report gives count, mean, p50, p99, max and the share of the window
+ * spent in the probe, then starts a new window.
+ *
+ * Profiling is off unless the sketch defines SENTIENT_PROFILE as 1 before
+ * including SentientMQTT.h. Off, both macros expand to nothing, no probe
+ * exists and the reporting code is discarded at link time.
+ *
+ * Probes are for loop() context; do not place them in interrupt handlers.
+ */
+
+#ifndef SENTIENT_PROFILER_H
+#define SENTIENT_PROFILER_H
+
+#include <Arduino.h>
+
+#ifndef SENTIENT_PROFILE
+#define SENTIENT_PROFILE 0
+#endif
+
+class SentientMQTT;
+
+class SentientProbe
+{
+public:
+  static constexpr uint8_t kSubBits = 2; // Buckets per power of two: 1 << kSubBits
+  static constexpr uint8_t kBuckets = (32 - kSubBits) * (1u << kSubBits) + (1u << kSubBits);
+
+  explicit SentientProbe(const char *name);
+  SentientProbe(const SentientProbe &) = delete;
+  SentientProbe &operator=(const SentientProbe &) = delete;
+
+  static uint32_t cycles()
+  {
+#if defined(__IMXRT1062__)
+    return ARM_DWT_CYCCNT;
+#else
+    return micros();
+#endif
+  }
+
+  void record(uint32_t elapsed)
+  {
+    ++_buckets[bucketOf(elapsed)];
+    ++_count;
+    _total += elapsed;
+    if (elapsed > _max)
+    {
+      _max = elapsed;
+    }
+  }
+
+  static uint8_t bucketOf(uint32_t value)
+  {
+    constexpr uint32_t kExact = 1u << kSubBits;
+    if (value < kExact)
+    {
+      return (uint8_t)value;
+    }
+    const uint8_t exponent = 31 - __builtin_clz(value);
+    const uint8_t sub = (value >> (exponent - kSubBits)) & (kExact - 1);
+    return (uint8_t)((exponent - kSubBits + 1) * kExact + sub);
+  }
+  static uint32_t bucketUpper(uint8_t bucket); // Largest value that lands in the bucket
+
+  const char *name() const { return _name; }
+  uint32_t count() const { return _count; }
+  uint32_t maxCycles() const { return _max; }
+  uint64_t totalCycles() const { return _total; }
+  uint32_t percentileCycles(uint8_t percent) const;
+  void reset();
+
+  static SentientProbe *first() { return s_first; }
+  SentientProbe *next() const { return _next; }
+
+private:
+  const char *_name;
+  uint32_t _buckets[kBuckets] = {};
+  uint32_t _count = 0;
+  uint32_t _max = 0;
+  uint64_t _total = 0;
+  SentientProbe *_next = nullptr;
+
+  static SentientProbe *s_first;
+};
+
+// Times its own lifetime into a probe
+class SentientProbeScope
+{
+public:
+  explicit SentientProbeScope(SentientProbe &probe) : _probe(probe), _start(SentientProbe::cycles()) {}
+  ~SentientProbeScope() { _probe.record(SentientProbe::cycles() - _start); }
+  SentientProbeScope(const SentientProbeScope &) = delete;
+  SentientProbeScope &operator=(const SentientProbeScope &) = delete;
+
+private:
+  SentientProbe &_probe;
+  uint32_t _start;
+};
+
+class SentientProfiler
+{
+public:
+  // Publish every probe on metrics/profile and start a new window
+  static bool publish(SentientMQTT &mqtt);
+  // publish() once intervalMs has passed since the last report; call every loop()
+  static bool report(SentientMQTT &mqtt, uint32_t intervalMs);
+
+  static float cyclesToMicros(uint64_t cycles);
+};
+
+#if SENTIENT_PROFILE
+#define SENTIENT_PROBE_JOIN_(a, b) a##b
+#define SENTIENT_PROBE_JOIN(a, b) SENTIENT_PROBE_JOIN_(a, b)
+#define SENTIENT_PROBE(name)                                                  \
+  static SentientProbe SENTIENT_PROBE_JOIN(sentientProbe_, __LINE__)(name); \
+  SentientProbeScope SENTIENT_PROBE_JOIN(sentientProbeScope_, __LINE__)(SENTIENT_PROBE_JOIN(sentientProbe_, __LINE__))
+#define SENTIENT_PROFILE_REPORT(mqtt, intervalMs) SentientProfiler::report((mqtt), (intervalMs))
+#else
+#define SENTIENT_PROBE(name) \
+  do                         \
+  {                          \
+  } while (0)
+#define SENTIENT_PROFILE_REPORT(mqtt, intervalMs) \
+  do                                              \
+  {                                               \
+  } while (0)
+#endif
+
+#endif // SENTIENT_PROFILER_H
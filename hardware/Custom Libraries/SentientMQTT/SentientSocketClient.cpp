@@ -0,0 +1,334 @@
+#include "SentientSocketClient.h"
+
+#if !defined(ESP32)
+
+#include <cstring>
+
+bool SentientSocketClient::beginConnect(const IPAddress &ip, uint16_t port)
+{
+  stop();
+
+  _socket = fnet_socket(AF_INET, SOCK_STREAM, 0);
+  if (!_socket)
+  {
+    return false;
+  }
+
+  struct fnet_sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_port = FNET_HTONS(port);
+  address.sin_addr.s_addr = static_cast<uint32_t>(ip);
+
+  // FNET sockets are non-blocking: connect() only queues the SYN and the
+  // handshake progresses from the stack's timer/ISR context.
+  fnet_socket_connect(_socket, reinterpret_cast<struct fnet_sockaddr *>(&address), sizeof(address));
+  _connectStartedAt = millis();
+
+  if (socketState() == SS_UNCONNECTED)
+  {
+    stop();
+    return false;
+  }
+  return true;
+}
+
+SentientSocketClient::ConnectStatus SentientSocketClient::pollConnect()
+{
+  if (!_socket)
+  {
+    return ConnectStatus::Idle;
+  }
+
+  switch (socketState())
+  {
+  case SS_CONNECTED:
+    return ConnectStatus::Connected;
+  case SS_CONNECTING:
+    return ConnectStatus::Pending;
+  default:
+    // Refused (RST) or aborted by the stack
+    stop();
+    return ConnectStatus::Failed;
+  }
+}
+
+size_t SentientSocketClient::peekBytes(uint8_t *buffer, size_t length)
+{
+  if (_rxTail - _rxHead < length)
+  {
+    fillReceiveBuffer();
+  }
+  const size_t buffered = _rxTail - _rxHead;
+  if (length > buffered)
+  {
+    length = buffered;
+  }
+  memcpy(buffer, _rxBuffer + _rxHead, length);
+  return length;
+}
+
+int SentientSocketClient::connect(IPAddress ip, uint16_t port)
+{
+  // Blocking form kept for PubSubClient; SentientMQTT never reaches it because
+  // the socket is already connected by the time PubSubClient::connect() runs.
+  if (!beginConnect(ip, port))
+  {
+    return 0;
+  }
+  while (millis() - _connectStartedAt < _timeoutMs)
+  {
+    const ConnectStatus status = pollConnect();
+    if (status == ConnectStatus::Connected)
+    {
+      return 1;
+    }
+    if (status == ConnectStatus::Failed)
+    {
+      return 0;
+    }
+    yield();
+  }
+  stop();
+  return 0;
+}
+
+int SentientSocketClient::connect(const char *host, uint16_t port)
+{
+  // Name resolution happens in SentientMQTT's resolve step
+  (void)host;
+  (void)port;
+  return 0;
+}
+
+size_t SentientSocketClient::write(uint8_t b)
+{
+  return write(&b, 1);
+}
+
+size_t SentientSocketClient::write(const uint8_t *buffer, size_t size)
+{
+  if (_discardWrites)
+  {
+    return size;
+  }
+  if (!_socket)
+  {
+    setWriteError();
+    return 0;
+  }
+
+  // A full send queue means a burst the link is still draining, or a dead
+  // peer. Nothing is sent until the whole write fits: if the room does not
+  // come in time the write fails with the stream intact, so PubSubClient
+  // fails that one publish and the connection is kept. The wait grows with
+  // the bytes that do not fit yet, since those wait on the peer's ACKs.
+  fnet_uint32_t capacity = 0;
+  fnet_uint32_t queued = 0;
+  uint32_t waitUs = 0;
+  const uint32_t started = micros();
+  for (bool first = true;; first = false)
+  {
+    if (!sendQueue(capacity, queued))
+    {
+      setWriteError();
+      return 0;
+    }
+    const size_t free = queued < capacity ? capacity - queued : 0;
+    if (first)
+    {
+      const size_t missing = size > free ? size - free : 0;
+      waitUs = SENTIENT_SOCKET_WRITE_WAIT_US + missing * SENTIENT_SOCKET_WRITE_WAIT_PER_KB_US / 1024;
+    }
+    // Writes larger than the whole queue start once it is empty
+    if (free >= (size < capacity ? size : capacity))
+    {
+      break;
+    }
+    if (micros() - started >= waitUs)
+    {
+      setWriteError();
+      return 0;
+    }
+  }
+
+  // Once started the write has to finish: a truncated MQTT frame cannot be
+  // resumed, so running out of time part way drops the connection.
+  size_t sent = 0;
+  while (sent < size)
+  {
+    const fnet_int32_t result = fnet_socket_send(_socket, buffer + sent, size - sent, 0);
+    if (result == FNET_ERR)
+    {
+      setWriteError();
+      stop();
+      return sent;
+    }
+    sent += static_cast<size_t>(result);
+    if (sent < size && micros() - started >= waitUs)
+    {
+      setWriteError();
+      stop();
+      return sent;
+    }
+  }
+  return sent;
+}
+
+int SentientSocketClient::availableForWrite()
+{
+  fnet_uint32_t capacity = 0;
+  fnet_uint32_t queued = 0;
+  if (!sendQueue(capacity, queued))
+  {
+    return 0;
+  }
+  return queued < capacity ? static_cast<int>(capacity - queued) : 0;
+}
+
+bool SentientSocketClient::hasRoomFor(size_t bytes)
+{
+  fnet_uint32_t capacity = 0;
+  fnet_uint32_t queued = 0;
+  if (!sendQueue(capacity, queued))
+  {
+    return false;
+  }
+  // More than the whole queue holds: start once it is empty and let write() stream the rest
+  if (bytes > capacity)
+  {
+    bytes = capacity;
+  }
+  return queued + bytes <= capacity;
+}
+
+bool SentientSocketClient::sendQueue(fnet_uint32_t &capacity, fnet_uint32_t &queued) const
+{
+  if (!_socket)
+  {
+    return false;
+  }
+  fnet_size_t length = sizeof(capacity);
+  if (fnet_socket_getopt(_socket, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<fnet_uint8_t *>(&capacity), &length) ==
+      FNET_ERR)
+  {
+    return false;
+  }
+  length = sizeof(queued);
+  return fnet_socket_getopt(_socket, SOL_SOCKET, SO_SNDNUM, reinterpret_cast<fnet_uint8_t *>(&queued), &length) !=
+         FNET_ERR;
+}
+
+int SentientSocketClient::available()
+{
+  if (_rxHead == _rxTail)
+  {
+    fillReceiveBuffer();
+  }
+  return static_cast<int>(_rxTail - _rxHead);
+}
+
+int SentientSocketClient::read()
+{
+  if (!available())
+  {
+    return -1;
+  }
+  return _rxBuffer[_rxHead++];
+}
+
+int SentientSocketClient::read(uint8_t *buffer, size_t size)
+{
+  size_t copied = 0;
+  while (copied < size && available())
+  {
+    size_t chunk = _rxTail - _rxHead;
+    if (chunk > size - copied)
+    {
+      chunk = size - copied;
+    }
+    memcpy(buffer + copied, _rxBuffer + _rxHead, chunk);
+    _rxHead += chunk;
+    copied += chunk;
+  }
+  return copied ? static_cast<int>(copied) : -1;
+}
+
+int SentientSocketClient::peek()
+{
+  if (!available())
+  {
+    return -1;
+  }
+  return _rxBuffer[_rxHead];
+}
+
+void SentientSocketClient::flush()
+{
+  // Writes go straight to the FNET send queue; nothing is held back here
+}
+
+void SentientSocketClient::stop()
+{
+  if (_socket)
+  {
+    fnet_socket_close(_socket);
+    _socket = nullptr;
+  }
+  _rxHead = 0;
+  _rxTail = 0;
+  _discardWrites = false;
+}
+
+uint8_t SentientSocketClient::connected()
+{
+  if (_rxHead != _rxTail)
+  {
+    return 1;
+  }
+  return (_socket && socketState() == SS_CONNECTED) ? 1 : 0;
+}
+
+bool SentientSocketClient::fillReceiveBuffer()
+{
+  if (!_socket)
+  {
+    return false;
+  }
+
+  // Compact unread bytes to the front so partial packets can accumulate
+  const size_t buffered = _rxTail - _rxHead;
+  if (_rxHead > 0)
+  {
+    memmove(_rxBuffer, _rxBuffer + _rxHead, buffered);
+    _rxHead = 0;
+    _rxTail = buffered;
+  }
+  if (_rxTail == sizeof(_rxBuffer))
+  {
+    return true;
+  }
+
+  const fnet_int32_t received = fnet_socket_recv(_socket, _rxBuffer + _rxTail, sizeof(_rxBuffer) - _rxTail, 0);
+  if (received == FNET_ERR)
+  {
+    // Reset by peer or stack error: make connected() report the loss
+    stop();
+    return false;
+  }
+  _rxTail += static_cast<size_t>(received);
+  return received > 0;
+}
+
+fnet_socket_state_t SentientSocketClient::socketState() const
+{
+  fnet_socket_state_t state = SS_UNCONNECTED;
+  fnet_size_t length = sizeof(state);
+  if (fnet_socket_getopt(_socket, SOL_SOCKET, SO_STATE, reinterpret_cast<fnet_uint8_t *>(&state), &length) == FNET_ERR)
+  {
+    return SS_UNCONNECTED;
+  }
+  return state;
+}
+
+#endif // !ESP32
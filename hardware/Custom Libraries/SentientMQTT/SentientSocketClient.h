@@ -0,0 +1,106 @@
+/*
+ * SentientSocketClient.h
+ *
+ * Non-blocking TCP client for Teensy 4.1, built directly on FNET sockets.
+ *
+ * EthernetClient::connect() spins until the handshake completes or its
+ * timeout expires, which stalls loop() for the whole timeout whenever the
+ * broker is down. This client splits the connect into beginConnect() and
+ * pollConnect() so SentientMQTT can advance the connection one step per
+ * loop(), and buffers received bytes so the CONNACK can be inspected
+ * before PubSubClient consumes it.
+ *
+ * Everything else implements the Arduino Client interface, so PubSubClient
+ * uses it exactly like an EthernetClient. Writes never wait long. A write
+ * only starts once the send queue can take all of it; if that takes longer
+ * than SENTIENT_SOCKET_WRITE_WAIT_US (plus SENTIENT_SOCKET_WRITE_WAIT_PER_KB_US
+ * for each KB that does not fit yet) it returns 0 with nothing sent and the
+ * connection kept, so a briefly full queue fails one publish rather than the
+ * session. Only a write that runs out of time part way through drops the
+ * connection, since a truncated MQTT frame cannot be resumed. hasRoomFor()
+ * and availableForWrite() let callers check for room before starting a
+ * packet.
+ */
+
+#ifndef SENTIENT_SOCKET_CLIENT_H
+#define SENTIENT_SOCKET_CLIENT_H
+
+#if !defined(ESP32)
+
+#include <Arduino.h>
+#include <Client.h>
+#include <fnet.h>
+
+#ifndef SENTIENT_SOCKET_RX_BUFFER
+#define SENTIENT_SOCKET_RX_BUFFER 256 // Receive staging buffer; PubSubClient drains it byte by byte
+#endif
+#ifndef SENTIENT_SOCKET_WRITE_WAIT_US
+#define SENTIENT_SOCKET_WRITE_WAIT_US 300 // Longest a write waits for send queue room before failing
+#endif
+#ifndef SENTIENT_SOCKET_WRITE_WAIT_PER_KB_US
+#define SENTIENT_SOCKET_WRITE_WAIT_PER_KB_US 1'000 // Added per KB the queue cannot take yet (waits on TCP ACKs)
+#endif
+
+class SentientSocketClient : public Client
+{
+public:
+  enum class ConnectStatus : uint8_t
+  {
+    Idle,
+    Pending,
+    Connected,
+    Failed
+  };
+
+  SentientSocketClient() = default;
+  SentientSocketClient(const SentientSocketClient &) = delete;
+  SentientSocketClient &operator=(const SentientSocketClient &) = delete;
+  ~SentientSocketClient() { stop(); }
+
+  // Open the socket and start the TCP handshake; never waits
+  bool beginConnect(const IPAddress &ip, uint16_t port);
+  ConnectStatus pollConnect();
+
+  // Copy up to length buffered bytes without consuming them
+  size_t peekBytes(uint8_t *buffer, size_t length);
+
+  // Swallow writes while PubSubClient replays a CONNECT we already sent
+  void setDiscardWrites(bool discard) { _discardWrites = discard; }
+
+  // Upper bound for the blocking connect() (PubSubClient's fallback path)
+  void setConnectionTimeout(uint16_t timeoutMs) { _timeoutMs = timeoutMs; }
+
+  int connect(IPAddress ip, uint16_t port) override;
+  int connect(const char *host, uint16_t port) override;
+  size_t write(uint8_t b) override;
+  size_t write(const uint8_t *buffer, size_t size) override;
+  int availableForWrite() override; // Free bytes in the socket's send queue
+  // Whether a packet of this size can start without waiting (oversized packets: once the queue is empty)
+  bool hasRoomFor(size_t bytes);
+  int available() override;
+  int read() override;
+  int read(uint8_t *buffer, size_t size) override;
+  int peek() override;
+  void flush() override;
+  void stop() override;
+  uint8_t connected() override;
+  operator bool() override { return _socket != nullptr; }
+
+private:
+  bool fillReceiveBuffer();
+  bool sendQueue(fnet_uint32_t &capacity, fnet_uint32_t &queued) const;
+  fnet_socket_state_t socketState() const;
+
+  fnet_socket_t _socket = nullptr;
+  uint32_t _connectStartedAt = 0;
+  uint16_t _timeoutMs = 1'000;
+  bool _discardWrites = false;
+
+  uint8_t _rxBuffer[SENTIENT_SOCKET_RX_BUFFER];
+  size_t _rxHead = 0;
+  size_t _rxTail = 0;
+};
+
+#endif // !ESP32
+
+#endif // SENTIENT_SOCKET_CLIENT_H
@@ -0,0 +1,386 @@
+#include "SentientTaskScheduler.h"
+#include "SentientMQTT.h"
+
+namespace
+{
+constexpr uint32_t kMaxPeriodUs = 0x7FFFFFFFu; // Due times are compared as signed micros() differences
+
+inline uint32_t msToUs(uint32_t ms)
+{
+  return ms > kMaxPeriodUs / 1000 ? kMaxPeriodUs : ms * 1000;
+}
+}
+
+#if defined(__IMXRT1062__)
+SentientTaskScheduler *SentientTaskScheduler::s_activeInstance = nullptr;
+
+void SentientTaskScheduler::timerThunk()
+{
+  if (s_activeInstance)
+  {
+    s_activeInstance->tick();
+  }
+}
+#endif
+
+int SentientTaskScheduler::add(const char *name, SentientTaskFunction function, void *context)
+{
+  if (!function)
+  {
+    return -1;
+  }
+  if (_count >= SENTIENT_TASKS)
+  {
+    Serial.println(F("[SentientTasks] Too many tasks (raise SENTIENT_TASKS)"));
+    return -1;
+  }
+  Task &task = _tasks[_count];
+  task = Task{};
+  task.name = name ? name : "task";
+  task.function = function;
+  task.context = context;
+  return _count++;
+}
+
+int SentientTaskScheduler::every(const char *name, uint32_t periodMs, SentientTaskFunction function, void *context,
+                                 uint8_t priority, uint32_t deadlineMs)
+{
+  const int index = add(name, function, context);
+  if (index < 0)
+  {
+    return -1;
+  }
+  Task &task = _tasks[index];
+  task.taskClass = SentientTaskClass::Soft;
+  task.priority = priority;
+  task.periodic = true;
+  task.periodUs = msToUs(periodMs > 0 ? periodMs : 1);
+  task.deadlineUs = deadlineMs > 0 ? msToUs(deadlineMs) : task.periodUs;
+  task.dueUs = micros();
+  task.enabled = true;
+  return index;
+}
+
+int SentientTaskScheduler::after(const char *name, uint32_t delayMs, SentientTaskFunction function, void *context,
+                                 uint8_t priority, uint32_t deadlineMs)
+{
+  const int index = add(name, function, context);
+  if (index < 0)
+  {
+    return -1;
+  }
+  Task &task = _tasks[index];
+  task.taskClass = SentientTaskClass::Soft;
+  task.priority = priority;
+  task.periodic = false;
+  task.deadlineUs = deadlineMs > 0 ? msToUs(deadlineMs) : kMaxPeriodUs;
+  task.dueUs = micros() + msToUs(delayMs);
+  task.enabled = true;
+  return index;
+}
+
+int SentientTaskScheduler::everyHard(const char *name, uint32_t periodUs, SentientTaskFunction function, void *context)
+{
+  const int index = add(name, function, context);
+  if (index < 0)
+  {
+    return -1;
+  }
+  Task &task = _tasks[index];
+  task.taskClass = SentientTaskClass::Hard;
+  task.priority = UINT8_MAX;
+  task.periodic = true;
+  task.periodTicks = (periodUs + SENTIENT_TASK_HARD_TICK_US / 2) / SENTIENT_TASK_HARD_TICK_US;
+  if (task.periodTicks == 0)
+  {
+    task.periodTicks = 1;
+  }
+  task.periodUs = task.periodTicks * SENTIENT_TASK_HARD_TICK_US;
+  task.deadlineUs = task.periodUs;
+  task.countdown = task.periodTicks;
+  task.enabled = true;
+  armTimer();
+  return index;
+}
+
+bool SentientTaskScheduler::restart(int task, uint32_t delayMs)
+{
+  if (task < 0 || task >= _count || _tasks[task].taskClass != SentientTaskClass::Soft)
+  {
+    return false;
+  }
+  _tasks[task].dueUs = micros() + msToUs(delayMs);
+  _tasks[task].enabled = true;
+  ++_tasks[task].generation;
+  return true;
+}
+
+bool SentientTaskScheduler::setPeriod(int task, uint32_t periodMs)
+{
+  if (task < 0 || task >= _count || !_tasks[task].periodic || _tasks[task].taskClass != SentientTaskClass::Soft)
+  {
+    return false;
+  }
+  Task &t = _tasks[task];
+  const bool deadlineWasPeriod = t.deadlineUs == t.periodUs;
+  t.periodUs = msToUs(periodMs > 0 ? periodMs : 1);
+  if (deadlineWasPeriod)
+  {
+    t.deadlineUs = t.periodUs;
+  }
+  return true;
+}
+
+void SentientTaskScheduler::suspend(int task)
+{
+  if (task >= 0 && task < _count)
+  {
+    _tasks[task].enabled = false;
+    ++_tasks[task].generation;
+  }
+}
+
+void SentientTaskScheduler::resume(int task)
+{
+  if (task < 0 || task >= _count || _tasks[task].enabled)
+  {
+    return;
+  }
+  Task &t = _tasks[task];
+  if (t.taskClass == SentientTaskClass::Soft)
+  {
+    t.dueUs = micros(); // Resume now rather than catch up on the suspended periods
+  }
+  else
+  {
+    t.countdown = t.periodTicks;
+  }
+  t.enabled = true;
+  ++t.generation;
+}
+
+void SentientTaskScheduler::run()
+{
+  // Each pass picks again, so a higher priority task that fell due while a
+  // slow one ran goes next; the bound keeps an overloaded set from pinning loop()
+  for (uint8_t pass = 0; pass < _count; ++pass)
+  {
+    const uint32_t now = micros();
+    Task *pick = nullptr;
+    for (uint8_t i = 0; i < _count; ++i)
+    {
+      Task &task = _tasks[i];
+      if (task.taskClass != SentientTaskClass::Soft || !task.enabled || (int32_t)(task.dueUs - now) > 0)
+      {
+        continue;
+      }
+      if (!pick || task.priority > pick->priority ||
+          (task.priority == pick->priority &&
+           (int32_t)((task.dueUs + task.deadlineUs) - (pick->dueUs + pick->deadlineUs)) < 0))
+      {
+        pick = &task;
+      }
+    }
+    if (!pick)
+    {
+      return;
+    }
+    execute(*pick);
+  }
+}
+
+uint32_t SentientTaskScheduler::msUntilNext() const
+{
+  const uint32_t now = micros();
+  uint32_t next = UINT32_MAX;
+  for (uint8_t i = 0; i < _count; ++i)
+  {
+    const Task &task = _tasks[i];
+    if (task.taskClass != SentientTaskClass::Soft || !task.enabled)
+    {
+      continue;
+    }
+    const int32_t until = (int32_t)(task.dueUs - now);
+    if (until <= 0)
+    {
+      return 0;
+    }
+    const uint32_t ms = (uint32_t)until / 1000;
+    if (ms < next)
+    {
+      next = ms;
+    }
+  }
+  return next;
+}
+
+void SentientTaskScheduler::execute(Task &task)
+{
+  const uint32_t due = task.dueUs;
+  const uint32_t generation = task.generation;
+  const uint32_t started = micros();
+  task.function(task.context);
+  const uint32_t finished = micros();
+  record(task, started, finished, due);
+
+  if (task.generation != generation)
+  {
+    return; // The task restarted, suspended or resumed itself; keep what it asked for
+  }
+  if (!task.periodic)
+  {
+    task.enabled = false;
+    return;
+  }
+  task.dueUs = due + task.periodUs;
+  if ((int32_t)(task.dueUs - finished) <= 0)
+  {
+    // A whole period behind: drop what was missed instead of running back to back
+    const uint32_t missed = (finished - task.dueUs) / task.periodUs + 1;
+    task.skipped = task.skipped + missed;
+    task.dueUs += missed * task.periodUs;
+  }
+}
+
+void SentientTaskScheduler::record(Task &task, uint32_t started, uint32_t finished, uint32_t due)
+{
+  const uint32_t elapsed = finished - started;
+  task.runs = task.runs + 1;
+  task.lastUs = elapsed;
+  task.totalUs = task.totalUs + elapsed;
+  if (elapsed > task.maxUs)
+  {
+    task.maxUs = elapsed;
+  }
+  const int32_t jitter = (int32_t)(started - due);
+  if (jitter > 0 && (uint32_t)jitter > task.maxJitterUs)
+  {
+    task.maxJitterUs = (uint32_t)jitter;
+  }
+  if ((int32_t)(finished - (due + task.deadlineUs)) > 0)
+  {
+    task.overruns = task.overruns + 1;
+  }
+}
+
+void SentientTaskScheduler::tick()
+{
+  for (uint8_t i = 0; i < _count; ++i)
+  {
+    Task &task = _tasks[i];
+    if (task.taskClass != SentientTaskClass::Hard || !task.enabled || --task.countdown != 0)
+    {
+      continue;
+    }
+    task.countdown = task.periodTicks;
+    // The tick is the due time; lateness is interrupt latency, not measured here
+    const uint32_t started = micros();
+    task.function(task.context);
+    record(task, started, micros(), started);
+  }
+}
+
+bool SentientTaskScheduler::stats(int task, SentientTaskStats &out) const
+{
+  if (task < 0 || task >= _count)
+  {
+    return false;
+  }
+  const Task &t = _tasks[task];
+  // Hard task counters change in the ISR; copy them in one piece
+  noInterrupts();
+  out.name = t.name;
+  out.taskClass = t.taskClass;
+  out.priority = t.priority;
+  out.periodUs = t.periodic ? t.periodUs : 0;
+  out.runs = t.runs;
+  out.lastUs = t.lastUs;
+  out.maxUs = t.maxUs;
+  out.totalUs = t.totalUs;
+  out.overruns = t.overruns;
+  out.skipped = t.skipped;
+  out.maxJitterUs = t.maxJitterUs;
+  interrupts();
+  return true;
+}
+
+void SentientTaskScheduler::resetPeaks()
+{
+  noInterrupts();
+  for (uint8_t i = 0; i < _count; ++i)
+  {
+    _tasks[i].maxUs = 0;
+    _tasks[i].maxJitterUs = 0;
+  }
+  interrupts();
+}
+
+bool SentientTaskScheduler::publishMetrics(SentientMQTT &mqtt, bool resetPeaksAfter)
+{
+  JsonDocument &doc = mqtt.scratchDocument();
+  JsonArray tasks = doc["tasks"].to<JsonArray>();
+  for (uint8_t i = 0; i < _count; ++i)
+  {
+    SentientTaskStats s{};
+    stats(i, s);
+    JsonObject task = tasks.add<JsonObject>();
+    task["name"] = s.name;
+    task["class"] = s.taskClass == SentientTaskClass::Hard ? "hard" : "soft";
+    task["priority"] = s.priority;
+    task["period_us"] = s.periodUs;
+    task["runs"] = s.runs;
+    task["last_us"] = s.lastUs;
+    task["mean_us"] = s.runs ? (uint32_t)(s.totalUs / s.runs) : 0;
+    task["max_us"] = s.maxUs;
+    task["max_jitter_us"] = s.maxJitterUs;
+    task["overruns"] = s.overruns;
+    task["skipped"] = s.skipped;
+  }
+  doc["timestamp"] = millis() / 1000;
+
+  const bool ok = mqtt.publishJson("metrics", "tasks", doc);
+  if (resetPeaksAfter)
+  {
+    resetPeaks();
+  }
+  return ok;
+}
+
+int SentientTaskScheduler::reportEvery(SentientMQTT &mqtt, uint32_t intervalMs)
+{
+  _reportMqtt = &mqtt;
+  const int index = every("task_report", intervalMs, reportTask, this);
+  if (index >= 0)
+  {
+    // First report after one interval, not at startup
+    restart(index, intervalMs);
+  }
+  return index;
+}
+
+void SentientTaskScheduler::reportTask(void *context)
+{
+  SentientTaskScheduler *self = static_cast<SentientTaskScheduler *>(context);
+  if (self->_reportMqtt && self->_reportMqtt->isConnected())
+  {
+    self->publishMetrics(*self->_reportMqtt);
+  }
+}
+
+void SentientTaskScheduler::armTimer()
+{
+  if (_timerArmed)
+  {
+    return;
+  }
+#if defined(__IMXRT1062__)
+  s_activeInstance = this;
+  // All IntervalTimers share IRQ_PIT, which runs at the highest priority any
+  // of them asked for; this only matters when the scheduler's timer is the
+  // sole one. With a step engine or pulse outputs running, hard tasks share
+  // their ISR and delay its edges by their own run time.
+  _timer.priority(64);
+  _timer.begin(timerThunk, SENTIENT_TASK_HARD_TICK_US);
+#endif
+  _timerArmed = true;
+}
@@ -0,0 +1,159 @@
+/*
+ * SentientTaskScheduler.h
+ *
+ * Periodic and one-shot tasks for a controller's loop(), in place of
+ * hand-written "millis() - last_x >= INTERVAL" checks.
+ *
+ * Soft tasks run cooperatively from run(), called every loop(). Of the tasks
+ * that are due, the highest priority runs first and equal priorities go
+ * earliest deadline first; after each task the choice is made again, so a
+ * slow task delays lower priorities, not higher ones that fell due meanwhile.
+ * A periodic task is due again one period after its previous due time, so
+ * it keeps its rate; if it falls a whole period behind, the missed periods
+ * are dropped and counted rather than run back to back.
+ *
+ * Hard tasks run from a timer interrupt (IntervalTimer/PIT on Teensy 4)
+ * ticking every SENTIENT_TASK_HARD_TICK_US, so they keep time however long
+ * loop() takes. They must be short and ISR-safe: no MQTT, no JSON, no
+ * Serial. On Teensy 4 every IntervalTimer shares one interrupt (IRQ_PIT),
+ * so a hard task runs in the same ISR as SentientStepEngine and
+ * SentientPulseOutputs and adds its run time to their step and pulse
+ * jitter; keep hard tasks to a few microseconds.
+ *
+ * Every task records its run count, execution time (last, mean, max),
+ * overruns (finished after its deadline), dropped periods and start jitter
+ * (how late after its due time it started). publishMetrics() sends them on
+ * the metrics/tasks topic; reportEvery() schedules that as a task itself.
+ *
+ * Off-target builds (host simulation) have no timer: call tick() once per
+ * hard tick.
+ */
+
+#ifndef SENTIENT_TASK_SCHEDULER_H
+#define SENTIENT_TASK_SCHEDULER_H
+
+#include <Arduino.h>
+
+#if defined(__IMXRT1062__)
+#include <IntervalTimer.h>
+#endif
+
+#ifndef SENTIENT_TASKS
+#define SENTIENT_TASKS 16 // Soft and hard tasks per scheduler
+#endif
+#ifndef SENTIENT_TASK_HARD_TICK_US
+#define SENTIENT_TASK_HARD_TICK_US 250 // Hard task periods are rounded to whole ticks
+#endif
+
+class SentientMQTT;
+
+enum class SentientTaskClass : uint8_t
+{
+  Soft, // Cooperative, from run() in loop()
+  Hard  // From the timer interrupt
+};
+
+using SentientTaskFunction = void (*)(void *context);
+
+struct SentientTaskStats
+{
+  const char *name;
+  SentientTaskClass taskClass;
+  uint8_t priority;
+  uint32_t periodUs;    // 0 for a one-shot
+  uint32_t runs;
+  uint32_t lastUs;      // Execution time of the latest run
+  uint32_t maxUs;       // Longest run since resetPeaks()
+  uint64_t totalUs;     // For the mean
+  uint32_t overruns;    // Runs that finished after their deadline
+  uint32_t skipped;     // Periods dropped after falling a whole period behind
+  uint32_t maxJitterUs; // Latest start after the due time since resetPeaks()
+};
+
+class SentientTaskScheduler
+{
+public:
+  SentientTaskScheduler() = default;
+  SentientTaskScheduler(const SentientTaskScheduler &) = delete;
+  SentientTaskScheduler &operator=(const SentientTaskScheduler &) = delete;
+
+  // Soft tasks; a deadline of 0 means the period (one-shots: no deadline).
+  // Higher priority runs first. All return the task index or -1.
+  int every(const char *name, uint32_t periodMs, SentientTaskFunction function, void *context = nullptr,
+            uint8_t priority = 0, uint32_t deadlineMs = 0);
+  int after(const char *name, uint32_t delayMs, SentientTaskFunction function, void *context = nullptr,
+            uint8_t priority = 0, uint32_t deadlineMs = 0);
+
+  // Hard task, run from the timer interrupt every periodUs (whole ticks)
+  int everyHard(const char *name, uint32_t periodUs, SentientTaskFunction function, void *context = nullptr);
+
+  // Make a soft task due delayMs from now; re-arms a one-shot that has run.
+  // Safe from inside the task itself: a task that restarts, suspends or
+  // resumes itself keeps that in place of its usual rescheduling.
+  bool restart(int task, uint32_t delayMs = 0);
+  bool setPeriod(int task, uint32_t periodMs);
+  void suspend(int task);
+  void resume(int task);
+
+  // Call every loop(): runs the soft tasks that are due
+  void run();
+  // Until the next soft task is due (0: one is due now); for SentientMQTT::idle()
+  uint32_t msUntilNext() const;
+
+  uint8_t count() const { return _count; }
+  bool stats(int task, SentientTaskStats &out) const;
+  void resetPeaks();
+
+  // One document with every task's statistics on metrics/tasks
+  bool publishMetrics(SentientMQTT &mqtt, bool resetPeaksAfter = true);
+  int reportEvery(SentientMQTT &mqtt, uint32_t intervalMs = 30'000);
+
+  // One hard tick. Runs from the timer ISR on target; host simulations call
+  // it directly.
+  void tick();
+
+private:
+  struct Task
+  {
+    const char *name;
+    SentientTaskFunction function;
+    void *context;
+    SentientTaskClass taskClass;
+    uint8_t priority;
+    bool periodic;
+    volatile bool enabled;
+    uint32_t periodUs;
+    uint32_t deadlineUs;  // After the due time
+    uint32_t dueUs;       // Soft: micros() the task is due at
+    uint32_t periodTicks; // Hard: period in timer ticks
+    uint32_t countdown;   // Hard: ticks until the next run
+    uint32_t generation;  // Bumped by restart(), suspend() and resume()
+
+    volatile uint32_t runs;
+    volatile uint32_t lastUs;
+    volatile uint32_t maxUs;
+    volatile uint64_t totalUs;
+    volatile uint32_t overruns;
+    volatile uint32_t skipped;
+    volatile uint32_t maxJitterUs;
+  };
+
+  int add(const char *name, SentientTaskFunction function, void *context);
+  void execute(Task &task);
+  void record(Task &task, uint32_t started, uint32_t finished, uint32_t due);
+  void armTimer();
+  static void reportTask(void *context);
+
+  Task _tasks[SENTIENT_TASKS] = {};
+  uint8_t _count = 0;
+  SentientMQTT *_reportMqtt = nullptr;
+
+#if defined(__IMXRT1062__)
+  IntervalTimer _timer;
+  static SentientTaskScheduler *s_activeInstance;
+  static void timerThunk();
+#endif
+  bool _timerArmed = false;
+};
+
+#endif // SENTIENT_TASK_SCHEDULER_H
@@ -0,0 +1,302 @@
+#include "SentientMotionPlanner.h"
+
+int SentientMotionPlanner::addAxis(const SentientAxisConfig &config)
+{
+  const int index = config.driver == SentientStepperDriver::FourWire
+                        ? _engine.addCoilAxis(config.group, config.coilPins, config.coilSequence)
+                        : _engine.addAxis(config.group, config.pins);
+  if (index < 0)
+  {
+    return -1;
+  }
+  if (config.softLimits && config.minPosition > config.maxPosition)
+  {
+    Serial.println(F("[SentientMotion] Soft limits inverted; minPosition must not exceed maxPosition"));
+  }
+
+  AxisState &state = _axes[index];
+  state.config = config;
+  state.homing = HomingPhase::Idle;
+  state.homed = false;
+  state.coilsHeld = false;
+  _axisCount = index + 1;
+  return index;
+}
+
+bool SentientMotionPlanner::addLimitInput(uint8_t axis, int8_t direction, uint8_t pin, uint8_t activeLevel)
+{
+  return _engine.addLimitInput(axis, direction, pin, activeLevel);
+}
+
+bool SentientMotionPlanner::configureGroup(uint8_t group, const SentientMotionConfig &config)
+{
+  return _engine.configure(group, config);
+}
+
+bool SentientMotionPlanner::moveTo(uint8_t group, const long *targets, float maxRate)
+{
+  const uint8_t size = _engine.groupSize(group);
+  if (size == 0)
+  {
+    return false;
+  }
+  if (_engine.running(group))
+  {
+    _engine.stop(group);
+  }
+
+  long steps[SENTIENT_STEP_GROUP_AXES] = {0};
+  for (uint8_t slot = 0; slot < size; ++slot)
+  {
+    const uint8_t axis = _engine.groupAxis(group, slot);
+    steps[slot] = clampTarget(axis, targets[slot]) - _engine.endPosition(axis);
+  }
+  markMoving(group);
+  return _engine.queueMove(group, steps, maxRate);
+}
+
+bool SentientMotionPlanner::moveAxisTo(uint8_t axis, long target, float maxRate)
+{
+  if (axis >= _axisCount)
+  {
+    return false;
+  }
+  const uint8_t group = _engine.groupOf(axis);
+  if (_engine.running(group))
+  {
+    _engine.stop(group); // Settle the other axes' end positions first
+  }
+
+  long targets[SENTIENT_STEP_GROUP_AXES] = {0};
+  for (uint8_t slot = 0; slot < _engine.groupSize(group); ++slot)
+  {
+    targets[slot] = _engine.endPosition(_engine.groupAxis(group, slot));
+  }
+  targets[_engine.slotOf(axis)] = target;
+  return moveTo(group, targets, maxRate);
+}
+
+bool SentientMotionPlanner::run(uint8_t group, const int8_t *directions, float rate)
+{
+  const uint8_t size = _engine.groupSize(group);
+  if (size == 0)
+  {
+    return false;
+  }
+
+  bool limited = false;
+  for (uint8_t slot = 0; slot < size; ++slot)
+  {
+    limited = limited || (directions[slot] != 0 && _axes[_engine.groupAxis(group, slot)].config.softLimits);
+  }
+  if (!limited)
+  {
+    markMoving(group);
+    return _engine.queueRun(group, directions, rate);
+  }
+
+  // With soft limits a run is a move to the nearest limit along the directions
+  if (_engine.running(group))
+  {
+    _engine.stop(group);
+  }
+  long travel = 0x7FFFFFFFL;
+  for (uint8_t slot = 0; slot < size; ++slot)
+  {
+    const uint8_t axis = _engine.groupAxis(group, slot);
+    const SentientAxisConfig &config = _axes[axis].config;
+    if (directions[slot] == 0 || !config.softLimits)
+    {
+      continue;
+    }
+    const long from = _engine.endPosition(axis);
+    const long room = directions[slot] > 0 ? config.maxPosition - from : from - config.minPosition;
+    if (room < travel)
+    {
+      travel = room;
+    }
+  }
+  if (travel <= 0)
+  {
+    return true; // Already at the limit
+  }
+
+  long steps[SENTIENT_STEP_GROUP_AXES] = {0};
+  for (uint8_t slot = 0; slot < size; ++slot)
+  {
+    steps[slot] = directions[slot] > 0 ? travel : (directions[slot] < 0 ? -travel : 0);
+  }
+  markMoving(group);
+  return _engine.queueMove(group, steps, rate);
+}
+
+bool SentientMotionPlanner::runAxis(uint8_t axis, int8_t direction, float rate)
+{
+  if (axis >= _axisCount)
+  {
+    return false;
+  }
+  int8_t directions[SENTIENT_STEP_GROUP_AXES] = {0};
+  directions[_engine.slotOf(axis)] = direction;
+  return run(_engine.groupOf(axis), directions, rate);
+}
+
+void SentientMotionPlanner::stop(uint8_t group)
+{
+  _engine.stop(group);
+  for (uint8_t i = 0; i < _axisCount; ++i)
+  {
+    if (_engine.groupOf(i) == group)
+    {
+      _axes[i].homing = HomingPhase::Idle;
+    }
+  }
+}
+
+void SentientMotionPlanner::stopAll()
+{
+  for (uint8_t group = 0; group < SENTIENT_STEP_MAX_GROUPS; ++group)
+  {
+    stop(group);
+  }
+}
+
+void SentientMotionPlanner::halt()
+{
+  _engine.halt();
+  for (uint8_t i = 0; i < _axisCount; ++i)
+  {
+    _axes[i].homing = HomingPhase::Idle;
+  }
+}
+
+bool SentientMotionPlanner::home(uint8_t axis)
+{
+  if (axis >= _axisCount)
+  {
+    return false;
+  }
+  const SentientAxisConfig &config = _axes[axis].config;
+  if (config.homeDirection == 0)
+  {
+    Serial.println(F("[SentientMotion] Axis has no homing direction"));
+    return false;
+  }
+  const uint8_t group = _engine.groupOf(axis);
+  if (_engine.busy(group))
+  {
+    Serial.println(F("[SentientMotion] Cannot home while the group is moving"));
+    return false;
+  }
+
+  // Soft limits are not trusted until the axis is homed, so the seek bypasses them
+  long steps[SENTIENT_STEP_GROUP_AXES] = {0};
+  steps[_engine.slotOf(axis)] = config.homeDirection > 0 ? config.homingTravel : -config.homingTravel;
+  const float rate = config.homingRate > 0.0f ? config.homingRate : _engine.startRate(group);
+  markMoving(group);
+  if (!_engine.queueMove(group, steps, rate))
+  {
+    return false;
+  }
+  _axes[axis].homing = HomingPhase::Seeking;
+  _axes[axis].homed = false;
+  return true;
+}
+
+void SentientMotionPlanner::loop()
+{
+  for (uint8_t axis = 0; axis < _axisCount; ++axis)
+  {
+    AxisState &state = _axes[axis];
+    const uint8_t group = _engine.groupOf(axis);
+    if (_engine.busy(group))
+    {
+      continue;
+    }
+
+    if (state.homing == HomingPhase::Seeking)
+    {
+      if (!_engine.limitTripped(group))
+      {
+        state.homing = HomingPhase::Idle;
+        Serial.print(F("[SentientMotion] Homing failed: no limit input within travel on axis "));
+        Serial.println(axis);
+        continue;
+      }
+
+      _engine.setPosition(axis, state.config.homePosition);
+      _tripReported[group] = true; // The trip was the point
+      if (state.config.homingBackoff > 0)
+      {
+        long steps[SENTIENT_STEP_GROUP_AXES] = {0};
+        steps[_engine.slotOf(axis)] = state.config.homeDirection > 0 ? -state.config.homingBackoff : state.config.homingBackoff;
+        const float rate = state.config.homingRate > 0.0f ? state.config.homingRate : _engine.startRate(group);
+        if (_engine.queueMove(group, steps, rate))
+        {
+          state.homing = HomingPhase::BackingOff;
+          continue;
+        }
+      }
+      finishHoming(axis);
+    }
+    else if (state.homing == HomingPhase::BackingOff)
+    {
+      finishHoming(axis);
+    }
+
+    if (state.coilsHeld && state.config.releaseWhenIdle && state.config.driver == SentientStepperDriver::FourWire)
+    {
+      _engine.releaseCoils(axis);
+      state.coilsHeld = false;
+    }
+  }
+
+  for (uint8_t group = 0; group < SENTIENT_STEP_MAX_GROUPS; ++group)
+  {
+    if (_engine.limitTripped(group) && !_tripReported[group])
+    {
+      _tripReported[group] = true;
+      Serial.print(F("[SentientMotion] Group "));
+      Serial.print(group);
+      Serial.println(F(" stopped at a limit input"));
+    }
+  }
+}
+
+long SentientMotionPlanner::clampTarget(uint8_t axis, long target) const
+{
+  const SentientAxisConfig &config = _axes[axis].config;
+  if (!config.softLimits)
+  {
+    return target;
+  }
+  if (target < config.minPosition)
+  {
+    return config.minPosition;
+  }
+  return target > config.maxPosition ? config.maxPosition : target;
+}
+
+void SentientMotionPlanner::markMoving(uint8_t group)
+{
+  _tripReported[group] = false;
+  for (uint8_t i = 0; i < _axisCount; ++i)
+  {
+    if (_engine.groupOf(i) == group)
+    {
+      _axes[i].homing = HomingPhase::Idle;
+      _axes[i].coilsHeld = true;
+    }
+  }
+}
+
+void SentientMotionPlanner::finishHoming(uint8_t axis)
+{
+  AxisState &state = _axes[axis];
+  state.homing = HomingPhase::Idle;
+  state.homed = true;
+  Serial.print(F("[SentientMotion] Axis "));
+  Serial.print(axis);
+  Serial.print(F(" homed at "));
+  Serial.println(_engine.position(axis));
+}
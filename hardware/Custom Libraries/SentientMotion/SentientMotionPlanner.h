@@ -0,0 +1,113 @@
+/*
+ * SentientMotionPlanner.h
+ *
+ * Position-level motion on top of SentientStepEngine: absolute targets,
+ * continuous runs, soft limits and homing, for every stepper controller.
+ *
+ * Each axis is described once by a SentientAxisConfig. Axes sharing a group
+ * move together: moveTo() queues a straight-line segment that starts and ends
+ * on every axis of the group at once, and consecutive moves blend through the
+ * engine's look-ahead. Soft limits clamp targets and turn run() into a move
+ * that stops at the limit. Homing seeks the axis' limit input, zeroes the
+ * position on it (homePosition) and optionally backs off.
+ *
+ * The step pulses themselves never depend on loop(); loop() only advances
+ * homing, releases idle four-wire coils and reports limit trips.
+ */
+
+#ifndef SENTIENT_MOTION_PLANNER_H
+#define SENTIENT_MOTION_PLANNER_H
+
+#include <Arduino.h>
+#include "SentientStepEngine.h"
+
+struct SentientAxisConfig
+{
+  uint8_t group = 0;
+  SentientStepperDriver driver = SentientStepperDriver::StepDir;
+  SentientStepperPins pins = {SENTIENT_NO_PIN, SENTIENT_NO_PIN, SENTIENT_NO_PIN, SENTIENT_NO_PIN, false};
+  uint8_t coilPins[4] = {SENTIENT_NO_PIN, SENTIENT_NO_PIN, SENTIENT_NO_PIN, SENTIENT_NO_PIN}; // FourWire only
+  const uint8_t *coilSequence = SENTIENT_COILS_FULL_STEP;                                     // FourWire only
+  bool releaseWhenIdle = false; // De-energise FourWire coils once the group stops
+
+  bool softLimits = false; // Clamp targets to [minPosition, maxPosition]
+  long minPosition = 0;
+  long maxPosition = 0;
+
+  int8_t homeDirection = 0;   // -1 or +1 towards the homing limit input; 0 = no homing
+  long homePosition = 0;      // Position assigned where the limit input trips
+  long homingTravel = 100000; // Give up after this many steps without a trip
+  long homingBackoff = 0;     // Steps to back away from the input afterwards
+  float homingRate = 0.0f;    // Steps/s while seeking (0 = the group's start rate)
+};
+
+class SentientMotionPlanner
+{
+public:
+  SentientMotionPlanner() = default;
+  SentientMotionPlanner(const SentientMotionPlanner &) = delete;
+  SentientMotionPlanner &operator=(const SentientMotionPlanner &) = delete;
+
+  // Returns the axis index or -1
+  int addAxis(const SentientAxisConfig &config);
+  // An input that stops the axis while it moves towards it (direction -1 or +1)
+  bool addLimitInput(uint8_t axis, int8_t direction, uint8_t pin, uint8_t activeLevel = HIGH);
+  bool configureGroup(uint8_t group, const SentientMotionConfig &config);
+
+  // Queue a move of the whole group to absolute targets, one per axis in the
+  // order they were added. Stops a run() in progress first.
+  bool moveTo(uint8_t group, const long *targets, float maxRate = 0.0f);
+  // Queue a move of one axis; the rest of its group holds still
+  bool moveAxisTo(uint8_t axis, long target, float maxRate = 0.0f);
+
+  // Run the group (direction -1, 0 or +1 per axis) until stop() or a limit
+  bool run(uint8_t group, const int8_t *directions, float rate);
+  bool runAxis(uint8_t axis, int8_t direction, float rate);
+
+  void stop(uint8_t group); // Decelerate to rest
+  void stopAll();
+  void halt(); // Immediately, every group
+
+  bool home(uint8_t axis);
+  void loop();
+
+  bool busy() const { return _engine.busy(); }
+  bool busy(uint8_t group) const { return _engine.busy(group); }
+  bool homing(uint8_t axis) const { return axis < _axisCount && _axes[axis].homing != HomingPhase::Idle; }
+  bool homed(uint8_t axis) const { return axis < _axisCount && _axes[axis].homed; }
+  bool limitTripped(uint8_t group) const { return _engine.limitTripped(group); }
+  bool atLimit(uint8_t axis, int8_t direction) const { return _engine.limitActive(axis, direction); }
+
+  long position(uint8_t axis) const { return _engine.position(axis); }
+  long target(uint8_t axis) const { return _engine.endPosition(axis); }
+  void setPosition(uint8_t axis, long position) { _engine.setPosition(axis, position); }
+
+  SentientStepEngine &engine() { return _engine; }
+
+private:
+  enum class HomingPhase : uint8_t
+  {
+    Idle,
+    Seeking,
+    BackingOff
+  };
+
+  struct AxisState
+  {
+    SentientAxisConfig config;
+    HomingPhase homing;
+    bool homed;
+    bool coilsHeld; // FourWire coils may be energised
+  };
+
+  long clampTarget(uint8_t axis, long target) const;
+  void markMoving(uint8_t group);
+  void finishHoming(uint8_t axis);
+
+  SentientStepEngine _engine;
+  AxisState _axes[SENTIENT_STEP_MAX_AXES] = {};
+  uint8_t _axisCount = 0;
+  bool _tripReported[SENTIENT_STEP_MAX_GROUPS] = {false};
+};
+
+#endif // SENTIENT_MOTION_PLANNER_H
@@ -0,0 +1,962 @@
+#include "SentientStepEngine.h"
+
+const uint8_t SENTIENT_COILS_FULL_STEP[4] = {0b0101, 0b0110, 0b1010, 0b1001};
+const uint8_t SENTIENT_COILS_WAVE[4] = {0b0001, 0b0010, 0b0100, 0b1000};
+
+namespace
+{
+constexpr float kPhasePerStepPerUs = 4294.967296f; // 2^32 / 1e6: phase units per (step/s) per microsecond
+constexpr uint32_t kMaxPhaseRate = 0x7FFFFFFFu;    // Below 2^31 a carry never lands on consecutive ticks
+constexpr uint32_t kMaxRampSteps = (uint32_t)SENTIENT_STEP_RAMP_ENTRIES << 12;
+constexpr uint8_t kQueueMask = SENTIENT_STEP_QUEUE_DEPTH - 1;
+
+static_assert((SENTIENT_STEP_QUEUE_DEPTH & kQueueMask) == 0, "SENTIENT_STEP_QUEUE_DEPTH must be a power of two");
+static_assert(SENTIENT_STEP_MAX_AXES <= 32 && SENTIENT_STEP_MAX_GROUPS <= 32, "Axis and group masks are 32 bits");
+
+constexpr uint8_t kDelayShift = 24;                                // Ramp step delays are Q24 microseconds
+constexpr uint64_t kRateDelay = (1'000'000ull << kDelayShift) << 8; // Q24 delay x Q8 rate (steps/s)
+constexpr uint32_t kExactSteps = 16;                               // Ramp steps from rest computed with a square root
+
+inline uint32_t magnitude(int32_t steps)
+{
+  return steps < 0 ? (uint32_t)-steps : (uint32_t)steps;
+}
+
+inline uint32_t toQ8(float value)
+{
+  return value <= 0.0f ? 0 : (uint32_t)(value * 256.0f + 0.5f);
+}
+
+inline uint32_t squareRoot(uint64_t value)
+{
+  uint64_t root = 0;
+  for (uint64_t bit = 1ull << 62; bit; bit >>= 2)
+  {
+    if (value >= root + bit)
+    {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    }
+    else
+    {
+      root >>= 1;
+    }
+  }
+  return (uint32_t)root;
+}
+
+// Step delays of one acceleration ramp, in integer arithmetic only.
+// Trapezoidal ramps follow the Eiden/Austin recurrence. Austin's
+//   c[n] = c[n-1] - 2 c[n-1] / (4n + 1)
+// gives the delay between steps n and n+1; the table holds the rate at step
+// n itself, half a step earlier, which makes it c[n-1] - 2 c[n-1] / (4n - 1).
+// n counts steps from rest, so it starts at v0^2 / 2a (kept in Q8). The
+// recurrence is poor for small n: the first kExactSteps of a ramp from rest
+// use the exact rate sqrt(2an) instead. The S-curve evaluates the smoothstep
+// rate at the elapsed ramp time in Q24.
+class RampGenerator
+{
+public:
+  RampGenerator(uint32_t startQ8, uint32_t maxQ8, uint32_t accelerationQ8, bool sCurve)
+      : _startQ8(startQ8), _deltaQ8(maxQ8 - startQ8), _accelerationQ8(accelerationQ8), _sCurve(sCurve)
+  {
+    _cruiseDelay = kRateDelay / maxQ8;
+    _delay = accelerationQ8 == 0 ? _cruiseDelay : kRateDelay / startQ8;
+    if (accelerationQ8 == 0)
+    {
+      return;
+    }
+    // n = v0^2 / 2a, in Q8 steps
+    _n = ((uint64_t)startQ8 * startQ8) / ((uint64_t)accelerationQ8 << 1);
+    // The smoothstep peaks at 1.5x the average acceleration, so it takes 1.5x as long
+    _duration = ((uint64_t)_deltaQ8 * 1'000'000u * 3 / 2 << 8) / accelerationQ8;
+  }
+
+  bool done() const { return _delay <= _cruiseDelay; }
+  uint64_t delay() const { return _delay; }
+
+  void advance()
+  {
+    if (!_sCurve)
+    {
+      _n += 256;
+      if (_n < (kExactSteps << 8))
+      {
+        // Q16 rate^2 = 2an with n in Q8
+        _delay = kRateDelay / squareRoot(2 * _accelerationQ8 * _n);
+      }
+      else
+      {
+        const uint64_t divisor = 4 * _n - 256; // 4n - 1, Q8
+        _delay -= ((_delay << 9) + divisor / 2) / divisor;
+      }
+    }
+    else
+    {
+      _elapsed += _delay >> (kDelayShift - 8);
+      if (_elapsed >= _duration)
+      {
+        _delay = _cruiseDelay;
+        return;
+      }
+      const uint64_t tau = (_elapsed << 24) / _duration;                          // Q24
+      const uint64_t shape = (((tau * tau) >> 24) * ((3ull << 24) - 2 * tau)) >> 24; // Q24
+      _delay = kRateDelay / (_startQ8 + ((_deltaQ8 * shape) >> 24));
+    }
+    if (_delay < _cruiseDelay)
+    {
+      _delay = _cruiseDelay;
+    }
+  }
+
+private:
+  uint32_t _startQ8;
+  uint64_t _deltaQ8;
+  uint64_t _accelerationQ8;
+  bool _sCurve;
+  uint64_t _delay;
+  uint64_t _cruiseDelay;
+  uint64_t _n = 0;       // Q8 steps from rest
+  uint64_t _elapsed = 0;  // Q8 microseconds
+  uint64_t _duration = 0; // Q8 microseconds
+};
+}
+
+#if defined(__IMXRT1062__)
+SentientStepEngine *SentientStepEngine::s_activeInstance = nullptr;
+
+void SentientStepEngine::timerThunk()
+{
+  if (s_activeInstance)
+  {
+    s_activeInstance->tick();
+  }
+}
+#endif
+
+int SentientStepEngine::registerAxis(uint8_t group)
+{
+  if (group >= SENTIENT_STEP_MAX_GROUPS)
+  {
+    Serial.println(F("[SentientMotion] Group out of range (raise SENTIENT_STEP_MAX_GROUPS)"));
+    return -1;
+  }
+  if (_axisCount >= SENTIENT_STEP_MAX_AXES)
+  {
+    Serial.println(F("[SentientMotion] Axis table full (raise SENTIENT_STEP_MAX_AXES)"));
+    return -1;
+  }
+  Group &g = _groups[group];
+  if (g.axisCount >= SENTIENT_STEP_GROUP_AXES)
+  {
+    Serial.println(F("[SentientMotion] Group full (raise SENTIENT_STEP_GROUP_AXES)"));
+    return -1;
+  }
+
+  Axis &axis = _axes[_axisCount];
+  axis = Axis{};
+  axis.group = group;
+  axis.slot = g.axisCount;
+  axis.step.pin = SENTIENT_NO_PIN;
+  axis.dirPos.pin = SENTIENT_NO_PIN;
+  axis.dirNeg.pin = SENTIENT_NO_PIN;
+  for (PinPort &coil : axis.coils)
+  {
+    coil.pin = SENTIENT_NO_PIN;
+  }
+  g.axes[g.axisCount++] = _axisCount;
+  return _axisCount++;
+}
+
+int SentientStepEngine::addAxis(uint8_t group, const SentientStepperPins &pins)
+{
+  const int index = registerAxis(group);
+  if (index < 0)
+  {
+    return -1;
+  }
+
+  Axis &axis = _axes[index];
+  axis.driver = SentientStepperDriver::StepDir;
+  axis.invertDir = pins.invertDir;
+
+  // DM542 idle state: both STEP lines LOW, DIR+ LOW / DIR- HIGH
+  pinMode(pins.stepPos, OUTPUT);
+  digitalWrite(pins.stepPos, LOW);
+  if (pins.stepNeg != SENTIENT_NO_PIN)
+  {
+    pinMode(pins.stepNeg, OUTPUT);
+    digitalWrite(pins.stepNeg, LOW);
+  }
+  pinMode(pins.dirPos, OUTPUT);
+  digitalWrite(pins.dirPos, LOW);
+  if (pins.dirNeg != SENTIENT_NO_PIN)
+  {
+    pinMode(pins.dirNeg, OUTPUT);
+    digitalWrite(pins.dirNeg, HIGH);
+  }
+
+  bindPin(axis.step, pins.stepPos);
+  bindPin(axis.dirPos, pins.dirPos);
+  if (pins.dirNeg != SENTIENT_NO_PIN)
+  {
+    bindPin(axis.dirNeg, pins.dirNeg);
+  }
+  return index;
+}
+
+int SentientStepEngine::addCoilAxis(uint8_t group, const uint8_t *coilPins, const uint8_t *sequence)
+{
+  const int index = registerAxis(group);
+  if (index < 0)
+  {
+    return -1;
+  }
+
+  Axis &axis = _axes[index];
+  axis.driver = SentientStepperDriver::FourWire;
+  axis.sequence = sequence ? sequence : SENTIENT_COILS_FULL_STEP;
+
+  // Coils start de-energised; the first segment energises the holding pattern
+  for (uint8_t i = 0; i < 4; ++i)
+  {
+    pinMode(coilPins[i], OUTPUT);
+    digitalWrite(coilPins[i], LOW);
+    bindPin(axis.coils[i], coilPins[i]);
+  }
+  return index;
+}
+
+bool SentientStepEngine::addLimitInput(uint8_t axis, int8_t direction, uint8_t pin, uint8_t activeLevel)
+{
+  if (axis >= _axisCount || direction == 0)
+  {
+    return false;
+  }
+  Axis &a = _axes[axis];
+  const uint8_t end = direction > 0 ? 1 : 0;
+  if (a.limitCount[end] >= SENTIENT_STEP_LIMIT_INPUTS)
+  {
+    Serial.println(F("[SentientMotion] Limit inputs full (raise SENTIENT_STEP_LIMIT_INPUTS)"));
+    return false;
+  }
+
+  // The pin mode stays with the sketch, which usually publishes the same sensor
+  const uint8_t slot = a.limitCount[end];
+  bindPin(a.limits[end][slot], pin);
+  a.limitLevel[end][slot] = activeLevel;
+  a.limitCount[end] = slot + 1;
+  return true;
+}
+
+bool SentientStepEngine::limitActive(uint8_t axis, int8_t direction) const
+{
+  return axis < _axisCount && direction != 0 && limitHit(_axes[axis], direction);
+}
+
+bool SentientStepEngine::configure(uint8_t group, const SentientMotionConfig &config)
+{
+  if (group >= SENTIENT_STEP_MAX_GROUPS)
+  {
+    return false;
+  }
+  noInterrupts();
+  halt(_groups[group]);
+  interrupts();
+
+  const float tickCeiling = 1'000'000.0f / (2.0f * kTickUs);
+  const float maxRate = config.maxRate < tickCeiling ? config.maxRate : tickCeiling;
+  if (maxRate <= 0.0f)
+  {
+    Serial.println(F("[SentientMotion] maxRate must be positive"));
+    return false;
+  }
+  const float startRate = config.startRate <= 0.0f ? 1.0f : (config.startRate < maxRate ? config.startRate : maxRate);
+  if (config.maxRate > tickCeiling)
+  {
+    Serial.print(F("[SentientMotion] maxRate clamped to tick limit: "));
+    Serial.println(maxRate);
+  }
+
+  // Fixed point from here on: rates in Q8 steps/s, delays in Q24 microseconds
+  uint32_t startQ8 = toQ8(startRate);
+  uint32_t maxQ8 = toQ8(maxRate);
+  startQ8 = startQ8 ? startQ8 : 1;
+  maxQ8 = maxQ8 > startQ8 ? maxQ8 : startQ8;
+  const uint32_t accelerationQ8 = maxQ8 > startQ8 ? toQ8(config.acceleration) : 0;
+  const bool sCurve = config.profile == SentientMotionProfile::SCurve;
+
+  // First pass: how many steps the ramp takes
+  uint32_t rampSteps = 0;
+  for (RampGenerator ramp(startQ8, maxQ8, accelerationQ8, sCurve); !ramp.done() && rampSteps < kMaxRampSteps; ramp.advance())
+  {
+    ++rampSteps;
+  }
+
+  // Sample every 2^shift steps so the ramp plus the cruise entry fits the table
+  uint8_t shift = 0;
+  while ((((rampSteps + (1u << shift) - 1) >> shift) + 1) > SENTIENT_STEP_RAMP_ENTRIES)
+  {
+    ++shift;
+  }
+  const uint32_t sampled = (rampSteps + (1u << shift) - 1) >> shift;
+
+  // Second pass: record the rate at each sampled step
+  Group &g = _groups[group];
+  RampGenerator ramp(startQ8, maxQ8, accelerationQ8, sCurve);
+  for (uint32_t step = 0; step < rampSteps; ++step, ramp.advance())
+  {
+    if ((step & ((1u << shift) - 1)) == 0)
+    {
+      g.ramp[step >> shift] = delayToPhase(ramp.delay());
+    }
+  }
+  g.ramp[sampled] = rateToPhase(maxRate);
+  g.rampSteps = rampSteps;
+  g.rampShift = shift;
+  g.rampEntries = sampled + 1;
+  g.startRate = startRate;
+  g.maxRate = maxRate;
+
+  Serial.print(F("[SentientMotion] Group "));
+  Serial.print(group);
+  Serial.print(F(" ramp "));
+  Serial.print(startRate);
+  Serial.print(F(" -> "));
+  Serial.print(maxRate);
+  Serial.print(F(" steps/s over "));
+  Serial.print(rampSteps);
+  Serial.print(F(" steps ("));
+  Serial.print(g.rampEntries);
+  Serial.print(F(" entries, 1 per "));
+  Serial.print(1u << shift);
+  Serial.println(F(" steps)"));
+  return true;
+}
+
+bool SentientStepEngine::queueMove(uint8_t group, const long *steps, float maxRate)
+{
+  if (group >= SENTIENT_STEP_MAX_GROUPS)
+  {
+    return false;
+  }
+  const Group &g = _groups[group];
+
+  Segment segment = {};
+  for (uint8_t slot = 0; slot < g.axisCount; ++slot)
+  {
+    if (steps[slot] > 0x7FFFFFFFL || steps[slot] < -0x7FFFFFFFL)
+    {
+      Serial.println(F("[SentientMotion] Segment too long"));
+      return false;
+    }
+    segment.steps[slot] = (int32_t)steps[slot];
+    const uint32_t count = magnitude(segment.steps[slot]);
+    if (count > segment.total)
+    {
+      segment.total = count;
+    }
+  }
+  if (segment.total == 0)
+  {
+    return true; // Already there
+  }
+  return setRate(g, segment, maxRate) && append(group, segment);
+}
+
+bool SentientStepEngine::queueRun(uint8_t group, const int8_t *directions, float rate)
+{
+  if (group >= SENTIENT_STEP_MAX_GROUPS)
+  {
+    return false;
+  }
+  Group &g = _groups[group];
+
+  Segment segment = {};
+  for (uint8_t slot = 0; slot < g.axisCount; ++slot)
+  {
+    segment.steps[slot] = directions[slot] > 0 ? 1 : (directions[slot] < 0 ? -1 : 0);
+    if (segment.steps[slot] != 0)
+    {
+      segment.total = 1; // Every moving axis steps on every dominant step
+    }
+  }
+  if (segment.total == 0)
+  {
+    stop(group);
+    return true;
+  }
+  segment.endless = true;
+  if (!setRate(g, segment, rate))
+  {
+    return false;
+  }
+
+  // The same run already in progress only takes the new rate
+  noInterrupts();
+  if (g.count == 1 && g.queue[g.head].endless)
+  {
+    Segment &current = g.queue[g.head];
+    bool same = true;
+    for (uint8_t slot = 0; slot < g.axisCount; ++slot)
+    {
+      same = same && current.steps[slot] == segment.steps[slot];
+    }
+    if (same)
+    {
+      current.ratePhase = segment.ratePhase;
+      current.cruise = segment.cruise;
+      interrupts();
+      return true;
+    }
+  }
+  interrupts();
+  return append(group, segment);
+}
+
+bool SentientStepEngine::running(uint8_t group) const
+{
+  if (group >= SENTIENT_STEP_MAX_GROUPS)
+  {
+    return false;
+  }
+  const Group &g = _groups[group];
+  const uint8_t count = g.count;
+  return count > 0 && g.queue[(g.head + count - 1) & kQueueMask].endless;
+}
+
+void SentientStepEngine::stop(uint8_t group)
+{
+  if (group >= SENTIENT_STEP_MAX_GROUPS)
+  {
+    return;
+  }
+  Group &g = _groups[group];
+
+  noInterrupts();
+  if (g.loaded)
+  {
+    // Keep the executing segment, but only as far as it takes to ramp down from here
+    Segment &current = g.queue[g.head];
+    g.count = 1;
+    current.exit = 0;
+    if (current.endless)
+    {
+      current.endless = false;
+      g.remaining = g.index;
+    }
+    else if (g.remaining > g.index)
+    {
+      g.remaining = g.index;
+    }
+  }
+  else
+  {
+    g.count = 0;
+  }
+  interrupts();
+}
+
+void SentientStepEngine::halt()
+{
+  noInterrupts();
+  for (uint8_t i = 0; i < _axisCount; ++i)
+  {
+    if (_highMask & (1u << i))
+    {
+      writePin(_axes[i].step, false);
+    }
+  }
+  _highMask = 0;
+  for (Group &g : _groups)
+  {
+    halt(g);
+  }
+  _activeGroups = 0;
+  disarmTimer();
+  interrupts();
+}
+
+long SentientStepEngine::endPosition(uint8_t axis) const
+{
+  if (axis >= _axisCount)
+  {
+    return 0;
+  }
+  const Axis &a = _axes[axis];
+  const Group &g = _groups[a.group];
+
+  noInterrupts();
+  long end = a.position;
+  for (uint8_t k = 0; k < g.count; ++k)
+  {
+    const Segment &segment = g.queue[(g.head + k) & kQueueMask];
+    const int32_t steps = segment.steps[a.slot];
+    if (segment.endless || steps == 0)
+    {
+      continue;
+    }
+    if (k == 0 && g.loaded)
+    {
+      // Steps still to come from the Bresenham term of the executing segment
+      const uint64_t pending = ((uint64_t)g.error[a.slot] + (uint64_t)g.remaining * magnitude(steps)) / segment.total;
+      end += steps < 0 ? -(long)pending : (long)pending;
+    }
+    else
+    {
+      end += steps;
+    }
+  }
+  interrupts();
+  return end;
+}
+
+void SentientStepEngine::setPosition(uint8_t axis, long position)
+{
+  if (axis < _axisCount && !busy(_axes[axis].group))
+  {
+    _axes[axis].position = position;
+  }
+}
+
+void SentientStepEngine::releaseCoils(uint8_t axis)
+{
+  if (axis < _axisCount && _axes[axis].driver == SentientStepperDriver::FourWire && !busy(_axes[axis].group))
+  {
+    writeCoils(_axes[axis], 0);
+  }
+}
+
+uint32_t SentientStepEngine::rateToIndex(uint8_t group, float stepsPerSecond) const
+{
+  return group < SENTIENT_STEP_MAX_GROUPS ? indexForRate(_groups[group], stepsPerSecond) : 0;
+}
+
+float SentientStepEngine::rateAt(uint8_t group, uint32_t index) const
+{
+  if (group >= SENTIENT_STEP_MAX_GROUPS || _groups[group].rampEntries == 0)
+  {
+    return 0.0f;
+  }
+  const Group &g = _groups[group];
+  uint32_t entry = index >> g.rampShift;
+  if (entry >= g.rampEntries)
+  {
+    entry = g.rampEntries - 1;
+  }
+  return g.ramp[entry] / (kTickUs * kPhasePerStepPerUs);
+}
+
+void SentientStepEngine::tick()
+{
+  if (_highMask)
+  {
+    for (uint8_t i = 0; i < _axisCount; ++i)
+    {
+      if (_highMask & (1u << i))
+      {
+        writePin(_axes[i].step, false);
+      }
+    }
+    _highMask = 0;
+  }
+
+  uint32_t active = _activeGroups;
+  for (uint8_t group = 0; group < SENTIENT_STEP_MAX_GROUPS; ++group)
+  {
+    const uint32_t bit = 1u << group;
+    if (!(active & bit))
+    {
+      continue;
+    }
+
+    Group &g = _groups[group];
+    if (!g.loaded)
+    {
+      if (g.count == 0)
+      {
+        g.index = 0;
+        g.phase = 0;
+        active &= ~bit;
+      }
+      else
+      {
+        load(g); // DIR settles for a tick before the first step
+      }
+      continue;
+    }
+
+    Segment &segment = g.queue[g.head];
+    uint32_t remaining = g.remaining;
+    if (remaining == 0 && !segment.endless)
+    {
+      g.head = (g.head + 1) & kQueueMask;
+      g.count = g.count - 1;
+      g.loaded = false;
+      if (g.count)
+      {
+        load(g);
+      }
+      else
+      {
+        g.index = 0;
+        g.phase = 0;
+        active &= ~bit;
+      }
+      continue;
+    }
+
+    uint32_t entry = g.index >> g.rampShift;
+    if (entry >= g.rampEntries)
+    {
+      entry = g.rampEntries - 1;
+    }
+    uint32_t rate = g.ramp[entry];
+    if (rate > segment.ratePhase)
+    {
+      rate = segment.ratePhase;
+    }
+    const uint32_t before = g.phase;
+    g.phase = before + rate;
+    if (g.phase >= before)
+    {
+      continue;
+    }
+
+    // One dominant step: find which axes step, and check their limits before touching a pin
+    uint32_t stepping = 0;
+    for (uint8_t slot = 0; slot < g.axisCount; ++slot)
+    {
+      const uint32_t count = magnitude(segment.steps[slot]);
+      if (count == 0)
+      {
+        continue;
+      }
+      uint32_t error = g.error[slot] + count;
+      if (error >= segment.total)
+      {
+        error -= segment.total;
+        stepping |= 1u << slot;
+      }
+      g.error[slot] = error;
+    }
+
+    bool blocked = false;
+    for (uint8_t slot = 0; slot < g.axisCount && !blocked; ++slot)
+    {
+      if (stepping & (1u << slot))
+      {
+        const Axis &axis = _axes[g.axes[slot]];
+        blocked = limitHit(axis, axis.direction);
+      }
+    }
+    if (blocked)
+    {
+      halt(g);
+      g.tripped = true;
+      active &= ~bit;
+      continue;
+    }
+
+    for (uint8_t slot = 0; slot < g.axisCount; ++slot)
+    {
+      if (!(stepping & (1u << slot)))
+      {
+        continue;
+      }
+      const uint8_t index = g.axes[slot];
+      Axis &axis = _axes[index];
+      axis.position = axis.position + axis.direction;
+      if (axis.driver == SentientStepperDriver::StepDir)
+      {
+        writePin(axis.step, true);
+        _highMask |= 1u << index;
+      }
+      else
+      {
+        writeCoils(axis, axis.sequence[axis.position & 3]);
+      }
+    }
+
+    // Ramp one step towards the cruise index, or towards what the steps left can still shed
+    uint32_t limit = segment.cruise;
+    if (!segment.endless)
+    {
+      g.remaining = --remaining;
+      if (segment.exit + remaining < limit)
+      {
+        limit = segment.exit + remaining;
+      }
+    }
+    if (g.index < limit)
+    {
+      ++g.index;
+    }
+    else if (g.index > limit)
+    {
+      --g.index;
+    }
+  }
+
+  _activeGroups = active;
+  if (!active && !_highMask)
+  {
+    disarmTimer();
+  }
+}
+
+uint32_t SentientStepEngine::rateToPhase(float stepsPerSecond)
+{
+  const float phase = stepsPerSecond * kTickUs * kPhasePerStepPerUs;
+  return phase >= (float)kMaxPhaseRate ? kMaxPhaseRate : (uint32_t)phase;
+}
+
+uint32_t SentientStepEngine::delayToPhase(uint64_t delay)
+{
+  const uint64_t phase = ((uint64_t)kTickUs << (32 + kDelayShift)) / delay;
+  return phase >= kMaxPhaseRate ? kMaxPhaseRate : (uint32_t)phase;
+}
+
+uint32_t SentientStepEngine::indexForRate(const Group &group, float stepsPerSecond)
+{
+  if (group.rampEntries == 0)
+  {
+    return 0;
+  }
+  const uint32_t phase = rateToPhase(stepsPerSecond);
+  uint32_t low = 0;
+  uint32_t high = group.rampEntries - 1;
+  if (group.ramp[high] <= phase)
+  {
+    return high << group.rampShift;
+  }
+  if (group.ramp[0] > phase)
+  {
+    return 0;
+  }
+
+  // The ramp rises monotonically: bisect for the last entry at or below the rate
+  while (high - low > 1)
+  {
+    const uint32_t mid = (low + high) / 2;
+    if (group.ramp[mid] <= phase)
+    {
+      low = mid;
+    }
+    else
+    {
+      high = mid;
+    }
+  }
+  return low << group.rampShift;
+}
+
+void SentientStepEngine::bindPin(PinPort &port, uint8_t pin)
+{
+  port.pin = pin;
+#if defined(__IMXRT1062__)
+  port.set = portSetRegister(pin);
+  port.clear = portClearRegister(pin);
+  port.input = portInputRegister(pin);
+  port.mask = digitalPinToBitMask(pin);
+#endif
+}
+
+void SentientStepEngine::writePin(const PinPort &port, bool level)
+{
+#if defined(__IMXRT1062__)
+  *(level ? port.set : port.clear) = port.mask;
+#else
+  digitalWrite(port.pin, level ? HIGH : LOW);
+#endif
+}
+
+bool SentientStepEngine::readPin(const PinPort &port)
+{
+#if defined(__IMXRT1062__)
+  return (*port.input & port.mask) != 0;
+#else
+  return digitalRead(port.pin) == HIGH;
+#endif
+}
+
+bool SentientStepEngine::setRate(const Group &group, Segment &segment, float rate) const
+{
+  if (group.rampEntries == 0)
+  {
+    Serial.println(F("[SentientMotion] configure() must run before queueing moves"));
+    return false;
+  }
+  const float cap = (rate <= 0.0f || rate > group.maxRate) ? group.maxRate : rate;
+  segment.ratePhase = rateToPhase(cap);
+  segment.cruise = indexForRate(group, cap);
+  return true;
+}
+
+uint32_t SentientStepEngine::junctionIndex(const Group &group, const Segment &previous, const Segment &next) const
+{
+  // The group's rate carries across the junction; each axis' share of it may
+  // jump by at most the start rate, and no axis may reverse without stopping.
+  float worst = 0.0f;
+  for (uint8_t slot = 0; slot < group.axisCount; ++slot)
+  {
+    const int32_t before = previous.steps[slot];
+    const int32_t after = next.steps[slot];
+    if ((before < 0 && after > 0) || (before > 0 && after < 0))
+    {
+      return 0;
+    }
+    float change = (float)before / previous.total - (float)after / next.total;
+    change = change < 0.0f ? -change : change;
+    if (change > worst)
+    {
+      worst = change;
+    }
+  }
+
+  uint32_t junction = previous.cruise < next.cruise ? previous.cruise : next.cruise;
+  if (worst > 0.0f)
+  {
+    const uint32_t allowed = indexForRate(group, group.startRate / worst);
+    if (allowed < junction)
+    {
+      junction = allowed;
+    }
+  }
+  return junction;
+}
+
+bool SentientStepEngine::append(uint8_t group, Segment &segment)
+{
+  Group &g = _groups[group];
+  if (running(group))
+  {
+    stop(group); // Nothing can follow a run; wind it down first
+  }
+
+  noInterrupts();
+  if (g.count >= SENTIENT_STEP_QUEUE_DEPTH)
+  {
+    interrupts();
+    Serial.println(F("[SentientMotion] Segment queue full"));
+    return false;
+  }
+  segment.junction = g.count == 0 ? 0 : junctionIndex(g, g.queue[(g.head + g.count - 1) & kQueueMask], segment);
+  g.queue[(g.head + g.count) & kQueueMask] = segment;
+  g.count = g.count + 1;
+  g.tripped = false;
+  plan(g);
+  _activeGroups |= 1u << group;
+  armTimer();
+  interrupts();
+  return true;
+}
+
+void SentientStepEngine::plan(Group &group)
+{
+  // Backwards from rest at the end of the queue: each segment may be entered
+  // no faster than its junction allows and than it can shed before its exit.
+  uint32_t entry = 0;
+  for (int k = group.count - 1; k >= 0; --k)
+  {
+    Segment &segment = group.queue[(group.head + k) & kQueueMask];
+    segment.exit = entry;
+    const uint32_t reachable = segment.endless ? segment.junction : segment.exit + segment.total;
+    entry = segment.junction < reachable ? segment.junction : reachable;
+  }
+}
+
+void SentientStepEngine::load(Group &group)
+{
+  const Segment &segment = group.queue[group.head];
+  group.remaining = segment.total;
+  for (uint8_t slot = 0; slot < group.axisCount; ++slot)
+  {
+    group.error[slot] = segment.total >> 1; // Centre follower steps within the segment
+    const int32_t steps = segment.steps[slot];
+    if (steps == 0)
+    {
+      continue;
+    }
+
+    // Always rewritten: sketches may have toggled DIR by hand while the axis was idle
+    Axis &axis = _axes[group.axes[slot]];
+    writeDirection(axis, steps > 0 ? 1 : -1);
+    if (axis.driver == SentientStepperDriver::FourWire)
+    {
+      writeCoils(axis, axis.sequence[axis.position & 3]); // Hold the current step before moving off it
+    }
+  }
+  group.loaded = true;
+}
+
+void SentientStepEngine::halt(Group &group)
+{
+  group.count = 0;
+  group.loaded = false;
+  group.remaining = 0;
+  group.index = 0;
+  group.phase = 0;
+}
+
+bool SentientStepEngine::limitHit(const Axis &axis, int8_t direction) const
+{
+  const uint8_t end = direction > 0 ? 1 : 0;
+  for (uint8_t i = 0; i < axis.limitCount[end]; ++i)
+  {
+    if (readPin(axis.limits[end][i]) == (axis.limitLevel[end][i] == HIGH))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+void SentientStepEngine::writeDirection(Axis &axis, int8_t direction)
+{
+  axis.direction = direction;
+  if (axis.driver != SentientStepperDriver::StepDir)
+  {
+    return;
+  }
+  const bool forward = (direction > 0) != axis.invertDir;
+  writePin(axis.dirPos, forward);
+  if (axis.dirNeg.pin != SENTIENT_NO_PIN)
+  {
+    writePin(axis.dirNeg, !forward);
+  }
+}
+
+void SentientStepEngine::writeCoils(const Axis &axis, uint8_t pattern)
+{
+  for (uint8_t i = 0; i < 4; ++i)
+  {
+    writePin(axis.coils[i], pattern & (1u << i));
+  }
+}
+
+void SentientStepEngine::armTimer()
+{
+  if (_timerArmed)
+  {
+    return;
+  }
+#if defined(__IMXRT1062__)
+  s_activeInstance = this;
+  _timer.priority(32); // Ahead of Ethernet and USB so pulse timing holds under network load
+  _timer.begin(timerThunk, kTickUs);
+#endif
+  _timerArmed = true;
+}
+
+void SentientStepEngine::disarmTimer()
+{
+  if (!_timerArmed)
+  {
+    return;
+  }
+#if defined(__IMXRT1062__)
+  _timer.end();
+#endif
+  _timerArmed = false;
+}
@@ -0,0 +1,269 @@
+/*
+ * SentientStepEngine.h
+ *
+ * Background step generation for STEP/DIR drivers (DM542 and similar) and for
+ * four-wire steppers whose coils are switched directly.
+ *
+ * A hardware timer (IntervalTimer/PIT on Teensy 4) fires every
+ * SENTIENT_STEP_TICK_US. Axes are organised in groups and each group executes
+ * a queue of straight-line segments. Per tick a group adds its current rate to
+ * a 32-bit phase accumulator; a carry out of the phase is one step of the
+ * segment's dominant axis, and the other axes of the group follow through
+ * Bresenham error terms, so every axis of a segment starts and finishes
+ * together. STEP lines are raised on the carry tick and dropped on the next
+ * one: the pulse is exactly one tick wide and the low time at least one tick.
+ *
+ * Velocity comes from a per-group ramp table built once in configure(),
+ * indexed in steps: entry i is the rate after i steps of acceleration from the
+ * start rate. The table is generated in fixed point (the Eiden/Austin step
+ * delay recurrence for trapezoidal ramps) and holds phase increments, so a
+ * step costs a table read and a few integer operations at any rate. After
+ * every step the group's ramp index moves one step towards
+ * min(cruise, exit + steps left), where exit is the index the next segment is
+ * entered at. That one rule accelerates out of rest, cruises, slows into the
+ * next segment or the target, and makes short moves triangular.
+ *
+ * Exits are planned as segments are queued: a backward pass over the queue
+ * (the look-ahead window) raises each exit as far as the following segments
+ * can still shed, limited at each junction by how sharply the axis velocities
+ * change there. A reversal on any axis forces a stop at the junction.
+ *
+ * Limit inputs are read before every step in the direction of travel; a
+ * tripped input halts the group on the spot and discards its queue.
+ *
+ * Off-target builds (host simulation) have no timer: call tick() directly to
+ * advance the engine by one period.
+ */
+
+#ifndef SENTIENT_STEP_ENGINE_H
+#define SENTIENT_STEP_ENGINE_H
+
+#include <Arduino.h>
+
+#if defined(__IMXRT1062__)
+#include <IntervalTimer.h>
+#endif
+
+#ifndef SENTIENT_STEP_MAX_AXES
+#define SENTIENT_STEP_MAX_AXES 6 // Axes driven by one engine
+#endif
+#ifndef SENTIENT_STEP_MAX_GROUPS
+#define SENTIENT_STEP_MAX_GROUPS 4 // Independently moving axis groups
+#endif
+#ifndef SENTIENT_STEP_GROUP_AXES
+#define SENTIENT_STEP_GROUP_AXES 3 // Axes interpolated together within one group
+#endif
+#ifndef SENTIENT_STEP_QUEUE_DEPTH
+#define SENTIENT_STEP_QUEUE_DEPTH 8 // Segments queued per group; also the look-ahead window
+#endif
+#ifndef SENTIENT_STEP_LIMIT_INPUTS
+#define SENTIENT_STEP_LIMIT_INPUTS 2 // Limit inputs per axis end (any one of them trips)
+#endif
+#ifndef SENTIENT_STEP_TICK_US
+#define SENTIENT_STEP_TICK_US 10 // Timer period; caps the step rate at 1 / (2 * tick)
+#endif
+#ifndef SENTIENT_STEP_RAMP_ENTRIES
+#define SENTIENT_STEP_RAMP_ENTRIES 256 // Ramp table size per group; longer ramps are sampled every 2^n steps
+#endif
+
+#define SENTIENT_NO_PIN 0xFF
+
+enum class SentientMotionProfile : uint8_t
+{
+  Trapezoidal, // Constant acceleration
+  SCurve       // Jerk-limited: acceleration eases in and out (peak 1.5x the average)
+};
+
+enum class SentientStepperDriver : uint8_t
+{
+  StepDir, // External driver on STEP/DIR, optionally differential
+  FourWire // Coils switched directly (H-bridge, ULN2003) from a step sequence
+};
+
+struct SentientStepperPins
+{
+  uint8_t stepPos;
+  uint8_t stepNeg;        // Held LOW; SENTIENT_NO_PIN when the driver is wired single-ended
+  uint8_t dirPos;
+  uint8_t dirNeg;         // Driven opposite to dirPos; SENTIENT_NO_PIN when single-ended
+  bool invertDir = false; // Swap directions for a motor mounted the other way round
+};
+
+// Coil sequences for FourWire axes: bit n drives coil pin n, and an axis at
+// position p holds sequence[p & 3].
+extern const uint8_t SENTIENT_COILS_FULL_STEP[4]; // Two coils on (AccelStepper FULL4WIRE order)
+extern const uint8_t SENTIENT_COILS_WAVE[4];      // One coil on at a time
+
+struct SentientMotionConfig
+{
+  float startRate = 1000.0f;    // Steps/s from rest, and the largest instant rate change at a junction
+  float maxRate = 2000.0f;      // Cruise steps/s (clamped to half the tick rate)
+  float acceleration = 3000.0f; // Average steps/s^2 while ramping
+  SentientMotionProfile profile = SentientMotionProfile::Trapezoidal;
+};
+
+class SentientStepEngine
+{
+public:
+  SentientStepEngine() = default;
+  SentientStepEngine(const SentientStepEngine &) = delete;
+  SentientStepEngine &operator=(const SentientStepEngine &) = delete;
+
+  // Register an axis in a group and drive its pins to idle; returns the axis
+  // index or -1. Within a group, axes take their step counts in the order added.
+  int addAxis(uint8_t group, const SentientStepperPins &pins);
+  int addCoilAxis(uint8_t group, const uint8_t *coilPins, const uint8_t *sequence = SENTIENT_COILS_FULL_STEP);
+
+  // An input that stops the axis' group while it moves towards it (direction -1 or +1).
+  // Configure the pin (pull-up/down) before registering it.
+  bool addLimitInput(uint8_t axis, int8_t direction, uint8_t pin, uint8_t activeLevel = HIGH);
+  bool limitActive(uint8_t axis, int8_t direction) const;
+
+  // Build the group's ramp table. Halts the group.
+  bool configure(uint8_t group, const SentientMotionConfig &config);
+
+  // Append a straight-line segment: steps[i] is the signed step count of the
+  // group's i-th axis. maxRate caps the dominant axis (0 = the cruise rate).
+  bool queueMove(uint8_t group, const long *steps, float maxRate = 0.0f);
+
+  // Run the group's axes (direction -1, 0 or +1 each) until stop() or a limit.
+  // Repeating the directions of the run in progress only changes its rate.
+  bool queueRun(uint8_t group, const int8_t *directions, float rate);
+
+  // Decelerate the group to rest, discarding whatever is queued behind
+  void stop(uint8_t group);
+  // Halt every group immediately (no deceleration); positions stay exact
+  void halt();
+
+  bool busy() const { return _activeGroups != 0; }
+  bool busy(uint8_t group) const { return group < SENTIENT_STEP_MAX_GROUPS && (_activeGroups & (1u << group)); }
+  bool running(uint8_t group) const; // Executing or about to execute a queueRun()
+  uint8_t queued(uint8_t group) const { return group < SENTIENT_STEP_MAX_GROUPS ? _groups[group].count : 0; }
+  bool limitTripped(uint8_t group) const { return group < SENTIENT_STEP_MAX_GROUPS && _groups[group].tripped; }
+
+  long position(uint8_t axis) const { return axis < _axisCount ? _axes[axis].position : 0; }
+  long endPosition(uint8_t axis) const;          // Where the axis comes to rest once its queue drains
+  void setPosition(uint8_t axis, long position); // Only while the axis' group is idle
+  void releaseCoils(uint8_t axis);               // De-energise an idle FourWire axis
+
+  uint8_t axisCount() const { return _axisCount; }
+  uint8_t groupOf(uint8_t axis) const { return axis < _axisCount ? _axes[axis].group : 0; }
+  uint8_t slotOf(uint8_t axis) const { return axis < _axisCount ? _axes[axis].slot : 0; }
+  uint8_t groupSize(uint8_t group) const { return group < SENTIENT_STEP_MAX_GROUPS ? _groups[group].axisCount : 0; }
+  uint8_t groupAxis(uint8_t group, uint8_t slot) const { return _groups[group].axes[slot]; }
+  SentientStepperDriver driver(uint8_t axis) const { return _axes[axis].driver; }
+
+  // Ramp geometry, for logging and simulation
+  uint32_t rampSteps(uint8_t group) const { return _groups[group].rampSteps; }
+  uint16_t rampEntries(uint8_t group) const { return _groups[group].rampEntries; }
+  uint8_t rampShift(uint8_t group) const { return _groups[group].rampShift; }
+  float startRate(uint8_t group) const { return _groups[group].startRate; }
+  uint32_t rampIndex(uint8_t group) const { return _groups[group].index; }
+  uint32_t rateToIndex(uint8_t group, float stepsPerSecond) const; // Highest ramp index not above the rate
+  float rateAt(uint8_t group, uint32_t index) const;
+
+  // Advance one timer period. Runs from the timer ISR on target; host
+  // simulations call it directly.
+  void tick();
+
+  static constexpr uint32_t kTickUs = SENTIENT_STEP_TICK_US;
+
+private:
+  struct PinPort
+  {
+#if defined(__IMXRT1062__)
+    volatile uint32_t *set;
+    volatile uint32_t *clear;
+    volatile uint32_t *input;
+    uint32_t mask;
+#endif
+    uint8_t pin;
+  };
+
+  struct Axis
+  {
+    SentientStepperDriver driver;
+    uint8_t group;
+    uint8_t slot;
+    bool invertDir;
+    PinPort step;
+    PinPort dirPos;
+    PinPort dirNeg;
+    PinPort coils[4];
+    const uint8_t *sequence;
+    PinPort limits[2][SENTIENT_STEP_LIMIT_INPUTS]; // [0] negative end, [1] positive end
+    uint8_t limitLevel[2][SENTIENT_STEP_LIMIT_INPUTS];
+    uint8_t limitCount[2];
+    volatile long position;
+    int8_t direction;
+  };
+
+  struct Segment
+  {
+    int32_t steps[SENTIENT_STEP_GROUP_AXES];
+    uint32_t total;     // Steps of the dominant axis
+    uint32_t ratePhase; // Dominant axis rate cap, in phase units
+    uint32_t cruise;    // Ramp index the segment cruises at
+    uint32_t junction;  // Highest ramp index the segment may be entered at
+    uint32_t exit;      // Planned ramp index at its end
+    bool endless;       // queueRun(): never counts down
+  };
+
+  struct Group
+  {
+    uint8_t axes[SENTIENT_STEP_GROUP_AXES];
+    uint8_t axisCount;
+
+    Segment queue[SENTIENT_STEP_QUEUE_DEPTH];
+    uint8_t head;
+    volatile uint8_t count;
+    volatile bool loaded;  // queue[head] is executing
+    volatile bool tripped; // A limit input halted the group
+
+    volatile uint32_t remaining; // Dominant steps left in the executing segment
+    uint32_t error[SENTIENT_STEP_GROUP_AXES];
+    uint32_t index; // Ramp position, in steps
+    uint32_t phase;
+
+    uint32_t ramp[SENTIENT_STEP_RAMP_ENTRIES];
+    uint32_t rampSteps;
+    uint16_t rampEntries;
+    uint8_t rampShift;
+    float startRate;
+    float maxRate;
+  };
+
+  static uint32_t rateToPhase(float stepsPerSecond);
+  static uint32_t delayToPhase(uint64_t delay); // Q24 microseconds per step
+  static uint32_t indexForRate(const Group &group, float stepsPerSecond);
+  static void bindPin(PinPort &port, uint8_t pin);
+  static void writePin(const PinPort &port, bool level);
+  static bool readPin(const PinPort &port);
+  int registerAxis(uint8_t group);
+  uint32_t junctionIndex(const Group &group, const Segment &previous, const Segment &next) const;
+  bool setRate(const Group &group, Segment &segment, float rate) const;
+  bool append(uint8_t group, Segment &segment);
+  void plan(Group &group);
+  void load(Group &group);
+  void halt(Group &group);
+  bool limitHit(const Axis &axis, int8_t direction) const;
+  void writeDirection(Axis &axis, int8_t direction);
+  void writeCoils(const Axis &axis, uint8_t pattern);
+  void armTimer();
+  void disarmTimer();
+
+  Axis _axes[SENTIENT_STEP_MAX_AXES] = {};
+  uint8_t _axisCount = 0;
+  Group _groups[SENTIENT_STEP_MAX_GROUPS] = {};
+  volatile uint32_t _activeGroups = 0; // Groups with a segment loaded or queued
+  uint32_t _highMask = 0;              // Axes whose STEP line went high on the last tick
+
+#if defined(__IMXRT1062__)
+  IntervalTimer _timer;
+  static SentientStepEngine *s_activeInstance;
+  static void timerThunk();
+#endif
+  bool _timerArmed = false;
+};
+
+#endif // SENTIENT_STEP_ENGINE_H
@@ -0,0 +1,232 @@
+#include "SentientPulseOutputs.h"
+
+namespace
+{
+constexpr uint32_t kDoneMask = SENTIENT_PULSE_DONE_QUEUE - 1;
+constexpr uint32_t kMaxIntervalUs = 0x7FFFFFFFu; // Deadlines are compared as signed micros() differences
+constexpr uint32_t kMaxArmUs = 100'000'000u;     // The PIT counts 2^32 ticks of 24 MHz (~178 s); longer waits re-arm
+
+inline uint32_t clampInterval(uint32_t us)
+{
+  return us > kMaxIntervalUs ? kMaxIntervalUs : us;
+}
+}
+
+#if defined(__IMXRT1062__)
+SentientPulseOutputs *SentientPulseOutputs::s_activeInstance = nullptr;
+
+void SentientPulseOutputs::timerThunk()
+{
+  if (s_activeInstance)
+  {
+    s_activeInstance->tick();
+  }
+}
+#endif
+
+int SentientPulseOutputs::add(uint8_t pin, uint8_t activeLevel)
+{
+  if (_outputCount >= SENTIENT_PULSE_OUTPUTS)
+  {
+    Serial.println(F("[SentientOutput] Too many outputs (raise SENTIENT_PULSE_OUTPUTS)"));
+    return -1;
+  }
+  const uint8_t index = _outputCount;
+  Output &output = _outputs[index];
+  output.pin = pin;
+  output.activeLevel = activeLevel;
+#if defined(__IMXRT1062__)
+  output.set = portSetRegister(pin);
+  output.clear = portClearRegister(pin);
+  output.mask = digitalPinToBitMask(pin);
+#endif
+  pinMode(pin, OUTPUT);
+  drive(output, false);
+  _outputCount = index + 1;
+  return index;
+}
+
+bool SentientPulseOutputs::pulse(uint8_t output, uint32_t activeUs, uint32_t delayUs, uint32_t tag)
+{
+  return start(output, true, 2, activeUs, 0, delayUs, tag);
+}
+
+bool SentientPulseOutputs::train(uint8_t output, uint32_t activeUs, uint32_t inactiveUs, uint16_t count,
+                                 uint32_t delayUs, uint32_t tag)
+{
+  return count != 0 && start(output, true, (uint32_t)count * 2, activeUs, inactiveUs, delayUs, tag);
+}
+
+bool SentientPulseOutputs::setAfter(uint8_t output, bool active, uint32_t delayUs, uint32_t tag)
+{
+  return start(output, active, 1, 0, 0, delayUs, tag);
+}
+
+void SentientPulseOutputs::cancel(uint8_t output)
+{
+  if (output >= _outputCount)
+  {
+    return;
+  }
+  Output &o = _outputs[output];
+  noInterrupts();
+  if (o.edges != 0)
+  {
+    o.edges = 0;
+    post(output, o.tag, SentientPulseResult::Replaced);
+  }
+  drive(o, false);
+  interrupts();
+}
+
+void SentientPulseOutputs::onComplete(SentientPulseCallback callback, void *context)
+{
+  _callback = callback;
+  _callbackContext = context;
+}
+
+void SentientPulseOutputs::loop()
+{
+  while (_doneTail != _doneHead)
+  {
+    // Copy out before releasing the slot to the ISR
+    const SentientPulseDone done = _done[_doneTail & kDoneMask];
+    _doneTail = _doneTail + 1;
+    if (_callback)
+    {
+      _callback(done, _callbackContext);
+    }
+  }
+}
+
+bool SentientPulseOutputs::start(uint8_t output, bool firstLevel, uint32_t edges, uint32_t activeUs,
+                                 uint32_t inactiveUs, uint32_t delayUs, uint32_t tag)
+{
+  if (output >= _outputCount)
+  {
+    return false;
+  }
+  Output &o = _outputs[output];
+
+  noInterrupts();
+  if (o.edges != 0)
+  {
+    post(output, o.tag, SentientPulseResult::Replaced);
+  }
+  o.nextLevel = firstLevel;
+  o.activeUs = clampInterval(activeUs);
+  o.inactiveUs = clampInterval(inactiveUs);
+  o.tag = tag;
+  o.dueUs = micros() + clampInterval(delayUs);
+  o.edges = edges;
+  // Drives the first edge now when there is no delay, and re-arms the timer
+  // if this edge is the earliest
+  tick();
+  interrupts();
+  return true;
+}
+
+void SentientPulseOutputs::tick()
+{
+  const uint32_t now = micros();
+  uint32_t nextUs = UINT32_MAX;
+
+  for (uint8_t i = 0; i < _outputCount; ++i)
+  {
+    Output &o = _outputs[i];
+    if (o.edges == 0)
+    {
+      continue;
+    }
+    int32_t until = (int32_t)(o.dueUs - now);
+    while (until <= 0)
+    {
+      const uint32_t late = (uint32_t)-until;
+      if (late > _maxLateUs)
+      {
+        _maxLateUs = late;
+      }
+      drive(o, o.nextLevel);
+      if (--o.edges == 0)
+      {
+        post(i, o.tag, SentientPulseResult::Done);
+        break;
+      }
+      // Next deadline from this one, not from now, so a train never drifts
+      o.dueUs += o.level ? o.activeUs : o.inactiveUs;
+      o.nextLevel = !o.nextLevel;
+      until = (int32_t)(o.dueUs - now);
+    }
+    if (o.edges != 0 && (uint32_t)until < nextUs)
+    {
+      nextUs = (uint32_t)until;
+    }
+  }
+
+  if (nextUs == UINT32_MAX)
+  {
+    disarm();
+  }
+  else
+  {
+    arm(nextUs);
+  }
+}
+
+void SentientPulseOutputs::drive(Output &output, bool active)
+{
+  output.level = active;
+  const bool high = active == (output.activeLevel == HIGH);
+#if defined(__IMXRT1062__)
+  *(high ? output.set : output.clear) = output.mask;
+#else
+  digitalWrite(output.pin, high ? HIGH : LOW);
+#endif
+}
+
+void SentientPulseOutputs::post(uint8_t output, uint32_t tag, SentientPulseResult result)
+{
+  // Called from tick() or with the ISR held off, so there is one producer
+  if (_doneHead - _doneTail >= SENTIENT_PULSE_DONE_QUEUE)
+  {
+    ++_droppedDone;
+    return;
+  }
+  SentientPulseDone &done = _done[_doneHead & kDoneMask];
+  done.output = output;
+  done.tag = tag;
+  done.result = result;
+  _doneHead = _doneHead + 1;
+}
+
+void SentientPulseOutputs::arm(uint32_t delayUs)
+{
+  if (delayUs < SENTIENT_PULSE_MIN_ARM_US)
+  {
+    delayUs = SENTIENT_PULSE_MIN_ARM_US;
+  }
+  else if (delayUs > kMaxArmUs)
+  {
+    delayUs = kMaxArmUs;
+  }
+#if defined(__IMXRT1062__)
+  // begin() on a running IntervalTimer reloads it in place, so this also
+  // works from inside the timer's own interrupt
+  s_activeInstance = this;
+  _timer.priority(32); // Ahead of Ethernet and USB so edges hold under network load
+  _timer.begin(timerThunk, delayUs);
+#endif
+  _timerArmed = true;
+}
+
+void SentientPulseOutputs::disarm()
+{
+  if (!_timerArmed)
+  {
+    return;
+  }
+#if defined(__IMXRT1062__)
+  _timer.end();
+#endif
+  _timerArmed = false;
+}
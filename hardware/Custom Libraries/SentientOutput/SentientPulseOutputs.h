@@ -0,0 +1,145 @@
+/*
+ * SentientPulseOutputs.h
+ *
+ * Timed GPIO outputs for relays, fog triggers, solenoids and indicator LEDs:
+ * single pulses, pulse trains and delayed on/off transitions, all without
+ * blocking loop().
+ *
+ * Each registered output runs at most one program: a number of edges, the
+ * level the next edge drives, and how long the output stays active and
+ * inactive between edges. A one-shot hardware timer (IntervalTimer/PIT on
+ * Teensy 4) is always armed for the earliest pending edge across all
+ * outputs; its handler drives every edge that is due, then re-arms for the
+ * next one. Edges land within the interrupt latency of their deadline
+ * however busy loop() is, and any number of outputs overlap freely.
+ *
+ * Starting a program on an output that is still running one replaces it.
+ * Finished and replaced programs are posted to a ring that loop() drains
+ * into the completion callback, so acks and status publishes run in loop()
+ * context, never in the interrupt.
+ *
+ * Times are micros() deadlines: a program may last up to about 35 minutes.
+ *
+ * Off-target builds (host simulation) have no timer: call tick() to drive
+ * the edges that are due.
+ */
+
+#ifndef SENTIENT_PULSE_OUTPUTS_H
+#define SENTIENT_PULSE_OUTPUTS_H
+
+#include <Arduino.h>
+
+#if defined(__IMXRT1062__)
+#include <IntervalTimer.h>
+#endif
+
+#ifndef SENTIENT_PULSE_OUTPUTS
+#define SENTIENT_PULSE_OUTPUTS 16 // Timed outputs per controller
+#endif
+#ifndef SENTIENT_PULSE_DONE_QUEUE
+#define SENTIENT_PULSE_DONE_QUEUE 16 // Completions waiting for loop() (power of two)
+#endif
+#ifndef SENTIENT_PULSE_MIN_ARM_US
+#define SENTIENT_PULSE_MIN_ARM_US 2 // Shortest timer period; closer edges are driven together
+#endif
+
+static_assert((SENTIENT_PULSE_DONE_QUEUE & (SENTIENT_PULSE_DONE_QUEUE - 1)) == 0,
+              "SENTIENT_PULSE_DONE_QUEUE must be a power of two");
+
+enum class SentientPulseResult : uint8_t
+{
+  Done,     // Every edge was driven
+  Replaced, // A new program or cancel() took the output over
+};
+
+struct SentientPulseDone
+{
+  uint8_t output;
+  uint32_t tag; // Caller's value from pulse()/train()/setAfter()
+  SentientPulseResult result;
+};
+
+using SentientPulseCallback = void (*)(const SentientPulseDone &done, void *context);
+
+class SentientPulseOutputs
+{
+public:
+  SentientPulseOutputs() = default;
+  SentientPulseOutputs(const SentientPulseOutputs &) = delete;
+  SentientPulseOutputs &operator=(const SentientPulseOutputs &) = delete;
+
+  // Register a pin and drive it inactive; returns the output index or -1
+  int add(uint8_t pin, uint8_t activeLevel = HIGH);
+
+  // Active for activeUs, starting after delayUs
+  bool pulse(uint8_t output, uint32_t activeUs, uint32_t delayUs = 0, uint32_t tag = 0);
+  // count pulses of activeUs separated by inactiveUs, starting after delayUs
+  bool train(uint8_t output, uint32_t activeUs, uint32_t inactiveUs, uint16_t count, uint32_t delayUs = 0,
+             uint32_t tag = 0);
+  // Drive the output active or inactive after delayUs, and leave it there
+  bool setAfter(uint8_t output, bool active, uint32_t delayUs, uint32_t tag = 0);
+  // Drop the program and drive the output inactive now
+  void cancel(uint8_t output);
+
+  bool busy(uint8_t output) const { return output < _outputCount && _outputs[output].edges != 0; }
+  bool active(uint8_t output) const { return output < _outputCount && _outputs[output].level; }
+
+  void onComplete(SentientPulseCallback callback, void *context = nullptr);
+
+  // Call every loop(): delivers completions to the callback
+  void loop();
+
+  uint32_t maxLateUs() const { return _maxLateUs; }     // Worst edge lateness seen
+  uint32_t droppedDone() const { return _droppedDone; } // Completions lost to a full ring
+
+  // Drive due edges and re-arm for the next. Runs from the timer ISR on
+  // target; host simulations call it directly.
+  void tick();
+
+private:
+  struct Output
+  {
+#if defined(__IMXRT1062__)
+    volatile uint32_t *set;
+    volatile uint32_t *clear;
+    uint32_t mask;
+#endif
+    uint8_t pin;
+    uint8_t activeLevel;
+    volatile bool level;     // Output is active
+    bool nextLevel;          // Level the next edge drives
+    volatile uint32_t edges; // Edges left; 0 = idle
+    uint32_t dueUs;          // micros() of the next edge
+    uint32_t activeUs;
+    uint32_t inactiveUs;
+    uint32_t tag;
+  };
+
+  bool start(uint8_t output, bool firstLevel, uint32_t edges, uint32_t activeUs, uint32_t inactiveUs,
+             uint32_t delayUs, uint32_t tag);
+  void drive(Output &output, bool active);
+  void post(uint8_t output, uint32_t tag, SentientPulseResult result);
+  void arm(uint32_t delayUs);
+  void disarm();
+
+  Output _outputs[SENTIENT_PULSE_OUTPUTS] = {};
+  uint8_t _outputCount = 0;
+
+  SentientPulseDone _done[SENTIENT_PULSE_DONE_QUEUE] = {};
+  volatile uint32_t _doneHead = 0; // Advanced by post() only, in the ISR or with it held off
+  volatile uint32_t _doneTail = 0; // Advanced by loop() only
+  uint32_t _droppedDone = 0;
+  uint32_t _maxLateUs = 0;
+
+  SentientPulseCallback _callback = nullptr;
+  void *_callbackContext = nullptr;
+
+#if defined(__IMXRT1062__)
+  IntervalTimer _timer;
+  static SentientPulseOutputs *s_activeInstance;
+  static void timerThunk();
+#endif
+  bool _timerArmed = false;
+};
+
+#endif // SENTIENT_PULSE_OUTPUTS_H
@@ -0,0 +1,231 @@
+#include "SentientRfidReaders.h"
+
+namespace
+{
+constexpr uint8_t kStx = 0x02;
+constexpr uint8_t kEtx = 0x03;
+constexpr uint8_t kTagDigits = 12;
+
+int8_t hexValue(uint8_t c)
+{
+  if (c >= '0' && c <= '9')
+  {
+    return c - '0';
+  }
+  if (c >= 'A' && c <= 'F')
+  {
+    return c - 'A' + 10;
+  }
+  if (c >= 'a' && c <= 'f')
+  {
+    return c - 'a' + 10;
+  }
+  return -1;
+}
+}
+
+int SentientRfidReaders::add(HardwareSerial &port, uint8_t tirPin, uint8_t tirMode)
+{
+  if (_started)
+  {
+    Serial.println(F("[SentientRfidReaders] Readers must be added before begin()"));
+    return -1;
+  }
+  if (_readerCount >= SENTIENT_RFID_MAX_READERS)
+  {
+    Serial.println(F("[SentientRfidReaders] Too many readers; raise SENTIENT_RFID_MAX_READERS"));
+    return -1;
+  }
+  for (uint8_t i = 0; i < _readerCount; i++)
+  {
+    if (_readers[i].port == &port)
+    {
+      Serial.println(F("[SentientRfidReaders] Serial port added twice"));
+      return -1;
+    }
+  }
+
+  Reader &reader = _readers[_readerCount];
+  reader.port = &port;
+  reader.tirPin = tirPin;
+  if (tirPin != SENTIENT_RFID_NO_TIR)
+  {
+    pinMode(tirPin, tirMode);
+  }
+  return _readerCount++;
+}
+
+bool SentientRfidReaders::begin(uint32_t baud)
+{
+  if (_started || _readerCount == 0 || baud == 0)
+  {
+    return false;
+  }
+  _byteUs = 10000000u / baud; // Start, 8 data and stop bits
+
+  const uint32_t now = micros();
+  for (uint8_t i = 0; i < _readerCount; i++)
+  {
+    Reader &reader = _readers[i];
+    reader.port->begin(baud);
+    reader.port->addMemoryForRead(reader.rxBuffer, sizeof(reader.rxBuffer));
+    reader.tir = false;
+    reader.changeUs = now;
+  }
+  _started = true;
+
+  Serial.print(F("[SentientRfidReaders] "));
+  Serial.print(_readerCount);
+  Serial.print(F(" readers at "));
+  Serial.print(baud);
+  Serial.println(F(" baud"));
+  return true;
+}
+
+uint32_t SentientRfidReaders::update()
+{
+  uint32_t changed = 0;
+  for (uint8_t i = 0; i < _readerCount; i++)
+  {
+    Reader &reader = _readers[i];
+    const uint32_t now = micros();
+
+    // Bytes still queued behind an ETX arrived after it, one byte time each
+    int waiting = reader.port->available();
+    while (waiting-- > 0)
+    {
+      if (frameByte(reader, reader.port->read()))
+      {
+        reader.haveFrame = true;
+        reader.frameTag = reader.value;
+        reader.frameUs = now - (uint32_t)waiting * _byteUs;
+      }
+    }
+
+    bool present;
+    if (reader.tirPin != SENTIENT_RFID_NO_TIR)
+    {
+      const bool tir = digitalRead(reader.tirPin) == HIGH;
+      if (tir && !reader.tir)
+      {
+        reader.tirRoseUs = now;
+        // A frame from before this tag came into range belongs to an older read
+        if (reader.haveFrame && now - reader.frameUs > SENTIENT_RFID_FRAME_LEAD_MS * 1000u)
+        {
+          reader.haveFrame = false;
+        }
+      }
+      else if (!tir && reader.tir)
+      {
+        reader.haveFrame = false;
+      }
+      reader.tir = tir;
+      present = tir && reader.haveFrame;
+    }
+    else
+    {
+      present = reader.haveFrame && now - reader.frameUs < SENTIENT_RFID_HOLD_MS * 1000u;
+      reader.tir = present;
+    }
+
+    const SentientRfidTag tag = present ? reader.frameTag : 0;
+    if (present != reader.present || tag != reader.tag)
+    {
+      if (present)
+      {
+        // Whichever came last made the tag present: its frame or TIR
+        const bool frameLast = reader.tirPin == SENTIENT_RFID_NO_TIR || (int32_t)(reader.frameUs - reader.tirRoseUs) > 0;
+        reader.changeUs = frameLast ? reader.frameUs : reader.tirRoseUs;
+      }
+      else
+      {
+        reader.changeUs = now;
+      }
+      reader.present = present;
+      reader.tag = tag;
+      changed |= bit(i);
+    }
+  }
+  return changed;
+}
+
+uint32_t SentientRfidReaders::ageMicros(uint8_t reader) const
+{
+  return reader < _readerCount ? micros() - _readers[reader].changeUs : 0;
+}
+
+bool SentientRfidReaders::frameByte(Reader &reader, uint8_t c)
+{
+  if (c == kStx)
+  {
+    // A new STX restarts framing, whatever came before it
+    if (reader.inFrame)
+    {
+      reader.errors++;
+    }
+    reader.inFrame = true;
+    reader.digits = 0;
+    reader.value = 0;
+    return false;
+  }
+  if (!reader.inFrame)
+  {
+    return false; // Line noise between frames
+  }
+  if (c == '\r' || c == '\n')
+  {
+    return false;
+  }
+  if (c == kEtx)
+  {
+    reader.inFrame = false;
+    if (reader.digits == kTagDigits && checksumValid(reader.value))
+    {
+      reader.frames++;
+      return true;
+    }
+    reader.errors++;
+    return false;
+  }
+
+  const int8_t nibble = hexValue(c);
+  if (nibble < 0 || reader.digits >= kTagDigits)
+  {
+    reader.inFrame = false;
+    reader.errors++;
+    return false;
+  }
+  reader.value = (reader.value << 4) | (uint8_t)nibble;
+  reader.digits++;
+  return false;
+}
+
+void SentientRfidReaders::formatTag(SentientRfidTag tag, char *out)
+{
+  static const char kHex[] = "0123456789ABCDEF";
+  if (tag == 0)
+  {
+    out[0] = '\0';
+    return;
+  }
+  for (uint8_t i = 0; i < kTagDigits; i++)
+  {
+    out[i] = kHex[(tag >> (4 * (kTagDigits - 1 - i))) & 0xF];
+  }
+  out[kTagDigits] = '\0';
+}
+
+SentientRfidTag SentientRfidReaders::parseTag(const char *text)
+{
+  uint64_t value = 0;
+  for (uint8_t i = 0; i < kTagDigits; i++)
+  {
+    const int8_t nibble = hexValue(text[i]);
+    if (nibble < 0)
+    {
+      return 0;
+    }
+    value = (value << 4) | (uint8_t)nibble;
+  }
+  return text[kTagDigits] == '\0' && checksumValid(value) ? value : 0;
+}
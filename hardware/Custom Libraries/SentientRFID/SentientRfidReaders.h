@@ -0,0 +1,142 @@
+/*
+ * SentientRfidReaders.h
+ *
+ * EM4100 tag readers (ID-12/ID-20 style) on hardware serial ports, with
+ * Tag-in-Range (TIR) presence.
+ *
+ * A reader sends each tag as one ASCII frame:
+ *   STX, 10 hex digits of tag data, 2 hex digits of checksum, [CR LF], ETX
+ * The checksum is the XOR of the five data bytes. Every port has its own
+ * framing state machine, so bytes from two readers can interleave freely.
+ * A frame is only accepted with exactly twelve hex digits and a matching
+ * checksum; anything else is counted as an error and dropped. Each port
+ * also gets extra RX buffer memory, so a slow loop() pass never overruns
+ * the UART FIFO.
+ *
+ * Tags are packed integers: the 48-bit value of the 12 hex digits (40-bit
+ * ID, then the checksum byte), which prints back as the familiar
+ * "3C0088C9CFB2" string. 0 means no tag.
+ *
+ * Presence fuses the frame with the TIR line:
+ * - a tag is present while TIR is high and a valid frame has been seen
+ *   (a frame may arrive up to SENTIENT_RFID_FRAME_LEAD_MS before TIR rises);
+ * - TIR falling removes the tag at once, with no timeout;
+ * - a reader without TIR holds a tag for SENTIENT_RFID_HOLD_MS after its
+ *   last frame (readers that repeat frames while the tag is in the field).
+ *
+ * ageMicros() gives the time since the wire event behind the latest change.
+ * The ETX arrival is estimated from the bytes still queued behind it, so it
+ * includes the time the frame spent waiting in the RX buffer. Sketches
+ * publish it as the arrival-to-publish latency.
+ *
+ * USAGE:
+ *   SentientRfidReaders rfid;
+ *   const int reader = rfid.add(Serial1, TIR_PIN);
+ *   rfid.begin(9600);
+ *   ...
+ *   const uint32_t changed = rfid.update();       // Once per loop()
+ *   if (changed & SentientRfidReaders::bit(reader)) publish(rfid.present(reader), rfid.tag(reader));
+ */
+
+#ifndef SENTIENT_RFID_READERS_H
+#define SENTIENT_RFID_READERS_H
+
+#include <Arduino.h>
+
+#ifndef SENTIENT_RFID_MAX_READERS
+#define SENTIENT_RFID_MAX_READERS 8 // Serial1..Serial8
+#endif
+#ifndef SENTIENT_RFID_RX_BUFFER
+#define SENTIENT_RFID_RX_BUFFER 128 // Extra RX bytes per port (a frame is 16)
+#endif
+#ifndef SENTIENT_RFID_FRAME_LEAD_MS
+#define SENTIENT_RFID_FRAME_LEAD_MS 500 // A frame this recent still counts when TIR rises
+#endif
+#ifndef SENTIENT_RFID_HOLD_MS
+#define SENTIENT_RFID_HOLD_MS 600 // Presence after the last frame, readers without TIR
+#endif
+
+#define SENTIENT_RFID_NO_TIR 0xFF
+#define SENTIENT_RFID_TAG_TEXT 13 // 12 hex digits and the terminator
+
+typedef uint64_t SentientRfidTag; // 48 bits: 40-bit ID << 8 | checksum, 0 = none
+
+class SentientRfidReaders
+{
+public:
+  SentientRfidReaders() = default;
+  SentientRfidReaders(const SentientRfidReaders &) = delete;
+  SentientRfidReaders &operator=(const SentientRfidReaders &) = delete;
+
+  // Register a reader before begin(); returns its index or -1.
+  // tirPin is read active HIGH with tirMode (the readers drive it).
+  int add(HardwareSerial &port, uint8_t tirPin = SENTIENT_RFID_NO_TIR, uint8_t tirMode = INPUT_PULLDOWN);
+  bool begin(uint32_t baud = 9600);
+
+  // Drain every port and re-evaluate presence; returns the readers whose
+  // presence or tag changed (bit n = reader n). Call once per loop().
+  uint32_t update();
+
+  static uint32_t bit(uint8_t reader) { return 1ul << reader; }
+  uint8_t count() const { return _readerCount; }
+
+  bool present(uint8_t reader) const { return reader < _readerCount && _readers[reader].present; }
+  SentientRfidTag tag(uint8_t reader) const { return reader < _readerCount ? _readers[reader].tag : 0; }
+  bool tagInRange(uint8_t reader) const { return reader < _readerCount && _readers[reader].tir; }
+  uint32_t ageMicros(uint8_t reader) const;
+
+  uint32_t frames(uint8_t reader) const { return reader < _readerCount ? _readers[reader].frames : 0; }
+  uint32_t errors(uint8_t reader) const { return reader < _readerCount ? _readers[reader].errors : 0; }
+
+  // "3C0088C9CFB2", or "" for no tag; out holds SENTIENT_RFID_TAG_TEXT chars
+  static void formatTag(SentientRfidTag tag, char *out);
+  // Parses 12 hex digits (checksum verified); returns 0 when invalid
+  static SentientRfidTag parseTag(const char *text);
+  // True when the low byte is the XOR of the five ID bytes (usable at compile time)
+  static constexpr bool checksumValid(SentientRfidTag tag)
+  {
+    uint8_t sum = 0;
+    for (uint8_t shift = 8; shift < 48; shift += 8)
+    {
+      sum ^= (uint8_t)(tag >> shift);
+    }
+    return tag != 0 && tag >> 48 == 0 && sum == (uint8_t)tag;
+  }
+
+private:
+  struct Reader
+  {
+    HardwareSerial *port;
+    uint8_t tirPin;
+    uint8_t rxBuffer[SENTIENT_RFID_RX_BUFFER];
+
+    // Framing
+    bool inFrame;
+    uint8_t digits;
+    uint64_t value;
+
+    // Latest valid frame
+    bool haveFrame;
+    SentientRfidTag frameTag;
+    uint32_t frameUs;
+
+    bool tir;
+    uint32_t tirRoseUs;
+    bool present;
+    SentientRfidTag tag;
+    uint32_t changeUs;
+
+    uint32_t frames;
+    uint32_t errors;
+  };
+
+  // Feed one byte to the framing state machine; true when a frame completed
+  static bool frameByte(Reader &reader, uint8_t c);
+
+  Reader _readers[SENTIENT_RFID_MAX_READERS] = {};
+  uint8_t _readerCount = 0;
+  uint32_t _byteUs = 1042; // 10 bits at 9600 baud
+  bool _started = false;
+};
+
+#endif // SENTIENT_RFID_READERS_H
@@ -0,0 +1,233 @@
+#include "SentientRfidTagTable.h"
+#include <EEPROM.h>
+
+namespace
+{
+constexpr uint32_t kMagic = 0x31545253; // "SRT1"
+
+// FNV-1a over one byte, the same hash the device registry uses
+uint32_t fnv(uint32_t h, uint8_t byte)
+{
+  return (h ^ byte) * 16777619u;
+}
+
+void writeU32(int address, uint32_t value)
+{
+  for (uint8_t i = 0; i < 4; i++)
+  {
+    EEPROM.update(address + i, (uint8_t)(value >> (8 * i)));
+  }
+}
+
+uint32_t readU32(int address)
+{
+  uint32_t value = 0;
+  for (uint8_t i = 0; i < 4; i++)
+  {
+    value |= (uint32_t)EEPROM.read(address + i) << (8 * i);
+  }
+  return value;
+}
+}
+
+bool SentientRfidTagTable::begin(const SentientRfidTag *defaults, uint16_t count, int eepromAddress)
+{
+  if (_started)
+  {
+    return false;
+  }
+  if (count > SENTIENT_RFID_TABLE_SIZE || eepromAddress < 0 ||
+      eepromAddress + storageBytes() > (size_t)EEPROM.length())
+  {
+    Serial.println(F("[SentientRfidTagTable] Table does not fit; check SENTIENT_RFID_TABLE_SIZE and the EEPROM address"));
+    return false;
+  }
+  _defaults = defaults;
+  _defaultCount = count;
+  _address = eepromAddress;
+  _started = true;
+
+  if (load())
+  {
+    _stored = true;
+    Serial.print(F("[SentientRfidTagTable] "));
+    Serial.print(_count);
+    Serial.println(F(" tags from EEPROM"));
+    return true;
+  }
+  if (!index(defaults, count, _slots))
+  {
+    Serial.println(F("[SentientRfidTagTable] Default tags are invalid"));
+    _count = 0;
+    memset(_slots, kEmpty, sizeof(_slots));
+    return false;
+  }
+  memcpy(_tags, defaults, count * sizeof(SentientRfidTag));
+  _count = count;
+  Serial.print(F("[SentientRfidTagTable] "));
+  Serial.print(_count);
+  Serial.println(F(" default tags"));
+  return true;
+}
+
+uint16_t SentientRfidTagTable::lookup(SentientRfidTag tag) const
+{
+  if (tag == 0 || _count == 0)
+  {
+    return 0;
+  }
+  for (size_t k = slotOf(tag);; k = (k + 1) & (kSlots - 1))
+  {
+    const uint8_t entry = _slots[k];
+    if (entry == kEmpty)
+    {
+      return 0;
+    }
+    if (_tags[entry] == tag)
+    {
+      return entry + 1;
+    }
+  }
+}
+
+bool SentientRfidTagTable::assign(uint16_t number, SentientRfidTag tag)
+{
+  if (!_started || number == 0 || number > _count + 1 || number > SENTIENT_RFID_TABLE_SIZE)
+  {
+    return false;
+  }
+  SentientRfidTag tags[SENTIENT_RFID_TABLE_SIZE];
+  memcpy(tags, _tags, _count * sizeof(SentientRfidTag));
+  tags[number - 1] = tag;
+  return replace(tags, number > _count ? number : _count);
+}
+
+bool SentientRfidTagTable::replace(const SentientRfidTag *tags, uint16_t count)
+{
+  if (!_started || count > SENTIENT_RFID_TABLE_SIZE)
+  {
+    return false;
+  }
+  uint8_t slots[kSlots];
+  if (!index(tags, count, slots))
+  {
+    Serial.println(F("[SentientRfidTagTable] Rejected: invalid or repeated tag"));
+    return false;
+  }
+  if (tags != _tags)
+  {
+    memcpy(_tags, tags, count * sizeof(SentientRfidTag));
+  }
+  memcpy(_slots, slots, sizeof(_slots));
+  _count = count;
+  save();
+  _stored = true;
+  return true;
+}
+
+bool SentientRfidTagTable::restoreDefaults()
+{
+  if (!_started)
+  {
+    return false;
+  }
+  writeU32(_address, 0xFFFFFFFF);
+  _stored = false;
+  memcpy(_tags, _defaults, _defaultCount * sizeof(SentientRfidTag));
+  _count = _defaultCount;
+  return index(_tags, _count, _slots);
+}
+
+bool SentientRfidTagTable::index(const SentientRfidTag *tags, uint16_t count, uint8_t *slots)
+{
+  memset(slots, kEmpty, kSlots);
+  for (uint16_t i = 0; i < count; i++)
+  {
+    const SentientRfidTag tag = tags[i];
+    if (tag == 0)
+    {
+      continue; // Unassigned number
+    }
+    if (!SentientRfidReaders::checksumValid(tag))
+    {
+      return false;
+    }
+    size_t k = slotOf(tag);
+    while (slots[k] != kEmpty)
+    {
+      if (tags[slots[k]] == tag)
+      {
+        return false;
+      }
+      k = (k + 1) & (kSlots - 1);
+    }
+    slots[k] = (uint8_t)i;
+  }
+  return true;
+}
+
+size_t SentientRfidTagTable::slotOf(SentientRfidTag tag)
+{
+  // Fibonacci hashing: the top bits of the product mix every bit of the tag
+  return (size_t)((tag * 0x9E3779B97F4A7C15ull) >> 40) & (kSlots - 1);
+}
+
+bool SentientRfidTagTable::load()
+{
+  if (readU32(_address) != kMagic)
+  {
+    return false;
+  }
+  const uint32_t count = readU32(_address + 4);
+  if (count > SENTIENT_RFID_TABLE_SIZE || readU32(_address + 8) != storedChecksum(count))
+  {
+    return false;
+  }
+
+  SentientRfidTag tags[SENTIENT_RFID_TABLE_SIZE];
+  for (uint16_t i = 0; i < count; i++)
+  {
+    SentientRfidTag tag = 0;
+    for (uint8_t b = 0; b < kTagBytes; b++)
+    {
+      tag |= (SentientRfidTag)EEPROM.read(_address + kHeaderBytes + i * kTagBytes + b) << (8 * b);
+    }
+    tags[i] = tag;
+  }
+  if (!index(tags, count, _slots))
+  {
+    return false;
+  }
+  memcpy(_tags, tags, count * sizeof(SentientRfidTag));
+  _count = count;
+  return true;
+}
+
+void SentientRfidTagTable::save()
+{
+  // Tags first, then the header that vouches for them; update() skips
+  // bytes that already hold the value, so unchanged tags cost no writes
+  writeU32(_address, 0xFFFFFFFF);
+  for (uint16_t i = 0; i < _count; i++)
+  {
+    for (uint8_t b = 0; b < kTagBytes; b++)
+    {
+      EEPROM.update(_address + kHeaderBytes + i * kTagBytes + b, (uint8_t)(_tags[i] >> (8 * b)));
+    }
+  }
+  writeU32(_address + 4, _count);
+  writeU32(_address + 8, storedChecksum(_count));
+  writeU32(_address, kMagic);
+}
+
+uint32_t SentientRfidTagTable::storedChecksum(uint16_t count) const
+{
+  uint32_t h = 2166136261u;
+  h = fnv(fnv(h, (uint8_t)count), (uint8_t)(count >> 8));
+  const size_t bytes = (size_t)count * kTagBytes;
+  for (size_t i = 0; i < bytes; i++)
+  {
+    h = fnv(h, EEPROM.read(_address + kHeaderBytes + i));
+  }
+  return h;
+}
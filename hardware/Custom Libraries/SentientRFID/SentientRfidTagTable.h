@@ -0,0 +1,131 @@
+/*
+ * SentientRfidTagTable.h
+ *
+ * Numbered tag list (tag -> 1..n) with constant-time lookup, replaceable at
+ * run time and persisted in EEPROM (flash emulated on Teensy 4).
+ *
+ * Tags are SentientRfidTag integers, so a lookup is a hash probe over
+ * 64-bit keys instead of a strcmp() over every entry:
+ * - the list itself is numbered by position, defaults[0] is number 1;
+ * - an open-addressing index at most half full maps a tag to its position,
+ *   so a probe ends after one or two slots however many tags there are;
+ * - the index is rebuilt whenever the list changes.
+ *
+ * The firmware defaults are a constexpr array of 48-bit literals, checked by
+ * the compiler with sentient_rfid::valid_tags() (every checksum valid, no
+ * tag twice). A list changed with assign() or replace() is written to
+ * EEPROM and wins over the defaults on the next boot until restoreDefaults().
+ * The tags are written before the header that validates them, so a reset
+ * mid-write leaves the defaults in charge rather than a half-written list.
+ *
+ * USAGE:
+ *   constexpr SentientRfidTag defaults[] = {0x0C007DAE1DC2, 0x3C0088C9CFB2};
+ *   static_assert(sentient_rfid::valid_tags(defaults), "Bad tag list");
+ *
+ *   SentientRfidTagTable tags;
+ *   tags.begin(defaults);                  // Stored list if any, else defaults
+ *   uint16_t number = tags.lookup(tag);    // 1..count, 0 = unknown tag
+ *   tags.assign(2, replacementTag);        // Replace a lost tag, persisted
+ */
+
+#ifndef SENTIENT_RFID_TAG_TABLE_H
+#define SENTIENT_RFID_TAG_TABLE_H
+
+#include <Arduino.h>
+#include "SentientRfidReaders.h"
+
+#ifndef SENTIENT_RFID_TABLE_SIZE
+#define SENTIENT_RFID_TABLE_SIZE 64 // Tags per table, numbered 1..SENTIENT_RFID_TABLE_SIZE
+#endif
+
+namespace sentient_rfid
+{
+  // Defaults must carry valid checksums and appear once each; 0 leaves a number unassigned
+  template <size_t N>
+  constexpr bool valid_tags(const SentientRfidTag (&tags)[N])
+  {
+    if (N > SENTIENT_RFID_TABLE_SIZE)
+      return false;
+    for (size_t i = 0; i < N; i++)
+    {
+      if (tags[i] != 0 && !SentientRfidReaders::checksumValid(tags[i]))
+        return false;
+      for (size_t j = i + 1; j < N; j++)
+      {
+        if (tags[i] != 0 && tags[i] == tags[j])
+          return false;
+      }
+    }
+    return true;
+  }
+
+  // Power of two at least twice the entry count
+  constexpr size_t slots_for(size_t entries)
+  {
+    size_t slots = 4;
+    while (slots < entries * 2)
+    {
+      slots <<= 1;
+    }
+    return slots;
+  }
+}
+
+class SentientRfidTagTable
+{
+public:
+  SentientRfidTagTable() = default;
+  SentientRfidTagTable(const SentientRfidTagTable &) = delete;
+  SentientRfidTagTable &operator=(const SentientRfidTagTable &) = delete;
+
+  // Load the list stored at eepromAddress, or the defaults when none is stored
+  template <size_t N>
+  bool begin(const SentientRfidTag (&defaults)[N], int eepromAddress = 0)
+  {
+    return begin(defaults, N, eepromAddress);
+  }
+  bool begin(const SentientRfidTag *defaults, uint16_t count, int eepromAddress = 0);
+
+  // Number of the tag (1..count), 0 when unknown
+  uint16_t lookup(SentientRfidTag tag) const;
+  SentientRfidTag tag(uint16_t number) const { return number >= 1 && number <= _count ? _tags[number - 1] : 0; }
+  uint16_t count() const { return _count; }
+  bool stored() const { return _stored; } // List came from (or went to) EEPROM
+
+  // Set one number's tag (0 unassigns it); count + 1 appends. Fails if the
+  // tag is invalid or already has another number. Persisted on success.
+  bool assign(uint16_t number, SentientRfidTag tag);
+  // Replace the whole list; same rules, all or nothing. Persisted on success.
+  bool replace(const SentientRfidTag *tags, uint16_t count);
+  // Forget the stored list and go back to the firmware defaults
+  bool restoreDefaults();
+
+  // EEPROM bytes used from eepromAddress
+  static constexpr size_t storageBytes() { return kHeaderBytes + SENTIENT_RFID_TABLE_SIZE * kTagBytes; }
+
+private:
+  static constexpr uint8_t kEmpty = 0xFF;
+  static constexpr size_t kSlots = sentient_rfid::slots_for(SENTIENT_RFID_TABLE_SIZE);
+  static constexpr size_t kHeaderBytes = 12; // Magic, count, checksum
+  static constexpr size_t kTagBytes = 6;     // 48 bits, little endian
+
+  static_assert(SENTIENT_RFID_TABLE_SIZE < kEmpty, "SENTIENT_RFID_TABLE_SIZE must fit the index");
+
+  // Fill slots for tags; false on an invalid or repeated tag
+  static bool index(const SentientRfidTag *tags, uint16_t count, uint8_t *slots);
+  static size_t slotOf(SentientRfidTag tag);
+  bool load();
+  void save();
+  uint32_t storedChecksum(uint16_t count) const;
+
+  SentientRfidTag _tags[SENTIENT_RFID_TABLE_SIZE] = {};
+  uint8_t _slots[kSlots] = {};
+  uint16_t _count = 0;
+  const SentientRfidTag *_defaults = nullptr;
+  uint16_t _defaultCount = 0;
+  int _address = 0;
+  bool _stored = false;
+  bool _started = false;
+};
+
+#endif // SENTIENT_RFID_TAG_TABLE_H
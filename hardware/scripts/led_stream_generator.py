@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+"""
+LED stream frame generator for SentientLedStream controllers.
+
+Sends a moving rainbow as E1.31 (sACN) or DDP frames at a fixed rate, so a
+controller's streaming path can be checked without a lighting desk.
+
+Examples:
+  # floor_v2: 540 pixels packed from universe 1, 40 fps
+  ./led_stream_generator.py 192.168.2.50 --pixels 540 --fps 40
+
+  # picture_frame_leds_v2: 32 strips of 12 pixels over DDP
+  ./led_stream_generator.py 192.168.2.51 --pixels 384 --protocol ddp
+
+  # picture_frame_leds_v2 over E1.31: one universe per TV
+  ./led_stream_generator.py 192.168.2.51 --zone 1:96 --zone 2:96 --zone 3:96 --zone 4:96
+
+  # main_lighting_v2: two 300 pixel zones starting at universes 1 and 3
+  ./led_stream_generator.py 192.168.2.52 --zone 1:300 --zone 3:300
+"""
+
+import argparse
+import colorsys
+import socket
+import struct
+import time
+import uuid
+
+E131_PORT = 5568
+DDP_PORT = 4048
+PIXELS_PER_UNIVERSE = 170
+UNIVERSE_BYTES = PIXELS_PER_UNIVERSE * 3
+DDP_MAX_DATA = 1440  # 480 pixels, fits one Ethernet frame
+
+
+def e131_packet(cid, universe, sequence, data, sync_universe=0):
+    """E1.31 data packet: root, framing and DMP layers, start code 0."""
+    slots = bytes([0]) + data
+    dmp = struct.pack("!HBBHHH", 0x7000 | (10 + len(slots)), 0x02, 0xA1, 0, 1, len(slots)) + slots
+    source = b"Sentient stream generator".ljust(64, b"\0")
+    framing = struct.pack("!HI", 0x7000 | (77 + len(dmp)), 0x00000002) + source
+    framing += struct.pack("!BHBBH", 100, sync_universe, sequence, 0, universe) + dmp
+    root = struct.pack("!HI", 0x7000 | (22 + len(framing)), 0x00000004) + cid + framing
+    return struct.pack("!HH12s", 0x0010, 0, b"ASC-E1.17\0\0\0") + root
+
+
+def e131_sync_packet(cid, sync_universe, sequence):
+    framing = struct.pack("!HIBHH", 0x7000 | 11, 0x00000001, sequence, sync_universe, 0)
+    root = struct.pack("!HI", 0x7000 | (22 + len(framing)), 0x00000008) + cid + framing
+    return struct.pack("!HH12s", 0x0010, 0, b"ASC-E1.17\0\0\0") + root
+
+
+def ddp_packet(sequence, offset, data, push):
+    flags = 0x40 | (0x01 if push else 0)
+    return struct.pack("!BBBBIH", flags, sequence, 0x0B, 1, offset, len(data)) + data
+
+
+def rainbow(pixels, phase):
+    out = bytearray()
+    for i in range(pixels):
+        r, g, b = colorsys.hsv_to_rgb(((i / max(pixels, 1)) + phase) % 1.0, 1.0, 1.0)
+        out += bytes((int(r * 255), int(g * 255), int(b * 255)))
+    return bytes(out)
+
+
+def parse_zones(args):
+    """[(first universe, pixels)]; --pixels alone packs from universe 1."""
+    if args.zone:
+        zones = []
+        for zone in args.zone:
+            universe, pixels = zone.split(":")
+            zones.append((int(universe), int(pixels)))
+        return zones
+    return [(1, args.pixels)]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("host", nargs="?", default="127.0.0.1", help="Controller IP (default: localhost)")
+    parser.add_argument("--protocol", choices=("e131", "ddp"), default="e131")
+    parser.add_argument("--pixels", type=int, default=540, help="Pixels packed from universe 1")
+    parser.add_argument("--zone", action="append", help="UNIVERSE:PIXELS, repeatable (E1.31 layout)")
+    parser.add_argument("--fps", type=float, default=40.0)
+    parser.add_argument("--seconds", type=float, default=0, help="Stop after this long (default: run until Ctrl-C)")
+    parser.add_argument("--sync", type=int, default=0, help="E1.31 sync universe (0: no sync packets)")
+    parser.add_argument("--drop", type=int, default=0, help="Skip every Nth packet to exercise loss handling")
+    args = parser.parse_args()
+
+    zones = parse_zones(args)
+    total = sum(pixels for _, pixels in zones)
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    cid = uuid.uuid4().bytes
+    sequences = {}
+    ddp_sequence = 0
+    sync_sequence = 0
+    sent = 0
+    frames = 0
+    period = 1.0 / args.fps
+    started = time.monotonic()
+    next_frame = started
+    report_at = started + 1.0
+    report_frames = 0
+
+    print(f"Streaming {total} pixels over {args.protocol.upper()} to {args.host} at {args.fps:g} fps")
+    try:
+        while not args.seconds or time.monotonic() - started < args.seconds:
+            frame = rainbow(total, frames / (args.fps * 4))
+            packets = []
+            if args.protocol == "e131":
+                offset = 0
+                for first, pixels in zones:
+                    zone = frame[offset * 3:(offset + pixels) * 3]
+                    offset += pixels
+                    for u in range((len(zone) + UNIVERSE_BYTES - 1) // UNIVERSE_BYTES):
+                        universe = first + u
+                        sequences[universe] = (sequences.get(universe, 0) + 1) & 0xFF
+                        chunk = zone[u * UNIVERSE_BYTES:(u + 1) * UNIVERSE_BYTES]
+                        packets.append((E131_PORT, e131_packet(cid, universe, sequences[universe], chunk, args.sync)))
+                if args.sync:
+                    sync_sequence = (sync_sequence + 1) & 0xFF
+                    packets.append((E131_PORT, e131_sync_packet(cid, args.sync, sync_sequence)))
+            else:
+                for offset in range(0, len(frame), DDP_MAX_DATA):
+                    ddp_sequence = ddp_sequence % 15 + 1
+                    chunk = frame[offset:offset + DDP_MAX_DATA]
+                    push = offset + DDP_MAX_DATA >= len(frame)
+                    packets.append((DDP_PORT, ddp_packet(ddp_sequence, offset, chunk, push)))
+
+            for port, packet in packets:
+                sent += 1
+                if args.drop and sent % args.drop == 0:
+                    continue
+                sock.sendto(packet, (args.host, port))
+
+            now = time.monotonic()
+            if now >= report_at:
+                print(f"{report_frames} fps, {len(packets)} packets per frame")
+                report_frames = 0
+                report_at += 1.0
+            frames += 1
+            report_frames += 1
+            next_frame += period
+            time.sleep(max(0.0, next_frame - time.monotonic()))
+    except KeyboardInterrupt:
+        pass
+    print(f"Sent {frames} frames")
+
+
+if __name__ == "__main__":
+    main()
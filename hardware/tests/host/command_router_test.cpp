@@ -0,0 +1,80 @@
+/*
+ * command_router_test.cpp
+ *
+ * SentientCommandRouter on the host with a deliberately small trie, so a
+ * registration runs out of nodes halfway through. Routes registered before
+ * the failed add must still dispatch, and the trie must accept new routes
+ * afterwards.
+ */
+
+#include "host_test.h"
+
+#include <SentientCommandRouter.h>
+
+namespace
+{
+  const char *g_lastDevice = nullptr;
+  const char *g_lastName = nullptr;
+  void *g_lastContext = nullptr;
+  int g_calls = 0;
+
+  void record(const SentientCommand &command, const JsonDocument &, void *context)
+  {
+    g_lastDevice = command.deviceId;
+    g_lastName = command.name;
+    g_lastContext = context;
+    ++g_calls;
+  }
+
+  bool dispatch(SentientCommandRouter &router, const char *device, const char *name, void *expected)
+  {
+    static JsonDocument payload;
+    SentientCommand command;
+    command.device = {device, strlen(device)};
+    command.command = {name, strlen(name)};
+    g_lastContext = nullptr;
+    return router.dispatch(command, payload) && g_lastContext == expected && strcmp(g_lastName, name) == 0;
+  }
+
+  int tags[8];
+}
+
+int main()
+{
+  static_assert(SENTIENT_ROUTER_MAX_NODES == 32, "the test sizes its routes for a 32-node trie");
+  static SentientCommandRouter router;
+
+  CHECK(router.add("lamp", "on", record, &tags[0]));
+  CHECK(router.add("lamp", "off", record, &tags[1]));
+  CHECK(router.add("door", "open", record, &tags[2]));
+  CHECK(router.add(SENTIENT_ANY_DEVICE, "reset", record, &tags[3]));
+  const size_t nodes = router.nodeCount();
+  const size_t routes = router.routeCount();
+
+  // Fails below "lamp/", where the first new node is prepended to the list
+  // holding "o"
+  CHECK(!router.add("lamp", "flicker_slowly_forever", record, &tags[4]));
+  // Fails at the root, where the first new node is prepended to the list
+  // holding "l", "d" and "+"
+  CHECK(!router.add("projector_and_screen", "up", record, &tags[5]));
+  CHECK(router.nodeCount() == nodes);
+  CHECK(router.routeCount() == routes);
+
+  CHECK(dispatch(router, "lamp", "on", &tags[0]));
+  CHECK(dispatch(router, "lamp", "off", &tags[1]));
+  CHECK(dispatch(router, "door", "open", &tags[2]));
+  CHECK(dispatch(router, "fan", "reset", &tags[3]));
+  CHECK(dispatch(router, "", "reset", &tags[3]));
+  CHECK(!dispatch(router, "lamp", "flicker_slowly_forever", &tags[4]));
+  CHECK(!dispatch(router, "lamp", "f", nullptr));
+
+  // The freed nodes are reusable, and a shorter route next to the partial
+  // one fits
+  CHECK(router.add("lamp", "dim", record, &tags[6]));
+  CHECK(dispatch(router, "lamp", "dim", &tags[6]));
+  CHECK(dispatch(router, "lamp", "on", &tags[0]));
+  CHECK(dispatch(router, "door", "open", &tags[2]));
+  CHECK(g_lastDevice && strcmp(g_lastDevice, "door") == 0);
+
+  return hostTestResult();
+}
@@ -0,0 +1,49 @@
+/*
+ * host_test.h
+ *
+ * Minimal checks for the host tests: CHECK records a failure and keeps
+ * going, so one run reports every broken expectation; main() returns
+ * hostTestResult() for ctest.
+ */
+
+#ifndef SENTIENT_HOST_TEST_H
+#define SENTIENT_HOST_TEST_H
+
+#include <chrono>
+#include <stdio.h>
+
+inline int &hostTestFailures()
+{
+  static int failures = 0;
+  return failures;
+}
+
+#define CHECK(condition)                                                  \
+  do                                                                      \
+  {                                                                       \
+    if (!(condition))                                                     \
+    {                                                                     \
+      printf("%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+      ++hostTestFailures();                                               \
+    }                                                                     \
+  } while (0)
+
+inline int hostTestResult()
+{
+  if (hostTestFailures())
+  {
+    printf("%d check(s) failed\n", hostTestFailures());
+    return 1;
+  }
+  printf("all checks passed\n");
+  return 0;
+}
+
+// Wall-clock nanoseconds for the benchmarks; host timings only rank
+// alternatives, the numbers that matter come from the Teensy profiler
+inline uint64_t hostNanos()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif // SENTIENT_HOST_TEST_H
@@ -0,0 +1,153 @@
+/*
+ * led_kernels_bench.cpp
+ *
+ * SentientLedKernels against byte-at-a-time loops over the same FastLED
+ * formulas, at strip sizes from a gauge (34) to floor_v2 (540) and a long
+ * chain (2048). Built with autovectorisation off so the host compiler does
+ * not turn the byte loops into SIMD the Teensy does not have; the ratios
+ * are indicative only, the packed DSP path runs on target.
+ */
+
+#include "host_test.h"
+#include "led_kernels_reference.h"
+
+#include <SentientLedKernels.h>
+
+#include <vector>
+
+namespace
+{
+  // The byte-wise versions, one FastLED call per channel
+  namespace bytewise
+  {
+    __attribute__((noinline)) void add(uint8_t *rgb, const uint8_t *other, uint16_t count)
+    {
+      for (size_t i = 0; i < (size_t)count * 3; ++i)
+      {
+        rgb[i] = reference::qadd8(rgb[i], other[i]);
+      }
+    }
+
+    __attribute__((noinline)) void fade(uint8_t *rgb, uint16_t count, uint8_t amount)
+    {
+      for (size_t i = 0; i < (size_t)count * 3; ++i)
+      {
+        rgb[i] = reference::qsub8(rgb[i], amount);
+      }
+    }
+
+    __attribute__((noinline)) void scale(uint8_t *rgb, uint16_t count, uint8_t scale)
+    {
+      for (size_t i = 0; i < (size_t)count * 3; ++i)
+      {
+        rgb[i] = reference::scale8(rgb[i], scale);
+      }
+    }
+
+    __attribute__((noinline)) void scaleVideo(uint8_t *rgb, uint16_t count, uint8_t scale)
+    {
+      for (size_t i = 0; i < (size_t)count * 3; ++i)
+      {
+        rgb[i] = reference::scale8_video(rgb[i], scale);
+      }
+    }
+
+    __attribute__((noinline)) void blend(uint8_t *rgb, const uint8_t *overlay, uint16_t count, uint8_t amount)
+    {
+      for (size_t i = 0; i < (size_t)count * 3; ++i)
+      {
+        rgb[i] = reference::nblend(rgb[i], overlay[i], amount);
+      }
+    }
+
+    __attribute__((noinline)) void drift(uint8_t *values, const int8_t *steps, uint16_t count, uint8_t floor)
+    {
+      for (size_t i = 0; i < count; ++i)
+      {
+        values[i] = reference::drift(values[i], steps[i], floor);
+      }
+    }
+  }
+
+  uint32_t g_random = 99;
+  uint8_t nextByte()
+  {
+    g_random = g_random * 1664525u + 1013904223u;
+    return g_random >> 24;
+  }
+
+  // Nanoseconds per pixel; the buffer is refreshed between rounds so the
+  // saturating kernels do not settle at 0 or 255
+  template <typename Run>
+  double time(uint16_t pixels, Run run)
+  {
+    std::vector<uint8_t> seed(pixels * 3), buffer(pixels * 3);
+    for (uint8_t &b : seed)
+    {
+      b = nextByte();
+    }
+    uint64_t best = ~0ull;
+    for (int round = 0; round < 20; ++round)
+    {
+      buffer = seed;
+      const uint64_t start = hostNanos();
+      for (int i = 0; i < 50; ++i)
+      {
+        run(buffer.data(), pixels, (uint8_t)(i * 37 + 1));
+      }
+      best = std::min(best, hostNanos() - start);
+    }
+    return (double)best / 50 / pixels;
+  }
+}
+
+int main()
+{
+  std::vector<uint8_t> other(2048 * 3);
+  for (uint8_t &b : other)
+  {
+    b = nextByte();
+  }
+  const uint8_t *o = other.data();
+  const int8_t *steps = reinterpret_cast<const int8_t *>(o);
+  SentientLedPalette16 palette;
+  for (uint32_t &entry : palette.entries)
+  {
+    entry = SentientLedKernels::pack(nextByte(), nextByte(), nextByte());
+  }
+
+  printf("%-11s %6s %14s %14s %8s\n", "kernel", "pixels", "byte-wise ns/px", "packed ns/px", "speedup");
+  for (uint16_t pixels : {34, 540, 2048})
+  {
+    struct Row
+    {
+      const char *name;
+      double bytes;
+      double packed;
+    } rows[] = {
+        {"add", time(pixels, [o](uint8_t *p, uint16_t n, uint8_t) { bytewise::add(p, o, n); }),
+         time(pixels, [o](uint8_t *p, uint16_t n, uint8_t) { SentientLedKernels::add(p, o, n); })},
+        {"fade", time(pixels, [](uint8_t *p, uint16_t n, uint8_t s) { bytewise::fade(p, n, s & 15); }),
+         time(pixels, [](uint8_t *p, uint16_t n, uint8_t s) { SentientLedKernels::fade(p, n, s & 15); })},
+        {"scale", time(pixels, [](uint8_t *p, uint16_t n, uint8_t s) { bytewise::scale(p, n, s | 0xC0); }),
+         time(pixels, [](uint8_t *p, uint16_t n, uint8_t s) { SentientLedKernels::scale(p, n, s | 0xC0); })},
+        {"scaleVideo", time(pixels, [](uint8_t *p, uint16_t n, uint8_t s) { bytewise::scaleVideo(p, n, s | 0xC0); }),
+         time(pixels, [](uint8_t *p, uint16_t n, uint8_t s) { SentientLedKernels::scaleVideo(p, n, s | 0xC0); })},
+        {"blend", time(pixels, [o](uint8_t *p, uint16_t n, uint8_t s) { bytewise::blend(p, o, n, s | 1); }),
+         time(pixels, [o](uint8_t *p, uint16_t n, uint8_t s) { SentientLedKernels::blend(p, o, n, s | 1); })},
+        {"drift", time(pixels, [steps](uint8_t *p, uint16_t n, uint8_t s) { bytewise::drift(p, steps, n * 3, s); }),
+         time(pixels, [steps](uint8_t *p, uint16_t n, uint8_t s) { SentientLedKernels::drift(p, steps, n * 3, s); })},
+    };
+    for (const Row &row : rows)
+    {
+      printf("%-11s %6u %14.2f %14.2f %7.2fx\n", row.name, pixels, row.bytes, row.packed, row.bytes / row.packed);
+    }
+  }
+
+  // The palette lookup has no byte-wise twin here; report its cost alone
+  std::vector<uint8_t> leds(540 * 3);
+  const double lookup = time(540, [&](uint8_t *p, uint16_t n, uint8_t s)
+                             { SentientLedKernels::paletteMap(leds.data(), p, n, palette, s); });
+  printf("paletteMap    540 %29.2f\n", lookup);
+  return hostTestResult();
+}
@@ -0,0 +1,88 @@
+/*
+ * led_kernels_reference.h
+ *
+ * FastLED's byte-at-a-time formulas (FASTLED_SCALE8_FIXED and
+ * FASTLED_BLEND_FIXED, the library defaults), as the reference the packed
+ * SentientLedKernels are checked and timed against.
+ */
+
+#ifndef SENTIENT_LED_KERNELS_REFERENCE_H
+#define SENTIENT_LED_KERNELS_REFERENCE_H
+
+#include <stdint.h>
+
+namespace reference
+{
+  inline uint8_t qadd8(uint8_t i, uint8_t j)
+  {
+    const unsigned t = i + j;
+    return t > 255 ? 255 : t;
+  }
+
+  inline uint8_t qsub8(uint8_t i, uint8_t j)
+  {
+    return i > j ? i - j : 0;
+  }
+
+  inline uint8_t scale8(uint8_t i, uint8_t scale)
+  {
+    return ((uint16_t)i * (1 + (uint16_t)scale)) >> 8;
+  }
+
+  inline uint8_t scale8_video(uint8_t i, uint8_t scale)
+  {
+    return (((int)i * (int)scale) >> 8) + ((i && scale) ? 1 : 0);
+  }
+
+  inline uint8_t blend8(uint8_t a, uint8_t b, uint8_t amountOfB)
+  {
+    uint16_t partial = (a << 8) | b;
+    partial += b * amountOfB;
+    partial -= a * amountOfB;
+    return partial >> 8;
+  }
+
+  // nblend() for one channel: 0 keeps, 255 takes the overlay
+  inline uint8_t nblend(uint8_t existing, uint8_t overlay, uint8_t amount)
+  {
+    return amount == 0 ? existing : (amount == 255 ? overlay : blend8(existing, overlay, amount));
+  }
+
+  inline uint8_t drift(uint8_t value, int8_t step, uint8_t floor)
+  {
+    int v = value + step;
+    v = v < 0 ? 0 : (v > 255 ? 255 : v);
+    return v < floor ? floor : v;
+  }
+
+  // ColorFromPalette(palette16, index, brightness, LINEARBLEND) for one
+  // channel, given the two neighbouring entries' values
+  inline uint8_t paletteChannel(uint8_t c1, uint8_t c2, uint8_t index, uint8_t brightness)
+  {
+    const uint8_t lo4 = index & 0x0F;
+    if (lo4)
+    {
+      const uint8_t f2 = lo4 << 4;
+      const uint8_t f1 = 255 - f2;
+      c1 = scale8(c1, f1) + scale8(c2, f2);
+    }
+    if (brightness != 255)
+    {
+      if (brightness)
+      {
+        ++brightness; // As FastLED does, to round
+        if (c1)
+        {
+          c1 = scale8(c1, brightness);
+        }
+      }
+      else
+      {
+        c1 = 0;
+      }
+    }
+    return c1;
+  }
+}
+
+#endif // SENTIENT_LED_KERNELS_REFERENCE_H
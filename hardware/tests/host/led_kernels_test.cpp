@@ -0,0 +1,235 @@
+/*
+ * led_kernels_test.cpp
+ *
+ * SentientLedKernels against FastLED's byte-wise formulas, bit for bit,
+ * for every input pair in every lane of a word and every scalar argument.
+ * Random buffers of every tail length then check that neighbouring lanes
+ * never leak into each other. On the host this exercises the portable
+ * path; the DSP path must give the same results.
+ */
+
+#include "host_test.h"
+#include "led_kernels_reference.h"
+
+#include <SentientLedKernels.h>
+
+#include <algorithm>
+#include <stdlib.h>
+#include <vector>
+
+namespace
+{
+  // Every byte value in all four lanes of a word: byte j holds j / 4,
+  // plus a two-byte tail so the last pixel is complete
+  constexpr uint16_t kPixels = 342;
+  constexpr size_t kBytes = kPixels * 3;
+
+  uint32_t g_random = 12345;
+  uint8_t nextByte()
+  {
+    g_random = g_random * 1664525u + 1013904223u;
+    return g_random >> 24;
+  }
+
+  std::vector<uint8_t> sweep()
+  {
+    std::vector<uint8_t> bytes(kBytes);
+    for (size_t j = 0; j < kBytes; ++j)
+    {
+      bytes[j] = (uint8_t)(j >> 2);
+    }
+    return bytes;
+  }
+
+  template <typename Kernel, typename Reference>
+  bool matchesForEveryScalar(Kernel kernel, Reference reference)
+  {
+    const std::vector<uint8_t> input = sweep();
+    for (unsigned scalar = 0; scalar < 256; ++scalar)
+    {
+      std::vector<uint8_t> out = input;
+      kernel(out.data(), kPixels, (uint8_t)scalar);
+      for (size_t j = 0; j < kBytes; ++j)
+      {
+        if (out[j] != reference(input[j], (uint8_t)scalar))
+        {
+          printf("  byte %zu = %u with %u: %u, expected %u\n", j, input[j], scalar, out[j],
+                 reference(input[j], (uint8_t)scalar));
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  void scalarKernels()
+  {
+    CHECK(matchesForEveryScalar(SentientLedKernels::fade, reference::qsub8));
+    CHECK(matchesForEveryScalar(SentientLedKernels::scale, reference::scale8));
+    CHECK(matchesForEveryScalar(SentientLedKernels::scaleVideo, reference::scale8_video));
+  }
+
+  void pairKernels()
+  {
+    const std::vector<uint8_t> other = sweep();
+    bool addOk = true, blendOk = true, driftOk = true;
+    for (unsigned a = 0; a < 256; ++a)
+    {
+      std::vector<uint8_t> sum(kBytes, (uint8_t)a);
+      SentientLedKernels::add(sum.data(), other.data(), kPixels);
+      for (size_t j = 0; j < kBytes; ++j)
+      {
+        addOk = addOk && sum[j] == reference::qadd8(a, other[j]);
+      }
+
+      for (unsigned amount = 0; amount < 256; ++amount)
+      {
+        std::vector<uint8_t> mixed(kBytes, (uint8_t)a);
+        SentientLedKernels::blend(mixed.data(), other.data(), kPixels, (uint8_t)amount);
+        for (size_t j = 0; j < kBytes; ++j)
+        {
+          blendOk = blendOk && mixed[j] == reference::nblend(a, other[j], amount);
+        }
+
+        // drift() counts values, not pixels
+        const unsigned floor = amount;
+        std::vector<uint8_t> values(kBytes, (uint8_t)a);
+        SentientLedKernels::drift(values.data(), reinterpret_cast<const int8_t *>(other.data()), kBytes, floor);
+        for (size_t j = 0; j < kBytes; ++j)
+        {
+          driftOk = driftOk && values[j] == reference::drift(a, (int8_t)other[j], floor);
+        }
+      }
+    }
+    CHECK(addOk);
+    CHECK(blendOk);
+    CHECK(driftOk);
+  }
+
+  // Random neighbours and every length up to a few words past the tail
+  void randomBuffers()
+  {
+    bool ok = true;
+    for (int round = 0; round < 2000 && ok; ++round)
+    {
+      const uint16_t pixels = round % 40;
+      const size_t bytes = pixels * 3;
+      std::vector<uint8_t> a(bytes + 4), b(bytes + 4);
+      for (size_t j = 0; j < a.size(); ++j)
+      {
+        a[j] = nextByte();
+        b[j] = nextByte();
+      }
+      const uint8_t scalar = nextByte();
+      std::vector<uint8_t> out;
+
+      out = a;
+      SentientLedKernels::add(out.data(), b.data(), pixels);
+      for (size_t j = 0; j < bytes; ++j)
+      {
+        ok = ok && out[j] == reference::qadd8(a[j], b[j]);
+      }
+      out = a;
+      SentientLedKernels::blend(out.data(), b.data(), pixels, scalar);
+      for (size_t j = 0; j < bytes; ++j)
+      {
+        ok = ok && out[j] == reference::nblend(a[j], b[j], scalar);
+      }
+      out = a;
+      SentientLedKernels::scaleVideo(out.data(), pixels, scalar);
+      for (size_t j = 0; j < bytes; ++j)
+      {
+        ok = ok && out[j] == reference::scale8_video(a[j], scalar);
+      }
+      out = a;
+      SentientLedKernels::fade(out.data(), pixels, scalar);
+      for (size_t j = 0; j < bytes; ++j)
+      {
+        ok = ok && out[j] == reference::qsub8(a[j], scalar);
+      }
+      // Nothing past the last pixel is touched
+      for (size_t j = bytes; j < a.size(); ++j)
+      {
+        ok = ok && out[j] == a[j];
+      }
+    }
+    CHECK(ok);
+  }
+
+  void fill()
+  {
+    for (uint16_t pixels = 0; pixels < 16; ++pixels)
+    {
+      std::vector<uint8_t> leds(pixels * 3 + 4, 0xA5);
+      const uint32_t color = SentientLedKernels::pack(255, 96, 0);
+      CHECK(SentientLedKernels::fill(leds.data(), pixels, color) == (pixels > 0));
+      bool ok = true;
+      for (uint16_t i = 0; i < pixels; ++i)
+      {
+        ok = ok && leds[i * 3] == 255 && leds[i * 3 + 1] == 96 && leds[i * 3 + 2] == 0;
+      }
+      for (size_t j = pixels * 3; j < leds.size(); ++j)
+      {
+        ok = ok && leds[j] == 0xA5;
+      }
+      CHECK(ok);
+      CHECK(!SentientLedKernels::fill(leds.data(), pixels, color));
+    }
+  }
+
+  // Documented as within one step of ColorFromPalette(..., LINEARBLEND)
+  void palette()
+  {
+    SentientLedPalette16 palette;
+    for (uint8_t i = 0; i < 16; ++i)
+    {
+      palette.entries[i] = SentientLedKernels::pack(nextByte(), nextByte(), nextByte());
+    }
+    palette.entries[3] = SentientLedKernels::pack(255, 255, 255);
+    palette.entries[4] = 0;
+
+    int worst = 0;
+    for (unsigned index = 0; index < 256; ++index)
+    {
+      const uint32_t c1 = palette.entries[index >> 4];
+      const uint32_t c2 = palette.entries[((index >> 4) + 1) & 0x0F];
+      for (unsigned brightness = 0; brightness < 256; ++brightness)
+      {
+        const uint32_t color = SentientLedKernels::paletteColor(palette, index, brightness);
+        for (int shift = 0; shift < 24; shift += 8)
+        {
+          const int expected = reference::paletteChannel(c1 >> shift, c2 >> shift, index, brightness);
+          worst = std::max(worst, abs((int)((color >> shift) & 0xFF) - expected));
+        }
+        CHECK((color >> 24) == 0);
+      }
+    }
+    CHECK(worst <= 1);
+
+    uint8_t indices[64];
+    uint8_t leds[64 * 3] = {};
+    for (uint8_t i = 0; i < 64; ++i)
+    {
+      indices[i] = nextByte();
+    }
+    CHECK(SentientLedKernels::paletteMap(leds, indices, 64, palette, 200));
+    bool ok = true;
+    for (uint8_t i = 0; i < 64; ++i)
+    {
+      const uint32_t color = SentientLedKernels::paletteColor(palette, indices[i], 200);
+      ok = ok && SentientLedKernels::pack(leds[i * 3], leds[i * 3 + 1], leds[i * 3 + 2]) == color;
+    }
+    CHECK(ok);
+    CHECK(!SentientLedKernels::paletteMap(leds, indices, 64, palette, 200));
+  }
+}
+
+int main()
+{
+  scalarKernels();
+  pairKernels();
+  randomBuffers();
+  fill();
+  palette();
+  return hostTestResult();
+}
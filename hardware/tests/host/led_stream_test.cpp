@@ -0,0 +1,325 @@
+/*
+ * led_stream_test.cpp
+ *
+ * SentientLedStream fed hand-built E1.31 and DDP datagrams, laid out as
+ * hardware/scripts/led_stream_generator.py sends them. Most cases go through
+ * receive(); the last ones queue datagrams on the stub UDP sockets so
+ * service() reads them straight from the socket.
+ */
+
+#include "host_test.h"
+
+#include <SentientLedStream.h>
+
+#include <vector>
+
+namespace
+{
+  using Packet = std::vector<uint8_t>;
+
+  constexpr uint16_t kSyncUniverse = 7000;
+  const uint8_t kCid[16] = {0x5e, 0x47, 0x11, 0x3a, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+
+  void put16(Packet &p, size_t at, uint16_t value)
+  {
+    p[at] = value >> 8;
+    p[at + 1] = (uint8_t)value;
+  }
+
+  void put32(Packet &p, size_t at, uint32_t value)
+  {
+    put16(p, at, value >> 16);
+    put16(p, at + 2, (uint16_t)value);
+  }
+
+  void rootLayer(Packet &p, uint32_t vector)
+  {
+    put16(p, 0, 0x0010);
+    memcpy(&p[4], "ASC-E1.17\0\0\0", 12);
+    put16(p, 16, 0x7000 | (p.size() - 16));
+    put32(p, 18, vector);
+    memcpy(&p[22], kCid, sizeof(kCid));
+  }
+
+  Packet e131(uint16_t universe, uint8_t sequence, const std::vector<uint8_t> &data, uint16_t sync = 0,
+              uint8_t options = 0)
+  {
+    Packet p(126 + data.size());
+    rootLayer(p, 0x00000004);
+    put16(p, 38, 0x7000 | (p.size() - 38));
+    put32(p, 40, 0x00000002);
+    memcpy(&p[44], "Sentient host test", 18);
+    p[108] = 100;
+    put16(p, 109, sync);
+    p[111] = sequence;
+    p[112] = options;
+    put16(p, 113, universe);
+    put16(p, 115, 0x7000 | (p.size() - 115));
+    p[117] = 0x02;
+    p[118] = 0xA1;
+    put16(p, 119, 0);
+    put16(p, 121, 1);
+    put16(p, 123, 1 + data.size());
+    p[125] = 0;
+    memcpy(&p[126], data.data(), data.size());
+    return p;
+  }
+
+  Packet e131Sync(uint16_t sync, uint8_t sequence)
+  {
+    Packet p(49);
+    rootLayer(p, 0x00000008);
+    put16(p, 38, 0x7000 | (p.size() - 38));
+    put32(p, 40, 0x00000001);
+    p[44] = sequence;
+    put16(p, 45, sync);
+    return p;
+  }
+
+  Packet ddp(uint8_t sequence, uint32_t offset, const std::vector<uint8_t> &data, bool push)
+  {
+    Packet p(10 + data.size());
+    p[0] = 0x40 | (push ? 0x01 : 0);
+    p[1] = sequence;
+    p[2] = 0x0B; // RGB, 8 bits per channel
+    p[3] = 1;
+    put32(p, 4, offset);
+    put16(p, 8, data.size());
+    memcpy(&p[10], data.data(), data.size());
+    return p;
+  }
+
+  // Channel values that say where they came from
+  std::vector<uint8_t> pattern(size_t bytes, uint8_t seed)
+  {
+    std::vector<uint8_t> data(bytes);
+    for (size_t i = 0; i < bytes; ++i)
+    {
+      data[i] = (uint8_t)(i * 7 + seed);
+    }
+    return data;
+  }
+
+  // Strip layout: A at universe 1, B packed after it (spilling into
+  // universe 2), C at universe 5. Universes 1, 2 and 5 make a frame.
+  CRGB ledsA[60], ledsB[200], ledsC[30];
+  constexpr size_t kBytesA = sizeof(ledsA), kBytesB = sizeof(ledsB), kBytesC = sizeof(ledsC);
+
+  uint32_t g_lastMask = 0;
+  int g_latches = 0;
+
+  void onFrame(uint32_t stripMask, void *context)
+  {
+    g_lastMask = stripMask;
+    ++g_latches;
+    ++*static_cast<int *>(context);
+  }
+
+  bool receive(SentientLedStream &stream, uint16_t port, const Packet &p)
+  {
+    return stream.receive(port, p.data(), p.size());
+  }
+
+  const uint8_t *bytes(CRGB *leds) { return leds[0].raw; }
+
+  // Universe data as the strips should hold it after one frame
+  bool stripsHold(const std::vector<uint8_t> &u1, const std::vector<uint8_t> &u2, const std::vector<uint8_t> &u5)
+  {
+    std::vector<uint8_t> b(u1.begin() + kBytesA, u1.end());
+    b.insert(b.end(), u2.begin(), u2.begin() + (kBytesB - b.size()));
+    return memcmp(bytes(ledsA), u1.data(), kBytesA) == 0 && memcmp(bytes(ledsB), b.data(), kBytesB) == 0 &&
+           memcmp(bytes(ledsC), u5.data(), kBytesC) == 0;
+  }
+
+  void mapping(SentientLedStream &stream)
+  {
+    CHECK(stream.addStrip(ledsA, 60, 1) == 0);
+    CHECK(stream.addStrip(ledsB, 200) == 1);
+    CRGB overlapping[10];
+    CHECK(stream.addStrip(overlapping, 10, 2) == -1);
+    CHECK(stream.addStrip(ledsC, 30, 5) == 2);
+    CHECK(stream.stripCount() == 3);
+    CHECK(stream.firstUniverse(0) == 1);
+    CHECK(stream.firstUniverse(1) == 1);
+    CHECK(stream.firstUniverse(2) == 5);
+  }
+
+  void e131Frames(SentientLedStream &stream)
+  {
+    // A whole frame latches on its last universe
+    const auto u1 = pattern(510, 1), u2 = pattern(510, 2), u5 = pattern(90, 5);
+    CHECK(!receive(stream, 5568, e131(1, 10, u1)));
+    CHECK(stream.active());
+    CHECK(!receive(stream, 5568, e131(2, 20, u2)));
+    CHECK(!receive(stream, 5568, e131(3, 1, pattern(510, 3)))); // Not mapped here
+    CHECK(g_latches == 0);
+    CHECK(receive(stream, 5568, e131(5, 50, u5)));
+    CHECK(g_latches == 1);
+    CHECK(g_lastMask == 0b111);
+    CHECK(stripsHold(u1, u2, u5));
+    CHECK(stream.frames() == 1 && stream.incompleteFrames() == 0);
+
+    // A duplicate is dropped and leaves the pixels alone; a gap is counted
+    CHECK(!receive(stream, 5568, e131(1, 10, pattern(510, 9))));
+    CHECK(stream.latePackets() == 1);
+    CHECK(memcmp(bytes(ledsA), u1.data(), kBytesA) == 0);
+    CHECK(!receive(stream, 5568, e131(1, 13, u1)));
+    CHECK(stream.lostPackets() == 2);
+
+    // Universe 1 again before the frame completed: the partial frame shows
+    const auto next = pattern(510, 11);
+    CHECK(receive(stream, 5568, e131(1, 14, next)));
+    CHECK(stream.incompleteFrames() == 1);
+    CHECK(g_lastMask == 0b011); // A and B had universe 1's data
+    CHECK(!receive(stream, 5568, e131(2, 21, u2)));
+    CHECK(receive(stream, 5568, e131(5, 51, u5)));
+    CHECK(stripsHold(next, u2, u5));
+    CHECK(stream.frames() == 3);
+
+    // Preview data and a nonzero start code are not pixels
+    Packet preview = e131(1, 15, pattern(510, 99), 0, 0x80);
+    Packet startCode = e131(2, 22, pattern(510, 99));
+    startCode[125] = 0xDD;
+    CHECK(!receive(stream, 5568, preview) && !receive(stream, 5568, startCode));
+    CHECK(memcmp(bytes(ledsA), next.data(), kBytesA) == 0);
+
+    // Malformed packets are rejected
+    Packet garbage = e131(1, 16, u1);
+    garbage[5] = 'X';
+    const uint32_t rejected = stream.rejectedPackets();
+    CHECK(!receive(stream, 5568, garbage));
+    CHECK(!receive(stream, 5568, Packet(20, 0)));
+    CHECK(stream.rejectedPackets() == rejected + 2);
+  }
+
+  void e131Sync(SentientLedStream &stream)
+  {
+    // With a sync address the frame waits for the sync packet
+    const auto u1 = pattern(510, 31), u2 = pattern(510, 32), u5 = pattern(90, 35);
+    const int before = g_latches;
+    CHECK(!receive(stream, 5568, e131(1, 30, u1, kSyncUniverse)));
+    CHECK(!receive(stream, 5568, e131(2, 30, u2, kSyncUniverse)));
+    CHECK(!receive(stream, 5568, e131(5, 60, u5, kSyncUniverse)));
+    CHECK(g_latches == before);
+    CHECK(!receive(stream, 5568, e131Sync(kSyncUniverse + 1, 1))); // Another group's sync
+    CHECK(g_latches == before);
+    const uint32_t incomplete = stream.incompleteFrames();
+    CHECK(receive(stream, 5568, e131Sync(kSyncUniverse, 2)));
+    CHECK(g_latches == before + 1 && g_lastMask == 0b111);
+    CHECK(stream.incompleteFrames() == incomplete);
+    CHECK(stripsHold(u1, u2, u5));
+  }
+
+  void e131Terminate(SentientLedStream &stream)
+  {
+    // Terminated: inactive, pending data dropped, sequences forgotten
+    const int before = g_latches;
+    CHECK(!receive(stream, 5568, e131(1, 31, pattern(510, 41))));
+    CHECK(!receive(stream, 5568, e131(1, 32, {}, 0, 0x40)));
+    CHECK(!stream.active());
+    CHECK(g_latches == before);
+    const uint32_t late = stream.latePackets();
+    CHECK(!receive(stream, 5568, e131(1, 5, pattern(510, 42)))); // Older sequence: a new sender
+    CHECK(stream.latePackets() == late);
+    CHECK(stream.active());
+  }
+
+  void ddpFrames(SentientLedStream &stream)
+  {
+    // DDP offsets run over A, B and C back to back: 870 bytes in all
+    const auto frame = pattern(kBytesA + kBytesB + kBytesC, 77);
+    const std::vector<uint8_t> first(frame.begin(), frame.begin() + 500), rest(frame.begin() + 500, frame.end());
+    const int before = g_latches;
+    CHECK(!receive(stream, 4048, ddp(1, 0, first, false)));
+    CHECK(g_latches == before);
+    CHECK(receive(stream, 4048, ddp(2, 500, rest, true)));
+    CHECK(g_latches == before + 1 && g_lastMask == 0b111);
+    CHECK(memcmp(bytes(ledsA), frame.data(), kBytesA) == 0);
+    CHECK(memcmp(bytes(ledsB), frame.data() + kBytesA, kBytesB) == 0);
+    CHECK(memcmp(bytes(ledsC), frame.data() + kBytesA + kBytesB, kBytesC) == 0);
+
+    // Sequence 3 lost; 2 again is late
+    const uint32_t lost = stream.lostPackets(), late = stream.latePackets();
+    CHECK(!receive(stream, 4048, ddp(4, 0, first, false)));
+    CHECK(stream.lostPackets() == lost + 1);
+    CHECK(!receive(stream, 4048, ddp(2, 0, first, false)));
+    CHECK(stream.latePackets() == late + 1);
+
+    // Back to offset 0 without a push: the partial frame is shown first
+    const uint32_t incomplete = stream.incompleteFrames();
+    CHECK(receive(stream, 4048, ddp(5, 0, first, false)));
+    CHECK(stream.incompleteFrames() == incomplete + 1);
+    CHECK(g_lastMask == 0b011);
+
+    // Only the part of C a packet covers is written
+    const std::vector<uint8_t> tail = {1, 2, 3, 4, 5, 6};
+    CHECK(receive(stream, 4048, ddp(6, kBytesA + kBytesB + 3, tail, true)));
+    CHECK(g_lastMask == 0b100 || g_lastMask == 0b111);
+    CHECK(memcmp(bytes(ledsC) + 3, tail.data(), tail.size()) == 0);
+  }
+
+  void timeout(SentientLedStream &stream)
+  {
+    CHECK(stream.active());
+    hostAdvanceMicros((SENTIENT_LED_STREAM_TIMEOUT_MS - 1) * 1000ull);
+    stream.service();
+    CHECK(stream.active());
+    hostAdvanceMicros(1000);
+    stream.service();
+    CHECK(!stream.active());
+  }
+
+  // service() reading datagrams from the sockets, at 40 fps for a second
+  void sockets(SentientLedStream &stream)
+  {
+    CHECK(stream.begin());
+    stream.service(); // Start a fresh one-second window
+    const int before = g_latches;
+    std::vector<uint8_t> u1, u2, u5;
+    for (uint8_t frame = 0; frame < 40; ++frame)
+    {
+      u1 = pattern(510, frame);
+      u2 = pattern(510, frame + 1);
+      u5 = pattern(90, frame + 2);
+      const Packet packets[] = {e131(1, 100 + frame, u1), e131(2, 100 + frame, u2), e131(5, 100 + frame, u5)};
+      for (const Packet &p : packets)
+      {
+        hostUdpDeliver(SentientLedStream::E131_PORT, p.data(), p.size());
+      }
+      CHECK(stream.service());
+      hostAdvanceMicros(25000);
+    }
+    CHECK(hostUdpPending(SentientLedStream::E131_PORT) == 0);
+    CHECK(g_latches == before + 40);
+    CHECK(stripsHold(u1, u2, u5));
+    stream.service();
+    CHECK(stream.framesPerSecond() == 40);
+
+    // DDP through its own socket, with a datagram the header says is longer
+    // than it is: only what arrived is written
+    const auto frame = pattern(kBytesA + kBytesB + kBytesC, 200);
+    Packet short_ = ddp(1, 0, frame, true);
+    short_.resize(10 + 100);
+    hostUdpDeliver(SentientLedStream::DDP_PORT, short_.data(), short_.size());
+    CHECK(stream.service());
+    CHECK(g_lastMask == 0b001);
+    CHECK(memcmp(bytes(ledsA), frame.data(), 100) == 0);
+  }
+}
+
+int main()
+{
+  static SentientLedStream stream;
+  static int frames = 0;
+  hostSetMicros(1'000'000);
+  mapping(stream);
+  stream.onFrame(onFrame, &frames);
+  e131Frames(stream);
+  e131Sync(stream);
+  e131Terminate(stream);
+  ddpFrames(stream);
+  timeout(stream);
+  sockets(stream);
+  CHECK(frames == g_latches);
+  return hostTestResult();
+}
@@ -0,0 +1,188 @@
+/*
+ * manifest_stream_test.cpp
+ *
+ * SentientManifestStream registering through SentientMQTT on host time.
+ * Every PUBLISH the socket sees is decoded, so the test counts controller
+ * and device messages: a full registration, a busy send queue (waits, does
+ * not fail), a broker lost part way (backs off, then starts again from the
+ * controller message) and a reconnect after a complete registration
+ * (registers again).
+ */
+
+#include "host_test.h"
+
+#include <SentientManifestStream.h>
+
+#include <string.h>
+
+namespace
+{
+  constexpr size_t kSendQueueBytes = 8192; // SO_SNDBUF in the fnet stub
+
+  constexpr const char *kLightCommands[] = {"on", "off"};
+  constexpr const char *kDoorSensors[] = {"open"};
+  constexpr SentientDeviceDef kLight("light", "Light", "relay", kLightCommands, 2);
+  constexpr SentientDeviceDef kDoor("door", "Door", "sensor", kDoorSensors, 1, true);
+  constexpr SentientDeviceDef kFan("fan", "Fan", "relay", kLightCommands, 2);
+
+  SENTIENT_DEVICE_REGISTRY(registry, &kLight, &kDoor, &kFan);
+
+  uint8_t g_wire[64 * 1024];
+
+  struct Counts
+  {
+    int controller = 0;
+    int devices = 0;
+  };
+
+  // Registration messages among everything sent since the capture started
+  Counts count()
+  {
+    Counts counts;
+    const size_t length = hostTcpCaptured();
+    size_t at = 0;
+    while (at + 2 <= length)
+    {
+      const uint8_t type = g_wire[at++];
+      size_t remaining = 0;
+      for (int shift = 0; at < length; shift += 7)
+      {
+        const uint8_t digit = g_wire[at++];
+        remaining |= (size_t)(digit & 0x7F) << shift;
+        if (!(digit & 0x80))
+        {
+          break;
+        }
+      }
+      if ((type & 0xF0) == 0x30 && at + 2 <= length)
+      {
+        const size_t topicLength = (g_wire[at] << 8) | g_wire[at + 1];
+        const char *topic = reinterpret_cast<const char *>(g_wire + at + 2);
+        if (topicLength == strlen("sentient/system/register/controller") &&
+            memcmp(topic, "sentient/system/register/controller", topicLength) == 0)
+        {
+          ++counts.controller;
+        }
+        if (topicLength == strlen("sentient/system/register/device") &&
+            memcmp(topic, "sentient/system/register/device", topicLength) == 0)
+        {
+          ++counts.devices;
+        }
+      }
+      at += remaining;
+    }
+    return counts;
+  }
+
+  void step(SentientMQTT &mqtt, SentientManifestStream &manifest, uint32_t ms = 10)
+  {
+    mqtt.loop();
+    manifest.loop();
+    hostAdvanceMicros(ms * 1000ul);
+  }
+
+  // Loop until the stream is registered (or ms of host time pass)
+  bool runUntilRegistered(SentientMQTT &mqtt, SentientManifestStream &manifest, uint32_t ms)
+  {
+    for (uint32_t spent = 0; spent < ms && !manifest.registered(); spent += 10)
+    {
+      step(mqtt, manifest);
+    }
+    return manifest.registered();
+  }
+
+  bool connect(SentientMQTT &mqtt)
+  {
+    for (int i = 0; i < 100 && !mqtt.isConnected(); ++i)
+    {
+      mqtt.loop();
+      hostAdvanceMicros(10'000);
+    }
+    return mqtt.isConnected();
+  }
+}
+
+int main()
+{
+  SentientMQTTConfig config;
+  config.brokerIp = IPAddress(192, 168, 20, 3);
+  config.namespaceId = "paragon";
+  config.roomId = "clockwork";
+  config.controllerId = "gauge_1_3_4";
+  config.syncClock = false;
+  config.autoHeartbeat = false;
+
+  hostSetMicros(5'000'000);
+  static SentientMQTT mqtt(config);
+  CHECK(mqtt.begin());
+  CHECK(connect(mqtt));
+  if (!mqtt.isConnected())
+  {
+    return hostTestResult();
+  }
+
+  SentientManifestStream manifest(registry);
+  manifest.set_controller_info("gauge_1_3_4", "Gauges", "2.0.0", "clockwork", "gauge_1_3_4");
+  hostTcpCapture(g_wire, sizeof(g_wire));
+
+  // A full registration: controller now, then one device per gap
+  CHECK(manifest.publish_registration(mqtt, "clockwork"));
+  CHECK(count().controller == 1 && count().devices == 0);
+  CHECK(runUntilRegistered(mqtt, manifest, 2'000));
+  CHECK(count().controller == 1 && count().devices == 3);
+
+  // A busy send queue holds the registration without failing it
+  hostTcpCapture(g_wire, sizeof(g_wire));
+  hostTcpSetBacklog(kSendQueueBytes);
+  CHECK(!manifest.publish_registration(mqtt, "clockwork"));
+  for (int i = 0; i < 50; ++i)
+  {
+    step(mqtt, manifest);
+  }
+  CHECK(manifest.in_progress() && !manifest.failed());
+  CHECK(mqtt.isConnected());
+  hostTcpSetBacklog(0);
+  CHECK(runUntilRegistered(mqtt, manifest, 2'000));
+  CHECK(count().controller == 1 && count().devices == 3);
+
+  // Broker lost after the first device: back off, then start over from the controller
+  hostTcpCapture(g_wire, sizeof(g_wire));
+  CHECK(manifest.publish_registration(mqtt, "clockwork"));
+  for (int i = 0; i < 100 && count().devices < 1; ++i)
+  {
+    step(mqtt, manifest);
+  }
+  hostTcpFailSends(true);
+  for (int i = 0; i < 20 && !manifest.failed(); ++i)
+  {
+    step(mqtt, manifest);
+  }
+  CHECK(manifest.failed());
+  const uint32_t failedAt = millis();
+  hostTcpFailSends(false);
+  while (millis() - failedAt < SENTIENT_MANIFEST_RETRY_MS - 20)
+  {
+    step(mqtt, manifest);
+  }
+  CHECK(mqtt.isConnected());             // Reconnected meanwhile,
+  CHECK(count().controller == 1);        // but waiting out the backoff
+  CHECK(runUntilRegistered(mqtt, manifest, 2'000));
+  CHECK(count().controller == 2 && count().devices == 4);
+
+  // A reconnect after a complete registration registers again
+  hostTcpCapture(g_wire, sizeof(g_wire));
+  hostTcpFailSends(true);
+  mqtt.publishTopic("paragon/clockwork/events/gauge_1_3_4/lost", "{}"); // The failed write drops the socket
+  step(mqtt, manifest);
+  CHECK(!mqtt.isConnected());
+  CHECK(!manifest.failed()); // Nothing was in flight
+  hostTcpFailSends(false);
+  CHECK(connect(mqtt));
+  step(mqtt, manifest);
+  CHECK(manifest.in_progress());
+  CHECK(runUntilRegistered(mqtt, manifest, 2'000));
+  CHECK(count().controller == 1 && count().devices == 3);
+
+  hostTcpCapture(nullptr, 0);
+  return hostTestResult();
+}
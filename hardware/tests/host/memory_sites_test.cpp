@@ -0,0 +1,87 @@
+/*
+ * memory_sites_test.cpp
+ *
+ * SentientMemory's allocation tracker attributing blocks. The malloc
+ * wrappers only exist on Teensy, so blocks are handed to track() the way
+ * they would: outside a scope each caller is its own site, inside
+ * SENTIENT_MEMORY_SCOPE every allocation is charged to the scope's name,
+ * whichever wrapper called malloc, and the innermost scope wins.
+ */
+
+#include "host_test.h"
+
+#include <SentientMemory.h>
+
+#include <string.h>
+
+namespace
+{
+  alignas(8) uint8_t g_heap[8][64]; // Stand-in blocks
+
+  // Pretend callers of malloc, such as WString's changeBuffer() and a sketch function
+  void *const kStringBuffer = reinterpret_cast<void *>(0x6000'1000);
+  void *const kJsonAllocator = reinterpret_cast<void *>(0x6000'2000);
+  void *const kSketch = reinterpret_cast<void *>(0x6000'3000);
+
+  void allocate(int block, size_t size, void *caller) { SentientMemory::track(g_heap[block], size, nullptr, caller); }
+  void release(int block, void *caller) { SentientMemory::track(nullptr, 0, g_heap[block], caller); }
+
+  // The tracked site for a scope name, or for a caller's address outside any scope
+  const SentientMemorySite *find(const SentientMemorySite *sites, uint8_t count, const char *scope, void *caller)
+  {
+    for (uint8_t i = 0; i < count; ++i)
+    {
+      const bool match = scope ? sites[i].scope && strcmp(sites[i].scope, scope) == 0
+                               : !sites[i].scope && sites[i].pc == (uint32_t)(uintptr_t)caller;
+      if (match)
+      {
+        return &sites[i];
+      }
+    }
+    return nullptr;
+  }
+}
+
+int main()
+{
+  SentientMemory::startTracking();
+
+  allocate(0, 48, kSketch);
+  allocate(1, 24, kStringBuffer);
+  {
+    SENTIENT_MEMORY_SCOPE("publish_status");
+    allocate(2, 32, kStringBuffer);
+    allocate(3, 16, kJsonAllocator);
+    {
+      SENTIENT_MEMORY_SCOPE("build_topic");
+      allocate(4, 8, kStringBuffer);
+    }
+    allocate(5, 40, kStringBuffer);
+  }
+  CHECK(sentient_memory_scope == nullptr);
+  release(3, kJsonAllocator); // Freed outside the scope: still comes off its site
+
+  SentientMemorySite sites[SENTIENT_MEMORY_TRACK_SITES];
+  const uint8_t count = SentientMemory::topSites(sites, SENTIENT_MEMORY_TRACK_SITES);
+  CHECK(count == 4);
+
+  const SentientMemorySite *publish = find(sites, count, "publish_status", nullptr);
+  CHECK(publish && publish->pc == 0);
+  CHECK(publish && publish->allocs == 3 && publish->live == 2 && publish->liveBytes == 72);
+
+  const SentientMemorySite *topic = find(sites, count, "build_topic", nullptr);
+  CHECK(topic && topic->allocs == 1 && topic->liveBytes == 8);
+
+  // Outside a scope the direct caller is the site, String's buffer included
+  const SentientMemorySite *sketch = find(sites, count, nullptr, kSketch);
+  CHECK(sketch && sketch->liveBytes == 48);
+  const SentientMemorySite *string = find(sites, count, nullptr, kStringBuffer);
+  CHECK(string && string->allocs == 1 && string->liveBytes == 24);
+  CHECK(!find(sites, count, nullptr, kJsonAllocator));
+
+  // Most live bytes first
+  CHECK(sites[0].scope && strcmp(sites[0].scope, "publish_status") == 0);
+
+  SentientMemory::stopTracking();
+  return hostTestResult();
+}
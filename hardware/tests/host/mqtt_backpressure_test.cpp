@@ -0,0 +1,120 @@
+/*
+ * mqtt_backpressure_test.cpp
+ *
+ * SentientMQTT and SentientSocketClient with a full socket send queue. A
+ * briefly full queue must fail (or offline-queue) the publishes that meet
+ * it and keep the session; only a message cut short part way through may
+ * drop the connection, and loop() then reconnects.
+ */
+
+#include "host_test.h"
+
+#include <SentientMQTT.h>
+
+namespace
+{
+  constexpr size_t kSendQueueBytes = 8192; // SO_SNDBUF in the fnet stub
+
+  // Run loop() through the connect steps (and any reconnect backoff)
+  bool connect(SentientMQTT &mqtt)
+  {
+    for (int i = 0; i < 600 && !mqtt.isConnected(); ++i)
+    {
+      mqtt.loop();
+      hostAdvanceMicros(100'000);
+    }
+    return mqtt.isConnected();
+  }
+
+  // Let the offline queue drain (one burst per drain interval)
+  void drain(SentientMQTT &mqtt)
+  {
+    for (int i = 0; i < 20 && mqtt.offlineQueueDepth() > 0; ++i)
+    {
+      hostAdvanceMicros(mqtt.config().offlineDrainIntervalMs * 1000ul);
+      mqtt.loop();
+    }
+  }
+
+  void socketWrites()
+  {
+    SentientSocketClient socket;
+    CHECK(socket.beginConnect(IPAddress(192, 168, 20, 3), 1883));
+    CHECK(socket.pollConnect() == SentientSocketClient::ConnectStatus::Connected);
+
+    const uint8_t packet[64] = {0x30};
+    hostTcpSetBacklog(kSendQueueBytes - 16);
+    const uint64_t sentBefore = hostTcpBytesSent();
+    const uint32_t started = micros();
+    CHECK(socket.write(packet, sizeof(packet)) == 0);
+    CHECK(hostTcpBytesSent() == sentBefore);                    // None of it went out
+    CHECK(micros() - started >= SENTIENT_SOCKET_WRITE_WAIT_US); // after a bounded wait
+    CHECK(socket.connected());                                  // and the connection stayed
+
+    hostTcpSetBacklog(0);
+    CHECK(socket.write(packet, sizeof(packet)) == sizeof(packet));
+    CHECK(hostTcpBytesSent() == sentBefore + sizeof(packet));
+    socket.stop();
+  }
+
+  void publishesSurviveFullQueue(SentientMQTT &mqtt)
+  {
+    hostTcpSetBacklog(kSendQueueBytes);
+
+    // Library publishes go to the offline queue, raw ones fail; neither disconnects
+    CHECK(mqtt.publishTopic("paragon/clockwork/acknowledgement/gauge_1_3_4/gauge_1/open", "{\"success\":true}"));
+    CHECK(mqtt.offlineQueueDepth() == 1);
+    CHECK(!mqtt.get_client().publish("paragon/clockwork/events/gauge_1_3_4/raw", "{}", false));
+    CHECK(!mqtt.beginPublish("sentient/system/register/device", 200));
+    CHECK(mqtt.isConnected());
+
+    hostTcpSetBacklog(0);
+    drain(mqtt);
+    CHECK(mqtt.offlineQueueDepth() == 0);
+    CHECK(mqtt.isConnected());
+  }
+
+  void streamedPublish(SentientMQTT &mqtt)
+  {
+    const uint8_t payload[100] = {'x'};
+    CHECK(mqtt.beginPublish("sentient/system/register/device", sizeof(payload)));
+    CHECK(mqtt.writePayload(payload, sizeof(payload)));
+    CHECK(mqtt.endPublish());
+    CHECK(mqtt.isConnected());
+
+    // Cut short after the header: the connection goes, then comes back
+    CHECK(mqtt.beginPublish("sentient/system/register/device", sizeof(payload)));
+    hostTcpSetBacklog(kSendQueueBytes);
+    CHECK(!mqtt.writePayload(payload, sizeof(payload)));
+    CHECK(!mqtt.endPublish());
+    CHECK(!mqtt.isConnected());
+    hostTcpSetBacklog(0);
+    CHECK(connect(mqtt));
+  }
+}
+
+int main()
+{
+  hostSetMicros(5'000'000);
+  socketWrites();
+
+  SentientMQTTConfig config;
+  config.brokerIp = IPAddress(192, 168, 20, 3);
+  config.namespaceId = "paragon";
+  config.roomId = "clockwork";
+  config.controllerId = "gauge_1_3_4";
+  config.deviceId = "gauge_1";
+  config.syncClock = false;
+  config.autoHeartbeat = false;
+
+  static SentientMQTT mqtt(config);
+  CHECK(mqtt.begin());
+  CHECK(connect(mqtt));
+  if (!mqtt.isConnected())
+  {
+    return hostTestResult();
+  }
+  publishesSurviveFullQueue(mqtt);
+  streamedPublish(mqtt);
+  return hostTestResult();
+}
@@ -0,0 +1,271 @@
+/*
+ * mqtt_publish_bench.cpp
+ *
+ * Heap allocations and host time per publish for SentientMQTT's fixed
+ * buffer publish path, next to the String and DynamicJsonDocument path it
+ * replaced (reproduced below). Both go through the same connected
+ * PubSubClient and stub socket, and must put the same bytes on the wire.
+ * malloc and friends are wrapped so the calls made while a publish runs
+ * can be counted (glibc only; elsewhere the counts read zero).
+ */
+
+#include "host_test.h"
+
+#include <SentientMQTT.h>
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#endif
+
+namespace
+{
+  bool g_counting = false;
+  uint64_t g_allocations = 0; // malloc, calloc and realloc calls
+  uint64_t g_frees = 0;
+}
+
+#if defined(__GLIBC__)
+#define HOST_COUNTS_ALLOCATIONS 1
+
+extern "C"
+{
+  void *__libc_malloc(size_t size);
+  void *__libc_calloc(size_t count, size_t size);
+  void *__libc_realloc(void *block, size_t size);
+  void __libc_free(void *block);
+
+  void *malloc(size_t size)
+  {
+    g_allocations += g_counting;
+    return __libc_malloc(size);
+  }
+
+  void *calloc(size_t count, size_t size)
+  {
+    g_allocations += g_counting;
+    return __libc_calloc(count, size);
+  }
+
+  void *realloc(void *block, size_t size)
+  {
+    g_allocations += g_counting;
+    return __libc_realloc(block, size);
+  }
+
+  void free(void *block)
+  {
+    g_frees += g_counting && block;
+    __libc_free(block);
+  }
+}
+#else
+#define HOST_COUNTS_ALLOCATIONS 0
+#endif
+
+namespace
+{
+  // SentientMQTT's publish path before the fixed topic and payload buffers,
+  // less the ensureConnected() call publishRaw() made first
+  namespace legacy
+  {
+    String buildTopic(const SentientMQTTConfig &config, const char *category, const char *item)
+    {
+      String topic;
+      topic.reserve(96);
+
+      auto appendSegment = [&topic](const char *segment)
+      {
+        if (!segment || segment[0] == '\0')
+        {
+          return;
+        }
+        if (topic.length() > 0 && topic[topic.length() - 1] != '/')
+        {
+          topic += '/';
+        }
+        topic += segment;
+      };
+
+      appendSegment(config.namespaceId ? config.namespaceId : "paragon");
+      appendSegment(config.roomId);
+      appendSegment(category);
+      appendSegment(config.controllerId);
+      appendSegment(config.deviceId);
+      appendSegment(item);
+      return topic;
+    }
+
+    bool publishJson(SentientMQTT &mqtt, const char *category, const char *item, const JsonDocument &payload)
+    {
+      String topic = buildTopic(mqtt.config(), category, item);
+      String message;
+      serializeJson(payload, message);
+      PubSubClient &client = mqtt.get_client();
+      return client.connected() && client.publish(topic.c_str(), message.c_str(), false);
+    }
+
+    bool publishSensor(SentientMQTT &mqtt, const char *name, float value, const char *unit)
+    {
+      DynamicJsonDocument doc(mqtt.config().publishJsonCapacity);
+      doc["name"] = name ? name : "sensor";
+      doc["value"] = value;
+      if (unit && unit[0] != '\0')
+      {
+        doc["unit"] = unit;
+      }
+      doc["timestamp"] = millis() / 1000;
+      return publishJson(mqtt, "sensors", name, doc);
+    }
+
+    bool publishState(SentientMQTT &mqtt, const char *state)
+    {
+      DynamicJsonDocument doc(mqtt.config().publishJsonCapacity);
+      doc["state"] = state ? state : "unknown";
+      doc["timestamp"] = millis() / 1000;
+      if (mqtt.config().deviceId)
+      {
+        doc["deviceId"] = mqtt.config().deviceId;
+      }
+      return publishJson(mqtt, "status", "state", doc);
+    }
+
+    // A controller's own event payload, built in a document of its own
+    bool publishEvent(SentientMQTT &mqtt, uint8_t position)
+    {
+      DynamicJsonDocument doc(mqtt.config().publishJsonCapacity);
+      doc["lever"] = position & 1 ? "down" : "up";
+      doc["position"] = position;
+      return publishJson(mqtt, "events", "lever_moved", doc);
+    }
+  }
+
+  namespace current
+  {
+    bool publishSensor(SentientMQTT &mqtt, const char *name, float value, const char *unit)
+    {
+      return mqtt.publishSensor(name, value, unit);
+    }
+
+    bool publishState(SentientMQTT &mqtt, const char *state) { return mqtt.publishState(state); }
+
+    bool publishEvent(SentientMQTT &mqtt, uint8_t position)
+    {
+      JsonDocument &doc = mqtt.scratchDocument();
+      doc["lever"] = position & 1 ? "down" : "up";
+      doc["position"] = position;
+      return mqtt.publishEvent("lever_moved", doc);
+    }
+  }
+
+  struct Cost
+  {
+    double ns;          // Per publish, best round
+    double allocations; // Heap calls per publish
+    double frees;
+    bool sent;          // Every publish went out
+  };
+
+  constexpr int kRounds = 10;
+  constexpr int kPublishes = 2000;
+
+  template <typename Publish>
+  Cost measure(Publish publish)
+  {
+    // Warm up: first calls may size buffers the steady state then reuses
+    bool sent = true;
+    for (int i = 0; i < 100; ++i)
+    {
+      sent = publish(i) && sent;
+    }
+
+    uint64_t best = ~0ull;
+    g_allocations = g_frees = 0;
+    for (int round = 0; round < kRounds; ++round)
+    {
+      g_counting = true;
+      const uint64_t start = hostNanos();
+      for (int i = 0; i < kPublishes; ++i)
+      {
+        sent = publish(i) && sent;
+      }
+      const uint64_t spent = hostNanos() - start;
+      g_counting = false;
+      best = std::min(best, spent);
+    }
+    const double publishes = (double)kRounds * kPublishes;
+    return {(double)best / kPublishes, g_allocations / publishes, g_frees / publishes, sent};
+  }
+
+  // The bytes one publish puts on the socket
+  template <typename Publish>
+  size_t wire(Publish publish, uint8_t *buffer, size_t capacity)
+  {
+    hostTcpCapture(buffer, capacity);
+    const bool sent = publish(1);
+    const size_t length = hostTcpCaptured();
+    hostTcpCapture(nullptr, 0);
+    return sent ? length : 0;
+  }
+
+  template <typename Legacy, typename Current>
+  void compare(SentientMQTT &mqtt, const char *name, Legacy legacyPublish, Current currentPublish)
+  {
+    static uint8_t before[1024], after[1024];
+    const size_t legacyBytes = wire(legacyPublish, before, sizeof(before));
+    const size_t currentBytes = wire(currentPublish, after, sizeof(after));
+    CHECK(legacyBytes > 0 && legacyBytes == currentBytes && memcmp(before, after, legacyBytes) == 0);
+
+    const Cost was = measure(legacyPublish);
+    const Cost now = measure(currentPublish);
+    CHECK(was.sent && now.sent);
+    CHECK(now.allocations == 0 && now.frees == 0);
+#if HOST_COUNTS_ALLOCATIONS
+    CHECK(was.allocations > 0);
+#endif
+    CHECK(mqtt.offlineQueueDepth() == 0);
+
+    printf("%-14s %5zu %10.1f %10.1f %8.2fx %14.1f %11.1f\n", name, currentBytes, was.ns, now.ns, was.ns / now.ns,
+           was.allocations, now.allocations);
+  }
+}
+
+int main()
+{
+  SentientMQTTConfig config;
+  config.brokerIp = IPAddress(192, 168, 20, 3);
+  config.namespaceId = "paragon";
+  config.roomId = "clockwork";
+  config.controllerId = "gauge_1_3_4";
+  config.deviceId = "gauge_1";
+  config.syncClock = false;
+  config.autoHeartbeat = false;
+
+  static SentientMQTT mqtt(config);
+  hostSetMicros(5'000'000);
+  CHECK(mqtt.begin());
+  for (int i = 0; i < 10 && !mqtt.isConnected(); ++i)
+  {
+    mqtt.loop();
+  }
+  CHECK(mqtt.isConnected());
+  if (!mqtt.isConnected())
+  {
+    return hostTestResult();
+  }
+
+  printf("%-14s %5s %10s %10s %9s %14s %11s\n", "publish", "bytes", "legacy ns", "now ns", "speedup",
+         "legacy allocs", "now allocs");
+  compare(
+      mqtt, "sensor", [&](int i) { return legacy::publishSensor(mqtt, "pressure", 21.5f + (i & 7), "psi"); },
+      [&](int i) { return current::publishSensor(mqtt, "pressure", 21.5f + (i & 7), "psi"); });
+  compare(
+      mqtt, "state", [&](int) { return legacy::publishState(mqtt, "running"); },
+      [&](int) { return current::publishState(mqtt, "running"); });
+  compare(
+      mqtt, "event", [&](int i) { return legacy::publishEvent(mqtt, (uint8_t)i); },
+      [&](int i) { return current::publishEvent(mqtt, (uint8_t)i); });
+#if !HOST_COUNTS_ALLOCATIONS
+  printf("(allocation counting needs glibc; counts above read zero)\n");
+#endif
+  return hostTestResult();
+}
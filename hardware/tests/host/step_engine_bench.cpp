@@ -0,0 +1,195 @@
+/*
+ * step_engine_bench.cpp
+ *
+ * Host cycles per tick and per step of SentientStepEngine, next to the
+ * per-loop float profile clock_v2 used before it (calculateStepInterval(),
+ * reproduced below). Cycles come from the TSC on x86 and are only good for
+ * comparing the two on one machine; on target, SENTIENT_PROFILE measures
+ * the ISR in Cortex-M7 cycles.
+ */
+
+#include "host_test.h"
+
+#include <SentientStepEngine.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static uint64_t cycles() { return __rdtsc(); }
+static const char *kUnit = "TSC cycles";
+#else
+static uint64_t cycles() { return hostNanos(); }
+static const char *kUnit = "ns";
+#endif
+
+namespace
+{
+  // clock_v2's profile before the step engine: the step interval was
+  // recomputed in float on every loop() from the steps left on three axes
+  namespace legacy
+  {
+    const unsigned long minStepInterval = 500;
+    const unsigned long maxStepInterval = 1000;
+    const unsigned long accelSteps = 500;
+
+    long minutePosition, hourPosition, gearPosition;
+    long minuteTarget, hourTarget, gearTarget;
+    long minuteStepsRemaining, hourStepsRemaining, gearStepsRemaining;
+
+    unsigned long calculateStepInterval()
+    {
+      long maxStepsRemaining = max(minuteStepsRemaining, max(hourStepsRemaining, gearStepsRemaining));
+      if (maxStepsRemaining == 0)
+      {
+        return maxStepInterval;
+      }
+      long totalSteps = max(labs(minuteTarget - minutePosition), max(labs(hourTarget - hourPosition), labs(gearTarget - gearPosition)));
+      if (totalSteps <= (long)accelSteps * 2)
+      {
+        float progress = (float)(totalSteps - maxStepsRemaining) / (float)totalSteps;
+        if (progress < 0.5)
+        {
+          return maxStepInterval - (unsigned long)((maxStepInterval - minStepInterval) * progress * 2);
+        }
+        return minStepInterval + (unsigned long)((maxStepInterval - minStepInterval) * (progress - 0.5) * 2);
+      }
+      long stepsTaken = totalSteps - maxStepsRemaining;
+      if (stepsTaken < (long)accelSteps)
+      {
+        float progress = (float)stepsTaken / (float)accelSteps;
+        return maxStepInterval - (unsigned long)((maxStepInterval - minStepInterval) * progress);
+      }
+      if (maxStepsRemaining < (long)accelSteps)
+      {
+        float progress = (float)(accelSteps - maxStepsRemaining) / (float)accelSteps;
+        return minStepInterval + (unsigned long)((maxStepInterval - minStepInterval) * progress);
+      }
+      return minStepInterval;
+    }
+  }
+
+  volatile unsigned long g_sink;
+
+  double legacyCyclesPerCall()
+  {
+    using namespace legacy;
+    const long moves[3] = {4520, 5240, -3200};
+    minuteTarget = moves[0];
+    hourTarget = moves[1];
+    gearTarget = moves[2];
+    const uint64_t start = cycles();
+    uint64_t calls = 0;
+    for (long step = 0; step <= 5240; ++step)
+    {
+      minutePosition = step * moves[0] / 5240;
+      hourPosition = step;
+      gearPosition = step * moves[2] / 5240;
+      minuteStepsRemaining = labs(minuteTarget - minutePosition);
+      hourStepsRemaining = labs(hourTarget - hourPosition);
+      gearStepsRemaining = labs(gearTarget - gearPosition);
+      g_sink = calculateStepInterval();
+      ++calls;
+    }
+    return (double)(cycles() - start) / calls;
+  }
+
+  struct EngineCost
+  {
+    double perTick;  // Averaged over the whole move
+    double perStep;  // Whole move over dominant steps, idle ticks included
+    double stepTick; // A tick that steps, timed tick by tick
+    double idleTick; // A tick that only advances the phase
+    uint64_t steps;
+  };
+
+  EngineCost engineCost(float maxRate, const long *moves)
+  {
+    static SentientStepEngine engine;
+    static bool added = false;
+    if (!added)
+    {
+      for (uint8_t i = 0; i < 3; ++i)
+      {
+        SentientStepperPins pins;
+        pins.stepPos = 2 + 2 * i;
+        pins.stepNeg = SENTIENT_NO_PIN;
+        pins.dirPos = 3 + 2 * i;
+        pins.dirNeg = SENTIENT_NO_PIN;
+        engine.addAxis(0, pins);
+      }
+      added = true;
+    }
+    SentientMotionConfig config;
+    config.startRate = 1000;
+    config.maxRate = maxRate;
+    config.acceleration = maxRate * 4;
+    engine.configure(0, config);
+    const long before = engine.position(1);
+    CHECK(engine.queueMove(0, moves));
+
+    uint64_t ticks = 0;
+    const uint64_t start = cycles();
+    while (engine.busy())
+    {
+      engine.tick();
+      ++ticks;
+    }
+    const uint64_t spent = cycles() - start;
+    const uint64_t steps = (uint64_t)labs(engine.position(1) - before);
+    CHECK(steps == (uint64_t)labs(moves[1]));
+
+    // The same move again, timing each tick on its own and subtracting the
+    // cost of reading the counter
+    uint64_t overhead = ~0ull;
+    for (int i = 0; i < 1000; ++i)
+    {
+      const uint64_t t0 = cycles();
+      overhead = std::min(overhead, cycles() - t0);
+    }
+    const long back[3] = {-moves[0], -moves[1], -moves[2]};
+    CHECK(engine.queueMove(0, back));
+    uint64_t stepCycles = 0, stepTicks = 0, idleCycles = 0, idleTicks = 0;
+    while (engine.busy())
+    {
+      const long position = engine.position(1);
+      const uint64_t t0 = cycles();
+      engine.tick();
+      const uint64_t t1 = cycles() - t0;
+      const uint64_t spentTick = t1 > overhead ? t1 - overhead : 0;
+      if (engine.position(1) != position)
+      {
+        stepCycles += spentTick;
+        ++stepTicks;
+      }
+      else
+      {
+        idleCycles += spentTick;
+        ++idleTicks;
+      }
+    }
+    return {(double)spent / ticks, (double)spent / steps, (double)stepCycles / stepTicks, (double)idleCycles / idleTicks,
+            steps};
+  }
+}
+
+int main()
+{
+  const long clockMove[3] = {4520, 5240, -3200};
+  const long fastMove[3] = {300000, 400000, -200000};
+
+  // Warm up caches and the branch predictor
+  legacyCyclesPerCall();
+  engineCost(2000, clockMove);
+
+  const double legacy = legacyCyclesPerCall();
+  const EngineCost clock = engineCost(2000, clockMove);
+  const EngineCost fast = engineCost(40000, fastMove);
+
+  printf("legacy calculateStepInterval(): %.1f %s per call (one per loop, at most 2000 steps/s)\n", legacy, kUnit);
+  for (const EngineCost *cost : {&clock, &fast})
+  {
+    printf("step engine, %s steps/s, 3 axes: %.1f %s per tick on average, %.1f per dominant step; "
+           "a stepping tick %.1f, an idle tick %.1f\n",
+           cost == &clock ? "2000" : "40000", cost->perTick, kUnit, cost->perStep, cost->stepTick, cost->idleTick);
+  }
+  return hostTestResult();
+}
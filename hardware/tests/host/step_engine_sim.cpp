@@ -0,0 +1,374 @@
+/*
+ * step_engine_sim.cpp
+ *
+ * SentientStepEngine driven tick by tick on the host. The STEP and DIR pins
+ * are sampled after every tick, so the simulation sees exactly what a driver
+ * would: it checks step counts, pulse shape, and that the step times follow
+ * the configured trapezoidal and S-curve profiles.
+ */
+
+#include "host_test.h"
+
+#include <SentientStepEngine.h>
+
+#include <vector>
+
+namespace
+{
+  constexpr uint8_t kStepPins[3] = {2, 4, 6};
+  constexpr uint8_t kDirPins[3] = {3, 5, 7};
+  constexpr uint8_t kLimitPin = 20;
+  constexpr double kTickS = SentientStepEngine::kTickUs * 1e-6;
+
+  struct Trace
+  {
+    std::vector<uint64_t> steps[3]; // Tick of every rising STEP edge, per axis
+    long net[3] = {0, 0, 0};        // Steps signed by the DIR level at the edge
+    uint64_t ticks = 0;
+    bool shapeOk = true; // Every pulse one tick high, at least one tick low
+
+    double seconds(uint8_t axis, size_t from, size_t to) const { return (steps[axis][to] - steps[axis][from]) * kTickS; }
+    double rateAround(uint8_t axis, size_t step, size_t span = 8) const
+    {
+      return span / seconds(axis, step - span / 2, step + span / 2);
+    }
+  };
+
+  struct Rig
+  {
+    SentientStepEngine engine;
+    Trace trace;
+    uint8_t last[3] = {LOW, LOW, LOW};
+
+    explicit Rig(const SentientMotionConfig &config, uint8_t axes = 1)
+    {
+      for (uint8_t i = 0; i < HOST_PIN_COUNT; ++i)
+      {
+        hostSetPinLevel(i, LOW);
+      }
+      for (uint8_t i = 0; i < axes; ++i)
+      {
+        SentientStepperPins pins;
+        pins.stepPos = kStepPins[i];
+        pins.stepNeg = SENTIENT_NO_PIN;
+        pins.dirPos = kDirPins[i];
+        pins.dirNeg = SENTIENT_NO_PIN;
+        engine.addAxis(0, pins);
+      }
+      engine.configure(0, config);
+    }
+
+    // One tick, recording edges; returns false once the group is idle
+    bool step()
+    {
+      engine.tick();
+      ++trace.ticks;
+      for (uint8_t i = 0; i < 3; ++i)
+      {
+        const uint8_t level = hostPinLevel(kStepPins[i]);
+        if (level == HIGH && last[i] == HIGH)
+        {
+          trace.shapeOk = false;
+        }
+        if (level == HIGH && last[i] == LOW)
+        {
+          const std::vector<uint64_t> &edges = trace.steps[i];
+          if (!edges.empty() && trace.ticks - edges.back() < 2)
+          {
+            trace.shapeOk = false;
+          }
+          trace.steps[i].push_back(trace.ticks);
+          trace.net[i] += hostPinLevel(kDirPins[i]) == HIGH ? 1 : -1;
+        }
+        last[i] = level;
+      }
+      return engine.busy(0);
+    }
+
+    void run(uint64_t maxTicks = 100'000'000)
+    {
+      while (step() && trace.ticks < maxTicks)
+      {
+      }
+    }
+  };
+
+  bool near(double value, double expected, double tolerance)
+  {
+    const bool ok = fabs(value - expected) <= tolerance;
+    if (!ok)
+    {
+      printf("  %.6f, expected %.6f +- %.6f\n", value, expected, tolerance);
+    }
+    return ok;
+  }
+
+  // The rate after i steps of acceleration, straight from the profile's
+  // definition: sqrt(v0^2 + 2ai) for the trapezoid, the smoothstep rate at
+  // the time step i is reached for the S-curve
+  std::vector<double> profileRates(const SentientMotionConfig &config, uint32_t steps)
+  {
+    const double v0 = config.startRate, v = config.maxRate, a = config.acceleration;
+    const double rampSeconds = 1.5 * (v - v0) / a;
+    std::vector<double> rates;
+    double elapsed = 0;
+    for (uint32_t i = 0; i < steps; ++i)
+    {
+      double rate;
+      if (config.profile == SentientMotionProfile::Trapezoidal)
+      {
+        rate = sqrt(v0 * v0 + 2 * a * i);
+      }
+      else
+      {
+        const double tau = elapsed / rampSeconds;
+        rate = tau >= 1 ? v : v0 + (v - v0) * tau * tau * (3 - 2 * tau);
+      }
+      rate = rate < v ? rate : v;
+      rates.push_back(rate);
+      elapsed += 1 / rate;
+    }
+    return rates;
+  }
+
+  // Expected step times (seconds after the first step) of one move from rest
+  // to rest, following the engine's documented rules: after every step the
+  // ramp index moves one towards min(cruise, steps left), and the rate is
+  // read from a table sampled every 2^rampShift steps
+  std::vector<double> modelStepTimes(const SentientStepEngine &engine, const SentientMotionConfig &config, uint32_t steps)
+  {
+    const uint8_t shift = engine.rampShift(0);
+    const uint32_t cruise = (uint32_t)(engine.rampEntries(0) - 1) << shift;
+    const std::vector<double> rates = profileRates(config, cruise + 1);
+    std::vector<double> times(1, 0.0);
+    uint32_t index = 0;
+    for (uint32_t step = 1; step < steps; ++step)
+    {
+      const uint32_t limit = std::min(cruise, steps - step);
+      index += index < limit ? 1 : (index > limit ? -1 : 0);
+      const double rate = index >= cruise ? config.maxRate : rates[(index >> shift) << shift];
+      times.push_back(times.back() + 1 / rate);
+    }
+    return times;
+  }
+
+  // Every step lands where the model puts it: the phase accumulator carries
+  // its remainder, so the tick grid costs at most a tick and never adds up
+  bool followsModel(const Trace &trace, const std::vector<double> &model)
+  {
+    double worst = 0;
+    for (size_t i = 0; i < model.size(); ++i)
+    {
+      const double error = fabs(trace.seconds(0, 0, i) - model[i]);
+      const double allowed = 2 * kTickS + model[i] * 1e-4;
+      worst = std::max(worst, error - allowed);
+    }
+    if (worst > 0)
+    {
+      printf("  step times off the model by up to %.1f us beyond the allowance\n", worst * 1e6);
+    }
+    return worst <= 0;
+  }
+
+  // A long trapezoidal move: exact counts, step times on the profile, and the
+  // continuous-time duration
+  void trapezoidalMove()
+  {
+    SentientMotionConfig config;
+    config.startRate = 1000;
+    config.maxRate = 8000;
+    config.acceleration = 20000;
+    Rig rig(config);
+    const long steps[] = {20000};
+    CHECK(rig.engine.queueMove(0, steps));
+    rig.run();
+
+    const Trace &t = rig.trace;
+    CHECK(t.shapeOk);
+    CHECK(t.steps[0].size() == 20000);
+    CHECK(t.net[0] == 20000);
+    CHECK(rig.engine.position(0) == 20000);
+    CHECK(followsModel(t, modelStepTimes(rig.engine, config, 20000)));
+
+    // Against the continuous profile the table's sampling (every 8 steps
+    // here) only costs a few steps' time
+    const double v0 = config.startRate, v = config.maxRate, a = config.acceleration;
+    const double rampSteps = (v * v - v0 * v0) / (2 * a);
+    const double expected = 2 * (v - v0) / a + (20000 - 1 - 2 * rampSteps) / v;
+    CHECK(near(t.seconds(0, 0, 19999), expected, expected * 0.005));
+    CHECK(near(t.seconds(0, 19999 - 1000, 19999), t.seconds(0, 0, 1000), 4 * kTickS));
+    CHECK(near(t.rateAround(0, 10000), v, v * 0.01));
+    CHECK(near(1.0 / t.seconds(0, 0, 1), v0, v0 * 0.02));
+    CHECK(near(1.0 / t.seconds(0, 19998, 19999), v0, v0 * 0.02));
+  }
+
+  // Too short to reach cruise: the profile is a triangle peaking where the
+  // ramp up meets the ramp down
+  void triangularMove()
+  {
+    SentientMotionConfig config;
+    config.startRate = 500;
+    config.maxRate = 10000;
+    config.acceleration = 10000;
+    Rig rig(config);
+    const long steps[] = {-2000};
+    CHECK(rig.engine.queueMove(0, steps));
+    rig.run();
+
+    const Trace &t = rig.trace;
+    CHECK(t.shapeOk);
+    CHECK(t.steps[0].size() == 2000);
+    CHECK(t.net[0] == -2000);
+    CHECK(rig.engine.position(0) == -2000);
+    CHECK(followsModel(t, modelStepTimes(rig.engine, config, 2000)));
+
+    const double v0 = config.startRate, a = config.acceleration;
+    const double peak = sqrt(v0 * v0 + a * 2000);
+    CHECK(near(t.rateAround(0, 1000), peak, peak * 0.02));
+  }
+
+  // The S-curve takes 1.5x as long to reach cruise and covers the average
+  // of the start and cruise rates over that time
+  void sCurveMove()
+  {
+    SentientMotionConfig config;
+    config.startRate = 1000;
+    config.maxRate = 2000;
+    config.acceleration = 3000;
+    config.profile = SentientMotionProfile::SCurve;
+    Rig rig(config);
+    const long steps[] = {5240};
+    CHECK(rig.engine.queueMove(0, steps));
+    rig.run();
+
+    const Trace &t = rig.trace;
+    CHECK(t.shapeOk);
+    CHECK(t.steps[0].size() == 5240);
+    CHECK(followsModel(t, modelStepTimes(rig.engine, config, 5240)));
+
+    const double v0 = config.startRate, v = config.maxRate;
+    const double rampSeconds = 1.5 * (v - v0) / config.acceleration;
+    const double rampSteps = (v0 + v) / 2 * rampSeconds;
+    CHECK(near(rig.engine.rampSteps(0), rampSteps, 2));
+    const double expected = 2 * rampSeconds + (5240 - 1 - 2 * rampSteps) / v;
+    CHECK(near(t.seconds(0, 0, 5239), expected, expected * 0.005));
+    // Halfway through the ramp the rate is halfway between start and cruise;
+    // by then the smoothstep has covered 3/32 of (v - v0) * rampSeconds
+    const size_t middle = (size_t)(v0 * rampSeconds / 2 + (v - v0) * rampSeconds * 3 / 32);
+    CHECK(near(t.rateAround(0, middle), (v0 + v) / 2, (v0 + v) / 2 * 0.02));
+    // Acceleration eases in: the first steps come at the start rate
+    CHECK(near(t.seconds(0, 0, 10), 10 / v0, 10 / v0 * 0.01));
+    CHECK(near(t.rateAround(0, 2620), v, v * 0.01));
+  }
+
+  // Three axes interpolated in one segment, with the clock's hand moves
+  void interpolatedMove()
+  {
+    SentientMotionConfig config;
+    config.profile = SentientMotionProfile::SCurve;
+    Rig rig(config, 3);
+    const long steps[] = {4520, 5240, -3200};
+    CHECK(rig.engine.queueMove(0, steps));
+    rig.run();
+
+    const Trace &t = rig.trace;
+    CHECK(t.shapeOk);
+    for (uint8_t i = 0; i < 3; ++i)
+    {
+      CHECK(t.net[i] == steps[i]);
+      CHECK(rig.engine.position(i) == steps[i]);
+    }
+    // Followers are spread over the whole segment and finish with the
+    // dominant axis, never after it
+    const uint64_t end = t.steps[1].back();
+    CHECK(t.steps[0].back() <= end && t.steps[2].back() <= end);
+    CHECK(end - t.steps[0].back() < 2 * 5240 / 4520 * (uint64_t)(1 / (config.startRate * kTickS)));
+    CHECK(end - t.steps[2].back() < 2 * 5240 / 3200 * (uint64_t)(1 / (config.startRate * kTickS)));
+    CHECK(t.steps[2].front() - t.steps[1].front() < 2 * (uint64_t)(1 / (config.startRate * kTickS)));
+  }
+
+  // Queued segments: straight on keeps the cruise rate through the
+  // junction, a reversal stops there
+  void junctions()
+  {
+    SentientMotionConfig config;
+    config.startRate = 1000;
+    config.maxRate = 4000;
+    config.acceleration = 20000;
+
+    Rig straight(config);
+    const long forward[] = {2000};
+    CHECK(straight.engine.queueMove(0, forward));
+    CHECK(straight.engine.queueMove(0, forward));
+    straight.run();
+    CHECK(straight.trace.steps[0].size() == 4000);
+    CHECK(near(straight.trace.rateAround(0, 2000), config.maxRate, config.maxRate * 0.01));
+
+    Rig reverse(config);
+    const long back[] = {-2000};
+    CHECK(reverse.engine.queueMove(0, forward));
+    CHECK(reverse.engine.queueMove(0, back));
+    reverse.run();
+    CHECK(reverse.trace.steps[0].size() == 4000);
+    CHECK(reverse.trace.net[0] == 0);
+    CHECK(reverse.engine.position(0) == 0);
+    CHECK(reverse.trace.rateAround(0, 2000, 2) < config.startRate * 1.05);
+  }
+
+  // stop() mid-cruise sheds the ramp and no more; a limit halts on the spot
+  void stopAndLimit()
+  {
+    SentientMotionConfig config;
+    config.startRate = 1000;
+    config.maxRate = 6000;
+    config.acceleration = 30000;
+    const uint32_t rampSteps = (uint32_t)((config.maxRate * config.maxRate - config.startRate * config.startRate) /
+                                          (2 * config.acceleration));
+
+    Rig stopped(config);
+    const long far[] = {100000};
+    CHECK(stopped.engine.queueMove(0, far));
+    while (stopped.trace.steps[0].size() < 5000)
+    {
+      stopped.step();
+    }
+    stopped.engine.stop(0);
+    stopped.run();
+    const long shed = (long)stopped.trace.steps[0].size() - 5000;
+    CHECK(near(shed, rampSteps, rampSteps * 0.01 + 2));
+    CHECK(stopped.engine.position(0) == (long)stopped.trace.steps[0].size());
+    CHECK(!stopped.engine.limitTripped(0));
+
+    Rig limited(config);
+    CHECK(limited.engine.addLimitInput(0, +1, kLimitPin, HIGH));
+    CHECK(limited.engine.queueMove(0, far));
+    while (limited.trace.steps[0].size() < 3000)
+    {
+      limited.step();
+    }
+    hostSetPinLevel(kLimitPin, HIGH);
+    limited.run();
+    CHECK(limited.trace.steps[0].size() == 3000);
+    CHECK(limited.engine.position(0) == 3000);
+    CHECK(limited.engine.limitTripped(0));
+    CHECK(limited.engine.limitActive(0, +1) && !limited.engine.limitActive(0, -1));
+
+    // Moving away from the tripped limit is allowed
+    const long away[] = {-500};
+    CHECK(limited.engine.queueMove(0, away));
+    limited.run();
+    CHECK(limited.engine.position(0) == 2500);
+    hostSetPinLevel(kLimitPin, LOW);
+  }
+}
+
+int main()
+{
+  trapezoidalMove();
+  triangularMove();
+  sCurveMove();
+  interpolatedMove();
+  junctions();
+  stopAndLimit();
+  return hostTestResult();
+}
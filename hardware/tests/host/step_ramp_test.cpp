@@ -0,0 +1,102 @@
+/*
+ * step_ramp_test.cpp
+ *
+ * The fixed-point ramp tables SentientStepEngine::configure() builds,
+ * checked entry by entry against the same profiles evaluated in double
+ * precision: sqrt(v0^2 + 2an) for trapezoids, the smoothstep rate at the
+ * elapsed ramp time for S-curves.
+ */
+
+#include "host_test.h"
+
+#include <SentientStepEngine.h>
+
+namespace
+{
+  constexpr double kTolerance = 1e-4; // 0.01%
+
+  // The S-curve reference steps through time in double precision: each step
+  // takes 1 / rate, and the rate follows v0 + (v - v0) * smoothstep(t / T)
+  // with T = 1.5 (v - v0) / a
+  double sCurveRate(const SentientMotionConfig &config, uint32_t step, double &elapsed, uint32_t &at, double &rate)
+  {
+    const double v0 = config.startRate, v = config.maxRate;
+    const double rampSeconds = 1.5 * (v - v0) / config.acceleration;
+    for (; at < step; ++at)
+    {
+      elapsed += 1 / rate;
+      const double tau = elapsed / rampSeconds;
+      rate = tau >= 1 ? v : v0 + (v - v0) * tau * tau * (3 - 2 * tau);
+    }
+    return rate;
+  }
+
+  void checkRamp(float startRate, float maxRate, float acceleration, SentientMotionProfile profile)
+  {
+    SentientMotionConfig config;
+    config.startRate = startRate;
+    config.maxRate = maxRate;
+    config.acceleration = acceleration;
+    config.profile = profile;
+    static SentientStepEngine engine;
+    CHECK(engine.configure(0, config));
+
+    const uint32_t rampSteps = engine.rampSteps(0);
+    const uint8_t shift = engine.rampShift(0);
+    const double v0 = startRate, v = maxRate, a = acceleration;
+    if (profile == SentientMotionProfile::Trapezoidal)
+    {
+      const double expected = (v * v - v0 * v0) / (2 * a);
+      // The rate is within kTolerance, so the step it reaches cruise is too
+      CHECK(fabs(rampSteps - expected) <= 1 + kTolerance * v * v / a);
+    }
+    else
+    {
+      const double expected = (v0 + v) / 2 * 1.5 * (v - v0) / a;
+      CHECK(fabs(rampSteps - expected) <= 2 + expected * kTolerance);
+    }
+
+    double worst = 0;
+    double previous = 0;
+    bool monotonic = true;
+    double elapsed = 0, rate = v0;
+    uint32_t at = 0;
+    for (uint32_t step = 0; step < rampSteps; step += 1u << shift)
+    {
+      const double reference = profile == SentientMotionProfile::Trapezoidal
+                                   ? std::min(v, sqrt(v0 * v0 + 2 * a * step))
+                                   : sCurveRate(config, step, elapsed, at, rate);
+      const double actual = engine.rateAt(0, step);
+      worst = std::max(worst, fabs(actual - reference) / reference);
+      monotonic = monotonic && actual >= previous;
+      previous = actual;
+    }
+    const double cruise = engine.rateAt(0, (uint32_t)(engine.rampEntries(0) - 1) << shift);
+
+    printf("%s %g -> %g steps/s at %g steps/s^2: %u steps, %u entries, worst error %.5f%%\n",
+           profile == SentientMotionProfile::Trapezoidal ? "trapezoid" : "s-curve  ", v0, v, a,
+           (unsigned)rampSteps, (unsigned)engine.rampEntries(0), worst * 100);
+    CHECK(worst <= kTolerance);
+    CHECK(monotonic);
+    CHECK(fabs(cruise - v) <= v * kTolerance);
+    CHECK(engine.rateToIndex(0, maxRate) == (uint32_t)(engine.rampEntries(0) - 1) << shift);
+    CHECK(engine.rateToIndex(0, startRate) < (1u << shift) * 2);
+  }
+}
+
+int main()
+{
+  const SentientMotionProfile trapezoid = SentientMotionProfile::Trapezoidal;
+  const SentientMotionProfile sCurve = SentientMotionProfile::SCurve;
+
+  checkRamp(1000, 2000, 3000, trapezoid); // clock_v2's hands
+  checkRamp(100, 40000, 200000, trapezoid);
+  checkRamp(1, 5000, 10000, trapezoid); // From (almost) rest: the exact square-root steps
+  checkRamp(1000, 48000, 50000, trapezoid); // Sampled: more steps than table entries
+
+  checkRamp(1000, 2000, 3000, sCurve);
+  checkRamp(100, 40000, 200000, sCurve);
+  checkRamp(200, 5000, 10000, sCurve);
+
+  return hostTestResult();
+}
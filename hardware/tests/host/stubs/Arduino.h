@@ -0,0 +1,344 @@
+/*
+ * Arduino.h (host stub)
+ *
+ * Just enough of the Teensy core for the Sentient libraries to build and
+ * run on a PC: Print/Stream, String, IPAddress, Serial, pins and time.
+ * Time does not move on its own; tests advance it with hostAdvanceMicros()
+ * so every run is deterministic. Pin levels live in an array tests can
+ * inspect.
+ */
+
+#ifndef SENTIENT_HOST_ARDUINO_H
+#define SENTIENT_HOST_ARDUINO_H
+
+#include <ctype.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define INPUT_PULLDOWN 3
+#define CHANGE 4
+#define FALLING 2
+#define RISING 3
+
+#define DEC 10
+#define HEX 16
+#define BIN 2
+
+class __FlashStringHelper;
+#define F(string) (reinterpret_cast<const __FlashStringHelper *>(string))
+#define PROGMEM
+
+using std::max;
+using std::min;
+
+// ---- Host controls ---------------------------------------------------------
+
+#define HOST_PIN_COUNT 64
+
+void hostSetMicros(uint64_t us);
+void hostAdvanceMicros(uint64_t us);
+uint64_t hostMicros();
+uint8_t hostPinLevel(uint8_t pin);
+void hostSetPinLevel(uint8_t pin, uint8_t level);
+uint32_t hostPinWrites(uint8_t pin); // digitalWrite calls since start
+extern bool hostSerialEcho;          // Copy Serial output to stdout
+
+// ---- Time, pins, interrupts ------------------------------------------------
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+uint8_t digitalRead(uint8_t pin);
+inline int digitalPinToInterrupt(uint8_t pin) { return pin; }
+void attachInterrupt(uint8_t pin, void (*handler)(), int mode);
+void detachInterrupt(uint8_t pin);
+
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+long random(long howBig);
+long random(long howSmall, long howBig);
+void randomSeed(unsigned long seed);
+
+// ---- Print / Stream --------------------------------------------------------
+
+class Print;
+
+class Printable
+{
+public:
+  virtual ~Printable() {}
+  virtual size_t printTo(Print &p) const = 0;
+};
+
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t b) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size)
+  {
+    size_t n = 0;
+    while (size--)
+    {
+      n += write(*buffer++);
+    }
+    return n;
+  }
+  size_t write(const char *s) { return s ? write((const uint8_t *)s, strlen(s)) : 0; }
+  size_t write(const char *buffer, size_t size) { return write((const uint8_t *)buffer, size); }
+  virtual int availableForWrite() { return 0; }
+  virtual void flush() {}
+
+  size_t print(const char *s) { return write(s); }
+  size_t print(const __FlashStringHelper *s) { return write(reinterpret_cast<const char *>(s)); }
+  size_t print(const class String &s);
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(const Printable &p) { return p.printTo(*this); }
+  size_t print(unsigned char n, int base = DEC) { return printNumber(n, base); }
+  size_t print(int n, int base = DEC) { return printSigned(n, base); }
+  size_t print(unsigned int n, int base = DEC) { return printNumber(n, base); }
+  size_t print(long n, int base = DEC) { return printSigned(n, base); }
+  size_t print(unsigned long n, int base = DEC) { return printNumber(n, base); }
+  size_t print(long long n, int base = DEC) { return printSigned(n, base); }
+  size_t print(unsigned long long n, int base = DEC) { return printNumber(n, base); }
+  size_t print(double n, int digits = 2)
+  {
+    char text[40];
+    snprintf(text, sizeof(text), "%.*f", digits, n);
+    return write(text);
+  }
+
+  size_t println() { return write("\r\n"); }
+  template <typename T>
+  size_t println(const T &value)
+  {
+    size_t n = print(value);
+    return n + println();
+  }
+  template <typename T>
+  size_t println(const T &value, int format)
+  {
+    size_t n = print(value, format);
+    return n + println();
+  }
+
+  int getWriteError() { return _writeError; }
+  void clearWriteError() { _writeError = 0; }
+
+protected:
+  void setWriteError(int error = 1) { _writeError = error; }
+
+private:
+  size_t printSigned(long long n, int base)
+  {
+    if (n < 0 && base == DEC)
+    {
+      return print('-') + printNumber((unsigned long long)-n, base);
+    }
+    return printNumber((unsigned long long)n, base);
+  }
+  size_t printNumber(unsigned long long n, int base)
+  {
+    char text[72];
+    char *p = text + sizeof(text);
+    *--p = '\0';
+    do
+    {
+      const uint8_t digit = n % base;
+      *--p = digit < 10 ? '0' + digit : 'A' + digit - 10;
+      n /= base;
+    } while (n);
+    return write(p);
+  }
+
+  int _writeError = 0;
+};
+
+class Stream : public Print
+{
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+};
+
+class HostSerial : public Stream
+{
+public:
+  void begin(uint32_t) {}
+  explicit operator bool() const { return true; }
+  size_t write(uint8_t b) override
+  {
+    if (hostSerialEcho)
+    {
+      putchar(b);
+    }
+    return 1;
+  }
+  using Print::write;
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+};
+
+extern HostSerial Serial;
+
+// ---- String --------------------------------------------------------------
+
+// Heap backed like the Teensy core's WString: every growth is a realloc()
+// sized to fit, so code built on it allocates as it does on target
+class String
+{
+public:
+  String(const char *text = "") { *this = text; }
+  String(const String &other) { *this = other.c_str(); }
+  String(unsigned long value, unsigned char base = DEC)
+  {
+    char text[72];
+    char *p = text + sizeof(text);
+    *--p = '\0';
+    do
+    {
+      const uint8_t digit = value % base;
+      *--p = digit < 10 ? '0' + digit : 'A' + digit - 10;
+      value /= base;
+    } while (value);
+    *this = p;
+  }
+  ~String() { free(_buffer); }
+
+  String &operator=(const String &other) { return this == &other ? *this : (*this = other.c_str()); }
+  String &operator=(const char *text)
+  {
+    if (!text)
+    {
+      // What ArduinoJson assigns before serializing into a String
+      free(_buffer);
+      _buffer = nullptr;
+      _capacity = _length = 0;
+      return *this;
+    }
+    _length = 0;
+    concat(text);
+    return *this;
+  }
+
+  bool reserve(size_t size)
+  {
+    if (_buffer && _capacity >= size)
+    {
+      return true;
+    }
+    char *buffer = static_cast<char *>(realloc(_buffer, size + 1));
+    if (!buffer)
+    {
+      return false;
+    }
+    if (!_buffer)
+    {
+      buffer[0] = '\0';
+    }
+    _buffer = buffer;
+    _capacity = size;
+    return true;
+  }
+
+  bool concat(const char *text) { return text && concat(text, strlen(text)); }
+  bool concat(const char *text, size_t length)
+  {
+    if (!reserve(_length + length))
+    {
+      return false;
+    }
+    memcpy(_buffer + _length, text, length);
+    _length += length;
+    _buffer[_length] = '\0';
+    return true;
+  }
+  bool concat(char c) { return concat(&c, 1); }
+  String &operator+=(const char *text) { concat(text); return *this; }
+  String &operator+=(const String &other) { concat(other.c_str(), other.length()); return *this; }
+  String &operator+=(char c) { concat(c); return *this; }
+
+  size_t length() const { return _length; }
+  const char *c_str() const { return _buffer ? _buffer : ""; }
+  char operator[](size_t index) const { return index < _length ? _buffer[index] : '\0'; }
+  bool operator==(const char *text) const { return strcmp(c_str(), text ? text : "") == 0; }
+
+private:
+  char *_buffer = nullptr;
+  size_t _capacity = 0;
+  size_t _length = 0;
+};
+
+inline size_t Print::print(const String &s) { return write(s.c_str(), s.length()); }
+
+// ---- IPAddress -------------------------------------------------------------
+
+class IPAddress : public Printable
+{
+public:
+  IPAddress() {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _bytes{a, b, c, d} {}
+  IPAddress(uint32_t address) { memcpy(_bytes, &address, 4); }
+  IPAddress(const uint8_t *address) { memcpy(_bytes, address, 4); }
+
+  operator uint32_t() const
+  {
+    uint32_t address;
+    memcpy(&address, _bytes, 4);
+    return address;
+  }
+  bool operator==(const IPAddress &other) const { return memcmp(_bytes, other._bytes, 4) == 0; }
+  bool operator!=(const IPAddress &other) const { return !(*this == other); }
+  uint8_t operator[](int index) const { return _bytes[index]; }
+  uint8_t &operator[](int index) { return _bytes[index]; }
+
+  bool fromString(const char *text)
+  {
+    unsigned a, b, c, d;
+    if (!text || sscanf(text, "%u.%u.%u.%u", &a, &b, &c, &d) != 4 || a > 255 || b > 255 || c > 255 || d > 255)
+    {
+      return false;
+    }
+    *this = IPAddress(a, b, c, d);
+    return true;
+  }
+
+  size_t printTo(Print &p) const override
+  {
+    size_t n = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+      n += p.print(_bytes[i], DEC);
+      if (i < 3)
+      {
+        n += p.print('.');
+      }
+    }
+    return n;
+  }
+
+  uint8_t *raw_address() { return _bytes; }
+
+private:
+  uint8_t _bytes[4] = {0, 0, 0, 0};
+};
+
+#endif // SENTIENT_HOST_ARDUINO_H
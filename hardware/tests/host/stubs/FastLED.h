@@ -0,0 +1,32 @@
+/*
+ * FastLED.h (host stub)
+ *
+ * CRGB only, laid out as FastLED lays it out (r, g, b; raw[] aliases them).
+ */
+
+#ifndef SENTIENT_HOST_FASTLED_H
+#define SENTIENT_HOST_FASTLED_H
+
+#include <Arduino.h>
+
+struct CRGB
+{
+  union
+  {
+    struct
+    {
+      uint8_t r;
+      uint8_t g;
+      uint8_t b;
+    };
+    uint8_t raw[3];
+  };
+
+  CRGB() : r(0), g(0), b(0) {}
+  CRGB(uint8_t red, uint8_t green, uint8_t blue) : r(red), g(green), b(blue) {}
+
+  bool operator==(const CRGB &other) const { return r == other.r && g == other.g && b == other.b; }
+  bool operator!=(const CRGB &other) const { return !(*this == other); }
+};
+
+#endif // SENTIENT_HOST_FASTLED_H
@@ -0,0 +1,23 @@
+/*
+ * NativeDns.h (host stub)
+ *
+ * DNSClient that only resolves dotted-quad names; host tests configure the
+ * broker by address.
+ */
+
+#ifndef SENTIENT_HOST_NATIVE_DNS_H
+#define SENTIENT_HOST_NATIVE_DNS_H
+
+#include <Arduino.h>
+
+class DNSClient
+{
+public:
+  void begin(const IPAddress &server) {}
+  int getHostByName(const char *host, IPAddress &result, uint16_t timeout = 5000)
+  {
+    return result.fromString(host) ? 1 : 0;
+  }
+};
+
+#endif // SENTIENT_HOST_NATIVE_DNS_H
@@ -0,0 +1,37 @@
+/*
+ * NativeEthernet.h (host stub)
+ *
+ * An Ethernet object whose link is always up with fixed addresses.
+ */
+
+#ifndef SENTIENT_HOST_NATIVE_ETHERNET_H
+#define SENTIENT_HOST_NATIVE_ETHERNET_H
+
+#include <Arduino.h>
+#include <Client.h>
+
+class EthernetClass
+{
+public:
+  int begin(const uint8_t *mac, unsigned long timeout = 60000, unsigned long responseTimeout = 4000)
+  {
+    _localIP = IPAddress(192, 168, 20, 50);
+    return 1;
+  }
+  void begin(const uint8_t *mac, IPAddress ip, IPAddress dns, IPAddress gateway, IPAddress subnet)
+  {
+    _localIP = ip;
+    _dnsServerIP = dns;
+  }
+  int maintain() { return 0; }
+  IPAddress localIP() const { return _localIP; }
+  IPAddress dnsServerIP() const { return _dnsServerIP; }
+
+private:
+  IPAddress _localIP;
+  IPAddress _dnsServerIP = IPAddress(192, 168, 20, 1);
+};
+
+extern EthernetClass Ethernet;
+
+#endif // SENTIENT_HOST_NATIVE_ETHERNET_H
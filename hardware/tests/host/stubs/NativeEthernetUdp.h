@@ -0,0 +1,54 @@
+/*
+ * NativeEthernetUdp.h (host stub)
+ *
+ * EthernetUDP over in-memory queues. Tests hand datagrams to a port with
+ * hostUdpDeliver(); a socket bound to that port returns them from
+ * parsePacket()/read() in order. Sent datagrams are counted and the last
+ * one is kept for inspection.
+ */
+
+#ifndef SENTIENT_HOST_NATIVE_ETHERNET_UDP_H
+#define SENTIENT_HOST_NATIVE_ETHERNET_UDP_H
+
+#include <Arduino.h>
+
+#include <deque>
+#include <vector>
+
+void hostUdpDeliver(uint16_t port, const uint8_t *data, size_t length);
+size_t hostUdpPending(uint16_t port);
+uint32_t hostUdpSent();
+const std::vector<uint8_t> &hostUdpLastSent();
+
+class EthernetUDP : public Stream
+{
+public:
+  uint8_t begin(uint16_t port);
+  void stop() { _port = 0; }
+
+  int beginPacket(IPAddress ip, uint16_t port);
+  int beginPacket(const char *host, uint16_t port) { return host ? beginPacket(IPAddress(), port) : 0; }
+  int endPacket();
+  size_t write(uint8_t b) override;
+  size_t write(const uint8_t *buffer, size_t size) override;
+  using Print::write;
+
+  int parsePacket();
+  int available() override { return (int)(_packet.size() - _read); }
+  int read() override;
+  int read(uint8_t *buffer, size_t length);
+  int read(char *buffer, size_t length) { return read((uint8_t *)buffer, length); }
+  int peek() override { return available() ? _packet[_read] : -1; }
+  void flush() override {}
+
+  IPAddress remoteIP() { return IPAddress(127, 0, 0, 1); }
+  uint16_t remotePort() { return _port; }
+
+private:
+  uint16_t _port = 0;
+  std::vector<uint8_t> _packet;
+  size_t _read = 0;
+  std::vector<uint8_t> _outgoing;
+};
+
+#endif // SENTIENT_HOST_NATIVE_ETHERNET_UDP_H
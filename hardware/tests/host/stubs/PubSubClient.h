@@ -0,0 +1,155 @@
+/*
+ * PubSubClient.h (host stub)
+ *
+ * The part of knolleary's PubSubClient SentientMQTT uses, writing the same
+ * MQTT 3.1.1 bytes to its Client: connect() sends CONNECT and reads the
+ * CONNACK, publish() and beginPublish()/write()/endPublish() send QoS 0
+ * PUBLISH packets. Incoming PUBLISH packets are not parsed; loop() just
+ * drains the socket.
+ */
+
+#ifndef SENTIENT_HOST_PUB_SUB_CLIENT_H
+#define SENTIENT_HOST_PUB_SUB_CLIENT_H
+
+#include <Arduino.h>
+#include <Client.h>
+
+#define MQTTCONNECT 1 << 4
+#define MQTTCONNACK 2 << 4
+#define MQTTPUBLISH 3 << 4
+#define MQTTSUBSCRIBE 8 << 4
+
+#define MQTT_CONNECTION_LOST -3
+#define MQTT_CONNECT_FAILED -2
+#define MQTT_DISCONNECTED -1
+#define MQTT_CONNECTED 0
+
+#define MQTT_MAX_HEADER_SIZE 5
+
+#define MQTT_CALLBACK_SIGNATURE void (*callback)(char *, uint8_t *, unsigned int)
+
+class PubSubClient : public Print
+{
+public:
+  explicit PubSubClient(Client &client) : _client(&client) {}
+
+  PubSubClient &setServer(IPAddress ip, uint16_t port) { _ip = ip; _port = port; return *this; }
+  PubSubClient &setServer(const char *domain, uint16_t port) { _port = port; return *this; }
+  PubSubClient &setCallback(MQTT_CALLBACK_SIGNATURE) { return *this; }
+  PubSubClient &setKeepAlive(uint16_t keepAlive) { return *this; }
+  bool setBufferSize(uint16_t size)
+  {
+    _bufferSize = size;
+    return size > 0;
+  }
+  uint16_t getBufferSize() { return _bufferSize; }
+
+  bool connect(const char *id) { return connect(id, nullptr, nullptr); }
+  bool connect(const char *id, const char *user, const char *pass)
+  {
+    if (connected())
+    {
+      return true;
+    }
+    if (!_client->connected() && !_client->connect(_ip, _port))
+    {
+      _state = MQTT_CONNECT_FAILED;
+      return false;
+    }
+    const uint8_t body[] = {0x00, 0x04, 'M', 'Q', 'T', 'T', 0x04, 0x02, 0x00, 0x3C};
+    const uint16_t idLength = id ? strlen(id) : 0;
+    const uint8_t header[] = {MQTTCONNECT, (uint8_t)(sizeof(body) + 2 + idLength), (uint8_t)(idLength >> 8),
+                              (uint8_t)idLength};
+    _client->write(header, 2);
+    _client->write(body, sizeof(body));
+    _client->write(header + 2, 2);
+    _client->write((const uint8_t *)id, idLength);
+
+    uint8_t connack[4];
+    if (_client->available() < 4 || _client->read(connack, 4) != 4 || connack[0] != (MQTTCONNACK) ||
+        connack[3] != 0)
+    {
+      _state = MQTT_CONNECT_FAILED;
+      return false;
+    }
+    _state = MQTT_CONNECTED;
+    return true;
+  }
+
+  bool connected()
+  {
+    if (_state == MQTT_CONNECTED && !_client->connected())
+    {
+      _state = MQTT_CONNECTION_LOST;
+    }
+    return _state == MQTT_CONNECTED;
+  }
+
+  bool loop()
+  {
+    while (connected() && _client->available() > 0)
+    {
+      _client->read();
+    }
+    return connected();
+  }
+
+  bool subscribe(const char *topic)
+  {
+    const uint16_t length = strlen(topic);
+    const uint8_t header[] = {MQTTSUBSCRIBE | 0x02, (uint8_t)(2 + 2 + length + 1), 0, 1, (uint8_t)(length >> 8),
+                              (uint8_t)length};
+    const uint8_t qos = 0;
+    return connected() && _client->write(header, sizeof(header)) == sizeof(header) &&
+           _client->write((const uint8_t *)topic, length) == length && _client->write(&qos, 1) == 1;
+  }
+
+  bool publish(const char *topic, const char *payload, bool retained = false)
+  {
+    const size_t length = payload ? strlen(payload) : 0;
+    if (!connected() || _bufferSize < MQTT_MAX_HEADER_SIZE + 2 + strlen(topic) + length)
+    {
+      return false;
+    }
+    return beginPublish(topic, length, retained) && write((const uint8_t *)payload, length) == length &&
+           endPublish() == 1;
+  }
+
+  bool beginPublish(const char *topic, unsigned int length, bool retained)
+  {
+    if (!connected())
+    {
+      return false;
+    }
+    const uint16_t topicLength = strlen(topic);
+    uint8_t header[MQTT_MAX_HEADER_SIZE + 2];
+    size_t used = 0;
+    header[used++] = MQTTPUBLISH | (retained ? 1 : 0);
+    size_t remaining = 2 + topicLength + length;
+    do
+    {
+      uint8_t digit = remaining % 128;
+      remaining /= 128;
+      header[used++] = remaining ? digit | 0x80 : digit;
+    } while (remaining);
+    header[used++] = topicLength >> 8;
+    header[used++] = (uint8_t)topicLength;
+    return _client->write(header, used) == used && _client->write((const uint8_t *)topic, topicLength) == topicLength;
+  }
+  int endPublish() { return connected() ? 1 : 0; }
+
+  size_t write(uint8_t b) override { return _client->write(b); }
+  size_t write(const uint8_t *buffer, size_t size) override { return _client->write(buffer, size); }
+  using Print::write;
+
+  int state() { return _state; }
+
+private:
+  Client *_client;
+  IPAddress _ip;
+  uint16_t _port = 1883;
+  uint16_t _bufferSize = 256;
+  int _state = MQTT_DISCONNECTED;
+};
+
+#endif // SENTIENT_HOST_PUB_SUB_CLIENT_H
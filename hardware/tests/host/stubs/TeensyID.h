@@ -0,0 +1,18 @@
+/*
+ * TeensyID.h (host stub)
+ *
+ * A fixed MAC in the Teensy (PJRC) OUI range.
+ */
+
+#ifndef SENTIENT_HOST_TEENSY_ID_H
+#define SENTIENT_HOST_TEENSY_ID_H
+
+#include <Arduino.h>
+
+inline void teensyMAC(uint8_t *mac)
+{
+  static const uint8_t kMac[6] = {0x04, 0xE9, 0xE5, 0x10, 0x20, 0x30};
+  memcpy(mac, kMac, sizeof(kMac));
+}
+
+#endif // SENTIENT_HOST_TEENSY_ID_H
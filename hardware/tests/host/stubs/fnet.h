@@ -0,0 +1,104 @@
+/*
+ * fnet.h (host stub)
+ *
+ * The slice of the FNET socket API SentientSocketClient uses. Sockets
+ * connect at once and their send queues drain instantly unless a test
+ * holds a backlog in them; anything sent goes to hostTcpCapture()'s buffer
+ * and is counted. A CONNECT is answered
+ * with an accepting CONNACK, so SentientMQTT comes online within a few
+ * loop() calls. mDNS and LLMNR start and do nothing.
+ */
+
+#ifndef SENTIENT_HOST_FNET_H
+#define SENTIENT_HOST_FNET_H
+
+#include <Arduino.h>
+
+typedef uint8_t fnet_uint8_t;
+typedef uint16_t fnet_uint16_t;
+typedef uint32_t fnet_uint32_t;
+typedef int32_t fnet_int32_t;
+typedef size_t fnet_size_t;
+
+#define FNET_ERR (-1)
+#define FNET_HTONS(x) ((fnet_uint16_t)((((x) & 0xFF) << 8) | (((x) >> 8) & 0xFF)))
+
+#define AF_INET 2
+#define SOCK_STREAM 1
+#define SOL_SOCKET 0xFFFF
+#define SO_SNDBUF 0x1001
+#define SO_STATE 0x1010
+#define SO_SNDNUM 0x1011
+
+typedef enum
+{
+  SS_UNCONNECTED = 0,
+  SS_CONNECTING = 1,
+  SS_CONNECTED = 2,
+  SS_LISTENING = 3
+} fnet_socket_state_t;
+
+struct fnet_in_addr
+{
+  fnet_uint32_t s_addr;
+};
+
+struct fnet_sockaddr
+{
+  fnet_uint16_t sa_family;
+  fnet_uint8_t sa_data[14];
+};
+
+struct fnet_sockaddr_in
+{
+  fnet_uint16_t sin_family;
+  fnet_uint16_t sin_port;
+  fnet_uint16_t sin_scope_id;
+  struct fnet_in_addr sin_addr;
+};
+
+struct HostSocket;
+typedef HostSocket *fnet_socket_t;
+typedef void *fnet_netif_desc_t;
+
+fnet_socket_t fnet_socket(int family, int type, int protocol);
+int fnet_socket_connect(fnet_socket_t s, struct fnet_sockaddr *name, fnet_size_t namelen);
+fnet_int32_t fnet_socket_send(fnet_socket_t s, const void *data, fnet_size_t len, int flags);
+fnet_int32_t fnet_socket_recv(fnet_socket_t s, void *buf, fnet_size_t len, int flags);
+int fnet_socket_getopt(fnet_socket_t s, int level, int optname, fnet_uint8_t *optval, fnet_size_t *optlen);
+int fnet_socket_close(fnet_socket_t s);
+void fnet_service_poll();
+fnet_netif_desc_t fnet_netif_get_default();
+
+typedef void *fnet_mdns_desc_t;
+typedef struct
+{
+  fnet_netif_desc_t netif_desc;
+  int addr_family;
+  const char *name;
+} fnet_mdns_params_t;
+fnet_mdns_desc_t fnet_mdns_init(fnet_mdns_params_t *params);
+
+typedef void *fnet_llmnr_desc_t;
+typedef struct
+{
+  fnet_netif_desc_t netif_desc;
+  int addr_family;
+  const char *host_name;
+} fnet_llmnr_params_t;
+fnet_llmnr_desc_t fnet_llmnr_init(fnet_llmnr_params_t *params);
+
+// ---- Host controls ---------------------------------------------------------
+
+// Copy everything sockets send into buffer (nullptr: just count it)
+void hostTcpCapture(uint8_t *buffer, size_t capacity);
+size_t hostTcpCaptured();
+uint64_t hostTcpBytesSent();
+// Hold bytes in every socket's send queue (0: queues drain instantly). Each
+// look at a queue with a backlog costs a microsecond of host time, so a
+// writer waiting for room eventually times out.
+void hostTcpSetBacklog(size_t bytes);
+// Fail every send (FNET_ERR), as a socket the peer has reset does
+void hostTcpFailSends(bool fail);
+
+#endif // SENTIENT_HOST_FNET_H
@@ -0,0 +1,68 @@
+#include <Arduino.h>
+
+namespace
+{
+  uint64_t g_micros = 0;
+  uint8_t g_pins[HOST_PIN_COUNT] = {};
+  uint32_t g_pinWrites[HOST_PIN_COUNT] = {};
+  uint32_t g_random = 1;
+}
+
+HostSerial Serial;
+bool hostSerialEcho = false;
+
+void hostSetMicros(uint64_t us) { g_micros = us; }
+void hostAdvanceMicros(uint64_t us) { g_micros += us; }
+uint64_t hostMicros() { return g_micros; }
+
+uint8_t hostPinLevel(uint8_t pin) { return pin < HOST_PIN_COUNT ? g_pins[pin] : LOW; }
+void hostSetPinLevel(uint8_t pin, uint8_t level)
+{
+  if (pin < HOST_PIN_COUNT)
+  {
+    g_pins[pin] = level ? HIGH : LOW;
+  }
+}
+uint32_t hostPinWrites(uint8_t pin) { return pin < HOST_PIN_COUNT ? g_pinWrites[pin] : 0; }
+
+uint32_t millis() { return (uint32_t)(g_micros / 1000); }
+uint32_t micros() { return (uint32_t)g_micros; }
+void delay(uint32_t ms) { g_micros += (uint64_t)ms * 1000; }
+void delayMicroseconds(uint32_t us) { g_micros += us; }
+void yield() {}
+
+void pinMode(uint8_t, uint8_t) {}
+
+void digitalWrite(uint8_t pin, uint8_t level)
+{
+  if (pin < HOST_PIN_COUNT)
+  {
+    g_pins[pin] = level ? HIGH : LOW;
+    ++g_pinWrites[pin];
+  }
+}
+
+uint8_t digitalRead(uint8_t pin) { return hostPinLevel(pin); }
+
+void attachInterrupt(uint8_t, void (*)(), int) {}
+void detachInterrupt(uint8_t) {}
+
+long random(long howBig)
+{
+  if (howBig <= 0)
+  {
+    return 0;
+  }
+  // xorshift32: deterministic across runs and platforms
+  g_random ^= g_random << 13;
+  g_random ^= g_random >> 17;
+  g_random ^= g_random << 5;
+  return g_random % howBig;
+}
+
+long random(long howSmall, long howBig)
+{
+  return howSmall >= howBig ? howSmall : howSmall + random(howBig - howSmall);
+}
+
+void randomSeed(unsigned long seed) { g_random = seed ? seed : 1; }
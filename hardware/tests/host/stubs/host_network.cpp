@@ -0,0 +1,212 @@
+#include <NativeEthernet.h>
+#include <NativeEthernetUdp.h>
+#include <fnet.h>
+
+#include <map>
+
+namespace
+{
+  std::map<uint16_t, std::deque<std::vector<uint8_t>>> g_inbound;
+  uint32_t g_sent = 0;
+  std::vector<uint8_t> g_lastSent;
+}
+
+EthernetClass Ethernet;
+
+void hostUdpDeliver(uint16_t port, const uint8_t *data, size_t length)
+{
+  g_inbound[port].emplace_back(data, data + length);
+}
+
+size_t hostUdpPending(uint16_t port)
+{
+  return g_inbound[port].size();
+}
+
+uint32_t hostUdpSent() { return g_sent; }
+const std::vector<uint8_t> &hostUdpLastSent() { return g_lastSent; }
+
+uint8_t EthernetUDP::begin(uint16_t port)
+{
+  _port = port;
+  return 1;
+}
+
+int EthernetUDP::beginPacket(IPAddress ip, uint16_t port)
+{
+  _outgoing.clear();
+  return 1;
+}
+
+int EthernetUDP::endPacket()
+{
+  ++g_sent;
+  g_lastSent = _outgoing;
+  return 1;
+}
+
+size_t EthernetUDP::write(uint8_t b)
+{
+  _outgoing.push_back(b);
+  return 1;
+}
+
+size_t EthernetUDP::write(const uint8_t *buffer, size_t size)
+{
+  _outgoing.insert(_outgoing.end(), buffer, buffer + size);
+  return size;
+}
+
+int EthernetUDP::parsePacket()
+{
+  // Whatever was not read of the previous datagram is discarded
+  _packet.clear();
+  _read = 0;
+  std::deque<std::vector<uint8_t>> &queue = g_inbound[_port];
+  if (!_port || queue.empty())
+  {
+    return 0;
+  }
+  _packet = std::move(queue.front());
+  queue.pop_front();
+  return (int)_packet.size();
+}
+
+int EthernetUDP::read()
+{
+  return available() ? _packet[_read++] : -1;
+}
+
+int EthernetUDP::read(uint8_t *buffer, size_t length)
+{
+  const size_t n = std::min(length, _packet.size() - _read);
+  memcpy(buffer, _packet.data() + _read, n);
+  _read += n;
+  return (int)n;
+}
+
+// ---- FNET sockets ----------------------------------------------------------
+
+struct HostSocket
+{
+  fnet_socket_state_t state = SS_UNCONNECTED;
+  bool connectAnswered = false;
+  uint8_t inbound[4];
+  size_t inboundLength = 0;
+};
+
+namespace
+{
+  constexpr fnet_uint32_t kSendQueueBytes = 8192;
+  constexpr uint8_t kConnack[4] = {0x20, 0x02, 0x00, 0x00};
+
+  uint8_t *g_capture = nullptr;
+  size_t g_captureCapacity = 0;
+  size_t g_captured = 0;
+  uint64_t g_tcpSent = 0;
+  size_t g_tcpBacklog = 0;
+  bool g_tcpFailSends = false;
+}
+
+void hostTcpCapture(uint8_t *buffer, size_t capacity)
+{
+  g_capture = buffer;
+  g_captureCapacity = capacity;
+  g_captured = 0;
+}
+
+size_t hostTcpCaptured() { return g_captured; }
+uint64_t hostTcpBytesSent() { return g_tcpSent; }
+void hostTcpSetBacklog(size_t bytes) { g_tcpBacklog = std::min<size_t>(bytes, kSendQueueBytes); }
+void hostTcpFailSends(bool fail) { g_tcpFailSends = fail; }
+
+fnet_socket_t fnet_socket(int family, int type, int protocol)
+{
+  return new HostSocket;
+}
+
+int fnet_socket_connect(fnet_socket_t s, struct fnet_sockaddr *name, fnet_size_t namelen)
+{
+  s->state = SS_CONNECTED;
+  return 0;
+}
+
+fnet_int32_t fnet_socket_send(fnet_socket_t s, const void *data, fnet_size_t len, int flags)
+{
+  if (s->state != SS_CONNECTED || g_tcpFailSends)
+  {
+    return FNET_ERR;
+  }
+  if (g_tcpBacklog > 0)
+  {
+    hostAdvanceMicros(1);
+    len = std::min<size_t>(len, kSendQueueBytes - g_tcpBacklog);
+  }
+  const uint8_t *bytes = static_cast<const uint8_t *>(data);
+  if (!s->connectAnswered && len > 0 && bytes[0] == 0x10)
+  {
+    memcpy(s->inbound, kConnack, sizeof(kConnack));
+    s->inboundLength = sizeof(kConnack);
+    s->connectAnswered = true;
+  }
+  if (g_capture)
+  {
+    const size_t n = std::min(len, g_captureCapacity - g_captured);
+    memcpy(g_capture + g_captured, bytes, n);
+    g_captured += n;
+  }
+  g_tcpSent += len;
+  return (fnet_int32_t)len;
+}
+
+fnet_int32_t fnet_socket_recv(fnet_socket_t s, void *buf, fnet_size_t len, int flags)
+{
+  const size_t n = std::min(len, s->inboundLength);
+  memcpy(buf, s->inbound, n);
+  memmove(s->inbound, s->inbound + n, s->inboundLength - n);
+  s->inboundLength -= n;
+  return (fnet_int32_t)n;
+}
+
+int fnet_socket_getopt(fnet_socket_t s, int level, int optname, fnet_uint8_t *optval, fnet_size_t *optlen)
+{
+  switch (optname)
+  {
+  case SO_SNDBUF:
+    *reinterpret_cast<fnet_uint32_t *>(optval) = kSendQueueBytes;
+    return 0;
+  case SO_SNDNUM:
+    if (g_tcpBacklog > 0)
+    {
+      hostAdvanceMicros(1);
+    }
+    *reinterpret_cast<fnet_uint32_t *>(optval) = (fnet_uint32_t)g_tcpBacklog;
+    return 0;
+  case SO_STATE:
+    *reinterpret_cast<fnet_socket_state_t *>(optval) = s->state;
+    return 0;
+  default:
+    return FNET_ERR;
+  }
+}
+
+int fnet_socket_close(fnet_socket_t s)
+{
+  delete s;
+  return 0;
+}
+
+void fnet_service_poll() {}
+fnet_netif_desc_t fnet_netif_get_default() { return nullptr; }
+
+fnet_mdns_desc_t fnet_mdns_init(fnet_mdns_params_t *params)
+{
+  static int service;
+  return &service;
+}
+
+fnet_llmnr_desc_t fnet_llmnr_init(fnet_llmnr_params_t *params)
+{
+  static int service;
+  return &service;
+}
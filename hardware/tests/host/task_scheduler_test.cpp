@@ -0,0 +1,142 @@
+/*
+ * task_scheduler_test.cpp
+ *
+ * SentientTaskScheduler's soft tasks on host time: periodic tasks keep their
+ * rate, one-shots run once, and a task that restarts or suspends itself from
+ * inside its own run keeps what it asked for instead of being rescheduled
+ * over.
+ */
+
+#include "host_test.h"
+
+#include <SentientTaskScheduler.h>
+
+namespace
+{
+  struct Probe
+  {
+    SentientTaskScheduler *tasks = nullptr;
+    int index = -1;
+    int runs = 0;
+    uint64_t lastRunUs = 0;
+    int restartsLeft = 0;    // Restart itself this many times
+    uint32_t restartMs = 0;
+    int suspendAfter = 0;    // Suspend itself on this run (0: never)
+  };
+
+  void probeRun(void *context)
+  {
+    Probe &probe = *static_cast<Probe *>(context);
+    ++probe.runs;
+    probe.lastRunUs = micros();
+    if (probe.restartsLeft > 0)
+    {
+      --probe.restartsLeft;
+      probe.tasks->restart(probe.index, probe.restartMs);
+    }
+    if (probe.suspendAfter > 0 && probe.runs == probe.suspendAfter)
+    {
+      probe.tasks->suspend(probe.index);
+    }
+  }
+
+  // Runs the scheduler every millisecond for ms milliseconds
+  void runFor(SentientTaskScheduler &tasks, uint32_t ms)
+  {
+    for (uint32_t i = 0; i < ms; ++i)
+    {
+      tasks.run();
+      hostAdvanceMicros(1000);
+    }
+  }
+
+  void periodicKeepsRate()
+  {
+    hostSetMicros(1'000'000);
+    SentientTaskScheduler tasks;
+    Probe probe;
+    probe.tasks = &tasks;
+    probe.index = tasks.every("periodic", 10, probeRun, &probe);
+    runFor(tasks, 100);
+    CHECK(probe.runs == 10);
+  }
+
+  void oneShotRunsOnce()
+  {
+    hostSetMicros(1'000'000);
+    SentientTaskScheduler tasks;
+    Probe probe;
+    probe.tasks = &tasks;
+    probe.index = tasks.after("once", 5, probeRun, &probe);
+    runFor(tasks, 100);
+    CHECK(probe.runs == 1);
+
+    // restart() from outside re-arms it
+    CHECK(tasks.restart(probe.index, 5));
+    runFor(tasks, 100);
+    CHECK(probe.runs == 2);
+  }
+
+  void oneShotRestartsItself()
+  {
+    hostSetMicros(1'000'000);
+    SentientTaskScheduler tasks;
+    Probe probe;
+    probe.tasks = &tasks;
+    probe.restartsLeft = 3;
+    probe.restartMs = 20;
+    probe.index = tasks.after("retry", 5, probeRun, &probe);
+    runFor(tasks, 200);
+    CHECK(probe.runs == 4); // The first run and three self-restarts
+  }
+
+  void periodicRestartsItself()
+  {
+    hostSetMicros(1'000'000);
+    SentientTaskScheduler tasks;
+    Probe probe;
+    probe.tasks = &tasks;
+    probe.restartsLeft = 1;
+    probe.restartMs = 50;
+    probe.index = tasks.every("backoff", 10, probeRun, &probe);
+
+    runFor(tasks, 1);
+    CHECK(probe.runs == 1);
+    const uint64_t first = probe.lastRunUs;
+    runFor(tasks, 45);
+    CHECK(probe.runs == 1); // Held off by its own restart, not due one period later
+    runFor(tasks, 10);
+    CHECK(probe.runs == 2);
+    CHECK(probe.lastRunUs - first >= 50'000);
+
+    // Back on its period from the restarted run
+    runFor(tasks, 100);
+    CHECK(probe.runs == 12);
+  }
+
+  void periodicSuspendsItself()
+  {
+    hostSetMicros(1'000'000);
+    SentientTaskScheduler tasks;
+    Probe probe;
+    probe.tasks = &tasks;
+    probe.suspendAfter = 3;
+    probe.index = tasks.every("until", 10, probeRun, &probe);
+    runFor(tasks, 100);
+    CHECK(probe.runs == 3);
+
+    tasks.resume(probe.index);
+    runFor(tasks, 25);
+    CHECK(probe.runs == 6);
+  }
+}
+
+int main()
+{
+  periodicKeepsRate();
+  oneShotRunsOnce();
+  oneShotRestartsItself();
+  periodicRestartsItself();
+  periodicSuspendsItself();
+  return hostTestResult();
+}